@@ -0,0 +1,200 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxAnimation.h
+// Desc : Skeletal Animation.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <asdxMath.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   ANIMATION_LANE_COUNT    = 4;    //!< SoA形式で同時に処理するボーン数.
+static constexpr uint32_t   ANIMATION_KEY_CHANNELS  = 9;    //!< 1キーあたりのチャンネル数(回転3, 平行移動3, スケール3).
+static constexpr uint32_t   ANIMATION_RANGE_CHANNELS= 12;   //!< 1ボーンあたりの範囲チャンネル数(平行移動とスケールの最小値と量子化幅).
+static constexpr uint32_t   ANIMATION_POSE_CHANNELS = 10;   //!< 姿勢のチャンネル数(平行移動3, 回転4, スケール3).
+
+///////////////////////////////////////////////////////////////////////////////
+// ANIMATION_INTERPOLATION enum
+///////////////////////////////////////////////////////////////////////////////
+enum ANIMATION_INTERPOLATION
+{
+    ANIMATION_INTERPOLATION_NLERP = 0,  //!< 正規化線形補間.
+    ANIMATION_INTERPOLATION_SLERP,      //!< 球面線形補間.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ANIMATION_POSE_CHANNEL enum
+///////////////////////////////////////////////////////////////////////////////
+enum ANIMATION_POSE_CHANNEL
+{
+    ANIMATION_POSE_TRANSLATION_X = 0,
+    ANIMATION_POSE_TRANSLATION_Y,
+    ANIMATION_POSE_TRANSLATION_Z,
+    ANIMATION_POSE_ROTATION_X,
+    ANIMATION_POSE_ROTATION_Y,
+    ANIMATION_POSE_ROTATION_Z,
+    ANIMATION_POSE_ROTATION_W,
+    ANIMATION_POSE_SCALE_X,
+    ANIMATION_POSE_SCALE_Y,
+    ANIMATION_POSE_SCALE_Z,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResAnimationClip structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResAnimationClip
+{
+    std::string                 Name;
+    float                       FrameRate   = 30.0f;    //!< 1秒あたりのキーフレーム数.
+    uint32_t                    FrameCount  = 0;        //!< キーフレーム数.
+    uint32_t                    BoneCount   = 0;        //!< ボーン数.
+    std::vector<Vector3>        Translations;           //!< [FrameCount * BoneCount] フレーム順に並んだ平行移動.
+    std::vector<Quaternion>     Rotations;              //!< [FrameCount * BoneCount] フレーム順に並んだ回転.
+    std::vector<Vector3>        Scales;                 //!< [FrameCount * BoneCount] フレーム順に並んだスケール.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// AnimationClip structure
+///////////////////////////////////////////////////////////////////////////////
+struct AnimationClip
+{
+    std::string             Name;
+    float                   FrameRate   = 30.0f;    //!< 1秒あたりのキーフレーム数.
+    float                   Duration    = 0.0f;     //!< 再生時間(秒).
+    uint32_t                FrameCount  = 0;        //!< キーフレーム数.
+    uint32_t                BoneCount   = 0;        //!< ボーン数.
+    uint32_t                LaneCount   = 0;        //!< ANIMATION_LANE_COUNT の倍数に切り上げたボーン数.
+    std::vector<float>      Ranges;                 //!< [ANIMATION_RANGE_CHANNELS][LaneCount] 平行移動とスケールの復元範囲.
+    std::vector<uint16_t>   Keys;                   //!< [FrameCount][ANIMATION_KEY_CHANNELS][LaneCount] 量子化されたキー.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// AnimationPose structure
+///////////////////////////////////////////////////////////////////////////////
+struct AnimationPose
+{
+    uint32_t                BoneCount   = 0;        //!< ボーン数.
+    uint32_t                LaneCount   = 0;        //!< ANIMATION_LANE_COUNT の倍数に切り上げたボーン数.
+    std::vector<float>      Channels;               //!< [ANIMATION_POSE_CHANNELS][LaneCount] SoA形式の局所姿勢.
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定ボーン数で初期化します.
+    //!
+    //! @param[in]      boneCount       ボーン数.
+    //-------------------------------------------------------------------------
+    void Init(uint32_t boneCount);
+
+    //-------------------------------------------------------------------------
+    //! @brief      チャンネルの先頭ポインタを取得します.
+    //!
+    //! @param[in]      channel         ANIMATION_POSE_CHANNEL の値.
+    //! @return     LaneCount 要素の配列を返却します.
+    //-------------------------------------------------------------------------
+    float*       GetChannel(uint32_t channel)       { return Channels.data() + channel * LaneCount; }
+    const float* GetChannel(uint32_t channel) const { return Channels.data() + channel * LaneCount; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      平行移動を取得します.
+    //-------------------------------------------------------------------------
+    Vector3 GetTranslation(uint32_t bone) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      回転を取得します.
+    //-------------------------------------------------------------------------
+    Quaternion GetRotation(uint32_t bone) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      スケールを取得します.
+    //-------------------------------------------------------------------------
+    Vector3 GetScale(uint32_t bone) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// AnimationSampleJob structure
+///////////////////////////////////////////////////////////////////////////////
+struct AnimationSampleJob
+{
+    const AnimationClip*        pClip           = nullptr;                          //!< サンプリングするクリップ.
+    float                       Time            = 0.0f;                             //!< 再生時間(秒).
+    bool                        Loop            = true;                             //!< ループ再生するかどうか.
+    ANIMATION_INTERPOLATION     Interpolation   = ANIMATION_INTERPOLATION_NLERP;    //!< 回転の補間方法.
+    AnimationPose*              pPose           = nullptr;                          //!< 出力先の姿勢.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      アニメーションクリップを圧縮します.
+//!
+//! @param[in]      source      非圧縮のアニメーションクリップ.
+//! @param[out]     result      圧縮されたアニメーションクリップ.
+//! @retval true    圧縮に成功.
+//! @retval false   圧縮に失敗.
+//! @note       回転は最大成分を省いた3成分を15bitに, 平行移動とスケールは
+//!             ボーンごとの値域で正規化して16bitに量子化します.
+//-----------------------------------------------------------------------------
+bool CompressAnimationClip(const ResAnimationClip& source, AnimationClip& result);
+
+//-----------------------------------------------------------------------------
+//! @brief      アニメーションをサンプリングします.
+//!
+//! @param[in]      clip            アニメーションクリップ.
+//! @param[in]      time            再生時間(秒).
+//! @param[in]      loop            ループ再生する場合は true.
+//! @param[in]      interpolation   回転の補間方法.
+//! @param[out]     pose            局所姿勢の格納先.
+//! @note       全ボーンを ANIMATION_LANE_COUNT 本ずつSoA形式で処理します.
+//-----------------------------------------------------------------------------
+void SampleAnimation(
+    const AnimationClip&    clip,
+    float                   time,
+    bool                    loop,
+    ANIMATION_INTERPOLATION interpolation,
+    AnimationPose&          pose);
+
+//-----------------------------------------------------------------------------
+//! @brief      複数のアニメーションをまとめてサンプリングします.
+//!
+//! @param[in]      pJobs           サンプリング要求の配列.
+//! @param[in]      count           サンプリング要求の数.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//-----------------------------------------------------------------------------
+void SampleAnimations(
+    const AnimationSampleJob*   pJobs,
+    size_t                      count,
+    uint32_t                    maxThreadCount = 1);
+
+//-----------------------------------------------------------------------------
+//! @brief      姿勢をブレンドします.
+//!
+//! @param[in]      a               姿勢.
+//! @param[in]      b               姿勢.
+//! @param[in]      weight          b の重み.
+//! @param[out]     result          ブレンドした姿勢(a, b と同じでも可).
+//! @note       回転は正規化線形補間でブレンドします.
+//-----------------------------------------------------------------------------
+void BlendPoses(
+    const AnimationPose&    a,
+    const AnimationPose&    b,
+    float                   weight,
+    AnimationPose&          result);
+
+//-----------------------------------------------------------------------------
+//! @brief      局所姿勢から局所変換行列を求めます.
+//!
+//! @param[in]      pose            局所姿勢.
+//! @param[out]     pResult         pose.BoneCount 個の変換行列の格納先.
+//! @note       各行列は Matrix::CreateScale(S) * Matrix::CreateFromQuaternion(R) * Matrix::CreateTranslation(T) と同じ変換です.
+//-----------------------------------------------------------------------------
+void CalcLocalMatrices(const AnimationPose& pose, Matrix34* pResult);
+
+} // namespace asdx
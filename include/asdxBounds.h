@@ -0,0 +1,541 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxBounds.h
+// Desc : Bounding Volumes.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cfloat>
+#include <asdxMath.h>
+
+// xxxX4 構造体は4個の境界ボリュームをSoA形式で保持し, 判定結果を4bitのマスクで返却します.
+// i番目のレーンが条件を満たす場合に (1 << i) のビットが立ちます.
+// ASDX_ENABLE_SIMD を定義するとSSE2で4レーンを同時に判定します(結果はスカラー版と一致します).
+// 未設定のレーンは空の境界ボリュームで初期化され, どの判定でもビットは立ちません.
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+struct BoundingSphere;
+struct OrientedBox;
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   FRUSTUM_PLANE_COUNT = 6;    //!< 視錐台の平面数(左, 右, 下, 上, 近, 遠).
+static constexpr uint32_t   BOUNDS_LANE_COUNT   = 4;    //!< xxxX4 構造体のレーン数.
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingBox structure
+///////////////////////////////////////////////////////////////////////////////
+struct BoundingBox
+{
+    Vector3     Min;    //!< 最小値.
+    Vector3     Max;    //!< 最大値.
+
+    //-------------------------------------------------------------------------
+    //! @brief      空の境界箱を生成します.
+    //-------------------------------------------------------------------------
+    BoundingBox();
+
+    //-------------------------------------------------------------------------
+    //! @brief      最小値と最大値を指定して生成します.
+    //-------------------------------------------------------------------------
+    BoundingBox(const Vector3& mini, const Vector3& maxi);
+
+    //-------------------------------------------------------------------------
+    //! @brief      空の境界箱かどうかチェックします.
+    //-------------------------------------------------------------------------
+    bool IsEmpty() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      中心座標を取得します.
+    //-------------------------------------------------------------------------
+    Vector3 GetCenter() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      中心から各面までの距離を取得します.
+    //-------------------------------------------------------------------------
+    Vector3 GetExtents() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      8角の座標を取得します.
+    //!
+    //! @param[out]     corners     8個の座標の格納先. i番目の角は (i & 1, i & 2, i & 4) が立っている軸で最大値を取ります.
+    //-------------------------------------------------------------------------
+    void GetCorners(Vector3* corners) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を含むように拡張します.
+    //-------------------------------------------------------------------------
+    void Merge(const Vector3& point);
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱を含むように拡張します.
+    //-------------------------------------------------------------------------
+    void Merge(const BoundingBox& box);
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const Vector3& point) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱を完全に包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球を完全に包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const BoundingSphere& sphere) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱と交差するかどうか判定します(接触を含みます).
+    //-------------------------------------------------------------------------
+    bool Intersects(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と交差するかどうか判定します(接触を含みます).
+    //-------------------------------------------------------------------------
+    bool Intersects(const BoundingSphere& sphere) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点群を包含する境界箱を生成します.
+    //!
+    //! @param[in]      pPoints     点群.
+    //! @param[in]      count       点の数.
+    //! @param[in]      stride      点の間隔(バイト).
+    //! @return     count が0の場合は空の境界箱を返却します.
+    //-------------------------------------------------------------------------
+    static BoundingBox CreateFromPoints(const Vector3* pPoints, size_t count, size_t stride = sizeof(Vector3));
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球を包含する境界箱を生成します.
+    //-------------------------------------------------------------------------
+    static BoundingBox CreateFromSphere(const BoundingSphere& sphere);
+
+    //-------------------------------------------------------------------------
+    //! @brief      2つの境界箱を包含する境界箱を求めます.
+    //-------------------------------------------------------------------------
+    static BoundingBox Merge(const BoundingBox& a, const BoundingBox& b);
+
+    //-------------------------------------------------------------------------
+    //! @brief      変換後の境界箱を包含する境界箱を求めます.
+    //!
+    //! @param[in]      box         境界箱.
+    //! @param[in]      matrix      アフィン変換行列.
+    //! @note       8角を変換せずに中心と各軸の広がりから求めます(Arvo の方法).
+    //-------------------------------------------------------------------------
+    static BoundingBox Transform(const BoundingBox& box, const Matrix& matrix);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingSphere structure
+///////////////////////////////////////////////////////////////////////////////
+struct BoundingSphere
+{
+    Vector3     Center;     //!< 中心座標.
+    float       Radius;     //!< 半径.
+
+    //-------------------------------------------------------------------------
+    //! @brief      原点を中心とする半径0の境界球を生成します.
+    //-------------------------------------------------------------------------
+    BoundingSphere();
+
+    //-------------------------------------------------------------------------
+    //! @brief      中心座標と半径を指定して生成します.
+    //-------------------------------------------------------------------------
+    BoundingSphere(const Vector3& center, float radius);
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const Vector3& point) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱を完全に包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球を完全に包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const BoundingSphere& sphere) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱と交差するかどうか判定します(接触を含みます).
+    //-------------------------------------------------------------------------
+    bool Intersects(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と交差するかどうか判定します(接触を含みます).
+    //-------------------------------------------------------------------------
+    bool Intersects(const BoundingSphere& sphere) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点群を包含する境界球を生成します.
+    //!
+    //! @param[in]      pPoints     点群.
+    //! @param[in]      count       点の数.
+    //! @param[in]      stride      点の間隔(バイト).
+    //! @note       Ritter の方法で求めるため, 最小包含球より最大で5%程度大きくなります.
+    //-------------------------------------------------------------------------
+    static BoundingSphere CreateFromPoints(const Vector3* pPoints, size_t count, size_t stride = sizeof(Vector3));
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱を包含する境界球を生成します.
+    //-------------------------------------------------------------------------
+    static BoundingSphere CreateFromBox(const BoundingBox& box);
+
+    //-------------------------------------------------------------------------
+    //! @brief      2つの境界球を包含する最小の境界球を求めます.
+    //-------------------------------------------------------------------------
+    static BoundingSphere Merge(const BoundingSphere& a, const BoundingSphere& b);
+
+    //-------------------------------------------------------------------------
+    //! @brief      変換後の境界球を包含する境界球を求めます.
+    //!
+    //! @param[in]      sphere      境界球.
+    //! @param[in]      matrix      アフィン変換行列.
+    //! @note       半径は最大のスケール成分で拡大します.
+    //-------------------------------------------------------------------------
+    static BoundingSphere Transform(const BoundingSphere& sphere, const Matrix& matrix);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// OrientedBox structure
+///////////////////////////////////////////////////////////////////////////////
+struct OrientedBox
+{
+    Vector3     Center;     //!< 中心座標.
+    Vector3     Extents;    //!< 中心から各面までの距離.
+    Vector3     Axis[3];    //!< 正規直交の局所座標軸.
+
+    //-------------------------------------------------------------------------
+    //! @brief      原点を中心とする大きさ0の有向境界箱を生成します.
+    //-------------------------------------------------------------------------
+    OrientedBox();
+
+    //-------------------------------------------------------------------------
+    //! @brief      中心座標, 広がり, 回転を指定して生成します.
+    //-------------------------------------------------------------------------
+    OrientedBox(const Vector3& center, const Vector3& extents, const Quaternion& orientation);
+
+    //-------------------------------------------------------------------------
+    //! @brief      8角の座標を取得します.
+    //!
+    //! @param[out]     corners     8個の座標の格納先. 並びは BoundingBox::GetCorners() と同じです.
+    //-------------------------------------------------------------------------
+    void GetCorners(Vector3* corners) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      包含する軸並行境界箱を取得します.
+    //-------------------------------------------------------------------------
+    BoundingBox GetBoundingBox() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const Vector3& point) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と交差するかどうか判定します(接触を含みます).
+    //-------------------------------------------------------------------------
+    bool Intersects(const BoundingSphere& sphere) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      軸並行境界箱と交差するかどうか判定します(接触を含みます).
+    //-------------------------------------------------------------------------
+    bool Intersects(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      有向境界箱と交差するかどうか判定します(接触を含みます).
+    //!
+    //! @note       15軸の分離軸判定を行います.
+    //-------------------------------------------------------------------------
+    bool Intersects(const OrientedBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      局所空間の境界箱をワールド空間に変換した有向境界箱を生成します.
+    //!
+    //! @param[in]      box         局所空間の境界箱.
+    //! @param[in]      matrix      ワールド行列(せん断を含まないこと).
+    //! @note       スケールは広がりに反映します.
+    //-------------------------------------------------------------------------
+    static OrientedBox CreateFromBox(const BoundingBox& box, const Matrix& matrix);
+
+    //-------------------------------------------------------------------------
+    //! @brief      有向境界箱を変換します.
+    //!
+    //! @param[in]      box         有向境界箱.
+    //! @param[in]      matrix      変換行列(せん断を含まないこと).
+    //-------------------------------------------------------------------------
+    static OrientedBox Transform(const OrientedBox& box, const Matrix& matrix);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingBoxX4 structure
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(16) BoundingBoxX4
+{
+    float   MinX[BOUNDS_LANE_COUNT];    //!< 最小値のX成分.
+    float   MinY[BOUNDS_LANE_COUNT];    //!< 最小値のY成分.
+    float   MinZ[BOUNDS_LANE_COUNT];    //!< 最小値のZ成分.
+    float   MaxX[BOUNDS_LANE_COUNT];    //!< 最大値のX成分.
+    float   MaxY[BOUNDS_LANE_COUNT];    //!< 最大値のY成分.
+    float   MaxZ[BOUNDS_LANE_COUNT];    //!< 最大値のZ成分.
+
+    //-------------------------------------------------------------------------
+    //! @brief      全レーンを空の境界箱で初期化します.
+    //-------------------------------------------------------------------------
+    BoundingBoxX4();
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンに境界箱を設定します.
+    //-------------------------------------------------------------------------
+    void Set(uint32_t lane, const BoundingBox& box);
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンの境界箱を取得します.
+    //-------------------------------------------------------------------------
+    BoundingBox Get(uint32_t lane) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を包含するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Contains(const Vector3& point) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱と交差するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と交差するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingSphere& sphere) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingSphereX4 structure
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(16) BoundingSphereX4
+{
+    float   CenterX[BOUNDS_LANE_COUNT];     //!< 中心座標のX成分.
+    float   CenterY[BOUNDS_LANE_COUNT];     //!< 中心座標のY成分.
+    float   CenterZ[BOUNDS_LANE_COUNT];     //!< 中心座標のZ成分.
+    float   Radius [BOUNDS_LANE_COUNT];     //!< 半径(負の場合は空).
+
+    //-------------------------------------------------------------------------
+    //! @brief      全レーンを空の境界球で初期化します.
+    //-------------------------------------------------------------------------
+    BoundingSphereX4();
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンに境界球を設定します.
+    //-------------------------------------------------------------------------
+    void Set(uint32_t lane, const BoundingSphere& sphere);
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンの境界球を取得します.
+    //-------------------------------------------------------------------------
+    BoundingSphere Get(uint32_t lane) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を包含するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Contains(const Vector3& point) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱と交差するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と交差するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingSphere& sphere) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// OrientedBoxX4 structure
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(16) OrientedBoxX4
+{
+    float   CenterX[BOUNDS_LANE_COUNT];     //!< 中心座標のX成分.
+    float   CenterY[BOUNDS_LANE_COUNT];     //!< 中心座標のY成分.
+    float   CenterZ[BOUNDS_LANE_COUNT];     //!< 中心座標のZ成分.
+    float   Extents[3][BOUNDS_LANE_COUNT];  //!< [軸][レーン] 広がり(負の場合は空).
+    float   Axis[3][3][BOUNDS_LANE_COUNT];  //!< [軸][成分][レーン] 局所座標軸.
+
+    //-------------------------------------------------------------------------
+    //! @brief      全レーンを空の有向境界箱で初期化します.
+    //-------------------------------------------------------------------------
+    OrientedBoxX4();
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンに有向境界箱を設定します.
+    //-------------------------------------------------------------------------
+    void Set(uint32_t lane, const OrientedBox& box);
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンの有向境界箱を取得します.
+    //-------------------------------------------------------------------------
+    OrientedBox Get(uint32_t lane) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を包含するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Contains(const Vector3& point) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と交差するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingSphere& sphere) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Frustum structure
+///////////////////////////////////////////////////////////////////////////////
+struct Frustum
+{
+    Vector4     Planes[FRUSTUM_PLANE_COUNT];    //!< 内向きの法線を持つ正規化された平面(左, 右, 下, 上, 近, 遠).
+
+    //-------------------------------------------------------------------------
+    //! @brief      全ての点を含まない視錐台を生成します.
+    //-------------------------------------------------------------------------
+    Frustum();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ビュー行列と射影行列から生成します.
+    //!
+    //! @note       平面は CalcFrustumPlanes() で求めます.
+    //-------------------------------------------------------------------------
+    Frustum(const Matrix& view, const Matrix& proj);
+
+    //-------------------------------------------------------------------------
+    //! @brief      FRUSTUM_PLANE_COUNT 枚の平面から生成します.
+    //-------------------------------------------------------------------------
+    explicit Frustum(const Vector4* planes);
+
+    //-------------------------------------------------------------------------
+    //! @brief      8角の座標を取得します.
+    //!
+    //! @param[out]     corners     8個の座標の格納先. 並びは GetCorners() と同じです.
+    //-------------------------------------------------------------------------
+    void GetCorners(Vector3* corners) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const Vector3& point) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱を完全に包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球を完全に包含するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Contains(const BoundingSphere& sphere) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と交差するかどうか判定します.
+    //!
+    //! @note       Intersects() は各平面の裏側に完全に入るかどうかのみを判定するため,
+    //!             視錐台の角付近では交差しない場合も true を返却する保守的な結果になります.
+    //!             判定式は CullSpheres(), CullBoxes() と同じです.
+    //-------------------------------------------------------------------------
+    bool Intersects(const BoundingSphere& sphere) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱と交差するかどうか判定します(保守的).
+    //-------------------------------------------------------------------------
+    bool Intersects(const BoundingBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      有向境界箱と交差するかどうか判定します(保守的).
+    //-------------------------------------------------------------------------
+    bool Intersects(const OrientedBox& box) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      4個の境界球のうち交差するレーンのマスクを求めます(保守的).
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingSphereX4& spheres) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      4個の境界箱のうち交差するレーンのマスクを求めます(保守的).
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingBoxX4& boxes) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      4個の有向境界箱のうち交差するレーンのマスクを求めます(保守的).
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const OrientedBoxX4& boxes) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      視錐台を変換します.
+    //!
+    //! @param[in]      frustum     視錐台.
+    //! @param[in]      matrix      変換行列(逆行列を持つこと).
+    //-------------------------------------------------------------------------
+    static Frustum Transform(const Frustum& frustum, const Matrix& matrix);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FrustumX4 structure
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(16) FrustumX4
+{
+    float   PlaneX[FRUSTUM_PLANE_COUNT][BOUNDS_LANE_COUNT];     //!< [平面][レーン] 法線のX成分.
+    float   PlaneY[FRUSTUM_PLANE_COUNT][BOUNDS_LANE_COUNT];     //!< [平面][レーン] 法線のY成分.
+    float   PlaneZ[FRUSTUM_PLANE_COUNT][BOUNDS_LANE_COUNT];     //!< [平面][レーン] 法線のZ成分.
+    float   PlaneW[FRUSTUM_PLANE_COUNT][BOUNDS_LANE_COUNT];     //!< [平面][レーン] 距離.
+
+    //-------------------------------------------------------------------------
+    //! @brief      全レーンを何も含まない視錐台で初期化します.
+    //-------------------------------------------------------------------------
+    FrustumX4();
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンに視錐台を設定します.
+    //-------------------------------------------------------------------------
+    void Set(uint32_t lane, const Frustum& frustum);
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンの視錐台を取得します.
+    //-------------------------------------------------------------------------
+    Frustum Get(uint32_t lane) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を包含するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t Contains(const Vector3& point) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と交差するレーンのマスクを求めます(保守的).
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingSphere& sphere) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱と交差するレーンのマスクを求めます(保守的).
+    //-------------------------------------------------------------------------
+    uint32_t Intersects(const BoundingBox& box) const;
+};
+
+} // namespace asdx
+
+//-----------------------------------------------------------------------------
+// Inline Files
+//-----------------------------------------------------------------------------
+#include <asdxBounds.inl>
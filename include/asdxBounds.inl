@@ -0,0 +1,1164 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxBounds.inl
+// Desc : Bounding Volumes.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      点と境界箱の最近接点までの距離の2乗を求めます.
+//-----------------------------------------------------------------------------
+inline
+float CalcDistanceSq( const Vector3& point, const Vector3& mini, const Vector3& maxi )
+{
+    auto dx = Max( mini.x, Min( point.x, maxi.x ) ) - point.x;
+    auto dy = Max( mini.y, Min( point.y, maxi.y ) ) - point.y;
+    auto dz = Max( mini.z, Min( point.z, maxi.z ) ) - point.z;
+    return ( dx * dx + dy * dy ) + dz * dz;
+}
+
+//-----------------------------------------------------------------------------
+//      平面と点の符号付き距離を求めます.
+//-----------------------------------------------------------------------------
+inline
+float CalcPlaneDistance( const Vector4& plane, float x, float y, float z )
+{ return ( ( plane.x * x + plane.y * y ) + plane.z * z ) + plane.w; }
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingBox structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      空の境界箱を生成します.
+//-----------------------------------------------------------------------------
+inline
+BoundingBox::BoundingBox()
+: Min( FLT_MAX, FLT_MAX, FLT_MAX )
+, Max( -FLT_MAX, -FLT_MAX, -FLT_MAX )
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      最小値と最大値を指定して生成します.
+//-----------------------------------------------------------------------------
+inline
+BoundingBox::BoundingBox( const Vector3& mini, const Vector3& maxi )
+: Min( mini )
+, Max( maxi )
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      空の境界箱かどうかチェックします.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingBox::IsEmpty() const
+{ return ( Min.x > Max.x ) || ( Min.y > Max.y ) || ( Min.z > Max.z ); }
+
+//-----------------------------------------------------------------------------
+//      中心座標を取得します.
+//-----------------------------------------------------------------------------
+inline
+Vector3 BoundingBox::GetCenter() const
+{ return ( Min + Max ) * 0.5f; }
+
+//-----------------------------------------------------------------------------
+//      中心から各面までの距離を取得します.
+//-----------------------------------------------------------------------------
+inline
+Vector3 BoundingBox::GetExtents() const
+{ return ( Max - Min ) * 0.5f; }
+
+//-----------------------------------------------------------------------------
+//      8角の座標を取得します.
+//-----------------------------------------------------------------------------
+inline
+void BoundingBox::GetCorners( Vector3* corners ) const
+{
+    for(auto i=0; i<8; ++i)
+    {
+        corners[i].x = ( i & 1 ) ? Max.x : Min.x;
+        corners[i].y = ( i & 2 ) ? Max.y : Min.y;
+        corners[i].z = ( i & 4 ) ? Max.z : Min.z;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      点を含むように拡張します.
+//-----------------------------------------------------------------------------
+inline
+void BoundingBox::Merge( const Vector3& point )
+{
+    Min = Vector3::Min( Min, point );
+    Max = Vector3::Max( Max, point );
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱を含むように拡張します.
+//-----------------------------------------------------------------------------
+inline
+void BoundingBox::Merge( const BoundingBox& box )
+{
+    Min = Vector3::Min( Min, box.Min );
+    Max = Vector3::Max( Max, box.Max );
+}
+
+//-----------------------------------------------------------------------------
+//      点を包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingBox::Contains( const Vector3& point ) const
+{
+    return ( Min.x <= point.x ) && ( point.x <= Max.x )
+        && ( Min.y <= point.y ) && ( point.y <= Max.y )
+        && ( Min.z <= point.z ) && ( point.z <= Max.z );
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱を完全に包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingBox::Contains( const BoundingBox& box ) const
+{
+    return ( Min.x <= box.Min.x ) && ( box.Max.x <= Max.x )
+        && ( Min.y <= box.Min.y ) && ( box.Max.y <= Max.y )
+        && ( Min.z <= box.Min.z ) && ( box.Max.z <= Max.z );
+}
+
+//-----------------------------------------------------------------------------
+//      境界球を完全に包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingBox::Contains( const BoundingSphere& sphere ) const
+{ return Contains( BoundingBox::CreateFromSphere( sphere ) ); }
+
+//-----------------------------------------------------------------------------
+//      境界箱と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingBox::Intersects( const BoundingBox& box ) const
+{
+    return ( Min.x <= box.Max.x ) && ( box.Min.x <= Max.x )
+        && ( Min.y <= box.Max.y ) && ( box.Min.y <= Max.y )
+        && ( Min.z <= box.Max.z ) && ( box.Min.z <= Max.z );
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingBox::Intersects( const BoundingSphere& sphere ) const
+{ return CalcDistanceSq( sphere.Center, Min, Max ) <= sphere.Radius * sphere.Radius; }
+
+//-----------------------------------------------------------------------------
+//      点群を包含する境界箱を生成します.
+//-----------------------------------------------------------------------------
+inline
+BoundingBox BoundingBox::CreateFromPoints( const Vector3* pPoints, size_t count, size_t stride )
+{
+    assert( pPoints != nullptr || count == 0 );
+
+    BoundingBox result;
+    auto ptr = reinterpret_cast<const uint8_t*>( pPoints );
+    for(size_t i=0; i<count; ++i, ptr += stride)
+    { result.Merge( *reinterpret_cast<const Vector3*>( ptr ) ); }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球を包含する境界箱を生成します.
+//-----------------------------------------------------------------------------
+inline
+BoundingBox BoundingBox::CreateFromSphere( const BoundingSphere& sphere )
+{
+    auto r = Vector3( sphere.Radius, sphere.Radius, sphere.Radius );
+    return BoundingBox( sphere.Center - r, sphere.Center + r );
+}
+
+//-----------------------------------------------------------------------------
+//      2つの境界箱を包含する境界箱を求めます.
+//-----------------------------------------------------------------------------
+inline
+BoundingBox BoundingBox::Merge( const BoundingBox& a, const BoundingBox& b )
+{ return BoundingBox( Vector3::Min( a.Min, b.Min ), Vector3::Max( a.Max, b.Max ) ); }
+
+//-----------------------------------------------------------------------------
+//      変換後の境界箱を包含する境界箱を求めます.
+//-----------------------------------------------------------------------------
+inline
+BoundingBox BoundingBox::Transform( const BoundingBox& box, const Matrix& matrix )
+{
+    if ( box.IsEmpty() )
+    { return box; }
+
+    auto center  = Vector3::Transform( box.GetCenter(), matrix );
+    auto extents = box.GetExtents();
+
+    // 各軸の広がりは行列要素の絶対値で重み付けした和になる.
+    auto x = ( extents.x * fabsf( matrix._11 ) + extents.y * fabsf( matrix._21 ) ) + extents.z * fabsf( matrix._31 );
+    auto y = ( extents.x * fabsf( matrix._12 ) + extents.y * fabsf( matrix._22 ) ) + extents.z * fabsf( matrix._32 );
+    auto z = ( extents.x * fabsf( matrix._13 ) + extents.y * fabsf( matrix._23 ) ) + extents.z * fabsf( matrix._33 );
+    auto e = Vector3( x, y, z );
+
+    return BoundingBox( center - e, center + e );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingSphere structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      原点を中心とする半径0の境界球を生成します.
+//-----------------------------------------------------------------------------
+inline
+BoundingSphere::BoundingSphere()
+: Center( 0.0f, 0.0f, 0.0f )
+, Radius( 0.0f )
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      中心座標と半径を指定して生成します.
+//-----------------------------------------------------------------------------
+inline
+BoundingSphere::BoundingSphere( const Vector3& center, float radius )
+: Center( center )
+, Radius( radius )
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      点を包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingSphere::Contains( const Vector3& point ) const
+{ return Vector3::DistanceSq( point, Center ) <= Radius * Radius; }
+
+//-----------------------------------------------------------------------------
+//      境界箱を完全に包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingSphere::Contains( const BoundingBox& box ) const
+{
+    // 中心から最も遠い角で判定する.
+    auto dx = Max( fabsf( box.Min.x - Center.x ), fabsf( box.Max.x - Center.x ) );
+    auto dy = Max( fabsf( box.Min.y - Center.y ), fabsf( box.Max.y - Center.y ) );
+    auto dz = Max( fabsf( box.Min.z - Center.z ), fabsf( box.Max.z - Center.z ) );
+    return ( dx * dx + dy * dy ) + dz * dz <= Radius * Radius;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球を完全に包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingSphere::Contains( const BoundingSphere& sphere ) const
+{
+    auto r = Radius - sphere.Radius;
+    return ( r >= 0.0f ) && ( Vector3::DistanceSq( sphere.Center, Center ) <= r * r );
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingSphere::Intersects( const BoundingBox& box ) const
+{ return box.Intersects( *this ); }
+
+//-----------------------------------------------------------------------------
+//      境界球と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool BoundingSphere::Intersects( const BoundingSphere& sphere ) const
+{
+    auto r = Radius + sphere.Radius;
+    return Vector3::DistanceSq( sphere.Center, Center ) <= r * r;
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱を包含する境界球を生成します.
+//-----------------------------------------------------------------------------
+inline
+BoundingSphere BoundingSphere::CreateFromBox( const BoundingBox& box )
+{ return BoundingSphere( box.GetCenter(), box.GetExtents().Length() ); }
+
+//-----------------------------------------------------------------------------
+//      変換後の境界球を包含する境界球を求めます.
+//-----------------------------------------------------------------------------
+inline
+BoundingSphere BoundingSphere::Transform( const BoundingSphere& sphere, const Matrix& matrix )
+{
+    auto sx = Vector3( matrix._11, matrix._12, matrix._13 ).LengthSq();
+    auto sy = Vector3( matrix._21, matrix._22, matrix._23 ).LengthSq();
+    auto sz = Vector3( matrix._31, matrix._32, matrix._33 ).LengthSq();
+    auto s  = sqrt( Max( sx, Max( sy, sz ) ) );
+
+    return BoundingSphere( Vector3::Transform( sphere.Center, matrix ), sphere.Radius * s );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// OrientedBox structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      原点を中心とする大きさ0の有向境界箱を生成します.
+//-----------------------------------------------------------------------------
+inline
+OrientedBox::OrientedBox()
+: Center ( 0.0f, 0.0f, 0.0f )
+, Extents( 0.0f, 0.0f, 0.0f )
+{
+    Axis[0] = Vector3( 1.0f, 0.0f, 0.0f );
+    Axis[1] = Vector3( 0.0f, 1.0f, 0.0f );
+    Axis[2] = Vector3( 0.0f, 0.0f, 1.0f );
+}
+
+//-----------------------------------------------------------------------------
+//      中心座標, 広がり, 回転を指定して生成します.
+//-----------------------------------------------------------------------------
+inline
+OrientedBox::OrientedBox( const Vector3& center, const Vector3& extents, const Quaternion& orientation )
+: Center ( center )
+, Extents( extents )
+{
+    auto m = Matrix::CreateFromQuaternion( orientation );
+    Axis[0] = Vector3( m._11, m._12, m._13 );
+    Axis[1] = Vector3( m._21, m._22, m._23 );
+    Axis[2] = Vector3( m._31, m._32, m._33 );
+}
+
+//-----------------------------------------------------------------------------
+//      8角の座標を取得します.
+//-----------------------------------------------------------------------------
+inline
+void OrientedBox::GetCorners( Vector3* corners ) const
+{
+    auto ax = Axis[0] * Extents.x;
+    auto ay = Axis[1] * Extents.y;
+    auto az = Axis[2] * Extents.z;
+
+    for(auto i=0; i<8; ++i)
+    {
+        corners[i] = Center;
+        corners[i] += ( i & 1 ) ? ax : -ax;
+        corners[i] += ( i & 2 ) ? ay : -ay;
+        corners[i] += ( i & 4 ) ? az : -az;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      包含する軸並行境界箱を取得します.
+//-----------------------------------------------------------------------------
+inline
+BoundingBox OrientedBox::GetBoundingBox() const
+{
+    auto e = Vector3::Abs( Axis[0] ) * Extents.x
+           + Vector3::Abs( Axis[1] ) * Extents.y
+           + Vector3::Abs( Axis[2] ) * Extents.z;
+    return BoundingBox( Center - e, Center + e );
+}
+
+//-----------------------------------------------------------------------------
+//      点を包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool OrientedBox::Contains( const Vector3& point ) const
+{
+    auto v = point - Center;
+    return ( fabsf( Vector3::Dot( v, Axis[0] ) ) <= Extents.x )
+        && ( fabsf( Vector3::Dot( v, Axis[1] ) ) <= Extents.y )
+        && ( fabsf( Vector3::Dot( v, Axis[2] ) ) <= Extents.z );
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool OrientedBox::Intersects( const BoundingSphere& sphere ) const
+{
+    // 局所空間で最近接点までの距離を求める.
+    auto v  = sphere.Center - Center;
+    auto dx = Max( fabsf( Vector3::Dot( v, Axis[0] ) ) - Extents.x, 0.0f );
+    auto dy = Max( fabsf( Vector3::Dot( v, Axis[1] ) ) - Extents.y, 0.0f );
+    auto dz = Max( fabsf( Vector3::Dot( v, Axis[2] ) ) - Extents.z, 0.0f );
+    return ( dx * dx + dy * dy ) + dz * dz <= sphere.Radius * sphere.Radius;
+}
+
+//-----------------------------------------------------------------------------
+//      軸並行境界箱と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool OrientedBox::Intersects( const BoundingBox& box ) const
+{
+    OrientedBox obb;
+    obb.Center  = box.GetCenter();
+    obb.Extents = box.GetExtents();
+    return Intersects( obb );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Frustum structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      全ての点を含まない視錐台を生成します.
+//-----------------------------------------------------------------------------
+inline
+Frustum::Frustum()
+{
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    { Planes[i] = Vector4( 0.0f, 0.0f, 0.0f, -FLT_MAX ); }
+}
+
+//-----------------------------------------------------------------------------
+//      ビュー行列と射影行列から生成します.
+//-----------------------------------------------------------------------------
+inline
+Frustum::Frustum( const Matrix& view, const Matrix& proj )
+{ CalcFrustumPlanes( view, proj, Planes ); }
+
+//-----------------------------------------------------------------------------
+//      平面から生成します.
+//-----------------------------------------------------------------------------
+inline
+Frustum::Frustum( const Vector4* planes )
+{
+    assert( planes != nullptr );
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    { Planes[i] = planes[i]; }
+}
+
+//-----------------------------------------------------------------------------
+//      8角の座標を取得します.
+//-----------------------------------------------------------------------------
+inline
+void Frustum::GetCorners( Vector3* corners ) const
+{ asdx::GetCorners( Planes, corners ); }
+
+//-----------------------------------------------------------------------------
+//      点を包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool Frustum::Contains( const Vector3& point ) const
+{
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        if ( !( CalcPlaneDistance( Planes[i], point.x, point.y, point.z ) >= 0.0f ) )
+        { return false; }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱を完全に包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool Frustum::Contains( const BoundingBox& box ) const
+{
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        // 法線方向に最も近い頂点で判定する.
+        auto& p = Planes[i];
+        auto x = ( p.x >= 0.0f ) ? box.Min.x : box.Max.x;
+        auto y = ( p.y >= 0.0f ) ? box.Min.y : box.Max.y;
+        auto z = ( p.z >= 0.0f ) ? box.Min.z : box.Max.z;
+        if ( !( CalcPlaneDistance( p, x, y, z ) >= 0.0f ) )
+        { return false; }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球を完全に包含するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool Frustum::Contains( const BoundingSphere& sphere ) const
+{
+    auto& c = sphere.Center;
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        if ( !( CalcPlaneDistance( Planes[i], c.x, c.y, c.z ) >= sphere.Radius ) )
+        { return false; }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool Frustum::Intersects( const BoundingSphere& sphere ) const
+{
+    auto& c = sphere.Center;
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        if ( !( CalcPlaneDistance( Planes[i], c.x, c.y, c.z ) >= -sphere.Radius ) )
+        { return false; }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool Frustum::Intersects( const BoundingBox& box ) const
+{
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        // 法線方向に最も遠い頂点で判定する.
+        auto& p = Planes[i];
+        auto x = ( p.x >= 0.0f ) ? box.Max.x : box.Min.x;
+        auto y = ( p.y >= 0.0f ) ? box.Max.y : box.Min.y;
+        auto z = ( p.z >= 0.0f ) ? box.Max.z : box.Min.z;
+        if ( !( CalcPlaneDistance( p, x, y, z ) >= 0.0f ) )
+        { return false; }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      有向境界箱と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline
+bool Frustum::Intersects( const OrientedBox& box ) const
+{
+    auto& c = box.Center;
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        // 平面の法線に投影した半径で判定する.
+        auto& p = Planes[i];
+        auto r0 = fabsf( ( p.x * box.Axis[0].x + p.y * box.Axis[0].y ) + p.z * box.Axis[0].z ) * box.Extents.x;
+        auto r1 = fabsf( ( p.x * box.Axis[1].x + p.y * box.Axis[1].y ) + p.z * box.Axis[1].z ) * box.Extents.y;
+        auto r2 = fabsf( ( p.x * box.Axis[2].x + p.y * box.Axis[2].y ) + p.z * box.Axis[2].z ) * box.Extents.z;
+        auto r  = ( r0 + r1 ) + r2;
+        if ( !( CalcPlaneDistance( p, c.x, c.y, c.z ) >= -r ) )
+        { return false; }
+    }
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingBoxX4 structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      全レーンを空の境界箱で初期化します.
+//-----------------------------------------------------------------------------
+inline
+BoundingBoxX4::BoundingBoxX4()
+{
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    { Set( i, BoundingBox() ); }
+}
+
+//-----------------------------------------------------------------------------
+//      レーンに境界箱を設定します.
+//-----------------------------------------------------------------------------
+inline
+void BoundingBoxX4::Set( uint32_t lane, const BoundingBox& box )
+{
+    assert( lane < BOUNDS_LANE_COUNT );
+    MinX[lane] = box.Min.x;
+    MinY[lane] = box.Min.y;
+    MinZ[lane] = box.Min.z;
+    MaxX[lane] = box.Max.x;
+    MaxY[lane] = box.Max.y;
+    MaxZ[lane] = box.Max.z;
+}
+
+//-----------------------------------------------------------------------------
+//      レーンの境界箱を取得します.
+//-----------------------------------------------------------------------------
+inline
+BoundingBox BoundingBoxX4::Get( uint32_t lane ) const
+{
+    assert( lane < BOUNDS_LANE_COUNT );
+    return BoundingBox(
+        Vector3( MinX[lane], MinY[lane], MinZ[lane] ),
+        Vector3( MaxX[lane], MaxY[lane], MaxZ[lane] ) );
+}
+
+//-----------------------------------------------------------------------------
+//      点を包含するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t BoundingBoxX4::Contains( const Vector3& point ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto px = _mm_set1_ps( point.x );
+    auto py = _mm_set1_ps( point.y );
+    auto pz = _mm_set1_ps( point.z );
+    auto hit = _mm_and_ps( _mm_cmple_ps( _mm_load_ps( MinX ), px ), _mm_cmple_ps( px, _mm_load_ps( MaxX ) ) );
+    hit = _mm_and_ps( hit, _mm_and_ps( _mm_cmple_ps( _mm_load_ps( MinY ), py ), _mm_cmple_ps( py, _mm_load_ps( MaxY ) ) ) );
+    hit = _mm_and_ps( hit, _mm_and_ps( _mm_cmple_ps( _mm_load_ps( MinZ ), pz ), _mm_cmple_ps( pz, _mm_load_ps( MaxZ ) ) ) );
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Get( i ).Contains( point ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱と交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t BoundingBoxX4::Intersects( const BoundingBox& box ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto hit = _mm_and_ps( _mm_cmple_ps( _mm_load_ps( MinX ), _mm_set1_ps( box.Max.x ) ), _mm_cmple_ps( _mm_set1_ps( box.Min.x ), _mm_load_ps( MaxX ) ) );
+    hit = _mm_and_ps( hit, _mm_and_ps( _mm_cmple_ps( _mm_load_ps( MinY ), _mm_set1_ps( box.Max.y ) ), _mm_cmple_ps( _mm_set1_ps( box.Min.y ), _mm_load_ps( MaxY ) ) ) );
+    hit = _mm_and_ps( hit, _mm_and_ps( _mm_cmple_ps( _mm_load_ps( MinZ ), _mm_set1_ps( box.Max.z ) ), _mm_cmple_ps( _mm_set1_ps( box.Min.z ), _mm_load_ps( MaxZ ) ) ) );
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Get( i ).Intersects( box ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t BoundingBoxX4::Intersects( const BoundingSphere& sphere ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto cx = _mm_set1_ps( sphere.Center.x );
+    auto cy = _mm_set1_ps( sphere.Center.y );
+    auto cz = _mm_set1_ps( sphere.Center.z );
+    auto dx = _mm_sub_ps( _mm_max_ps( _mm_load_ps( MinX ), _mm_min_ps( cx, _mm_load_ps( MaxX ) ) ), cx );
+    auto dy = _mm_sub_ps( _mm_max_ps( _mm_load_ps( MinY ), _mm_min_ps( cy, _mm_load_ps( MaxY ) ) ), cy );
+    auto dz = _mm_sub_ps( _mm_max_ps( _mm_load_ps( MinZ ), _mm_min_ps( cz, _mm_load_ps( MaxZ ) ) ), cz );
+    auto d2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+    auto r2 = _mm_set1_ps( sphere.Radius * sphere.Radius );
+    return uint32_t( _mm_movemask_ps( _mm_cmple_ps( d2, r2 ) ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Get( i ).Intersects( sphere ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingSphereX4 structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      全レーンを空の境界球で初期化します.
+//-----------------------------------------------------------------------------
+inline
+BoundingSphereX4::BoundingSphereX4()
+{
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    { Set( i, BoundingSphere( Vector3( 0.0f, 0.0f, 0.0f ), -FLT_MAX ) ); }
+}
+
+//-----------------------------------------------------------------------------
+//      レーンに境界球を設定します.
+//-----------------------------------------------------------------------------
+inline
+void BoundingSphereX4::Set( uint32_t lane, const BoundingSphere& sphere )
+{
+    assert( lane < BOUNDS_LANE_COUNT );
+    CenterX[lane] = sphere.Center.x;
+    CenterY[lane] = sphere.Center.y;
+    CenterZ[lane] = sphere.Center.z;
+    Radius [lane] = sphere.Radius;
+}
+
+//-----------------------------------------------------------------------------
+//      レーンの境界球を取得します.
+//-----------------------------------------------------------------------------
+inline
+BoundingSphere BoundingSphereX4::Get( uint32_t lane ) const
+{
+    assert( lane < BOUNDS_LANE_COUNT );
+    return BoundingSphere( Vector3( CenterX[lane], CenterY[lane], CenterZ[lane] ), Radius[lane] );
+}
+
+//-----------------------------------------------------------------------------
+//      点を包含するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t BoundingSphereX4::Contains( const Vector3& point ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto dx = _mm_sub_ps( _mm_set1_ps( point.x ), _mm_load_ps( CenterX ) );
+    auto dy = _mm_sub_ps( _mm_set1_ps( point.y ), _mm_load_ps( CenterY ) );
+    auto dz = _mm_sub_ps( _mm_set1_ps( point.z ), _mm_load_ps( CenterZ ) );
+    auto d2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+    auto r  = _mm_load_ps( Radius );
+    auto hit = _mm_and_ps( _mm_cmple_ps( d2, _mm_mul_ps( r, r ) ), _mm_cmpge_ps( r, _mm_setzero_ps() ) );
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Radius[i] >= 0.0f && Get( i ).Contains( point ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱と交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t BoundingSphereX4::Intersects( const BoundingBox& box ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto cx = _mm_load_ps( CenterX );
+    auto cy = _mm_load_ps( CenterY );
+    auto cz = _mm_load_ps( CenterZ );
+    auto dx = _mm_sub_ps( _mm_max_ps( _mm_set1_ps( box.Min.x ), _mm_min_ps( cx, _mm_set1_ps( box.Max.x ) ) ), cx );
+    auto dy = _mm_sub_ps( _mm_max_ps( _mm_set1_ps( box.Min.y ), _mm_min_ps( cy, _mm_set1_ps( box.Max.y ) ) ), cy );
+    auto dz = _mm_sub_ps( _mm_max_ps( _mm_set1_ps( box.Min.z ), _mm_min_ps( cz, _mm_set1_ps( box.Max.z ) ) ), cz );
+    auto d2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+    auto r  = _mm_load_ps( Radius );
+    auto hit = _mm_and_ps( _mm_cmple_ps( d2, _mm_mul_ps( r, r ) ), _mm_cmpge_ps( r, _mm_setzero_ps() ) );
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Radius[i] >= 0.0f && box.Intersects( Get( i ) ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t BoundingSphereX4::Intersects( const BoundingSphere& sphere ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto dx = _mm_sub_ps( _mm_set1_ps( sphere.Center.x ), _mm_load_ps( CenterX ) );
+    auto dy = _mm_sub_ps( _mm_set1_ps( sphere.Center.y ), _mm_load_ps( CenterY ) );
+    auto dz = _mm_sub_ps( _mm_set1_ps( sphere.Center.z ), _mm_load_ps( CenterZ ) );
+    auto d2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+    auto r  = _mm_add_ps( _mm_load_ps( Radius ), _mm_set1_ps( sphere.Radius ) );
+    auto hit = _mm_and_ps( _mm_cmple_ps( d2, _mm_mul_ps( r, r ) ), _mm_cmpge_ps( r, _mm_setzero_ps() ) );
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Radius[i] + sphere.Radius >= 0.0f && Get( i ).Intersects( sphere ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// OrientedBoxX4 structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      全レーンを空の有向境界箱で初期化します.
+//-----------------------------------------------------------------------------
+inline
+OrientedBoxX4::OrientedBoxX4()
+{
+    OrientedBox empty;
+    empty.Extents = Vector3( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    { Set( i, empty ); }
+}
+
+//-----------------------------------------------------------------------------
+//      レーンに有向境界箱を設定します.
+//-----------------------------------------------------------------------------
+inline
+void OrientedBoxX4::Set( uint32_t lane, const OrientedBox& box )
+{
+    assert( lane < BOUNDS_LANE_COUNT );
+    CenterX[lane] = box.Center.x;
+    CenterY[lane] = box.Center.y;
+    CenterZ[lane] = box.Center.z;
+    Extents[0][lane] = box.Extents.x;
+    Extents[1][lane] = box.Extents.y;
+    Extents[2][lane] = box.Extents.z;
+    for(auto i=0; i<3; ++i)
+    {
+        Axis[i][0][lane] = box.Axis[i].x;
+        Axis[i][1][lane] = box.Axis[i].y;
+        Axis[i][2][lane] = box.Axis[i].z;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      レーンの有向境界箱を取得します.
+//-----------------------------------------------------------------------------
+inline
+OrientedBox OrientedBoxX4::Get( uint32_t lane ) const
+{
+    assert( lane < BOUNDS_LANE_COUNT );
+    OrientedBox result;
+    result.Center  = Vector3( CenterX[lane], CenterY[lane], CenterZ[lane] );
+    result.Extents = Vector3( Extents[0][lane], Extents[1][lane], Extents[2][lane] );
+    for(auto i=0; i<3; ++i)
+    { result.Axis[i] = Vector3( Axis[i][0][lane], Axis[i][1][lane], Axis[i][2][lane] ); }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      点を包含するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t OrientedBoxX4::Contains( const Vector3& point ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto vx = _mm_sub_ps( _mm_set1_ps( point.x ), _mm_load_ps( CenterX ) );
+    auto vy = _mm_sub_ps( _mm_set1_ps( point.y ), _mm_load_ps( CenterY ) );
+    auto vz = _mm_sub_ps( _mm_set1_ps( point.z ), _mm_load_ps( CenterZ ) );
+    auto hit = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+    for(auto i=0; i<3; ++i)
+    {
+        auto d = _mm_add_ps( _mm_add_ps(
+            _mm_mul_ps( vx, _mm_load_ps( Axis[i][0] ) ),
+            _mm_mul_ps( vy, _mm_load_ps( Axis[i][1] ) ) ),
+            _mm_mul_ps( vz, _mm_load_ps( Axis[i][2] ) ) );
+        hit = _mm_and_ps( hit, _mm_cmple_ps( SimdAbs( d ), _mm_load_ps( Extents[i] ) ) );
+    }
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Get( i ).Contains( point ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t OrientedBoxX4::Intersects( const BoundingSphere& sphere ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto vx = _mm_sub_ps( _mm_set1_ps( sphere.Center.x ), _mm_load_ps( CenterX ) );
+    auto vy = _mm_sub_ps( _mm_set1_ps( sphere.Center.y ), _mm_load_ps( CenterY ) );
+    auto vz = _mm_sub_ps( _mm_set1_ps( sphere.Center.z ), _mm_load_ps( CenterZ ) );
+    auto zero = _mm_setzero_ps();
+
+    __m128 d[3];
+    for(auto i=0; i<3; ++i)
+    {
+        auto t = _mm_add_ps( _mm_add_ps(
+            _mm_mul_ps( vx, _mm_load_ps( Axis[i][0] ) ),
+            _mm_mul_ps( vy, _mm_load_ps( Axis[i][1] ) ) ),
+            _mm_mul_ps( vz, _mm_load_ps( Axis[i][2] ) ) );
+        d[i] = _mm_max_ps( _mm_sub_ps( SimdAbs( t ), _mm_load_ps( Extents[i] ) ), zero );
+    }
+
+    auto d2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( d[0], d[0] ), _mm_mul_ps( d[1], d[1] ) ), _mm_mul_ps( d[2], d[2] ) );
+    auto r2 = _mm_set1_ps( sphere.Radius * sphere.Radius );
+    return uint32_t( _mm_movemask_ps( _mm_cmple_ps( d2, r2 ) ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Get( i ).Intersects( sphere ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Frustum structure (batched)
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      4個の境界球のうち交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t Frustum::Intersects( const BoundingSphereX4& spheres ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto cx = _mm_load_ps( spheres.CenterX );
+    auto cy = _mm_load_ps( spheres.CenterY );
+    auto cz = _mm_load_ps( spheres.CenterZ );
+    auto nr = _mm_xor_ps( _mm_load_ps( spheres.Radius ), _mm_set1_ps( -0.0f ) );
+    auto hit = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        auto& p = Planes[i];
+        auto d = _mm_mul_ps( _mm_set1_ps( p.x ), cx );
+        d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( p.y ), cy ) );
+        d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( p.z ), cz ) );
+        d = _mm_add_ps( d, _mm_set1_ps( p.w ) );
+        hit = _mm_and_ps( hit, _mm_cmpge_ps( d, nr ) );
+    }
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Intersects( spheres.Get( i ) ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      4個の境界箱のうち交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t Frustum::Intersects( const BoundingBoxX4& boxes ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto zero = _mm_setzero_ps();
+    auto hit  = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        // 法線の符号は全レーン共通なので, 読み込む配列を選ぶだけで良い.
+        auto& p = Planes[i];
+        auto x = _mm_load_ps( ( p.x >= 0.0f ) ? boxes.MaxX : boxes.MinX );
+        auto y = _mm_load_ps( ( p.y >= 0.0f ) ? boxes.MaxY : boxes.MinY );
+        auto z = _mm_load_ps( ( p.z >= 0.0f ) ? boxes.MaxZ : boxes.MinZ );
+        auto d = _mm_mul_ps( _mm_set1_ps( p.x ), x );
+        d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( p.y ), y ) );
+        d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( p.z ), z ) );
+        d = _mm_add_ps( d, _mm_set1_ps( p.w ) );
+        hit = _mm_and_ps( hit, _mm_cmpge_ps( d, zero ) );
+    }
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Intersects( boxes.Get( i ) ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      4個の有向境界箱のうち交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t Frustum::Intersects( const OrientedBoxX4& boxes ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto cx  = _mm_load_ps( boxes.CenterX );
+    auto cy  = _mm_load_ps( boxes.CenterY );
+    auto cz  = _mm_load_ps( boxes.CenterZ );
+    auto hit = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        auto& p = Planes[i];
+        auto px = _mm_set1_ps( p.x );
+        auto py = _mm_set1_ps( p.y );
+        auto pz = _mm_set1_ps( p.z );
+
+        __m128 r[3];
+        for(auto j=0; j<3; ++j)
+        {
+            auto t = _mm_add_ps( _mm_add_ps(
+                _mm_mul_ps( px, _mm_load_ps( boxes.Axis[j][0] ) ),
+                _mm_mul_ps( py, _mm_load_ps( boxes.Axis[j][1] ) ) ),
+                _mm_mul_ps( pz, _mm_load_ps( boxes.Axis[j][2] ) ) );
+            r[j] = _mm_mul_ps( SimdAbs( t ), _mm_load_ps( boxes.Extents[j] ) );
+        }
+        auto nr = _mm_xor_ps( _mm_add_ps( _mm_add_ps( r[0], r[1] ), r[2] ), _mm_set1_ps( -0.0f ) );
+
+        auto d = _mm_mul_ps( px, cx );
+        d = _mm_add_ps( d, _mm_mul_ps( py, cy ) );
+        d = _mm_add_ps( d, _mm_mul_ps( pz, cz ) );
+        d = _mm_add_ps( d, _mm_set1_ps( p.w ) );
+        hit = _mm_and_ps( hit, _mm_cmpge_ps( d, nr ) );
+    }
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Intersects( boxes.Get( i ) ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FrustumX4 structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      全レーンを何も含まない視錐台で初期化します.
+//-----------------------------------------------------------------------------
+inline
+FrustumX4::FrustumX4()
+{
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    { Set( i, Frustum() ); }
+}
+
+//-----------------------------------------------------------------------------
+//      レーンに視錐台を設定します.
+//-----------------------------------------------------------------------------
+inline
+void FrustumX4::Set( uint32_t lane, const Frustum& frustum )
+{
+    assert( lane < BOUNDS_LANE_COUNT );
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        PlaneX[i][lane] = frustum.Planes[i].x;
+        PlaneY[i][lane] = frustum.Planes[i].y;
+        PlaneZ[i][lane] = frustum.Planes[i].z;
+        PlaneW[i][lane] = frustum.Planes[i].w;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      レーンの視錐台を取得します.
+//-----------------------------------------------------------------------------
+inline
+Frustum FrustumX4::Get( uint32_t lane ) const
+{
+    assert( lane < BOUNDS_LANE_COUNT );
+    Frustum result;
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    { result.Planes[i] = Vector4( PlaneX[i][lane], PlaneY[i][lane], PlaneZ[i][lane], PlaneW[i][lane] ); }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      点を包含するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t FrustumX4::Contains( const Vector3& point ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto x = _mm_set1_ps( point.x );
+    auto y = _mm_set1_ps( point.y );
+    auto z = _mm_set1_ps( point.z );
+    auto zero = _mm_setzero_ps();
+    auto hit  = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        auto d = _mm_mul_ps( _mm_load_ps( PlaneX[i] ), x );
+        d = _mm_add_ps( d, _mm_mul_ps( _mm_load_ps( PlaneY[i] ), y ) );
+        d = _mm_add_ps( d, _mm_mul_ps( _mm_load_ps( PlaneZ[i] ), z ) );
+        d = _mm_add_ps( d, _mm_load_ps( PlaneW[i] ) );
+        hit = _mm_and_ps( hit, _mm_cmpge_ps( d, zero ) );
+    }
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Get( i ).Contains( point ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t FrustumX4::Intersects( const BoundingSphere& sphere ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto x  = _mm_set1_ps( sphere.Center.x );
+    auto y  = _mm_set1_ps( sphere.Center.y );
+    auto z  = _mm_set1_ps( sphere.Center.z );
+    auto nr = _mm_set1_ps( -sphere.Radius );
+    auto hit = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        auto d = _mm_mul_ps( _mm_load_ps( PlaneX[i] ), x );
+        d = _mm_add_ps( d, _mm_mul_ps( _mm_load_ps( PlaneY[i] ), y ) );
+        d = _mm_add_ps( d, _mm_mul_ps( _mm_load_ps( PlaneZ[i] ), z ) );
+        d = _mm_add_ps( d, _mm_load_ps( PlaneW[i] ) );
+        hit = _mm_and_ps( hit, _mm_cmpge_ps( d, nr ) );
+    }
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Get( i ).Intersects( sphere ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱と交差するレーンのマスクを求めます.
+//-----------------------------------------------------------------------------
+inline
+uint32_t FrustumX4::Intersects( const BoundingBox& box ) const
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto minX = _mm_set1_ps( box.Min.x );
+    auto minY = _mm_set1_ps( box.Min.y );
+    auto minZ = _mm_set1_ps( box.Min.z );
+    auto maxX = _mm_set1_ps( box.Max.x );
+    auto maxY = _mm_set1_ps( box.Max.y );
+    auto maxZ = _mm_set1_ps( box.Max.z );
+    auto zero = _mm_setzero_ps();
+    auto hit  = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    {
+        // 法線の符号がレーンごとに異なるため, マスクで頂点を選ぶ.
+        auto px = _mm_load_ps( PlaneX[i] );
+        auto py = _mm_load_ps( PlaneY[i] );
+        auto pz = _mm_load_ps( PlaneZ[i] );
+        auto x  = SimdSelect( _mm_cmpge_ps( px, zero ), maxX, minX );
+        auto y  = SimdSelect( _mm_cmpge_ps( py, zero ), maxY, minY );
+        auto z  = SimdSelect( _mm_cmpge_ps( pz, zero ), maxZ, minZ );
+        auto d  = _mm_mul_ps( px, x );
+        d = _mm_add_ps( d, _mm_mul_ps( py, y ) );
+        d = _mm_add_ps( d, _mm_mul_ps( pz, z ) );
+        d = _mm_add_ps( d, _mm_load_ps( PlaneW[i] ) );
+        hit = _mm_and_ps( hit, _mm_cmpge_ps( d, zero ) );
+    }
+    return uint32_t( _mm_movemask_ps( hit ) );
+#else
+    uint32_t mask = 0;
+    for(auto i=0u; i<BOUNDS_LANE_COUNT; ++i)
+    {
+        if ( Get( i ).Intersects( box ) )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif
+}
+
+} // namespace asdx
@@ -0,0 +1,94 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxCulling.h
+// Desc : Frustum Culling.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxMath.h>
+#include <asdxBounds.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   CULLING_PLANE_COUNT         = FRUSTUM_PLANE_COUNT;  //!< 視錐台平面数.
+static constexpr size_t     CULLING_PARALLEL_THRESHOLD  = 65536;    //!< マルチスレッド処理を行う最小要素数.
+
+///////////////////////////////////////////////////////////////////////////////
+// CullingSpheres structure
+///////////////////////////////////////////////////////////////////////////////
+struct CullingSpheres
+{
+    const float*    pCenterX    = nullptr;  //!< 中心座標のX成分配列.
+    const float*    pCenterY    = nullptr;  //!< 中心座標のY成分配列.
+    const float*    pCenterZ    = nullptr;  //!< 中心座標のZ成分配列.
+    const float*    pRadius     = nullptr;  //!< 半径配列.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// CullingBoxes structure
+///////////////////////////////////////////////////////////////////////////////
+struct CullingBoxes
+{
+    const float*    pMinX   = nullptr;      //!< 最小値のX成分配列.
+    const float*    pMinY   = nullptr;      //!< 最小値のY成分配列.
+    const float*    pMinZ   = nullptr;      //!< 最小値のZ成分配列.
+    const float*    pMaxX   = nullptr;      //!< 最大値のX成分配列.
+    const float*    pMaxY   = nullptr;      //!< 最大値のY成分配列.
+    const float*    pMaxZ   = nullptr;      //!< 最大値のZ成分配列.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      可視判定ビットマスクに必要な32bitワード数を取得します.
+//!
+//! @param[in]      count       判定する要素数.
+//! @return     (count + 31) / 32 を返却します.
+//-----------------------------------------------------------------------------
+inline size_t GetCullingMaskWordCount(size_t count)
+{ return (count + 31) / 32; }
+
+//-----------------------------------------------------------------------------
+//! @brief      境界球を視錐台カリングします.
+//!
+//! @param[in]      planes          CalcFrustumPlanes() で求めた6枚の平面.
+//! @param[in]      spheres         SoA形式の境界球.
+//! @param[in]      count           境界球の数.
+//! @param[out]     pVisibleMask    可視判定結果の格納先(GetCullingMaskWordCount(count) ワード).
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @return     可視と判定された要素数を返却します.
+//! @note       i番目の要素が可視であれば pVisibleMask[i / 32] の (i % 32) ビット目が立ちます.
+//!             末尾ワードの余りビットは0になります.
+//!             要素数が CULLING_PARALLEL_THRESHOLD 未満の場合は常にシングルスレッドで処理します.
+//-----------------------------------------------------------------------------
+size_t CullSpheres(
+    const Vector4*          planes,
+    const CullingSpheres&   spheres,
+    size_t                  count,
+    uint32_t*               pVisibleMask,
+    uint32_t                maxThreadCount = 1);
+
+//-----------------------------------------------------------------------------
+//! @brief      軸並行境界箱を視錐台カリングします.
+//!
+//! @param[in]      planes          CalcFrustumPlanes() で求めた6枚の平面.
+//! @param[in]      boxes           SoA形式の軸並行境界箱.
+//! @param[in]      count           境界箱の数.
+//! @param[out]     pVisibleMask    可視判定結果の格納先(GetCullingMaskWordCount(count) ワード).
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @return     可視と判定された要素数を返却します.
+//! @note       各平面について法線方向に最も遠い頂点のみを判定するため, 保守的な結果になります.
+//-----------------------------------------------------------------------------
+size_t CullBoxes(
+    const Vector4*          planes,
+    const CullingBoxes&     boxes,
+    size_t                  count,
+    uint32_t*               pVisibleMask,
+    uint32_t                maxThreadCount = 1);
+
+} // namespace asdx
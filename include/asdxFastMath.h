@@ -0,0 +1,195 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxFastMath.h
+// Desc : Fast Approximation Math Functions.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxMath.h>
+
+// 各関数は精度の異なる2段階を持ちます.
+//  - XxxEst : 低精度で高速な版.
+//  - Xxx    : float の丸め誤差程度の精度を持つ版.
+// 最大誤差は定数として定義しており, スカラー版と配列版は同じ結果を返します(FMA縮約無効時).
+// ASDX_ENABLE_SIMD を定義すると配列版は4要素ずつSSE2で処理します.
+
+
+namespace asdx {
+namespace fast {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr float SINCOS_MAX_DOMAIN        = 65536.0f;     //!< SinCos() の最大誤差を保証する入力の絶対値の上限です.
+static constexpr float SINCOS_EST_MAX_ERROR     = 1.3e-5f;      //!< SinCosEst() の最大絶対誤差です.
+static constexpr float SINCOS_MAX_ERROR         = 2.5e-7f;      //!< SinCos() の最大絶対誤差です.
+static constexpr float RSQRT_EST_MAX_ERROR      = 1.8e-3f;      //!< RsqrtEst() の最大相対誤差です.
+static constexpr float RSQRT_MAX_ERROR          = 3.0e-7f;      //!< Rsqrt() の最大相対誤差です.
+static constexpr float EXP2_EST_MAX_ERROR       = 1.1e-4f;      //!< Exp2Est() の最大相対誤差です.
+static constexpr float EXP2_MAX_ERROR           = 3.0e-7f;      //!< Exp2() の最大相対誤差です.
+static constexpr float LOG2_EST_MAX_ERROR       = 1.1e-4f;      //!< Log2Est() の最大誤差です(結果の絶対値が1を超える場合は相対誤差).
+static constexpr float LOG2_MAX_ERROR           = 2.5e-7f;      //!< Log2() の最大誤差です(結果の絶対値が1を超える場合は相対誤差).
+static constexpr float ATAN2_EST_MAX_ERROR      = 9.0e-5f;      //!< Atan2Est() の最大絶対誤差です.
+static constexpr float ATAN2_MAX_ERROR          = 4.0e-7f;      //!< Atan2() の最大絶対誤差です.
+static constexpr float ACOS_EST_MAX_ERROR       = 4.0e-5f;      //!< AcosEst() の最大絶対誤差です.
+static constexpr float ACOS_MAX_ERROR           = 4.0e-7f;      //!< Acos() の最大絶対誤差です.
+
+
+//-----------------------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//! @brief      正弦と余弦を低精度で求めます.
+//!
+//! @param[in]      radian      角度(ラジアン).
+//! @param[out]     s           正弦.
+//! @param[out]     c           余弦.
+//! @note       |radian| <= SINCOS_MAX_DOMAIN で最大絶対誤差は SINCOS_EST_MAX_ERROR です.
+//-----------------------------------------------------------------------------
+void SinCosEst( float radian, float& s, float& c );
+
+//-----------------------------------------------------------------------------
+//! @brief      正弦と余弦を求めます.
+//!
+//! @param[in]      radian      角度(ラジアン).
+//! @param[out]     s           正弦.
+//! @param[out]     c           余弦.
+//! @note       |radian| <= SINCOS_MAX_DOMAIN で最大絶対誤差は SINCOS_MAX_ERROR です.
+//-----------------------------------------------------------------------------
+void SinCos( float radian, float& s, float& c );
+
+//-----------------------------------------------------------------------------
+//! @brief      平方根の逆数を低精度で求めます.
+//!
+//! @param[in]      value       正の正規化数.
+//! @return     1 / sqrt(value) を返却します. 最大相対誤差は RSQRT_EST_MAX_ERROR です.
+//-----------------------------------------------------------------------------
+float RsqrtEst( float value );
+
+//-----------------------------------------------------------------------------
+//! @brief      平方根の逆数を求めます.
+//!
+//! @param[in]      value       正の正規化数.
+//! @return     1 / sqrt(value) を返却します. 最大相対誤差は RSQRT_MAX_ERROR です.
+//! @note       RsqrtEst() の結果をニュートン法で補正します.
+//-----------------------------------------------------------------------------
+float Rsqrt( float value );
+
+//-----------------------------------------------------------------------------
+//! @brief      2の累乗を低精度で求めます.
+//!
+//! @param[in]      value       指数. [-126, 127] にクランプされます.
+//! @return     2^value を返却します. 最大相対誤差は EXP2_EST_MAX_ERROR です.
+//-----------------------------------------------------------------------------
+float Exp2Est( float value );
+
+//-----------------------------------------------------------------------------
+//! @brief      2の累乗を求めます.
+//!
+//! @param[in]      value       指数. [-126, 127] にクランプされます.
+//! @return     2^value を返却します. 最大相対誤差は EXP2_MAX_ERROR です.
+//! @note       整数の入力に対しては正確な値を返却します.
+//-----------------------------------------------------------------------------
+float Exp2( float value );
+
+//-----------------------------------------------------------------------------
+//! @brief      2を底とする対数を低精度で求めます.
+//!
+//! @param[in]      value       正の正規化数.
+//! @return     log2(value) を返却します. 最大誤差は LOG2_EST_MAX_ERROR です.
+//-----------------------------------------------------------------------------
+float Log2Est( float value );
+
+//-----------------------------------------------------------------------------
+//! @brief      2を底とする対数を求めます.
+//!
+//! @param[in]      value       正の正規化数.
+//! @return     log2(value) を返却します. 最大誤差は LOG2_MAX_ERROR です.
+//-----------------------------------------------------------------------------
+float Log2( float value );
+
+//-----------------------------------------------------------------------------
+//! @brief      逆正接を低精度で求めます.
+//!
+//! @param[in]      y           Y成分.
+//! @param[in]      x           X成分.
+//! @return     [-π, π] の範囲の角度を返却します. 最大絶対誤差は ATAN2_EST_MAX_ERROR です.
+//! @note       x = y = 0 の場合は 0 を返却します.
+//-----------------------------------------------------------------------------
+float Atan2Est( float y, float x );
+
+//-----------------------------------------------------------------------------
+//! @brief      逆正接を求めます.
+//!
+//! @param[in]      y           Y成分.
+//! @param[in]      x           X成分.
+//! @return     [-π, π] の範囲の角度を返却します. 最大絶対誤差は ATAN2_MAX_ERROR です.
+//! @note       x = y = 0 の場合は 0 を返却します.
+//-----------------------------------------------------------------------------
+float Atan2( float y, float x );
+
+//-----------------------------------------------------------------------------
+//! @brief      逆余弦を低精度で求めます.
+//!
+//! @param[in]      value       入力値. [-1, 1] にクランプされます.
+//! @return     [0, π] の範囲の角度を返却します. 最大絶対誤差は ACOS_EST_MAX_ERROR です.
+//-----------------------------------------------------------------------------
+float AcosEst( float value );
+
+//-----------------------------------------------------------------------------
+//! @brief      逆余弦を求めます.
+//!
+//! @param[in]      value       入力値. [-1, 1] にクランプされます.
+//! @return     [0, π] の範囲の角度を返却します. 最大絶対誤差は ACOS_MAX_ERROR です.
+//-----------------------------------------------------------------------------
+float Acos( float value );
+
+//-----------------------------------------------------------------------------
+//! @brief      配列の正弦と余弦をまとめて求めます.
+//!
+//! @param[in]      pRadian     角度の配列.
+//! @param[out]     pSin        正弦の格納先(nullptr 可).
+//! @param[out]     pCos        余弦の格納先(nullptr 可).
+//! @param[in]      count       要素数.
+//-----------------------------------------------------------------------------
+void SinCosEst( const float* pRadian, float* pSin, float* pCos, size_t count );
+void SinCos   ( const float* pRadian, float* pSin, float* pCos, size_t count );
+
+//-----------------------------------------------------------------------------
+//! @brief      配列の各要素に関数を適用します.
+//!
+//! @param[in]      pValue      入力値の配列.
+//! @param[out]     pResult     結果の格納先(pValue と同じでも可).
+//! @param[in]      count       要素数.
+//-----------------------------------------------------------------------------
+void RsqrtEst( const float* pValue, float* pResult, size_t count );
+void Rsqrt   ( const float* pValue, float* pResult, size_t count );
+void Exp2Est ( const float* pValue, float* pResult, size_t count );
+void Exp2    ( const float* pValue, float* pResult, size_t count );
+void Log2Est ( const float* pValue, float* pResult, size_t count );
+void Log2    ( const float* pValue, float* pResult, size_t count );
+void AcosEst ( const float* pValue, float* pResult, size_t count );
+void Acos    ( const float* pValue, float* pResult, size_t count );
+
+//-----------------------------------------------------------------------------
+//! @brief      配列の逆正接をまとめて求めます.
+//!
+//! @param[in]      pY          Y成分の配列.
+//! @param[in]      pX          X成分の配列.
+//! @param[out]     pResult     結果の格納先(pY または pX と同じでも可).
+//! @param[in]      count       要素数.
+//-----------------------------------------------------------------------------
+void Atan2Est( const float* pY, const float* pX, float* pResult, size_t count );
+void Atan2   ( const float* pY, const float* pX, float* pResult, size_t count );
+
+} // namespace fast
+} // namespace asdx
+
+//-----------------------------------------------------------------------------
+// Inline Files
+//-----------------------------------------------------------------------------
+#include <asdxFastMath.inl>
@@ -0,0 +1,349 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxFastMath.inl
+// Desc : Fast Approximation Math Functions.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+namespace asdx {
+namespace fast {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+
+// π/2 を3分割した値(Cody-Waite法). 上位2つは8bitなので |q| < 2^16 の積は誤差無しで求まる.
+static constexpr float PIDIV2_HI    = 1.5703125f;
+static constexpr float PIDIV2_MID   = 4.825592041015625e-4f;
+static constexpr float PIDIV2_LO    = 1.2675908465098473e-6f;
+static constexpr float F_2DIVPI     = 0.63661977236758134308f;
+static constexpr float F_SQRT2      = 1.41421356237309504880f;
+
+// 以下の係数は区間上の最大誤差が最小となるよう求めたものです.
+// sin(r) = r + r^3 * P(r^2), r ∈ [-π/4, π/4].
+static constexpr float SIN_EST_COEF[2]  = { -1.666283309e-01f, 8.152992465e-03f };
+static constexpr float SIN_COEF[3]      = { -1.666665077e-01f, 8.331978694e-03f, -1.949563593e-04f };
+
+// cos(r) = 1 + r^2 * P(r^2) (低精度版), 1 - r^2 / 2 + r^4 * P(r^2) (通常版).
+static constexpr float COS_EST_COEF[2]  = { -4.997763038e-01f, 4.048893601e-02f };
+static constexpr float COS_COEF[3]      = { 4.166664556e-02f, -1.388736768e-03f, 2.443845187e-05f };
+
+// 2^f = 1 + f * P(f), f ∈ [-1/2, 1/2].
+static constexpr float EXP2_EST_COEF[3] = { 6.932829022e-01f, 2.422109544e-01f, 5.500892922e-02f };
+static constexpr float EXP2_COEF[6]     = { 6.931471825e-01f, 2.402264774e-01f, 5.550332367e-02f,
+                                            9.618436918e-03f, 1.339887385e-03f, 1.535336196e-04f };
+
+// log2(1 + u) = u * P(u) (低精度版), log2((1 + t) / (1 - t)) = t * P(t^2) (通常版), 仮数部 ∈ [1/√2, √2].
+static constexpr float LOG2_EST_COEF[4] = { 1.441760659e+00f, -7.249041796e-01f, 5.175094008e-01f, -3.296297193e-01f };
+static constexpr float LOG2_COEF[3]     = { 2.885391235e+00f, 9.614707828e-01f, 5.989738703e-01f };
+
+// atan(r) = r * P(r^2), r ∈ [0, 1].
+static constexpr float ATAN_EST_COEF[4] = { 9.992138147e-01f, -3.211749792e-01f, 1.462644637e-01f, -3.898651153e-02f };
+static constexpr float ATAN_COEF[8]     = { 9.999993443e-01f, -3.332985938e-01f, 1.994656622e-01f, -1.390862912e-01f,
+                                            9.642197937e-02f, -5.591233075e-02f, 2.186295949e-02f, -4.054567777e-03f };
+
+// acos(x) = sqrt(1 - x) * P(x), x ∈ [0, 1].
+static constexpr float ACOS_EST_COEF[4] = { 1.570758343e+00f, -2.128751874e-01f, 7.689737529e-02f, -2.089202963e-02f };
+static constexpr float ACOS_COEF[8]     = { 1.570796371e+00f, -2.145998925e-01f, 8.899926394e-02f, -5.031278357e-02f,
+                                            3.133546934e-02f, -1.780898497e-02f, 7.245447952e-03f, -1.441479893e-03f };
+
+//-----------------------------------------------------------------------------
+//      角度を [-π/4, π/4] に縮約します.
+//-----------------------------------------------------------------------------
+inline
+float ReduceAngle( float radian, int& quadrant )
+{
+    quadrant = int( radian * F_2DIVPI + ( ( radian >= 0.0f ) ? 0.5f : -0.5f ) );
+    auto q = float( quadrant );
+    return ( ( radian - q * PIDIV2_HI ) - q * PIDIV2_MID ) - q * PIDIV2_LO;
+}
+
+//-----------------------------------------------------------------------------
+//      象限に応じて正弦と余弦を入れ替えます.
+//-----------------------------------------------------------------------------
+inline
+void ApplyQuadrant( int quadrant, float& s, float& c )
+{
+    if ( quadrant & 1 )
+    {
+        auto t = s;
+        s = c;
+        c = t;
+    }
+    if ( quadrant & 2 )
+    { s = -s; }
+    if ( ( quadrant + 1 ) & 2 )
+    { c = -c; }
+}
+
+//-----------------------------------------------------------------------------
+//      正弦と余弦を低精度で求めます.
+//-----------------------------------------------------------------------------
+inline
+void SinCosEst( float radian, float& s, float& c )
+{
+    int quadrant;
+    auto r  = ReduceAngle( radian, quadrant );
+    auto r2 = r * r;
+
+    s = r + ( r * r2 ) * ( SIN_EST_COEF[0] + r2 * SIN_EST_COEF[1] );
+    c = 1.0f + r2 * ( COS_EST_COEF[0] + r2 * COS_EST_COEF[1] );
+    ApplyQuadrant( quadrant, s, c );
+}
+
+//-----------------------------------------------------------------------------
+//      正弦と余弦を求めます.
+//-----------------------------------------------------------------------------
+inline
+void SinCos( float radian, float& s, float& c )
+{
+    int quadrant;
+    auto r  = ReduceAngle( radian, quadrant );
+    auto r2 = r * r;
+
+    s = r + ( r * r2 ) * ( SIN_COEF[0] + r2 * ( SIN_COEF[1] + r2 * SIN_COEF[2] ) );
+    c = ( 1.0f - 0.5f * r2 ) + ( r2 * r2 ) * ( COS_COEF[0] + r2 * ( COS_COEF[1] + r2 * COS_COEF[2] ) );
+    ApplyQuadrant( quadrant, s, c );
+}
+
+//-----------------------------------------------------------------------------
+//      平方根の逆数を低精度で求めます.
+//-----------------------------------------------------------------------------
+inline
+float RsqrtEst( float value )
+{
+#if defined(ASDX_ENABLE_SIMD)
+    return _mm_cvtss_f32( _mm_rsqrt_ss( _mm_set_ss( value ) ) );
+#else
+    union FP32
+    {
+        uint32_t u;
+        float    f;
+    };
+
+    // 指数部を半分にした初期値をニュートン法で1回補正する.
+    FP32 fp32;
+    fp32.f = value;
+    fp32.u = 0x5f375a86u - ( fp32.u >> 1 );
+
+    auto y = fp32.f;
+    return y * ( 1.5f - ( 0.5f * value ) * ( y * y ) );
+#endif//defined(ASDX_ENABLE_SIMD)
+}
+
+//-----------------------------------------------------------------------------
+//      平方根の逆数を求めます.
+//-----------------------------------------------------------------------------
+inline
+float Rsqrt( float value )
+{
+    auto y = RsqrtEst( value );
+    auto h = 0.5f * value;
+    y = y * ( 1.5f - h * ( y * y ) );
+#if !defined(ASDX_ENABLE_SIMD)
+    // 初期値の精度が低いので補正を追加で2回行う.
+    y = y * ( 1.5f - h * ( y * y ) );
+    y = y * ( 1.5f - h * ( y * y ) );
+#endif//!defined(ASDX_ENABLE_SIMD)
+    return y;
+}
+
+//-----------------------------------------------------------------------------
+//      指数を整数部と小数部に分けます.
+//-----------------------------------------------------------------------------
+inline
+float SplitExponent( float value, float& scale )
+{
+    union FP32
+    {
+        uint32_t u;
+        float    f;
+    };
+
+    auto x = ( value < -126.0f ) ? -126.0f : value;
+    x = ( x > 127.0f ) ? 127.0f : x;
+
+    auto n = int( x + ( ( x >= 0.0f ) ? 0.5f : -0.5f ) );
+
+    FP32 fp32;
+    fp32.u = uint32_t( n + 127 ) << 23;
+    scale = fp32.f;
+
+    return x - float( n );
+}
+
+//-----------------------------------------------------------------------------
+//      2の累乗を低精度で求めます.
+//-----------------------------------------------------------------------------
+inline
+float Exp2Est( float value )
+{
+    float scale;
+    auto f = SplitExponent( value, scale );
+    auto p = 1.0f + f * ( EXP2_EST_COEF[0] + f * ( EXP2_EST_COEF[1] + f * EXP2_EST_COEF[2] ) );
+    return p * scale;
+}
+
+//-----------------------------------------------------------------------------
+//      2の累乗を求めます.
+//-----------------------------------------------------------------------------
+inline
+float Exp2( float value )
+{
+    float scale;
+    auto f = SplitExponent( value, scale );
+    auto p = EXP2_COEF[4] + f * EXP2_COEF[5];
+    p = EXP2_COEF[3] + f * p;
+    p = EXP2_COEF[2] + f * p;
+    p = EXP2_COEF[1] + f * p;
+    p = EXP2_COEF[0] + f * p;
+    return ( 1.0f + f * p ) * scale;
+}
+
+//-----------------------------------------------------------------------------
+//      仮数部と指数部に分けます.
+//-----------------------------------------------------------------------------
+inline
+float SplitMantissa( float value, float& exponent )
+{
+    union FP32
+    {
+        uint32_t u;
+        float    f;
+    };
+
+    FP32 fp32;
+    fp32.f = value;
+
+    auto e = int( ( fp32.u >> 23 ) & 0xff ) - 127;
+    fp32.u = ( fp32.u & 0x7fffff ) | 0x3f800000;
+
+    // 仮数部を [1/√2, √2] にして多項式の区間を狭くする.
+    auto m = fp32.f;
+    if ( m > F_SQRT2 )
+    {
+        m *= 0.5f;
+        e++;
+    }
+
+    exponent = float( e );
+    return m;
+}
+
+//-----------------------------------------------------------------------------
+//      2を底とする対数を低精度で求めます.
+//-----------------------------------------------------------------------------
+inline
+float Log2Est( float value )
+{
+    float e;
+    auto u = SplitMantissa( value, e ) - 1.0f;
+    auto p = LOG2_EST_COEF[0] + u * ( LOG2_EST_COEF[1] + u * ( LOG2_EST_COEF[2] + u * LOG2_EST_COEF[3] ) );
+    return u * p + e;
+}
+
+//-----------------------------------------------------------------------------
+//      2を底とする対数を求めます.
+//-----------------------------------------------------------------------------
+inline
+float Log2( float value )
+{
+    float e;
+    auto m  = SplitMantissa( value, e );
+    auto t  = ( m - 1.0f ) / ( m + 1.0f );
+    auto t2 = t * t;
+    auto p  = LOG2_COEF[0] + t2 * ( LOG2_COEF[1] + t2 * LOG2_COEF[2] );
+    return t * p + e;
+}
+
+//-----------------------------------------------------------------------------
+//      逆正接の象限を補正します.
+//-----------------------------------------------------------------------------
+inline
+float ApplyOctant( float angle, float y, float x, bool swapped )
+{
+    if ( swapped )
+    { angle = F_PIDIV2 - angle; }
+    if ( x < 0.0f )
+    { angle = F_PI - angle; }
+    if ( y < 0.0f )
+    { angle = -angle; }
+    return angle;
+}
+
+//-----------------------------------------------------------------------------
+//      逆正接を低精度で求めます.
+//-----------------------------------------------------------------------------
+inline
+float Atan2Est( float y, float x )
+{
+    auto ax = fabsf( x );
+    auto ay = fabsf( y );
+    auto mn = ( ax < ay ) ? ax : ay;
+    auto mx = ( ax < ay ) ? ay : ax;
+    auto r  = ( mx > 0.0f ) ? mn / mx : 0.0f;
+    auto s  = r * r;
+    auto p  = ATAN_EST_COEF[0] + s * ( ATAN_EST_COEF[1] + s * ( ATAN_EST_COEF[2] + s * ATAN_EST_COEF[3] ) );
+    return ApplyOctant( r * p, y, x, ax < ay );
+}
+
+//-----------------------------------------------------------------------------
+//      逆正接を求めます.
+//-----------------------------------------------------------------------------
+inline
+float Atan2( float y, float x )
+{
+    auto ax = fabsf( x );
+    auto ay = fabsf( y );
+    auto mn = ( ax < ay ) ? ax : ay;
+    auto mx = ( ax < ay ) ? ay : ax;
+    auto r  = ( mx > 0.0f ) ? mn / mx : 0.0f;
+    auto s  = r * r;
+    auto p  = ATAN_COEF[6] + s * ATAN_COEF[7];
+    p = ATAN_COEF[5] + s * p;
+    p = ATAN_COEF[4] + s * p;
+    p = ATAN_COEF[3] + s * p;
+    p = ATAN_COEF[2] + s * p;
+    p = ATAN_COEF[1] + s * p;
+    p = ATAN_COEF[0] + s * p;
+    return ApplyOctant( r * p, y, x, ax < ay );
+}
+
+//-----------------------------------------------------------------------------
+//      逆余弦を低精度で求めます.
+//-----------------------------------------------------------------------------
+inline
+float AcosEst( float value )
+{
+    auto x  = ( value < -1.0f ) ? -1.0f : value;
+    x = ( x > 1.0f ) ? 1.0f : x;
+
+    auto ax = fabsf( x );
+    auto p  = ACOS_EST_COEF[0] + ax * ( ACOS_EST_COEF[1] + ax * ( ACOS_EST_COEF[2] + ax * ACOS_EST_COEF[3] ) );
+    auto r  = sqrtf( 1.0f - ax ) * p;
+    return ( x < 0.0f ) ? F_PI - r : r;
+}
+
+//-----------------------------------------------------------------------------
+//      逆余弦を求めます.
+//-----------------------------------------------------------------------------
+inline
+float Acos( float value )
+{
+    auto x  = ( value < -1.0f ) ? -1.0f : value;
+    x = ( x > 1.0f ) ? 1.0f : x;
+
+    auto ax = fabsf( x );
+    auto p  = ACOS_COEF[6] + ax * ACOS_COEF[7];
+    p = ACOS_COEF[5] + ax * p;
+    p = ACOS_COEF[4] + ax * p;
+    p = ACOS_COEF[3] + ax * p;
+    p = ACOS_COEF[2] + ax * p;
+    p = ACOS_COEF[1] + ax * p;
+    p = ACOS_COEF[0] + ax * p;
+    auto r  = sqrtf( 1.0f - ax ) * p;
+    return ( x < 0.0f ) ? F_PI - r : r;
+}
+
+} // namespace fast
+} // namespace asdx
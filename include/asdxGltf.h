@@ -0,0 +1,51 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxGltf.h
+// Desc : glTF 2.0 Loader.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+#include <asdxResModel.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//! @brief      glTF 2.0 ファイル(.gltf, .glb)を読み込みます.
+//!
+//! @param[in]      filename        ファイルパス.
+//! @param[out]     result          読み込み結果.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//! @note       ファイルと外部バッファはメモリにマップし, アクセサから直接頂点ストリームに変換します.
+//!             三角形リストのプリミティブごとに ResMesh を1つ生成し, ノードの変換は適用しません.
+//!             JOINTS_0 と WEIGHTS_0 は BoneIndices と BoneWeights に格納され,
+//!             ボーン番号はスキンの joints 配列の番号になります.
+//-----------------------------------------------------------------------------
+bool LoadGltf(const char* filename, ResModel& result, uint32_t maxThreadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      メモリ上の glTF 2.0 データを読み込みます.
+//!
+//! @param[in]      pBuffer         .gltf(JSON) または .glb のデータ.
+//! @param[in]      size            データサイズ.
+//! @param[in]      baseDirectory   外部バッファの基準ディレクトリ(nullptr の場合は外部バッファを参照できません).
+//! @param[out]     result          読み込み結果.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//-----------------------------------------------------------------------------
+bool LoadGltf(
+    const void*     pBuffer,
+    size_t          size,
+    const char*     baseDirectory,
+    ResModel&       result,
+    uint32_t        maxThreadCount = 0);
+
+} // namespace asdx
@@ -9,6 +9,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <asdxMath.h>
+#include <asdxBounds.h>
 
 
 namespace asdx {
@@ -152,6 +153,18 @@ public:
         return (d2 <= r2);
     }
 
+    // BoundingBoxの包含.
+    bool Contains(const BoundingBox& box) const
+    { return Contains(box.Min, box.Max); }
+
+    // BoundingSphereの包含.
+    bool Contains(const BoundingSphere& sphere) const
+    { return Contains(sphere.Center, sphere.Radius); }
+
+    // 影響範囲を包含する境界球.
+    BoundingSphere GetBoundingSphere() const
+    { return BoundingSphere(m_Center, m_Radius); }
+
 private:
     //=========================================================================
     // private variables.
@@ -197,8 +210,8 @@ public:
         const Vector3&  color,
         float           intensity = 1.0f)
     : m_Position    (position)
-    , m_Forward     (forward)
     , m_Radius      (radius)
+    , m_Forward     (forward)
     , m_InnerAngle  (innerAngle)
     , m_OuterAngle  (outerAngle)
     , m_Color       (color)
@@ -269,7 +282,7 @@ public:
     {
         auto center = (maxi + mini) * 0.5f;
         auto extent = (maxi - mini) * 0.5f;
-        auto r = Vector3::Dot(extent, extent);
+        auto r = sqrt(Vector3::Dot(extent, extent));
         auto v = center - m_Position;
         auto lenSq = Vector3::Dot(v, v);
         auto v1Len = Vector3::Dot(v, m_Forward);
@@ -294,6 +307,25 @@ public:
         return !(angleCull || frontCull || backCull);
     }
 
+    // BoundingBoxの包含.
+    bool Contains(const BoundingBox& box) const
+    { return Contains(box.Min, box.Max); }
+
+    // BoundingSphereの包含.
+    bool Contains(const BoundingSphere& sphere) const
+    { return Contains(sphere.Center, sphere.Radius); }
+
+    // 影響範囲(高さ m_Radius, 半頂角 m_OuterAngle の円錐)を包含する最小の境界球.
+    BoundingSphere GetBoundingSphere() const
+    {
+        auto c = cos(m_OuterAngle);
+        if (m_OuterAngle >= F_PIDIV4)
+        { return BoundingSphere(m_Position + m_Forward * m_Radius, m_Radius * tan(m_OuterAngle)); }
+
+        auto r = m_Radius / (2.0f * c * c);
+        return BoundingSphere(m_Position + m_Forward * r, r);
+    }
+
 private:
     //=========================================================================
     // private variables.
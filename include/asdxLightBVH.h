@@ -0,0 +1,182 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxLightBVH.h
+// Desc : Bounding Volume Hierarchy for Lights.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <asdxMath.h>
+#include <asdxBounds.h>
+#include <asdxLight.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   LIGHT_BVH_LEAF_SIZE     = 4;    //!< 葉ノードが持つ最大ライト数.
+static constexpr uint32_t   LIGHT_BVH_MAX_DEPTH     = 64;   //!< 探索スタックの最大深さ.
+
+///////////////////////////////////////////////////////////////////////////////
+// LightBVHNode structure
+///////////////////////////////////////////////////////////////////////////////
+struct LightBVHNode
+{
+    BoundingBox     Bounds;         //!< 子孫のライトを包含する境界箱.
+    uint32_t        Offset  = 0;    //!< 葉ノードの場合は先頭の要素番号, 内部ノードの場合は左の子ノード番号(右の子は Offset + 1).
+    uint32_t        Count   = 0;    //!< 葉ノードのライト数(0の場合は内部ノード).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LightBVHResult structure
+///////////////////////////////////////////////////////////////////////////////
+struct LightBVHResult
+{
+    std::vector<uint32_t>   PointLights;    //!< 該当したポイントライト番号.
+    std::vector<uint32_t>   SpotLights;     //!< 該当したスポットライト番号.
+
+    //-------------------------------------------------------------------------
+    //! @brief      結果を空にします.
+    //-------------------------------------------------------------------------
+    void Clear()
+    {
+        PointLights.clear();
+        SpotLights .clear();
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LightBVH class
+///////////////////////////////////////////////////////////////////////////////
+class LightBVH
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      階層を構築します.
+    //!
+    //! @param[in]      pPointLights    ポイントライト配列.
+    //! @param[in]      pointCount      ポイントライト数.
+    //! @param[in]      pSpotLights     スポットライト配列.
+    //! @param[in]      spotCount       スポットライト数.
+    //! @note       ライトはコピーして保持します. 境界箱の中心で最長軸を中央分割します.
+    //-------------------------------------------------------------------------
+    void Build(
+        const PointLight*   pPointLights,
+        size_t              pointCount,
+        const SpotLight*    pSpotLights,
+        size_t              spotCount);
+
+    //-------------------------------------------------------------------------
+    //! @brief      階層構造を維持したまま全ての境界箱を再計算します.
+    //!
+    //! @param[in]      pPointLights    ポイントライト配列(Build() と同じ数).
+    //! @param[in]      pSpotLights     スポットライト配列(Build() と同じ数).
+    //! @note       ライトが大きく移動すると探索効率が低下するため, 必要に応じて Build() し直してください.
+    //-------------------------------------------------------------------------
+    void Refit(const PointLight* pPointLights, const SpotLight* pSpotLights);
+
+    //-------------------------------------------------------------------------
+    //! @brief      ポイントライトを更新し, 祖先ノードの境界箱を再計算します.
+    //!
+    //! @param[in]      index       ポイントライト番号.
+    //! @param[in]      light       更新後のライト.
+    //-------------------------------------------------------------------------
+    void UpdatePointLight(uint32_t index, const PointLight& light);
+
+    //-------------------------------------------------------------------------
+    //! @brief      スポットライトを更新し, 祖先ノードの境界箱を再計算します.
+    //!
+    //! @param[in]      index       スポットライト番号.
+    //! @param[in]      light       更新後のライト.
+    //-------------------------------------------------------------------------
+    void UpdateSpotLight(uint32_t index, const SpotLight& light);
+
+    //-------------------------------------------------------------------------
+    //! @brief      点を含むライトを検索します.
+    //!
+    //! @param[in]      point       検索する点.
+    //! @param[out]     result      検索結果の追加先.
+    //! @note       境界箱で枝刈りした後, ライトの Contains() で判定したものを追加します.
+    //!             スポットライトの境界箱は円錐から求めるため, 全てのライトに Contains() を
+    //!             呼び出した場合よりも保守的な誤判定が少なくなることがあります.
+    //-------------------------------------------------------------------------
+    void Query(const Vector3& point, LightBVHResult& result) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界箱と重なるライトを検索します.
+    //!
+    //! @param[in]      box         検索する境界箱.
+    //! @param[out]     result      検索結果の追加先.
+    //-------------------------------------------------------------------------
+    void Query(const BoundingBox& box, LightBVHResult& result) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と重なるライトを検索します.
+    //!
+    //! @param[in]      sphere      検索する境界球.
+    //! @param[out]     result      検索結果の追加先.
+    //-------------------------------------------------------------------------
+    void Query(const BoundingSphere& sphere, LightBVHResult& result) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ノード配列を取得します.
+    //!
+    //! @return     ノード配列を返却します. 先頭がルートノードです.
+    //-------------------------------------------------------------------------
+    const std::vector<LightBVHNode>& GetNodes() const
+    { return m_Nodes; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ポイントライト数を取得します.
+    //-------------------------------------------------------------------------
+    size_t GetPointLightCount() const
+    { return m_PointLights.size(); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      スポットライト数を取得します.
+    //-------------------------------------------------------------------------
+    size_t GetSpotLightCount() const
+    { return m_SpotLights.size(); }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::vector<LightBVHNode>   m_Nodes;        // ノード(子は親より後ろに並ぶ).
+    std::vector<uint32_t>       m_Parents;      // 親ノード番号.
+    std::vector<uint32_t>       m_Items;        // 葉ノードが参照する要素(最上位ビットがスポットライト).
+    std::vector<uint32_t>       m_ItemLeaves;   // 要素を持つ葉ノード番号(ポイントライト, スポットライトの順).
+    std::vector<PointLight>     m_PointLights;  // ポイントライト.
+    std::vector<SpotLight>      m_SpotLights;   // スポットライト.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    BoundingBox GetItemBounds(uint32_t item) const;
+    void RefitLeaf(uint32_t node);
+    void RefitUpward(uint32_t node);
+
+    template<typename Overlap, typename Contains>
+    void Traverse(Overlap overlap, Contains contains, LightBVHResult& result) const;
+};
+
+} // namespace asdx
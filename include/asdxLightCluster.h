@@ -0,0 +1,111 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxLightCluster.h
+// Desc : Clustered Light Assignment.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <asdxMath.h>
+#include <asdxLight.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// LightClusterDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct LightClusterDesc
+{
+    uint32_t    TileCountX  = 16;       //!< 横方向の分割数.
+    uint32_t    TileCountY  = 9;        //!< 縦方向の分割数.
+    uint32_t    SliceCount  = 24;       //!< 奥行方向の分割数.
+    float       NearClip    = 0.1f;     //!< 分割を開始するビュー空間の奥行(0より大きい値).
+    float       FarClip     = 1000.0f;  //!< 分割を終了するビュー空間の奥行.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LightClusterRange structure
+///////////////////////////////////////////////////////////////////////////////
+struct LightClusterRange
+{
+    uint32_t    Offset      = 0;    //!< インデックスリストの開始位置.
+    uint32_t    PointCount  = 0;    //!< ポイントライトの数.
+    uint32_t    SpotCount   = 0;    //!< スポットライトの数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LightClusterList structure
+///////////////////////////////////////////////////////////////////////////////
+struct LightClusterList
+{
+    std::vector<LightClusterRange>  Ranges;     //!< クラスターごとのインデックス範囲.
+    std::vector<uint32_t>           Indices;    //!< ライト番号リスト.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      クラスター数を取得します.
+//!
+//! @param[in]      desc        分割設定.
+//! @return     TileCountX * TileCountY * SliceCount を返却します.
+//-----------------------------------------------------------------------------
+inline uint32_t GetLightClusterCount(const LightClusterDesc& desc)
+{ return desc.TileCountX * desc.TileCountY * desc.SliceCount; }
+
+//-----------------------------------------------------------------------------
+//! @brief      クラスター番号を取得します.
+//!
+//! @param[in]      desc        分割設定.
+//! @param[in]      x           横方向のタイル番号(画面左端が0).
+//! @param[in]      y           縦方向のタイル番号(画面上端が0).
+//! @param[in]      slice       奥行方向のスライス番号(手前が0).
+//! @return     (slice * TileCountY + y) * TileCountX + x を返却します.
+//-----------------------------------------------------------------------------
+inline uint32_t GetLightClusterIndex(const LightClusterDesc& desc, uint32_t x, uint32_t y, uint32_t slice)
+{ return (slice * desc.TileCountY + y) * desc.TileCountX + x; }
+
+//-----------------------------------------------------------------------------
+//! @brief      ビュー空間の奥行からスライス番号を求めます.
+//!
+//! @param[in]      desc        分割設定.
+//! @param[in]      viewDepth   ビュー空間の奥行(カメラ前方を正とする距離).
+//! @return     [0, SliceCount - 1] に制限したスライス番号を返却します.
+//! @note       slice = log(depth / NearClip) * SliceCount / log(FarClip / NearClip) で求めます.
+//!             シェーダ側では同じ式の係数を定数として渡してください.
+//-----------------------------------------------------------------------------
+uint32_t CalcLightClusterSlice(const LightClusterDesc& desc, float viewDepth);
+
+//-----------------------------------------------------------------------------
+//! @brief      ライトをクラスターに割り当てます.
+//!
+//! @param[in]      desc            分割設定.
+//! @param[in]      view            ビュー行列.
+//! @param[in]      proj            透視投影行列.
+//! @param[in]      pPointLights    ポイントライト配列.
+//! @param[in]      pointCount      ポイントライト数.
+//! @param[in]      pSpotLights     スポットライト配列.
+//! @param[in]      spotCount       スポットライト数.
+//! @param[out]     result          割り当て結果(以前の確保領域は再利用されます).
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @note       クラスター i のライトは result.Indices[Ranges[i].Offset] からポイントライト番号が
+//!             PointCount 個, 続けてスポットライト番号が SpotCount 個並びます.
+//!             各リストはライト番号の昇順で, 結果はスレッド数に依存しません.
+//!             クラスターを包含する軸並行境界箱とライトの境界球で判定し, スポットライトは
+//!             さらにクラスターの境界球と円錐で判定するため, 保守的な結果になります.
+//!             奥行方向のスライス単位で並列処理を行います.
+//-----------------------------------------------------------------------------
+void AssignLightsToClusters(
+    const LightClusterDesc& desc,
+    const Matrix&           view,
+    const Matrix&           proj,
+    const PointLight*       pPointLights,
+    size_t                  pointCount,
+    const SpotLight*        pSpotLights,
+    size_t                  spotCount,
+    LightClusterList&       result,
+    uint32_t                maxThreadCount = 1);
+
+} // namespace asdx
@@ -0,0 +1,101 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMappedFile.h
+// Desc : Memory Mapped File.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////
+class MappedFile
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    MappedFile() = default;
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~MappedFile();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルを読み取り専用でメモリにマップします.
+    //!
+    //! @param[in]      filename        ファイルパス.
+    //! @retval true    マップに成功.
+    //! @retval false   マップに失敗.
+    //! @note       サイズが0のファイルはマップせずに成功します.
+    //-------------------------------------------------------------------------
+    bool Open(const char* filename);
+
+    //-------------------------------------------------------------------------
+    //! @brief      マップを解除してファイルを閉じます.
+    //-------------------------------------------------------------------------
+    void Close();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルを開いているかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool IsOpen() const
+    { return m_IsOpen; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      マップされた先頭アドレスを取得します.
+    //-------------------------------------------------------------------------
+    const uint8_t* GetData() const
+    { return m_pData; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルサイズを取得します.
+    //-------------------------------------------------------------------------
+    size_t GetSize() const
+    { return m_Size; }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    const uint8_t*  m_pData     = nullptr;  // 先頭アドレス.
+    size_t          m_Size      = 0;        // ファイルサイズ.
+    bool            m_IsOpen    = false;    // 開いているかどうか.
+#if defined(_WIN32)
+    void*           m_hFile     = nullptr;  // ファイルハンドル.
+    void*           m_hMapping  = nullptr;  // マッピングオブジェクトのハンドル.
+#else
+    int             m_Handle    = -1;       // ファイルディスクリプタ.
+#endif
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    MappedFile              (const MappedFile&) = delete;
+    MappedFile& operator =  (const MappedFile&) = delete;
+};
+
+} // namespace asdx
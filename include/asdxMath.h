@@ -16,6 +16,14 @@
 #include <cstring>
 #include <climits>
 
+// ASDX_ENABLE_SIMD を定義すると Vector4, Matrix, Quaternion の主要演算をSSE2で実行します.
+// 行列乗算とベクトル変換はスカラー版とビット一致します(FMA縮約無効時).
+// 内積と四元数乗算は加算順序が異なるため, 誤差は 2ULP × Σ|a_i * b_i| 以内となります.
+// 逆行列は2x2ブロック展開で求めるため, 余因子展開版と同程度の残差になります.
+#if defined(ASDX_ENABLE_SIMD)
+#include <asdxSimd.h>
+#endif//defined(ASDX_ENABLE_SIMD)
+
 
 namespace asdx {
 
@@ -26,6 +34,7 @@ struct Vector2;
 struct Vector3;
 struct Vector4;
 struct Matrix;
+struct Matrix34;
 struct Quaternion;
 
 //-----------------------------------------------------------------------------
@@ -68,7 +77,7 @@ static constexpr float ONB_EPSILON = 0.01f;                                //!<
 //! @param [in]     degree      角度(度)
 //! @return     度をラジアンに変換した結果を返却します.
 //-----------------------------------------------------------------------------
-float ToRadian( float degree ) noexcept;
+constexpr float ToRadian( float degree ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      度をラジアンに変換します.
@@ -76,7 +85,7 @@ float ToRadian( float degree ) noexcept;
 //! @param [in]     degree      角度(度)
 //! @return     度をラジアンに変換した結果を返却します.
 //-----------------------------------------------------------------------------
-double ToRadian( double degree ) noexcept;
+constexpr double ToRadian( double degree ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      ラジアンを度に変換します.
@@ -84,7 +93,7 @@ double ToRadian( double degree ) noexcept;
 //! @param [in]     radian      角度(ラジアン)
 //! @return     ラジアンを度に変換した結果を返却します.
 //-----------------------------------------------------------------------------
-float ToDegree( float radian ) noexcept;
+constexpr float ToDegree( float radian ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      ラジアンを度に変換します.
@@ -92,7 +101,7 @@ float ToDegree( float radian ) noexcept;
 //! @param [in]     radian      角度(ラジアン)
 //! @return     ラジアンを度に変換した結果を返却します.
 //-----------------------------------------------------------------------------
-double ToDegree( double radian ) noexcept;
+constexpr double ToDegree( double radian ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      値がゼロであるかどうか判定します.
@@ -100,7 +109,7 @@ double ToDegree( double radian ) noexcept;
 //! @param [in]     value       判定する値.
 //! @return     値がゼロであるとみなせる場合にtrueを返却します.
 //-----------------------------------------------------------------------------
-bool IsZero( float value ) noexcept;
+constexpr bool IsZero( float value ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      値がゼロであるかどうか判定します.
@@ -108,7 +117,7 @@ bool IsZero( float value ) noexcept;
 //! @param [in]     value       判定する値.
 //! @return     値がゼロであるとみなせる場合にtrueを返却します.
 //-----------------------------------------------------------------------------
-bool IsZero( double value ) noexcept;
+constexpr bool IsZero( double value ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      値が等価であるか判定します.
@@ -117,7 +126,7 @@ bool IsZero( double value ) noexcept;
 //! @param [in]     b           判定する値.
 //! @return     値が等価であるとみなせる場合にtrueを返却します.
 //-----------------------------------------------------------------------------
-bool IsEqual( float a, float b ) noexcept;
+constexpr bool IsEqual( float a, float b ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      値が等価であるか判定します.
@@ -126,7 +135,7 @@ bool IsEqual( float a, float b ) noexcept;
 //! @param [in]     b           判定する値.
 //! @return     値が等価であるとみなせる場合にtrueを返却します.
 //-----------------------------------------------------------------------------
-bool IsEqual( double a, double b ) noexcept;
+constexpr bool IsEqual( double a, double b ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      非数であるか判定します.
@@ -270,6 +279,27 @@ half ToHalf( float value );
 //-----------------------------------------------------------------------------
 float ToFloat( half value );
 
+//-----------------------------------------------------------------------------
+//! @brief      float型の配列をhalf型の配列に一括変換します.
+//!
+//! @param [in]     pInput      入力配列.
+//! @param [in]     count       要素数.
+//! @param [out]    pOutput     出力配列.
+//! @note       結果は要素ごとに ToHalf() を呼び出した場合と一致します.
+//!             ASDX_ENABLE_SIMD が定義されている場合はF16C命令またはSSE2で8要素ずつ変換します.
+//-----------------------------------------------------------------------------
+void ToHalfArray( const float* pInput, size_t count, half* pOutput );
+
+//-----------------------------------------------------------------------------
+//! @brief      half型の配列をfloat型の配列に一括変換します.
+//!
+//! @param [in]     pInput      入力配列.
+//! @param [in]     count       要素数.
+//! @param [out]    pOutput     出力配列.
+//! @note       結果は要素ごとに ToFloat() を呼び出した場合と一致します.
+//-----------------------------------------------------------------------------
+void ToFloatArray( const half* pInput, size_t count, float* pOutput );
+
 //-----------------------------------------------------------------------------
 //! @brief      線形補間を行います.
 //!
@@ -278,7 +308,7 @@ float ToFloat( half value );
 //! @param [in]     amount      重み(0～1の値範囲で指定).
 //! @return     線形補間の結果を返却します.
 //-----------------------------------------------------------------------------
-float Lerp( float a, float b, float amount ) noexcept;
+constexpr float Lerp( float a, float b, float amount ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      線形補間を行います.
@@ -288,7 +318,7 @@ float Lerp( float a, float b, float amount ) noexcept;
 //! @param [in]     amount      重み(0～1の値範囲で指定).
 //! @return     線形補間の結果を返却します.
 //-----------------------------------------------------------------------------
-double Lerp( double a, double b, double amount ) noexcept;
+constexpr double Lerp( double a, double b, double amount ) noexcept;
 
 //-----------------------------------------------------------------------------
 //! @brief      2つの値のうち，大きい方を返却します.
@@ -297,7 +327,7 @@ double Lerp( double a, double b, double amount ) noexcept;
 //! @param [in]     b       判定する値.
 //! @return     2つの値のうち，大きい方を返却します.
 //-----------------------------------------------------------------------------
-template<typename T> inline
+template<typename T> constexpr
 T Max( const T& a, const T& b ) noexcept
 { return ( a > b ) ? a : b; }
 
@@ -308,7 +338,7 @@ T Max( const T& a, const T& b ) noexcept
 //! @param [in]     b       判定する値.
 //! @return     2つの値のうち，小さい方の値を返却します.
 //-----------------------------------------------------------------------------
-template<typename T> inline
+template<typename T> constexpr
 T Min( const T& a, const T& b ) noexcept
 { return ( a < b ) ? a : b; }
 
@@ -320,7 +350,7 @@ T Min( const T& a, const T& b ) noexcept
 //! @param [in]     b       最大値.
 //! @return     値をaからbの範囲内に収めた結果を返却します.
 //-----------------------------------------------------------------------------
-template<typename T> inline
+template<typename T> constexpr
 T Clamp( const T& value, const T& mini, const T& maxi ) noexcept
 { return Max( mini, Min( maxi, value ) ); }
 
@@ -330,7 +360,7 @@ T Clamp( const T& value, const T& mini, const T& maxi ) noexcept
 //! @param [in]     value   クランプする値.
 //! @return     値を0から1の範囲内に収めた結果を返却します.
 //-----------------------------------------------------------------------------
-template<typename T> inline
+template<typename T> constexpr
 T Saturate( const T& value ) noexcept
 { return Clamp( value, T(0), T(1) ); }
 
@@ -340,7 +370,7 @@ T Saturate( const T& value ) noexcept
 //! @param [in]     value   符号を取得する値.
 //! @return     符号が正である場合には1を，負である場合には-1を返却します.
 //-----------------------------------------------------------------------------
-template<typename T> inline
+template<typename T> constexpr
 T Sign( T value ) noexcept
 { return ( value < T(0) ) ? T(-1) : T(1); }
 
@@ -361,7 +391,7 @@ struct Vector2
     //! @param [in]     value       乗算されるベクトル.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    friend Vector2   operator*   ( float, const Vector2& );
+    friend constexpr Vector2   operator*   ( float, const Vector2& );
 
 public:
     //=========================================================================
@@ -377,14 +407,14 @@ public:
     //-------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //-------------------------------------------------------------------------
-    Vector2();
+    constexpr Vector2();
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
     //!
     //! @param [in]     pValeus     要素数2の配列.
     //-------------------------------------------------------------------------
-    explicit Vector2( const float* );
+    explicit constexpr Vector2( const float* );
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -392,7 +422,7 @@ public:
     //! @param [in]     nx           X成分.
     //! @param [in]     ny           Y成分.
     //-------------------------------------------------------------------------
-    Vector2( float nx, float ny );
+    constexpr Vector2( float nx, float ny );
 
     //-------------------------------------------------------------------------
     //! @brief      float*型への演算子です.
@@ -414,7 +444,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2&         operator += ( const Vector2& );
+    constexpr Vector2&         operator += ( const Vector2& );
 
     //-------------------------------------------------------------------------
     //! @brief      減算代入演算子です.
@@ -422,7 +452,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2&         operator -= ( const Vector2& );
+    constexpr Vector2&         operator -= ( const Vector2& );
 
     //-------------------------------------------------------------------------
     //! @brief      乗算代入演算子です.
@@ -430,7 +460,7 @@ public:
     //! @param [in]     scalar      乗算するスカラー値.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2&         operator *= ( float );
+    constexpr Vector2&         operator *= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      除算代入演算子です.
@@ -438,7 +468,7 @@ public:
     //! @param [in]     scalar      除算するスカラー値.
     //! @return     除算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2&         operator /= ( float );
+    constexpr Vector2&         operator /= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      代入演算子です.
@@ -446,21 +476,21 @@ public:
     //! @param [in]     value       代入する値.
     //! @return     代入結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2&         operator =  ( const Vector2& );
+    constexpr Vector2&         operator =  ( const Vector2& );
 
     //-------------------------------------------------------------------------
     //! @brief      正符号演算子です.
     //!
     //! @return     自分自身の値を返却します.
     //-------------------------------------------------------------------------
-    Vector2          operator +  () const;
+    constexpr Vector2          operator +  () const;
 
     //-------------------------------------------------------------------------
     //! @brief      負符号演算子です.
     //!
     //! @return     負符号を付けた値を返却します.
     //-------------------------------------------------------------------------
-    Vector2          operator -  () const;
+    constexpr Vector2          operator -  () const;
 
     //-------------------------------------------------------------------------
     //! @brief      加算演算子です.
@@ -468,7 +498,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2          operator +  ( const Vector2& ) const;
+    constexpr Vector2          operator +  ( const Vector2& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      減算演算子です.
@@ -476,7 +506,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2          operator -  ( const Vector2& ) const;
+    constexpr Vector2          operator -  ( const Vector2& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      乗算演算子です.
@@ -484,7 +514,7 @@ public:
     //! @param [in]     scalar      乗算するスカラー値.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2          operator *  ( float ) const;
+    constexpr Vector2          operator *  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      除算演算子です.
@@ -492,7 +522,7 @@ public:
     //! @param [in]     scalar      除算するスカラー値.
     //! @return     除算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector2          operator /  ( float ) const;
+    constexpr Vector2          operator /  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      等価比較演算子です.
@@ -500,7 +530,7 @@ public:
     //! @param [in]     value       比較する値.
     //! @return     値が等価であればtrue, そうでなければfalseを返却します.
     //-------------------------------------------------------------------------
-    bool             operator == ( const Vector2& ) const;
+    constexpr bool             operator == ( const Vector2& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      非等価比較演算子です.
@@ -508,7 +538,7 @@ public:
     //! @param [in]     value       比較する値.
     //! @return     値が非等価であればtrue, そうでなければfalseを返却します.
     //-------------------------------------------------------------------------
-    bool             operator != ( const Vector2& ) const;
+    constexpr bool             operator != ( const Vector2& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルの長さを求めます.
@@ -522,7 +552,7 @@ public:
     //!
     //! @return     ベクトルの長さの2乗値を返却します.
     //-------------------------------------------------------------------------
-    float             LengthSq        () const;
+    constexpr float             LengthSq        () const;
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルを正規化します.
@@ -564,7 +594,7 @@ public:
     //! @param [in]     b           最大値.
     //! @return     クランプされた値を返却します.
     //-------------------------------------------------------------------------
-    static Vector2 Clamp( const Vector2& value, const Vector2& a, const Vector2& b );
+    static constexpr Vector2 Clamp( const Vector2& value, const Vector2& a, const Vector2& b );
 
     //-------------------------------------------------------------------------
     //! @brief      値を指定された範囲内に制限します.
@@ -582,7 +612,7 @@ public:
     //! @param [in]     value       クランプする値.
     //! @return     クランプされた値.
     //-------------------------------------------------------------------------
-    static Vector2 Saturate( const Vector2& value );
+    static constexpr Vector2 Saturate( const Vector2& value );
 
     //-------------------------------------------------------------------------
     //! @brief      指定された値を0～1の範囲に制限します.
@@ -617,7 +647,7 @@ public:
     //! @param [in]     b           入力ベクトル.
     //! @return     2つのベクトル間の距離の2乗値を返却します.
     //-------------------------------------------------------------------------
-    static float     DistanceSq( const Vector2& a, const Vector2& b );
+    static constexpr float     DistanceSq( const Vector2& a, const Vector2& b );
 
     //-------------------------------------------------------------------------
     //! @brief      2つのベクトル間の距離の2乗値を求めます.
@@ -635,7 +665,7 @@ public:
     //! @param [in]     b           入力ベクトル.
     //! @return     ベクトルの内積を返却します.
     //-------------------------------------------------------------------------
-    static float     Dot( const Vector2& a, const Vector2& b );
+    static constexpr float     Dot( const Vector2& a, const Vector2& b );
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルの内積を求めます.
@@ -706,7 +736,7 @@ public:
     //! @param [in]     b           比較する値.
     //! @return     各成分の最小値を求め，その結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector2 Min( const Vector2& a, const Vector2& b );
+    static constexpr Vector2 Min( const Vector2& a, const Vector2& b );
 
     //-------------------------------------------------------------------------
     //! @brief      各成分の最小値を求めます.
@@ -724,7 +754,7 @@ public:
     //! @param [in]     b           比較する値.
     //! @return     各成分の最大値を求め，その結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector2 Max( const Vector2& a, const Vector2& b );
+    static constexpr Vector2 Max( const Vector2& a, const Vector2& b );
 
     //-------------------------------------------------------------------------
     //! @brief      各成分の最大値を求めます.
@@ -853,7 +883,7 @@ public:
     //! @param [in]     amount      重み(0～1の値範囲で指定).
     //! @return     線形補間の結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector2 Lerp( const Vector2& a, const Vector2& b, float amount );
+    static constexpr Vector2 Lerp( const Vector2& a, const Vector2& b, float amount );
 
     //-------------------------------------------------------------------------
     //! @brief      線形補間を行います.
@@ -958,7 +988,7 @@ struct Vector3
     //! @param [in]     value       乗算されるベクトル.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    friend Vector3   operator *  ( float, const Vector3& );
+    friend constexpr Vector3   operator *  ( float, const Vector3& );
 
 public:
     //=========================================================================
@@ -975,14 +1005,14 @@ public:
     //-------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //-------------------------------------------------------------------------
-    Vector3();
+    constexpr Vector3();
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
     //!
     //! @param [in]     pValeus     要素数3の配列.
     //-------------------------------------------------------------------------
-    explicit Vector3( const float * );
+    explicit constexpr Vector3( const float * );
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -990,7 +1020,7 @@ public:
     //! @param [in]     value       2次元ベクトル.
     //! @param [in]     nz          Z成分.
     //-------------------------------------------------------------------------
-    Vector3( const Vector2& value, float nz );
+    constexpr Vector3( const Vector2& value, float nz );
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -999,7 +1029,7 @@ public:
     //! @param [in]     ny           Y成分.
     //! @param [in]     nz           Z成分.
     //-------------------------------------------------------------------------
-    Vector3( float nx, float ny, float nz );
+    constexpr Vector3( float nx, float ny, float nz );
 
     //-------------------------------------------------------------------------
     //! @brief      float*型への演算子です.
@@ -1021,7 +1051,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3&         operator += ( const Vector3& );
+    constexpr Vector3&         operator += ( const Vector3& );
 
     //-------------------------------------------------------------------------
     //! @brief      減算代入演算子です.
@@ -1029,7 +1059,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3&         operator -= ( const Vector3& );
+    constexpr Vector3&         operator -= ( const Vector3& );
 
     //-------------------------------------------------------------------------
     //! @brief      乗算代入演算子です.
@@ -1037,7 +1067,7 @@ public:
     //! @param [in]     scalar      乗算するスカラー値.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3&         operator *= ( float );
+    constexpr Vector3&         operator *= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      除算代入演算子です.
@@ -1045,7 +1075,7 @@ public:
     //! @param [in]     scalar      除算するスカラー値.
     //! @return     除算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3&         operator /= ( float );
+    constexpr Vector3&         operator /= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      代入演算子です.
@@ -1053,21 +1083,21 @@ public:
     //! @param [in]     value       代入する値.
     //! @return     代入結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3&         operator =  ( const Vector3& );
+    constexpr Vector3&         operator =  ( const Vector3& );
 
     //-------------------------------------------------------------------------
     //! @brief      正符号演算子です.
     //!
     //! @return     自分自身の値を返却します.
     //-------------------------------------------------------------------------
-    Vector3          operator +  () const;
+    constexpr Vector3          operator +  () const;
 
     //-------------------------------------------------------------------------
     //! @brief      負符号演算子です.
     //!
     //! @return     負符号を付けた値を返却します.
     //-------------------------------------------------------------------------
-    Vector3          operator -  () const;
+    constexpr Vector3          operator -  () const;
 
     //-------------------------------------------------------------------------
     //! @brief      加算演算子です.
@@ -1075,7 +1105,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3          operator +  ( const Vector3& ) const;
+    constexpr Vector3          operator +  ( const Vector3& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      減算演算子です.
@@ -1083,7 +1113,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3          operator -  ( const Vector3& ) const;
+    constexpr Vector3          operator -  ( const Vector3& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      乗算演算子です.
@@ -1091,7 +1121,7 @@ public:
     //! @param [in]     scalar      乗算するスカラー値.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3          operator *  ( float ) const;
+    constexpr Vector3          operator *  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      除算演算子です.
@@ -1099,7 +1129,7 @@ public:
     //! @param [in]     scalar      除算するスカラー値.
     //! @return     除算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector3          operator /  ( float ) const;
+    constexpr Vector3          operator /  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      等価比較演算子です.
@@ -1107,7 +1137,7 @@ public:
     //! @param [in]     value       比較する値.
     //! @return     値が等価であればtrue, そうでなければfalseを返却します.
     //-------------------------------------------------------------------------
-    bool             operator == ( const Vector3& ) const;
+    constexpr bool             operator == ( const Vector3& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      非等価比較演算子です.
@@ -1115,7 +1145,7 @@ public:
     //! @param [in]     value       比較する値.
     //! @return     値が非等価であればtrue, そうでなければfalseを返却します.
     //-------------------------------------------------------------------------
-    bool             operator != ( const Vector3& ) const;
+    constexpr bool             operator != ( const Vector3& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルの長さを求めます.
@@ -1129,7 +1159,7 @@ public:
     //!
     //! @return     ベクトルの長さの2乗値を返却します.
     //-------------------------------------------------------------------------
-    float             LengthSq        () const;
+    constexpr float             LengthSq        () const;
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルを正規化します.
@@ -1171,7 +1201,7 @@ public:
     //! @param [in]     b           最大値.
     //! @return     クランプされた値を返却します.
     //-------------------------------------------------------------------------
-    static Vector3 Clamp( const Vector3& value, const Vector3& a, const Vector3& b );
+    static constexpr Vector3 Clamp( const Vector3& value, const Vector3& a, const Vector3& b );
 
     //-------------------------------------------------------------------------
     //! @brief      値を指定された範囲内に制限します.
@@ -1189,7 +1219,7 @@ public:
     //! @param [in]     value       クランプする値.
     //! @return     クランプされた値.
     //-------------------------------------------------------------------------
-    static Vector3 Saturate( const Vector3& value );
+    static constexpr Vector3 Saturate( const Vector3& value );
 
     //-------------------------------------------------------------------------
     //! @brief      指定された値を0～1の範囲に制限します.
@@ -1224,7 +1254,7 @@ public:
     //! @param [in]     b           入力ベクトル.
     //! @return     2つのベクトル間の距離の2乗値を返却します.
     //-------------------------------------------------------------------------
-    static float     DistanceSq( const Vector3& a, const Vector3& b );
+    static constexpr float     DistanceSq( const Vector3& a, const Vector3& b );
 
     //-------------------------------------------------------------------------
     //! @brief      2つのベクトル間の距離の2乗値を求めます.
@@ -1242,7 +1272,7 @@ public:
     //! @param [in]     b           入力ベクトル.
     //! @return     ベクトルの内積を返却します.
     //-------------------------------------------------------------------------
-    static float     Dot( const Vector3& a, const Vector3& b );
+    static constexpr float     Dot( const Vector3& a, const Vector3& b );
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルの内積を求めます.
@@ -1260,7 +1290,7 @@ public:
     //! @param [in]     b           入力ベクトル.
     //! @return     ベクトルの外積を返却します.
     //-------------------------------------------------------------------------
-    static Vector3 Cross( const Vector3& a, const Vector3& b );
+    static constexpr Vector3 Cross( const Vector3& a, const Vector3& b );
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルの外積を求めます.
@@ -1373,7 +1403,7 @@ public:
     //! @param [in]     b           比較する値.
     //! @return     各成分の最小値を求め，その結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector3 Min( const Vector3& a, const Vector3& b );
+    static constexpr Vector3 Min( const Vector3& a, const Vector3& b );
 
     //-------------------------------------------------------------------------
     //! @brief      各成分の最小値を求めます.
@@ -1391,7 +1421,7 @@ public:
     //! @param [in]     b           比較する値.
     //! @return     各成分の最大値を求め，その結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector3 Max( const Vector3& a, const Vector3& b );
+    static constexpr Vector3 Max( const Vector3& a, const Vector3& b );
 
     //-------------------------------------------------------------------------
     //! @brief      各成分の最大値を求めます.
@@ -1520,7 +1550,7 @@ public:
     //! @param [in]     amount      重み(0～1の値範囲で指定).
     //! @return     線形補間の結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector3 Lerp( const Vector3& a, const Vector3& b, float amount );
+    static constexpr Vector3 Lerp( const Vector3& a, const Vector3& b, float amount );
 
     //-------------------------------------------------------------------------
     //! @brief      線形補間を行います.
@@ -1588,6 +1618,42 @@ public:
     //-------------------------------------------------------------------------
     static void    TransformNormal( const Vector3& normal, const Matrix& matrix, Vector3 &result );
 
+    //-------------------------------------------------------------------------
+    //! @brief      指定された3x4行列を用いて，ベクトルを変換します.
+    //!
+    //! @param [in]     position    入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @return     変換されたベクトルを返却します.
+    //-------------------------------------------------------------------------
+    static Vector3 Transform( const Vector3& position, const Matrix34& matrix );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された3x4行列を用いて，ベクトルを変換します.
+    //!
+    //! @param [in]     position    入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      変換されたベクトル.
+    //-------------------------------------------------------------------------
+    static void    Transform( const Vector3& position, const Matrix34& matrix, Vector3 &result );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された3x4行列を用いて，法線ベクトルを変換します.
+    //!
+    //! @param [in]     normal      入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @return     変換された法線ベクトル.
+    //-------------------------------------------------------------------------
+    static Vector3 TransformNormal( const Vector3& normal, const Matrix34& matrix );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された3x4行列を用いて，法線ベクトルを変換します.
+    //!
+    //! @param [in]     normal      入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      変換された法線ベクトル.
+    //-------------------------------------------------------------------------
+    static void    TransformNormal( const Vector3& normal, const Matrix34& matrix, Vector3 &result );
+
     //-------------------------------------------------------------------------
     //! @brief      指定された行列を用いてベクトルを変換し，変換結果をw=1に射影します.
     //!
@@ -1606,6 +1672,44 @@ public:
     //-------------------------------------------------------------------------
     static void    TransformCoord( const Vector3& coord, const Matrix& matrix, Vector3& result );
 
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトル配列を一括変換します.
+    //!
+    //! @param [in]     pInput          入力ベクトル配列.
+    //! @param [in]     inputStride     入力要素間のバイト数.
+    //! @param [in]     count           変換する要素数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         出力ベクトル配列.
+    //! @param [in]     outputStride    出力要素間のバイト数.
+    //! @note       入力と出力は同じ配列(同じストライド)でも構いません.
+    //!             ASDX_ENABLE_SIMD定義時は4要素ずつSSE2で処理します.
+    //-------------------------------------------------------------------------
+    static void    TransformArray( const Vector3* pInput, size_t inputStride, size_t count, const Matrix& matrix, Vector3* pOutput, size_t outputStride );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，法線ベクトル配列を一括変換します.
+    //!
+    //! @param [in]     pInput          入力法線ベクトル配列.
+    //! @param [in]     inputStride     入力要素間のバイト数.
+    //! @param [in]     count           変換する要素数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         出力法線ベクトル配列.
+    //! @param [in]     outputStride    出力要素間のバイト数.
+    //-------------------------------------------------------------------------
+    static void    TransformNormalArray( const Vector3* pInput, size_t inputStride, size_t count, const Matrix& matrix, Vector3* pOutput, size_t outputStride );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いてベクトル配列を一括変換し，変換結果をw=1に射影します.
+    //!
+    //! @param [in]     pInput          入力ベクトル配列.
+    //! @param [in]     inputStride     入力要素間のバイト数.
+    //! @param [in]     count           変換する要素数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         出力ベクトル配列.
+    //! @param [in]     outputStride    出力要素間のバイト数.
+    //-------------------------------------------------------------------------
+    static void    TransformCoordArray( const Vector3* pInput, size_t inputStride, size_t count, const Matrix& matrix, Vector3* pOutput, size_t outputStride );
+
     //-------------------------------------------------------------------------
     //! @brief      スカラー3重積を計算します.
     //!
@@ -1700,7 +1804,7 @@ struct Vector4
     //! @param [in]     value       乗算されるベクトル.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    friend Vector4   operator *  ( float, const Vector4& );
+    friend constexpr Vector4   operator *  ( float, const Vector4& );
 
 public:
     //=========================================================================
@@ -1718,14 +1822,14 @@ public:
     //-------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //-------------------------------------------------------------------------
-    Vector4();
+    constexpr Vector4();
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
     //!
     //! @param [in]     pValeus     要素数4の配列.
     //-------------------------------------------------------------------------
-    Vector4( const float* );
+    constexpr Vector4( const float* );
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -1734,7 +1838,7 @@ public:
     //! @param [in]     nz          Z成分.
     //! @param [in]     nw          W成分.
     //-------------------------------------------------------------------------
-    Vector4( const Vector2& value, float nz, float nw );
+    constexpr Vector4( const Vector2& value, float nz, float nw );
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -1742,7 +1846,7 @@ public:
     //! @param [in]     value       3次元ベクトル.
     //! @param [in]     nw          W成分.
     //-------------------------------------------------------------------------
-    Vector4( const Vector3& value, float nw );
+    constexpr Vector4( const Vector3& value, float nw );
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -1752,7 +1856,7 @@ public:
     //! @param [in]     nz           Z成分.
     //! @param [in]     nw           W成分.
     //-------------------------------------------------------------------------
-    Vector4( float nx, float ny, float nz, float nw );
+    constexpr Vector4( float nx, float ny, float nz, float nw );
 
     //-------------------------------------------------------------------------
     //! @brief      float*型への演算子です.
@@ -1774,7 +1878,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4&         operator += ( const Vector4& );
+    constexpr Vector4&         operator += ( const Vector4& );
 
     //-------------------------------------------------------------------------
     //! @brief      減算代入演算子です.
@@ -1782,7 +1886,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4&         operator -= ( const Vector4& );
+    constexpr Vector4&         operator -= ( const Vector4& );
 
     //-------------------------------------------------------------------------
     //! @brief      乗算代入演算子です.
@@ -1790,7 +1894,7 @@ public:
     //! @param [in]     scalar      乗算するスカラー値.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4&         operator *= ( float );
+    constexpr Vector4&         operator *= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      除算代入演算子です.
@@ -1798,7 +1902,7 @@ public:
     //! @param [in]     scalar      除算するスカラー値.
     //! @return     除算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4&         operator /= ( float );
+    constexpr Vector4&         operator /= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      代入演算子です.
@@ -1806,21 +1910,21 @@ public:
     //! @param [in]     value       代入する値.
     //! @return     代入結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4&         operator =  ( const Vector4& );
+    constexpr Vector4&         operator =  ( const Vector4& );
 
     //-------------------------------------------------------------------------
     //! @brief      正符号演算子です.
     //!
     //! @return     自分自身の値を返却します.
     //-------------------------------------------------------------------------
-    Vector4          operator +  () const;
+    constexpr Vector4          operator +  () const;
 
     //-------------------------------------------------------------------------
     //! @brief      負符号演算子です.
     //!
     //! @return     負符号を付けた値を返却します.
     //-------------------------------------------------------------------------
-    Vector4          operator -  () const;
+    constexpr Vector4          operator -  () const;
 
     //-------------------------------------------------------------------------
     //! @brief      加算演算子です.
@@ -1828,7 +1932,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4          operator +  ( const Vector4& ) const;
+    constexpr Vector4          operator +  ( const Vector4& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      減算演算子です.
@@ -1836,7 +1940,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4          operator -  ( const Vector4& ) const;
+    constexpr Vector4          operator -  ( const Vector4& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      乗算演算子です.
@@ -1844,7 +1948,7 @@ public:
     //! @param [in]     scalar      乗算するスカラー値.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4          operator *  ( float ) const;
+    constexpr Vector4          operator *  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      除算演算子です.
@@ -1852,7 +1956,7 @@ public:
     //! @param [in]     scalar      除算するスカラー値.
     //! @return     除算結果を返却します.
     //-------------------------------------------------------------------------
-    Vector4          operator /  ( float ) const;
+    constexpr Vector4          operator /  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      等価比較演算子です.
@@ -1860,7 +1964,7 @@ public:
     //! @param [in]     value       比較する値.
     //! @return     値が等価であればtrue, そうでなければfalseを返却します.
     //-------------------------------------------------------------------------
-    bool             operator == ( const Vector4& ) const;
+    constexpr bool             operator == ( const Vector4& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      非等価比較演算子です.
@@ -1868,7 +1972,7 @@ public:
     //! @param [in]     value       比較する値.
     //! @return     値が非等価であればtrue, そうでなければfalseを返却します.
     //-------------------------------------------------------------------------
-    bool             operator != ( const Vector4& ) const;
+    constexpr bool             operator != ( const Vector4& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルの長さを求めます.
@@ -1882,7 +1986,7 @@ public:
     //!
     //! @return     ベクトルの長さの2乗値を返却します.
     //-------------------------------------------------------------------------
-    float              LengthSq       () const;
+    constexpr float              LengthSq       () const;
 
     //-------------------------------------------------------------------------
     //! @brief      ベクトルを正規化します.
@@ -1924,7 +2028,7 @@ public:
     //! @param [in]     b           最大値.
     //! @return     クランプされた値を返却します.
     //-------------------------------------------------------------------------
-    static Vector4 Clamp( const Vector4& value, const Vector4& a, const Vector4& b );
+    static constexpr Vector4 Clamp( const Vector4& value, const Vector4& a, const Vector4& b );
 
     //-------------------------------------------------------------------------
     //! @brief      値を指定された範囲内に制限します.
@@ -1942,7 +2046,7 @@ public:
     //! @param [in]     value       クランプする値.
     //! @return     クランプされた値.
     //-------------------------------------------------------------------------
-    static Vector4 Saturate( const Vector4& value );
+    static constexpr Vector4 Saturate( const Vector4& value );
 
     //-------------------------------------------------------------------------
     //! @brief      指定された値を0～1の範囲に制限します.
@@ -1977,7 +2081,7 @@ public:
     //! @param [in]     b           入力ベクトル.
     //! @return     2つのベクトル間の距離の2乗値を返却します.
     //-------------------------------------------------------------------------
-    static float     DistanceSq( const Vector4& a, const Vector4& b );
+    static constexpr float     DistanceSq( const Vector4& a, const Vector4& b );
 
     //-------------------------------------------------------------------------
     //! @brief      2つのベクトル間の距離の2乗値を求めます.
@@ -2066,7 +2170,7 @@ public:
     //! @param [in]     b           比較する値.
     //! @return     各成分の最小値を求め，その結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector4 Min( const Vector4& a, const Vector4& b );
+    static constexpr Vector4 Min( const Vector4& a, const Vector4& b );
 
     //-------------------------------------------------------------------------
     //! @brief      各成分の最小値を求めます.
@@ -2084,7 +2188,7 @@ public:
     //! @param [in]     b           比較する値.
     //! @return     各成分の最大値を求め，その結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector4 Max( const Vector4& a, const Vector4& b );
+    static constexpr Vector4 Max( const Vector4& a, const Vector4& b );
 
     //-------------------------------------------------------------------------
     //! @brief      各成分の最大値を求めます.
@@ -2175,7 +2279,7 @@ public:
     //! @param [in]     amount      重み(0～1の値範囲で指定).
     //! @return     線形補間の結果を返却します.
     //-------------------------------------------------------------------------
-    static Vector4 Lerp( const Vector4& a, const Vector4& b, float amount );
+    static constexpr Vector4 Lerp( const Vector4& a, const Vector4& b, float amount );
 
     //-------------------------------------------------------------------------
     //! @brief      線形補間を行います.
@@ -2244,7 +2348,7 @@ struct Matrix
     //! @param [in]     value       乗算される行列.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    friend Matrix operator * ( float, const Matrix& );
+    friend constexpr Matrix operator * ( float, const Matrix& );
 
 public:
     //=========================================================================
@@ -2277,7 +2381,7 @@ public:
     //!
     //! @param [in]     pValues     要素数16の配列.
     //-------------------------------------------------------------------------
-    explicit Matrix( const float* );
+    explicit constexpr Matrix( const float* );
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -2299,7 +2403,7 @@ public:
     //! @param [in]     m43         4行3列の値.
     //! @param [in]     m44         4行4列の値.
     //-------------------------------------------------------------------------
-    explicit Matrix (
+    explicit constexpr Matrix (
         float m11, float m12, float m13, float m14,
         float m21, float m22, float m23, float m24,
         float m31, float m32, float m33, float m34,
@@ -2313,7 +2417,14 @@ public:
     //! @param[in]      v2      3行目の値です.
     //! @param[in]      v3      4行目の値です.
     //---------------------------------------------------------------------------------------------
-    explicit Matrix( const Vector4& v1, const Vector4& v2, const Vector4& v3, const Vector4& v4 );
+    explicit constexpr Matrix( const Vector4& v1, const Vector4& v2, const Vector4& v3, const Vector4& v4 );
+
+    //-------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param[in]      value       3x4アフィン変換行列です.
+    //-------------------------------------------------------------------------
+    explicit constexpr Matrix( const Matrix34& value );
 
     //-------------------------------------------------------------------------
     //! @brief      インデクサです.
@@ -2361,7 +2472,7 @@ public:
     //! @param [in]     value       加算する行列.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Matrix& operator += ( const Matrix& );
+    constexpr Matrix& operator += ( const Matrix& );
 
     //-------------------------------------------------------------------------
     //! @brief      減算代入演算子です.
@@ -2369,7 +2480,7 @@ public:
     //! @param [in]     value       減算する行列.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Matrix& operator -= ( const Matrix& );
+    constexpr Matrix& operator -= ( const Matrix& );
 
     //-------------------------------------------------------------------------
     //! @brief      乗算代入演算子です.
@@ -2377,7 +2488,7 @@ public:
     //! @param [in]     scalar      乗算するスカラー値.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    Matrix& operator *= ( float );
+    constexpr Matrix& operator *= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      除算代入演算子です.
@@ -2385,7 +2496,7 @@ public:
     //! @param [in]     scalar      除算するスカラー値.
     //! @return     除算結果を返却します.
     //-------------------------------------------------------------------------
-    Matrix& operator /= ( float );
+    constexpr Matrix& operator /= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      代入演算子です.
@@ -2400,14 +2511,14 @@ public:
     //!
     //! @return     自分自身を値を返却します.
     //-------------------------------------------------------------------------
-    Matrix  operator + () const;
+    constexpr Matrix  operator + () const;
 
     //-------------------------------------------------------------------------
     //! @brief      負符号演算子です.
     //
     //! @return     各成分にマイナスを付けた値を返却します.
     //-------------------------------------------------------------------------
-    Matrix  operator - () const;
+    constexpr Matrix  operator - () const;
 
     //-------------------------------------------------------------------------
     //! @brief      乗算演算子です.
@@ -2423,7 +2534,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Matrix  operator +  ( const Matrix& ) const;
+    constexpr Matrix  operator +  ( const Matrix& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      減算演算子です.
@@ -2431,7 +2542,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @retrurn    減算結果を返却します.
     //-------------------------------------------------------------------------
-    Matrix  operator -  ( const Matrix& ) const;
+    constexpr Matrix  operator -  ( const Matrix& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      乗算演算子です.
@@ -2439,14 +2550,14 @@ public:
     //! @param [in]     scalar      乗算するスカラー値.
     //! @return     乗算結果を返却します.
     //-------------------------------------------------------------------------
-    Matrix  operator *  ( float ) const;
+    constexpr Matrix  operator *  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      除算演算子です.
     //!
     //! @param [in]     scalar      除算するスカラー値.
     //-------------------------------------------------------------------------
-    Matrix  operator /  ( float ) const;
+    constexpr Matrix  operator /  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      等価比較演算子です.
@@ -2478,14 +2589,14 @@ public:
     //!
     //! @return     単位行列にした結果を返却します.
     //-------------------------------------------------------------------------
-    Matrix& Identity();
+    constexpr Matrix& Identity();
     
     //-------------------------------------------------------------------------
     //! @brief      単位行列を取得します.
     //!
     //! @return     単位行列を返却します.
     //-------------------------------------------------------------------------
-    static Matrix   CreateIdentity();
+    static constexpr Matrix   CreateIdentity();
 
     //-------------------------------------------------------------------------
     //! @brief      単位行列であるか判定します.
@@ -2496,13 +2607,31 @@ public:
     //-------------------------------------------------------------------------
     static bool    IsIdentity( const Matrix &value );
 
+    //-------------------------------------------------------------------------
+    //! @brief      アフィン変換行列であるか判定します.
+    //!
+    //! @param [in]     value       判定する値.
+    //! @retval true    4列目が(0, 0, 0, 1)です.
+    //! @retval false   アフィン変換行列ではありません.
+    //-------------------------------------------------------------------------
+    static bool    IsAffine( const Matrix& value );
+
+    //-------------------------------------------------------------------------
+    //! @brief      剛体変換行列であるか判定します.
+    //!
+    //! @param [in]     value       判定する値.
+    //! @retval true    アフィン変換行列であり, 左上3x3が正規直交です.
+    //! @retval false   剛体変換行列ではありません.
+    //-------------------------------------------------------------------------
+    static bool    IsRigid( const Matrix& value );
+
     //-------------------------------------------------------------------------
     //! @brief      行列を転置します.
     //!
     //! @param [in]     value       転置する行列.
     //! @return     行列を転置した結果を返却します.
     //-------------------------------------------------------------------------
-    static Matrix  Transpose( const Matrix& value );
+    static constexpr Matrix  Transpose( const Matrix& value );
 
     //-------------------------------------------------------------------------
     //! @brief      行列を転置します.
@@ -2537,7 +2666,7 @@ public:
     //! @param [in]     scalar      スカラー値.
     //! @return     行列をスカラー倍した結果を返却します.
     //-------------------------------------------------------------------------
-    static Matrix  Multiply( const Matrix& value, float scalar );
+    static constexpr Matrix  Multiply( const Matrix& value, float scalar );
 
     //-------------------------------------------------------------------------
     //! @brief      スカラー乗算します.
@@ -2581,13 +2710,45 @@ public:
     //-------------------------------------------------------------------------
     static void    Invert( const Matrix& value, Matrix &result );
 
+    //-------------------------------------------------------------------------
+    //! @brief      アフィン変換行列の逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値(4列目が(0, 0, 0, 1)であること).
+    //! @note       左上3x3と平行移動のみを計算するため Invert() より高速です.
+    //-------------------------------------------------------------------------
+    static Matrix  InvertAffine( const Matrix& value );
+
+    //-------------------------------------------------------------------------
+    //! @brief      アフィン変換行列の逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値(4列目が(0, 0, 0, 1)であること).
+    //! @param [out]    result      逆行列.
+    //-------------------------------------------------------------------------
+    static void    InvertAffine( const Matrix& value, Matrix &result );
+
+    //-------------------------------------------------------------------------
+    //! @brief      剛体変換行列の逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値(回転と平行移動のみであること).
+    //! @note       左上3x3を転置して求めます. スケールを含む場合は InvertAffine() を使用してください.
+    //-------------------------------------------------------------------------
+    static Matrix  InvertRigid( const Matrix& value );
+
+    //-------------------------------------------------------------------------
+    //! @brief      剛体変換行列の逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値(回転と平行移動のみであること).
+    //! @param [out]    result      逆行列.
+    //-------------------------------------------------------------------------
+    static void    InvertRigid( const Matrix& value, Matrix &result );
+
     //-------------------------------------------------------------------------
     //! @brief      拡大縮小行列を生成します.
     //!
     //! @param [in]     scale      拡大縮小値.
     //! @return     拡大縮小行列を返却します.
     //-------------------------------------------------------------------------
-    static Matrix  CreateScale( float scale );
+    static constexpr Matrix  CreateScale( float scale );
 
     //-------------------------------------------------------------------------
     //! @brief      拡大縮小行列を生成します.
@@ -2605,7 +2766,7 @@ public:
     //! @param [in]     sz          Z成分の拡大縮小値.
     //! @return     拡大縮小行列を返却します.
     //-------------------------------------------------------------------------
-    static Matrix  CreateScale( float sx, float sy, float sz );
+    static constexpr Matrix  CreateScale( float sx, float sy, float sz );
 
     //-------------------------------------------------------------------------
     //! @brief      拡大縮小行列を生成します.
@@ -2623,7 +2784,7 @@ public:
     //! @param [in]     scale       拡大縮小値.
     //! @return     拡大縮小行列を返却します.
     //-------------------------------------------------------------------------
-    static Matrix  CreateScale( const Vector3& scale );
+    static constexpr Matrix  CreateScale( const Vector3& scale );
 
     //-------------------------------------------------------------------------
     //! @brief      拡大縮小行列を生成します.
@@ -2641,7 +2802,7 @@ public:
     //! @param [in]     tz          Z成分の平行移動値.
     //! @return     平行移動行列を返却します.
     //-------------------------------------------------------------------------
-    static Matrix  CreateTranslation( float tx, float ty, float tz );
+    static constexpr Matrix  CreateTranslation( float tx, float ty, float tz );
 
     //-------------------------------------------------------------------------
     //! @brief      平行移動行列を生成します.
@@ -2659,7 +2820,7 @@ public:
     //! @param [in]     translate   平行移動値.
     //! @return     平行移動行列を返却します.
     //-------------------------------------------------------------------------
-    static Matrix  CreateTranslation( const Vector3& translate );
+    static constexpr Matrix  CreateTranslation( const Vector3& translate );
 
     //-------------------------------------------------------------------------
     //! @brief      平行移動行列を生成します.
@@ -2983,7 +3144,7 @@ public:
     //! @param [in]     amount      補間係数.
     //! @return     線形補間した行列を返却します.
     //-------------------------------------------------------------------------
-    static Matrix  Lerp( const Matrix& a, const Matrix& b, float amount );
+    static constexpr Matrix  Lerp( const Matrix& a, const Matrix& b, float amount );
 
     //-------------------------------------------------------------------------
     //! @brief      2つの行列を線形補間します.
@@ -3065,6 +3226,186 @@ public:
 };
 
 
+///////////////////////////////////////////////////////////////////////////////
+// Matrix34 structure
+///////////////////////////////////////////////////////////////////////////////
+struct Matrix34
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    //! Matrix を転置した上3行を保持します. 各行の4列目が平行移動成分です.
+    //! シェーダには float3x4 (float4 x 3) としてそのまま転送できます.
+    union
+    {
+        struct
+        {
+            float _11, _12, _13, _14;
+            float _21, _22, _23, _24;
+            float _31, _32, _33, _34;
+        };
+        float m[3][4];
+        Vector4 row[3];
+    };
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    Matrix34();
+
+    //-------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param [in]     pValues     要素数12の配列.
+    //-------------------------------------------------------------------------
+    explicit Matrix34( const float* );
+
+    //-------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param [in]     m11         1行1列の値.
+    //! @param [in]     m12         1行2列の値.
+    //! @param [in]     m13         1行3列の値.
+    //! @param [in]     m14         1行4列の値(X方向の平行移動).
+    //! @param [in]     m21         2行1列の値.
+    //! @param [in]     m22         2行2列の値.
+    //! @param [in]     m23         2行3列の値.
+    //! @param [in]     m24         2行4列の値(Y方向の平行移動).
+    //! @param [in]     m31         3行1列の値.
+    //! @param [in]     m32         3行2列の値.
+    //! @param [in]     m33         3行3列の値.
+    //! @param [in]     m34         3行4列の値(Z方向の平行移動).
+    //-------------------------------------------------------------------------
+    explicit constexpr Matrix34 (
+        float m11, float m12, float m13, float m14,
+        float m21, float m22, float m23, float m24,
+        float m31, float m32, float m33, float m34 );
+
+    //-------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param [in]     value       アフィン変換行列(4列目が(0, 0, 0, 1)であること).
+    //-------------------------------------------------------------------------
+    explicit Matrix34( const Matrix& value );
+
+    //-------------------------------------------------------------------------
+    //! @brief      float*型へのキャストです.
+    //-------------------------------------------------------------------------
+    operator       float* ();
+
+    //-------------------------------------------------------------------------
+    //! @brief      const float*型へのキャストです.
+    //-------------------------------------------------------------------------
+    operator const float* () const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      代入演算子です.
+    //!
+    //! @param [in]     value       代入する値.
+    //! @return     代入結果を返却します.
+    //-------------------------------------------------------------------------
+    Matrix34& operator =  ( const Matrix34& );
+
+    //-------------------------------------------------------------------------
+    //! @brief      乗算代入演算子です.
+    //!
+    //! @param [in]     value       後から適用する変換.
+    //! @return     乗算結果を返却します.
+    //-------------------------------------------------------------------------
+    Matrix34& operator *= ( const Matrix34& );
+
+    //-------------------------------------------------------------------------
+    //! @brief      乗算演算子です.
+    //!
+    //! @param [in]     value       後から適用する変換.
+    //! @return     乗算結果を返却します.
+    //-------------------------------------------------------------------------
+    Matrix34  operator *  ( const Matrix34& ) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      等価比較演算子です.
+    //-------------------------------------------------------------------------
+    bool      operator == ( const Matrix34& ) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      非等価比較演算子です.
+    //-------------------------------------------------------------------------
+    bool      operator != ( const Matrix34& ) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      単位行列化します.
+    //-------------------------------------------------------------------------
+    Matrix34& Identity();
+
+    //-------------------------------------------------------------------------
+    //! @brief      単位行列を生成します.
+    //!
+    //! @return     単位行列を返却します.
+    //-------------------------------------------------------------------------
+    static constexpr Matrix34 CreateIdentity();
+
+    //-------------------------------------------------------------------------
+    //! @brief      変換を連結します.
+    //!
+    //! @param [in]     a           先に適用する変換.
+    //! @param [in]     b           後から適用する変換.
+    //! @return     Matrix( a ) * Matrix( b ) と同じ変換を返却します.
+    //-------------------------------------------------------------------------
+    static Matrix34 Multiply( const Matrix34& a, const Matrix34& b );
+
+    //-------------------------------------------------------------------------
+    //! @brief      変換を連結します.
+    //!
+    //! @param [in]     a           先に適用する変換.
+    //! @param [in]     b           後から適用する変換.
+    //! @param [out]    result      Matrix( a ) * Matrix( b ) と同じ変換.
+    //-------------------------------------------------------------------------
+    static void     Multiply( const Matrix34& a, const Matrix34& b, Matrix34& result );
+
+    //-------------------------------------------------------------------------
+    //! @brief      逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値.
+    //! @return     逆行列を返却します.
+    //-------------------------------------------------------------------------
+    static Matrix34 Invert( const Matrix34& value );
+
+    //-------------------------------------------------------------------------
+    //! @brief      逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値.
+    //! @param [out]    result      逆行列.
+    //-------------------------------------------------------------------------
+    static void     Invert( const Matrix34& value, Matrix34& result );
+
+    //-------------------------------------------------------------------------
+    //! @brief      剛体変換行列の逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値(回転と平行移動のみであること).
+    //! @return     逆行列を返却します.
+    //-------------------------------------------------------------------------
+    static Matrix34 InvertRigid( const Matrix34& value );
+
+    //-------------------------------------------------------------------------
+    //! @brief      剛体変換行列の逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値(回転と平行移動のみであること).
+    //! @param [out]    result      逆行列.
+    //-------------------------------------------------------------------------
+    static void     InvertRigid( const Matrix34& value, Matrix34& result );
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Quaternion structure
 ///////////////////////////////////////////////////////////////////////////////
@@ -3081,7 +3422,7 @@ struct Quaternion
     //! @param [in]     value           乗算される四元数.
     //! @return         乗算結果を返却します.
     //-------------------------------------------------------------------------
-    friend Quaternion operator * ( float, const Quaternion& );
+    friend constexpr Quaternion operator * ( float, const Quaternion& );
 
 public:
     //=========================================================================
@@ -3106,7 +3447,7 @@ public:
     //!
     //! @param [in]     pValues     要素数4の配列.
     //-------------------------------------------------------------------------
-    Quaternion( const float* );
+    constexpr Quaternion( const float* );
 
     //-------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -3116,7 +3457,7 @@ public:
     //! @param [in]     nz          Z成分.
     //! @param [in]     nw          W成分.
     //-------------------------------------------------------------------------
-    Quaternion( float nx, float ny, float nz, float nw );
+    constexpr Quaternion( float nx, float ny, float nz, float nw );
 
     //-------------------------------------------------------------------------
     //! @brief      float*型へのキャストです.
@@ -3138,7 +3479,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion& operator += ( const Quaternion& );
+    constexpr Quaternion& operator += ( const Quaternion& );
 
     //-------------------------------------------------------------------------
     //! @brief      減算代入演算子です.
@@ -3146,7 +3487,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion& operator -= ( const Quaternion& );
+    constexpr Quaternion& operator -= ( const Quaternion& );
 
     //-------------------------------------------------------------------------
     //! @brief      乗算代入演算子です.
@@ -3162,7 +3503,7 @@ public:
     //! @param [in]     scalar      スカラー乗算する値.
     //! @return     スカラー乗算した結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion& operator *= ( float );
+    constexpr Quaternion& operator *= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      除算代入演算子です.
@@ -3170,21 +3511,21 @@ public:
     //! @param [in]     scalar      スカラー除算する値.
     //! @return     スカラー除算した結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion& operator /= ( float );
+    constexpr Quaternion& operator /= ( float );
 
     //-------------------------------------------------------------------------
     //! @brief      正符号演算子です.
     //!
     //! @return     自分自身の値を返却します.
     //-------------------------------------------------------------------------
-    Quaternion  operator + () const;
+    constexpr Quaternion  operator + () const;
 
     //-------------------------------------------------------------------------
     //! @brief      負符号演算子です.
     //!
     //! @return     各成分の符号を反転した結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion  operator - () const;
+    constexpr Quaternion  operator - () const;
 
     //-------------------------------------------------------------------------
     //! @brief      乗算演算子です.
@@ -3200,7 +3541,7 @@ public:
     //! @param [in]     value       加算する値.
     //! @return     加算結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion  operator +  ( const Quaternion& ) const;
+    constexpr Quaternion  operator +  ( const Quaternion& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      減算演算子です.
@@ -3208,7 +3549,7 @@ public:
     //! @param [in]     value       減算する値.
     //! @return     減算結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion  operator -  ( const Quaternion& ) const;
+    constexpr Quaternion  operator -  ( const Quaternion& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      乗算演算子です.
@@ -3216,7 +3557,7 @@ public:
     //! @param [in]     scalar      スカラー乗算する値.
     //! @return     スカラー乗算した結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion  operator *  ( float ) const;
+    constexpr Quaternion  operator *  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      除算演算子です.
@@ -3224,7 +3565,7 @@ public:
     //! @param [in]     scalar      スカラー除算する値.
     //! @return     スカラー除算した結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion  operator /  ( float ) const;
+    constexpr Quaternion  operator /  ( float ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      等価比較演算子です.
@@ -3233,7 +3574,7 @@ public:
     //! @retval true    等価です.
     //! @retval false   非等価です.
     //-------------------------------------------------------------------------
-    bool        operator == ( const Quaternion& ) const;
+    constexpr bool        operator == ( const Quaternion& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      非等価比較演算子です.
@@ -3242,7 +3583,7 @@ public:
     //! @retval true    非等価です.
     //! @retval flase   等価です.
     //-------------------------------------------------------------------------
-    bool        operator != ( const Quaternion& ) const;
+    constexpr bool        operator != ( const Quaternion& ) const;
 
     //-------------------------------------------------------------------------
     //! @brief      四元数の長さを求めます.
@@ -3256,7 +3597,7 @@ public:
     //!
     //! @return     四元数の長さの2乗値を返却します.
     //-------------------------------------------------------------------------
-    float         LengthSq     () const;
+    constexpr float         LengthSq     () const;
 
     //-------------------------------------------------------------------------
     //! @brief      四元数を正規化します.
@@ -3278,14 +3619,14 @@ public:
     //!
     //! @return     単位四元数化した結果を返却します.
     //-------------------------------------------------------------------------
-    Quaternion& Identity     ();
+    constexpr Quaternion& Identity     ();
 
     //-------------------------------------------------------------------------
     //! @brief      単位四元数を生成します.
     //!
     //! @return     単位四元数を返却します.
     //-------------------------------------------------------------------------
-    static Quaternion   CreateIdentity();
+    static constexpr Quaternion   CreateIdentity();
 
     //-------------------------------------------------------------------------
     //! @brief      単位四元数かどうかチェックします.
@@ -3329,7 +3670,7 @@ public:
     //! @param [in]     b           入力四元数.
     //! @return     四元数の内積を返却します.
     //-------------------------------------------------------------------------
-    static float         Dot( const Quaternion& a, const Quaternion& b );
+    static constexpr float         Dot( const Quaternion& a, const Quaternion& b );
 
     //-------------------------------------------------------------------------
     //! @brief      四元数の内積を求めます.
@@ -3346,7 +3687,7 @@ public:
     //! @param [in]     value       共役を求めたい四元数.
     //! @return     四元数の共役を返却します.
     //-------------------------------------------------------------------------
-    static Quaternion  Conjugate( const Quaternion& value );
+    static constexpr Quaternion  Conjugate( const Quaternion& value );
 
     //-------------------------------------------------------------------------
     //! @brief      四元数の共役を求めます.
@@ -3480,6 +3821,27 @@ public:
     //-------------------------------------------------------------------------
     static void        Slerp( const Quaternion& a, const Quaternion& b, float amount, Quaternion &result );
 
+    //-------------------------------------------------------------------------
+    //! @brief      正規化線形補間を行います.
+    //!
+    //! @param [in]     a           入力四元数.
+    //! @param [in]     b           入力四元数.
+    //! @param [in]     amount      補間係数.
+    //! @return     最短経路で線形補間した後, 正規化した結果を返却します.
+    //! @note       Slerp() より高速ですが, 角速度は一定になりません.
+    //-------------------------------------------------------------------------
+    static Quaternion  Nlerp( const Quaternion& a, const Quaternion& b, float amount );
+
+    //-------------------------------------------------------------------------
+    //! @brief      正規化線形補間を行います.
+    //!
+    //! @param [in]     a           入力四元数.
+    //! @param [in]     b           入力四元数.
+    //! @param [in]     amount      補間係数.
+    //! @param [out]    result      最短経路で線形補間した後, 正規化した結果.
+    //-------------------------------------------------------------------------
+    static void        Nlerp( const Quaternion& a, const Quaternion& b, float amount, Quaternion &result );
+
     //-------------------------------------------------------------------------
     //! @brief      球面四角形補間を行います.
     //!
@@ -3515,7 +3877,7 @@ class XorShift
     //=========================================================================
     // list of friend classes and methods.
     //=========================================================================
-    /* NOTHING */
+    friend class XorShiftX4;
 
 public:
     //=========================================================================
@@ -3632,6 +3994,23 @@ public:
     //-------------------------------------------------------------------------
     double  GetAsF64( double a, double b );
 
+    //-------------------------------------------------------------------------
+    //! @brief      乱数生成を 2^64 回分読み飛ばします.
+    //!
+    //! @note       周期は 2^128 - 1 なので, 2^64 個ずつ重ならない系列に分割できます.
+    //-------------------------------------------------------------------------
+    void Jump();
+
+    //-------------------------------------------------------------------------
+    //! @brief      独立した乱数系列を生成します.
+    //!
+    //! @param [in]     seed            設定する種.
+    //! @param [in]     streamIndex     系列番号.
+    //! @return     SetSeed( seed ) の後に Jump() を streamIndex 回呼び出した乱数生成器を返却します.
+    //! @note       スレッドごとに異なる系列番号を割り当てると, 再現性のある独立した系列が得られます.
+    //-------------------------------------------------------------------------
+    static XorShift CreateStream( int seed, uint32_t streamIndex );
+
     //-------------------------------------------------------------------------
     //! @brief      代入演算子です.
     //
@@ -3681,7 +4060,7 @@ class PCG
     //=========================================================================
     // list of friend classes and methods.
     //=========================================================================
-    /* NOTHING */
+    friend class PCGX4;
 
 public:
     //=========================================================================
@@ -3798,6 +4177,24 @@ public:
     //-------------------------------------------------------------------------
     double  GetAsF64( double a, double b );
 
+    //-------------------------------------------------------------------------
+    //! @brief      乱数生成を指定回数分読み飛ばします.
+    //!
+    //! @param [in]     delta       読み飛ばす回数.
+    //! @note       O(log delta) で状態を進めます.
+    //-------------------------------------------------------------------------
+    void Advance( uint64_t delta );
+
+    //-------------------------------------------------------------------------
+    //! @brief      独立した乱数系列を生成します.
+    //!
+    //! @param [in]     seed            設定する種.
+    //! @param [in]     streamIndex     系列番号(65536未満).
+    //! @return     SetSeed( seed ) の後に 2^48 * streamIndex 回読み飛ばした乱数生成器を返却します.
+    //! @note       スレッドごとに異なる系列番号を割り当てると, 再現性のある独立した系列が得られます.
+    //-------------------------------------------------------------------------
+    static PCG CreateStream( uint64_t seed, uint32_t streamIndex );
+
     //-------------------------------------------------------------------------
     //! @brief      代入演算子です.
     //!
@@ -3838,6 +4235,149 @@ private:
     static uint32_t Rotate(uint32_t x, uint32_t r);
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// XorShiftX4 class
+///////////////////////////////////////////////////////////////////////////////
+class XorShiftX4
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @param [in]     seed            設定する種.
+    //! @param [in]     streamIndex     系列番号.
+    //! @note       レーン k は XorShift::CreateStream( seed, streamIndex * 4 + k ) と同じ系列になります.
+    //-------------------------------------------------------------------------
+    XorShiftX4( int seed, uint32_t streamIndex = 0 );
+
+    //-------------------------------------------------------------------------
+    //! @brief      乱数をuint32_t型として一括生成します.
+    //!
+    //! @param [out]    pResult     格納先.
+    //! @param [in]     count       生成する数.
+    //! @note       pResult[4 * i + k] にレーン k の i 番目の乱数を格納します.
+    //!             count が4の倍数でない場合, 最後の1回分の余ったレーンは捨てられます.
+    //-------------------------------------------------------------------------
+    void FillU32( uint32_t* pResult, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      乱数をfloat型として一括生成します.
+    //!
+    //! @param [out]    pResult     [0, 1) の範囲の乱数の格納先.
+    //! @param [in]     count       生成する数.
+    //-------------------------------------------------------------------------
+    void FillF32( float* pResult, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された値範囲の乱数をfloat型として一括生成します.
+    //!
+    //! @param [out]    pResult     [a, b) の範囲の乱数の格納先.
+    //! @param [in]     count       生成する数.
+    //! @param [in]     a           最小値.
+    //! @param [in]     b           最大値.
+    //-------------------------------------------------------------------------
+    void FillF32( float* pResult, size_t count, float a, float b );
+
+private:
+    //=========================================================================
+    // private variables
+    //=========================================================================
+    uint32_t    m_X[4];     //!< 各レーンの変数です.
+    uint32_t    m_Y[4];     //!< 各レーンの変数です.
+    uint32_t    m_Z[4];     //!< 各レーンの変数です.
+    uint32_t    m_W[4];     //!< 各レーンの変数です.
+
+    //=========================================================================
+    // private methods
+    //=========================================================================
+    template<typename Func>
+    void Fill( size_t count, Func func );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PCGX4 class
+///////////////////////////////////////////////////////////////////////////////
+class PCGX4
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @param [in]     seed            設定する種.
+    //! @param [in]     streamIndex     系列番号(16384未満).
+    //! @note       レーン k は PCG::CreateStream( seed, streamIndex * 4 + k ) と同じ系列になります.
+    //-------------------------------------------------------------------------
+    PCGX4( uint64_t seed, uint32_t streamIndex = 0 );
+
+    //-------------------------------------------------------------------------
+    //! @brief      乱数をuint32_t型として一括生成します.
+    //!
+    //! @param [out]    pResult     格納先.
+    //! @param [in]     count       生成する数.
+    //! @note       pResult[4 * i + k] にレーン k の i 番目の乱数を格納します.
+    //!             count が4の倍数でない場合, 最後の1回分の余ったレーンは捨てられます.
+    //-------------------------------------------------------------------------
+    void FillU32( uint32_t* pResult, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      乱数をfloat型として一括生成します.
+    //!
+    //! @param [out]    pResult     [0, 1) の範囲の乱数の格納先.
+    //! @param [in]     count       生成する数.
+    //-------------------------------------------------------------------------
+    void FillF32( float* pResult, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された値範囲の乱数をfloat型として一括生成します.
+    //!
+    //! @param [out]    pResult     [a, b) の範囲の乱数の格納先.
+    //! @param [in]     count       生成する数.
+    //! @param [in]     a           最小値.
+    //! @param [in]     b           最大値.
+    //-------------------------------------------------------------------------
+    void FillF32( float* pResult, size_t count, float a, float b );
+
+private:
+    //=========================================================================
+    // private variables
+    //=========================================================================
+    uint64_t    m_State[4];     //!< 各レーンの状態です.
+
+    //=========================================================================
+    // private methods
+    //=========================================================================
+    template<typename Func>
+    void Fill( size_t count, Func func );
+};
+
 //-----------------------------------------------------------------------------
 //! @brief      正規直交基底を求めます.
 //!
@@ -3855,6 +4395,27 @@ void CalcONB(const Vector3& N, Vector3& T, Vector3& B);
 //-----------------------------------------------------------------------------
 Vector2 Hammersley( uint32_t i, uint32_t numSamples );
 
+//-----------------------------------------------------------------------------
+//! @brief      Hammersley点集合のテーブルを生成します.
+//!
+//! @param[in]      numSamples      サンプル数.
+//! @param[out]     pResult         numSamples 個のサンプルの格納先.
+//! @note       pResult[i] は Hammersley( i, numSamples ) と一致します.
+//-----------------------------------------------------------------------------
+void CreateHammersleyTable( uint32_t numSamples, Vector2* pResult );
+
+//-----------------------------------------------------------------------------
+//! @brief      2次元Sobol列のテーブルを生成します.
+//!
+//! @param[in]      count           サンプル数.
+//! @param[out]     pResult         count 個のサンプルの格納先([0, 1) の範囲).
+//! @param[in]      scrambleX       X成分のスクランブル値(ビット毎の排他的論理和).
+//! @param[in]      scrambleY       Y成分のスクランブル値(ビット毎の排他的論理和).
+//! @note       グレイコード順に1点あたり定数時間で生成します.
+//!             先頭 2^m 点は添字順の Sobol 列の先頭 2^m 点と同じ点集合になります.
+//-----------------------------------------------------------------------------
+void CreateSobolTable( uint32_t count, Vector2* pResult, uint32_t scrambleX = 0, uint32_t scrambleY = 0 );
+
 //-----------------------------------------------------------------------------
 //! @brief      平面式を正規化します.
 //!
@@ -4051,17 +4612,17 @@ Matrix CreateBrightnessMatrix(float brightness);
 //-----------------------------------------------------------------------------
 //      彩度を調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-Matrix CreateSaturationMatrix(float r, float g, float b);
+constexpr Matrix CreateSaturationMatrix(float r, float g, float b);
 
 //-----------------------------------------------------------------------------
 //      彩度を調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-Matrix CreateSaturationMatrix(float saturation);
+constexpr Matrix CreateSaturationMatrix(float saturation);
 
 //-----------------------------------------------------------------------------
 //      コントラストを調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-Matrix CreateContrastMatrix(float contrast);
+constexpr Matrix CreateContrastMatrix(float contrast);
 
 //-----------------------------------------------------------------------------
 //      色相を調整するカラー行列を生成します.
@@ -4071,17 +4632,17 @@ Matrix CreateHueMatrix(float hue);
 //-----------------------------------------------------------------------------
 //      セピアカラーを調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-Matrix CreateSepiaMatrix(float tone);
+constexpr Matrix CreateSepiaMatrix(float tone);
 
 //-----------------------------------------------------------------------------
 //      グレースケールカラーを調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-Matrix CreateGrayScaleMatrix(float tone);
+constexpr Matrix CreateGrayScaleMatrix(float tone);
 
 //-----------------------------------------------------------------------------
 //      ネガポジ反転のカラー行列を生成します.
 //-----------------------------------------------------------------------------
-Matrix CreateNegaposiMatrix();
+constexpr Matrix CreateNegaposiMatrix();
 
 } // namespace asdx
 
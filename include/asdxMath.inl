@@ -14,58 +14,58 @@ namespace asdx {
 //-----------------------------------------------------------------------------
 //      ラジアンに変換します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float ToRadian( float degree ) noexcept
 { return degree * ( F_PI / 180.0f ); }
 
 //-----------------------------------------------------------------------------
 //      ラジアンに変換します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 double ToRadian( double degree ) noexcept
 { return degree * ( D_PI / 180.0 ); }
 
 //-----------------------------------------------------------------------------
 //      度に変換します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float ToDegree( float radian ) noexcept
 { return radian * ( 180.0f / F_PI ); }
 
 //-----------------------------------------------------------------------------
 //      度に変換します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 double ToDegree( double radian ) noexcept
 { return radian * ( 180.0 / D_PI ); }
 
 //-----------------------------------------------------------------------------
 //      ゼロかどうかチェックします.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool IsZero( float value ) noexcept
-{ return fabs( value ) <= F_EPSILON; }
+{ return ( -F_EPSILON <= value ) && ( value <= F_EPSILON ); }
 
 //-----------------------------------------------------------------------------
 //      ゼロかどうかチェックします.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool IsZero( double value ) noexcept
-{ return abs( value ) <= D_EPSILON; }
+{ return ( -D_EPSILON <= value ) && ( value <= D_EPSILON ); }
 
 //-----------------------------------------------------------------------------
 //      値が等しいかどうかチェックします.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool IsEqual( float value1, float value2 ) noexcept
-{ return fabs( value1 - value2 ) <= F_EPSILON; }
+{ return IsZero( value1 - value2 ); }
 
 //-----------------------------------------------------------------------------
 //      値が等しいかどうかチェックします.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool IsEqual( double value1, double value2 ) noexcept
-{ return abs( value1 - value2 ) <= D_EPSILON; }
+{ return IsZero( value1 - value2 ); }
 
 //-----------------------------------------------------------------------------
 //      非数かどうかチェックします.
@@ -88,7 +88,8 @@ inline
 bool IsInf( float value )
 {
     // ビット列に変換して，指数部がすべて 1 かどうかチェック.
-    uint32_t f = *reinterpret_cast< uint32_t* >( &value );
+    uint32_t f;
+    memcpy( &f, &value, sizeof(f) );
     return ((f & 0x7f800000) == 0x7f800000) && (value == value);
 }
 
@@ -99,7 +100,8 @@ inline
 bool IsInf( double value )
 {
     // ビット列に変換して，指数部がすべて 1 かどうかチェック.
-    uint64_t d = *reinterpret_cast<uint64_t*>( &value );
+    uint64_t d;
+    memcpy( &d, &value, sizeof(d) );
     return ((d & 0x7ff0000000000000) == 0x7ff0000000000000) && (value == value);
 }
 
@@ -215,16 +217,24 @@ half ToHalf( float value )
     // 符号部を削ぎ落す.
     bit     = bit & 0x7FFFFFFFU;
 
+    // NaNの場合は上位ビットを残して quiet NaN にする.
+    if ( bit > 0x7F800000U)
+    { result = 0x7E00U | ( ( bit >> 13U) & 0x3FFU); }
     // halfとして表現する際に値がデカ過ぎる場合は，無限大にクランプ.
-    if ( bit > 0x47FFEFFFU)
-    { result = 0x7FFFU; }
+    else if ( bit >= 0x477FF000U)
+    { result = 0x7C00U; }
+    // 非正規化数の最小値の半分以下は0に丸める.
+    else if ( bit <= 0x33000000U)
+    { result = 0; }
     else
     {
         // 正規化されたhalfとして表現するために小さすぎる値は正規化されていない値に変換.
         if ( bit < 0x38800000U)
         {
-            uint32_t shift = 113U - ( bit >> 23U);
-            bit    = (0x800000U | ( bit & 0x7FFFFFU)) >> shift;
+            // 切り捨てたビットは最下位ビットに残して丸めに反映させる.
+            uint32_t shift    = 113U - ( bit >> 23U);
+            uint32_t mantissa = 0x800000U | ( bit & 0x7FFFFFU);
+            bit    = ( mantissa >> shift) | ( ( mantissa & ( ( 1U << shift) - 1U)) != 0 ? 1U : 0U);
         }
         else
         {
@@ -258,8 +268,16 @@ float ToFloat( half value )
     // 仮数
     uint32_t mantissa = static_cast<uint32_t>( value & 0x03FF );
 
+    // 無限大またはNaNの場合.
+    if ( ( value & 0x7C00 ) == 0x7C00 )
+    {
+        // 指数部を最大にし, NaNは quiet NaN にする.
+        exponent = 255 - 112;
+        if ( mantissa != 0 )
+        { mantissa |= 0x0200; }
+    }
     // 正規化済みの場合.
-    if ( ( value & 0x7C00 ) != 0 )
+    else if ( ( value & 0x7C00 ) != 0 )
     {
         // 指数部を計算.
         exponent = static_cast<uint32_t>( ( value >> 10 ) & 0x1F );
@@ -295,16 +313,76 @@ float ToFloat( half value )
 }
 
 //-----------------------------------------------------------------------------
-//      線形補間を行います.
+//      float型の配列をhalf型の配列に一括変換します.
+//-----------------------------------------------------------------------------
+inline
+void ToHalfArray( const float* pInput, size_t count, half* pOutput )
+{
+    assert( pInput != nullptr || count == 0 );
+    assert( pOutput != nullptr || count == 0 );
+
+    size_t i = 0;
+
+#if defined(ASDX_ENABLE_SIMD)
+    for(; i + 8 <= count; i += 8)
+    {
+    #if defined(ASDX_ENABLE_F16C)
+        auto lo = _mm_cvtps_ph( _mm_loadu_ps( pInput + i + 0 ), _MM_FROUND_TO_NEAREST_INT );
+        auto hi = _mm_cvtps_ph( _mm_loadu_ps( pInput + i + 4 ), _MM_FROUND_TO_NEAREST_INT );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pOutput + i ), _mm_unpacklo_epi64( lo, hi ) );
+    #else
+        auto lo = SimdFloatToHalf( _mm_loadu_ps( pInput + i + 0 ) );
+        auto hi = SimdFloatToHalf( _mm_loadu_ps( pInput + i + 4 ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pOutput + i ), _mm_packs_epi32( lo, hi ) );
+    #endif//defined(ASDX_ENABLE_F16C)
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    for(; i<count; ++i)
+    { pOutput[i] = ToHalf( pInput[i] ); }
+}
+
+//-----------------------------------------------------------------------------
+//      half型の配列をfloat型の配列に一括変換します.
 //-----------------------------------------------------------------------------
 inline
+void ToFloatArray( const half* pInput, size_t count, float* pOutput )
+{
+    assert( pInput != nullptr || count == 0 );
+    assert( pOutput != nullptr || count == 0 );
+
+    size_t i = 0;
+
+#if defined(ASDX_ENABLE_SIMD)
+    for(; i + 8 <= count; i += 8)
+    {
+        auto value = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pInput + i ) );
+    #if defined(ASDX_ENABLE_F16C)
+        _mm_storeu_ps( pOutput + i + 0, _mm_cvtph_ps( value ) );
+        _mm_storeu_ps( pOutput + i + 4, _mm_cvtph_ps( _mm_unpackhi_epi64( value, value ) ) );
+    #else
+        auto zero = _mm_setzero_si128();
+        _mm_storeu_ps( pOutput + i + 0, SimdHalfToFloat( _mm_unpacklo_epi16( value, zero ) ) );
+        _mm_storeu_ps( pOutput + i + 4, SimdHalfToFloat( _mm_unpackhi_epi16( value, zero ) ) );
+    #endif//defined(ASDX_ENABLE_F16C)
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    for(; i<count; ++i)
+    { pOutput[i] = ToFloat( pInput[i] ); }
+}
+
+//-----------------------------------------------------------------------------
+//      線形補間を行います.
+//-----------------------------------------------------------------------------
+constexpr
 float Lerp( float a, float b, float amount ) noexcept
 { return a + amount * ( b - a ); }
 
 //-----------------------------------------------------------------------------
 //      線形補間を行います.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 double Lerp( double a, double b, double amount ) noexcept
 { return a + amount * ( b - a ); }
 
@@ -315,14 +393,14 @@ double Lerp( double a, double b, double amount ) noexcept
 //-----------------------------------------------------------------------------
 //      コンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2::Vector2()
 { /* DO_NOTHING */ }
 
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタ.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2::Vector2( const float* pf )
 {
     assert( pf != nullptr );
@@ -333,7 +411,7 @@ Vector2::Vector2( const float* pf )
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタ.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2::Vector2( float nx, float ny )
 : x( nx )
 , y( ny )
@@ -356,7 +434,7 @@ Vector2::operator const float *() const
 //-----------------------------------------------------------------------------
 //      加算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2& Vector2::operator += ( const Vector2& v )
 {
     x += v.x;
@@ -367,7 +445,7 @@ Vector2& Vector2::operator += ( const Vector2& v )
 //-----------------------------------------------------------------------------
 //      減算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2& Vector2::operator -= ( const Vector2& v )
 {
     x -= v.x;
@@ -378,7 +456,7 @@ Vector2& Vector2::operator -= ( const Vector2& v )
 //-----------------------------------------------------------------------------
 //      乗算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2& Vector2::operator *= ( float f )
 {
     x *= f;
@@ -389,7 +467,7 @@ Vector2& Vector2::operator *= ( float f )
 //-----------------------------------------------------------------------------
 //      除算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2& Vector2::operator /= ( float f )
 {
     assert( !IsZero( f ) );
@@ -401,7 +479,7 @@ Vector2& Vector2::operator /= ( float f )
 //-----------------------------------------------------------------------------
 //      代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2& Vector2::operator = ( const Vector2& value )
 {
     x = value.x;
@@ -412,42 +490,42 @@ Vector2& Vector2::operator = ( const Vector2& value )
 //-----------------------------------------------------------------------------
 //      正符号演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::operator + () const
 { return (*this); }
 
 //-----------------------------------------------------------------------------
 //      負符号演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::operator - () const
 { return Vector2( -x, -y ); }
 
 //-----------------------------------------------------------------------------
 //      加算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::operator + ( const Vector2& v ) const
 { return Vector2( x + v.x, y + v.y ); }
 
 //-----------------------------------------------------------------------------
 //      減算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::operator - ( const Vector2& v ) const
 { return Vector2( x - v.x, y - v.y ); }
 
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::operator * ( float f ) const
 { return Vector2( x * f, y * f ); }
 
 //-----------------------------------------------------------------------------
 //      除算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::operator / ( float f ) const
 {
     assert( !IsZero( f ) );
@@ -457,14 +535,14 @@ Vector2 Vector2::operator / ( float f ) const
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 operator * ( float f, const Vector2& v )
 { return Vector2( f * v.x, f * v.y ); }
 
 //-----------------------------------------------------------------------------
 //      等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool Vector2::operator == ( const Vector2& v ) const
 { 
     return IsEqual( x, v.x )
@@ -474,7 +552,7 @@ bool Vector2::operator == ( const Vector2& v ) const
 //-----------------------------------------------------------------------------
 //      非等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool Vector2::operator != ( const Vector2& v ) const
 {
     return !IsEqual( x, v.x )
@@ -491,7 +569,7 @@ float Vector2::Length() const
 //-----------------------------------------------------------------------------
 //      長さの2乗を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Vector2::LengthSq() const
 { return ( x * x + y * y ); }
 
@@ -557,7 +635,7 @@ void Vector2::Abs( const Vector2 &value, Vector2 &result )
 //-----------------------------------------------------------------------------
 //      各成分の値を制限します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::Clamp( const Vector2& value, const Vector2& a, const Vector2& b )
 {
     return Vector2(
@@ -579,7 +657,7 @@ void Vector2::Clamp( const Vector2& value, const Vector2& a, const Vector2& b, V
 //-----------------------------------------------------------------------------
 //      各成分の値を0～1に収めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::Saturate( const Vector2& value )
 {
     return Vector2(
@@ -615,7 +693,7 @@ void Vector2::Distance( const Vector2 &a, const Vector2 &b, float &result )
 //-----------------------------------------------------------------------------
 //      2点間距離の2乗値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Vector2::DistanceSq( const Vector2& a, const Vector2& b )
 {
     auto X = b.x - a.x;
@@ -637,7 +715,7 @@ void Vector2::DistanceSq( const Vector2 &a, const Vector2 &b, float &result )
 //-----------------------------------------------------------------------------
 //      内積を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Vector2::Dot( const Vector2& a, const Vector2& b )
 { return ( a.x * b.x + a.y * b.y ); }
 
@@ -763,7 +841,7 @@ void Vector2::ComputeCrossingAngle( const Vector2 &a, const Vector2 &b, float &r
 //-----------------------------------------------------------------------------
 //      各成分の最小値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::Min( const Vector2& a, const Vector2& b )
 { 
     return Vector2(
@@ -785,7 +863,7 @@ void Vector2::Min( const Vector2 &a, const Vector2 &b, Vector2 &result )
 //-----------------------------------------------------------------------------
 //      各成分の最大値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::Max( const Vector2& a, const Vector2& b )
 {
     return Vector2(
@@ -1014,7 +1092,7 @@ void Vector2::CatmullRom
 //-----------------------------------------------------------------------------
 //      線形補間を行います.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector2 Vector2::Lerp( const Vector2& a, const Vector2& b, float amount )
 {
     return Vector2(
@@ -1138,14 +1216,14 @@ void Vector2::TransformCoord( const Vector2 &coords, const Matrix &matrix, Vecto
 //-----------------------------------------------------------------------------
 //      コンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3::Vector3()
 { /* DO_NOTHING */ }
 
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3::Vector3( const float* pf )
 {
     assert( pf != nullptr );
@@ -1157,7 +1235,7 @@ Vector3::Vector3( const float* pf )
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3::Vector3( const Vector2& value, float nz )
 : x( value.x )
 , y( value.y )
@@ -1167,7 +1245,7 @@ Vector3::Vector3( const Vector2& value, float nz )
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3::Vector3( float nx, float ny, float nz )
 : x( nx )
 , y( ny )
@@ -1191,7 +1269,7 @@ Vector3::operator const float *() const
 //-----------------------------------------------------------------------------
 //      加算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3& Vector3::operator += ( const Vector3& v )
 {
     x += v.x;
@@ -1203,7 +1281,7 @@ Vector3& Vector3::operator += ( const Vector3& v )
 //-----------------------------------------------------------------------------
 //      減算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3& Vector3::operator -= ( const Vector3& v )
 {
     x -= v.x;
@@ -1215,7 +1293,7 @@ Vector3& Vector3::operator -= ( const Vector3& v )
 //-----------------------------------------------------------------------------
 //      乗算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3& Vector3::operator *= ( float f )
 {
     x *= f;
@@ -1227,7 +1305,7 @@ Vector3& Vector3::operator *= ( float f )
 //-----------------------------------------------------------------------------
 //      除算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3& Vector3::operator /= ( float f )
 {
     assert( !IsZero( f ) );
@@ -1240,7 +1318,7 @@ Vector3& Vector3::operator /= ( float f )
 //-----------------------------------------------------------------------------
 //      代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3& Vector3::operator = ( const Vector3& value )
 {
     x = value.x;
@@ -1252,42 +1330,42 @@ Vector3& Vector3::operator = ( const Vector3& value )
 //-----------------------------------------------------------------------------
 //      正符号演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::operator + () const
 { return (*this); }
 
 //-----------------------------------------------------------------------------
 //      負符号演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::operator - () const
 { return Vector3( -x, -y, -z ); }
 
 //-----------------------------------------------------------------------------
 //      加算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::operator + ( const Vector3& v ) const
 { return Vector3( x + v.x, y + v.y, z + v.z ); }
 
 //-----------------------------------------------------------------------------
 //      減算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::operator - ( const Vector3& v ) const
 { return Vector3( x - v.x, y - v.y, z - v.z ); }
 
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::operator * ( float f ) const
 { return Vector3( x * f, y * f, z * f ); }
 
 //-----------------------------------------------------------------------------
 //      除算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::operator / ( float f ) const
 {
     assert( !IsZero( f ) );
@@ -1297,14 +1375,14 @@ Vector3 Vector3::operator / ( float f ) const
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 operator * ( float f, const Vector3& v )
 { return Vector3( f * v.x, f * v.y, f * v.z ); }
 
 //-----------------------------------------------------------------------------
 //      等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool Vector3::operator == ( const Vector3& v ) const
 {
     return IsEqual( x, v.x )
@@ -1315,7 +1393,7 @@ bool Vector3::operator == ( const Vector3& v ) const
 //-----------------------------------------------------------------------------
 //      非等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool Vector3::operator != ( const Vector3& v ) const
 { 
     return !IsEqual( x, v.x )
@@ -1333,7 +1411,7 @@ float Vector3::Length() const
 //-----------------------------------------------------------------------------
 //      ベクトルの大きさの2乗値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Vector3::LengthSq() const
 { return ( x * x + y * y + z * z); }
 
@@ -1404,7 +1482,7 @@ void Vector3::Abs( const Vector3 &value, Vector3 &result )
 //-----------------------------------------------------------------------------
 //      各成分の値を制限します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::Clamp( const Vector3& value, const Vector3& a, const Vector3& b )
 {
     return Vector3( 
@@ -1428,7 +1506,7 @@ void Vector3::Clamp( const Vector3 &value, const Vector3 &a, const Vector3 &b, V
 //-----------------------------------------------------------------------------
 //      各成分の値を0～1に収めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::Saturate( const Vector3& value )
 {
     return Vector3(
@@ -1466,7 +1544,7 @@ void Vector3::Distance( const Vector3 &a, const Vector3 &b, float &result )
 //-----------------------------------------------------------------------------
 //      2点間距離の2乗値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Vector3::DistanceSq( const Vector3& a, const Vector3& b )
 {
     auto X = b.x - a.x;
@@ -1490,7 +1568,7 @@ void Vector3::DistanceSq( const Vector3 &a, const Vector3 &b, float &result )
 //-----------------------------------------------------------------------------
 //      内積を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Vector3::Dot( const Vector3& a, const Vector3& b )
 { return ( a.x * b.x + a.y * b.y + a.z * b.z ); }
 
@@ -1504,7 +1582,7 @@ void Vector3::Dot( const Vector3 &a, const Vector3 &b, float &result )
 //-----------------------------------------------------------------------------
 //      外積を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::Cross( const Vector3& a, const Vector3& b )
 {
     return Vector3( 
@@ -1728,7 +1806,7 @@ void Vector3::ComputeCrossingAngle( const Vector3 &a, const Vector3 &b, float &r
 //-----------------------------------------------------------------------------
 //      各成分の最小値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::Min( const Vector3& a, const Vector3& b )
 { 
     return Vector3( 
@@ -1752,7 +1830,7 @@ void Vector3::Min( const Vector3 &a, const Vector3 &b, Vector3 &result )
 //-----------------------------------------------------------------------------
 //      各成分の最大値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::Max( const Vector3& a, const Vector3& b )
 {
     return Vector3(
@@ -1997,7 +2075,7 @@ void Vector3::CatmullRom
 //-----------------------------------------------------------------------------
 //      線形補間を行います.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector3 Vector3::Lerp( const Vector3& a, const Vector3& b, float amount )
 {
     return Vector3(
@@ -2092,6 +2170,58 @@ void Vector3::TransformNormal( const Vector3 &normal, const Matrix &matrix, Vect
     result.z = ((normal.x * matrix._13) + (normal.y * matrix._23)) + (normal.z * matrix._33);
 }
 
+//-----------------------------------------------------------------------------
+//      指定された3x4行列を用いて，ベクトルを変換します.
+//-----------------------------------------------------------------------------
+inline
+Vector3 Vector3::Transform( const Vector3& position, const Matrix34& matrix )
+{
+    return Vector3(
+        ( ((position.x * matrix._11) + (position.y * matrix._12)) + (position.z * matrix._13)) + matrix._14,
+        ( ((position.x * matrix._21) + (position.y * matrix._22)) + (position.z * matrix._23)) + matrix._24,
+        ( ((position.x * matrix._31) + (position.y * matrix._32)) + (position.z * matrix._33)) + matrix._34 );
+}
+
+//-----------------------------------------------------------------------------
+//      指定された3x4行列を用いて，ベクトルを変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::Transform( const Vector3 &position, const Matrix34 &matrix, Vector3 &result )
+{
+    auto x = ( ((position.x * matrix._11) + (position.y * matrix._12)) + (position.z * matrix._13)) + matrix._14;
+    auto y = ( ((position.x * matrix._21) + (position.y * matrix._22)) + (position.z * matrix._23)) + matrix._24;
+    auto z = ( ((position.x * matrix._31) + (position.y * matrix._32)) + (position.z * matrix._33)) + matrix._34;
+    result.x = x;
+    result.y = y;
+    result.z = z;
+}
+
+//-----------------------------------------------------------------------------
+//      指定された3x4行列を用いて，法線ベクトルを変換します.
+//-----------------------------------------------------------------------------
+inline
+Vector3 Vector3::TransformNormal( const Vector3& normal, const Matrix34& matrix )
+{
+    return Vector3(
+        ((normal.x * matrix._11) + (normal.y * matrix._12)) + (normal.z * matrix._13),
+        ((normal.x * matrix._21) + (normal.y * matrix._22)) + (normal.z * matrix._23),
+        ((normal.x * matrix._31) + (normal.y * matrix._32)) + (normal.z * matrix._33) );
+}
+
+//-----------------------------------------------------------------------------
+//      指定された3x4行列を用いて，法線ベクトルを変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformNormal( const Vector3 &normal, const Matrix34 &matrix, Vector3 &result )
+{
+    auto x = ((normal.x * matrix._11) + (normal.y * matrix._12)) + (normal.z * matrix._13);
+    auto y = ((normal.x * matrix._21) + (normal.y * matrix._22)) + (normal.z * matrix._23);
+    auto z = ((normal.x * matrix._31) + (normal.y * matrix._32)) + (normal.z * matrix._33);
+    result.x = x;
+    result.y = y;
+    result.z = z;
+}
+
 //-----------------------------------------------------------------------------
 //      指定された行列を用いてベクトルを変換し，変換結果をw=1に射影します.
 //-----------------------------------------------------------------------------
@@ -2125,6 +2255,144 @@ void Vector3::TransformCoord( const Vector3 &coords, const Matrix &matrix, Vecto
     result.z = Z / W;
 }
 
+//-----------------------------------------------------------------------------
+//      指定された行列を用いて，ベクトル配列を一括変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformArray
+(
+    const Vector3*  pInput,
+    size_t          inputStride,
+    size_t          count,
+    const Matrix&   matrix,
+    Vector3*        pOutput,
+    size_t          outputStride
+)
+{
+    assert( count == 0 || ( pInput != nullptr && pOutput != nullptr ) );
+    auto pSrc = reinterpret_cast<const uint8_t*>( pInput );
+    auto pDst = reinterpret_cast<uint8_t*>( pOutput );
+    size_t i = 0;
+
+#if defined(ASDX_ENABLE_SIMD)
+    auto m11 = _mm_set1_ps( matrix._11 ); auto m12 = _mm_set1_ps( matrix._12 ); auto m13 = _mm_set1_ps( matrix._13 );
+    auto m21 = _mm_set1_ps( matrix._21 ); auto m22 = _mm_set1_ps( matrix._22 ); auto m23 = _mm_set1_ps( matrix._23 );
+    auto m31 = _mm_set1_ps( matrix._31 ); auto m32 = _mm_set1_ps( matrix._32 ); auto m33 = _mm_set1_ps( matrix._33 );
+    auto m41 = _mm_set1_ps( matrix._41 ); auto m42 = _mm_set1_ps( matrix._42 ); auto m43 = _mm_set1_ps( matrix._43 );
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        __m128 x, y, z;
+        SimdLoadFloat3x4( pSrc + i * inputStride, inputStride, x, y, z );
+
+        auto X = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m11 ), _mm_mul_ps( y, m21 ) ), _mm_mul_ps( z, m31 ) ), m41 );
+        auto Y = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m12 ), _mm_mul_ps( y, m22 ) ), _mm_mul_ps( z, m32 ) ), m42 );
+        auto Z = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m13 ), _mm_mul_ps( y, m23 ) ), _mm_mul_ps( z, m33 ) ), m43 );
+
+        SimdStoreFloat3x4( pDst + i * outputStride, outputStride, X, Y, Z );
+    }
+#endif
+
+    for( ; i < count; ++i )
+    {
+        auto& src = *reinterpret_cast<const Vector3*>( pSrc + i * inputStride );
+        auto& dst = *reinterpret_cast<Vector3*>( pDst + i * outputStride );
+        dst = Transform( src, matrix );
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      指定された行列を用いて，法線ベクトル配列を一括変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformNormalArray
+(
+    const Vector3*  pInput,
+    size_t          inputStride,
+    size_t          count,
+    const Matrix&   matrix,
+    Vector3*        pOutput,
+    size_t          outputStride
+)
+{
+    assert( count == 0 || ( pInput != nullptr && pOutput != nullptr ) );
+    auto pSrc = reinterpret_cast<const uint8_t*>( pInput );
+    auto pDst = reinterpret_cast<uint8_t*>( pOutput );
+    size_t i = 0;
+
+#if defined(ASDX_ENABLE_SIMD)
+    auto m11 = _mm_set1_ps( matrix._11 ); auto m12 = _mm_set1_ps( matrix._12 ); auto m13 = _mm_set1_ps( matrix._13 );
+    auto m21 = _mm_set1_ps( matrix._21 ); auto m22 = _mm_set1_ps( matrix._22 ); auto m23 = _mm_set1_ps( matrix._23 );
+    auto m31 = _mm_set1_ps( matrix._31 ); auto m32 = _mm_set1_ps( matrix._32 ); auto m33 = _mm_set1_ps( matrix._33 );
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        __m128 x, y, z;
+        SimdLoadFloat3x4( pSrc + i * inputStride, inputStride, x, y, z );
+
+        auto X = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m11 ), _mm_mul_ps( y, m21 ) ), _mm_mul_ps( z, m31 ) );
+        auto Y = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m12 ), _mm_mul_ps( y, m22 ) ), _mm_mul_ps( z, m32 ) );
+        auto Z = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m13 ), _mm_mul_ps( y, m23 ) ), _mm_mul_ps( z, m33 ) );
+
+        SimdStoreFloat3x4( pDst + i * outputStride, outputStride, X, Y, Z );
+    }
+#endif
+
+    for( ; i < count; ++i )
+    {
+        auto& src = *reinterpret_cast<const Vector3*>( pSrc + i * inputStride );
+        auto& dst = *reinterpret_cast<Vector3*>( pDst + i * outputStride );
+        dst = TransformNormal( src, matrix );
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      指定された行列を用いてベクトル配列を一括変換し，変換結果をw=1に射影します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformCoordArray
+(
+    const Vector3*  pInput,
+    size_t          inputStride,
+    size_t          count,
+    const Matrix&   matrix,
+    Vector3*        pOutput,
+    size_t          outputStride
+)
+{
+    assert( count == 0 || ( pInput != nullptr && pOutput != nullptr ) );
+    auto pSrc = reinterpret_cast<const uint8_t*>( pInput );
+    auto pDst = reinterpret_cast<uint8_t*>( pOutput );
+    size_t i = 0;
+
+#if defined(ASDX_ENABLE_SIMD)
+    auto m11 = _mm_set1_ps( matrix._11 ); auto m12 = _mm_set1_ps( matrix._12 ); auto m13 = _mm_set1_ps( matrix._13 ); auto m14 = _mm_set1_ps( matrix._14 );
+    auto m21 = _mm_set1_ps( matrix._21 ); auto m22 = _mm_set1_ps( matrix._22 ); auto m23 = _mm_set1_ps( matrix._23 ); auto m24 = _mm_set1_ps( matrix._24 );
+    auto m31 = _mm_set1_ps( matrix._31 ); auto m32 = _mm_set1_ps( matrix._32 ); auto m33 = _mm_set1_ps( matrix._33 ); auto m34 = _mm_set1_ps( matrix._34 );
+    auto m41 = _mm_set1_ps( matrix._41 ); auto m42 = _mm_set1_ps( matrix._42 ); auto m43 = _mm_set1_ps( matrix._43 ); auto m44 = _mm_set1_ps( matrix._44 );
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        __m128 x, y, z;
+        SimdLoadFloat3x4( pSrc + i * inputStride, inputStride, x, y, z );
+
+        auto X = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m11 ), _mm_mul_ps( y, m21 ) ), _mm_mul_ps( z, m31 ) ), m41 );
+        auto Y = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m12 ), _mm_mul_ps( y, m22 ) ), _mm_mul_ps( z, m32 ) ), m42 );
+        auto Z = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m13 ), _mm_mul_ps( y, m23 ) ), _mm_mul_ps( z, m33 ) ), m43 );
+        auto W = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m14 ), _mm_mul_ps( y, m24 ) ), _mm_mul_ps( z, m34 ) ), m44 );
+
+        SimdStoreFloat3x4( pDst + i * outputStride, outputStride, _mm_div_ps( X, W ), _mm_div_ps( Y, W ), _mm_div_ps( Z, W ) );
+    }
+#endif
+
+    for( ; i < count; ++i )
+    {
+        auto& src = *reinterpret_cast<const Vector3*>( pSrc + i * inputStride );
+        auto& dst = *reinterpret_cast<Vector3*>( pDst + i * outputStride );
+        dst = TransformCoord( src, matrix );
+    }
+}
+
 //-----------------------------------------------------------------------------
 //      スカラー3重積を求めます.
 //-----------------------------------------------------------------------------
@@ -2247,14 +2515,14 @@ void Vector3::InverseRotate( const Vector3& value, const Quaternion& rotation, V
 //-----------------------------------------------------------------------------
 //      コンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4::Vector4()
 { /* DO_NOTHING */ }
 
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4::Vector4( const float* pf )
 {
     assert( pf != nullptr );
@@ -2267,7 +2535,7 @@ Vector4::Vector4( const float* pf )
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4::Vector4( const Vector2& value, float nz, float nw )
 : x( value.x )
 , y( value.y )
@@ -2278,7 +2546,7 @@ Vector4::Vector4( const Vector2& value, float nz, float nw )
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4::Vector4( const Vector3& value, float nw )
 : x( value.x )
 , y( value.y )
@@ -2289,7 +2557,7 @@ Vector4::Vector4( const Vector3& value, float nw )
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4::Vector4( float nx, float ny, float nz, float nw )
 : x( nx )
 , y( ny )
@@ -2314,7 +2582,7 @@ Vector4::operator const float *() const
 //-----------------------------------------------------------------------------
 //      加算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4& Vector4::operator += ( const Vector4& v )
 {
     x += v.x;
@@ -2327,7 +2595,7 @@ Vector4& Vector4::operator += ( const Vector4& v )
 //-----------------------------------------------------------------------------
 //      減算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4& Vector4::operator -= ( const Vector4& v )
 {
     x -= v.x;
@@ -2340,7 +2608,7 @@ Vector4& Vector4::operator -= ( const Vector4& v )
 //-----------------------------------------------------------------------------
 //      乗算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4& Vector4::operator *= ( float f )
 {
     x *= f;
@@ -2353,7 +2621,7 @@ Vector4& Vector4::operator *= ( float f )
 //-----------------------------------------------------------------------------
 //      除算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4& Vector4::operator /= ( float f )
 {
     assert( !IsZero( f ) );
@@ -2367,7 +2635,7 @@ Vector4& Vector4::operator /= ( float f )
 //-----------------------------------------------------------------------------
 //      代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4& Vector4::operator = ( const Vector4& value )
 {
     x = value.x;
@@ -2380,42 +2648,42 @@ Vector4& Vector4::operator = ( const Vector4& value )
 //-----------------------------------------------------------------------------
 //      正符号演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::operator + () const
 { return (*this); }
 
 //-----------------------------------------------------------------------------
 //      負符号演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::operator - () const
 { return Vector4( -x, -y, -z, -w ); }
 
 //-----------------------------------------------------------------------------
 //      加算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::operator + ( const Vector4& v ) const
 { return Vector4( x + v.x, y + v.y, z + v.z, w + v.w ); }
 
 //-----------------------------------------------------------------------------
 //      減算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::operator - ( const Vector4& v ) const
 { return Vector4( x - v.x, y - v.y, z - v.z, w - v.w ); }
 
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::operator * ( float f ) const
 { return Vector4( x * f, y * f, z * f, w * f ); }
 
 //-----------------------------------------------------------------------------
 //      除算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::operator / ( float f ) const
 {
     assert( !IsZero( f ) );
@@ -2425,26 +2693,26 @@ Vector4 Vector4::operator / ( float f ) const
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 operator * ( float f, const Vector4& v )
 { return Vector4( f * v.x, f * v.y, f * v.z, f * v.w ); }
 
 //-----------------------------------------------------------------------------
 //      等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool Vector4::operator == ( const Vector4& v ) const
 {
     return IsEqual( x, v.x )
         && IsEqual( y, v.y )
         && IsEqual( z, v.z )
-        && IsEqual( w, v.z );
+        && IsEqual( w, v.w );
 }
 
 //-----------------------------------------------------------------------------
 //      非等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool Vector4::operator != ( const Vector4& v ) const
 { 
     return !IsEqual( x, v.x )
@@ -2463,7 +2731,7 @@ float Vector4::Length() const
 //-----------------------------------------------------------------------------
 //      ベクトルの大きさの2乗値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Vector4::LengthSq() const
 { return ( x * x + y * y + z * z + w * w ); }
 
@@ -2541,7 +2809,7 @@ void Vector4::Abs( const Vector4 &value, Vector4 &result )
 //-----------------------------------------------------------------------------
 //      値を指定された範囲内に制限します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::Clamp( const Vector4& value, const Vector4& a, const Vector4& b )
 {
     return Vector4( 
@@ -2567,7 +2835,7 @@ void Vector4::Clamp( const Vector4 &value, const Vector4 &a, const Vector4 &b, V
 //-----------------------------------------------------------------------------
 //      指定された値を0～1の範囲に制限します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::Saturate( const Vector4& value )
 {
     return Vector4(
@@ -2607,7 +2875,7 @@ void Vector4::Distance( const Vector4 &a, const Vector4 &b, float &result )
 //-----------------------------------------------------------------------------
 //      2点間距離の2乗値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Vector4::DistanceSq( const Vector4& a, const Vector4& b )
 {
     auto X = b.x - a.x;
@@ -2635,14 +2903,26 @@ void Vector4::DistanceSq( const Vector4 &a, const Vector4 &b, float &result )
 //-----------------------------------------------------------------------------
 inline
 float Vector4::Dot( const Vector4& a, const Vector4& b )
-{ return ( a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w ); }
+{
+#if defined(ASDX_ENABLE_SIMD)
+    return _mm_cvtss_f32( SimdDot4( _mm_loadu_ps( &a.x ), _mm_loadu_ps( &b.x ) ) );
+#else
+    return ( a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w );
+#endif
+}
 
 //-----------------------------------------------------------------------------
 //      内積を求めます.
 //-----------------------------------------------------------------------------
 inline
 void Vector4::Dot( const Vector4 &a, const Vector4 &b, float &result )
-{ result = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+{
+#if defined(ASDX_ENABLE_SIMD)
+    result = _mm_cvtss_f32( SimdDot4( _mm_loadu_ps( &a.x ), _mm_loadu_ps( &b.x ) ) );
+#else
+    result = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+#endif
+}
 
 //-----------------------------------------------------------------------------
 //      正規化を行います.
@@ -2769,7 +3049,7 @@ void Vector4::ComputeCrossingAngle( const Vector4 &a, const Vector4 &b, float &r
 //-----------------------------------------------------------------------------
 //      各成分の最小値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::Min( const Vector4& a, const Vector4& b )
 { 
     return Vector4( 
@@ -2795,7 +3075,7 @@ void Vector4::Min( const Vector4 &a, const Vector4 &b, Vector4 &result )
 //-----------------------------------------------------------------------------
 //      各成分の最大値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::Max( const Vector4& a, const Vector4& b )
 {
     return Vector4( 
@@ -2990,7 +3270,7 @@ void Vector4::CatmullRom
 //-----------------------------------------------------------------------------
 //      線形補間を行います.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Vector4 Vector4::Lerp( const Vector4& a, const Vector4& b, float amount )
 {
     return Vector4(
@@ -3049,11 +3329,17 @@ void Vector4::SmoothStep( const Vector4 &a, const Vector4 &b, float amount, Vect
 inline
 Vector4 Vector4::Transform( const Vector4& position, const Matrix& matrix )
 {
+#if defined(ASDX_ENABLE_SIMD)
+    Vector4 result;
+    Transform( position, matrix, result );
+    return result;
+#else
     return Vector4(
         ( ( ((position.x * matrix._11) + (position.y * matrix._21)) + (position.z * matrix._31) ) + (position.w * matrix._41)),
         ( ( ((position.x * matrix._12) + (position.y * matrix._22)) + (position.z * matrix._32) ) + (position.w * matrix._42)),
         ( ( ((position.x * matrix._13) + (position.y * matrix._23)) + (position.z * matrix._33) ) + (position.w * matrix._43)),
         ( ( ((position.x * matrix._14) + (position.y * matrix._24)) + (position.z * matrix._34) ) + (position.w * matrix._44)) );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -3062,10 +3348,19 @@ Vector4 Vector4::Transform( const Vector4& position, const Matrix& matrix )
 inline
 void Vector4::Transform( const Vector4 &position, const Matrix &matrix, Vector4 &result )
 {
+#if defined(ASDX_ENABLE_SIMD)
+    _mm_storeu_ps( &result.x, SimdTransform(
+        _mm_loadu_ps( &position.x ),
+        _mm_loadu_ps( matrix.m[0] ),
+        _mm_loadu_ps( matrix.m[1] ),
+        _mm_loadu_ps( matrix.m[2] ),
+        _mm_loadu_ps( matrix.m[3] ) ) );
+#else
     result.x = ( ( ((position.x * matrix._11) + (position.y * matrix._21)) + (position.z * matrix._31) ) + (position.w * matrix._41));
     result.y = ( ( ((position.x * matrix._12) + (position.y * matrix._22)) + (position.z * matrix._32) ) + (position.w * matrix._42));
     result.z = ( ( ((position.x * matrix._13) + (position.y * matrix._23)) + (position.z * matrix._33) ) + (position.w * matrix._43));
     result.w = ( ( ((position.x * matrix._14) + (position.y * matrix._24)) + (position.z * matrix._34) ) + (position.w * matrix._44));
+#endif
 }
 
 
@@ -3083,17 +3378,18 @@ Matrix::Matrix()
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix::Matrix( const float* pf )
-{
-    assert( pf != nullptr );
-    memcpy( &_11, pf, sizeof(Matrix) );
-}
+: _11( pf[ 0] ), _12( pf[ 1] ), _13( pf[ 2] ), _14( pf[ 3] )
+, _21( pf[ 4] ), _22( pf[ 5] ), _23( pf[ 6] ), _24( pf[ 7] )
+, _31( pf[ 8] ), _32( pf[ 9] ), _33( pf[10] ), _34( pf[11] )
+, _41( pf[12] ), _42( pf[13] ), _43( pf[14] ), _44( pf[15] )
+{ assert( pf != nullptr ); }
 
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix::Matrix
 (
     float _f11, float _f12, float _f13, float _f14,
@@ -3101,24 +3397,33 @@ Matrix::Matrix
     float _f31, float _f32, float _f33, float _f34,
     float _f41, float _f42, float _f43, float _f44 
 )
-{
-    _11 = _f11; _12 = _f12; _13 = _f13; _14 = _f14;
-    _21 = _f21; _22 = _f22; _23 = _f23; _24 = _f24;
-    _31 = _f31; _32 = _f32; _33 = _f33; _34 = _f34;
-    _41 = _f41; _42 = _f42; _43 = _f43; _44 = _f44;
-}
+: _11( _f11 ), _12( _f12 ), _13( _f13 ), _14( _f14 )
+, _21( _f21 ), _22( _f22 ), _23( _f23 ), _24( _f24 )
+, _31( _f31 ), _32( _f32 ), _33( _f33 ), _34( _f34 )
+, _41( _f41 ), _42( _f42 ), _43( _f43 ), _44( _f44 )
+{ /* DO_NOTHING */ }
 
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix::Matrix( const Vector4& v1, const Vector4& v2, const Vector4& v3, const Vector4& v4 )
-{
-    _11 = v1.x; _12 = v1.y; _13 = v1.z; _14 = v1.z;
-    _21 = v2.x; _22 = v2.y; _23 = v2.z; _24 = v2.z;
-    _31 = v3.x; _32 = v3.y; _33 = v3.z; _34 = v3.z;
-    _41 = v4.x; _42 = v4.y; _43 = v4.z; _44 = v4.z;
-}
+: _11( v1.x ), _12( v1.y ), _13( v1.z ), _14( v1.w )
+, _21( v2.x ), _22( v2.y ), _23( v2.z ), _24( v2.w )
+, _31( v3.x ), _32( v3.y ), _33( v3.z ), _34( v3.w )
+, _41( v4.x ), _42( v4.y ), _43( v4.z ), _44( v4.w )
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-----------------------------------------------------------------------------
+constexpr
+Matrix::Matrix( const Matrix34& value )
+: _11( value._11 ), _12( value._21 ), _13( value._31 ), _14( 0.0f )
+, _21( value._12 ), _22( value._22 ), _23( value._32 ), _24( 0.0f )
+, _31( value._13 ), _32( value._23 ), _33( value._33 ), _34( 0.0f )
+, _41( value._14 ), _42( value._24 ), _43( value._34 ), _44( 1.0f )
+{ /* DO_NOTHING */ }
 
 //-----------------------------------------------------------------------------
 //      インデクサです.
@@ -3154,6 +3459,9 @@ Matrix::operator const float* () const
 inline 
 Matrix& Matrix::operator *= ( const Matrix &value )
 {
+#if defined(ASDX_ENABLE_SIMD)
+    Multiply( *this, value, *this );
+#else
     auto m11 = ( _11 * value._11 ) + ( _12 * value._21 ) + ( _13 * value._31 ) + ( _14 * value._41 );
     auto m12 = ( _11 * value._12 ) + ( _12 * value._22 ) + ( _13 * value._32 ) + ( _14 * value._42 );
     auto m13 = ( _11 * value._13 ) + ( _12 * value._23 ) + ( _13 * value._33 ) + ( _14 * value._43 );
@@ -3178,6 +3486,7 @@ Matrix& Matrix::operator *= ( const Matrix &value )
     _21 = m21;  _22 = m22;  _23 = m23;  _24 = m24;
     _31 = m31;  _32 = m32;  _33 = m33;  _34 = m34;
     _41 = m41;  _42 = m42;  _43 = m43;  _44 = m44;
+#endif
 
     return (*this);
 }
@@ -3185,7 +3494,7 @@ Matrix& Matrix::operator *= ( const Matrix &value )
 //-----------------------------------------------------------------------------
 //      加算代入演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix& Matrix::operator += ( const Matrix& mat )
 {
     _11 += mat._11; _12 += mat._12; _13 += mat._13; _14 += mat._14;
@@ -3198,7 +3507,7 @@ Matrix& Matrix::operator += ( const Matrix& mat )
 //-----------------------------------------------------------------------------
 //      減算代入演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix& Matrix::operator -= ( const Matrix& mat )
 {
     _11 -= mat._11; _12 -= mat._12; _13 -= mat._13; _14 -= mat._14;
@@ -3211,7 +3520,7 @@ Matrix& Matrix::operator -= ( const Matrix& mat )
 //-----------------------------------------------------------------------------
 //      乗算代入演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix& Matrix::operator *= ( float f )
 {
     _11 *= f; _12 *= f; _13 *= f; _14 *= f;
@@ -3224,7 +3533,7 @@ Matrix& Matrix::operator *= ( float f )
 //-----------------------------------------------------------------------------
 //      除算代入演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix& Matrix::operator /= ( float f )
 {
     assert( !IsZero( f ) );
@@ -3248,14 +3557,14 @@ Matrix& Matrix::operator = ( const Matrix& value )
 //-----------------------------------------------------------------------------
 //      正符号演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::operator + () const
 { return (*this); }
 
 //-----------------------------------------------------------------------------
 //      負符号演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::operator - () const
 {
     return Matrix(
@@ -3271,6 +3580,11 @@ Matrix Matrix::operator - () const
 inline 
 Matrix Matrix::operator * ( const Matrix& value ) const
 {
+#if defined(ASDX_ENABLE_SIMD)
+    Matrix result;
+    Multiply( *this, value, result );
+    return result;
+#else
     return Matrix(
         ( _11 * value._11 ) + ( _12 * value._21 ) + ( _13 * value._31 ) + ( _14 * value._41 ),
         ( _11 * value._12 ) + ( _12 * value._22 ) + ( _13 * value._32 ) + ( _14 * value._42 ),
@@ -3292,12 +3606,13 @@ Matrix Matrix::operator * ( const Matrix& value ) const
         ( _41 * value._13 ) + ( _42 * value._23 ) + ( _43 * value._33 ) + ( _44 * value._43 ),
         ( _41 * value._14 ) + ( _42 * value._24 ) + ( _43 * value._34 ) + ( _44 * value._44 )
     );
+#endif
 }
 
 //-----------------------------------------------------------------------------
 //      加算演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix Matrix::operator + ( const Matrix& mat ) const
 {
     return Matrix(
@@ -3310,7 +3625,7 @@ Matrix Matrix::operator + ( const Matrix& mat ) const
 //-----------------------------------------------------------------------------
 //      減算演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix Matrix::operator - ( const Matrix& mat ) const
 {
     return Matrix(
@@ -3323,7 +3638,7 @@ Matrix Matrix::operator - ( const Matrix& mat ) const
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::operator * ( float f ) const
 {
     return Matrix( 
@@ -3336,7 +3651,7 @@ Matrix Matrix::operator * ( float f ) const
 //-----------------------------------------------------------------------------
 //      除算演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::operator / ( float f ) const
 {
     assert( !IsZero( f ) );
@@ -3350,7 +3665,7 @@ Matrix Matrix::operator / ( float f ) const
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix operator * ( float f, const Matrix& mat )
 {
     return Matrix(
@@ -3363,14 +3678,14 @@ Matrix operator * ( float f, const Matrix& mat )
 //-----------------------------------------------------------------------------
 //      等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline 
+inline
 bool Matrix::operator == ( const Matrix& mat ) const
 { return ( 0 == memcmp( this, &mat, sizeof( Matrix ) ) ); }
 
 //-----------------------------------------------------------------------------
 //      非等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline 
+inline
 bool Matrix::operator != ( const Matrix& mat ) const
 { return ( 0 != memcmp( this, &mat, sizeof( Matrix ) ) ); }
 
@@ -3398,7 +3713,7 @@ float Matrix::Determinant() const
 //-----------------------------------------------------------------------------
 //      単位行列化します.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix& Matrix::Identity()
 {
     _11 = _22 = _33 = _44 = 1.0f;
@@ -3417,7 +3732,7 @@ Matrix& Matrix::Identity()
 //-----------------------------------------------------------------------------
 //      単位行列を生成します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::CreateIdentity()
 {
     return Matrix(
@@ -3441,9 +3756,49 @@ bool Matrix::IsIdentity( const Matrix &value )
 }
 
 //-----------------------------------------------------------------------------
-//      行列を転置します.
+//      アフィン変換行列かどうかチェックします.
 //-----------------------------------------------------------------------------
 inline
+bool Matrix::IsAffine( const Matrix& value )
+{
+    return IsZero( value._14 )
+        && IsZero( value._24 )
+        && IsZero( value._34 )
+        && IsEqual( value._44, 1.0f );
+}
+
+//-----------------------------------------------------------------------------
+//      剛体変換行列かどうかチェックします.
+//-----------------------------------------------------------------------------
+inline
+bool Matrix::IsRigid( const Matrix& value )
+{
+    if ( !IsAffine( value ) )
+    { return false; }
+
+    // 誤差の蓄積した行列も許容できるよう, 緩めの閾値で判定する.
+    const auto Tolerance = 1.0e-3f;
+
+    for( auto i=0; i<3; ++i )
+    {
+        for( auto j=i; j<3; ++j )
+        {
+            auto dot = value.m[i][0] * value.m[j][0]
+                     + value.m[i][1] * value.m[j][1]
+                     + value.m[i][2] * value.m[j][2];
+            auto expected = ( i == j ) ? 1.0f : 0.0f;
+            if ( fabs( dot - expected ) > Tolerance )
+            { return false; }
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      行列を転置します.
+//-----------------------------------------------------------------------------
+constexpr
 Matrix Matrix::Transpose( const Matrix& value )
 {
     return Matrix(
@@ -3486,6 +3841,11 @@ void Matrix::Transpose( const Matrix &value, Matrix &result )
 inline
 Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
 {
+#if defined(ASDX_ENABLE_SIMD)
+    Matrix result;
+    Multiply( a, b, result );
+    return result;
+#else
     return Matrix(
         ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 ),
         ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 ),
@@ -3507,6 +3867,7 @@ Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
         ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 ),
         ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 )
     );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -3515,6 +3876,18 @@ Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
 inline
 void Matrix::Multiply( const Matrix &a, const Matrix &b, Matrix &result )
 {
+#if defined(ASDX_ENABLE_SIMD)
+    // result が a, b と同じインスタンスでも良いように先に b を読み込んでおく.
+    auto b0 = _mm_loadu_ps( b.m[0] );
+    auto b1 = _mm_loadu_ps( b.m[1] );
+    auto b2 = _mm_loadu_ps( b.m[2] );
+    auto b3 = _mm_loadu_ps( b.m[3] );
+
+    _mm_storeu_ps( result.m[0], SimdTransform( _mm_loadu_ps( a.m[0] ), b0, b1, b2, b3 ) );
+    _mm_storeu_ps( result.m[1], SimdTransform( _mm_loadu_ps( a.m[1] ), b0, b1, b2, b3 ) );
+    _mm_storeu_ps( result.m[2], SimdTransform( _mm_loadu_ps( a.m[2] ), b0, b1, b2, b3 ) );
+    _mm_storeu_ps( result.m[3], SimdTransform( _mm_loadu_ps( a.m[3] ), b0, b1, b2, b3 ) );
+#else
     result._11 = ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 );
     result._12 = ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 );
     result._13 = ( a._11 * b._13 ) + ( a._12 * b._23 ) + ( a._13 * b._33 ) + ( a._14 * b._43 );
@@ -3534,12 +3907,13 @@ void Matrix::Multiply( const Matrix &a, const Matrix &b, Matrix &result )
     result._42 = ( a._41 * b._12 ) + ( a._42 * b._22 ) + ( a._43 * b._32 ) + ( a._44 * b._42 );
     result._43 = ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 );
     result._44 = ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 );
+#endif
 }
 
 //-----------------------------------------------------------------------------
 //      スカラー乗算します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::Multiply( const Matrix& value, float scaleFactor )
 {
     return Matrix(
@@ -3638,6 +4012,11 @@ void Matrix::MultiplyTranspose( const Matrix &a, const Matrix &b, Matrix &result
 inline 
 Matrix Matrix::Invert( const Matrix& value )
 {
+#if defined(ASDX_ENABLE_SIMD)
+    Matrix result;
+    Invert( value, result );
+    return result;
+#else
     auto det = value.Determinant();
     assert( !IsZero( det ) );
 
@@ -3666,6 +4045,7 @@ Matrix Matrix::Invert( const Matrix& value )
         m21 / det, m22 / det, m23 / det, m24 / det,
         m31 / det, m32 / det, m33 / det, m34 / det,
         m41 / det, m42 / det, m43 / det, m44 / det );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -3674,6 +4054,22 @@ Matrix Matrix::Invert( const Matrix& value )
 inline
 void Matrix::Invert( const Matrix &value, Matrix &result )
 { 
+#if defined(ASDX_ENABLE_SIMD)
+    __m128 rows[4];
+    auto det = SimdInvert(
+        _mm_loadu_ps( value.m[0] ),
+        _mm_loadu_ps( value.m[1] ),
+        _mm_loadu_ps( value.m[2] ),
+        _mm_loadu_ps( value.m[3] ),
+        rows );
+    assert( det != 0.0f );
+    (void)det;
+
+    _mm_storeu_ps( result.m[0], rows[0] );
+    _mm_storeu_ps( result.m[1], rows[1] );
+    _mm_storeu_ps( result.m[2], rows[2] );
+    _mm_storeu_ps( result.m[3], rows[3] );
+#else
     auto det = value.Determinant();
     assert( det != 0.0f );
 
@@ -3716,12 +4112,135 @@ void Matrix::Invert( const Matrix &value, Matrix &result )
     result._42 /= det;
     result._43 /= det;
     result._44 /= det;
+#endif
 }
 
 //-----------------------------------------------------------------------------
-//      拡大・縮小行列を生成します.
+//      アフィン変換行列の逆行列を求めます.
+//-----------------------------------------------------------------------------
+inline
+Matrix Matrix::InvertAffine( const Matrix& value )
+{
+    Matrix result;
+    InvertAffine( value, result );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      アフィン変換行列の逆行列を求めます.
+//-----------------------------------------------------------------------------
+inline
+void Matrix::InvertAffine( const Matrix& value, Matrix& result )
+{
+    assert( IsAffine( value ) );
+
+#if defined(ASDX_ENABLE_SIMD)
+    __m128 rows[4];
+    auto det = SimdInvertAffine(
+        _mm_loadu_ps( value.m[0] ),
+        _mm_loadu_ps( value.m[1] ),
+        _mm_loadu_ps( value.m[2] ),
+        _mm_loadu_ps( value.m[3] ),
+        rows );
+    assert( det != 0.0f );
+    (void)det;
+
+    _mm_storeu_ps( result.m[0], rows[0] );
+    _mm_storeu_ps( result.m[1], rows[1] );
+    _mm_storeu_ps( result.m[2], rows[2] );
+    _mm_storeu_ps( result.m[3], rows[3] );
+#else
+    // 左上3x3の余因子を行ベクトルの外積で求める.
+    auto c11 = value._22 * value._33 - value._23 * value._32;
+    auto c12 = value._23 * value._31 - value._21 * value._33;
+    auto c13 = value._21 * value._32 - value._22 * value._31;
+
+    auto c21 = value._32 * value._13 - value._33 * value._12;
+    auto c22 = value._33 * value._11 - value._31 * value._13;
+    auto c23 = value._31 * value._12 - value._32 * value._11;
+
+    auto c31 = value._12 * value._23 - value._13 * value._22;
+    auto c32 = value._13 * value._21 - value._11 * value._23;
+    auto c33 = value._11 * value._22 - value._12 * value._21;
+
+    auto det = value._11 * c11 + value._12 * c12 + value._13 * c13;
+    assert( det != 0.0f );
+
+    auto invDet = 1.0f / det;
+    auto m11 = c11 * invDet; auto m12 = c21 * invDet; auto m13 = c31 * invDet;
+    auto m21 = c12 * invDet; auto m22 = c22 * invDet; auto m23 = c32 * invDet;
+    auto m31 = c13 * invDet; auto m32 = c23 * invDet; auto m33 = c33 * invDet;
+
+    auto tx = value._41;
+    auto ty = value._42;
+    auto tz = value._43;
+
+    result._11 = m11;   result._12 = m12;   result._13 = m13;   result._14 = 0.0f;
+    result._21 = m21;   result._22 = m22;   result._23 = m23;   result._24 = 0.0f;
+    result._31 = m31;   result._32 = m32;   result._33 = m33;   result._34 = 0.0f;
+    result._41 = -( tx * m11 + ty * m21 + tz * m31 );
+    result._42 = -( tx * m12 + ty * m22 + tz * m32 );
+    result._43 = -( tx * m13 + ty * m23 + tz * m33 );
+    result._44 = 1.0f;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      剛体変換行列の逆行列を求めます.
+//-----------------------------------------------------------------------------
+inline
+Matrix Matrix::InvertRigid( const Matrix& value )
+{
+    Matrix result;
+    InvertRigid( value, result );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      剛体変換行列の逆行列を求めます.
 //-----------------------------------------------------------------------------
 inline
+void Matrix::InvertRigid( const Matrix& value, Matrix& result )
+{
+    assert( IsRigid( value ) );
+
+#if defined(ASDX_ENABLE_SIMD)
+    __m128 rows[4];
+    SimdInvertRigid(
+        _mm_loadu_ps( value.m[0] ),
+        _mm_loadu_ps( value.m[1] ),
+        _mm_loadu_ps( value.m[2] ),
+        _mm_loadu_ps( value.m[3] ),
+        rows );
+
+    _mm_storeu_ps( result.m[0], rows[0] );
+    _mm_storeu_ps( result.m[1], rows[1] );
+    _mm_storeu_ps( result.m[2], rows[2] );
+    _mm_storeu_ps( result.m[3], rows[3] );
+#else
+    // 正規直交なので左上3x3は転置で求まる.
+    auto m11 = value._11; auto m12 = value._21; auto m13 = value._31;
+    auto m21 = value._12; auto m22 = value._22; auto m23 = value._32;
+    auto m31 = value._13; auto m32 = value._23; auto m33 = value._33;
+
+    auto tx = value._41;
+    auto ty = value._42;
+    auto tz = value._43;
+
+    result._11 = m11;   result._12 = m12;   result._13 = m13;   result._14 = 0.0f;
+    result._21 = m21;   result._22 = m22;   result._23 = m23;   result._24 = 0.0f;
+    result._31 = m31;   result._32 = m32;   result._33 = m33;   result._34 = 0.0f;
+    result._41 = -( tx * m11 + ty * m21 + tz * m31 );
+    result._42 = -( tx * m12 + ty * m22 + tz * m32 );
+    result._43 = -( tx * m13 + ty * m23 + tz * m33 );
+    result._44 = 1.0f;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      拡大・縮小行列を生成します.
+//-----------------------------------------------------------------------------
+constexpr
 Matrix Matrix::CreateScale( float scale )
 {
     return Matrix(
@@ -3746,7 +4265,7 @@ void Matrix::CreateScale( float scale, Matrix &result )
 //-----------------------------------------------------------------------------
 //      拡大・縮小行列を生成します.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix Matrix::CreateScale( float xScale, float yScale, float zScale )
 {
     return Matrix(
@@ -3771,7 +4290,7 @@ void Matrix::CreateScale( float xScale, float yScale, float zScale, Matrix &resu
 //-----------------------------------------------------------------------------
 //      拡大・縮小行列を生成します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::CreateScale( const Vector3& scales )
 {
     return Matrix(
@@ -3796,7 +4315,7 @@ void Matrix::CreateScale( const Vector3 &scales, Matrix &result )
 //-----------------------------------------------------------------------------
 //      平行移動行列を生成します.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Matrix Matrix::CreateTranslation( float xPos, float yPos, float zPos )
 {
     return Matrix(
@@ -3821,7 +4340,7 @@ void Matrix::CreateTranslation( float xPos, float yPos, float zPos, Matrix &resu
 //-----------------------------------------------------------------------------
 //      平行移動行列を生成します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::CreateTranslation( const Vector3& pos )
 {
     return Matrix(
@@ -4838,7 +5357,7 @@ void Matrix::CreateOrthographicOffCenterReverseZ
 //-----------------------------------------------------------------------------
 //      2つの行列を線形補間します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Matrix Matrix::Lerp( const Matrix& a, const Matrix& b, float amount )
 {
     return Matrix(
@@ -5019,6 +5538,298 @@ Matrix Matrix::AppendScale(Matrix& mat, const Vector3& vec)
     return mat;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Matrix34
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+inline
+Matrix34::Matrix34()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-----------------------------------------------------------------------------
+inline
+Matrix34::Matrix34( const float* pf )
+{
+    assert( pf != nullptr );
+    memcpy( m, pf, sizeof( float ) * 12 );
+}
+
+//-----------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-----------------------------------------------------------------------------
+constexpr
+Matrix34::Matrix34
+(
+    float _f11, float _f12, float _f13, float _f14,
+    float _f21, float _f22, float _f23, float _f24,
+    float _f31, float _f32, float _f33, float _f34
+)
+: _11( _f11 ), _12( _f12 ), _13( _f13 ), _14( _f14 )
+, _21( _f21 ), _22( _f22 ), _23( _f23 ), _24( _f24 )
+, _31( _f31 ), _32( _f32 ), _33( _f33 ), _34( _f34 )
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-----------------------------------------------------------------------------
+inline
+Matrix34::Matrix34( const Matrix& value )
+: _11( value._11 ), _12( value._21 ), _13( value._31 ), _14( value._41 )
+, _21( value._12 ), _22( value._22 ), _23( value._32 ), _24( value._42 )
+, _31( value._13 ), _32( value._23 ), _33( value._33 ), _34( value._43 )
+{ assert( Matrix::IsAffine( value ) ); }
+
+//-----------------------------------------------------------------------------
+//      float*型へのキャストです.
+//-----------------------------------------------------------------------------
+inline
+Matrix34::operator float* ()
+{ return static_cast<float*>( &_11 ); }
+
+//-----------------------------------------------------------------------------
+//      const float*型へのキャストです.
+//-----------------------------------------------------------------------------
+inline
+Matrix34::operator const float* () const
+{ return static_cast<const float*>( &_11 ); }
+
+//-----------------------------------------------------------------------------
+//      代入演算子です.
+//-----------------------------------------------------------------------------
+inline
+Matrix34& Matrix34::operator = ( const Matrix34& value )
+{
+    memcpy( &_11, &value._11, sizeof(Matrix34) );
+    return (*this);
+}
+
+//-----------------------------------------------------------------------------
+//      乗算代入演算子です.
+//-----------------------------------------------------------------------------
+inline
+Matrix34& Matrix34::operator *= ( const Matrix34& value )
+{
+    Multiply( *this, value, *this );
+    return (*this);
+}
+
+//-----------------------------------------------------------------------------
+//      乗算演算子です.
+//-----------------------------------------------------------------------------
+inline
+Matrix34 Matrix34::operator * ( const Matrix34& value ) const
+{
+    Matrix34 result;
+    Multiply( *this, value, result );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      等価比較演算子です.
+//-----------------------------------------------------------------------------
+inline
+bool Matrix34::operator == ( const Matrix34& value ) const
+{ return ( 0 == memcmp( this, &value, sizeof( Matrix34 ) ) ); }
+
+//-----------------------------------------------------------------------------
+//      非等価比較演算子です.
+//-----------------------------------------------------------------------------
+inline
+bool Matrix34::operator != ( const Matrix34& value ) const
+{ return ( 0 != memcmp( this, &value, sizeof( Matrix34 ) ) ); }
+
+//-----------------------------------------------------------------------------
+//      単位行列化します.
+//-----------------------------------------------------------------------------
+inline
+Matrix34& Matrix34::Identity()
+{
+    _11 = _22 = _33 = 1.0f;
+    _12 = _13 = _14 =
+    _21 = _23 = _24 =
+    _31 = _32 = _34 = 0.0f;
+    return (*this);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Matrix34 Methods
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      単位行列を生成します.
+//-----------------------------------------------------------------------------
+constexpr
+Matrix34 Matrix34::CreateIdentity()
+{
+    return Matrix34(
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f );
+}
+
+//-----------------------------------------------------------------------------
+//      変換を連結します.
+//-----------------------------------------------------------------------------
+inline
+Matrix34 Matrix34::Multiply( const Matrix34& a, const Matrix34& b )
+{
+    Matrix34 result;
+    Multiply( a, b, result );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      変換を連結します.
+//-----------------------------------------------------------------------------
+inline
+void Matrix34::Multiply( const Matrix34& a, const Matrix34& b, Matrix34& result )
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto a0 = _mm_loadu_ps( a.m[0] );
+    auto a1 = _mm_loadu_ps( a.m[1] );
+    auto a2 = _mm_loadu_ps( a.m[2] );
+    auto b0 = _mm_loadu_ps( b.m[0] );
+    auto b1 = _mm_loadu_ps( b.m[1] );
+    auto b2 = _mm_loadu_ps( b.m[2] );
+
+    _mm_storeu_ps( result.m[0], SimdConcat3x4( a0, a1, a2, b0 ) );
+    _mm_storeu_ps( result.m[1], SimdConcat3x4( a0, a1, a2, b1 ) );
+    _mm_storeu_ps( result.m[2], SimdConcat3x4( a0, a1, a2, b2 ) );
+#else
+    // 列ベクトル形式なので b * a の順に掛ける.
+    auto m11 = ((b._11 * a._11) + (b._12 * a._21)) + (b._13 * a._31);
+    auto m12 = ((b._11 * a._12) + (b._12 * a._22)) + (b._13 * a._32);
+    auto m13 = ((b._11 * a._13) + (b._12 * a._23)) + (b._13 * a._33);
+    auto m14 = (((b._11 * a._14) + (b._12 * a._24)) + (b._13 * a._34)) + b._14;
+
+    auto m21 = ((b._21 * a._11) + (b._22 * a._21)) + (b._23 * a._31);
+    auto m22 = ((b._21 * a._12) + (b._22 * a._22)) + (b._23 * a._32);
+    auto m23 = ((b._21 * a._13) + (b._22 * a._23)) + (b._23 * a._33);
+    auto m24 = (((b._21 * a._14) + (b._22 * a._24)) + (b._23 * a._34)) + b._24;
+
+    auto m31 = ((b._31 * a._11) + (b._32 * a._21)) + (b._33 * a._31);
+    auto m32 = ((b._31 * a._12) + (b._32 * a._22)) + (b._33 * a._32);
+    auto m33 = ((b._31 * a._13) + (b._32 * a._23)) + (b._33 * a._33);
+    auto m34 = (((b._31 * a._14) + (b._32 * a._24)) + (b._33 * a._34)) + b._34;
+
+    result._11 = m11;   result._12 = m12;   result._13 = m13;   result._14 = m14;
+    result._21 = m21;   result._22 = m22;   result._23 = m23;   result._24 = m24;
+    result._31 = m31;   result._32 = m32;   result._33 = m33;   result._34 = m34;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      逆行列を求めます.
+//-----------------------------------------------------------------------------
+inline
+Matrix34 Matrix34::Invert( const Matrix34& value )
+{
+    Matrix34 result;
+    Invert( value, result );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      逆行列を求めます.
+//-----------------------------------------------------------------------------
+inline
+void Matrix34::Invert( const Matrix34& value, Matrix34& result )
+{
+#if defined(ASDX_ENABLE_SIMD)
+    __m128 rows[3];
+    auto det = SimdInvertAffine3x4(
+        _mm_loadu_ps( value.m[0] ),
+        _mm_loadu_ps( value.m[1] ),
+        _mm_loadu_ps( value.m[2] ),
+        rows );
+    assert( det != 0.0f );
+    (void)det;
+
+    _mm_storeu_ps( result.m[0], rows[0] );
+    _mm_storeu_ps( result.m[1], rows[1] );
+    _mm_storeu_ps( result.m[2], rows[2] );
+#else
+    // 列ベクトル形式なので, 行ベクトルの外積がそのまま逆行列の列になる.
+    auto c11 = value._22 * value._33 - value._23 * value._32;
+    auto c12 = value._23 * value._31 - value._21 * value._33;
+    auto c13 = value._21 * value._32 - value._22 * value._31;
+
+    auto c21 = value._32 * value._13 - value._33 * value._12;
+    auto c22 = value._33 * value._11 - value._31 * value._13;
+    auto c23 = value._31 * value._12 - value._32 * value._11;
+
+    auto c31 = value._12 * value._23 - value._13 * value._22;
+    auto c32 = value._13 * value._21 - value._11 * value._23;
+    auto c33 = value._11 * value._22 - value._12 * value._21;
+
+    auto det = value._11 * c11 + value._12 * c12 + value._13 * c13;
+    assert( det != 0.0f );
+
+    auto invDet = 1.0f / det;
+    auto m11 = c11 * invDet; auto m12 = c21 * invDet; auto m13 = c31 * invDet;
+    auto m21 = c12 * invDet; auto m22 = c22 * invDet; auto m23 = c32 * invDet;
+    auto m31 = c13 * invDet; auto m32 = c23 * invDet; auto m33 = c33 * invDet;
+
+    auto tx = value._14;
+    auto ty = value._24;
+    auto tz = value._34;
+
+    result._11 = m11;   result._12 = m12;   result._13 = m13;   result._14 = -( tx * m11 + ty * m12 + tz * m13 );
+    result._21 = m21;   result._22 = m22;   result._23 = m23;   result._24 = -( tx * m21 + ty * m22 + tz * m23 );
+    result._31 = m31;   result._32 = m32;   result._33 = m33;   result._34 = -( tx * m31 + ty * m32 + tz * m33 );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      剛体変換行列の逆行列を求めます.
+//-----------------------------------------------------------------------------
+inline
+Matrix34 Matrix34::InvertRigid( const Matrix34& value )
+{
+    Matrix34 result;
+    InvertRigid( value, result );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      剛体変換行列の逆行列を求めます.
+//-----------------------------------------------------------------------------
+inline
+void Matrix34::InvertRigid( const Matrix34& value, Matrix34& result )
+{
+#if defined(ASDX_ENABLE_SIMD)
+    __m128 rows[3];
+    SimdInvertRigid3x4(
+        _mm_loadu_ps( value.m[0] ),
+        _mm_loadu_ps( value.m[1] ),
+        _mm_loadu_ps( value.m[2] ),
+        rows );
+
+    _mm_storeu_ps( result.m[0], rows[0] );
+    _mm_storeu_ps( result.m[1], rows[1] );
+    _mm_storeu_ps( result.m[2], rows[2] );
+#else
+    // 正規直交なので左上3x3は転置で求まる.
+    auto m11 = value._11; auto m12 = value._21; auto m13 = value._31;
+    auto m21 = value._12; auto m22 = value._22; auto m23 = value._32;
+    auto m31 = value._13; auto m32 = value._23; auto m33 = value._33;
+
+    auto tx = value._14;
+    auto ty = value._24;
+    auto tz = value._34;
+
+    result._11 = m11;   result._12 = m12;   result._13 = m13;   result._14 = -( tx * m11 + ty * m12 + tz * m13 );
+    result._21 = m21;   result._22 = m22;   result._23 = m23;   result._24 = -( tx * m21 + ty * m22 + tz * m23 );
+    result._31 = m31;   result._32 = m32;   result._33 = m33;   result._34 = -( tx * m31 + ty * m32 + tz * m33 );
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Quaternion
 ///////////////////////////////////////////////////////////////////////////////
@@ -5033,7 +5844,7 @@ Quaternion::Quaternion()
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Quaternion::Quaternion( const float* pf )
 {
     assert( pf != nullptr );
@@ -5046,7 +5857,7 @@ Quaternion::Quaternion( const float* pf )
 //-----------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Quaternion::Quaternion( float nx, float ny, float nz, float nw )
 : x( nx )
 , y( ny )
@@ -5071,7 +5882,7 @@ Quaternion::operator const float* () const
 //-----------------------------------------------------------------------------
 //      加算代入演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion& Quaternion::operator += ( const Quaternion& q )
 {
     x += q.x;
@@ -5084,7 +5895,7 @@ Quaternion& Quaternion::operator += ( const Quaternion& q )
 //-----------------------------------------------------------------------------
 //      減算代入演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion& Quaternion::operator -= ( const Quaternion& q )
 {
     x -= q.x;
@@ -5100,21 +5911,25 @@ Quaternion& Quaternion::operator -= ( const Quaternion& q )
 inline
 Quaternion& Quaternion::operator *= ( const Quaternion& q )
 {
+#if defined(ASDX_ENABLE_SIMD)
+    _mm_storeu_ps( &x, SimdQuaternionMultiply( _mm_loadu_ps( &x ), _mm_loadu_ps( &q.x ) ) );
+#else
     auto X = ( q.x * w ) + ( x * q.w ) + ( q.y * z ) - ( q.z * y );
     auto Y = ( q.y * w ) + ( y * q.w ) + ( q.z * x ) - ( q.x * z );
     auto Z = ( q.z * w ) + ( z * q.w ) + ( q.x * y ) - ( q.y * x );
-    auto W = ( q.w * w ) - ( q.x * x ) - ( q.y * y ) + ( q.z * z );
+    auto W = ( q.w * w ) - ( q.x * x ) - ( q.y * y ) - ( q.z * z );
     x = X;
     y = Y;
     z = Z;
     w = W;
+#endif
     return (*this);
 }
 
 //-----------------------------------------------------------------------------
 //      乗算代入演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion& Quaternion::operator *= ( float f )
 {
     x *= f;
@@ -5127,7 +5942,7 @@ Quaternion& Quaternion::operator *= ( float f )
 //-----------------------------------------------------------------------------
 //      除算代入演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion& Quaternion::operator /= ( float f )
 {
     assert( !IsZero( f ) );
@@ -5141,30 +5956,30 @@ Quaternion& Quaternion::operator /= ( float f )
 //-----------------------------------------------------------------------------
 //      正符号演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion Quaternion::operator + () const
 { return (*this); }
 
 //-----------------------------------------------------------------------------
 //      負符号演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion Quaternion::operator - () const
 { return Quaternion( -x, -y, -z, -w ); }
 
 //-----------------------------------------------------------------------------
 //      加算演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion Quaternion::operator + ( const Quaternion& q ) const
-{ return Quaternion( x + q.x, y + q.y, z + q.z, w + q.z ); }
+{ return Quaternion( x + q.x, y + q.y, z + q.z, w + q.w ); }
 
 //-----------------------------------------------------------------------------
 //      減算演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion Quaternion::operator - ( const Quaternion& q ) const
-{ return Quaternion( x - q.x, y - q.y, z - q.z, w - q.z ); }
+{ return Quaternion( x - q.x, y - q.y, z - q.z, w - q.w ); }
 
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
@@ -5172,25 +5987,31 @@ Quaternion Quaternion::operator - ( const Quaternion& q ) const
 inline 
 Quaternion Quaternion::operator * ( const Quaternion& q ) const
 { 
+#if defined(ASDX_ENABLE_SIMD)
+    Quaternion result;
+    _mm_storeu_ps( &result.x, SimdQuaternionMultiply( _mm_loadu_ps( &x ), _mm_loadu_ps( &q.x ) ) );
+    return result;
+#else
     return Quaternion(
         ( q.x * w ) + ( x * q.w ) + ( q.y * z ) - ( q.z * y ),
         ( q.y * w ) + ( y * q.w ) + ( q.z * x ) - ( q.x * z ),
         ( q.z * w ) + ( z * q.w ) + ( q.x * y ) - ( q.y * x ),
-        ( q.w * w ) - ( q.x * x ) - ( q.y * y ) + ( q.z * z )
+        ( q.w * w ) - ( q.x * x ) - ( q.y * y ) - ( q.z * z )
    );
+#endif
 }
 
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion Quaternion::operator * ( float f ) const
 { return Quaternion( x * f, y * f, z * f, w *f ); }
 
 //-----------------------------------------------------------------------------
 //      除算演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion Quaternion::operator / ( float f ) const
 { 
     assert( !IsZero( f ) );
@@ -5200,14 +6021,14 @@ Quaternion Quaternion::operator / ( float f ) const
 //-----------------------------------------------------------------------------
 //      乗算演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 Quaternion operator * ( float f, const Quaternion& q )
 { return Quaternion( f * q.x, f * q.y, f * q.z, f * q.w ); }
 
 //-----------------------------------------------------------------------------
 //      等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline 
+constexpr
 bool Quaternion::operator == ( const Quaternion& q ) const
 { 
     return IsEqual( x, q.x )
@@ -5219,7 +6040,7 @@ bool Quaternion::operator == ( const Quaternion& q ) const
 //-----------------------------------------------------------------------------
 //      非等価比較演算子です.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 bool Quaternion::operator != ( const Quaternion& q ) const
 { 
     return !IsEqual( x, q.x )
@@ -5238,7 +6059,7 @@ float Quaternion::Length() const
 //-----------------------------------------------------------------------------
 //      四元数の大きさの2乗値を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Quaternion::LengthSq() const
 { return ( x * x + y * y + z * z + w * w ); }
 
@@ -5284,7 +6105,7 @@ Quaternion& Quaternion::SafeNormalize( const Quaternion& set )
 //-----------------------------------------------------------------------------
 //      単位四元数化します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Quaternion& Quaternion::Identity()
 {
     x = 0.0f;
@@ -5301,7 +6122,7 @@ Quaternion& Quaternion::Identity()
 //-----------------------------------------------------------------------------
 //      単位四元数を生成します.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Quaternion Quaternion::CreateIdentity()
 { return Quaternion( 0.0f, 0.0f, 0.0f, 1.0f ); }
 
@@ -5332,12 +6153,18 @@ bool Quaternion::IsNormalized( const Quaternion& value )
 inline
 Quaternion Quaternion::Multiply( const Quaternion& a, const Quaternion& b )
 {
+#if defined(ASDX_ENABLE_SIMD)
+    Quaternion result;
+    _mm_storeu_ps( &result.x, SimdQuaternionMultiply( _mm_loadu_ps( &a.x ), _mm_loadu_ps( &b.x ) ) );
+    return result;
+#else
     return Quaternion(
         ( b.x * a.w ) + ( a.x * b.w ) + ( b.y * a.z ) - ( b.z * a.y ),
         ( b.y * a.w ) + ( a.y * b.w ) + ( b.z * a.x ) - ( b.x * a.z ),
         ( b.z * a.w ) + ( a.z * b.w ) + ( b.x * a.y ) - ( b.y * a.x ),
-        ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) + ( b.z * a.z )
+        ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) - ( b.z * a.z )
    );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -5346,16 +6173,24 @@ Quaternion Quaternion::Multiply( const Quaternion& a, const Quaternion& b )
 inline
 void Quaternion::Multiply( const Quaternion& a, const Quaternion& b, Quaternion& result )
 {
-    result.x = ( b.x * a.w ) + ( a.x * b.w ) + ( b.y * a.z ) - ( b.z * a.y );
-    result.y = ( b.y * a.w ) + ( a.y * b.w ) + ( b.z * a.x ) - ( b.x * a.z );
-    result.z = ( b.z * a.w ) + ( a.z * b.w ) + ( b.x * a.y ) - ( b.y * a.x );
-    result.w = ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) + ( b.z * a.z );
+#if defined(ASDX_ENABLE_SIMD)
+    _mm_storeu_ps( &result.x, SimdQuaternionMultiply( _mm_loadu_ps( &a.x ), _mm_loadu_ps( &b.x ) ) );
+#else
+    auto X = ( b.x * a.w ) + ( a.x * b.w ) + ( b.y * a.z ) - ( b.z * a.y );
+    auto Y = ( b.y * a.w ) + ( a.y * b.w ) + ( b.z * a.x ) - ( b.x * a.z );
+    auto Z = ( b.z * a.w ) + ( a.z * b.w ) + ( b.x * a.y ) - ( b.y * a.x );
+    auto W = ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) - ( b.z * a.z );
+    result.x = X;
+    result.y = Y;
+    result.z = Z;
+    result.w = W;
+#endif
 }
 
 //-----------------------------------------------------------------------------
 //      内積を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 float Quaternion::Dot( const Quaternion& a, const Quaternion& b )
 { return ( a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w ); }
 
@@ -5369,7 +6204,7 @@ void Quaternion::Dot( const Quaternion &a, const Quaternion &b, float &result )
 //-----------------------------------------------------------------------------
 //      共役な四元数を求めます.
 //-----------------------------------------------------------------------------
-inline
+constexpr
 Quaternion Quaternion::Conjugate( const Quaternion& value )
 { return Quaternion( -value.x, -value.y, -value.z, value.w ); }
 
@@ -5822,6 +6657,51 @@ void Quaternion::Slerp
     result.w = scale0 * a.w + scale1 * temp.w;
 }
 
+//-----------------------------------------------------------------------------
+//      正規化線形補間を行います.
+//-----------------------------------------------------------------------------
+inline
+Quaternion Quaternion::Nlerp
+(
+    const Quaternion&   a,
+    const Quaternion&   b,
+    const float         amount
+)
+{
+    Quaternion result;
+    Nlerp( a, b, amount, result );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      正規化線形補間を行います.
+//-----------------------------------------------------------------------------
+inline
+void Quaternion::Nlerp
+(
+    const Quaternion&   a,
+    const Quaternion&   b,
+    const float         amount,
+    Quaternion&         result
+)
+{
+    // 最短経路で補間する.
+    auto temp = ( Quaternion::Dot( a, b ) < 0.0f ) ? -b : b;
+
+    auto x = a.x + ( temp.x - a.x ) * amount;
+    auto y = a.y + ( temp.y - a.y ) * amount;
+    auto z = a.z + ( temp.z - a.z ) * amount;
+    auto w = a.w + ( temp.w - a.w ) * amount;
+
+    auto mag = sqrtf( x * x + y * y + z * z + w * w );
+    assert( mag > 0.0f );
+
+    result.x = x / mag;
+    result.y = y / mag;
+    result.z = z / mag;
+    result.w = w / mag;
+}
+
 //-----------------------------------------------------------------------------
 //      球面四角形補間を行います.
 //-----------------------------------------------------------------------------
@@ -6007,10 +6887,57 @@ double XorShift::GetAsF64( double a, double b )
 {
     auto x = GetAsF64();
     x *= ( b - a );
-    x *= a;
+    x += a;
     return x;
 }
 
+//-----------------------------------------------------------------------------
+//      乱数生成を 2^64 回分読み飛ばします.
+//-----------------------------------------------------------------------------
+inline
+void XorShift::Jump()
+{
+    // x^(2^64) mod (特性多項式) の係数.
+    static const uint32_t kJump[4] = { 0x35aac71c, 0x821e5343, 0xf52e65c4, 0xd8cd644e };
+
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t z = 0;
+    uint32_t w = 0;
+
+    for(auto i=0; i<4; ++i)
+    {
+        for(auto b=0; b<32; ++b)
+        {
+            if (kJump[i] & (1u << b))
+            {
+                x ^= m_X;
+                y ^= m_Y;
+                z ^= m_Z;
+                w ^= m_W;
+            }
+            GetAsU32();
+        }
+    }
+
+    m_X = x;
+    m_Y = y;
+    m_Z = z;
+    m_W = w;
+}
+
+//-----------------------------------------------------------------------------
+//      独立した乱数系列を生成します.
+//-----------------------------------------------------------------------------
+inline
+XorShift XorShift::CreateStream( int seed, uint32_t streamIndex )
+{
+    XorShift result( seed );
+    for(auto i=0u; i<streamIndex; ++i)
+    { result.Jump(); }
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 //      代入演算子です.
 //-----------------------------------------------------------------------------
@@ -6179,10 +7106,50 @@ double PCG::GetAsF64( double a, double b )
 {
     auto x = GetAsF64();
     x *= ( b - a );
-    x *= a;
+    x += a;
     return x;
 }
 
+//-----------------------------------------------------------------------------
+//      乱数生成を指定回数分読み飛ばします.
+//-----------------------------------------------------------------------------
+inline
+void PCG::Advance( uint64_t delta )
+{
+    // F. Brown, "Random Number Generation with Arbitrary Stride",
+    // Transactions of the American Nuclear Society, 1994.
+    uint64_t curMult = s_Multiplier;
+    uint64_t curPlus = s_Increment;
+    uint64_t accMult = 1u;
+    uint64_t accPlus = 0u;
+
+    while(delta > 0)
+    {
+        if (delta & 1u)
+        {
+            accMult *= curMult;
+            accPlus  = accPlus * curMult + curPlus;
+        }
+        curPlus = (curMult + 1u) * curPlus;
+        curMult *= curMult;
+        delta >>= 1u;
+    }
+
+    m_State = accMult * m_State + accPlus;
+}
+
+//-----------------------------------------------------------------------------
+//      独立した乱数系列を生成します.
+//-----------------------------------------------------------------------------
+inline
+PCG PCG::CreateStream( uint64_t seed, uint32_t streamIndex )
+{
+    assert(streamIndex < 65536u);
+    PCG result( seed );
+    result.Advance( uint64_t(streamIndex) << 48u );
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 //      代入演算子です.
 //-----------------------------------------------------------------------------
@@ -6215,6 +7182,206 @@ uint32_t PCG::Rotate(uint32_t x, uint32_t r)
 { return x >> r | x << ((~r + 1u) & 31); }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// XorShiftX4 class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+inline
+XorShiftX4::XorShiftX4( int seed, uint32_t streamIndex )
+{
+    // 先頭レーンから順に Jump() を積み重ねて系列を作る.
+    auto stream = XorShift::CreateStream( seed, streamIndex * 4 );
+    for(auto i=0; i<4; ++i)
+    {
+        m_X[i] = stream.m_X;
+        m_Y[i] = stream.m_Y;
+        m_Z[i] = stream.m_Z;
+        m_W[i] = stream.m_W;
+        stream.Jump();
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      4レーン分の乱数を生成して出力します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+inline
+void XorShiftX4::Fill( size_t count, Func func )
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_X));
+    auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_Y));
+    auto z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_Z));
+    auto w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_W));
+
+    for(size_t i=0; i<count; i+=4)
+    {
+        auto t = _mm_xor_si128(x, _mm_slli_epi32(x, 11));
+        x = y;
+        y = z;
+        z = w;
+        w = _mm_xor_si128(
+                _mm_xor_si128(w, _mm_srli_epi32(w, 19)),
+                _mm_xor_si128(t, _mm_srli_epi32(t, 8)));
+
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), w);
+        func(i, lanes);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(m_X), x);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(m_Y), y);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(m_Z), z);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(m_W), w);
+#else
+    for(size_t i=0; i<count; i+=4)
+    {
+        uint32_t lanes[4];
+        for(auto k=0; k<4; ++k)
+        {
+            auto t = m_X[k] ^ ( m_X[k] << 11 );
+            m_X[k] = m_Y[k];
+            m_Y[k] = m_Z[k];
+            m_Z[k] = m_W[k];
+            m_W[k] = ( m_W[k] ^ ( m_W[k] >> 19 ) ) ^ ( t ^ ( t >> 8 ) );
+            lanes[k] = m_W[k];
+        }
+        func(i, lanes);
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+}
+
+//-----------------------------------------------------------------------------
+//      乱数をuint32_t型として一括生成します.
+//-----------------------------------------------------------------------------
+inline
+void XorShiftX4::FillU32( uint32_t* pResult, size_t count )
+{
+    Fill(count, [&](size_t i, const uint32_t* lanes)
+    {
+        auto n = (count - i < 4) ? count - i : 4;
+        for(size_t k=0; k<n; ++k)
+        { pResult[i + k] = lanes[k]; }
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      乱数をfloat型として一括生成します.
+//-----------------------------------------------------------------------------
+inline
+void XorShiftX4::FillF32( float* pResult, size_t count )
+{ FillF32( pResult, count, 0.0f, 1.0f ); }
+
+//-----------------------------------------------------------------------------
+//      指定された値範囲の乱数をfloat型として一括生成します.
+//-----------------------------------------------------------------------------
+inline
+void XorShiftX4::FillF32( float* pResult, size_t count, float a, float b )
+{
+    auto scale = b - a;
+    Fill(count, [&](size_t i, const uint32_t* lanes)
+    {
+        auto n = (count - i < 4) ? count - i : 4;
+        for(size_t k=0; k<n; ++k)
+        { pResult[i + k] = a + float(lanes[k] >> 8) * (1.0f / 16777216.0f) * scale; }
+    });
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PCGX4 class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+inline
+PCGX4::PCGX4( uint64_t seed, uint32_t streamIndex )
+{
+    assert(streamIndex < 16384u);
+    for(auto i=0u; i<4; ++i)
+    { m_State[i] = PCG::CreateStream( seed, streamIndex * 4 + i ).m_State; }
+}
+
+//-----------------------------------------------------------------------------
+//      4レーン分の乱数を生成して出力します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+inline
+void PCGX4::Fill( size_t count, Func func )
+{
+    // SSE2 には64bit乗算と可変量のビット回転が無いため, 4レーンを独立に進めて
+    // 命令レベルの並列性で処理します.
+    auto s0 = m_State[0];
+    auto s1 = m_State[1];
+    auto s2 = m_State[2];
+    auto s3 = m_State[3];
+
+    for(size_t i=0; i<count; i+=4)
+    {
+        uint32_t lanes[4];
+        uint64_t x[4] = { s0, s1, s2, s3 };
+
+        s0 = s0 * PCG::s_Multiplier + PCG::s_Increment;
+        s1 = s1 * PCG::s_Multiplier + PCG::s_Increment;
+        s2 = s2 * PCG::s_Multiplier + PCG::s_Increment;
+        s3 = s3 * PCG::s_Multiplier + PCG::s_Increment;
+
+        for(auto k=0; k<4; ++k)
+        {
+            auto r = uint32_t(x[k] >> 59);
+            x[k] ^= x[k] >> 18;
+            lanes[k] = PCG::Rotate(uint32_t(x[k] >> 27), r);
+        }
+        func(i, lanes);
+    }
+
+    m_State[0] = s0;
+    m_State[1] = s1;
+    m_State[2] = s2;
+    m_State[3] = s3;
+}
+
+//-----------------------------------------------------------------------------
+//      乱数をuint32_t型として一括生成します.
+//-----------------------------------------------------------------------------
+inline
+void PCGX4::FillU32( uint32_t* pResult, size_t count )
+{
+    Fill(count, [&](size_t i, const uint32_t* lanes)
+    {
+        auto n = (count - i < 4) ? count - i : 4;
+        for(size_t k=0; k<n; ++k)
+        { pResult[i + k] = lanes[k]; }
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      乱数をfloat型として一括生成します.
+//-----------------------------------------------------------------------------
+inline
+void PCGX4::FillF32( float* pResult, size_t count )
+{ FillF32( pResult, count, 0.0f, 1.0f ); }
+
+//-----------------------------------------------------------------------------
+//      指定された値範囲の乱数をfloat型として一括生成します.
+//-----------------------------------------------------------------------------
+inline
+void PCGX4::FillF32( float* pResult, size_t count, float a, float b )
+{
+    auto scale = b - a;
+    Fill(count, [&](size_t i, const uint32_t* lanes)
+    {
+        auto n = (count - i < 4) ? count - i : 4;
+        for(size_t k=0; k<n; ++k)
+        { pResult[i + k] = a + float(lanes[k] >> 8) * (1.0f / 16777216.0f) * scale; }
+    });
+}
+
+
 //-----------------------------------------------------------------------------
 //      正規直交基底を求めます.
 //-----------------------------------------------------------------------------
@@ -6245,6 +7412,92 @@ Vector2 Hammersley( uint32_t i, uint32_t numSamples )
     return Vector2( float(i)/float(numSamples), result );
 }
 
+//-----------------------------------------------------------------------------
+//      Hammersley点集合のテーブルを生成します.
+//-----------------------------------------------------------------------------
+inline
+void CreateHammersleyTable( uint32_t numSamples, Vector2* pResult )
+{
+    assert(pResult != nullptr || numSamples == 0);
+
+    uint32_t i = 0;
+
+#if defined(ASDX_ENABLE_SIMD)
+    const auto m1  = _mm_set1_epi32(0x55555555);
+    const auto m2  = _mm_set1_epi32(0x33333333);
+    const auto m4  = _mm_set1_epi32(0x0F0F0F0F);
+    const auto m8  = _mm_set1_epi32(0x00FF00FF);
+    const auto lo  = _mm_set1_epi32(0xFFFF);
+    const auto inv = _mm_set1_ps(2.3283064365386963e-10f);
+    const auto f16 = _mm_set1_ps(65536.0f);
+
+    auto index = _mm_setr_epi32(0, 1, 2, 3);
+    for(; i + 4 <= numSamples; i += 4)
+    {
+        auto bits = _mm_or_si128(_mm_slli_epi32(index, 16), _mm_srli_epi32(index, 16));
+        bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(bits, m1), 1), _mm_and_si128(_mm_srli_epi32(bits, 1), m1));
+        bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(bits, m2), 2), _mm_and_si128(_mm_srli_epi32(bits, 2), m2));
+        bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(bits, m4), 4), _mm_and_si128(_mm_srli_epi32(bits, 4), m4));
+        bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(bits, m8), 8), _mm_and_si128(_mm_srli_epi32(bits, 8), m8));
+
+        // SSE2 には符号無し整数の変換が無いので上位と下位の16bitに分けて変換する.
+        // 上位は 65536 倍しても誤差が出ないので, 1回の丸めで float(bits) と一致する.
+        auto hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bits, 16)), f16);
+        auto y  = _mm_mul_ps(_mm_add_ps(hi, _mm_cvtepi32_ps(_mm_and_si128(bits, lo))), inv);
+
+        alignas(16) float ys[4];
+        _mm_store_ps(ys, y);
+        for(auto k=0u; k<4; ++k)
+        { pResult[i + k] = Vector2(float(i + k) / float(numSamples), ys[k]); }
+
+        index = _mm_add_epi32(index, _mm_set1_epi32(4));
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    for(; i<numSamples; ++i)
+    { pResult[i] = Hammersley( i, numSamples ); }
+}
+
+//-----------------------------------------------------------------------------
+//      2次元Sobol列のテーブルを生成します.
+//-----------------------------------------------------------------------------
+inline
+void CreateSobolTable( uint32_t count, Vector2* pResult, uint32_t scrambleX, uint32_t scrambleY )
+{
+    assert(pResult != nullptr || count == 0);
+
+    // 1次元目は van der Corput 列, 2次元目は原始多項式 x + 1 の方向数.
+    uint32_t v0[32];
+    uint32_t v1[32];
+    v0[0] = v1[0] = 1u << 31;
+    for(auto k=1; k<32; ++k)
+    {
+        v0[k] = 1u << (31 - k);
+        v1[k] = v1[k - 1] ^ (v1[k - 1] >> 1);
+    }
+
+    // グレイコード順なので, 前の点から1方向数の排他的論理和で次の点が求まる.
+    auto x = scrambleX;
+    auto y = scrambleY;
+    for(auto i=0u; i<count; ++i)
+    {
+        pResult[i] = Vector2(
+            float(x >> 8) * (1.0f / 16777216.0f),
+            float(y >> 8) * (1.0f / 16777216.0f));
+
+        // i + 1 の最下位の1のビット位置.
+        auto bit = 0;
+        auto n   = i + 1;
+        while((n & 1u) == 0 && bit < 31)
+        {
+            n >>= 1;
+            bit++;
+        }
+        x ^= v0[bit];
+        y ^= v1[bit];
+    }
+}
+
 //-----------------------------------------------------------------------------
 //      平面式を正規化します.
 //-----------------------------------------------------------------------------
@@ -6614,7 +7867,7 @@ inline Matrix CreateBrightnessMatrix(float brightness)
 //-----------------------------------------------------------------------------
 //      彩度を調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-inline Matrix CreateSaturationMatrix(float r, float g, float b)
+constexpr Matrix CreateSaturationMatrix(float r, float g, float b)
 {
     // https://docs.microsoft.com/ja-jp/windows/win32/direct2d/saturation
     return Matrix(
@@ -6639,13 +7892,13 @@ inline Matrix CreateSaturationMatrix(float r, float g, float b)
 //-----------------------------------------------------------------------------
 //      彩度を調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-inline Matrix CreateSaturationMatrix(float saturation)
+constexpr Matrix CreateSaturationMatrix(float saturation)
 { return CreateSaturationMatrix(saturation, saturation, saturation); }
 
 //-----------------------------------------------------------------------------
 //      コントラストを調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-inline Matrix CreateContrastMatrix(float contrast)
+constexpr Matrix CreateContrastMatrix(float contrast)
 {
     const auto t = (1.0f - contrast) * 0.5f;
     return Matrix(
@@ -6690,7 +7943,7 @@ inline Matrix CreateHueMatrix(float hue)
 //-----------------------------------------------------------------------------
 //      セピアカラーを調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-inline Matrix CreateSepiaMatrix(float tone)
+constexpr Matrix CreateSepiaMatrix(float tone)
 {
     const Vector3 W(0.298912f, 0.586611f, 0.114478f);
     const Vector3 Sepia(0.941f, 0.784f, 0.569f);
@@ -6717,7 +7970,7 @@ inline Matrix CreateSepiaMatrix(float tone)
 //-----------------------------------------------------------------------------
 //      グレースケールカラーを調整するカラー行列を生成します.
 //-----------------------------------------------------------------------------
-inline Matrix CreateGrayScaleMatrix(float tone)
+constexpr Matrix CreateGrayScaleMatrix(float tone)
 {
     const Vector3 GrayScale(0.22015f, 0.706655f, 0.071330f);
     return Matrix(
@@ -6742,7 +7995,7 @@ inline Matrix CreateGrayScaleMatrix(float tone)
 //-----------------------------------------------------------------------------
 //      ネガポジ反転のカラー行列を生成します.
 //-----------------------------------------------------------------------------
-inline Matrix CreateNegaposiMatrix()
+constexpr Matrix CreateNegaposiMatrix()
 {
     return Matrix(
         -1.0f,  0.0f,  0.0f, 0.0f,
@@ -0,0 +1,417 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMeshBVH.h
+// Desc : Bounding Volume Hierarchy for Mesh Triangles.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cfloat>
+#include <vector>
+#include <asdxMath.h>
+#include <asdxBounds.h>
+#include <asdxResModel.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   MESH_BVH_LEAF_SIZE      = 4;    //!< 葉ノードが持つ最大三角形数.
+static constexpr uint32_t   MESH_BVH_MAX_DEPTH      = 64;   //!< 探索スタックの最大深さ.
+static constexpr uint32_t   MESH_BVH_INVALID_INDEX  = UINT32_MAX;
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshBVHNode structure
+///////////////////////////////////////////////////////////////////////////////
+struct MeshBVHNode
+{
+    float       Min[3];     //!< 境界箱の最小値.
+    uint32_t    Offset;     //!< 葉ノードの場合は先頭の要素番号, 内部ノードの場合は左の子ノード番号(右の子は Offset + 1).
+    float       Max[3];     //!< 境界箱の最大値.
+    uint32_t    Count;      //!< 葉ノードの要素数(0の場合は内部ノード).
+};
+static_assert(sizeof(MeshBVHNode) == 32, "MeshBVHNode Size Not Matched.");
+
+///////////////////////////////////////////////////////////////////////////////
+// Ray structure
+///////////////////////////////////////////////////////////////////////////////
+struct Ray
+{
+    Vector3     Origin;                 //!< 始点.
+    Vector3     Direction;              //!< 方向(正規化は不要です).
+    float       MinT    = 0.0f;         //!< 交差を判定する最小距離(Direction 単位).
+    float       MaxT    = FLT_MAX;      //!< 交差を判定する最大距離(Direction 単位).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// RayPacket structure
+///////////////////////////////////////////////////////////////////////////////
+template<uint32_t N>
+struct alignas(16) RayPacket
+{
+    static_assert(N % 4 == 0, "Packet Size Must Be Multiple Of 4.");
+    static constexpr uint32_t LaneCount = N;    //!< レーン数.
+
+    float   OriginX     [N];    //!< 始点のX成分.
+    float   OriginY     [N];    //!< 始点のY成分.
+    float   OriginZ     [N];    //!< 始点のZ成分.
+    float   DirectionX  [N];    //!< 方向のX成分.
+    float   DirectionY  [N];    //!< 方向のY成分.
+    float   DirectionZ  [N];    //!< 方向のZ成分.
+    float   MinT        [N];    //!< 交差を判定する最小距離.
+    float   MaxT        [N];    //!< 交差を判定する最大距離(負の値のレーンは無効).
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンにレイを設定します.
+    //-------------------------------------------------------------------------
+    void Set(uint32_t lane, const Ray& ray)
+    {
+        OriginX   [lane] = ray.Origin.x;
+        OriginY   [lane] = ray.Origin.y;
+        OriginZ   [lane] = ray.Origin.z;
+        DirectionX[lane] = ray.Direction.x;
+        DirectionY[lane] = ray.Direction.y;
+        DirectionZ[lane] = ray.Direction.z;
+        MinT      [lane] = ray.MinT;
+        MaxT      [lane] = ray.MaxT;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      レーンのレイを取得します.
+    //-------------------------------------------------------------------------
+    Ray Get(uint32_t lane) const
+    {
+        Ray ray;
+        ray.Origin    = Vector3(OriginX[lane], OriginY[lane], OriginZ[lane]);
+        ray.Direction = Vector3(DirectionX[lane], DirectionY[lane], DirectionZ[lane]);
+        ray.MinT      = MinT[lane];
+        ray.MaxT      = MaxT[lane];
+        return ray;
+    }
+};
+
+using RayPacket4 = RayPacket<4>;
+using RayPacket8 = RayPacket<8>;
+
+///////////////////////////////////////////////////////////////////////////////
+// RayHit structure
+///////////////////////////////////////////////////////////////////////////////
+struct RayHit
+{
+    float       Distance        = FLT_MAX;                  //!< 交差距離(Direction 単位).
+    float       U               = 0.0f;                     //!< 重心座標(2番目の頂点の重み).
+    float       V               = 0.0f;                     //!< 重心座標(3番目の頂点の重み).
+    uint32_t    TriangleIndex   = MESH_BVH_INVALID_INDEX;   //!< 三角形番号(インデックスバッファの位置 / 3).
+    uint32_t    InstanceIndex   = MESH_BVH_INVALID_INDEX;   //!< インスタンス番号(ModelBVH のみ).
+
+    //-------------------------------------------------------------------------
+    //! @brief      交差したかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool IsHit() const
+    { return TriangleIndex != MESH_BVH_INVALID_INDEX; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ClosestPoint structure
+///////////////////////////////////////////////////////////////////////////////
+struct ClosestPoint
+{
+    Vector3     Point;                                      //!< 最近点.
+    float       Distance        = FLT_MAX;                  //!< 最近点までの距離.
+    uint32_t    TriangleIndex   = MESH_BVH_INVALID_INDEX;   //!< 三角形番号.
+    uint32_t    InstanceIndex   = MESH_BVH_INVALID_INDEX;   //!< インスタンス番号(ModelBVH のみ).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// TriangleRef structure
+///////////////////////////////////////////////////////////////////////////////
+struct TriangleRef
+{
+    uint32_t    InstanceIndex;  //!< インスタンス番号(MeshBVH の場合は MESH_BVH_INVALID_INDEX).
+    uint32_t    TriangleIndex;  //!< 三角形番号.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshBVH class
+///////////////////////////////////////////////////////////////////////////////
+class MeshBVH
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    friend class ModelBVH;
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      階層を構築します.
+    //!
+    //! @param[in]      mesh            対象メッシュ(Positions と Indices のみ使用します).
+    //! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+    //! @retval true    構築に成功.
+    //! @retval false   構築に失敗.
+    //! @note       三角形の頂点はコピーして保持します. ビン分割の SAH で分割し, 結果はスレッド数に依存しません.
+    //-------------------------------------------------------------------------
+    bool Build(const ResMesh& mesh, uint32_t maxThreadCount = 0);
+
+    //-------------------------------------------------------------------------
+    //! @brief      レイと最も近い交差を求めます.
+    //!
+    //! @param[in]      ray         レイ.
+    //! @param[out]     hit         交差情報.
+    //! @retval true    交差あり.
+    //! @retval false   交差なし.
+    //! @note       裏面とも交差します.
+    //-------------------------------------------------------------------------
+    bool Intersect(const Ray& ray, RayHit& hit) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      レイがいずれかの三角形と交差するかどうか判定します.
+    //!
+    //! @param[in]      ray         レイ.
+    //! @retval true    交差あり.
+    //! @retval false   交差なし.
+    //-------------------------------------------------------------------------
+    bool Occluded(const Ray& ray) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      4本のレイと最も近い交差を求めます.
+    //!
+    //! @param[in]      packet      レイパケット.
+    //! @param[out]     pHits       レーンごとの交差情報(4個).
+    //! @return     交差したレーンのマスクを返却します.
+    //-------------------------------------------------------------------------
+    uint32_t Intersect(const RayPacket4& packet, RayHit* pHits) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      8本のレイと最も近い交差を求めます.
+    //!
+    //! @param[in]      packet      レイパケット.
+    //! @param[out]     pHits       レーンごとの交差情報(8個).
+    //! @return     交差したレーンのマスクを返却します.
+    //-------------------------------------------------------------------------
+    uint32_t Intersect(const RayPacket8& packet, RayHit* pHits) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点から最も近い三角形上の点を求めます.
+    //!
+    //! @param[in]      point       検索する点.
+    //! @param[in]      maxDistance 検索する最大距離.
+    //! @param[out]     result      検索結果.
+    //! @retval true    maxDistance 以内に三角形がある.
+    //! @retval false   maxDistance 以内に三角形が無い.
+    //-------------------------------------------------------------------------
+    bool FindClosestPoint(const Vector3& point, float maxDistance, ClosestPoint& result) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と重なる三角形を検索します.
+    //!
+    //! @param[in]      sphere      検索する境界球.
+    //! @param[out]     result      検索結果の追加先.
+    //-------------------------------------------------------------------------
+    void Query(const BoundingSphere& sphere, std::vector<TriangleRef>& result) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      全体の境界箱を取得します.
+    //-------------------------------------------------------------------------
+    BoundingBox GetBounds() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ノード配列を取得します.
+    //!
+    //! @return     ノード配列を返却します. 先頭がルートノードです.
+    //-------------------------------------------------------------------------
+    const std::vector<MeshBVHNode>& GetNodes() const
+    { return m_Nodes; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      三角形数を取得します.
+    //-------------------------------------------------------------------------
+    size_t GetTriangleCount() const
+    { return m_TriangleIndices.size(); }
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Triangle structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Triangle
+    {
+        Vector3     V0;     // 1番目の頂点.
+        Vector3     E1;     // 2番目の頂点 - V0.
+        Vector3     E2;     // 3番目の頂点 - V0.
+    };
+
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::vector<MeshBVHNode>    m_Nodes;            // ノード(子は親より後ろに並ぶ).
+    std::vector<Triangle>       m_Triangles;        // 葉ノードの順に並べた三角形.
+    std::vector<uint32_t>       m_TriangleIndices;  // 並べ替え後の位置から元の三角形番号への対応表.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    template<bool AnyHit>
+    bool IntersectImpl(const Ray& ray, RayHit& hit) const;
+
+    template<uint32_t N>
+    uint32_t IntersectPacket(const RayPacket<N>& packet, RayHit* pHits) const;
+
+    bool FindClosestPointImpl(const Vector3& point, const Matrix* pWorld, float& distanceSq, ClosestPoint& result) const;
+    void QueryImpl(const BoundingSphere& sphere, const Matrix* pWorld, uint32_t instance, std::vector<TriangleRef>& result) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshInstance structure
+///////////////////////////////////////////////////////////////////////////////
+struct MeshInstance
+{
+    uint32_t    MeshIndex;  //!< ResModel のメッシュ番号.
+    Matrix      World;      //!< ワールド変換行列(アフィン変換).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ModelBVH class
+///////////////////////////////////////////////////////////////////////////////
+class ModelBVH
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      メッシュごとの階層を構築します.
+    //!
+    //! @param[in]      model           対象モデル.
+    //! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+    //! @retval true    構築に成功.
+    //! @retval false   構築に失敗.
+    //! @note       メッシュごとに単位行列のインスタンスを1つずつ設定します.
+    //-------------------------------------------------------------------------
+    bool Build(const ResModel& model, uint32_t maxThreadCount = 0);
+
+    //-------------------------------------------------------------------------
+    //! @brief      インスタンスを設定し, 上位の階層のみ再構築します.
+    //!
+    //! @param[in]      pInstances      インスタンス配列.
+    //! @param[in]      count           インスタンス数.
+    //! @retval true    設定に成功.
+    //! @retval false   メッシュ番号が範囲外, または変換行列がアフィン変換でないか逆行列を持たない.
+    //! @note       メッシュの階層は再構築しません.
+    //-------------------------------------------------------------------------
+    bool SetInstances(const MeshInstance* pInstances, size_t count);
+
+    //-------------------------------------------------------------------------
+    //! @brief      レイと最も近い交差を求めます.
+    //!
+    //! @param[in]      ray         ワールド空間のレイ.
+    //! @param[out]     hit         交差情報.
+    //! @retval true    交差あり.
+    //! @retval false   交差なし.
+    //-------------------------------------------------------------------------
+    bool Intersect(const Ray& ray, RayHit& hit) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      レイがいずれかの三角形と交差するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool Occluded(const Ray& ray) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      4本のレイと最も近い交差を求めます.
+    //!
+    //! @return     交差したレーンのマスクを返却します.
+    //-------------------------------------------------------------------------
+    uint32_t Intersect(const RayPacket4& packet, RayHit* pHits) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      8本のレイと最も近い交差を求めます.
+    //!
+    //! @return     交差したレーンのマスクを返却します.
+    //-------------------------------------------------------------------------
+    uint32_t Intersect(const RayPacket8& packet, RayHit* pHits) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      点から最も近い三角形上の点を求めます.
+    //!
+    //! @param[in]      point       ワールド空間の点.
+    //! @param[in]      maxDistance 検索する最大距離.
+    //! @param[out]     result      ワールド空間の検索結果.
+    //! @retval true    maxDistance 以内に三角形がある.
+    //! @retval false   maxDistance 以内に三角形が無い.
+    //! @note       非一様スケールでも正しい距離を求めるため, 下位の階層はワールド空間に変換して探索します.
+    //-------------------------------------------------------------------------
+    bool FindClosestPoint(const Vector3& point, float maxDistance, ClosestPoint& result) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      境界球と重なる三角形を検索します.
+    //!
+    //! @param[in]      sphere      ワールド空間の境界球.
+    //! @param[out]     result      検索結果の追加先.
+    //-------------------------------------------------------------------------
+    void Query(const BoundingSphere& sphere, std::vector<TriangleRef>& result) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      メッシュの階層を取得します.
+    //-------------------------------------------------------------------------
+    const std::vector<MeshBVH>& GetMeshes() const
+    { return m_Meshes; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      上位の階層のノード配列を取得します.
+    //-------------------------------------------------------------------------
+    const std::vector<MeshBVHNode>& GetNodes() const
+    { return m_Nodes; }
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Instance structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Instance
+    {
+        uint32_t    MeshIndex;  // メッシュ番号.
+        Matrix      World;      // ワールド変換行列.
+        Matrix      InvWorld;   // ワールド変換行列の逆行列.
+    };
+
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::vector<MeshBVH>        m_Meshes;           // メッシュごとの階層.
+    std::vector<Instance>       m_Instances;        // インスタンス.
+    std::vector<MeshBVHNode>    m_Nodes;            // インスタンスの階層.
+    std::vector<uint32_t>       m_InstanceOrder;    // 葉ノードの順に並べたインスタンス番号.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    template<bool AnyHit>
+    bool IntersectImpl(const Ray& ray, RayHit& hit) const;
+
+    template<uint32_t N>
+    uint32_t IntersectPacket(const RayPacket<N>& packet, RayHit* pHits) const;
+};
+
+} // namespace asdx
@@ -0,0 +1,103 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMeshSimplify.h
+// Desc : Mesh Simplification.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cfloat>
+#include <vector>
+#include <asdxResModel.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// SimplifyDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct SimplifyDesc
+{
+    uint32_t    TargetTriangleCount = 0;        //!< 目標の三角形数. この数以下になった時点で終了します.
+    float       TargetError         = FLT_MAX;  //!< 許容する誤差(距離). これを超える縮約は行いません.
+    bool        LockBorder          = false;    //!< 開いた境界の頂点を固定するかどうか.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LODChainDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct LODChainDesc
+{
+    uint32_t    MaxLevelCount       = 5;        //!< 最大レベル数(LOD0 を含む).
+    float       ReductionRatio      = 0.5f;     //!< 1レベルあたりの三角形数の比率.
+    uint32_t    MinTriangleCount    = 16;       //!< これより少ない三角形数のレベルは作りません.
+    float       MaxError            = FLT_MAX;  //!< 許容する最大誤差.
+    bool        LockBorder          = false;    //!< 開いた境界の頂点を固定するかどうか.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshLOD structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshLOD
+{
+    std::vector<uint32_t>   Indices;        //!< 元のメッシュの頂点を参照するインデックス.
+    float                   Error = 0.0f;   //!< 元の形状からの誤差(距離). レベルが上がるほど大きくなります.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      二次誤差計量による辺の縮約でメッシュを簡略化します.
+//!
+//! @param[in]      mesh        簡略化するメッシュ.
+//! @param[in]      desc        簡略化設定.
+//! @param[out]     result      簡略化したインデックス. 元のメッシュの頂点を参照します.
+//! @return     簡略化による誤差を返却します. 縮約した頂点の二次誤差から見積もった,
+//!             元の面からの距離です.
+//! @note       頂点は移動せず, 縮約先の頂点をそのまま使います. 同じ位置で属性が異なる頂点
+//!             (UV, 法線, カラーの継ぎ目)は継ぎ目に沿ってのみ両側をまとめて縮約するため,
+//!             属性の不連続は保たれます. 結果は入力だけで決まります.
+//-----------------------------------------------------------------------------
+float SimplifyMesh(const ResMesh& mesh, const SimplifyDesc& desc, std::vector<uint32_t>& result);
+
+//-----------------------------------------------------------------------------
+//! @brief      LOD チェインを構築します.
+//!
+//! @param[in]      mesh        元のメッシュ(LOD0).
+//! @param[in]      desc        構築設定.
+//! @param[out]     result      LOD0 から順に格納されたレベル.
+//! @note       各レベルは元のメッシュから簡略化するため, 誤差は常に元の形状に対する値です.
+//!             レベルは並列に構築します. 三角形数が十分に減らなくなった時点で打ち切ります.
+//-----------------------------------------------------------------------------
+void BuildLODChain(const ResMesh& mesh, const LODChainDesc& desc, std::vector<ResMeshLOD>& result);
+
+//-----------------------------------------------------------------------------
+//! @brief      画面上の誤差が許容値以下となる最も粗いレベルを選択します.
+//!
+//! @param[in]      lods            LOD チェイン.
+//! @param[in]      distance        視点からの距離.
+//! @param[in]      pixelsPerUnit   距離1での1単位あたりのピクセル数(画面の高さ / (2 * tan(fovY / 2))).
+//! @param[in]      maxPixelError   許容するピクセル誤差.
+//! @return     レベル番号を返却します.
+//-----------------------------------------------------------------------------
+inline uint32_t SelectLOD
+(
+    const std::vector<ResMeshLOD>&  lods,
+    float                           distance,
+    float                           pixelsPerUnit,
+    float                           maxPixelError
+)
+{
+    uint32_t level = 0;
+    auto scale = pixelsPerUnit / ((distance > FLT_MIN) ? distance : FLT_MIN);
+    for(uint32_t i=1; i<uint32_t(lods.size()); ++i)
+    {
+        if (lods[i].Error * scale > maxPixelError)
+        { break; }
+        level = i;
+    }
+    return level;
+}
+
+} // namespace asdx
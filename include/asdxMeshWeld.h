@@ -0,0 +1,56 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMeshWeld.h
+// Desc : Vertex Welding.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <asdxResModel.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// WeldDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct WeldDesc
+{
+    float   Epsilon = 0.0f;     //!< 位置の許容誤差(各成分). 0の場合は全ての属性が完全に一致する頂点のみ統合します.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      重複頂点を統合する頂点番号の対応表を生成します.
+//!
+//! @param[in]      mesh            対象メッシュ.
+//! @param[in]      desc            統合設定.
+//! @param[out]     remap           頂点ごとの統合後の頂点番号.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合はワーカースレッド数).
+//! @return     統合後の頂点数を返却します. 頂点ストリームの要素数が一致しない場合は0を返却します.
+//! @note       全ての頂点ストリームを xxhash でハッシュ化して比較します.
+//!             Epsilon を指定した場合, 位置は格子で近傍を探索し, 他の属性は完全一致で比較します.
+//!             統合後の頂点番号は最初に現れた順で, 結果はスレッド数に依存しません.
+//-----------------------------------------------------------------------------
+uint32_t GenerateVertexRemap(
+    const ResMesh&          mesh,
+    const WeldDesc&         desc,
+    std::vector<uint32_t>&  remap,
+    uint32_t                maxThreadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      重複頂点を統合し, インデックスを再構築します.
+//!
+//! @param[in,out]  mesh            対象メッシュ.
+//! @param[in]      desc            統合設定.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合はワーカースレッド数).
+//! @retval true    統合に成功.
+//! @retval false   統合に失敗.
+//! @note       インデックスが空の場合は, 頂点が3つずつ三角形を成すトライアングルスープとして扱います.
+//-----------------------------------------------------------------------------
+bool WeldVertices(ResMesh& mesh, const WeldDesc& desc = WeldDesc(), uint32_t maxThreadCount = 0);
+
+} // namespace asdx
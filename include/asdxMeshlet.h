@@ -0,0 +1,136 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMeshlet.h
+// Desc : Meshlet Builder.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <asdxMath.h>
+#include <asdxBounds.h>
+#include <asdxResModel.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   MESHLET_MAX_VERTEX_COUNT    = 256;  //!< メッシュレットの頂点数の上限(ローカルインデックスは8bit).
+static constexpr uint32_t   MESHLET_MAX_TRIANGLE_COUNT  = 512;  //!< メッシュレットの三角形数の上限.
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshletDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct MeshletDesc
+{
+    uint32_t    MaxVertexCount      = 64;   //!< 1メッシュレットあたりの最大頂点数(3 ～ MESHLET_MAX_VERTEX_COUNT).
+    uint32_t    MaxTriangleCount    = 124;  //!< 1メッシュレットあたりの最大三角形数(1 ～ MESHLET_MAX_TRIANGLE_COUNT).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshlet structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshlet
+{
+    uint32_t    VertexOffset    = 0;    //!< 頂点番号リストの開始位置.
+    uint32_t    VertexCount     = 0;    //!< 頂点数.
+    uint32_t    TriangleOffset  = 0;    //!< 三角形リストの開始位置.
+    uint32_t    TriangleCount   = 0;    //!< 三角形数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshletBounds structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshletBounds
+{
+    BoundingSphere  Sphere;             //!< バウンディングスフィア.
+    Vector3         ConeApex;           //!< 法線コーンの頂点.
+    Vector3         ConeAxis;           //!< 法線コーンの軸(平均法線). 判定できない場合はゼロベクトル.
+    float           ConeCutoff = 1.0f;  //!< 背面判定の閾値(コーン半角の正弦).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshlets structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshlets
+{
+    std::vector<ResMeshlet>         Meshlets;       //!< メッシュレット.
+    std::vector<ResMeshletBounds>   Bounds;         //!< メッシュレットごとの境界.
+    std::vector<uint32_t>           VertexIndices;  //!< メッシュの頂点番号リスト.
+    std::vector<uint32_t>           Triangles;      //!< ローカル頂点番号をパックした三角形(i0 | i1 << 8 | i2 << 16).
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      パックされた三角形を作成します.
+//-----------------------------------------------------------------------------
+inline uint32_t PackMeshletTriangle(uint32_t i0, uint32_t i1, uint32_t i2)
+{ return (i0 & 0xff) | ((i1 & 0xff) << 8) | ((i2 & 0xff) << 16); }
+
+//-----------------------------------------------------------------------------
+//! @brief      パックされた三角形のローカル頂点番号を取得します.
+//-----------------------------------------------------------------------------
+inline uint32_t UnpackMeshletTriangle(uint32_t packed, uint32_t corner)
+{ return (packed >> (corner * 8)) & 0xff; }
+
+//-----------------------------------------------------------------------------
+//! @brief      メッシュをメッシュレットに分割します.
+//!
+//! @param[in]      mesh        分割するメッシュ.
+//! @param[in]      desc        分割設定.
+//! @param[out]     result      分割結果.
+//! @retval true    分割に成功.
+//! @retval false   分割に失敗.
+//! @note       現在のメッシュレットと頂点を共有する三角形を優先して追加し,
+//!             候補が無い場合はインデックス順で次の三角形から新しく始めます.
+//!             結果は入力だけで決まります.
+//-----------------------------------------------------------------------------
+bool BuildMeshlets(const ResMesh& mesh, const MeshletDesc& desc, ResMeshlets& result);
+
+//-----------------------------------------------------------------------------
+//! @brief      モデルの全メッシュをメッシュレットに分割します.
+//!
+//! @param[in]      model           分割するモデル.
+//! @param[in]      desc            分割設定.
+//! @param[out]     result          メッシュごとの分割結果.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合はワーカースレッド数).
+//! @retval true    全てのメッシュの分割に成功.
+//! @retval false   いずれかのメッシュの分割に失敗.
+//! @note       メッシュ単位で並列に処理します. 結果はスレッド数に依存しません.
+//-----------------------------------------------------------------------------
+bool BuildMeshlets(
+    const ResModel&             model,
+    const MeshletDesc&          desc,
+    std::vector<ResMeshlets>&   result,
+    uint32_t                    maxThreadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      メッシュレットを検証します.
+//!
+//! @param[in]      mesh        分割元のメッシュ.
+//! @param[in]      desc        分割設定.
+//! @param[in]      meshlets    検証するメッシュレット.
+//! @retval true    上限を守り, 全ての三角形を1度ずつ含み, 境界が全頂点を含む.
+//! @retval false   不正なデータがある.
+//-----------------------------------------------------------------------------
+bool ValidateMeshlets(const ResMesh& mesh, const MeshletDesc& desc, const ResMeshlets& meshlets);
+
+//-----------------------------------------------------------------------------
+//! @brief      メッシュレットが視点から見て背面だけで構成されるか判定します.
+//!
+//! @param[in]      bounds      メッシュレットの境界.
+//! @param[in]      cameraPos   視点位置.
+//! @retval true    全ての三角形が背面.
+//! @retval false   表面の三角形が含まれる可能性がある.
+//-----------------------------------------------------------------------------
+inline bool IsMeshletBackfacing(const ResMeshletBounds& bounds, const Vector3& cameraPos)
+{
+    auto dir = Vector3::SafeNormalize(bounds.ConeApex - cameraPos, bounds.ConeAxis);
+    return Vector3::Dot(dir, bounds.ConeAxis) >= bounds.ConeCutoff;
+}
+
+} // namespace asdx
@@ -0,0 +1,63 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxObj.h
+// Desc : Wavefront OBJ Loader.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <asdxResModel.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//! @brief      Wavefront OBJ ファイルを読み込みます.
+//!
+//! @param[in]      filename        ファイルパス.
+//! @param[out]     result          読み込み結果.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//! @note       ファイルを行単位のチャンクに分割して並列に解析し, 頂点番号の組で重複頂点を統合します.
+//!             グループ(g, o)とマテリアル(usemtl)の組ごとに ResMesh を1つ生成し, 多角形は扇状に三角形化します.
+//!             mtllib で指定された MTL ファイルは OBJ ファイルと同じディレクトリから読み込みます.
+//!             テクスチャ座標の V は反転しません.
+//-----------------------------------------------------------------------------
+bool LoadObj(const char* filename, ResModel& result, uint32_t maxThreadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      メモリ上の Wavefront OBJ データを読み込みます.
+//!
+//! @param[in]      pBuffer         OBJ のテキスト.
+//! @param[in]      size            データサイズ.
+//! @param[in]      baseDirectory   MTL ファイルの基準ディレクトリ(nullptr の場合は MTL ファイルを読み込みません).
+//! @param[out]     result          読み込み結果.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//-----------------------------------------------------------------------------
+bool LoadObj(
+    const void*     pBuffer,
+    size_t          size,
+    const char*     baseDirectory,
+    ResModel&       result,
+    uint32_t        maxThreadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      メモリ上の MTL データを読み込みます.
+//!
+//! @param[in]      pBuffer         MTL のテキスト.
+//! @param[in]      size            データサイズ.
+//! @param[out]     result          読み込んだマテリアルの追加先.
+//! @note       Kd, Ke, Pr(Ns), map_Kd, map_Ke を ResMaterial に変換します.
+//!             Pr が無い場合は Ns から粗さを求めます.
+//-----------------------------------------------------------------------------
+void LoadMtl(const void* pBuffer, size_t size, std::vector<ResMaterial>& result);
+
+} // namespace asdx
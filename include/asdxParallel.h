@@ -0,0 +1,90 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxParallel.h
+// Desc : Parallel Helper.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//! @brief      使用可能なワーカースレッド数を取得します.
+//!
+//! @param [in]     maxThreadCount      最大スレッド数(0の場合は論理コア数).
+//! @return     1以上のスレッド数を返却します.
+//-----------------------------------------------------------------------------
+inline uint32_t GetWorkerThreadCount(uint32_t maxThreadCount = 0)
+{
+    auto count = std::thread::hardware_concurrency();
+    if (count == 0)
+    { count = 1; }
+
+    if (maxThreadCount != 0 && count > maxThreadCount)
+    { count = maxThreadCount; }
+
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      [0, count) の範囲を連続したバッチに分割して並列に処理します.
+//!
+//! @param [in]     count               要素数.
+//! @param [in]     minBatchSize        1バッチあたりの最小要素数.
+//! @param [in]     func                void(uint32_t batchIndex, size_t begin, size_t end) 形式の処理関数.
+//! @param [in]     maxThreadCount      最大スレッド数(0の場合は論理コア数).
+//! @return     実際に使用したバッチ数を返却します.
+//! @note       バッチの区切りは count, minBatchSize, スレッド数のみで決まります.
+//!             呼び出し元スレッドも最初のバッチを処理します.
+//-----------------------------------------------------------------------------
+template<typename Func> inline
+uint32_t ParallelFor(size_t count, size_t minBatchSize, Func func, uint32_t maxThreadCount = 0)
+{
+    if (count == 0)
+    { return 0; }
+
+    if (minBatchSize == 0)
+    { minBatchSize = 1; }
+
+    size_t batchCount = (count + minBatchSize - 1) / minBatchSize;
+    size_t threadCount = GetWorkerThreadCount(maxThreadCount);
+    if (batchCount > threadCount)
+    { batchCount = threadCount; }
+
+    if (batchCount <= 1)
+    {
+        func(0u, size_t(0), count);
+        return 1;
+    }
+
+    auto batchSize = (count + batchCount - 1) / batchCount;
+
+    std::vector<std::thread> threads;
+    threads.reserve(batchCount - 1);
+
+    for(size_t i=1; i<batchCount; ++i)
+    {
+        auto begin = i * batchSize;
+        auto end   = (begin + batchSize < count) ? begin + batchSize : count;
+        if (begin >= end)
+        { break; }
+
+        threads.emplace_back(func, uint32_t(i), begin, end);
+    }
+
+    func(0u, size_t(0), batchSize);
+
+    for(auto& thread : threads)
+    { thread.join(); }
+
+    return uint32_t(threads.size() + 1);
+}
+
+} // namespace asdx
@@ -84,6 +84,15 @@ struct ResModel
     std::vector<ResMaterial>    Materials;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// VertexCacheStats structure
+///////////////////////////////////////////////////////////////////////////////
+struct VertexCacheStats
+{
+    float   ACMR;   //!< 三角形あたりの頂点シェーダ実行回数(Average Cache Miss Ratio).
+    float   ATVR;   //!< 参照頂点あたりの頂点シェーダ実行回数(Average Transformed Vertex Ratio).
+};
+
 //-----------------------------------------------------------------------------
 //      メッシュの破棄処理を行います.
 //-----------------------------------------------------------------------------
@@ -96,15 +105,60 @@ void Dispose(ResModel& resource);
 
 //-----------------------------------------------------------------------------
 //      頂点法線を計算します.
+//      頂点ごとに隣接三角形を番号順に加算するため, 結果はスレッド数に依存しません.
+//      maxThreadCount は最大スレッド数です(0の場合は論理コア数, 1の場合はシングルスレッド).
 //-----------------------------------------------------------------------------
-void CalcNormals(ResMesh& resource);
-void CalcNormals(ResModel& resource);
+void CalcNormals(ResMesh& resource, uint32_t maxThreadCount = 0);
+void CalcNormals(ResModel& resource, uint32_t maxThreadCount = 0);
 
 //-----------------------------------------------------------------------------
 //      接線ベクトルを計算します.
+//      頂点ごとに隣接三角形を番号順に加算するため, 結果はスレッド数に依存しません.
+//      maxThreadCount は最大スレッド数です(0の場合は論理コア数, 1の場合はシングルスレッド).
+//-----------------------------------------------------------------------------
+void CalcTangents(ResMesh& resource, uint32_t maxThreadCount = 0);
+void CalcTangents(ResModel& resource, uint32_t maxThreadCount = 0);
+
+//-----------------------------------------------------------------------------
+//      頂点キャッシュの効率を解析します.
+//      FIFO キャッシュをシミュレートし, ACMR と ATVR を求めます.
+//      範囲外の頂点番号がある場合はエラーを出力して0を返却します.
+//-----------------------------------------------------------------------------
+VertexCacheStats AnalyzeVertexCache(
+    const uint32_t* pIndices,
+    size_t          indexCount,
+    size_t          vertexCount,
+    uint32_t        cacheSize = 32);
+VertexCacheStats AnalyzeVertexCache(const ResMesh& resource, uint32_t cacheSize = 32);
+
+//-----------------------------------------------------------------------------
+//      頂点キャッシュの効率が良くなるように三角形を並び替えます(Forsyth 法).
+//      範囲外の頂点番号がある場合はエラーを出力して何もしません(以下の最適化も同様).
+//-----------------------------------------------------------------------------
+void OptimizeVertexCache(ResMesh& resource);
+void OptimizeVertexCache(ResModel& resource);
+
+//-----------------------------------------------------------------------------
+//      オーバードローが少なくなるように三角形を並び替えます.
+//      OptimizeVertexCache() の後に呼び出してください. threshold は許容する
+//      ACMR の悪化率です.
+//-----------------------------------------------------------------------------
+void OptimizeOverdraw(ResMesh& resource, float threshold = 1.05f);
+void OptimizeOverdraw(ResModel& resource, float threshold = 1.05f);
+
+//-----------------------------------------------------------------------------
+//      頂点フェッチの効率が良くなるように頂点を並び替えます.
+//      全ての頂点ストリームを並び替え, インデックスを振り直します.
+//-----------------------------------------------------------------------------
+void OptimizeVertexFetch(ResMesh& resource);
+void OptimizeVertexFetch(ResModel& resource);
+
+//-----------------------------------------------------------------------------
+//      メッシュを最適化します.
+//      三角形の並び替え, オーバードロー最適化(任意), 頂点の並び替えを行います.
 //-----------------------------------------------------------------------------
-void CalcTangents(ResMesh& resource);
-void CalcTangents(ResModel& resource);
+void OptimizeMesh(ResMesh& resource, bool overdraw = false);
+void OptimizeMesh(ResModel& resource, bool overdraw = false);
 
 //-----------------------------------------------------------------------------
 //      八面体ラップ処理を行います.
@@ -0,0 +1,224 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxResModelFile.h
+// Desc : Binary Model File.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <asdxResModel.h>
+#include <asdxMappedFile.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   RES_MODEL_FILE_MAGIC        = 0x4c444d41;   //!< ファイル識別子('AMDL').
+static constexpr uint32_t   RES_MODEL_FILE_VERSION      = 1;            //!< ファイルバージョン.
+static constexpr uint32_t   RES_MODEL_FILE_ALIGNMENT    = 64;           //!< セクションと頂点ストリームのアライメント.
+
+///////////////////////////////////////////////////////////////////////////////
+// ResSpan structure
+///////////////////////////////////////////////////////////////////////////////
+template<typename T>
+struct ResSpan
+{
+    const T*    pData   = nullptr;  //!< 先頭要素.
+    size_t      Count   = 0;        //!< 要素数.
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    ResSpan() = default;
+
+    //-------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //-------------------------------------------------------------------------
+    ResSpan(const T* ptr, size_t count)
+    : pData(ptr), Count(count)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      配列を参照するビューを生成します.
+    //-------------------------------------------------------------------------
+    ResSpan(const std::vector<T>& value)
+    : pData(value.data()), Count(value.size())
+    { /* DO_NOTHING */ }
+
+    const T* data () const { return pData; }
+    const T* begin() const { return pData; }
+    const T* end  () const { return pData + Count; }
+    size_t   size () const { return Count; }
+    bool     empty() const { return Count == 0; }
+
+    const T& operator [] (size_t index) const
+    {
+        assert(index < Count);
+        return pData[index];
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMaterialView structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMaterialView
+{
+    const char* MaterialName        = "";   //!< マテリアル名.
+    const char* BaseColorMap        = "";   //!< ベースカラーマップ.
+    const char* OrmMap              = "";   //!< R:Occlusion, G:Roughness, B:Metalness.
+    const char* EmissiveMap         = "";   //!< エミッシブマップ.
+    float       BaseColorIntensity  = 0.0f; //!< ベースカラー強度.
+    float       OcclusionIntensity  = 0.0f; //!< 遮蔽強度.
+    float       RoughnessIntensity  = 0.0f; //!< ラフネス強度.
+    float       EmissiveIntensity   = 0.0f; //!< エミッシブ強度.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshView structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshView
+{
+    const char*             MeshName        = "";   //!< メッシュ名.
+    const char*             MaterialName    = "";   //!< マテリアル名.
+    ResSpan<Vector3>        Positions;              //!< 位置座標.
+    ResSpan<Vector3>        Normals;                //!< 法線ベクトル.
+    ResSpan<Vector3>        Tangents;               //!< 接線ベクトル.
+    ResSpan<Vector3>        Bitangents;             //!< 従接線ベクトル.
+    ResSpan<Vector4>        Colors;                 //!< 頂点カラー.
+    ResSpan<Vector2>        TexCoords[MAX_LAYER_COUNT]; //!< テクスチャ座標.
+    ResSpan<ResBoneIndex>   BoneIndices;            //!< ボーン番号.
+    ResSpan<Vector4>        BoneWeights;            //!< ボーンの重み.
+    ResSpan<uint32_t>       Indices;                //!< 頂点インデックス.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResModelFile class
+///////////////////////////////////////////////////////////////////////////////
+class ResModelFile
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    ResModelFile() = default;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルをメモリにマップして開きます.
+    //!
+    //! @param[in]      filename        ファイルパス.
+    //! @retval true    読み込みに成功.
+    //! @retval false   読み込みに失敗.
+    //! @note       データはコピーせず, 各ビューはマップされた領域を直接参照します.
+    //-------------------------------------------------------------------------
+    bool Open(const char* filename);
+
+    //-------------------------------------------------------------------------
+    //! @brief      メモリ上のデータを開きます.
+    //!
+    //! @param[in]      pBuffer         4バイト境界にアラインされたデータ.
+    //! @param[in]      size            データサイズ.
+    //! @retval true    読み込みに成功.
+    //! @retval false   読み込みに失敗.
+    //! @note       データはコピーしないため, Close() するまで破棄しないでください.
+    //-------------------------------------------------------------------------
+    bool Open(const void* pBuffer, size_t size);
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルを閉じます.
+    //-------------------------------------------------------------------------
+    void Close();
+
+    //-------------------------------------------------------------------------
+    //! @brief      メッシュ数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetMeshCount() const
+    { return uint32_t(m_Meshes.size()); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      マテリアル数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetMaterialCount() const
+    { return uint32_t(m_Materials.size()); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      メッシュのビューを取得します.
+    //-------------------------------------------------------------------------
+    const ResMeshView& GetMesh(uint32_t index) const
+    {
+        assert(index < m_Meshes.size());
+        return m_Meshes[index];
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      マテリアルのビューを取得します.
+    //-------------------------------------------------------------------------
+    const ResMaterialView& GetMaterial(uint32_t index) const
+    {
+        assert(index < m_Materials.size());
+        return m_Materials[index];
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      モデルリソースにコピーします.
+    //!
+    //! @param[out]     result      コピー先.
+    //-------------------------------------------------------------------------
+    void CopyTo(ResModel& result) const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    MappedFile                      m_File;         // マップされたファイル.
+    std::vector<ResMeshView>        m_Meshes;       // メッシュのビュー.
+    std::vector<ResMaterialView>    m_Materials;    // マテリアルのビュー.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    bool Parse(const void* pBuffer, size_t size);
+
+    ResModelFile                (const ResModelFile&) = delete;
+    ResModelFile& operator =    (const ResModelFile&) = delete;
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      モデルをバイナリ形式に変換します.
+//!
+//! @param[in]      model       変換するモデル.
+//! @param[out]     result      変換結果の格納先.
+//! @note       バイトオーダーはリトルエンディアンです.
+//-----------------------------------------------------------------------------
+void SaveResModel(const ResModel& model, std::vector<uint8_t>& result);
+
+//-----------------------------------------------------------------------------
+//! @brief      モデルをバイナリ形式でファイルに保存します.
+//!
+//! @param[in]      filename    ファイルパス.
+//! @param[in]      model       保存するモデル.
+//! @retval true    保存に成功.
+//! @retval false   保存に失敗.
+//-----------------------------------------------------------------------------
+bool SaveResModel(const char* filename, const ResModel& model);
+
+} // namespace asdx
@@ -0,0 +1,544 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxSimd.h
+// Desc : SIMD Helper.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+#include <emmintrin.h>
+
+#if !defined(ASDX_ENABLE_F16C) && (defined(__F16C__) || defined(__AVX2__))
+#define ASDX_ENABLE_F16C    // F16C命令を使用します.
+#endif
+
+#if defined(ASDX_ENABLE_F16C)
+#include <immintrin.h>
+#endif//defined(ASDX_ENABLE_F16C)
+
+
+//-----------------------------------------------------------------------------
+// Macros
+//-----------------------------------------------------------------------------
+#ifndef ASDX_SHUFFLE_MASK
+#define ASDX_SHUFFLE_MASK(x, y, z, w)       ( (x) | ((y) << 2) | ((z) << 4) | ((w) << 6) )
+#endif//ASDX_SHUFFLE_MASK
+
+#ifndef ASDX_SHUFFLE
+#define ASDX_SHUFFLE(a, b, x, y, z, w)      _mm_shuffle_ps( (a), (b), ASDX_SHUFFLE_MASK(x, y, z, w) )
+#endif//ASDX_SHUFFLE
+
+#ifndef ASDX_SWIZZLE
+#define ASDX_SWIZZLE(v, x, y, z, w)         _mm_castsi128_ps( _mm_shuffle_epi32( _mm_castps_si128(v), ASDX_SHUFFLE_MASK(x, y, z, w) ) )
+#endif//ASDX_SWIZZLE
+
+#ifndef ASDX_SPLAT
+#define ASDX_SPLAT(v, i)                    ASDX_SWIZZLE(v, i, i, i, i)
+#endif//ASDX_SPLAT
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//! @brief      全成分の総和を求めます.
+//!
+//! @param [in]     value       入力値.
+//! @return     全成分に総和を格納した値を返却します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdHorizontalAdd(__m128 value)
+{
+    auto t = _mm_add_ps(value, ASDX_SWIZZLE(value, 1, 0, 3, 2));  // (x+y, y+x, z+w, w+z)
+    return _mm_add_ps(t, ASDX_SWIZZLE(t, 2, 3, 0, 1));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      マスクに従って値を選択します.
+//!
+//! @param [in]     mask        比較結果のマスク.
+//! @param [in]     a           マスクのビットが立っている場合の値.
+//! @param [in]     b           マスクのビットが立っていない場合の値.
+//! @return     各ビットについて mask ? a : b を返却します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdSelect(__m128 mask, __m128 a, __m128 b)
+{ return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+//-----------------------------------------------------------------------------
+//! @brief      各成分の絶対値を求めます.
+//!
+//! @param [in]     value       入力値.
+//! @return     符号ビットを落とした値を返却します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdAbs(__m128 value)
+{ return _mm_andnot_ps(_mm_set1_ps(-0.0f), value); }
+
+//-----------------------------------------------------------------------------
+//! @brief      4成分の内積を求めます.
+//!
+//! @param [in]     a       入力値.
+//! @param [in]     b       入力値.
+//! @return     全成分に内積を格納した値を返却します.
+//! @note       加算順序のみスカラー版と異なり, 差は sum(|a_i * b_i|) の 2 ULP 以内です.
+//-----------------------------------------------------------------------------
+inline __m128 SimdDot4(__m128 a, __m128 b)
+{ return SimdHorizontalAdd(_mm_mul_ps(a, b)); }
+
+//-----------------------------------------------------------------------------
+//! @brief      行ベクトルと行列を乗算します.
+//!
+//! @param [in]     value       行ベクトル.
+//! @param [in]     r0          行列の1行目.
+//! @param [in]     r1          行列の2行目.
+//! @param [in]     r2          行列の3行目.
+//! @param [in]     r3          行列の4行目.
+//! @return     value * M を返却します.
+//! @note       加算順序はスカラー版と同じなので，FMA縮約が無ければビット一致します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdTransform(__m128 value, __m128 r0, __m128 r1, __m128 r2, __m128 r3)
+{
+    auto result = _mm_mul_ps(ASDX_SPLAT(value, 0), r0);
+    result = _mm_add_ps(result, _mm_mul_ps(ASDX_SPLAT(value, 1), r1));
+    result = _mm_add_ps(result, _mm_mul_ps(ASDX_SPLAT(value, 2), r2));
+    result = _mm_add_ps(result, _mm_mul_ps(ASDX_SPLAT(value, 3), r3));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      行優先の2x2行列同士を乗算します(A * B).
+//-----------------------------------------------------------------------------
+inline __m128 SimdMat2Mul(__m128 a, __m128 b)
+{
+    return _mm_add_ps(
+        _mm_mul_ps(a, ASDX_SWIZZLE(b, 0, 3, 0, 3)),
+        _mm_mul_ps(ASDX_SWIZZLE(a, 1, 0, 3, 2), ASDX_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      行優先の2x2行列の余因子行列と行列を乗算します(adj(A) * B).
+//-----------------------------------------------------------------------------
+inline __m128 SimdMat2AdjMul(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(ASDX_SWIZZLE(a, 3, 3, 0, 0), b),
+        _mm_mul_ps(ASDX_SWIZZLE(a, 1, 1, 2, 2), ASDX_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      行優先の2x2行列と余因子行列を乗算します(A * adj(B)).
+//-----------------------------------------------------------------------------
+inline __m128 SimdMat2MulAdj(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(a, ASDX_SWIZZLE(b, 3, 0, 3, 0)),
+        _mm_mul_ps(ASDX_SWIZZLE(a, 1, 0, 3, 2), ASDX_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      4x4行列の逆行列を求めます.
+//!
+//! @param [in]     r0          行列の1行目.
+//! @param [in]     r1          行列の2行目.
+//! @param [in]     r2          行列の3行目.
+//! @param [in]     r3          行列の4行目.
+//! @param [out]    result      逆行列の格納先(4要素 x 4行).
+//! @return     行列式を返却します.
+//! @note       2x2ブロックの余因子展開で求めます.
+//!             スカラー版との差は ulp(|inv(M)|) * cond(M) の 4 倍以内です(無限大ノルム).
+//-----------------------------------------------------------------------------
+inline float SimdInvert(__m128 r0, __m128 r1, __m128 r2, __m128 r3, __m128* result)
+{
+    // 2x2の小行列.
+    auto A = _mm_movelh_ps(r0, r1);
+    auto B = _mm_movehl_ps(r1, r0);
+    auto C = _mm_movelh_ps(r2, r3);
+    auto D = _mm_movehl_ps(r3, r2);
+
+    // 小行列の行列式 (|A|, |B|, |C|, |D|).
+    auto detSub = _mm_sub_ps(
+        _mm_mul_ps(ASDX_SHUFFLE(r0, r2, 0, 2, 0, 2), ASDX_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+        _mm_mul_ps(ASDX_SHUFFLE(r0, r2, 1, 3, 1, 3), ASDX_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+    auto detA = ASDX_SPLAT(detSub, 0);
+    auto detB = ASDX_SPLAT(detSub, 1);
+    auto detC = ASDX_SPLAT(detSub, 2);
+    auto detD = ASDX_SPLAT(detSub, 3);
+
+    auto D_C = SimdMat2AdjMul(D, C);
+    auto A_B = SimdMat2AdjMul(A, B);
+
+    auto X_ = _mm_sub_ps(_mm_mul_ps(detD, A), SimdMat2Mul(B, D_C));
+    auto W_ = _mm_sub_ps(_mm_mul_ps(detA, D), SimdMat2Mul(C, A_B));
+    auto Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), SimdMat2MulAdj(D, A_B));
+    auto Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), SimdMat2MulAdj(A, D_C));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C).
+    auto detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+    auto tr   = SimdHorizontalAdd(_mm_mul_ps(A_B, ASDX_SWIZZLE(D_C, 0, 2, 1, 3)));
+    detM = _mm_sub_ps(detM, tr);
+
+    auto rcpDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+    X_ = _mm_mul_ps(X_, rcpDet);
+    Y_ = _mm_mul_ps(Y_, rcpDet);
+    Z_ = _mm_mul_ps(Z_, rcpDet);
+    W_ = _mm_mul_ps(W_, rcpDet);
+
+    result[0] = ASDX_SHUFFLE(X_, Y_, 3, 1, 3, 1);
+    result[1] = ASDX_SHUFFLE(X_, Y_, 2, 0, 2, 0);
+    result[2] = ASDX_SHUFFLE(Z_, W_, 3, 1, 3, 1);
+    result[3] = ASDX_SHUFFLE(Z_, W_, 2, 0, 2, 0);
+
+    return _mm_cvtss_f32(detM);
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      3成分の外積を求めます.
+//!
+//! @param [in]     a       入力値.
+//! @param [in]     b       入力値.
+//! @return     xyzに外積を格納し, wは a.w * b.w - a.w * b.w を返却します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdCross3(__m128 a, __m128 b)
+{
+    auto a1 = ASDX_SWIZZLE(a, 1, 2, 0, 3);
+    auto b1 = ASDX_SWIZZLE(b, 2, 0, 1, 3);
+    auto a2 = ASDX_SWIZZLE(a, 2, 0, 1, 3);
+    auto b2 = ASDX_SWIZZLE(b, 1, 2, 0, 3);
+    return _mm_sub_ps(_mm_mul_ps(a1, b1), _mm_mul_ps(a2, b2));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      3x3行列と平行移動から逆行列の平行移動成分を求めます.
+//!
+//! @param [in]     i0          逆行列の1行目(w = 0).
+//! @param [in]     i1          逆行列の2行目(w = 0).
+//! @param [in]     i2          逆行列の3行目(w = 0).
+//! @param [in]     t           元の行列の平行移動成分.
+//! @return     -(t.x * i0 + t.y * i1 + t.z * i2) に w = 1 を設定した値を返却します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdInvertTranslation(__m128 i0, __m128 i1, __m128 i2, __m128 t)
+{
+    auto r = _mm_mul_ps(ASDX_SPLAT(t, 0), i0);
+    r = _mm_add_ps(r, _mm_mul_ps(ASDX_SPLAT(t, 1), i1));
+    r = _mm_add_ps(r, _mm_mul_ps(ASDX_SPLAT(t, 2), i2));
+    r = _mm_xor_ps(r, _mm_setr_ps(-0.0f, -0.0f, -0.0f, 0.0f));
+    r = _mm_and_ps(r, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+    return _mm_or_ps(r, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      アフィン変換行列の逆行列を求めます.
+//!
+//! @param [in]     r0          行列の1行目(w = 0).
+//! @param [in]     r1          行列の2行目(w = 0).
+//! @param [in]     r2          行列の3行目(w = 0).
+//! @param [in]     r3          行列の4行目(平行移動成分).
+//! @param [out]    result      逆行列の格納先(4要素 x 4行).
+//! @return     左上3x3の行列式を返却します.
+//! @note       3x3部分を外積による余因子で求めるため, 4x4の逆行列より大幅に安価です.
+//-----------------------------------------------------------------------------
+inline float SimdInvertAffine(__m128 r0, __m128 r1, __m128 r2, __m128 r3, __m128* result)
+{
+    auto c0 = SimdCross3(r1, r2);
+    auto c1 = SimdCross3(r2, r0);
+    auto c2 = SimdCross3(r0, r1);
+
+    auto d   = _mm_mul_ps(r0, c0);
+    auto det = _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(d, ASDX_SPLAT(d, 1)), ASDX_SPLAT(d, 2)));
+    auto rcpDet = _mm_set1_ps(1.0f / det);
+
+    // 余因子を転置する.
+    auto zero = _mm_setzero_ps();
+    auto t0 = _mm_unpacklo_ps(c0, c1);
+    auto t1 = _mm_unpackhi_ps(c0, c1);
+    auto t2 = _mm_unpacklo_ps(c2, zero);
+    auto t3 = _mm_unpackhi_ps(c2, zero);
+
+    // 行列式が負の場合に w が -0 にならないように, スカラー版と同じ +0 に戻す.
+    auto mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    result[0] = _mm_and_ps(_mm_mul_ps(_mm_movelh_ps(t0, t2), rcpDet), mask);
+    result[1] = _mm_and_ps(_mm_mul_ps(_mm_movehl_ps(t2, t0), rcpDet), mask);
+    result[2] = _mm_and_ps(_mm_mul_ps(_mm_movelh_ps(t1, t3), rcpDet), mask);
+    result[3] = SimdInvertTranslation(result[0], result[1], result[2], r3);
+
+    return det;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      剛体変換行列の逆行列を求めます.
+//!
+//! @param [in]     r0          行列の1行目(w = 0).
+//! @param [in]     r1          行列の2行目(w = 0).
+//! @param [in]     r2          行列の3行目(w = 0).
+//! @param [in]     r3          行列の4行目(平行移動成分).
+//! @param [out]    result      逆行列の格納先(4要素 x 4行).
+//! @note       左上3x3が正規直交であることを前提に転置で求めます.
+//-----------------------------------------------------------------------------
+inline void SimdInvertRigid(__m128 r0, __m128 r1, __m128 r2, __m128 r3, __m128* result)
+{
+    auto zero = _mm_setzero_ps();
+    auto t0 = _mm_unpacklo_ps(r0, r1);
+    auto t1 = _mm_unpackhi_ps(r0, r1);
+    auto t2 = _mm_unpacklo_ps(r2, zero);
+    auto t3 = _mm_unpackhi_ps(r2, zero);
+
+    result[0] = _mm_movelh_ps(t0, t2);
+    result[1] = _mm_movehl_ps(t2, t0);
+    result[2] = _mm_movelh_ps(t1, t3);
+    result[3] = SimdInvertTranslation(result[0], result[1], result[2], r3);
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      3x4アフィン変換行列を連結します.
+//!
+//! @param [in]     a0          先に適用する行列の1行目.
+//! @param [in]     a1          先に適用する行列の2行目.
+//! @param [in]     a2          先に適用する行列の3行目.
+//! @param [in]     b           後から適用する行列の行.
+//! @return     連結した行列の b に対応する行を返却します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdConcat3x4(__m128 a0, __m128 a1, __m128 a2, __m128 b)
+{
+    auto r = _mm_mul_ps(ASDX_SPLAT(b, 0), a0);
+    r = _mm_add_ps(r, _mm_mul_ps(ASDX_SPLAT(b, 1), a1));
+    r = _mm_add_ps(r, _mm_mul_ps(ASDX_SPLAT(b, 2), a2));
+
+    // 平行移動成分はwのみに加算する.
+    auto mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    auto w    = _mm_add_ps(r, b);
+    return _mm_or_ps(_mm_and_ps(mask, r), _mm_andnot_ps(mask, w));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      3x4アフィン変換行列の逆行列を求めます.
+//!
+//! @param [in]     r0          行列の1行目(wは平行移動成分).
+//! @param [in]     r1          行列の2行目(wは平行移動成分).
+//! @param [in]     r2          行列の3行目(wは平行移動成分).
+//! @param [out]    result      逆行列の格納先(4要素 x 3行).
+//! @return     左上3x3の行列式を返却します.
+//-----------------------------------------------------------------------------
+inline float SimdInvertAffine3x4(__m128 r0, __m128 r1, __m128 r2, __m128* result)
+{
+    // 列ベクトル形式なので, 余因子がそのまま逆行列の列になる.
+    auto c0 = SimdCross3(r1, r2);
+    auto c1 = SimdCross3(r2, r0);
+    auto c2 = SimdCross3(r0, r1);
+
+    auto d   = _mm_mul_ps(r0, c0);
+    auto det = _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(d, ASDX_SPLAT(d, 1)), ASDX_SPLAT(d, 2)));
+    auto rcpDet = _mm_set1_ps(1.0f / det);
+
+    c0 = _mm_mul_ps(c0, rcpDet);
+    c1 = _mm_mul_ps(c1, rcpDet);
+    c2 = _mm_mul_ps(c2, rcpDet);
+
+    auto t = _mm_mul_ps(ASDX_SPLAT(r0, 3), c0);
+    t = _mm_add_ps(t, _mm_mul_ps(ASDX_SPLAT(r1, 3), c1));
+    t = _mm_add_ps(t, _mm_mul_ps(ASDX_SPLAT(r2, 3), c2));
+    t = _mm_xor_ps(t, _mm_set1_ps(-0.0f));
+
+    auto t0 = _mm_unpacklo_ps(c0, c1);
+    auto t1 = _mm_unpackhi_ps(c0, c1);
+    auto t2 = _mm_unpacklo_ps(c2, t);
+    auto t3 = _mm_unpackhi_ps(c2, t);
+
+    result[0] = _mm_movelh_ps(t0, t2);
+    result[1] = _mm_movehl_ps(t2, t0);
+    result[2] = _mm_movelh_ps(t1, t3);
+
+    return det;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      3x4剛体変換行列の逆行列を求めます.
+//!
+//! @param [in]     r0          行列の1行目(wは平行移動成分).
+//! @param [in]     r1          行列の2行目(wは平行移動成分).
+//! @param [in]     r2          行列の3行目(wは平行移動成分).
+//! @param [out]    result      逆行列の格納先(4要素 x 3行).
+//-----------------------------------------------------------------------------
+inline void SimdInvertRigid3x4(__m128 r0, __m128 r1, __m128 r2, __m128* result)
+{
+    auto t = _mm_mul_ps(ASDX_SPLAT(r0, 3), r0);
+    t = _mm_add_ps(t, _mm_mul_ps(ASDX_SPLAT(r1, 3), r1));
+    t = _mm_add_ps(t, _mm_mul_ps(ASDX_SPLAT(r2, 3), r2));
+    t = _mm_xor_ps(t, _mm_set1_ps(-0.0f));
+
+    auto t0 = _mm_unpacklo_ps(r0, r1);
+    auto t1 = _mm_unpackhi_ps(r0, r1);
+    auto t2 = _mm_unpacklo_ps(r2, t);
+    auto t3 = _mm_unpackhi_ps(r2, t);
+
+    result[0] = _mm_movelh_ps(t0, t2);
+    result[1] = _mm_movehl_ps(t2, t0);
+    result[2] = _mm_movelh_ps(t1, t3);
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      四元数同士を乗算します.
+//!
+//! @param [in]     a       入力値(x, y, z, w).
+//! @param [in]     b       入力値(x, y, z, w).
+//! @return     Quaternion::Multiply(a, b) と同じ結果を返却します.
+//! @note       加算順序のみスカラー版と異なり, 差は成分ごとの積の絶対値の和の 2 ULP 以内です.
+//-----------------------------------------------------------------------------
+inline __m128 SimdQuaternionMultiply(__m128 a, __m128 b)
+{
+    const auto signX = _mm_castsi128_ps(_mm_setr_epi32(0, 0, int(0x80000000), int(0x80000000)));
+    const auto signY = _mm_castsi128_ps(_mm_setr_epi32(int(0x80000000), 0, 0, int(0x80000000)));
+    const auto signZ = _mm_castsi128_ps(_mm_setr_epi32(0, int(0x80000000), 0, int(0x80000000)));
+
+    auto result = _mm_mul_ps(ASDX_SPLAT(a, 3), b);
+    result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(ASDX_SPLAT(a, 0), ASDX_SWIZZLE(b, 3, 2, 1, 0)), signX));
+    result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(ASDX_SPLAT(a, 1), ASDX_SWIZZLE(b, 2, 3, 0, 1)), signY));
+    result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(ASDX_SPLAT(a, 2), ASDX_SWIZZLE(b, 1, 0, 3, 2)), signZ));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      3成分ベクトル4個を読み込み, SoA形式に変換します.
+//!
+//! @param [in]     pSrc        先頭要素へのポインタ.
+//! @param [in]     stride      要素間のバイト数.
+//! @param [out]    x           X成分.
+//! @param [out]    y           Y成分.
+//! @param [out]    z           Z成分.
+//-----------------------------------------------------------------------------
+inline void SimdLoadFloat3x4(const void* pSrc, size_t stride, __m128& x, __m128& y, __m128& z)
+{
+    auto p = static_cast<const uint8_t*>(pSrc);
+    if (stride == sizeof(float) * 3)
+    {
+        // 密に並んでいる場合は3回のロードとシャッフルで転置する.
+        auto f  = reinterpret_cast<const float*>(p);
+        auto v0 = _mm_loadu_ps(f + 0);    // x0 y0 z0 x1
+        auto v1 = _mm_loadu_ps(f + 4);    // y1 z1 x2 y2
+        auto v2 = _mm_loadu_ps(f + 8);    // z2 x3 y3 z3
+
+        x = ASDX_SHUFFLE(v0, ASDX_SHUFFLE(v1, v2, 2, 2, 1, 1), 0, 3, 0, 2);
+        y = ASDX_SHUFFLE(ASDX_SHUFFLE(v0, v1, 1, 1, 0, 0), ASDX_SHUFFLE(v1, v2, 3, 3, 2, 2), 0, 2, 0, 2);
+        z = ASDX_SHUFFLE(ASDX_SHUFFLE(v0, v1, 2, 2, 1, 1), v2, 0, 2, 0, 3);
+        return;
+    }
+
+    auto f0 = reinterpret_cast<const float*>(p);
+    auto f1 = reinterpret_cast<const float*>(p + stride);
+    auto f2 = reinterpret_cast<const float*>(p + stride * 2);
+    auto f3 = reinterpret_cast<const float*>(p + stride * 3);
+    x = _mm_setr_ps(f0[0], f1[0], f2[0], f3[0]);
+    y = _mm_setr_ps(f0[1], f1[1], f2[1], f3[1]);
+    z = _mm_setr_ps(f0[2], f1[2], f2[2], f3[2]);
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      SoA形式の3成分ベクトル4個を書き込みます.
+//!
+//! @param [out]    pDst        先頭要素へのポインタ.
+//! @param [in]     stride      要素間のバイト数.
+//! @param [in]     x           X成分.
+//! @param [in]     y           Y成分.
+//! @param [in]     z           Z成分.
+//-----------------------------------------------------------------------------
+inline void SimdStoreFloat3x4(void* pDst, size_t stride, __m128 x, __m128 y, __m128 z)
+{
+    auto p = static_cast<uint8_t*>(pDst);
+    if (stride == sizeof(float) * 3)
+    {
+        auto f  = reinterpret_cast<float*>(p);
+        auto o0 = ASDX_SHUFFLE(_mm_unpacklo_ps(x, y), ASDX_SHUFFLE(z, x, 0, 0, 1, 1), 0, 1, 0, 2);
+        auto o1 = ASDX_SHUFFLE(ASDX_SHUFFLE(y, z, 1, 1, 1, 1), _mm_unpackhi_ps(x, y), 0, 2, 0, 1);
+        auto o2 = ASDX_SHUFFLE(ASDX_SHUFFLE(z, x, 2, 2, 3, 3), ASDX_SHUFFLE(y, z, 3, 3, 3, 3), 0, 2, 0, 2);
+        _mm_storeu_ps(f + 0, o0);
+        _mm_storeu_ps(f + 4, o1);
+        _mm_storeu_ps(f + 8, o2);
+        return;
+    }
+
+    alignas(16) float tx[4];
+    alignas(16) float ty[4];
+    alignas(16) float tz[4];
+    _mm_store_ps(tx, x);
+    _mm_store_ps(ty, y);
+    _mm_store_ps(tz, z);
+
+    for(auto i=0; i<4; ++i)
+    {
+        auto f = reinterpret_cast<float*>(p + stride * i);
+        f[0] = tx[i];
+        f[1] = ty[i];
+        f[2] = tz[i];
+    }
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      単精度浮動小数4個を半精度浮動小数に変換します.
+//!
+//! @param [in]     value       変換する値.
+//! @return     各32bitレーンの下位16bitに変換結果を格納して返却します.
+//!             上位16bitは符号拡張されるため, _mm_packs_epi32() でそのまま詰められます.
+//! @note       最近接偶数丸めで変換し, 表現できない値は無限大, NaNは上位ビットを残した quiet NaN になります.
+//-----------------------------------------------------------------------------
+inline __m128i SimdFloatToHalf(__m128 value)
+{
+    const auto signMask     = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+    const auto halfMax      = _mm_set1_epi32(0x477FF000);   // これ以上は無限大に丸められる.
+    const auto minNormal    = _mm_set1_epi32(0x38800000);   // 正規化数になる最小値.
+    const auto subnormMagic = _mm_set1_epi32(0x3F000000);   // 0.5f.
+    const auto normalBias   = _mm_set1_epi32(0x00000FFF - 0x38000000);
+
+    auto sign    = _mm_and_ps(value, signMask);
+    auto absf    = _mm_xor_ps(value, sign);
+    auto absi    = _mm_castps_si128(absf);
+
+    // 無限大とNaN.
+    auto isNaN   = _mm_castps_si128(_mm_cmpunord_ps(absf, absf));
+    auto payload = _mm_or_si128(_mm_set1_epi32(0x200), _mm_and_si128(_mm_srli_epi32(absi, 13), _mm_set1_epi32(0x3FF)));
+    auto special = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(isNaN, payload));
+
+    // 非正規化数は加算時の丸めを利用する.
+    auto subnorm = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(subnormMagic))), subnormMagic);
+
+    // 正規化数は指数部を再バイアスして最近接偶数丸めを行う.
+    auto odd     = _mm_srai_epi32(_mm_slli_epi32(absi, 31 - 13), 31);
+    auto normal  = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absi, normalBias), odd), 13);
+
+    auto isSub     = _mm_cmpgt_epi32(minNormal, absi);
+    auto isRegular = _mm_cmpgt_epi32(halfMax, absi);
+    auto result    = _mm_or_si128(_mm_and_si128(isSub, subnorm), _mm_andnot_si128(isSub, normal));
+    result = _mm_or_si128(_mm_and_si128(isRegular, result), _mm_andnot_si128(isRegular, special));
+
+    return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      半精度浮動小数4個を単精度浮動小数に変換します.
+//!
+//! @param [in]     value       各32bitレーンの下位16bitに半精度浮動小数を格納した値.
+//! @return     変換結果を返却します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdHalfToFloat(__m128i value)
+{
+    const auto expMask  = _mm_set1_epi32(0x7C00 << 13);
+    const auto magic    = _mm_castsi128_ps(_mm_set1_epi32(113 << 23));   // 2^-14.
+
+    auto bits   = _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x7FFF)), 13);
+    auto exp    = _mm_and_si128(bits, expMask);
+    bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+    // 無限大とNaNは指数部を最大にし, NaNは quiet NaN にする.
+    auto isInfNaN = _mm_cmpeq_epi32(exp, expMask);
+    auto isNaN    = _mm_and_si128(isInfNaN, _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x47800000)));
+    bits = _mm_add_epi32(bits, _mm_and_si128(isInfNaN, _mm_set1_epi32((128 - 16) << 23)));
+    bits = _mm_or_si128(bits, _mm_and_si128(isNaN, _mm_set1_epi32(0x00400000)));
+
+    // 非正規化数は正規化数として解釈してから差し引く.
+    auto isSub  = _mm_cmpeq_epi32(exp, _mm_setzero_si128());
+    auto sub    = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))), magic);
+    auto result = _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(isSub), sub), _mm_andnot_ps(_mm_castsi128_ps(isSub), _mm_castsi128_ps(bits)));
+
+    return _mm_or_ps(result, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x8000)), 16)));
+}
+
+} // namespace asdx
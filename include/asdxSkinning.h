@@ -0,0 +1,77 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxSkinning.h
+// Desc : CPU Skinning.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxMath.h>
+#include <asdxResModel.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t     SKINNING_PARALLEL_THRESHOLD = 8192;     //!< 1スレッドあたりの最小頂点数.
+
+///////////////////////////////////////////////////////////////////////////////
+// SkinningSource structure
+///////////////////////////////////////////////////////////////////////////////
+struct SkinningSource
+{
+    const Vector3*          pPositions      = nullptr;  //!< 頂点座標(必須).
+    const Vector3*          pNormals        = nullptr;  //!< 法線ベクトル(任意).
+    const Vector3*          pTangents       = nullptr;  //!< 接線ベクトル(任意).
+    const Vector3*          pBitangents     = nullptr;  //!< 従接線ベクトル(任意, TBN圧縮時の利き手判定に使用).
+    const ResBoneIndex*     pBoneIndices    = nullptr;  //!< ボーン番号(必須).
+    const Vector4*          pBoneWeights    = nullptr;  //!< ボーンの重み(必須).
+    size_t                  VertexCount     = 0;        //!< 頂点数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SkinningTarget structure
+///////////////////////////////////////////////////////////////////////////////
+struct SkinningTarget
+{
+    Vector3*        pPositions  = nullptr;  //!< スキニング後の頂点座標(任意).
+    Vector3*        pNormals    = nullptr;  //!< スキニング後の正規化された法線ベクトル(任意, 入力の法線が必要).
+    Vector3*        pTangents   = nullptr;  //!< スキニング後の正規化された接線ベクトル(任意, 入力の接線が必要).
+    uint32_t*       pEncodedTBN = nullptr;  //!< EncodeTBN() 形式の接線空間(任意, 入力の法線と接線が必要).
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      メッシュからスキニングの入力を設定します.
+//!
+//! @param[in]      mesh        ボーン番号とボーンの重みを持つメッシュ.
+//! @return     メッシュの配列を参照する入力を返却します. 空の属性は nullptr になります.
+//!             ボーン番号とボーンの重みが頂点数と一致しない場合は, それらも nullptr になります.
+//-----------------------------------------------------------------------------
+SkinningSource GetSkinningSource(const ResMesh& mesh);
+
+//-----------------------------------------------------------------------------
+//! @brief      頂点をスキニングします.
+//!
+//! @param[in]      pPalette        ボーン行列パレット.
+//! @param[in]      boneCount       ボーン行列の数.
+//! @param[in]      source          入力頂点データ.
+//! @param[out]     target          出力先. nullptr の出力先は書き込みを行いません.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @retval true    スキニングに成功.
+//! @retval false   入力が不正, またはボーン番号が boneCount 以上. 出力先には何も書き込みません.
+//! @note       4本のボーン行列を重み付きで合成してから変換します.
+//!             法線と接線は合成行列の3x3部分で変換するため, 非一様スケールは考慮しません.
+//!             頂点範囲ごとに分割して並列処理を行います.
+//-----------------------------------------------------------------------------
+bool SkinVertices(
+    const Matrix34*         pPalette,
+    uint32_t                boneCount,
+    const SkinningSource&   source,
+    const SkinningTarget&   target,
+    uint32_t                maxThreadCount = 1);
+
+} // namespace asdx
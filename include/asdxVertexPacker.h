@@ -0,0 +1,124 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxVertexPacker.h
+// Desc : Quantized Vertex Stream Packer.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <asdxResModel.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   VERTEX_PACK_MAX_ELEMENTS    = 6 + MAX_LAYER_COUNT;  //!< 頂点要素の最大数.
+
+///////////////////////////////////////////////////////////////////////////////
+// VERTEX_FORMAT enum
+///////////////////////////////////////////////////////////////////////////////
+enum VERTEX_FORMAT
+{
+    VERTEX_FORMAT_NONE = 0,     //!< 出力しない.
+    VERTEX_FORMAT_FLOAT2,       //!< 32bit浮動小数 x 2 (DXGI_FORMAT_R32G32_FLOAT).
+    VERTEX_FORMAT_FLOAT3,       //!< 32bit浮動小数 x 3 (DXGI_FORMAT_R32G32B32_FLOAT).
+    VERTEX_FORMAT_FLOAT4,       //!< 32bit浮動小数 x 4 (DXGI_FORMAT_R32G32B32A32_FLOAT).
+    VERTEX_FORMAT_HALF2,        //!< 16bit浮動小数 x 2 (DXGI_FORMAT_R16G16_FLOAT).
+    VERTEX_FORMAT_UNORM16X4,    //!< 16bit符号無し正規化整数 x 4 (DXGI_FORMAT_R16G16B16A16_UNORM).
+    VERTEX_FORMAT_UNORM8X4,     //!< 8bit符号無し正規化整数 x 4 (DXGI_FORMAT_R8G8B8A8_UNORM).
+    VERTEX_FORMAT_UINT16X4,     //!< 16bit符号無し整数 x 4 (DXGI_FORMAT_R16G16B16A16_UINT).
+    VERTEX_FORMAT_UINT8X4,      //!< 8bit符号無し整数 x 4 (DXGI_FORMAT_R8G8B8A8_UINT).
+    VERTEX_FORMAT_UINT32,       //!< 32bit符号無し整数 (DXGI_FORMAT_R32_UINT).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// VertexPackDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct VertexPackDesc
+{
+    VERTEX_FORMAT   Position    = VERTEX_FORMAT_UNORM16X4;  //!< 位置座標(FLOAT3, UNORM16X4).
+    VERTEX_FORMAT   Normal      = VERTEX_FORMAT_UINT32;     //!< 法線と接線(FLOAT3, UINT32 は EncodeTBN() 形式).
+    VERTEX_FORMAT   Color       = VERTEX_FORMAT_UNORM8X4;   //!< 頂点カラー(FLOAT4, UNORM8X4).
+    VERTEX_FORMAT   TexCoord    = VERTEX_FORMAT_HALF2;      //!< テクスチャ座標(FLOAT2, HALF2).
+    VERTEX_FORMAT   BoneIndex   = VERTEX_FORMAT_UINT16X4;   //!< ボーン番号(UINT16X4, UINT8X4).
+    VERTEX_FORMAT   BoneWeight  = VERTEX_FORMAT_UNORM8X4;   //!< ボーンの重み(FLOAT4, UNORM16X4, UNORM8X4).
+    bool            Interleaved = true;                     //!< true なら1ストリームにインターリーブ, false なら要素ごとに分割します.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// VertexElement structure
+///////////////////////////////////////////////////////////////////////////////
+struct VertexElement
+{
+    const char*     SemanticName    = "";                   //!< セマンティクス名.
+    uint32_t        SemanticIndex   = 0;                    //!< セマンティクス番号.
+    VERTEX_FORMAT   Format          = VERTEX_FORMAT_NONE;   //!< フォーマット.
+    uint32_t        InputSlot       = 0;                    //!< ストリーム番号.
+    uint32_t        Offset          = 0;                    //!< ストリーム先頭からのバイトオフセット.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PackedVertexStream structure
+///////////////////////////////////////////////////////////////////////////////
+struct PackedVertexStream
+{
+    uint32_t                Stride  = 0;    //!< 1頂点あたりのバイト数.
+    std::vector<uint8_t>    Data;           //!< 頂点データ.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PackedVertices structure
+///////////////////////////////////////////////////////////////////////////////
+struct PackedVertices
+{
+    uint32_t                        VertexCount     = 0;    //!< 頂点数.
+    std::vector<VertexElement>      Elements;               //!< 入力レイアウト.
+    std::vector<PackedVertexStream> Streams;                //!< 頂点ストリーム.
+    Vector3                         PositionScale;          //!< 位置座標の逆量子化スケール.
+    Vector3                         PositionBias;           //!< 位置座標の逆量子化バイアス.
+
+    //-------------------------------------------------------------------------
+    //! @brief      全ストリームの合計サイズを取得します.
+    //-------------------------------------------------------------------------
+    size_t GetSize() const
+    {
+        size_t result = 0;
+        for(auto& itr : Streams)
+        { result += itr.Data.size(); }
+        return result;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      フォーマットのバイト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetVertexFormatSize(VERTEX_FORMAT format);
+
+//-----------------------------------------------------------------------------
+//! @brief      メッシュの頂点ストリームを量子化してパッキングします.
+//!
+//! @param[in]      mesh            対象メッシュ.
+//! @param[in]      desc            パッキング設定.
+//! @param[out]     result          パッキング結果.
+//! @param[in]      maxThreadCount  最大スレッド数(0の場合は論理コア数, 1の場合はシングルスレッド).
+//! @retval true    パッキングに成功.
+//! @retval false   パッキングに失敗.
+//! @note       メッシュに無い属性は出力しません.
+//!             UNORM16X4 の位置座標はメッシュのバウンディングボックスで正規化され,
+//!             シェーダでは position = packed.xyz * PositionScale + PositionBias で復元します.
+//!             FLOAT3 の法線を指定した場合, 接線があれば TANGENT として FLOAT3 で出力します.
+//!             UINT32 の法線は EncodeTBN() 形式で, 接線が無い場合は法線から生成します.
+//-----------------------------------------------------------------------------
+bool PackVertices(
+    const ResMesh&          mesh,
+    const VertexPackDesc&   desc,
+    PackedVertices&         result,
+    uint32_t                maxThreadCount = 0);
+
+} // namespace asdx
@@ -0,0 +1,785 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxAnimation.cpp
+// Desc : Skeletal Animation.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <asdxAnimation.h>
+#include <asdxParallel.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t     MIN_BATCH_JOB_COUNT = 8;
+static constexpr float      ROTATION_MAX        = 0.70710678118654752f;    // 1 / sqrt(2).
+static constexpr float      ROTATION_STEP       = 2.0f * ROTATION_MAX / 32766.0f;    // 0 を正確に表現できるよう偶数段階にする.
+static constexpr uint32_t   ROTATION_MASK       = 0x7fff;
+
+// キーのチャンネル.
+static constexpr uint32_t   KEY_ROTATION_A      = 0;
+static constexpr uint32_t   KEY_ROTATION_B      = 1;
+static constexpr uint32_t   KEY_ROTATION_C      = 2;
+static constexpr uint32_t   KEY_TRANSLATION     = 3;
+static constexpr uint32_t   KEY_SCALE           = 6;
+
+// 範囲のチャンネル.
+static constexpr uint32_t   RANGE_TRANSLATION_MIN   = 0;
+static constexpr uint32_t   RANGE_TRANSLATION_STEP  = 3;
+static constexpr uint32_t   RANGE_SCALE_MIN         = 6;
+static constexpr uint32_t   RANGE_SCALE_STEP        = 9;
+
+// 球面線形補間の多項式近似係数.
+// D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP" を参照.
+static constexpr float      SLERP_MU = 1.85298109240830f;
+static constexpr float      SLERP_U[8] = {
+    1.0f / (1.0f * 3.0f), 1.0f / (2.0f * 5.0f), 1.0f / (3.0f * 7.0f), 1.0f / (4.0f * 9.0f),
+    1.0f / (5.0f * 11.0f), 1.0f / (6.0f * 13.0f), 1.0f / (7.0f * 15.0f), SLERP_MU / (8.0f * 17.0f)
+};
+static constexpr float      SLERP_V[8] = {
+    1.0f / 3.0f, 2.0f / 5.0f, 3.0f / 7.0f, 4.0f / 9.0f,
+    5.0f / 11.0f, 6.0f / 13.0f, 7.0f / 15.0f, SLERP_MU * 8.0f / 17.0f
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SampleFrame structure
+///////////////////////////////////////////////////////////////////////////////
+struct SampleFrame
+{
+    const uint16_t* pKey0;      // 補間元のキー.
+    const uint16_t* pKey1;      // 補間先のキー.
+    float           Amount;     // 補間係数.
+};
+
+//-----------------------------------------------------------------------------
+//      LaneCount を求めます.
+//-----------------------------------------------------------------------------
+inline uint32_t GetLaneCount(uint32_t boneCount)
+{ return (boneCount + asdx::ANIMATION_LANE_COUNT - 1) / asdx::ANIMATION_LANE_COUNT * asdx::ANIMATION_LANE_COUNT; }
+
+//-----------------------------------------------------------------------------
+//      値域で正規化して16bitに量子化します.
+//-----------------------------------------------------------------------------
+inline uint16_t QuantizeRange(float value, float minValue, float step)
+{
+    if (step <= 0.0f)
+    { return 0; }
+
+    auto q = std::round((value - minValue) / step);
+    return uint16_t(asdx::Clamp(q, 0.0f, 65535.0f));
+}
+
+//-----------------------------------------------------------------------------
+//      回転を最大成分を省いた3成分に量子化します.
+//-----------------------------------------------------------------------------
+inline void QuantizeRotation(const asdx::Quaternion& value, uint16_t* pKey, uint32_t stride)
+{
+    auto q = asdx::Quaternion::SafeNormalize(value, asdx::Quaternion::CreateIdentity());
+
+    float c[4] = { q.x, q.y, q.z, q.w };
+
+    uint32_t index = 0;
+    for(auto i=1u; i<4; ++i)
+    {
+        if (std::abs(c[i]) > std::abs(c[index]))
+        { index = i; }
+    }
+
+    // 省いた成分が正になるように符号を揃える(q と -q は同じ回転).
+    auto sign = (c[index] < 0.0f) ? -1.0f : 1.0f;
+
+    uint16_t bits[3];
+    for(auto i=0u, j=0u; i<4; ++i)
+    {
+        if (i == index)
+        { continue; }
+
+        auto v = std::round((c[i] * sign + ROTATION_MAX) / ROTATION_STEP);
+        bits[j++] = uint16_t(asdx::Clamp(v, 0.0f, 32766.0f));
+    }
+
+    pKey[KEY_ROTATION_A * stride] = uint16_t(bits[0] | ((index & 0x1) << 15));
+    pKey[KEY_ROTATION_B * stride] = uint16_t(bits[1] | ((index >> 1) << 15));
+    pKey[KEY_ROTATION_C * stride] = bits[2];
+}
+
+//-----------------------------------------------------------------------------
+//      サンプリングするフレームを求めます.
+//-----------------------------------------------------------------------------
+SampleFrame GetSampleFrame(const asdx::AnimationClip& clip, float time, bool loop)
+{
+    if (loop && clip.Duration > 0.0f)
+    {
+        time = std::fmod(time, clip.Duration);
+        if (time < 0.0f)
+        { time += clip.Duration; }
+    }
+
+    auto last = clip.FrameCount - 1;
+    auto pos  = asdx::Clamp(time * clip.FrameRate, 0.0f, float(last));
+
+    auto f0 = uint32_t(pos);
+    auto f1 = f0 + 1;
+    auto amount = pos - float(f0);
+    if (f0 >= last)
+    {
+        f0      = last;
+        f1      = last;
+        amount  = 0.0f;
+    }
+
+    auto frameSize = asdx::ANIMATION_KEY_CHANNELS * clip.LaneCount;
+
+    SampleFrame result;
+    result.pKey0  = clip.Keys.data() + f0 * frameSize;
+    result.pKey1  = clip.Keys.data() + f1 * frameSize;
+    result.Amount = amount;
+    return result;
+}
+
+#if defined(ASDX_ENABLE_SIMD)
+///////////////////////////////////////////////////////////////////////////////
+// SimdQuaternion4 structure
+///////////////////////////////////////////////////////////////////////////////
+struct SimdQuaternion4
+{
+    __m128 x;
+    __m128 y;
+    __m128 z;
+    __m128 w;
+};
+
+//-----------------------------------------------------------------------------
+//      16bit値を4つ読み込みます.
+//-----------------------------------------------------------------------------
+inline __m128i SimdLoadU16x4(const uint16_t* pSrc)
+{
+    auto v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc));
+    return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+}
+
+//-----------------------------------------------------------------------------
+//      量子化された回転を4つ復元します.
+//-----------------------------------------------------------------------------
+inline SimdQuaternion4 SimdDecodeRotation(const uint16_t* pKey, uint32_t stride)
+{
+    auto ra = SimdLoadU16x4(pKey + KEY_ROTATION_A * stride);
+    auto rb = SimdLoadU16x4(pKey + KEY_ROTATION_B * stride);
+    auto rc = SimdLoadU16x4(pKey + KEY_ROTATION_C * stride);
+
+    auto mask  = _mm_set1_epi32(ROTATION_MASK);
+    auto step  = _mm_set1_ps(ROTATION_STEP);
+    auto bias  = _mm_set1_ps(-ROTATION_MAX);
+    auto index = _mm_or_si128(_mm_srli_epi32(ra, 15), _mm_slli_epi32(_mm_srli_epi32(rb, 15), 1));
+
+    auto a = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(ra, mask)), step), bias);
+    auto b = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(rb, mask)), step), bias);
+    auto c = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(rc), step), bias);
+
+    auto sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+    auto d  = _mm_sqrt_ps(_mm_max_ps(_mm_setzero_ps(), _mm_sub_ps(_mm_set1_ps(1.0f), sq)));
+
+    auto k0 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(0)));
+    auto k1 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(1)));
+    auto k2 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(2)));
+    auto k3 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(3)));
+
+    SimdQuaternion4 result;
+    result.x = asdx::SimdSelect(k0, d, a);
+    result.y = asdx::SimdSelect(k0, a, asdx::SimdSelect(k1, d, b));
+    result.z = asdx::SimdSelect(_mm_or_ps(k0, k1), b, asdx::SimdSelect(k2, d, c));
+    result.w = asdx::SimdSelect(k3, d, c);
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      量子化された3成分を4つ復元します.
+//-----------------------------------------------------------------------------
+inline void SimdDecodeRange
+(
+    const uint16_t* pKey,
+    const float*    pMin,
+    const float*    pStep,
+    uint32_t        stride,
+    __m128*         pResult
+)
+{
+    for(auto i=0u; i<3; ++i)
+    {
+        auto q = _mm_cvtepi32_ps(SimdLoadU16x4(pKey + i * stride));
+        pResult[i] = _mm_add_ps(_mm_loadu_ps(pMin + i * stride), _mm_mul_ps(q, _mm_loadu_ps(pStep + i * stride)));
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      内積の符号に合わせて b を反転します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdAlignRotation(const SimdQuaternion4& a, SimdQuaternion4& b)
+{
+    auto d = _mm_mul_ps(a.x, b.x);
+    d = _mm_add_ps(d, _mm_mul_ps(a.y, b.y));
+    d = _mm_add_ps(d, _mm_mul_ps(a.z, b.z));
+    d = _mm_add_ps(d, _mm_mul_ps(a.w, b.w));
+
+    auto sign = _mm_and_ps(d, _mm_set1_ps(-0.0f));
+    b.x = _mm_xor_ps(b.x, sign);
+    b.y = _mm_xor_ps(b.y, sign);
+    b.z = _mm_xor_ps(b.z, sign);
+    b.w = _mm_xor_ps(b.w, sign);
+
+    return _mm_xor_ps(d, sign);
+}
+
+//-----------------------------------------------------------------------------
+//      正規化線形補間を4つ同時に行います.
+//-----------------------------------------------------------------------------
+inline SimdQuaternion4 SimdNlerp(const SimdQuaternion4& a, SimdQuaternion4 b, __m128 t)
+{
+    SimdAlignRotation(a, b);
+
+    SimdQuaternion4 r;
+    r.x = _mm_add_ps(a.x, _mm_mul_ps(_mm_sub_ps(b.x, a.x), t));
+    r.y = _mm_add_ps(a.y, _mm_mul_ps(_mm_sub_ps(b.y, a.y), t));
+    r.z = _mm_add_ps(a.z, _mm_mul_ps(_mm_sub_ps(b.z, a.z), t));
+    r.w = _mm_add_ps(a.w, _mm_mul_ps(_mm_sub_ps(b.w, a.w), t));
+
+    auto sq = _mm_mul_ps(r.x, r.x);
+    sq = _mm_add_ps(sq, _mm_mul_ps(r.y, r.y));
+    sq = _mm_add_ps(sq, _mm_mul_ps(r.z, r.z));
+    sq = _mm_add_ps(sq, _mm_mul_ps(r.w, r.w));
+
+    auto inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(sq));
+    r.x = _mm_mul_ps(r.x, inv);
+    r.y = _mm_mul_ps(r.y, inv);
+    r.z = _mm_mul_ps(r.z, inv);
+    r.w = _mm_mul_ps(r.w, inv);
+    return r;
+}
+
+//-----------------------------------------------------------------------------
+//      球面線形補間を4つ同時に行います.
+//-----------------------------------------------------------------------------
+inline SimdQuaternion4 SimdSlerp(const SimdQuaternion4& a, SimdQuaternion4 b, __m128 t)
+{
+    auto one  = _mm_set1_ps(1.0f);
+    auto xm1  = _mm_sub_ps(SimdAlignRotation(a, b), one);
+    auto d    = _mm_sub_ps(one, t);
+    auto sqrT = _mm_mul_ps(t, t);
+    auto sqrD = _mm_mul_ps(d, d);
+
+    auto cT = one;
+    auto cD = one;
+    for(auto i=7; i>=0; --i)
+    {
+        auto u = _mm_set1_ps(SLERP_U[i]);
+        auto v = _mm_set1_ps(SLERP_V[i]);
+        auto bT = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, sqrT), v), xm1);
+        auto bD = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, sqrD), v), xm1);
+        cT = _mm_add_ps(one, _mm_mul_ps(bT, cT));
+        cD = _mm_add_ps(one, _mm_mul_ps(bD, cD));
+    }
+    cT = _mm_mul_ps(cT, t);
+    cD = _mm_mul_ps(cD, d);
+
+    SimdQuaternion4 r;
+    r.x = _mm_add_ps(_mm_mul_ps(a.x, cD), _mm_mul_ps(b.x, cT));
+    r.y = _mm_add_ps(_mm_mul_ps(a.y, cD), _mm_mul_ps(b.y, cT));
+    r.z = _mm_add_ps(_mm_mul_ps(a.z, cD), _mm_mul_ps(b.z, cT));
+    r.w = _mm_add_ps(_mm_mul_ps(a.w, cD), _mm_mul_ps(b.w, cT));
+    return r;
+}
+#else
+//-----------------------------------------------------------------------------
+//      量子化された回転を復元します.
+//-----------------------------------------------------------------------------
+inline asdx::Quaternion DecodeRotation(const uint16_t* pKey, uint32_t stride)
+{
+    uint32_t ra = pKey[KEY_ROTATION_A * stride];
+    uint32_t rb = pKey[KEY_ROTATION_B * stride];
+    uint32_t rc = pKey[KEY_ROTATION_C * stride];
+
+    auto index = (ra >> 15) | ((rb >> 15) << 1);
+
+    auto a = float(ra & ROTATION_MASK) * ROTATION_STEP + -ROTATION_MAX;
+    auto b = float(rb & ROTATION_MASK) * ROTATION_STEP + -ROTATION_MAX;
+    auto c = float(rc) * ROTATION_STEP + -ROTATION_MAX;
+    auto d = std::sqrt(asdx::Max(0.0f, 1.0f - ((a * a + b * b) + c * c)));
+
+    switch(index)
+    {
+    case 0:  return asdx::Quaternion(d, a, b, c);
+    case 1:  return asdx::Quaternion(a, d, b, c);
+    case 2:  return asdx::Quaternion(a, b, d, c);
+    default: return asdx::Quaternion(a, b, c, d);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      内積の符号に合わせて b を反転します.
+//-----------------------------------------------------------------------------
+inline float AlignRotation(const asdx::Quaternion& a, asdx::Quaternion& b)
+{
+    auto d = ((a.x * b.x + a.y * b.y) + a.z * b.z) + a.w * b.w;
+    if (std::signbit(d))
+    {
+        b = -b;
+        d = -d;
+    }
+    return d;
+}
+
+//-----------------------------------------------------------------------------
+//      正規化線形補間を行います.
+//-----------------------------------------------------------------------------
+inline asdx::Quaternion Nlerp(const asdx::Quaternion& a, asdx::Quaternion b, float t)
+{
+    AlignRotation(a, b);
+
+    auto x = a.x + (b.x - a.x) * t;
+    auto y = a.y + (b.y - a.y) * t;
+    auto z = a.z + (b.z - a.z) * t;
+    auto w = a.w + (b.w - a.w) * t;
+
+    auto inv = 1.0f / std::sqrt(((x * x + y * y) + z * z) + w * w);
+    return asdx::Quaternion(x * inv, y * inv, z * inv, w * inv);
+}
+
+//-----------------------------------------------------------------------------
+//      球面線形補間を行います.
+//-----------------------------------------------------------------------------
+inline asdx::Quaternion Slerp(const asdx::Quaternion& a, asdx::Quaternion b, float t)
+{
+    auto xm1  = AlignRotation(a, b) - 1.0f;
+    auto d    = 1.0f - t;
+    auto sqrT = t * t;
+    auto sqrD = d * d;
+
+    auto cT = 1.0f;
+    auto cD = 1.0f;
+    for(auto i=7; i>=0; --i)
+    {
+        auto bT = (SLERP_U[i] * sqrT - SLERP_V[i]) * xm1;
+        auto bD = (SLERP_U[i] * sqrD - SLERP_V[i]) * xm1;
+        cT = 1.0f + bT * cT;
+        cD = 1.0f + bD * cD;
+    }
+    cT *= t;
+    cD *= d;
+
+    return asdx::Quaternion(
+        a.x * cD + b.x * cT,
+        a.y * cD + b.y * cT,
+        a.z * cD + b.z * cT,
+        a.w * cD + b.w * cT);
+}
+#endif//defined(ASDX_ENABLE_SIMD)
+
+} // namespace
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// AnimationPose structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      指定ボーン数で初期化します.
+//-----------------------------------------------------------------------------
+void AnimationPose::Init(uint32_t boneCount)
+{
+    BoneCount = boneCount;
+    LaneCount = GetLaneCount(boneCount);
+    Channels.assign(ANIMATION_POSE_CHANNELS * LaneCount, 0.0f);
+
+    // 単位姿勢で埋めておく.
+    std::fill_n(GetChannel(ANIMATION_POSE_ROTATION_W), LaneCount, 1.0f);
+    std::fill_n(GetChannel(ANIMATION_POSE_SCALE_X),    LaneCount, 1.0f);
+    std::fill_n(GetChannel(ANIMATION_POSE_SCALE_Y),    LaneCount, 1.0f);
+    std::fill_n(GetChannel(ANIMATION_POSE_SCALE_Z),    LaneCount, 1.0f);
+}
+
+//-----------------------------------------------------------------------------
+//      平行移動を取得します.
+//-----------------------------------------------------------------------------
+Vector3 AnimationPose::GetTranslation(uint32_t bone) const
+{
+    assert(bone < BoneCount);
+    return Vector3(
+        GetChannel(ANIMATION_POSE_TRANSLATION_X)[bone],
+        GetChannel(ANIMATION_POSE_TRANSLATION_Y)[bone],
+        GetChannel(ANIMATION_POSE_TRANSLATION_Z)[bone]);
+}
+
+//-----------------------------------------------------------------------------
+//      回転を取得します.
+//-----------------------------------------------------------------------------
+Quaternion AnimationPose::GetRotation(uint32_t bone) const
+{
+    assert(bone < BoneCount);
+    return Quaternion(
+        GetChannel(ANIMATION_POSE_ROTATION_X)[bone],
+        GetChannel(ANIMATION_POSE_ROTATION_Y)[bone],
+        GetChannel(ANIMATION_POSE_ROTATION_Z)[bone],
+        GetChannel(ANIMATION_POSE_ROTATION_W)[bone]);
+}
+
+//-----------------------------------------------------------------------------
+//      スケールを取得します.
+//-----------------------------------------------------------------------------
+Vector3 AnimationPose::GetScale(uint32_t bone) const
+{
+    assert(bone < BoneCount);
+    return Vector3(
+        GetChannel(ANIMATION_POSE_SCALE_X)[bone],
+        GetChannel(ANIMATION_POSE_SCALE_Y)[bone],
+        GetChannel(ANIMATION_POSE_SCALE_Z)[bone]);
+}
+
+//-----------------------------------------------------------------------------
+//      アニメーションクリップを圧縮します.
+//-----------------------------------------------------------------------------
+bool CompressAnimationClip(const ResAnimationClip& source, AnimationClip& result)
+{
+    auto keyCount = size_t(source.FrameCount) * source.BoneCount;
+    if (keyCount == 0 || source.FrameRate <= 0.0f)
+    { return false; }
+
+    if (source.Translations.size() != keyCount
+     || source.Rotations   .size() != keyCount
+     || source.Scales      .size() != keyCount)
+    { return false; }
+
+    auto laneCount = GetLaneCount(source.BoneCount);
+
+    result.Name       = source.Name;
+    result.FrameRate  = source.FrameRate;
+    result.Duration   = float(source.FrameCount - 1) / source.FrameRate;
+    result.FrameCount = source.FrameCount;
+    result.BoneCount  = source.BoneCount;
+    result.LaneCount  = laneCount;
+    result.Ranges.assign(ANIMATION_RANGE_CHANNELS * laneCount, 0.0f);
+    result.Keys  .assign(size_t(ANIMATION_KEY_CHANNELS) * laneCount * source.FrameCount, 0);
+
+    auto pRange = result.Ranges.data();
+
+    // ボーンごとに値域を求める.
+    for(auto bone=0u; bone<laneCount; ++bone)
+    {
+        if (bone >= source.BoneCount)
+        {
+            // 詰め物のレーンは単位スケールにする.
+            for(auto i=0u; i<3; ++i)
+            { pRange[(RANGE_SCALE_MIN + i) * laneCount + bone] = 1.0f; }
+            continue;
+        }
+
+        auto minT = source.Translations[bone];
+        auto maxT = source.Translations[bone];
+        auto minS = source.Scales[bone];
+        auto maxS = source.Scales[bone];
+        for(auto frame=1u; frame<source.FrameCount; ++frame)
+        {
+            auto index = size_t(frame) * source.BoneCount + bone;
+            minT = Vector3::Min(minT, source.Translations[index]);
+            maxT = Vector3::Max(maxT, source.Translations[index]);
+            minS = Vector3::Min(minS, source.Scales[index]);
+            maxS = Vector3::Max(maxS, source.Scales[index]);
+        }
+
+        auto stepT = (maxT - minT) / 65535.0f;
+        auto stepS = (maxS - minS) / 65535.0f;
+
+        for(auto i=0u; i<3; ++i)
+        {
+            pRange[(RANGE_TRANSLATION_MIN  + i) * laneCount + bone] = minT[i];
+            pRange[(RANGE_TRANSLATION_STEP + i) * laneCount + bone] = stepT[i];
+            pRange[(RANGE_SCALE_MIN        + i) * laneCount + bone] = minS[i];
+            pRange[(RANGE_SCALE_STEP       + i) * laneCount + bone] = stepS[i];
+        }
+    }
+
+    // キーを量子化する.
+    auto identity = Quaternion::CreateIdentity();
+    for(auto frame=0u; frame<source.FrameCount; ++frame)
+    {
+        auto pKey = result.Keys.data() + size_t(frame) * ANIMATION_KEY_CHANNELS * laneCount;
+        for(auto bone=0u; bone<laneCount; ++bone)
+        {
+            if (bone >= source.BoneCount)
+            {
+                QuantizeRotation(identity, pKey + bone, laneCount);
+                continue;
+            }
+
+            auto index = size_t(frame) * source.BoneCount + bone;
+            QuantizeRotation(source.Rotations[index], pKey + bone, laneCount);
+
+            auto& t = source.Translations[index];
+            auto& s = source.Scales[index];
+            for(auto i=0u; i<3; ++i)
+            {
+                pKey[(KEY_TRANSLATION + i) * laneCount + bone] = QuantizeRange(t[i],
+                    pRange[(RANGE_TRANSLATION_MIN  + i) * laneCount + bone],
+                    pRange[(RANGE_TRANSLATION_STEP + i) * laneCount + bone]);
+                pKey[(KEY_SCALE + i) * laneCount + bone] = QuantizeRange(s[i],
+                    pRange[(RANGE_SCALE_MIN  + i) * laneCount + bone],
+                    pRange[(RANGE_SCALE_STEP + i) * laneCount + bone]);
+            }
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      アニメーションをサンプリングします.
+//-----------------------------------------------------------------------------
+void SampleAnimation
+(
+    const AnimationClip&    clip,
+    float                   time,
+    bool                    loop,
+    ANIMATION_INTERPOLATION interpolation,
+    AnimationPose&          pose
+)
+{
+    if (pose.BoneCount != clip.BoneCount)
+    { pose.Init(clip.BoneCount); }
+
+    if (clip.FrameCount == 0)
+    { return; }
+
+    auto frame  = GetSampleFrame(clip, time, loop);
+    auto stride = clip.LaneCount;
+    auto pRange = clip.Ranges.data();
+
+    float* pT[3];
+    float* pR[4];
+    float* pS[3];
+    for(auto i=0u; i<3; ++i)
+    {
+        pT[i] = pose.GetChannel(ANIMATION_POSE_TRANSLATION_X + i);
+        pS[i] = pose.GetChannel(ANIMATION_POSE_SCALE_X + i);
+    }
+    for(auto i=0u; i<4; ++i)
+    { pR[i] = pose.GetChannel(ANIMATION_POSE_ROTATION_X + i); }
+
+#if defined(ASDX_ENABLE_SIMD)
+    auto amount = _mm_set1_ps(frame.Amount);
+
+    for(auto lane=0u; lane<stride; lane+=ANIMATION_LANE_COUNT)
+    {
+        auto pKey0 = frame.pKey0 + lane;
+        auto pKey1 = frame.pKey1 + lane;
+
+        auto q0 = SimdDecodeRotation(pKey0, stride);
+        auto q1 = SimdDecodeRotation(pKey1, stride);
+        auto q  = (interpolation == ANIMATION_INTERPOLATION_SLERP)
+            ? SimdSlerp(q0, q1, amount)
+            : SimdNlerp(q0, q1, amount);
+        _mm_storeu_ps(pR[0] + lane, q.x);
+        _mm_storeu_ps(pR[1] + lane, q.y);
+        _mm_storeu_ps(pR[2] + lane, q.z);
+        _mm_storeu_ps(pR[3] + lane, q.w);
+
+        __m128 t0[3], t1[3], s0[3], s1[3];
+        SimdDecodeRange(pKey0 + KEY_TRANSLATION * stride, pRange + RANGE_TRANSLATION_MIN * stride + lane, pRange + RANGE_TRANSLATION_STEP * stride + lane, stride, t0);
+        SimdDecodeRange(pKey1 + KEY_TRANSLATION * stride, pRange + RANGE_TRANSLATION_MIN * stride + lane, pRange + RANGE_TRANSLATION_STEP * stride + lane, stride, t1);
+        SimdDecodeRange(pKey0 + KEY_SCALE * stride, pRange + RANGE_SCALE_MIN * stride + lane, pRange + RANGE_SCALE_STEP * stride + lane, stride, s0);
+        SimdDecodeRange(pKey1 + KEY_SCALE * stride, pRange + RANGE_SCALE_MIN * stride + lane, pRange + RANGE_SCALE_STEP * stride + lane, stride, s1);
+
+        for(auto i=0u; i<3; ++i)
+        {
+            _mm_storeu_ps(pT[i] + lane, _mm_add_ps(t0[i], _mm_mul_ps(_mm_sub_ps(t1[i], t0[i]), amount)));
+            _mm_storeu_ps(pS[i] + lane, _mm_add_ps(s0[i], _mm_mul_ps(_mm_sub_ps(s1[i], s0[i]), amount)));
+        }
+    }
+#else
+    auto amount = frame.Amount;
+
+    for(auto lane=0u; lane<stride; ++lane)
+    {
+        auto pKey0 = frame.pKey0 + lane;
+        auto pKey1 = frame.pKey1 + lane;
+
+        auto q0 = DecodeRotation(pKey0, stride);
+        auto q1 = DecodeRotation(pKey1, stride);
+        auto q  = (interpolation == ANIMATION_INTERPOLATION_SLERP)
+            ? Slerp(q0, q1, amount)
+            : Nlerp(q0, q1, amount);
+        pR[0][lane] = q.x;
+        pR[1][lane] = q.y;
+        pR[2][lane] = q.z;
+        pR[3][lane] = q.w;
+
+        for(auto i=0u; i<3; ++i)
+        {
+            auto minT  = pRange[(RANGE_TRANSLATION_MIN  + i) * stride + lane];
+            auto stepT = pRange[(RANGE_TRANSLATION_STEP + i) * stride + lane];
+            auto minS  = pRange[(RANGE_SCALE_MIN  + i) * stride + lane];
+            auto stepS = pRange[(RANGE_SCALE_STEP + i) * stride + lane];
+
+            auto t0 = minT + float(pKey0[(KEY_TRANSLATION + i) * stride]) * stepT;
+            auto t1 = minT + float(pKey1[(KEY_TRANSLATION + i) * stride]) * stepT;
+            auto s0 = minS + float(pKey0[(KEY_SCALE + i) * stride]) * stepS;
+            auto s1 = minS + float(pKey1[(KEY_SCALE + i) * stride]) * stepS;
+
+            pT[i][lane] = t0 + (t1 - t0) * amount;
+            pS[i][lane] = s0 + (s1 - s0) * amount;
+        }
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+}
+
+//-----------------------------------------------------------------------------
+//      複数のアニメーションをまとめてサンプリングします.
+//-----------------------------------------------------------------------------
+void SampleAnimations
+(
+    const AnimationSampleJob*   pJobs,
+    size_t                      count,
+    uint32_t                    maxThreadCount
+)
+{
+    assert(pJobs != nullptr || count == 0);
+
+    // 出力先はジョブごとに異なるため, スレッド間で書き込みが競合することは無い.
+    ParallelFor(count, MIN_BATCH_JOB_COUNT,
+        [&](uint32_t, size_t begin, size_t end)
+        {
+            for(auto i=begin; i<end; ++i)
+            {
+                auto& job = pJobs[i];
+                assert(job.pClip != nullptr);
+                assert(job.pPose != nullptr);
+                SampleAnimation(*job.pClip, job.Time, job.Loop, job.Interpolation, *job.pPose);
+            }
+        },
+        maxThreadCount);
+}
+
+//-----------------------------------------------------------------------------
+//      姿勢をブレンドします.
+//-----------------------------------------------------------------------------
+void BlendPoses
+(
+    const AnimationPose&    a,
+    const AnimationPose&    b,
+    float                   weight,
+    AnimationPose&          result
+)
+{
+    assert(a.BoneCount == b.BoneCount);
+    if (result.BoneCount != a.BoneCount)
+    { result.Init(a.BoneCount); }
+
+    auto stride = a.LaneCount;
+    auto pA = a.Channels.data();
+    auto pB = b.Channels.data();
+    auto pR = result.Channels.data();
+
+#if defined(ASDX_ENABLE_SIMD)
+    auto amount = _mm_set1_ps(weight);
+
+    for(auto lane=0u; lane<stride; lane+=ANIMATION_LANE_COUNT)
+    {
+        SimdQuaternion4 qa, qb;
+        qa.x = _mm_loadu_ps(pA + ANIMATION_POSE_ROTATION_X * stride + lane);
+        qa.y = _mm_loadu_ps(pA + ANIMATION_POSE_ROTATION_Y * stride + lane);
+        qa.z = _mm_loadu_ps(pA + ANIMATION_POSE_ROTATION_Z * stride + lane);
+        qa.w = _mm_loadu_ps(pA + ANIMATION_POSE_ROTATION_W * stride + lane);
+        qb.x = _mm_loadu_ps(pB + ANIMATION_POSE_ROTATION_X * stride + lane);
+        qb.y = _mm_loadu_ps(pB + ANIMATION_POSE_ROTATION_Y * stride + lane);
+        qb.z = _mm_loadu_ps(pB + ANIMATION_POSE_ROTATION_Z * stride + lane);
+        qb.w = _mm_loadu_ps(pB + ANIMATION_POSE_ROTATION_W * stride + lane);
+
+        auto q = SimdNlerp(qa, qb, amount);
+        _mm_storeu_ps(pR + ANIMATION_POSE_ROTATION_X * stride + lane, q.x);
+        _mm_storeu_ps(pR + ANIMATION_POSE_ROTATION_Y * stride + lane, q.y);
+        _mm_storeu_ps(pR + ANIMATION_POSE_ROTATION_Z * stride + lane, q.z);
+        _mm_storeu_ps(pR + ANIMATION_POSE_ROTATION_W * stride + lane, q.w);
+
+        const uint32_t channels[] = {
+            ANIMATION_POSE_TRANSLATION_X, ANIMATION_POSE_TRANSLATION_Y, ANIMATION_POSE_TRANSLATION_Z,
+            ANIMATION_POSE_SCALE_X, ANIMATION_POSE_SCALE_Y, ANIMATION_POSE_SCALE_Z
+        };
+        for(auto c : channels)
+        {
+            auto va = _mm_loadu_ps(pA + c * stride + lane);
+            auto vb = _mm_loadu_ps(pB + c * stride + lane);
+            _mm_storeu_ps(pR + c * stride + lane, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), amount)));
+        }
+    }
+#else
+    for(auto lane=0u; lane<stride; ++lane)
+    {
+        Quaternion qa(
+            pA[ANIMATION_POSE_ROTATION_X * stride + lane],
+            pA[ANIMATION_POSE_ROTATION_Y * stride + lane],
+            pA[ANIMATION_POSE_ROTATION_Z * stride + lane],
+            pA[ANIMATION_POSE_ROTATION_W * stride + lane]);
+        Quaternion qb(
+            pB[ANIMATION_POSE_ROTATION_X * stride + lane],
+            pB[ANIMATION_POSE_ROTATION_Y * stride + lane],
+            pB[ANIMATION_POSE_ROTATION_Z * stride + lane],
+            pB[ANIMATION_POSE_ROTATION_W * stride + lane]);
+
+        auto q = Nlerp(qa, qb, weight);
+        pR[ANIMATION_POSE_ROTATION_X * stride + lane] = q.x;
+        pR[ANIMATION_POSE_ROTATION_Y * stride + lane] = q.y;
+        pR[ANIMATION_POSE_ROTATION_Z * stride + lane] = q.z;
+        pR[ANIMATION_POSE_ROTATION_W * stride + lane] = q.w;
+
+        const uint32_t channels[] = {
+            ANIMATION_POSE_TRANSLATION_X, ANIMATION_POSE_TRANSLATION_Y, ANIMATION_POSE_TRANSLATION_Z,
+            ANIMATION_POSE_SCALE_X, ANIMATION_POSE_SCALE_Y, ANIMATION_POSE_SCALE_Z
+        };
+        for(auto c : channels)
+        {
+            auto va = pA[c * stride + lane];
+            auto vb = pB[c * stride + lane];
+            pR[c * stride + lane] = va + (vb - va) * weight;
+        }
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+}
+
+//-----------------------------------------------------------------------------
+//      局所姿勢から局所変換行列を求めます.
+//-----------------------------------------------------------------------------
+void CalcLocalMatrices(const AnimationPose& pose, Matrix34* pResult)
+{
+    assert(pResult != nullptr || pose.BoneCount == 0);
+
+    for(auto i=0u; i<pose.BoneCount; ++i)
+    {
+        auto t = pose.GetTranslation(i);
+        auto q = pose.GetRotation(i);
+        auto s = pose.GetScale(i);
+
+        auto xx = q.x * q.x;
+        auto yy = q.y * q.y;
+        auto zz = q.z * q.z;
+        auto xy = q.x * q.y;
+        auto zw = q.z * q.w;
+        auto zx = q.z * q.x;
+        auto yw = q.y * q.w;
+        auto yz = q.y * q.z;
+        auto xw = q.x * q.w;
+
+        // 列ベクトル形式の回転行列に右からスケールを掛ける.
+        pResult[i] = Matrix34(
+            (1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy - zw) * s.y, 2.0f * (zx + yw) * s.z, t.x,
+            2.0f * (xy + zw) * s.x, (1.0f - 2.0f * (zz + xx)) * s.y, 2.0f * (yz - xw) * s.z, t.y,
+            2.0f * (zx - yw) * s.x, 2.0f * (yz + xw) * s.y, (1.0f - 2.0f * (xx + yy)) * s.z, t.z);
+    }
+}
+
+} // namespace asdx
@@ -0,0 +1,249 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxBounds.cpp
+// Desc : Bounding Volumes.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxBounds.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr float SAT_EPSILON = 1e-6f;     // 平行な軸の外積がゼロになる場合の誤差.
+
+//-----------------------------------------------------------------------------
+//      ストライド付き配列の要素を取得します.
+//-----------------------------------------------------------------------------
+inline const asdx::Vector3& GetPoint(const asdx::Vector3* pPoints, size_t stride, size_t index)
+{ return *reinterpret_cast<const asdx::Vector3*>(reinterpret_cast<const uint8_t*>(pPoints) + index * stride); }
+
+//-----------------------------------------------------------------------------
+//      行列の行を正規化して軸と長さを求めます.
+//-----------------------------------------------------------------------------
+inline void ExtractAxis(const asdx::Vector3& row, const asdx::Vector3& fallback, asdx::Vector3& axis, float& length)
+{
+    length = row.Length();
+    axis   = (length > 0.0f) ? row / length : fallback;
+}
+
+} // namespace
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingSphere structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      点群を包含する境界球を生成します.
+//-----------------------------------------------------------------------------
+BoundingSphere BoundingSphere::CreateFromPoints(const Vector3* pPoints, size_t count, size_t stride)
+{
+    assert(pPoints != nullptr || count == 0);
+
+    if (count == 0)
+    { return BoundingSphere(); }
+
+    // 各軸で最小/最大となる点を求める.
+    size_t minIndex[3] = {};
+    size_t maxIndex[3] = {};
+    for(size_t i=1; i<count; ++i)
+    {
+        auto& p = GetPoint(pPoints, stride, i);
+        for(auto j=0; j<3; ++j)
+        {
+            if (p[j] < GetPoint(pPoints, stride, minIndex[j])[j]) { minIndex[j] = i; }
+            if (p[j] > GetPoint(pPoints, stride, maxIndex[j])[j]) { maxIndex[j] = i; }
+        }
+    }
+
+    // 最も離れた組を初期の直径とする.
+    auto axis = 0;
+    auto dist = -1.0f;
+    for(auto j=0; j<3; ++j)
+    {
+        auto d = Vector3::DistanceSq(GetPoint(pPoints, stride, minIndex[j]), GetPoint(pPoints, stride, maxIndex[j]));
+        if (d > dist)
+        {
+            dist = d;
+            axis = j;
+        }
+    }
+
+    auto& a = GetPoint(pPoints, stride, minIndex[axis]);
+    auto& b = GetPoint(pPoints, stride, maxIndex[axis]);
+    auto center = (a + b) * 0.5f;
+    auto radius = sqrt(dist) * 0.5f;
+
+    // 外側の点を含むように拡張する.
+    for(size_t i=0; i<count; ++i)
+    {
+        auto& p  = GetPoint(pPoints, stride, i);
+        auto  d2 = Vector3::DistanceSq(p, center);
+        if (d2 > radius * radius)
+        {
+            auto d = sqrt(d2);
+            auto r = (radius + d) * 0.5f;
+            center += (p - center) * ((r - radius) / d);
+            radius = r;
+        }
+    }
+
+    return BoundingSphere(center, radius);
+}
+
+//-----------------------------------------------------------------------------
+//      2つの境界球を包含する最小の境界球を求めます.
+//-----------------------------------------------------------------------------
+BoundingSphere BoundingSphere::Merge(const BoundingSphere& a, const BoundingSphere& b)
+{
+    auto v = b.Center - a.Center;
+    auto d = v.Length();
+
+    // 一方が他方を包含する場合.
+    if (a.Radius >= d + b.Radius)
+    { return a; }
+    if (b.Radius >= d + a.Radius)
+    { return b; }
+
+    auto r = (d + a.Radius + b.Radius) * 0.5f;
+    return BoundingSphere(a.Center + v * ((r - a.Radius) / d), r);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// OrientedBox structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      有向境界箱と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+bool OrientedBox::Intersects(const OrientedBox& box) const
+{
+    // Christer Ericson, "Real-Time Collision Detection", 4.4.1.
+    auto& ea = Extents;
+    auto& eb = box.Extents;
+
+    // box の軸を this の局所空間で表す.
+    float R[3][3];
+    float AbsR[3][3];
+    for(auto i=0; i<3; ++i)
+    {
+        for(auto j=0; j<3; ++j)
+        {
+            R[i][j]    = Vector3::Dot(Axis[i], box.Axis[j]);
+            AbsR[i][j] = fabsf(R[i][j]) + SAT_EPSILON;
+        }
+    }
+
+    auto v = box.Center - Center;
+    float t[3] = {
+        Vector3::Dot(v, Axis[0]),
+        Vector3::Dot(v, Axis[1]),
+        Vector3::Dot(v, Axis[2])
+    };
+
+    // this の軸.
+    for(auto i=0; i<3; ++i)
+    {
+        auto ra = ea[i];
+        auto rb = eb.x * AbsR[i][0] + eb.y * AbsR[i][1] + eb.z * AbsR[i][2];
+        if (fabsf(t[i]) > ra + rb)
+        { return false; }
+    }
+
+    // box の軸.
+    for(auto j=0; j<3; ++j)
+    {
+        auto ra = ea.x * AbsR[0][j] + ea.y * AbsR[1][j] + ea.z * AbsR[2][j];
+        auto rb = eb[j];
+        if (fabsf(t[0] * R[0][j] + t[1] * R[1][j] + t[2] * R[2][j]) > ra + rb)
+        { return false; }
+    }
+
+    // 軸の外積.
+    for(auto i=0; i<3; ++i)
+    {
+        auto i1 = (i + 1) % 3;
+        auto i2 = (i + 2) % 3;
+        for(auto j=0; j<3; ++j)
+        {
+            auto j1 = (j + 1) % 3;
+            auto j2 = (j + 2) % 3;
+            auto ra = ea[i1] * AbsR[i2][j] + ea[i2] * AbsR[i1][j];
+            auto rb = eb[j1] * AbsR[i][j2] + eb[j2] * AbsR[i][j1];
+            if (fabsf(t[i2] * R[i1][j] - t[i1] * R[i2][j]) > ra + rb)
+            { return false; }
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      局所空間の境界箱をワールド空間に変換した有向境界箱を生成します.
+//-----------------------------------------------------------------------------
+OrientedBox OrientedBox::CreateFromBox(const BoundingBox& box, const Matrix& matrix)
+{
+    assert(!box.IsEmpty());
+
+    OrientedBox result;
+    result.Center = Vector3::Transform(box.GetCenter(), matrix);
+
+    float scale[3];
+    ExtractAxis(Vector3(matrix._11, matrix._12, matrix._13), Vector3(1.0f, 0.0f, 0.0f), result.Axis[0], scale[0]);
+    ExtractAxis(Vector3(matrix._21, matrix._22, matrix._23), Vector3(0.0f, 1.0f, 0.0f), result.Axis[1], scale[1]);
+    ExtractAxis(Vector3(matrix._31, matrix._32, matrix._33), Vector3(0.0f, 0.0f, 1.0f), result.Axis[2], scale[2]);
+
+    auto extents = box.GetExtents();
+    result.Extents = Vector3(extents.x * scale[0], extents.y * scale[1], extents.z * scale[2]);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      有向境界箱を変換します.
+//-----------------------------------------------------------------------------
+OrientedBox OrientedBox::Transform(const OrientedBox& box, const Matrix& matrix)
+{
+    OrientedBox result;
+    result.Center = Vector3::Transform(box.Center, matrix);
+
+    for(auto i=0; i<3; ++i)
+    {
+        float scale;
+        ExtractAxis(Vector3::TransformNormal(box.Axis[i], matrix), box.Axis[i], result.Axis[i], scale);
+        result.Extents[i] = box.Extents[i] * scale;
+    }
+
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Frustum structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      視錐台を変換します.
+//-----------------------------------------------------------------------------
+Frustum Frustum::Transform(const Frustum& frustum, const Matrix& matrix)
+{
+    // 平面は逆転置行列で変換する.
+    auto m = Matrix::Transpose(Matrix::Invert(matrix));
+
+    Frustum result;
+    for(auto i=0u; i<FRUSTUM_PLANE_COUNT; ++i)
+    { result.Planes[i] = NormalizePlane(Vector4::Transform(frustum.Planes[i], m)); }
+
+    return result;
+}
+
+} // namespace asdx
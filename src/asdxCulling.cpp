@@ -0,0 +1,284 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxCulling.cpp
+// Desc : Frustum Culling.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <asdxCulling.h>
+#include <asdxParallel.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t MIN_BATCH_WORD_COUNT = asdx::CULLING_PARALLEL_THRESHOLD / 32;
+
+//-----------------------------------------------------------------------------
+//      立っているビット数を数えます.
+//-----------------------------------------------------------------------------
+inline uint32_t CountBits(uint32_t value)
+{
+    value = value - ((value >> 1) & 0x55555555u);
+    value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+    value = (value + (value >> 4)) & 0x0f0f0f0fu;
+    return (value * 0x01010101u) >> 24;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球が平面の表側にあるかどうか判定します.
+//-----------------------------------------------------------------------------
+inline bool TestSphere(const asdx::Vector4* planes, float x, float y, float z, float r)
+{
+    for(auto i=0u; i<asdx::CULLING_PLANE_COUNT; ++i)
+    {
+        auto& p = planes[i];
+        if (!(p.x * x + p.y * y + p.z * z + p.w >= -r))
+        { return false; }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱が平面の表側にあるかどうか判定します.
+//-----------------------------------------------------------------------------
+inline bool TestBox(const asdx::Vector4* planes, const asdx::CullingBoxes& boxes, size_t index)
+{
+    for(auto i=0u; i<asdx::CULLING_PLANE_COUNT; ++i)
+    {
+        // 法線方向に最も遠い頂点で判定する.
+        auto& p = planes[i];
+        auto x = (p.x >= 0.0f) ? boxes.pMaxX[index] : boxes.pMinX[index];
+        auto y = (p.y >= 0.0f) ? boxes.pMaxY[index] : boxes.pMinY[index];
+        auto z = (p.z >= 0.0f) ? boxes.pMaxZ[index] : boxes.pMinZ[index];
+        if (!(p.x * x + p.y * y + p.z * z + p.w >= 0.0f))
+        { return false; }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      指定ワード範囲の境界球を判定します.
+//-----------------------------------------------------------------------------
+size_t CullSpheresRange
+(
+    const asdx::Vector4*        planes,
+    const asdx::CullingSpheres& spheres,
+    size_t                      count,
+    uint32_t*                   pVisibleMask,
+    size_t                      wordBegin,
+    size_t                      wordEnd
+)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    __m128 nx[asdx::CULLING_PLANE_COUNT];
+    __m128 ny[asdx::CULLING_PLANE_COUNT];
+    __m128 nz[asdx::CULLING_PLANE_COUNT];
+    __m128 nw[asdx::CULLING_PLANE_COUNT];
+    for(auto i=0u; i<asdx::CULLING_PLANE_COUNT; ++i)
+    {
+        nx[i] = _mm_set1_ps(planes[i].x);
+        ny[i] = _mm_set1_ps(planes[i].y);
+        nz[i] = _mm_set1_ps(planes[i].z);
+        nw[i] = _mm_set1_ps(planes[i].w);
+    }
+    const auto signMask = _mm_set1_ps(-0.0f);
+    const auto allOne   = _mm_castsi128_ps(_mm_set1_epi32(-1));
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    size_t visibleCount = 0;
+
+    for(auto w=wordBegin; w<wordEnd; ++w)
+    {
+        auto begin = w * 32;
+        auto end   = (begin + 32 < count) ? begin + 32 : count;
+        auto i     = begin;
+
+        uint32_t mask = 0;
+
+    #if defined(ASDX_ENABLE_SIMD)
+        for(; i + 4 <= end; i += 4)
+        {
+            auto cx = _mm_loadu_ps(spheres.pCenterX + i);
+            auto cy = _mm_loadu_ps(spheres.pCenterY + i);
+            auto cz = _mm_loadu_ps(spheres.pCenterZ + i);
+            auto nr = _mm_xor_ps(_mm_loadu_ps(spheres.pRadius + i), signMask);
+
+            auto visible = allOne;
+            for(auto j=0u; j<asdx::CULLING_PLANE_COUNT; ++j)
+            {
+                auto d = _mm_mul_ps(nx[j], cx);
+                d = _mm_add_ps(d, _mm_mul_ps(ny[j], cy));
+                d = _mm_add_ps(d, _mm_mul_ps(nz[j], cz));
+                d = _mm_add_ps(d, nw[j]);
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(d, nr));
+            }
+
+            mask |= uint32_t(_mm_movemask_ps(visible)) << (i - begin);
+        }
+    #endif//defined(ASDX_ENABLE_SIMD)
+
+        for(; i<end; ++i)
+        {
+            if (TestSphere(planes, spheres.pCenterX[i], spheres.pCenterY[i], spheres.pCenterZ[i], spheres.pRadius[i]))
+            { mask |= 1u << (i - begin); }
+        }
+
+        pVisibleMask[w] = mask;
+        visibleCount += CountBits(mask);
+    }
+
+    return visibleCount;
+}
+
+//-----------------------------------------------------------------------------
+//      指定ワード範囲の境界箱を判定します.
+//-----------------------------------------------------------------------------
+size_t CullBoxesRange
+(
+    const asdx::Vector4*        planes,
+    const asdx::CullingBoxes&   boxes,
+    size_t                      count,
+    uint32_t*                   pVisibleMask,
+    size_t                      wordBegin,
+    size_t                      wordEnd
+)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    // 平面ごとに法線の符号で最大側/最小側の配列を選んでおく.
+    const float* px[asdx::CULLING_PLANE_COUNT];
+    const float* py[asdx::CULLING_PLANE_COUNT];
+    const float* pz[asdx::CULLING_PLANE_COUNT];
+    __m128 nx[asdx::CULLING_PLANE_COUNT];
+    __m128 ny[asdx::CULLING_PLANE_COUNT];
+    __m128 nz[asdx::CULLING_PLANE_COUNT];
+    __m128 nw[asdx::CULLING_PLANE_COUNT];
+    for(auto i=0u; i<asdx::CULLING_PLANE_COUNT; ++i)
+    {
+        px[i] = (planes[i].x >= 0.0f) ? boxes.pMaxX : boxes.pMinX;
+        py[i] = (planes[i].y >= 0.0f) ? boxes.pMaxY : boxes.pMinY;
+        pz[i] = (planes[i].z >= 0.0f) ? boxes.pMaxZ : boxes.pMinZ;
+        nx[i] = _mm_set1_ps(planes[i].x);
+        ny[i] = _mm_set1_ps(planes[i].y);
+        nz[i] = _mm_set1_ps(planes[i].z);
+        nw[i] = _mm_set1_ps(planes[i].w);
+    }
+    const auto zero   = _mm_setzero_ps();
+    const auto allOne = _mm_castsi128_ps(_mm_set1_epi32(-1));
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    size_t visibleCount = 0;
+
+    for(auto w=wordBegin; w<wordEnd; ++w)
+    {
+        auto begin = w * 32;
+        auto end   = (begin + 32 < count) ? begin + 32 : count;
+        auto i     = begin;
+
+        uint32_t mask = 0;
+
+    #if defined(ASDX_ENABLE_SIMD)
+        for(; i + 4 <= end; i += 4)
+        {
+            auto visible = allOne;
+            for(auto j=0u; j<asdx::CULLING_PLANE_COUNT; ++j)
+            {
+                auto d = _mm_mul_ps(nx[j], _mm_loadu_ps(px[j] + i));
+                d = _mm_add_ps(d, _mm_mul_ps(ny[j], _mm_loadu_ps(py[j] + i)));
+                d = _mm_add_ps(d, _mm_mul_ps(nz[j], _mm_loadu_ps(pz[j] + i)));
+                d = _mm_add_ps(d, nw[j]);
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(d, zero));
+            }
+
+            mask |= uint32_t(_mm_movemask_ps(visible)) << (i - begin);
+        }
+    #endif//defined(ASDX_ENABLE_SIMD)
+
+        for(; i<end; ++i)
+        {
+            if (TestBox(planes, boxes, i))
+            { mask |= 1u << (i - begin); }
+        }
+
+        pVisibleMask[w] = mask;
+        visibleCount += CountBits(mask);
+    }
+
+    return visibleCount;
+}
+
+//-----------------------------------------------------------------------------
+//      ワード単位で分割して判定処理を実行します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+size_t DispatchCulling(size_t count, uint32_t maxThreadCount, Func func)
+{
+    auto wordCount = asdx::GetCullingMaskWordCount(count);
+    if (maxThreadCount == 1 || count < asdx::CULLING_PARALLEL_THRESHOLD)
+    { return func(size_t(0), wordCount); }
+
+    // ワード単位で分割するため, スレッド間で同じワードに書き込むことは無い.
+    std::vector<size_t> counts(asdx::GetWorkerThreadCount(maxThreadCount), 0);
+    auto batchCount = asdx::ParallelFor(wordCount, MIN_BATCH_WORD_COUNT,
+        [&](uint32_t batchIndex, size_t begin, size_t end)
+        { counts[batchIndex] = func(begin, end); },
+        maxThreadCount);
+
+    size_t visibleCount = 0;
+    for(auto i=0u; i<batchCount; ++i)
+    { visibleCount += counts[i]; }
+
+    return visibleCount;
+}
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      境界球を視錐台カリングします.
+//-----------------------------------------------------------------------------
+size_t CullSpheres
+(
+    const Vector4*          planes,
+    const CullingSpheres&   spheres,
+    size_t                  count,
+    uint32_t*               pVisibleMask,
+    uint32_t                maxThreadCount
+)
+{
+    assert(planes       != nullptr);
+    assert(pVisibleMask != nullptr || count == 0);
+
+    return DispatchCulling(count, maxThreadCount,
+        [&](size_t wordBegin, size_t wordEnd)
+        { return CullSpheresRange(planes, spheres, count, pVisibleMask, wordBegin, wordEnd); });
+}
+
+//-----------------------------------------------------------------------------
+//      軸並行境界箱を視錐台カリングします.
+//-----------------------------------------------------------------------------
+size_t CullBoxes
+(
+    const Vector4*          planes,
+    const CullingBoxes&     boxes,
+    size_t                  count,
+    uint32_t*               pVisibleMask,
+    uint32_t                maxThreadCount
+)
+{
+    assert(planes       != nullptr);
+    assert(pVisibleMask != nullptr || count == 0);
+
+    return DispatchCulling(count, maxThreadCount,
+        [&](size_t wordBegin, size_t wordEnd)
+        { return CullBoxesRange(planes, boxes, count, pVisibleMask, wordBegin, wordEnd); });
+}
+
+} // namespace asdx
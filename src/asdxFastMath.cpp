@@ -0,0 +1,403 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxFastMath.cpp
+// Desc : Fast Approximation Math Functions.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxFastMath.h>
+
+
+namespace {
+
+#if defined(ASDX_ENABLE_SIMD)
+//-----------------------------------------------------------------------------
+//      多項式を評価します.
+//-----------------------------------------------------------------------------
+template<size_t N>
+inline __m128 SimdPolynomial(__m128 x, const float (&coef)[N])
+{
+    auto p = _mm_set1_ps(coef[N - 1]);
+    for(auto i=N - 1; i>0; --i)
+    { p = _mm_add_ps(_mm_set1_ps(coef[i - 1]), _mm_mul_ps(x, p)); }
+    return p;
+}
+
+//-----------------------------------------------------------------------------
+//      ゼロからの距離に応じて 0.5 を加減算して整数に切り捨てます.
+//-----------------------------------------------------------------------------
+inline __m128i SimdRoundToInt(__m128 value)
+{
+    const auto sign = _mm_set1_ps(-0.0f);
+    auto half = _mm_or_ps(_mm_set1_ps(0.5f), _mm_and_ps(value, sign));
+    return _mm_cvttps_epi32(_mm_add_ps(value, half));
+}
+
+//-----------------------------------------------------------------------------
+//      正弦と余弦を求めます.
+//-----------------------------------------------------------------------------
+template<size_t NS, size_t NC, bool Est>
+inline void SimdSinCos
+(
+    __m128          radian,
+    const float     (&sinCoef)[NS],
+    const float     (&cosCoef)[NC],
+    __m128&         s,
+    __m128&         c
+)
+{
+    using namespace asdx::fast;
+
+    auto qi = SimdRoundToInt(_mm_mul_ps(radian, _mm_set1_ps(F_2DIVPI)));
+    auto q  = _mm_cvtepi32_ps(qi);
+    auto r  = _mm_sub_ps(radian, _mm_mul_ps(q, _mm_set1_ps(PIDIV2_HI)));
+    r  = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PIDIV2_MID)));
+    r  = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PIDIV2_LO)));
+
+    auto r2 = _mm_mul_ps(r, r);
+    auto vs = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), SimdPolynomial(r2, sinCoef)));
+    auto vc = (Est)
+        ? _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, SimdPolynomial(r2, cosCoef)))
+        : _mm_add_ps(
+            _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)),
+            _mm_mul_ps(_mm_mul_ps(r2, r2), SimdPolynomial(r2, cosCoef)));
+
+    // 奇数象限は入れ替え, 符号は象限のビットから求める.
+    const auto one = _mm_set1_epi32(1);
+    const auto two = _mm_set1_epi32(2);
+    auto swap    = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(qi, one), one));
+    auto sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(qi, two), 30));
+    auto cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(qi, one), two), 30));
+
+    s = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, vc), _mm_andnot_ps(swap, vs)), sinSign);
+    c = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, vs), _mm_andnot_ps(swap, vc)), cosSign);
+}
+
+//-----------------------------------------------------------------------------
+//      指数を整数部と小数部に分けます.
+//-----------------------------------------------------------------------------
+inline __m128 SimdSplitExponent(__m128 value, __m128& scale)
+{
+    auto x = _mm_max_ps(_mm_min_ps(value, _mm_set1_ps(127.0f)), _mm_set1_ps(-126.0f));
+    auto n = SimdRoundToInt(x);
+    scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    return _mm_sub_ps(x, _mm_cvtepi32_ps(n));
+}
+
+//-----------------------------------------------------------------------------
+//      仮数部と指数部に分けます.
+//-----------------------------------------------------------------------------
+inline __m128 SimdSplitMantissa(__m128 value, __m128& exponent)
+{
+    auto bits = _mm_castps_si128(value);
+    auto e = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff)), _mm_set1_epi32(127));
+    auto m = _mm_castsi128_ps(_mm_or_si128(
+        _mm_and_si128(bits, _mm_set1_epi32(0x7fffff)),
+        _mm_set1_epi32(0x3f800000)));
+
+    auto mask = _mm_cmpgt_ps(m, _mm_set1_ps(asdx::fast::F_SQRT2));
+    m = _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(m, _mm_set1_ps(0.5f))), _mm_andnot_ps(mask, m));
+    e = _mm_sub_epi32(e, _mm_castps_si128(mask));   // mask は -1 なので減算で1を加える.
+
+    exponent = _mm_cvtepi32_ps(e);
+    return m;
+}
+
+//-----------------------------------------------------------------------------
+//      逆正接を求めます.
+//-----------------------------------------------------------------------------
+template<size_t N>
+inline __m128 SimdAtan2(__m128 y, __m128 x, const float (&coef)[N])
+{
+    const auto abs  = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const auto zero = _mm_setzero_ps();
+
+    auto ax = _mm_and_ps(x, abs);
+    auto ay = _mm_and_ps(y, abs);
+    auto swapped = _mm_cmplt_ps(ax, ay);
+    auto mn = _mm_or_ps(_mm_and_ps(swapped, ax), _mm_andnot_ps(swapped, ay));
+    auto mx = _mm_or_ps(_mm_and_ps(swapped, ay), _mm_andnot_ps(swapped, ax));
+    auto r  = _mm_and_ps(_mm_div_ps(mn, mx), _mm_cmpgt_ps(mx, zero));
+    auto a  = _mm_mul_ps(r, SimdPolynomial(_mm_mul_ps(r, r), coef));
+
+    auto t = _mm_sub_ps(_mm_set1_ps(asdx::F_PIDIV2), a);
+    a = _mm_or_ps(_mm_and_ps(swapped, t), _mm_andnot_ps(swapped, a));
+
+    auto negX = _mm_cmplt_ps(x, zero);
+    t = _mm_sub_ps(_mm_set1_ps(asdx::F_PI), a);
+    a = _mm_or_ps(_mm_and_ps(negX, t), _mm_andnot_ps(negX, a));
+
+    auto negY = _mm_cmplt_ps(y, zero);
+    return _mm_xor_ps(a, _mm_and_ps(negY, _mm_set1_ps(-0.0f)));
+}
+
+//-----------------------------------------------------------------------------
+//      逆余弦を求めます.
+//-----------------------------------------------------------------------------
+template<size_t N>
+inline __m128 SimdAcos(__m128 value, const float (&coef)[N])
+{
+    auto x  = _mm_max_ps(_mm_min_ps(value, _mm_set1_ps(1.0f)), _mm_set1_ps(-1.0f));
+    auto ax = _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+    auto r  = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), ax)), SimdPolynomial(ax, coef));
+
+    auto neg = _mm_cmplt_ps(x, _mm_setzero_ps());
+    auto t = _mm_sub_ps(_mm_set1_ps(asdx::F_PI), r);
+    return _mm_or_ps(_mm_and_ps(neg, t), _mm_andnot_ps(neg, r));
+}
+#endif//defined(ASDX_ENABLE_SIMD)
+
+//-----------------------------------------------------------------------------
+//      配列の各要素に関数を適用します.
+//-----------------------------------------------------------------------------
+template<typename SimdFunc, typename ScalarFunc>
+void Transform
+(
+    const float*    pValue,
+    float*          pResult,
+    size_t          count,
+    SimdFunc        simdFunc,
+    ScalarFunc      scalarFunc
+)
+{
+    assert(count == 0 || (pValue != nullptr && pResult != nullptr));
+
+    size_t i = 0;
+#if defined(ASDX_ENABLE_SIMD)
+    for(; i + 4 <= count; i += 4)
+    { _mm_storeu_ps(pResult + i, simdFunc(_mm_loadu_ps(pValue + i))); }
+#else
+    (void)simdFunc;
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    for(; i<count; ++i)
+    { pResult[i] = scalarFunc(pValue[i]); }
+}
+
+//-----------------------------------------------------------------------------
+//      配列の正弦と余弦を求めます.
+//-----------------------------------------------------------------------------
+template<bool Est>
+void SinCosArray(const float* pRadian, float* pSin, float* pCos, size_t count)
+{
+    using namespace asdx::fast;
+    assert(count == 0 || pRadian != nullptr);
+
+    size_t i = 0;
+#if defined(ASDX_ENABLE_SIMD)
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128 s, c;
+        if (Est)
+        { SimdSinCos<2, 2, true>(_mm_loadu_ps(pRadian + i), SIN_EST_COEF, COS_EST_COEF, s, c); }
+        else
+        { SimdSinCos<3, 3, false>(_mm_loadu_ps(pRadian + i), SIN_COEF, COS_COEF, s, c); }
+
+        if (pSin != nullptr) { _mm_storeu_ps(pSin + i, s); }
+        if (pCos != nullptr) { _mm_storeu_ps(pCos + i, c); }
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    for(; i<count; ++i)
+    {
+        float s, c;
+        if (Est)
+        { SinCosEst(pRadian[i], s, c); }
+        else
+        { SinCos(pRadian[i], s, c); }
+
+        if (pSin != nullptr) { pSin[i] = s; }
+        if (pCos != nullptr) { pCos[i] = c; }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      配列の逆正接を求めます.
+//-----------------------------------------------------------------------------
+template<bool Est>
+void Atan2Array(const float* pY, const float* pX, float* pResult, size_t count)
+{
+    using namespace asdx::fast;
+    assert(count == 0 || (pY != nullptr && pX != nullptr && pResult != nullptr));
+
+    size_t i = 0;
+#if defined(ASDX_ENABLE_SIMD)
+    for(; i + 4 <= count; i += 4)
+    {
+        auto y = _mm_loadu_ps(pY + i);
+        auto x = _mm_loadu_ps(pX + i);
+        _mm_storeu_ps(pResult + i, (Est) ? SimdAtan2(y, x, ATAN_EST_COEF) : SimdAtan2(y, x, ATAN_COEF));
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    for(; i<count; ++i)
+    { pResult[i] = (Est) ? Atan2Est(pY[i], pX[i]) : Atan2(pY[i], pX[i]); }
+}
+
+} // namespace
+
+
+namespace asdx {
+namespace fast {
+
+//-----------------------------------------------------------------------------
+//      配列の正弦と余弦を低精度で求めます.
+//-----------------------------------------------------------------------------
+void SinCosEst(const float* pRadian, float* pSin, float* pCos, size_t count)
+{ SinCosArray<true>(pRadian, pSin, pCos, count); }
+
+//-----------------------------------------------------------------------------
+//      配列の正弦と余弦を求めます.
+//-----------------------------------------------------------------------------
+void SinCos(const float* pRadian, float* pSin, float* pCos, size_t count)
+{ SinCosArray<false>(pRadian, pSin, pCos, count); }
+
+//-----------------------------------------------------------------------------
+//      配列の平方根の逆数を低精度で求めます.
+//-----------------------------------------------------------------------------
+void RsqrtEst(const float* pValue, float* pResult, size_t count)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto simdFunc = [](__m128 x) { return _mm_rsqrt_ps(x); };
+#else
+    auto simdFunc = nullptr;
+#endif
+    Transform(pValue, pResult, count, simdFunc, [](float x) { return RsqrtEst(x); });
+}
+
+//-----------------------------------------------------------------------------
+//      配列の平方根の逆数を求めます.
+//-----------------------------------------------------------------------------
+void Rsqrt(const float* pValue, float* pResult, size_t count)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto simdFunc = [](__m128 x)
+    {
+        auto y = _mm_rsqrt_ps(x);
+        auto h = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+        return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(h, _mm_mul_ps(y, y))));
+    };
+#else
+    auto simdFunc = nullptr;
+#endif
+    Transform(pValue, pResult, count, simdFunc, [](float x) { return Rsqrt(x); });
+}
+
+//-----------------------------------------------------------------------------
+//      配列の2の累乗を低精度で求めます.
+//-----------------------------------------------------------------------------
+void Exp2Est(const float* pValue, float* pResult, size_t count)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto simdFunc = [](__m128 x)
+    {
+        __m128 scale;
+        auto f = SimdSplitExponent(x, scale);
+        auto p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(f, SimdPolynomial(f, EXP2_EST_COEF)));
+        return _mm_mul_ps(p, scale);
+    };
+#else
+    auto simdFunc = nullptr;
+#endif
+    Transform(pValue, pResult, count, simdFunc, [](float x) { return Exp2Est(x); });
+}
+
+//-----------------------------------------------------------------------------
+//      配列の2の累乗を求めます.
+//-----------------------------------------------------------------------------
+void Exp2(const float* pValue, float* pResult, size_t count)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto simdFunc = [](__m128 x)
+    {
+        __m128 scale;
+        auto f = SimdSplitExponent(x, scale);
+        auto p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(f, SimdPolynomial(f, EXP2_COEF)));
+        return _mm_mul_ps(p, scale);
+    };
+#else
+    auto simdFunc = nullptr;
+#endif
+    Transform(pValue, pResult, count, simdFunc, [](float x) { return Exp2(x); });
+}
+
+//-----------------------------------------------------------------------------
+//      配列の2を底とする対数を低精度で求めます.
+//-----------------------------------------------------------------------------
+void Log2Est(const float* pValue, float* pResult, size_t count)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto simdFunc = [](__m128 x)
+    {
+        __m128 e;
+        auto u = _mm_sub_ps(SimdSplitMantissa(x, e), _mm_set1_ps(1.0f));
+        return _mm_add_ps(_mm_mul_ps(u, SimdPolynomial(u, LOG2_EST_COEF)), e);
+    };
+#else
+    auto simdFunc = nullptr;
+#endif
+    Transform(pValue, pResult, count, simdFunc, [](float x) { return Log2Est(x); });
+}
+
+//-----------------------------------------------------------------------------
+//      配列の2を底とする対数を求めます.
+//-----------------------------------------------------------------------------
+void Log2(const float* pValue, float* pResult, size_t count)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto simdFunc = [](__m128 x)
+    {
+        __m128 e;
+        auto m = SimdSplitMantissa(x, e);
+        auto one = _mm_set1_ps(1.0f);
+        auto t = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+        return _mm_add_ps(_mm_mul_ps(t, SimdPolynomial(_mm_mul_ps(t, t), LOG2_COEF)), e);
+    };
+#else
+    auto simdFunc = nullptr;
+#endif
+    Transform(pValue, pResult, count, simdFunc, [](float x) { return Log2(x); });
+}
+
+//-----------------------------------------------------------------------------
+//      配列の逆正接を低精度で求めます.
+//-----------------------------------------------------------------------------
+void Atan2Est(const float* pY, const float* pX, float* pResult, size_t count)
+{ Atan2Array<true>(pY, pX, pResult, count); }
+
+//-----------------------------------------------------------------------------
+//      配列の逆正接を求めます.
+//-----------------------------------------------------------------------------
+void Atan2(const float* pY, const float* pX, float* pResult, size_t count)
+{ Atan2Array<false>(pY, pX, pResult, count); }
+
+//-----------------------------------------------------------------------------
+//      配列の逆余弦を低精度で求めます.
+//-----------------------------------------------------------------------------
+void AcosEst(const float* pValue, float* pResult, size_t count)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto simdFunc = [](__m128 x) { return SimdAcos(x, ACOS_EST_COEF); };
+#else
+    auto simdFunc = nullptr;
+#endif
+    Transform(pValue, pResult, count, simdFunc, [](float x) { return AcosEst(x); });
+}
+
+//-----------------------------------------------------------------------------
+//      配列の逆余弦を求めます.
+//-----------------------------------------------------------------------------
+void Acos(const float* pValue, float* pResult, size_t count)
+{
+#if defined(ASDX_ENABLE_SIMD)
+    auto simdFunc = [](__m128 x) { return SimdAcos(x, ACOS_COEF); };
+#else
+    auto simdFunc = nullptr;
+#endif
+    Transform(pValue, pResult, count, simdFunc, [](float x) { return Acos(x); });
+}
+
+} // namespace fast
+} // namespace asdx
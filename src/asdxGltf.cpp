@@ -0,0 +1,1351 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxGltf.cpp
+// Desc : glTF 2.0 Loader.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxGltf.h>
+#include <asdxMappedFile.h>
+#include <asdxParallel.h>
+#include <asdxLogger.h>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   GLB_MAGIC               = 0x46546c67;   // 'glTF'.
+static constexpr uint32_t   GLB_VERSION             = 2;
+static constexpr uint32_t   GLB_CHUNK_JSON          = 0x4e4f534a;   // 'JSON'.
+static constexpr uint32_t   GLB_CHUNK_BIN           = 0x004e4942;   // 'BIN\0'.
+static constexpr uint32_t   JSON_MAX_DEPTH          = 64;           // JSON の最大入れ子数.
+static constexpr uint32_t   INVALID_INDEX           = UINT32_MAX;
+static constexpr size_t     INVALID_SIZE            = SIZE_MAX;
+static constexpr double     MAX_SIZE_VALUE          = 4294967295.0; // サイズ値の最大値.
+static constexpr size_t     MAX_BYTE_STRIDE         = 252;          // バッファビューの最大ストライド.
+static constexpr size_t     MAX_ZERO_ACCESSOR_COUNT = 1u << 24;     // バッファビューの無いアクセサの最大要素数.
+
+static constexpr uint32_t   GLTF_BYTE               = 5120;
+static constexpr uint32_t   GLTF_UNSIGNED_BYTE      = 5121;
+static constexpr uint32_t   GLTF_SHORT              = 5122;
+static constexpr uint32_t   GLTF_UNSIGNED_SHORT     = 5123;
+static constexpr uint32_t   GLTF_UNSIGNED_INT       = 5125;
+static constexpr uint32_t   GLTF_FLOAT              = 5126;
+static constexpr uint32_t   GLTF_MODE_TRIANGLES     = 4;
+
+///////////////////////////////////////////////////////////////////////////////
+// JSON_TYPE enum
+///////////////////////////////////////////////////////////////////////////////
+enum JSON_TYPE
+{
+    JSON_TYPE_NULL = 0,
+    JSON_TYPE_BOOL,
+    JSON_TYPE_NUMBER,
+    JSON_TYPE_STRING,
+    JSON_TYPE_ARRAY,
+    JSON_TYPE_OBJECT,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// JsonNode structure
+///////////////////////////////////////////////////////////////////////////////
+struct JsonNode
+{
+    JSON_TYPE   Type            = JSON_TYPE_NULL;
+    const char* pKey            = nullptr;          // オブジェクトのメンバー名(エスケープ未処理).
+    uint32_t    KeyLength       = 0;
+    const char* pString         = nullptr;          // 文字列(エスケープ未処理).
+    uint32_t    StringLength    = 0;
+    double      Number          = 0.0;              // 数値, または真偽値.
+    uint32_t    FirstChild      = INVALID_INDEX;    // 先頭の子要素.
+    uint32_t    NextSibling     = INVALID_INDEX;    // 次の兄弟要素.
+    uint32_t    ChildCount      = 0;                // 子要素数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// JsonDocument class
+///////////////////////////////////////////////////////////////////////////////
+class JsonDocument
+{
+public:
+    //-------------------------------------------------------------------------
+    //      テキストを解析します. 文字列はテキストを直接参照します.
+    //-------------------------------------------------------------------------
+    bool Parse(const char* pText, size_t length)
+    {
+        m_Nodes.clear();
+        m_pCur = pText;
+        m_pEnd = pText + length;
+
+        uint32_t root;
+        if (!ParseValue(0, root))
+        { return false; }
+
+        SkipWhitespace();
+        return m_pCur == m_pEnd || *m_pCur == '\0';
+    }
+
+    //-------------------------------------------------------------------------
+    //      ルート要素を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetRoot() const
+    { return m_Nodes.empty() ? INVALID_INDEX : 0; }
+
+    //-------------------------------------------------------------------------
+    //      ノードを取得します.
+    //-------------------------------------------------------------------------
+    const JsonNode& operator[] (uint32_t index) const
+    { return m_Nodes[index]; }
+
+    //-------------------------------------------------------------------------
+    //      メンバーを検索します.
+    //-------------------------------------------------------------------------
+    uint32_t Find(uint32_t object, const char* key) const
+    {
+        if (object == INVALID_INDEX || m_Nodes[object].Type != JSON_TYPE_OBJECT)
+        { return INVALID_INDEX; }
+
+        auto length = strlen(key);
+        for(auto i = m_Nodes[object].FirstChild; i != INVALID_INDEX; i = m_Nodes[i].NextSibling)
+        {
+            const auto& node = m_Nodes[i];
+            if (node.KeyLength == length && memcmp(node.pKey, key, length) == 0)
+            { return i; }
+        }
+
+        return INVALID_INDEX;
+    }
+
+    //-------------------------------------------------------------------------
+    //      配列の要素を列挙します.
+    //-------------------------------------------------------------------------
+    std::vector<uint32_t> GetElements(uint32_t array) const
+    {
+        std::vector<uint32_t> result;
+        if (array == INVALID_INDEX || m_Nodes[array].Type != JSON_TYPE_ARRAY)
+        { return result; }
+
+        result.reserve(m_Nodes[array].ChildCount);
+        for(auto i = m_Nodes[array].FirstChild; i != INVALID_INDEX; i = m_Nodes[i].NextSibling)
+        { result.push_back(i); }
+
+        return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //      数値を取得します.
+    //-------------------------------------------------------------------------
+    double GetNumber(uint32_t object, const char* key, double defaultValue) const
+    {
+        auto index = Find(object, key);
+        if (index == INVALID_INDEX || m_Nodes[index].Type != JSON_TYPE_NUMBER)
+        { return defaultValue; }
+
+        return m_Nodes[index].Number;
+    }
+
+    //-------------------------------------------------------------------------
+    //      インデックス値を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetIndex(uint32_t object, const char* key) const
+    {
+        auto value = GetNumber(object, key, -1.0);
+        if (value < 0.0 || value >= double(INVALID_INDEX))
+        { return INVALID_INDEX; }
+
+        return uint32_t(value);
+    }
+
+    //-------------------------------------------------------------------------
+    //      サイズ値を取得します. 負数, 非整数, 大きすぎる値は INVALID_SIZE を返却します.
+    //-------------------------------------------------------------------------
+    size_t GetSize(uint32_t object, const char* key) const
+    {
+        auto value = GetNumber(object, key, 0.0);
+        if (!(value >= 0.0) || value > MAX_SIZE_VALUE || value != floor(value))
+        { return INVALID_SIZE; }
+
+        return size_t(value);
+    }
+
+    //-------------------------------------------------------------------------
+    //      真偽値を取得します.
+    //-------------------------------------------------------------------------
+    bool GetBool(uint32_t object, const char* key, bool defaultValue) const
+    {
+        auto index = Find(object, key);
+        if (index == INVALID_INDEX || m_Nodes[index].Type != JSON_TYPE_BOOL)
+        { return defaultValue; }
+
+        return m_Nodes[index].Number != 0.0;
+    }
+
+    //-------------------------------------------------------------------------
+    //      文字列を取得します.
+    //-------------------------------------------------------------------------
+    std::string GetString(uint32_t object, const char* key) const
+    {
+        auto index = Find(object, key);
+        if (index == INVALID_INDEX || m_Nodes[index].Type != JSON_TYPE_STRING)
+        { return std::string(); }
+
+        return Unescape(m_Nodes[index].pString, m_Nodes[index].StringLength);
+    }
+
+private:
+    std::vector<JsonNode>   m_Nodes;
+    const char*             m_pCur = nullptr;
+    const char*             m_pEnd = nullptr;
+
+    //-------------------------------------------------------------------------
+    //      空白を読み飛ばします.
+    //-------------------------------------------------------------------------
+    void SkipWhitespace()
+    {
+        while(m_pCur < m_pEnd && (*m_pCur == ' ' || *m_pCur == '\t' || *m_pCur == '\n' || *m_pCur == '\r'))
+        { m_pCur++; }
+    }
+
+    //-------------------------------------------------------------------------
+    //      リテラルを読み込みます.
+    //-------------------------------------------------------------------------
+    bool ParseLiteral(const char* literal)
+    {
+        auto length = strlen(literal);
+        if (size_t(m_pEnd - m_pCur) < length || memcmp(m_pCur, literal, length) != 0)
+        { return false; }
+
+        m_pCur += length;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      文字列を読み込みます.
+    //-------------------------------------------------------------------------
+    bool ParseString(const char*& pString, uint32_t& length)
+    {
+        if (m_pCur >= m_pEnd || *m_pCur != '"')
+        { return false; }
+
+        auto begin = ++m_pCur;
+        while(m_pCur < m_pEnd && *m_pCur != '"')
+        {
+            if (*m_pCur == '\\')
+            { m_pCur++; }
+            m_pCur++;
+        }
+
+        if (m_pCur >= m_pEnd)
+        { return false; }
+
+        pString = begin;
+        length  = uint32_t(m_pCur - begin);
+        m_pCur++;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      数値を読み込みます.
+    //-------------------------------------------------------------------------
+    bool ParseNumber(double& value)
+    {
+        // テキストは終端されていないので, 一時バッファにコピーして変換する.
+        char buffer[64];
+        size_t count = 0;
+        while(m_pCur < m_pEnd && count < sizeof(buffer) - 1 && strchr("+-0123456789.eE", *m_pCur) != nullptr)
+        { buffer[count++] = *m_pCur++; }
+        buffer[count] = '\0';
+
+        char* pEnd = nullptr;
+        value = strtod(buffer, &pEnd);
+        return count > 0 && pEnd == buffer + count;
+    }
+
+    //-------------------------------------------------------------------------
+    //      値を読み込みます.
+    //-------------------------------------------------------------------------
+    bool ParseValue(uint32_t depth, uint32_t& index)
+    {
+        if (depth > JSON_MAX_DEPTH)
+        { return false; }
+
+        SkipWhitespace();
+        if (m_pCur >= m_pEnd)
+        { return false; }
+
+        index = uint32_t(m_Nodes.size());
+        m_Nodes.push_back(JsonNode());
+
+        auto c = *m_pCur;
+        if (c == '{' || c == '[')
+        {
+            auto isObject = (c == '{');
+            auto close    = isObject ? '}' : ']';
+            m_Nodes[index].Type = isObject ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY;
+            m_pCur++;
+
+            SkipWhitespace();
+            if (m_pCur < m_pEnd && *m_pCur == close)
+            {
+                m_pCur++;
+                return true;
+            }
+
+            auto last = INVALID_INDEX;
+            for(;;)
+            {
+                const char* pKey = nullptr;
+                uint32_t keyLength = 0;
+                if (isObject)
+                {
+                    SkipWhitespace();
+                    if (!ParseString(pKey, keyLength))
+                    { return false; }
+
+                    SkipWhitespace();
+                    if (m_pCur >= m_pEnd || *m_pCur != ':')
+                    { return false; }
+                    m_pCur++;
+                }
+
+                uint32_t child;
+                if (!ParseValue(depth + 1, child))
+                { return false; }
+
+                m_Nodes[child].pKey      = pKey;
+                m_Nodes[child].KeyLength = keyLength;
+
+                if (last == INVALID_INDEX)
+                { m_Nodes[index].FirstChild = child; }
+                else
+                { m_Nodes[last].NextSibling = child; }
+                last = child;
+                m_Nodes[index].ChildCount++;
+
+                SkipWhitespace();
+                if (m_pCur >= m_pEnd)
+                { return false; }
+
+                if (*m_pCur == ',')
+                {
+                    m_pCur++;
+                    continue;
+                }
+
+                if (*m_pCur != close)
+                { return false; }
+
+                m_pCur++;
+                return true;
+            }
+        }
+
+        auto& node = m_Nodes[index];
+        if (c == '"')
+        {
+            node.Type = JSON_TYPE_STRING;
+            return ParseString(node.pString, node.StringLength);
+        }
+
+        if (c == 't' || c == 'f')
+        {
+            node.Type   = JSON_TYPE_BOOL;
+            node.Number = (c == 't') ? 1.0 : 0.0;
+            return ParseLiteral((c == 't') ? "true" : "false");
+        }
+
+        if (c == 'n')
+        {
+            node.Type = JSON_TYPE_NULL;
+            return ParseLiteral("null");
+        }
+
+        node.Type = JSON_TYPE_NUMBER;
+        return ParseNumber(node.Number);
+    }
+
+    //-------------------------------------------------------------------------
+    //      エスケープを展開します.
+    //-------------------------------------------------------------------------
+    static std::string Unescape(const char* pString, uint32_t length)
+    {
+        std::string result;
+        result.reserve(length);
+
+        for(uint32_t i=0; i<length; ++i)
+        {
+            auto c = pString[i];
+            if (c != '\\' || i + 1 >= length)
+            {
+                result.push_back(c);
+                continue;
+            }
+
+            c = pString[++i];
+            switch(c)
+            {
+            case 'b': result.push_back('\b'); break;
+            case 'f': result.push_back('\f'); break;
+            case 'n': result.push_back('\n'); break;
+            case 'r': result.push_back('\r'); break;
+            case 't': result.push_back('\t'); break;
+            case 'u':
+                {
+                    if (i + 4 >= length)
+                    { return result; }
+
+                    char hex[5] = { pString[i + 1], pString[i + 2], pString[i + 3], pString[i + 4], '\0' };
+                    auto code = uint32_t(strtoul(hex, nullptr, 16));
+                    i += 4;
+
+                    // サロゲートペアは扱わず, 基本多言語面のみ UTF-8 に変換する.
+                    if (code < 0x80)
+                    { result.push_back(char(code)); }
+                    else if (code < 0x800)
+                    {
+                        result.push_back(char(0xc0 | (code >> 6)));
+                        result.push_back(char(0x80 | (code & 0x3f)));
+                    }
+                    else
+                    {
+                        result.push_back(char(0xe0 | (code >> 12)));
+                        result.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+                        result.push_back(char(0x80 | (code & 0x3f)));
+                    }
+                }
+                break;
+            default:
+                result.push_back(c);
+                break;
+            }
+        }
+
+        return result;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GltfBufferView structure
+///////////////////////////////////////////////////////////////////////////////
+struct GltfBufferView
+{
+    const uint8_t*  pData   = nullptr;  // 先頭アドレス.
+    size_t          Length  = 0;        // バイト数.
+    uint32_t        Stride  = 0;        // 要素間のバイト数(0の場合は密).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GltfAccessor structure
+///////////////////////////////////////////////////////////////////////////////
+struct GltfAccessor
+{
+    const uint8_t*  pData           = nullptr;  // 先頭要素(nullptr の場合は全て0).
+    size_t          Stride          = 0;        // 要素間のバイト数.
+    size_t          Count           = 0;        // 要素数.
+    uint32_t        ComponentType   = 0;        // 成分の型.
+    uint32_t        ComponentCount  = 0;        // 成分数.
+    bool            Normalized      = false;    // 正規化整数かどうか.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GltfPrimitive structure
+///////////////////////////////////////////////////////////////////////////////
+struct GltfPrimitive
+{
+    uint32_t        Node;       // プリミティブの JSON ノード.
+    std::string     MeshName;   // メッシュ名.
+};
+
+//-----------------------------------------------------------------------------
+//      成分のバイト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetComponentSize(uint32_t type)
+{
+    switch(type)
+    {
+    case GLTF_BYTE:
+    case GLTF_UNSIGNED_BYTE:    return 1;
+    case GLTF_SHORT:
+    case GLTF_UNSIGNED_SHORT:   return 2;
+    case GLTF_UNSIGNED_INT:
+    case GLTF_FLOAT:            return 4;
+    default:                    return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      要素の成分数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetComponentCount(const std::string& type)
+{
+    if (type == "SCALAR") { return 1; }
+    if (type == "VEC2")   { return 2; }
+    if (type == "VEC3")   { return 3; }
+    if (type == "VEC4")   { return 4; }
+    if (type == "MAT4")   { return 16; }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+//      成分を浮動小数として読み込みます.
+//-----------------------------------------------------------------------------
+inline float ReadFloat(const uint8_t* pData, uint32_t type, bool normalized)
+{
+    switch(type)
+    {
+    case GLTF_FLOAT:
+        {
+            float value;
+            memcpy(&value, pData, sizeof(value));
+            return value;
+        }
+
+    case GLTF_UNSIGNED_BYTE:
+        return normalized ? float(pData[0]) / 255.0f : float(pData[0]);
+
+    case GLTF_BYTE:
+        {
+            auto value = float(int8_t(pData[0]));
+            return normalized ? asdx::Max(value / 127.0f, -1.0f) : value;
+        }
+
+    case GLTF_UNSIGNED_SHORT:
+        {
+            uint16_t value;
+            memcpy(&value, pData, sizeof(value));
+            return normalized ? float(value) / 65535.0f : float(value);
+        }
+
+    case GLTF_SHORT:
+        {
+            int16_t value;
+            memcpy(&value, pData, sizeof(value));
+            return normalized ? asdx::Max(float(value) / 32767.0f, -1.0f) : float(value);
+        }
+
+    case GLTF_UNSIGNED_INT:
+        {
+            uint32_t value;
+            memcpy(&value, pData, sizeof(value));
+            return float(value);
+        }
+    }
+
+    return 0.0f;
+}
+
+//-----------------------------------------------------------------------------
+//      成分を符号無し整数として読み込みます.
+//-----------------------------------------------------------------------------
+inline uint32_t ReadUint(const uint8_t* pData, uint32_t type)
+{
+    switch(type)
+    {
+    case GLTF_UNSIGNED_BYTE:
+        return pData[0];
+
+    case GLTF_UNSIGNED_SHORT:
+        {
+            uint16_t value;
+            memcpy(&value, pData, sizeof(value));
+            return value;
+        }
+
+    case GLTF_UNSIGNED_INT:
+        {
+            uint32_t value;
+            memcpy(&value, pData, sizeof(value));
+            return value;
+        }
+    }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+//      アクセサを浮動小数の配列として読み込みます.
+//-----------------------------------------------------------------------------
+void ReadFloats(const GltfAccessor& accessor, uint32_t componentCount, float* pDst, size_t dstStride)
+{
+    if (accessor.pData == nullptr)
+    {
+        for(size_t i=0; i<accessor.Count; ++i)
+        { memset(pDst + i * dstStride, 0, sizeof(float) * componentCount); }
+        return;
+    }
+
+    // 型と並びが一致する場合は変換せずにコピーする.
+    auto elementSize = sizeof(float) * componentCount;
+    if (accessor.ComponentType == GLTF_FLOAT && accessor.Stride == elementSize && dstStride == componentCount)
+    {
+        memcpy(pDst, accessor.pData, elementSize * accessor.Count);
+        return;
+    }
+
+    auto componentSize = GetComponentSize(accessor.ComponentType);
+    for(size_t i=0; i<accessor.Count; ++i)
+    {
+        auto pSrc = accessor.pData + i * accessor.Stride;
+        for(uint32_t c=0; c<componentCount; ++c)
+        { pDst[i * dstStride + c] = ReadFloat(pSrc + c * componentSize, accessor.ComponentType, accessor.Normalized); }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      アクセサをベクトルの配列として読み込みます.
+//-----------------------------------------------------------------------------
+template<typename T>
+void ReadVectors(const GltfAccessor& accessor, std::vector<T>& result)
+{
+    static_assert(sizeof(T) % sizeof(float) == 0, "Invalid Vector Type");
+    static constexpr uint32_t N = sizeof(T) / sizeof(float);
+
+    result.resize(accessor.Count);
+    if (result.empty())
+    { return; }
+
+    ReadFloats(accessor, N, &result[0].x, N);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// GltfLoader class
+///////////////////////////////////////////////////////////////////////////////
+class GltfLoader
+{
+public:
+    //-------------------------------------------------------------------------
+    //      読み込み処理を行います.
+    //-------------------------------------------------------------------------
+    bool Load
+    (
+        const uint8_t*      pData,
+        size_t              size,
+        const char*         baseDirectory,
+        asdx::ResModel&     result,
+        uint32_t            maxThreadCount
+    )
+    {
+        result.Meshes   .clear();
+        result.Materials.clear();
+
+        const char*    pJson    = nullptr;
+        size_t         jsonSize = 0;
+        const uint8_t* pBin     = nullptr;
+        size_t         binSize  = 0;
+
+        if (!SplitChunks(pData, size, pJson, jsonSize, pBin, binSize))
+        { return false; }
+
+        if (!m_Document.Parse(pJson, jsonSize))
+        {
+            ELOGA("Error : JSON Parse Failed.");
+            return false;
+        }
+
+        auto root = m_Document.GetRoot();
+        auto version = m_Document.GetString(m_Document.Find(root, "asset"), "version");
+        if (version.empty() || version[0] != '2')
+        {
+            ELOGA("Error : Unsupported glTF Version. version = %s", version.c_str());
+            return false;
+        }
+
+        if (!LoadBuffers(root, pBin, binSize, baseDirectory)
+         || !LoadBufferViews(root)
+         || !LoadAccessors(root))
+        { return false; }
+
+        LoadMaterials(root, result);
+
+        // プリミティブを列挙する.
+        std::vector<GltfPrimitive> primitives;
+        auto meshes = m_Document.GetElements(m_Document.Find(root, "meshes"));
+        for(size_t i=0; i<meshes.size(); ++i)
+        {
+            auto name = m_Document.GetString(meshes[i], "name");
+            if (name.empty())
+            { name = "mesh" + std::to_string(i); }
+
+            auto items = m_Document.GetElements(m_Document.Find(meshes[i], "primitives"));
+            for(size_t j=0; j<items.size(); ++j)
+            {
+                auto mode = m_Document.GetNumber(items[j], "mode", GLTF_MODE_TRIANGLES);
+                if (mode != GLTF_MODE_TRIANGLES)
+                {
+                    WLOGA("Warning : Non-Triangle Primitive Skipped. mesh = %s", name.c_str());
+                    continue;
+                }
+
+                GltfPrimitive primitive;
+                primitive.Node     = items[j];
+                primitive.MeshName = (items.size() > 1) ? name + "_" + std::to_string(j) : name;
+                primitives.push_back(primitive);
+            }
+        }
+
+        // プリミティブごとに出力先が異なるので, 並列に読み込める.
+        result.Meshes.resize(primitives.size());
+        std::vector<uint8_t> succeeded(primitives.size(), 0);
+
+        asdx::ParallelFor(primitives.size(), 1, [&](uint32_t, size_t begin, size_t end)
+        {
+            for(auto i=begin; i<end; ++i)
+            { succeeded[i] = LoadPrimitive(primitives[i], i, result) ? 1 : 0; }
+        }, maxThreadCount);
+
+        for(size_t i=0; i<primitives.size(); ++i)
+        {
+            if (!succeeded[i])
+            {
+                ELOGA("Error : Invalid Primitive. mesh = %s", primitives[i].MeshName.c_str());
+                result.Meshes   .clear();
+                result.Materials.clear();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    JsonDocument                                    m_Document;
+    std::vector<GltfBufferView>                     m_Buffers;
+    std::vector<GltfBufferView>                     m_BufferViews;
+    std::vector<GltfAccessor>                       m_Accessors;
+    std::vector<std::unique_ptr<asdx::MappedFile>>  m_Files;            // 外部バッファ.
+    std::vector<std::vector<uint8_t>>               m_DecodedBuffers;   // Base64 をデコードしたバッファ.
+
+    //-------------------------------------------------------------------------
+    //      .glb の場合はチャンクに分割します.
+    //-------------------------------------------------------------------------
+    bool SplitChunks
+    (
+        const uint8_t*  pData,
+        size_t          size,
+        const char*&    pJson,
+        size_t&         jsonSize,
+        const uint8_t*& pBin,
+        size_t&         binSize
+    )
+    {
+        uint32_t header[3] = {};
+        if (size >= sizeof(header))
+        { memcpy(header, pData, sizeof(header)); }
+
+        if (header[0] != GLB_MAGIC)
+        {
+            // .gltf は全体が JSON.
+            pJson    = reinterpret_cast<const char*>(pData);
+            jsonSize = size;
+            return true;
+        }
+
+        if (header[1] != GLB_VERSION)
+        {
+            ELOGA("Error : Unsupported GLB Version. version = %u", header[1]);
+            return false;
+        }
+
+        if (header[2] > size)
+        {
+            ELOGA("Error : Invalid GLB Size.");
+            return false;
+        }
+
+        // チャンクは JSON, BIN の順に並ぶ.
+        size_t offset = sizeof(header);
+        while(offset + 8 <= header[2])
+        {
+            uint32_t chunk[2];
+            memcpy(chunk, pData + offset, sizeof(chunk));
+            offset += sizeof(chunk);
+
+            if (chunk[0] > header[2] - offset)
+            {
+                ELOGA("Error : Invalid GLB Chunk Size.");
+                return false;
+            }
+
+            if (chunk[1] == GLB_CHUNK_JSON && pJson == nullptr)
+            {
+                pJson    = reinterpret_cast<const char*>(pData + offset);
+                jsonSize = chunk[0];
+            }
+            else if (chunk[1] == GLB_CHUNK_BIN && pBin == nullptr)
+            {
+                pBin    = pData + offset;
+                binSize = chunk[0];
+            }
+
+            offset += (chunk[0] + 3) & ~3u;
+        }
+
+        if (pJson == nullptr)
+        {
+            ELOGA("Error : GLB JSON Chunk Not Found.");
+            return false;
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      バッファを読み込みます.
+    //-------------------------------------------------------------------------
+    bool LoadBuffers(uint32_t root, const uint8_t* pBin, size_t binSize, const char* baseDirectory)
+    {
+        auto buffers = m_Document.GetElements(m_Document.Find(root, "buffers"));
+        m_Buffers.resize(buffers.size());
+
+        for(size_t i=0; i<buffers.size(); ++i)
+        {
+            auto byteLength = m_Document.GetSize(buffers[i], "byteLength");
+            auto uri        = m_Document.GetString(buffers[i], "uri");
+            auto& buffer    = m_Buffers[i];
+
+            if (byteLength == INVALID_SIZE)
+            {
+                ELOGA("Error : Invalid Buffer Length. index = %zu", i);
+                return false;
+            }
+
+            if (uri.empty())
+            {
+                // URI の無い先頭バッファは .glb の BIN チャンク.
+                if (i != 0 || pBin == nullptr)
+                {
+                    ELOGA("Error : Buffer URI Not Found. index = %zu", i);
+                    return false;
+                }
+                buffer.pData  = pBin;
+                buffer.Length = binSize;
+            }
+            else if (uri.compare(0, 5, "data:") == 0)
+            {
+                auto pos = uri.find(";base64,");
+                if (pos == std::string::npos)
+                {
+                    ELOGA("Error : Unsupported Data URI. index = %zu", i);
+                    return false;
+                }
+
+                m_DecodedBuffers.emplace_back();
+                if (!DecodeBase64(uri.c_str() + pos + 8, m_DecodedBuffers.back()))
+                {
+                    ELOGA("Error : Invalid Base64 Data. index = %zu", i);
+                    return false;
+                }
+                buffer.pData  = m_DecodedBuffers.back().data();
+                buffer.Length = m_DecodedBuffers.back().size();
+            }
+            else
+            {
+                if (baseDirectory == nullptr)
+                {
+                    ELOGA("Error : External Buffer Is Not Allowed. uri = %s", uri.c_str());
+                    return false;
+                }
+
+                std::string path = baseDirectory;
+                if (!path.empty() && path.back() != '/' && path.back() != '\\')
+                { path += '/'; }
+                path += DecodeUri(uri);
+
+                std::unique_ptr<asdx::MappedFile> file(new asdx::MappedFile());
+                if (!file->Open(path.c_str()))
+                { return false; }
+
+                buffer.pData  = file->GetData();
+                buffer.Length = file->GetSize();
+                m_Files.push_back(std::move(file));
+            }
+
+            if (byteLength > buffer.Length)
+            {
+                ELOGA("Error : Buffer Too Small. index = %zu", i);
+                return false;
+            }
+            buffer.Length = byteLength;
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      バッファビューを読み込みます.
+    //-------------------------------------------------------------------------
+    bool LoadBufferViews(uint32_t root)
+    {
+        auto views = m_Document.GetElements(m_Document.Find(root, "bufferViews"));
+        m_BufferViews.resize(views.size());
+
+        for(size_t i=0; i<views.size(); ++i)
+        {
+            auto buffer     = m_Document.GetIndex(views[i], "buffer");
+            auto byteOffset = m_Document.GetSize(views[i], "byteOffset");
+            auto byteLength = m_Document.GetSize(views[i], "byteLength");
+            auto byteStride = m_Document.GetSize(views[i], "byteStride");
+
+            // 不正なサイズ値は INVALID_SIZE なので, 範囲外として弾かれる.
+            if (buffer >= m_Buffers.size()
+             || byteOffset > m_Buffers[buffer].Length
+             || byteLength > m_Buffers[buffer].Length - byteOffset
+             || byteStride > MAX_BYTE_STRIDE)
+            {
+                ELOGA("Error : Invalid Buffer View. index = %zu", i);
+                return false;
+            }
+
+            m_BufferViews[i].pData  = m_Buffers[buffer].pData + byteOffset;
+            m_BufferViews[i].Length = byteLength;
+            m_BufferViews[i].Stride = uint32_t(byteStride);
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      アクセサを読み込みます.
+    //-------------------------------------------------------------------------
+    bool LoadAccessors(uint32_t root)
+    {
+        auto accessors = m_Document.GetElements(m_Document.Find(root, "accessors"));
+        m_Accessors.resize(accessors.size());
+
+        for(size_t i=0; i<accessors.size(); ++i)
+        {
+            auto& accessor = m_Accessors[i];
+            accessor.Count          = m_Document.GetSize(accessors[i], "count");
+            accessor.ComponentType  = m_Document.GetIndex(accessors[i], "componentType");
+            accessor.ComponentCount = GetComponentCount(m_Document.GetString(accessors[i], "type"));
+            accessor.Normalized     = m_Document.GetBool(accessors[i], "normalized", false);
+
+            auto componentSize = GetComponentSize(accessor.ComponentType);
+            if (componentSize == 0 || accessor.ComponentCount == 0)
+            {
+                ELOGA("Error : Invalid Accessor Type. index = %zu", i);
+                return false;
+            }
+
+            if (m_Document.Find(accessors[i], "sparse") != INVALID_INDEX)
+            {
+                ELOGA("Error : Sparse Accessor Is Not Supported. index = %zu", i);
+                return false;
+            }
+
+            if (accessor.Count == INVALID_SIZE)
+            {
+                ELOGA("Error : Invalid Accessor Count. index = %zu", i);
+                return false;
+            }
+
+            // バッファビューが無い場合は全て0. データで要素数が制限されないので上限を設ける.
+            auto view = m_Document.GetIndex(accessors[i], "bufferView");
+            if (view == INVALID_INDEX)
+            {
+                if (accessor.Count > MAX_ZERO_ACCESSOR_COUNT)
+                {
+                    ELOGA("Error : Accessor Count Too Large. index = %zu, count = %zu", i, accessor.Count);
+                    return false;
+                }
+                continue;
+            }
+
+            if (view >= m_BufferViews.size())
+            {
+                ELOGA("Error : Invalid Accessor. index = %zu", i);
+                return false;
+            }
+
+            const auto& bufferView = m_BufferViews[view];
+            auto byteOffset  = m_Document.GetSize(accessors[i], "byteOffset");
+            auto elementSize = size_t(componentSize) * accessor.ComponentCount;
+            accessor.Stride  = (bufferView.Stride != 0) ? bufferView.Stride : elementSize;
+
+            // 先頭と最後の要素までバッファビューに収まること.
+            if (byteOffset > bufferView.Length
+             || (accessor.Count > 0
+              && (accessor.Count - 1 > (bufferView.Length - byteOffset) / accessor.Stride
+               || (accessor.Count - 1) * accessor.Stride + elementSize > bufferView.Length - byteOffset)))
+            {
+                ELOGA("Error : Accessor Out Of Range. index = %zu", i);
+                return false;
+            }
+
+            accessor.pData = bufferView.pData + byteOffset;
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      テクスチャの参照先を取得します.
+    //-------------------------------------------------------------------------
+    std::string GetTexturePath(uint32_t root, uint32_t textureInfo) const
+    {
+        auto texture = m_Document.GetIndex(textureInfo, "index");
+        auto textures = m_Document.Find(root, "textures");
+        if (texture == INVALID_INDEX || textures == INVALID_INDEX || texture >= m_Document[textures].ChildCount)
+        { return std::string(); }
+
+        auto source = m_Document.GetIndex(m_Document.GetElements(textures)[texture], "source");
+        auto images = m_Document.Find(root, "images");
+        if (source == INVALID_INDEX || images == INVALID_INDEX || source >= m_Document[images].ChildCount)
+        { return std::string(); }
+
+        // バッファに埋め込まれた画像は名前を返す.
+        auto image = m_Document.GetElements(images)[source];
+        auto uri = m_Document.GetString(image, "uri");
+        return uri.empty() ? m_Document.GetString(image, "name") : DecodeUri(uri);
+    }
+
+    //-------------------------------------------------------------------------
+    //      マテリアルを読み込みます.
+    //-------------------------------------------------------------------------
+    void LoadMaterials(uint32_t root, asdx::ResModel& result) const
+    {
+        auto materials = m_Document.GetElements(m_Document.Find(root, "materials"));
+        result.Materials.resize(materials.size());
+
+        for(size_t i=0; i<materials.size(); ++i)
+        {
+            auto  material  = materials[i];
+            auto  pbr       = m_Document.Find(material, "pbrMetallicRoughness");
+            auto& dst       = result.Materials[i];
+
+            dst.MaterialName = m_Document.GetString(material, "name");
+            if (dst.MaterialName.empty())
+            { dst.MaterialName = "material" + std::to_string(i); }
+
+            // ORM は R:Occlusion, G:Roughness, B:Metalness で glTF と同じ並び.
+            dst.BaseColorMap = GetTexturePath(root, m_Document.Find(pbr, "baseColorTexture"));
+            dst.OrmMap       = GetTexturePath(root, m_Document.Find(pbr, "metallicRoughnessTexture"));
+            dst.EmissiveMap  = GetTexturePath(root, m_Document.Find(material, "emissiveTexture"));
+            if (dst.OrmMap.empty())
+            { dst.OrmMap = GetTexturePath(root, m_Document.Find(material, "occlusionTexture")); }
+
+            // 係数は RGB の平均, 最大値をスカラーの強度とする.
+            float baseColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+            float emissive [3] = { 0.0f, 0.0f, 0.0f };
+            ReadNumbers(m_Document.Find(pbr,      "baseColorFactor"), baseColor, 4);
+            ReadNumbers(m_Document.Find(material, "emissiveFactor"),  emissive,  3);
+
+            auto strength = m_Document.GetNumber(
+                m_Document.Find(m_Document.Find(material, "extensions"), "KHR_materials_emissive_strength"),
+                "emissiveStrength", 1.0);
+
+            dst.BaseColorIntensity = (baseColor[0] + baseColor[1] + baseColor[2]) / 3.0f;
+            dst.OcclusionIntensity = float(m_Document.GetNumber(m_Document.Find(material, "occlusionTexture"), "strength", 1.0));
+            dst.RoughnessIntensity = float(m_Document.GetNumber(pbr, "roughnessFactor", 1.0));
+            dst.EmissiveIntensity  = asdx::Max(emissive[0], asdx::Max(emissive[1], emissive[2])) * float(strength);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      数値の配列を読み込みます.
+    //-------------------------------------------------------------------------
+    void ReadNumbers(uint32_t array, float* pResult, uint32_t count) const
+    {
+        auto elements = m_Document.GetElements(array);
+        for(size_t i=0; i<elements.size() && i<count; ++i)
+        {
+            if (m_Document[elements[i]].Type == JSON_TYPE_NUMBER)
+            { pResult[i] = float(m_Document[elements[i]].Number); }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      属性のアクセサを取得します.
+    //-------------------------------------------------------------------------
+    const GltfAccessor* FindAttribute(uint32_t attributes, const char* name) const
+    {
+        auto index = m_Document.GetIndex(attributes, name);
+        return (index < m_Accessors.size()) ? &m_Accessors[index] : nullptr;
+    }
+
+    //-------------------------------------------------------------------------
+    //      プリミティブを読み込みます.
+    //-------------------------------------------------------------------------
+    bool LoadPrimitive(const GltfPrimitive& primitive, size_t meshIndex, asdx::ResModel& model) const
+    {
+        auto  attributes = m_Document.Find(primitive.Node, "attributes");
+        auto& mesh       = model.Meshes[meshIndex];
+
+        mesh.MeshName = primitive.MeshName;
+
+        auto material = m_Document.GetIndex(primitive.Node, "material");
+        if (material < model.Materials.size())
+        { mesh.MaterialName = model.Materials[material].MaterialName; }
+
+        auto pPosition = FindAttribute(attributes, "POSITION");
+        if (pPosition == nullptr || pPosition->ComponentCount != 3)
+        { return false; }
+
+        auto vertexCount = pPosition->Count;
+        ReadVectors(*pPosition, mesh.Positions);
+
+        // 頂点属性は全て POSITION と同じ要素数でなければならない.
+        auto isValid = [vertexCount](const GltfAccessor* pAccessor, uint32_t minCount, uint32_t maxCount)
+        {
+            return pAccessor->Count == vertexCount
+                && pAccessor->ComponentCount >= minCount
+                && pAccessor->ComponentCount <= maxCount;
+        };
+
+        auto pNormal = FindAttribute(attributes, "NORMAL");
+        if (pNormal != nullptr)
+        {
+            if (!isValid(pNormal, 3, 3))
+            { return false; }
+            ReadVectors(*pNormal, mesh.Normals);
+        }
+
+        auto pTangent = FindAttribute(attributes, "TANGENT");
+        if (pTangent != nullptr)
+        {
+            if (!isValid(pTangent, 4, 4))
+            { return false; }
+
+            std::vector<asdx::Vector4> tangents;
+            ReadVectors(*pTangent, tangents);
+
+            // w は従法線の向き.
+            mesh.Tangents  .resize(vertexCount);
+            mesh.Bitangents.resize(vertexCount);
+            for(size_t i=0; i<vertexCount; ++i)
+            {
+                auto& t = tangents[i];
+                mesh.Tangents[i] = asdx::Vector3(t.x, t.y, t.z);
+                mesh.Bitangents[i] = mesh.Normals.empty()
+                    ? asdx::Vector3(0.0f, 0.0f, 0.0f)
+                    : asdx::Vector3::Cross(mesh.Normals[i], mesh.Tangents[i]) * t.w;
+            }
+        }
+
+        for(uint32_t layer=0; layer<MAX_LAYER_COUNT; ++layer)
+        {
+            char name[16];
+            snprintf(name, sizeof(name), "TEXCOORD_%u", layer);
+
+            auto pTexCoord = FindAttribute(attributes, name);
+            if (pTexCoord == nullptr)
+            { break; }
+
+            if (!isValid(pTexCoord, 2, 2))
+            { return false; }
+            ReadVectors(*pTexCoord, mesh.TexCoords[layer]);
+        }
+
+        auto pColor = FindAttribute(attributes, "COLOR_0");
+        if (pColor != nullptr)
+        {
+            if (!isValid(pColor, 3, 4))
+            { return false; }
+
+            // RGB の場合はアルファを 1 とする.
+            mesh.Colors.resize(vertexCount, asdx::Vector4(1.0f, 1.0f, 1.0f, 1.0f));
+            if (vertexCount > 0)
+            { ReadFloats(*pColor, pColor->ComponentCount, &mesh.Colors[0].x, 4); }
+        }
+
+        auto pJoints  = FindAttribute(attributes, "JOINTS_0");
+        auto pWeights = FindAttribute(attributes, "WEIGHTS_0");
+        if (pJoints != nullptr && pWeights != nullptr)
+        {
+            if (!isValid(pJoints, 4, 4) || !isValid(pWeights, 4, 4))
+            { return false; }
+
+            if (pJoints->ComponentType != GLTF_UNSIGNED_BYTE && pJoints->ComponentType != GLTF_UNSIGNED_SHORT)
+            { return false; }
+
+            ReadVectors(*pWeights, mesh.BoneWeights);
+
+            mesh.BoneIndices.resize(vertexCount);
+            auto componentSize = GetComponentSize(pJoints->ComponentType);
+            for(size_t i=0; i<vertexCount; ++i)
+            {
+                uint16_t joints[4] = {};
+                if (pJoints->pData != nullptr)
+                {
+                    auto pSrc = pJoints->pData + i * pJoints->Stride;
+                    for(uint32_t c=0; c<4; ++c)
+                    { joints[c] = uint16_t(ReadUint(pSrc + c * componentSize, pJoints->ComponentType)); }
+                }
+
+                mesh.BoneIndices[i].x = joints[0];
+                mesh.BoneIndices[i].y = joints[1];
+                mesh.BoneIndices[i].z = joints[2];
+                mesh.BoneIndices[i].w = joints[3];
+            }
+        }
+
+        auto indices = m_Document.GetIndex(primitive.Node, "indices");
+        if (indices == INVALID_INDEX)
+        {
+            // インデックスが無い場合は連番.
+            mesh.Indices.resize(vertexCount);
+            for(size_t i=0; i<vertexCount; ++i)
+            { mesh.Indices[i] = uint32_t(i); }
+        }
+        else
+        {
+            if (indices >= m_Accessors.size())
+            { return false; }
+
+            const auto& accessor = m_Accessors[indices];
+            if (accessor.ComponentCount != 1 || accessor.ComponentType == GLTF_FLOAT
+             || accessor.ComponentType == GLTF_BYTE || accessor.ComponentType == GLTF_SHORT)
+            { return false; }
+
+            mesh.Indices.resize(accessor.Count);
+            if (accessor.pData == nullptr)
+            { memset(mesh.Indices.data(), 0, sizeof(uint32_t) * accessor.Count); }
+            else if (accessor.ComponentType == GLTF_UNSIGNED_INT && accessor.Stride == sizeof(uint32_t))
+            { memcpy(mesh.Indices.data(), accessor.pData, sizeof(uint32_t) * accessor.Count); }
+            else
+            {
+                for(size_t i=0; i<accessor.Count; ++i)
+                { mesh.Indices[i] = ReadUint(accessor.pData + i * accessor.Stride, accessor.ComponentType); }
+            }
+        }
+
+        if (mesh.Indices.size() % 3 != 0)
+        { return false; }
+
+        for(auto& index : mesh.Indices)
+        {
+            if (index >= vertexCount)
+            { return false; }
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      URI のパーセントエンコードを展開します.
+    //-------------------------------------------------------------------------
+    static std::string DecodeUri(const std::string& uri)
+    {
+        std::string result;
+        result.reserve(uri.size());
+
+        for(size_t i=0; i<uri.size(); ++i)
+        {
+            if (uri[i] == '%' && i + 2 < uri.size() && isxdigit(uint8_t(uri[i + 1])) && isxdigit(uint8_t(uri[i + 2])))
+            {
+                char hex[3] = { uri[i + 1], uri[i + 2], '\0' };
+                result.push_back(char(strtoul(hex, nullptr, 16)));
+                i += 2;
+            }
+            else
+            { result.push_back(uri[i]); }
+        }
+
+        return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //      Base64 をデコードします.
+    //-------------------------------------------------------------------------
+    static bool DecodeBase64(const char* pText, std::vector<uint8_t>& result)
+    {
+        auto decode = [](char c) -> int
+        {
+            if (c >= 'A' && c <= 'Z') { return c - 'A'; }
+            if (c >= 'a' && c <= 'z') { return c - 'a' + 26; }
+            if (c >= '0' && c <= '9') { return c - '0' + 52; }
+            if (c == '+') { return 62; }
+            if (c == '/') { return 63; }
+            return -1;
+        };
+
+        auto length = strlen(pText);
+        result.clear();
+        result.reserve(length / 4 * 3);
+
+        uint32_t bits  = 0;
+        uint32_t count = 0;
+        for(size_t i=0; i<length; ++i)
+        {
+            if (pText[i] == '=')
+            { break; }
+
+            auto value = decode(pText[i]);
+            if (value < 0)
+            { return false; }
+
+            bits = (bits << 6) | uint32_t(value);
+            count += 6;
+            if (count >= 8)
+            {
+                count -= 8;
+                result.push_back(uint8_t(bits >> count));
+            }
+        }
+
+        return true;
+    }
+};
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      glTF 2.0 ファイルを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadGltf(const char* filename, ResModel& result, uint32_t maxThreadCount)
+{
+    if (filename == nullptr)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.Open(filename))
+    { return false; }
+
+    // 外部バッファはファイルと同じディレクトリから参照する.
+    std::string directory = filename;
+    auto pos = directory.find_last_of("/\\");
+    directory = (pos == std::string::npos) ? std::string(".") : directory.substr(0, pos);
+
+    return LoadGltf(file.GetData(), file.GetSize(), directory.c_str(), result, maxThreadCount);
+}
+
+//-----------------------------------------------------------------------------
+//      メモリ上の glTF 2.0 データを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadGltf
+(
+    const void*     pBuffer,
+    size_t          size,
+    const char*     baseDirectory,
+    ResModel&       result,
+    uint32_t        maxThreadCount
+)
+{
+    if (pBuffer == nullptr || size == 0)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    GltfLoader loader;
+    return loader.Load(static_cast<const uint8_t*>(pBuffer), size, baseDirectory, result, maxThreadCount);
+}
+
+} // namespace asdx
@@ -0,0 +1,366 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxLightBVH.cpp
+// Desc : Bounding Volume Hierarchy for Lights.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <asdxLightBVH.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t SPOT_LIGHT_BIT    = 0x80000000u;  // スポットライトを表すビット.
+static constexpr uint32_t INVALID_NODE      = UINT32_MAX;   // 無効なノード番号.
+
+//-----------------------------------------------------------------------------
+//      境界箱が完全に一致するかどうか判定します.
+//-----------------------------------------------------------------------------
+inline bool IsSameBounds(const asdx::BoundingBox& a, const asdx::BoundingBox& b)
+{
+    return a.Min.x == b.Min.x && a.Min.y == b.Min.y && a.Min.z == b.Min.z
+        && a.Max.x == b.Max.x && a.Max.y == b.Max.y && a.Max.z == b.Max.z;
+}
+
+//-----------------------------------------------------------------------------
+//      スポットライトの影響範囲を包含する境界箱を求めます.
+//-----------------------------------------------------------------------------
+asdx::BoundingBox CalcSpotLightBounds(const asdx::SpotLight& light)
+{
+    auto box = asdx::BoundingBox::CreateFromSphere(light.GetBoundingSphere());
+
+    auto angle = light.GetOuterAngle();
+    if (angle >= asdx::F_PIDIV2)
+    { return box; }
+
+    // 頂点と底面の円を包含する境界箱と重なる範囲に絞る.
+    auto& p = light.GetPosition();
+    auto& f = light.GetForward();
+    auto  c = p + f * light.GetRadius();
+    auto  r = light.GetRadius() * tan(angle);
+
+    asdx::Vector3 e(
+        r * sqrt(asdx::Max(1.0f - f.x * f.x, 0.0f)),
+        r * sqrt(asdx::Max(1.0f - f.y * f.y, 0.0f)),
+        r * sqrt(asdx::Max(1.0f - f.z * f.z, 0.0f)));
+
+    auto cone = asdx::BoundingBox(asdx::Vector3::Min(p, c - e), asdx::Vector3::Max(p, c + e));
+    return asdx::BoundingBox(
+        asdx::Vector3::Max(box.Min, cone.Min),
+        asdx::Vector3::Min(box.Max, cone.Max));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BuildContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct BuildContext
+{
+    std::vector<asdx::BoundingBox>  Bounds;     // 要素の境界箱.
+    std::vector<asdx::Vector3>      Centers;    // 要素の境界箱の中心.
+    std::vector<uint32_t>           Order;      // 並べ替え中の要素番号.
+};
+
+} // namespace
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// LightBVH class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      階層を構築します.
+//-----------------------------------------------------------------------------
+void LightBVH::Build
+(
+    const PointLight*   pPointLights,
+    size_t              pointCount,
+    const SpotLight*    pSpotLights,
+    size_t              spotCount
+)
+{
+    assert(pPointLights != nullptr || pointCount == 0);
+    assert(pSpotLights  != nullptr || spotCount  == 0);
+    assert(pointCount + spotCount < SPOT_LIGHT_BIT);
+
+    m_PointLights.assign(pPointLights, pPointLights + pointCount);
+    m_SpotLights .assign(pSpotLights,  pSpotLights  + spotCount);
+
+    auto itemCount = uint32_t(pointCount + spotCount);
+    m_Nodes     .clear();
+    m_Parents   .clear();
+    m_Items     .resize(itemCount);
+    m_ItemLeaves.resize(itemCount);
+
+    if (itemCount == 0)
+    { return; }
+
+    // 要素番号はポイントライト, スポットライトの順に通し番号を振る.
+    BuildContext context;
+    context.Bounds .resize(itemCount);
+    context.Centers.resize(itemCount);
+    context.Order  .resize(itemCount);
+    for(auto i=0u; i<itemCount; ++i)
+    {
+        auto item = (i < pointCount) ? i : (uint32_t(i - pointCount) | SPOT_LIGHT_BIT);
+        context.Bounds [i] = GetItemBounds(item);
+        context.Centers[i] = context.Bounds[i].GetCenter();
+        context.Order  [i] = i;
+    }
+
+    // 子は必ず親より後ろに配置する. 構築範囲は (ノード番号, 開始, 終了) で管理する.
+    struct Range
+    {
+        uint32_t Node;
+        uint32_t Begin;
+        uint32_t End;
+    };
+
+    std::vector<Range> stack;
+    stack.push_back({ 0, 0, itemCount });
+    m_Nodes  .reserve(size_t(itemCount) * 2 / LIGHT_BVH_LEAF_SIZE + 1);
+    m_Parents.reserve(m_Nodes.capacity());
+    m_Nodes  .push_back(LightBVHNode());
+    m_Parents.push_back(INVALID_NODE);
+
+    while(!stack.empty())
+    {
+        auto range = stack.back();
+        stack.pop_back();
+
+        BoundingBox bounds;
+        BoundingBox centers;
+        for(auto i=range.Begin; i<range.End; ++i)
+        {
+            auto index = context.Order[i];
+            bounds .Merge(context.Bounds [index]);
+            centers.Merge(context.Centers[index]);
+        }
+        m_Nodes[range.Node].Bounds = bounds;
+
+        auto count = range.End - range.Begin;
+        if (count <= LIGHT_BVH_LEAF_SIZE)
+        {
+            m_Nodes[range.Node].Offset = range.Begin;
+            m_Nodes[range.Node].Count  = count;
+            continue;
+        }
+
+        // 中心の分布が最も広い軸で要素数を半分に分ける.
+        auto size = centers.Max - centers.Min;
+        auto axis = (size.x >= size.y && size.x >= size.z) ? 0 : ((size.y >= size.z) ? 1 : 2);
+        auto mid  = range.Begin + count / 2;
+        std::nth_element(
+            context.Order.begin() + range.Begin,
+            context.Order.begin() + mid,
+            context.Order.begin() + range.End,
+            [&](uint32_t lhs, uint32_t rhs)
+            {
+                auto a = context.Centers[lhs][axis];
+                auto b = context.Centers[rhs][axis];
+                return (a < b) || (a == b && lhs < rhs);
+            });
+
+        auto left = uint32_t(m_Nodes.size());
+        m_Nodes[range.Node].Offset = left;
+        m_Nodes[range.Node].Count  = 0;
+        m_Nodes  .push_back(LightBVHNode());
+        m_Nodes  .push_back(LightBVHNode());
+        m_Parents.push_back(range.Node);
+        m_Parents.push_back(range.Node);
+
+        stack.push_back({ left + 1, mid, range.End });
+        stack.push_back({ left, range.Begin, mid });
+    }
+
+    // 葉ノードの要素を確定する.
+    for(auto i=0u; i<uint32_t(m_Nodes.size()); ++i)
+    {
+        auto& node = m_Nodes[i];
+        for(auto j=0u; j<node.Count; ++j)
+        {
+            auto index = context.Order[node.Offset + j];
+            m_Items     [node.Offset + j] = (index < pointCount) ? index : (uint32_t(index - pointCount) | SPOT_LIGHT_BIT);
+            m_ItemLeaves[index]           = i;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      階層構造を維持したまま全ての境界箱を再計算します.
+//-----------------------------------------------------------------------------
+void LightBVH::Refit(const PointLight* pPointLights, const SpotLight* pSpotLights)
+{
+    assert(pPointLights != nullptr || m_PointLights.empty());
+    assert(pSpotLights  != nullptr || m_SpotLights .empty());
+
+    std::copy(pPointLights, pPointLights + m_PointLights.size(), m_PointLights.begin());
+    std::copy(pSpotLights,  pSpotLights  + m_SpotLights .size(), m_SpotLights .begin());
+
+    // 子は親より後ろにあるため, 逆順に処理すれば子が先に確定する.
+    for(auto i=uint32_t(m_Nodes.size()); i-- > 0;)
+    {
+        auto& node = m_Nodes[i];
+        if (node.Count > 0)
+        { RefitLeaf(i); }
+        else
+        { node.Bounds = BoundingBox::Merge(m_Nodes[node.Offset].Bounds, m_Nodes[node.Offset + 1].Bounds); }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ポイントライトを更新します.
+//-----------------------------------------------------------------------------
+void LightBVH::UpdatePointLight(uint32_t index, const PointLight& light)
+{
+    assert(index < m_PointLights.size());
+    m_PointLights[index] = light;
+
+    auto leaf = m_ItemLeaves[index];
+    RefitLeaf(leaf);
+    RefitUpward(m_Parents[leaf]);
+}
+
+//-----------------------------------------------------------------------------
+//      スポットライトを更新します.
+//-----------------------------------------------------------------------------
+void LightBVH::UpdateSpotLight(uint32_t index, const SpotLight& light)
+{
+    assert(index < m_SpotLights.size());
+    m_SpotLights[index] = light;
+
+    auto leaf = m_ItemLeaves[m_PointLights.size() + index];
+    RefitLeaf(leaf);
+    RefitUpward(m_Parents[leaf]);
+}
+
+//-----------------------------------------------------------------------------
+//      点を含むライトを検索します.
+//-----------------------------------------------------------------------------
+void LightBVH::Query(const Vector3& point, LightBVHResult& result) const
+{
+    Traverse(
+        [&](const BoundingBox& bounds) { return bounds.Contains(point); },
+        [&](const auto& light) { return light.Contains(point); },
+        result);
+}
+
+//-----------------------------------------------------------------------------
+//      境界箱と重なるライトを検索します.
+//-----------------------------------------------------------------------------
+void LightBVH::Query(const BoundingBox& box, LightBVHResult& result) const
+{
+    Traverse(
+        [&](const BoundingBox& bounds) { return bounds.Intersects(box); },
+        [&](const auto& light) { return light.Contains(box); },
+        result);
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と重なるライトを検索します.
+//-----------------------------------------------------------------------------
+void LightBVH::Query(const BoundingSphere& sphere, LightBVHResult& result) const
+{
+    Traverse(
+        [&](const BoundingBox& bounds) { return bounds.Intersects(sphere); },
+        [&](const auto& light) { return light.Contains(sphere); },
+        result);
+}
+
+//-----------------------------------------------------------------------------
+//      要素の境界箱を求めます.
+//-----------------------------------------------------------------------------
+BoundingBox LightBVH::GetItemBounds(uint32_t item) const
+{
+    if (item & SPOT_LIGHT_BIT)
+    { return CalcSpotLightBounds(m_SpotLights[item & ~SPOT_LIGHT_BIT]); }
+
+    return BoundingBox::CreateFromSphere(m_PointLights[item].GetBoundingSphere());
+}
+
+//-----------------------------------------------------------------------------
+//      葉ノードの境界箱を再計算します.
+//-----------------------------------------------------------------------------
+void LightBVH::RefitLeaf(uint32_t node)
+{
+    auto& leaf = m_Nodes[node];
+    assert(leaf.Count > 0);
+
+    BoundingBox bounds;
+    for(auto i=0u; i<leaf.Count; ++i)
+    { bounds.Merge(GetItemBounds(m_Items[leaf.Offset + i])); }
+
+    leaf.Bounds = bounds;
+}
+
+//-----------------------------------------------------------------------------
+//      祖先ノードの境界箱を再計算します.
+//-----------------------------------------------------------------------------
+void LightBVH::RefitUpward(uint32_t node)
+{
+    while(node != INVALID_NODE)
+    {
+        auto& parent = m_Nodes[node];
+        auto  bounds = BoundingBox::Merge(m_Nodes[parent.Offset].Bounds, m_Nodes[parent.Offset + 1].Bounds);
+
+        // 変化しなければ, それより上の祖先も変化しない.
+        if (IsSameBounds(bounds, parent.Bounds))
+        { break; }
+
+        parent.Bounds = bounds;
+        node = m_Parents[node];
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      条件に合うライトを探索します.
+//-----------------------------------------------------------------------------
+template<typename Overlap, typename Contains>
+void LightBVH::Traverse(Overlap overlap, Contains contains, LightBVHResult& result) const
+{
+    if (m_Nodes.empty())
+    { return; }
+
+    uint32_t stack[LIGHT_BVH_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while(top > 0)
+    {
+        auto& node = m_Nodes[stack[--top]];
+        if (!overlap(node.Bounds))
+        { continue; }
+
+        if (node.Count == 0)
+        {
+            assert(top + 2 <= LIGHT_BVH_MAX_DEPTH);
+            stack[top++] = node.Offset + 1;
+            stack[top++] = node.Offset;
+            continue;
+        }
+
+        for(auto i=0u; i<node.Count; ++i)
+        {
+            auto item = m_Items[node.Offset + i];
+            if (item & SPOT_LIGHT_BIT)
+            {
+                auto index = item & ~SPOT_LIGHT_BIT;
+                if (contains(m_SpotLights[index]))
+                { result.SpotLights.push_back(index); }
+            }
+            else if (contains(m_PointLights[item]))
+            {
+                result.PointLights.push_back(item);
+            }
+        }
+    }
+}
+
+} // namespace asdx
@@ -0,0 +1,513 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxLightCluster.cpp
+// Desc : Clustered Light Assignment.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstring>
+#include <algorithm>
+#include <asdxLightCluster.h>
+#include <asdxParallel.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t MIN_BATCH_LIGHT_COUNT = 4096;   // ライト変換の1バッチあたりの最小ライト数.
+
+///////////////////////////////////////////////////////////////////////////////
+// ViewSphere structure
+///////////////////////////////////////////////////////////////////////////////
+struct ViewSphere
+{
+    float   X;          // ビュー空間のX座標.
+    float   Y;          // ビュー空間のY座標.
+    float   Depth;      // ビュー空間の奥行.
+    float   Radius;     // 半径.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ViewCone structure
+///////////////////////////////////////////////////////////////////////////////
+struct ViewCone
+{
+    asdx::Vector3   Position;   // 頂点の位置(X, Y, 奥行).
+    asdx::Vector3   Forward;    // 照射方向(X, Y, 奥行).
+    float           Range;      // 到達距離.
+    float           CosAngle;   // 外角の余弦.
+    float           SinAngle;   // 外角の正弦.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ClusterFrame structure
+///////////////////////////////////////////////////////////////////////////////
+struct ClusterFrame
+{
+    float               DepthSign;  // ビュー空間のZ座標を奥行に変換する符号.
+    std::vector<float>  SlopeX;     // タイル境界のX座標/奥行 (TileCountX + 1 個).
+    std::vector<float>  SlopeY;     // タイル境界のY座標/奥行 (TileCountY + 1 個).
+    std::vector<float>  Depths;     // スライス境界の奥行 (SliceCount + 1 個).
+};
+
+//-----------------------------------------------------------------------------
+//      正規化デバイス座標をビュー空間に逆投影します.
+//-----------------------------------------------------------------------------
+inline asdx::Vector3 Unproject(float x, float y, const asdx::Matrix& invProj)
+{
+    auto v = asdx::Vector4::Transform(asdx::Vector4(x, y, 0.5f, 1.0f), invProj);
+    return asdx::Vector3(v.x / v.w, v.y / v.w, v.z / v.w);
+}
+
+//-----------------------------------------------------------------------------
+//      区間までの距離の2乗を求めます.
+//-----------------------------------------------------------------------------
+inline float CalcAxisDistanceSq(float value, float mini, float maxi)
+{
+    auto d = asdx::Max(asdx::Max(mini - value, value - maxi), 0.0f);
+    return d * d;
+}
+
+//-----------------------------------------------------------------------------
+//      円錐と球が交差する可能性があるかどうか判定します.
+//-----------------------------------------------------------------------------
+inline bool TestCone(const ViewCone& cone, const asdx::Vector3& center, float radius)
+{
+    // SpotLight::Contains() と同じ判定. 丸め誤差で負にならないように制限しておく.
+    auto v     = center - cone.Position;
+    auto lenSq = asdx::Vector3::Dot(v, v);
+    auto v1Len = asdx::Vector3::Dot(v, cone.Forward);
+    auto distClosestPoint = cone.CosAngle * sqrt(asdx::Max(lenSq - v1Len * v1Len, 0.0f)) - v1Len * cone.SinAngle;
+
+    auto angleCull = distClosestPoint > radius;
+    auto frontCull = v1Len > (radius + cone.Range);
+    auto backCull  = v1Len < -radius;
+    return !(angleCull || frontCull || backCull);
+}
+
+//-----------------------------------------------------------------------------
+//      区間と重なるタイル範囲を求めます.
+//-----------------------------------------------------------------------------
+inline bool FindTileRange
+(
+    const float*    pMin,
+    const float*    pMax,
+    uint32_t        count,
+    float           value,
+    float           limit,
+    float*          pDistSq,
+    uint32_t&       first,
+    uint32_t&       last
+)
+{
+    // タイル境界は単調に並んでいるため, 重なるタイルは連続する.
+    first = 0;
+    while(first < count)
+    {
+        pDistSq[first] = CalcAxisDistanceSq(value, pMin[first], pMax[first]);
+        if (pDistSq[first] <= limit)
+        { break; }
+        first++;
+    }
+
+    if (first == count)
+    { return false; }
+
+    last = first;
+    while(last + 1 < count)
+    {
+        auto d = CalcAxisDistanceSq(value, pMin[last + 1], pMax[last + 1]);
+        if (d > limit)
+        { break; }
+        pDistSq[++last] = d;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SliceBins structure
+///////////////////////////////////////////////////////////////////////////////
+struct SliceBins
+{
+    std::vector<uint32_t>   Offsets;    // スライスごとの開始位置 (SliceCount + 1 個).
+    std::vector<uint32_t>   Indices;    // スライスと重なるライト番号(昇順).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SliceWorker class
+///////////////////////////////////////////////////////////////////////////////
+class SliceWorker
+{
+public:
+    SliceWorker(const asdx::LightClusterDesc& desc, const ClusterFrame& frame)
+    : m_Desc    (desc)
+    , m_Frame   (frame)
+    , m_TileCount   (desc.TileCountX * desc.TileCountY)
+    , m_ColumnMin   (desc.TileCountX)
+    , m_ColumnMax   (desc.TileCountX)
+    , m_RowMin      (desc.TileCountY)
+    , m_RowMax      (desc.TileCountY)
+    , m_DistSqX     (desc.TileCountX)
+    , m_DistSqY     (desc.TileCountY)
+    , m_Spheres     (m_TileCount)
+    , m_PointLists  (m_TileCount)
+    , m_SpotLists   (m_TileCount)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //      1スライス分のライトを割り当てます.
+    //-------------------------------------------------------------------------
+    void Process
+    (
+        uint32_t                        slice,
+        const std::vector<ViewSphere>&  points,
+        const std::vector<ViewSphere>&  spotSpheres,
+        const std::vector<ViewCone>&    spotCones,
+        const SliceBins&                pointBins,
+        const SliceBins&                spotBins,
+        asdx::LightClusterRange*        pRanges,
+        std::vector<uint32_t>&          indices
+    )
+    {
+        SetupSlice(slice);
+
+        for(auto i=0u; i<m_TileCount; ++i)
+        {
+            m_PointLists[i].clear();
+            m_SpotLists [i].clear();
+        }
+
+        for(auto i=pointBins.Offsets[slice]; i<pointBins.Offsets[slice + 1]; ++i)
+        {
+            auto index = pointBins.Indices[i];
+            AddSphere(points[index], index, nullptr);
+        }
+
+        for(auto i=spotBins.Offsets[slice]; i<spotBins.Offsets[slice + 1]; ++i)
+        {
+            auto index = spotBins.Indices[i];
+            AddSphere(spotSpheres[index], index, &spotCones[index]);
+        }
+
+        // タイル順にリストを詰める. オフセットはスライス内の相対値.
+        indices.clear();
+        auto base = slice * m_TileCount;
+        for(auto i=0u; i<m_TileCount; ++i)
+        {
+            auto& range = pRanges[base + i];
+            range.Offset     = uint32_t(indices.size());
+            range.PointCount = uint32_t(m_PointLists[i].size());
+            range.SpotCount  = uint32_t(m_SpotLists [i].size());
+            indices.insert(indices.end(), m_PointLists[i].begin(), m_PointLists[i].end());
+            indices.insert(indices.end(), m_SpotLists [i].begin(), m_SpotLists [i].end());
+        }
+    }
+
+private:
+    const asdx::LightClusterDesc&           m_Desc;
+    const ClusterFrame&                     m_Frame;
+    uint32_t                                m_TileCount;
+    float                                   m_NearDepth = 0.0f;
+    float                                   m_FarDepth  = 0.0f;
+    std::vector<float>                      m_ColumnMin;
+    std::vector<float>                      m_ColumnMax;
+    std::vector<float>                      m_RowMin;
+    std::vector<float>                      m_RowMax;
+    std::vector<float>                      m_DistSqX;
+    std::vector<float>                      m_DistSqY;
+    std::vector<asdx::BoundingSphere>       m_Spheres;
+    std::vector<std::vector<uint32_t>>      m_PointLists;
+    std::vector<std::vector<uint32_t>>      m_SpotLists;
+
+    //-------------------------------------------------------------------------
+    //      スライス内のタイルの境界を求めます.
+    //-------------------------------------------------------------------------
+    void SetupSlice(uint32_t slice)
+    {
+        auto d0 = m_Frame.Depths[slice];
+        auto d1 = m_Frame.Depths[slice + 1];
+        m_NearDepth = d0;
+        m_FarDepth  = d1;
+
+        auto calcRange = [d0, d1](float s0, float s1, float& mini, float& maxi)
+        {
+            auto a = s0 * d0;
+            auto b = s0 * d1;
+            auto c = s1 * d0;
+            auto d = s1 * d1;
+            mini = asdx::Min(asdx::Min(a, b), asdx::Min(c, d));
+            maxi = asdx::Max(asdx::Max(a, b), asdx::Max(c, d));
+        };
+
+        for(auto x=0u; x<m_Desc.TileCountX; ++x)
+        { calcRange(m_Frame.SlopeX[x], m_Frame.SlopeX[x + 1], m_ColumnMin[x], m_ColumnMax[x]); }
+
+        for(auto y=0u; y<m_Desc.TileCountY; ++y)
+        { calcRange(m_Frame.SlopeY[y], m_Frame.SlopeY[y + 1], m_RowMin[y], m_RowMax[y]); }
+
+        // スポットライトの円錐判定に使うクラスターの境界球.
+        auto cz = (d0 + d1) * 0.5f;
+        auto ez = (d1 - d0) * 0.5f;
+        for(auto y=0u; y<m_Desc.TileCountY; ++y)
+        {
+            auto cy = (m_RowMin[y] + m_RowMax[y]) * 0.5f;
+            auto ey = (m_RowMax[y] - m_RowMin[y]) * 0.5f;
+            for(auto x=0u; x<m_Desc.TileCountX; ++x)
+            {
+                auto cx = (m_ColumnMin[x] + m_ColumnMax[x]) * 0.5f;
+                auto ex = (m_ColumnMax[x] - m_ColumnMin[x]) * 0.5f;
+                m_Spheres[y * m_Desc.TileCountX + x] = asdx::BoundingSphere(
+                    asdx::Vector3(cx, cy, cz), sqrt(ex * ex + ey * ey + ez * ez));
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      境界球と交差するタイルにライトを追加します.
+    //-------------------------------------------------------------------------
+    void AddSphere(const ViewSphere& sphere, uint32_t index, const ViewCone* pCone)
+    {
+        auto r2 = sphere.Radius * sphere.Radius;
+        auto dz = CalcAxisDistanceSq(sphere.Depth, m_NearDepth, m_FarDepth);
+        if (dz > r2)
+        { return; }
+
+        auto limit = r2 - dz;
+
+        uint32_t x0, x1, y0, y1;
+        if (!FindTileRange(m_ColumnMin.data(), m_ColumnMax.data(), m_Desc.TileCountX, sphere.X, limit, m_DistSqX.data(), x0, x1))
+        { return; }
+        if (!FindTileRange(m_RowMin.data(), m_RowMax.data(), m_Desc.TileCountY, sphere.Y, limit, m_DistSqY.data(), y0, y1))
+        { return; }
+
+        for(auto y=y0; y<=y1; ++y)
+        {
+            for(auto x=x0; x<=x1; ++x)
+            {
+                if ((m_DistSqX[x] + m_DistSqY[y]) + dz > r2)
+                { continue; }
+
+                auto tile = y * m_Desc.TileCountX + x;
+                if (pCone == nullptr)
+                {
+                    m_PointLists[tile].push_back(index);
+                }
+                else if (TestCone(*pCone, m_Spheres[tile].Center, m_Spheres[tile].Radius))
+                {
+                    m_SpotLists[tile].push_back(index);
+                }
+            }
+        }
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      タイルとスライスの境界を求めます.
+//-----------------------------------------------------------------------------
+void SetupFrame(const asdx::LightClusterDesc& desc, const asdx::Matrix& proj, ClusterFrame& frame)
+{
+    auto invProj = asdx::Matrix::Invert(proj);
+
+    // 右手系と左手系のどちらでも奥行が正になるように符号を決める.
+    auto center = Unproject(0.0f, 0.0f, invProj);
+    frame.DepthSign = (center.z < 0.0f) ? -1.0f : 1.0f;
+
+    frame.SlopeX.resize(desc.TileCountX + 1);
+    for(auto i=0u; i<=desc.TileCountX; ++i)
+    {
+        auto p = Unproject(-1.0f + 2.0f * float(i) / float(desc.TileCountX), 0.0f, invProj);
+        frame.SlopeX[i] = p.x / (p.z * frame.DepthSign);
+    }
+
+    frame.SlopeY.resize(desc.TileCountY + 1);
+    for(auto i=0u; i<=desc.TileCountY; ++i)
+    {
+        auto p = Unproject(0.0f, 1.0f - 2.0f * float(i) / float(desc.TileCountY), invProj);
+        frame.SlopeY[i] = p.y / (p.z * frame.DepthSign);
+    }
+
+    frame.Depths.resize(desc.SliceCount + 1);
+    auto ratio = desc.FarClip / desc.NearClip;
+    for(auto i=0u; i<desc.SliceCount; ++i)
+    { frame.Depths[i] = desc.NearClip * pow(ratio, float(i) / float(desc.SliceCount)); }
+    frame.Depths[desc.SliceCount] = desc.FarClip;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と重なる可能性のあるスライスごとにライトを振り分けます.
+//-----------------------------------------------------------------------------
+void BinSlices
+(
+    const asdx::LightClusterDesc&   desc,
+    const ClusterFrame&             frame,
+    const std::vector<ViewSphere>&  spheres,
+    SliceBins&                      bins
+)
+{
+    // スライス境界を二分探索して, SliceWorker の奥行判定と同じ境界値で振り分ける.
+    auto pBegin = frame.Depths.data() + 1;
+    auto pEnd   = frame.Depths.data() + desc.SliceCount;
+
+    std::vector<uint32_t> ranges(spheres.size() * 2);
+    bins.Offsets.assign(desc.SliceCount + 1, 0);
+    for(size_t i=0; i<spheres.size(); ++i)
+    {
+        auto& s = spheres[i];
+        if (s.Depth + s.Radius < desc.NearClip || s.Depth - s.Radius > desc.FarClip)
+        {
+            ranges[i * 2 + 0] = 1;
+            ranges[i * 2 + 1] = 0;
+            continue;
+        }
+
+        auto first = uint32_t(std::lower_bound(pBegin, pEnd, s.Depth - s.Radius) - pBegin);
+        auto last  = uint32_t(std::upper_bound(pBegin, pEnd, s.Depth + s.Radius) - pBegin);
+        ranges[i * 2 + 0] = first;
+        ranges[i * 2 + 1] = last;
+
+        for(auto j=first; j<=last; ++j)
+        { bins.Offsets[j + 1]++; }
+    }
+
+    for(auto i=0u; i<desc.SliceCount; ++i)
+    { bins.Offsets[i + 1] += bins.Offsets[i]; }
+
+    // ライト番号順に格納するため, 各スライス内は昇順になる.
+    std::vector<uint32_t> cursor(bins.Offsets.begin(), bins.Offsets.end() - 1);
+    bins.Indices.resize(bins.Offsets[desc.SliceCount]);
+    for(size_t i=0; i<spheres.size(); ++i)
+    {
+        for(auto j=ranges[i * 2 + 0]; j<=ranges[i * 2 + 1]; ++j)
+        { bins.Indices[cursor[j]++] = uint32_t(i); }
+    }
+}
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      ビュー空間の奥行からスライス番号を求めます.
+//-----------------------------------------------------------------------------
+uint32_t CalcLightClusterSlice(const LightClusterDesc& desc, float viewDepth)
+{
+    if (!(viewDepth > desc.NearClip))
+    { return 0; }
+
+    auto slice = log(viewDepth / desc.NearClip) * float(desc.SliceCount) / log(desc.FarClip / desc.NearClip);
+    if (slice >= float(desc.SliceCount - 1))
+    { return desc.SliceCount - 1; }
+
+    return uint32_t(slice);
+}
+
+//-----------------------------------------------------------------------------
+//      ライトをクラスターに割り当てます.
+//-----------------------------------------------------------------------------
+void AssignLightsToClusters
+(
+    const LightClusterDesc& desc,
+    const Matrix&           view,
+    const Matrix&           proj,
+    const PointLight*       pPointLights,
+    size_t                  pointCount,
+    const SpotLight*        pSpotLights,
+    size_t                  spotCount,
+    LightClusterList&       result,
+    uint32_t                maxThreadCount
+)
+{
+    assert(desc.TileCountX > 0 && desc.TileCountY > 0 && desc.SliceCount > 0);
+    assert(0.0f < desc.NearClip && desc.NearClip < desc.FarClip);
+    assert(pPointLights != nullptr || pointCount == 0);
+    assert(pSpotLights  != nullptr || spotCount  == 0);
+
+    ClusterFrame frame;
+    SetupFrame(desc, proj, frame);
+
+    // ライトをビュー空間に変換する.
+    auto sign = frame.DepthSign;
+    std::vector<ViewSphere> points(pointCount);
+    ParallelFor(pointCount, MIN_BATCH_LIGHT_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            auto& light = pPointLights[i];
+            auto  c = Vector3::Transform(light.GetCenter(), view);
+            points[i] = { c.x, c.y, c.z * sign, light.GetRadius() };
+        }
+    }, maxThreadCount);
+
+    std::vector<ViewSphere> spotSpheres(spotCount);
+    std::vector<ViewCone>   spotCones  (spotCount);
+    ParallelFor(spotCount, MIN_BATCH_LIGHT_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            auto& light  = pSpotLights[i];
+            auto  bounds = light.GetBoundingSphere();
+            auto  c = Vector3::Transform(bounds.Center, view);
+            spotSpheres[i] = { c.x, c.y, c.z * sign, bounds.Radius };
+
+            auto p = Vector3::Transform(light.GetPosition(), view);
+            auto f = Vector3::Normalize(Vector3::TransformNormal(light.GetForward(), view));
+            auto& cone = spotCones[i];
+            cone.Position = Vector3(p.x, p.y, p.z * sign);
+            cone.Forward  = Vector3(f.x, f.y, f.z * sign);
+            cone.Range    = light.GetRadius();
+            cone.CosAngle = cos(light.GetOuterAngle());
+            cone.SinAngle = sin(light.GetOuterAngle());
+        }
+    }, maxThreadCount);
+
+    SliceBins pointBins;
+    SliceBins spotBins;
+    BinSlices(desc, frame, points,      pointBins);
+    BinSlices(desc, frame, spotSpheres, spotBins);
+
+    // スライスごとに並列で割り当てる.
+    result.Ranges.resize(GetLightClusterCount(desc));
+    std::vector<std::vector<uint32_t>> sliceIndices(desc.SliceCount);
+
+    auto batchCount = ParallelFor(desc.SliceCount, 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        SliceWorker worker(desc, frame);
+        for(auto i=begin; i<end; ++i)
+        { worker.Process(uint32_t(i), points, spotSpheres, spotCones, pointBins, spotBins, result.Ranges.data(), sliceIndices[i]); }
+    }, maxThreadCount);
+
+    // スライスの先頭位置を求めて1つのリストに詰める.
+    std::vector<uint32_t> sliceOffsets(desc.SliceCount);
+    size_t totalCount = 0;
+    for(auto i=0u; i<desc.SliceCount; ++i)
+    {
+        sliceOffsets[i] = uint32_t(totalCount);
+        totalCount += sliceIndices[i].size();
+    }
+    assert(totalCount <= UINT32_MAX);
+
+    result.Indices.resize(totalCount);
+
+    auto tileCount = desc.TileCountX * desc.TileCountY;
+    ParallelFor(desc.SliceCount, 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            auto& src = sliceIndices[i];
+            if (!src.empty())
+            { memcpy(result.Indices.data() + sliceOffsets[i], src.data(), src.size() * sizeof(uint32_t)); }
+
+            auto ranges = result.Ranges.data() + i * tileCount;
+            for(auto j=0u; j<tileCount; ++j)
+            { ranges[j].Offset += sliceOffsets[i]; }
+        }
+    }, batchCount);
+}
+
+} // namespace asdx
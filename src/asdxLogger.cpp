@@ -9,12 +9,16 @@
 //-------------------------------------------------------------------------------------------------
 #include <cstdio>
 #include <cstdarg>
+#include <cwchar>
+#if defined(_WIN32)
 #include <Windows.h>
+#endif//defined(_WIN32)
 #include <asdxLogger.h>
 
 
 namespace /* anonymous */ {
 
+#if defined(_WIN32)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // ConsoleColor class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -92,6 +96,18 @@ private:
     //=============================================================================================
     /* NOTHING */
 };
+#else
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ConsoleColor class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ConsoleColor
+{
+public:
+    // 出力先が端末とは限らないため, Windows以外ではカラー設定を行わない.
+    void Bind(asdx::LogLevel) { /* DO_NOTHING */ }
+    void Unbind() { /* DO_NOTHING */ }
+};
+#endif//defined(_WIN32)
 
 }// namespace /* anonymous */
 
@@ -134,12 +150,14 @@ void SystemLogger::LogA( const LogLevel level, const char* format, ... )
             va_list arg;
 
             va_start( arg, format );
-            vsprintf_s( msg, format, arg );
+            vsnprintf( msg, sizeof(msg), format, arg );
             va_end( arg );
 
-            printf_s( "%s", msg );
+            printf( "%s", msg );
 
+        #if defined(_WIN32)
             OutputDebugStringA( msg );
+        #endif//defined(_WIN32)
         }
 
         // カラー設定解除.
@@ -166,12 +184,14 @@ void SystemLogger::LogW( const LogLevel level, const wchar_t* format, ... )
             va_list arg;
 
             va_start( arg, format );
-            vswprintf_s( msg, format, arg );
+            vswprintf( msg, sizeof(msg) / sizeof(msg[0]), format, arg );
             va_end( arg );
 
-            wprintf_s( L"%s", msg );
+            wprintf( L"%ls", msg );
 
+        #if defined(_WIN32)
             OutputDebugStringW( msg );
+        #endif//defined(_WIN32)
         }
 
         // カラー設定解除.
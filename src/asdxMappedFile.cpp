@@ -0,0 +1,165 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMappedFile.cpp
+// Desc : Memory Mapped File.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxMappedFile.h>
+#include <asdxLogger.h>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{ Close(); }
+
+//-----------------------------------------------------------------------------
+//      ファイルを読み取り専用でメモリにマップします.
+//-----------------------------------------------------------------------------
+bool MappedFile::Open(const char* filename)
+{
+    Close();
+
+    if (filename == nullptr)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+#if defined(_WIN32)
+    auto hFile = CreateFileA(
+        filename,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        ELOGA("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(hFile, &size))
+    {
+        ELOGA("Error : GetFileSizeEx() Failed. path = %s", filename);
+        CloseHandle(hFile);
+        return false;
+    }
+
+    m_hFile  = hFile;
+    m_Size   = size_t(size.QuadPart);
+    m_IsOpen = true;
+
+    if (m_Size == 0)
+    { return true; }
+
+    m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hMapping == nullptr)
+    {
+        ELOGA("Error : CreateFileMappingA() Failed. path = %s", filename);
+        Close();
+        return false;
+    }
+
+    m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_pData == nullptr)
+    {
+        ELOGA("Error : MapViewOfFile() Failed. path = %s", filename);
+        Close();
+        return false;
+    }
+#else
+    auto handle = open(filename, O_RDONLY);
+    if (handle < 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
+
+    struct stat info = {};
+    if (fstat(handle, &info) != 0)
+    {
+        ELOGA("Error : fstat() Failed. path = %s", filename);
+        close(handle);
+        return false;
+    }
+
+    m_Handle = handle;
+    m_Size   = size_t(info.st_size);
+    m_IsOpen = true;
+
+    if (m_Size == 0)
+    { return true; }
+
+    auto ptr = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, handle, 0);
+    if (ptr == MAP_FAILED)
+    {
+        ELOGA("Error : mmap() Failed. path = %s", filename);
+        Close();
+        return false;
+    }
+
+    m_pData = static_cast<const uint8_t*>(ptr);
+#endif
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      マップを解除してファイルを閉じます.
+//-----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+    if (m_pData != nullptr)
+    { UnmapViewOfFile(m_pData); }
+
+    if (m_hMapping != nullptr)
+    { CloseHandle(m_hMapping); }
+
+    if (m_hFile != nullptr)
+    { CloseHandle(m_hFile); }
+
+    m_hMapping = nullptr;
+    m_hFile    = nullptr;
+#else
+    if (m_pData != nullptr)
+    { munmap(const_cast<uint8_t*>(m_pData), m_Size); }
+
+    if (m_Handle >= 0)
+    { close(m_Handle); }
+
+    m_Handle = -1;
+#endif
+
+    m_pData  = nullptr;
+    m_Size   = 0;
+    m_IsOpen = false;
+}
+
+} // namespace asdx
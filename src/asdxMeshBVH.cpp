@@ -0,0 +1,1530 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMeshBVH.cpp
+// Desc : Bounding Volume Hierarchy for Mesh Triangles.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <asdxMeshBVH.h>
+#include <asdxParallel.h>
+#include <asdxLogger.h>
+
+#if defined(ASDX_ENABLE_SIMD)
+#include <asdxSimd.h>
+#endif//defined(ASDX_ENABLE_SIMD)
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   BIN_COUNT               = 16;           // SAH のビン数.
+static constexpr uint32_t   PARALLEL_RANGE_SIZE     = 1u << 16;     // ビン分割を並列化する最小要素数.
+static constexpr uint32_t   SUBTREE_SIZE            = 1u << 12;     // 部分木を並列に構築する要素数の上限.
+static constexpr float      TRAVERSAL_COST          = 1.0f;         // ノードを辿るコスト(三角形の交差判定を1とする).
+static constexpr float      MIN_DIRECTION           = 1e-30f;       // 逆数を求める方向成分の最小値.
+
+///////////////////////////////////////////////////////////////////////////////
+// BuildRange structure
+///////////////////////////////////////////////////////////////////////////////
+struct BuildRange
+{
+    uint32_t    Node;       // ノード番号.
+    uint32_t    Begin;      // 先頭の要素.
+    uint32_t    End;        // 終端の要素.
+    uint32_t    Depth;      // 深さ.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BinSet structure
+///////////////////////////////////////////////////////////////////////////////
+struct BinSet
+{
+    asdx::BoundingBox   Bounds[3][BIN_COUNT];   // 軸ごとのビンの境界箱.
+    uint32_t            Count [3][BIN_COUNT];   // 軸ごとのビンの要素数.
+
+    void Clear()
+    {
+        for(auto axis=0; axis<3; ++axis)
+        {
+            for(auto i=0u; i<BIN_COUNT; ++i)
+            {
+                Bounds[axis][i] = asdx::BoundingBox();
+                Count [axis][i] = 0;
+            }
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// HierarchyBuilder class
+///////////////////////////////////////////////////////////////////////////////
+class HierarchyBuilder
+{
+public:
+    //-------------------------------------------------------------------------
+    //      境界箱の配列から階層を構築します.
+    //-------------------------------------------------------------------------
+    void Build
+    (
+        const std::vector<asdx::BoundingBox>&   bounds,
+        const std::vector<asdx::Vector3>&       centers,
+        uint32_t                                leafSize,
+        uint32_t                                maxThreadCount,
+        std::vector<asdx::MeshBVHNode>&         nodes,
+        std::vector<uint32_t>&                  order
+    )
+    {
+        m_pBounds        = bounds.data();
+        m_pCenters       = centers.data();
+        m_LeafSize       = leafSize;
+        m_MaxThreadCount = maxThreadCount;
+
+        auto count = uint32_t(bounds.size());
+        nodes.clear();
+        order.resize(count);
+        for(auto i=0u; i<count; ++i)
+        { order[i] = i; }
+
+        if (count == 0)
+        { return; }
+
+        m_pOrder = order.data();
+        m_BinSets.resize(asdx::GetWorkerThreadCount(maxThreadCount));
+
+        // 上位の階層は幅優先で分割し, 小さくなった範囲は部分木として並列に構築する.
+        // 分割はスレッド数に依存しないので, 結果も依存しない.
+        std::vector<BuildRange> subtrees;
+        std::vector<BuildRange> queue;
+        queue.push_back({ 0, 0, count, 0 });
+        nodes.push_back(asdx::MeshBVHNode());
+
+        for(size_t head=0; head<queue.size(); ++head)
+        {
+            auto range = queue[head];
+            if (range.End - range.Begin <= SUBTREE_SIZE)
+            {
+                subtrees.push_back(range);
+                continue;
+            }
+
+            uint32_t mid;
+            auto split = SplitRange(range, nodes[range.Node], mid, true);
+            if (!split)
+            { continue; }
+
+            auto left = uint32_t(nodes.size());
+            nodes[range.Node].Offset = left;
+            nodes[range.Node].Count  = 0;
+            nodes.push_back(asdx::MeshBVHNode());
+            nodes.push_back(asdx::MeshBVHNode());
+
+            queue.push_back({ left,     range.Begin, mid,       range.Depth + 1 });
+            queue.push_back({ left + 1, mid,         range.End, range.Depth + 1 });
+        }
+
+        std::vector<std::vector<asdx::MeshBVHNode>> locals(subtrees.size());
+        asdx::ParallelFor(subtrees.size(), 1, [&](uint32_t, size_t begin, size_t end)
+        {
+            for(auto i=begin; i<end; ++i)
+            { BuildSubtree(subtrees[i], locals[i]); }
+        }, maxThreadCount);
+
+        // 部分木の根は上位の階層のノードを置き換え, 残りは末尾に追加する.
+        for(size_t i=0; i<subtrees.size(); ++i)
+        {
+            auto& local = locals[i];
+            auto  base  = uint32_t(nodes.size()) - 1;
+
+            for(auto& node : local)
+            {
+                if (node.Count == 0)
+                { node.Offset += base; }
+            }
+
+            nodes[subtrees[i].Node] = local[0];
+            nodes.insert(nodes.end(), local.begin() + 1, local.end());
+        }
+    }
+
+private:
+    const asdx::BoundingBox*    m_pBounds           = nullptr;
+    const asdx::Vector3*        m_pCenters          = nullptr;
+    uint32_t*                   m_pOrder            = nullptr;
+    uint32_t                    m_LeafSize          = 1;
+    uint32_t                    m_MaxThreadCount    = 0;
+    std::vector<BinSet>         m_BinSets;
+
+    //-------------------------------------------------------------------------
+    //      部分木を構築します.
+    //-------------------------------------------------------------------------
+    void BuildSubtree(const BuildRange& root, std::vector<asdx::MeshBVHNode>& nodes)
+    {
+        std::vector<BuildRange> stack;
+        stack.push_back({ 0, root.Begin, root.End, root.Depth });
+        nodes.push_back(asdx::MeshBVHNode());
+
+        while(!stack.empty())
+        {
+            auto range = stack.back();
+            stack.pop_back();
+
+            uint32_t mid;
+            if (!SplitRange(range, nodes[range.Node], mid, false))
+            { continue; }
+
+            auto left = uint32_t(nodes.size());
+            nodes[range.Node].Offset = left;
+            nodes[range.Node].Count  = 0;
+            nodes.push_back(asdx::MeshBVHNode());
+            nodes.push_back(asdx::MeshBVHNode());
+
+            stack.push_back({ left + 1, mid,         range.End, range.Depth + 1 });
+            stack.push_back({ left,     range.Begin, mid,       range.Depth + 1 });
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      範囲の境界箱と中心の境界箱を求めます.
+    //-------------------------------------------------------------------------
+    void CalcRangeBounds(const BuildRange& range, bool parallel, asdx::BoundingBox& bounds, asdx::BoundingBox& centers)
+    {
+        auto count = range.End - range.Begin;
+        if (!parallel || count < PARALLEL_RANGE_SIZE)
+        {
+            for(auto i=range.Begin; i<range.End; ++i)
+            {
+                auto index = m_pOrder[i];
+                bounds .Merge(m_pBounds [index]);
+                centers.Merge(m_pCenters[index]);
+            }
+            return;
+        }
+
+        // 最小値と最大値の統合は順序に依存しない.
+        auto& sets = m_BinSets;
+        for(auto& set : sets)
+        {
+            set.Bounds[0][0] = asdx::BoundingBox();
+            set.Bounds[0][1] = asdx::BoundingBox();
+        }
+
+        auto batches = asdx::ParallelFor(count, PARALLEL_RANGE_SIZE / 4, [&](uint32_t batch, size_t begin, size_t end)
+        {
+            auto& set = sets[batch];
+            for(auto i=begin; i<end; ++i)
+            {
+                auto index = m_pOrder[range.Begin + i];
+                set.Bounds[0][0].Merge(m_pBounds [index]);
+                set.Bounds[0][1].Merge(m_pCenters[index]);
+            }
+        }, m_MaxThreadCount);
+
+        for(auto i=0u; i<batches; ++i)
+        {
+            bounds .Merge(sets[i].Bounds[0][0]);
+            centers.Merge(sets[i].Bounds[0][1]);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      ビン番号を求めます.
+    //-------------------------------------------------------------------------
+    static uint32_t GetBin(float value, float minimum, float scale)
+    {
+        auto bin = int((value - minimum) * scale);
+        return uint32_t(asdx::Clamp(bin, 0, int(BIN_COUNT) - 1));
+    }
+
+    //-------------------------------------------------------------------------
+    //      要素をビンに振り分けます.
+    //-------------------------------------------------------------------------
+    void FillBins(const BuildRange& range, bool parallel, const asdx::BoundingBox& centers, const float* scales, BinSet& result)
+    {
+        auto fill = [&](BinSet& set, size_t begin, size_t end)
+        {
+            for(auto i=begin; i<end; ++i)
+            {
+                auto index = m_pOrder[i];
+                for(auto axis=0; axis<3; ++axis)
+                {
+                    if (scales[axis] <= 0.0f)
+                    { continue; }
+
+                    auto bin = GetBin(m_pCenters[index][axis], centers.Min[axis], scales[axis]);
+                    set.Bounds[axis][bin].Merge(m_pBounds[index]);
+                    set.Count [axis][bin]++;
+                }
+            }
+        };
+
+        result.Clear();
+
+        auto count = range.End - range.Begin;
+        if (!parallel || count < PARALLEL_RANGE_SIZE)
+        {
+            fill(result, range.Begin, range.End);
+            return;
+        }
+
+        auto& sets = m_BinSets;
+        auto batches = asdx::ParallelFor(count, PARALLEL_RANGE_SIZE / 4, [&](uint32_t batch, size_t begin, size_t end)
+        {
+            sets[batch].Clear();
+            fill(sets[batch], range.Begin + begin, range.Begin + end);
+        }, m_MaxThreadCount);
+
+        for(auto i=0u; i<batches; ++i)
+        {
+            for(auto axis=0; axis<3; ++axis)
+            {
+                for(auto j=0u; j<BIN_COUNT; ++j)
+                {
+                    result.Bounds[axis][j].Merge(sets[i].Bounds[axis][j]);
+                    result.Count [axis][j] += sets[i].Count[axis][j];
+                }
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      表面積の半分を求めます.
+    //-------------------------------------------------------------------------
+    static float HalfArea(const asdx::BoundingBox& box)
+    {
+        auto size = box.Max - box.Min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    //-------------------------------------------------------------------------
+    //      範囲を分割します. 葉ノードにした場合は false を返却します.
+    //-------------------------------------------------------------------------
+    bool SplitRange(const BuildRange& range, asdx::MeshBVHNode& node, uint32_t& mid, bool parallel)
+    {
+        asdx::BoundingBox bounds;
+        asdx::BoundingBox centers;
+        CalcRangeBounds(range, parallel, bounds, centers);
+
+        node.Min[0] = bounds.Min.x; node.Min[1] = bounds.Min.y; node.Min[2] = bounds.Min.z;
+        node.Max[0] = bounds.Max.x; node.Max[1] = bounds.Max.y; node.Max[2] = bounds.Max.z;
+        node.Offset = range.Begin;
+        node.Count  = range.End - range.Begin;
+
+        // 探索スタックを超えないように深さを制限する.
+        auto count = range.End - range.Begin;
+        if (count <= 1 || range.Depth + 2 >= asdx::MESH_BVH_MAX_DEPTH)
+        { return false; }
+
+        float scales[3];
+        for(auto axis=0; axis<3; ++axis)
+        {
+            auto extent = centers.Max[axis] - centers.Min[axis];
+            scales[axis] = (extent > 0.0f) ? float(BIN_COUNT) * 0.9999f / extent : 0.0f;
+        }
+
+        BinSet bins;
+        FillBins(range, parallel, centers, scales, bins);
+
+        // 左右の表面積と要素数の積の和が最小となる区切りを探す.
+        auto bestCost  = FLT_MAX;
+        auto bestAxis  = -1;
+        auto bestSplit = 0u;
+        for(auto axis=0; axis<3; ++axis)
+        {
+            if (scales[axis] <= 0.0f)
+            { continue; }
+
+            float    rightCost[BIN_COUNT];
+            asdx::BoundingBox right;
+            uint32_t rightCount = 0;
+            for(auto i=BIN_COUNT - 1; i>0; --i)
+            {
+                right.Merge(bins.Bounds[axis][i]);
+                rightCount += bins.Count[axis][i];
+                rightCost[i] = (rightCount > 0) ? HalfArea(right) * float(rightCount) : 0.0f;
+            }
+
+            asdx::BoundingBox left;
+            uint32_t leftCount = 0;
+            for(auto i=0u; i<BIN_COUNT - 1; ++i)
+            {
+                left.Merge(bins.Bounds[axis][i]);
+                leftCount += bins.Count[axis][i];
+                if (leftCount == 0 || leftCount == count)
+                { continue; }
+
+                auto cost = HalfArea(left) * float(leftCount) + rightCost[i + 1];
+                if (cost < bestCost)
+                {
+                    bestCost  = cost;
+                    bestAxis  = axis;
+                    bestSplit = i + 1;
+                }
+            }
+        }
+
+        if (bestAxis < 0)
+        {
+            // 中心が全て一致する場合は要素数で半分に分ける.
+            if (count <= m_LeafSize)
+            { return false; }
+
+            mid = range.Begin + count / 2;
+            return true;
+        }
+
+        auto area = HalfArea(bounds);
+        auto splitCost = TRAVERSAL_COST + ((area > 0.0f) ? bestCost / area : float(count));
+        if (count <= m_LeafSize && splitCost >= float(count))
+        { return false; }
+
+        auto axis    = bestAxis;
+        auto minimum = centers.Min[axis];
+        auto scale   = scales[axis];
+        auto pMid = std::partition(m_pOrder + range.Begin, m_pOrder + range.End, [&](uint32_t index)
+        { return GetBin(m_pCenters[index][axis], minimum, scale) < bestSplit; });
+
+        mid = uint32_t(pMid - m_pOrder);
+        return true;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// RayContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct RayContext
+{
+    asdx::Vector3   Origin;
+    asdx::Vector3   Direction;
+    asdx::Vector3   InvDirection;
+    float           MinT;
+};
+
+//-----------------------------------------------------------------------------
+//      0除算を避けた逆数を求めます.
+//-----------------------------------------------------------------------------
+inline float SafeInverse(float value)
+{
+    if (fabsf(value) < MIN_DIRECTION)
+    { value = (value < 0.0f) ? -MIN_DIRECTION : MIN_DIRECTION; }
+    return 1.0f / value;
+}
+
+//-----------------------------------------------------------------------------
+//      レイの交差判定の準備をします.
+//-----------------------------------------------------------------------------
+inline RayContext CreateRayContext(const asdx::Ray& ray)
+{
+    RayContext result;
+    result.Origin       = ray.Origin;
+    result.Direction    = ray.Direction;
+    result.InvDirection = asdx::Vector3(
+        SafeInverse(ray.Direction.x),
+        SafeInverse(ray.Direction.y),
+        SafeInverse(ray.Direction.z));
+    result.MinT         = ray.MinT;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      レイとノードの境界箱の交差判定を行います.
+//-----------------------------------------------------------------------------
+inline bool IntersectNode(const asdx::MeshBVHNode& node, const RayContext& ray, float maxT, float& nearT)
+{
+    auto tx0 = (node.Min[0] - ray.Origin.x) * ray.InvDirection.x;
+    auto tx1 = (node.Max[0] - ray.Origin.x) * ray.InvDirection.x;
+    auto ty0 = (node.Min[1] - ray.Origin.y) * ray.InvDirection.y;
+    auto ty1 = (node.Max[1] - ray.Origin.y) * ray.InvDirection.y;
+    auto tz0 = (node.Min[2] - ray.Origin.z) * ray.InvDirection.z;
+    auto tz1 = (node.Max[2] - ray.Origin.z) * ray.InvDirection.z;
+
+    auto t0 = asdx::Max(asdx::Max(ray.MinT, asdx::Min(tx0, tx1)), asdx::Max(asdx::Min(ty0, ty1), asdx::Min(tz0, tz1)));
+    auto t1 = asdx::Min(asdx::Min(maxT,     asdx::Max(tx0, tx1)), asdx::Min(asdx::Max(ty0, ty1), asdx::Max(tz0, tz1)));
+
+    nearT = t0;
+    return t0 <= t1;
+}
+
+//-----------------------------------------------------------------------------
+//      レイと三角形の交差判定を行います(Moller-Trumbore).
+//-----------------------------------------------------------------------------
+inline bool IntersectTriangle
+(
+    const asdx::Vector3&    v0,
+    const asdx::Vector3&    e1,
+    const asdx::Vector3&    e2,
+    const RayContext&       ray,
+    float                   maxT,
+    float&                  t,
+    float&                  u,
+    float&                  v
+)
+{
+    auto p   = asdx::Vector3::Cross(ray.Direction, e2);
+    auto det = asdx::Vector3::Dot(e1, p);
+    if (det == 0.0f)
+    { return false; }
+
+    auto invDet = 1.0f / det;
+    auto s = ray.Origin - v0;
+    u = asdx::Vector3::Dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f)
+    { return false; }
+
+    auto q = asdx::Vector3::Cross(s, e1);
+    v = asdx::Vector3::Dot(ray.Direction, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f)
+    { return false; }
+
+    t = asdx::Vector3::Dot(e2, q) * invDet;
+    return t >= ray.MinT && t < maxT;
+}
+
+//-----------------------------------------------------------------------------
+//      三角形上で点に最も近い点を求めます(Real-Time Collision Detection 5.1.5).
+//-----------------------------------------------------------------------------
+asdx::Vector3 ClosestPointOnTriangle
+(
+    const asdx::Vector3& p,
+    const asdx::Vector3& a,
+    const asdx::Vector3& b,
+    const asdx::Vector3& c
+)
+{
+    auto ab = b - a;
+    auto ac = c - a;
+    auto ap = p - a;
+    auto d1 = asdx::Vector3::Dot(ab, ap);
+    auto d2 = asdx::Vector3::Dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+    { return a; }
+
+    auto bp = p - b;
+    auto d3 = asdx::Vector3::Dot(ab, bp);
+    auto d4 = asdx::Vector3::Dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+    { return b; }
+
+    auto vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+    { return a + ab * (d1 / (d1 - d3)); }
+
+    auto cp = p - c;
+    auto d5 = asdx::Vector3::Dot(ab, cp);
+    auto d6 = asdx::Vector3::Dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+    { return c; }
+
+    auto vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+    { return a + ac * (d2 / (d2 - d6)); }
+
+    auto va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+    { return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))); }
+
+    // 縮退した三角形では分母が0になるので, 辺上の点を返す.
+    auto sum = va + vb + vc;
+    if (sum == 0.0f)
+    { return a; }
+
+    auto denom = 1.0f / sum;
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+//-----------------------------------------------------------------------------
+//      点と境界箱の距離の2乗を求めます.
+//-----------------------------------------------------------------------------
+inline float DistanceSq(const asdx::Vector3& point, const asdx::BoundingBox& box)
+{
+    auto d = asdx::Vector3::Max(asdx::Vector3::Max(box.Min - point, point - box.Max), asdx::Vector3(0.0f, 0.0f, 0.0f));
+    return asdx::Vector3::Dot(d, d);
+}
+
+//-----------------------------------------------------------------------------
+//      ノードの境界箱を取得します.
+//-----------------------------------------------------------------------------
+inline asdx::BoundingBox GetNodeBounds(const asdx::MeshBVHNode& node, const asdx::Matrix* pWorld)
+{
+    asdx::BoundingBox box(
+        asdx::Vector3(node.Min[0], node.Min[1], node.Min[2]),
+        asdx::Vector3(node.Max[0], node.Max[1], node.Max[2]));
+    return (pWorld != nullptr) ? asdx::BoundingBox::Transform(box, *pWorld) : box;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PacketContext structure
+///////////////////////////////////////////////////////////////////////////////
+template<uint32_t N>
+struct alignas(16) PacketContext
+{
+    float   OriginX[N];
+    float   OriginY[N];
+    float   OriginZ[N];
+    float   DirectionX[N];
+    float   DirectionY[N];
+    float   DirectionZ[N];
+    float   InvX[N];
+    float   InvY[N];
+    float   InvZ[N];
+    float   MinT[N];
+    float   MaxT[N];    // 現在の最も近い交差距離.
+    float   U[N];
+    float   V[N];
+    uint32_t Triangle[N];
+
+    //-------------------------------------------------------------------------
+    //      レイパケットと交差情報から初期化します.
+    //-------------------------------------------------------------------------
+    void Init(const asdx::RayPacket<N>& packet, const asdx::RayHit* pHits)
+    {
+        for(auto i=0u; i<N; ++i)
+        {
+            OriginX   [i] = packet.OriginX[i];
+            OriginY   [i] = packet.OriginY[i];
+            OriginZ   [i] = packet.OriginZ[i];
+            DirectionX[i] = packet.DirectionX[i];
+            DirectionY[i] = packet.DirectionY[i];
+            DirectionZ[i] = packet.DirectionZ[i];
+            InvX      [i] = SafeInverse(packet.DirectionX[i]);
+            InvY      [i] = SafeInverse(packet.DirectionY[i]);
+            InvZ      [i] = SafeInverse(packet.DirectionZ[i]);
+            MinT      [i] = packet.MinT[i];
+            MaxT      [i] = asdx::Min(packet.MaxT[i], pHits[i].Distance);
+            U         [i] = 0.0f;
+            V         [i] = 0.0f;
+            Triangle  [i] = asdx::MESH_BVH_INVALID_INDEX;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      ノードと交差するレーンのマスクを求めます.
+    //-------------------------------------------------------------------------
+    uint32_t IntersectNode(const asdx::MeshBVHNode& node, float& nearT) const
+    {
+        uint32_t mask = 0;
+        nearT = FLT_MAX;
+
+    #if defined(ASDX_ENABLE_SIMD)
+        auto minX = _mm_set1_ps(node.Min[0]);
+        auto minY = _mm_set1_ps(node.Min[1]);
+        auto minZ = _mm_set1_ps(node.Min[2]);
+        auto maxX = _mm_set1_ps(node.Max[0]);
+        auto maxY = _mm_set1_ps(node.Max[1]);
+        auto maxZ = _mm_set1_ps(node.Max[2]);
+        auto tnear = _mm_set1_ps(FLT_MAX);
+
+        for(auto i=0u; i<N; i+=4)
+        {
+            auto ox = _mm_load_ps(OriginX + i);
+            auto oy = _mm_load_ps(OriginY + i);
+            auto oz = _mm_load_ps(OriginZ + i);
+            auto ix = _mm_load_ps(InvX + i);
+            auto iy = _mm_load_ps(InvY + i);
+            auto iz = _mm_load_ps(InvZ + i);
+
+            auto tx0 = _mm_mul_ps(_mm_sub_ps(minX, ox), ix);
+            auto tx1 = _mm_mul_ps(_mm_sub_ps(maxX, ox), ix);
+            auto ty0 = _mm_mul_ps(_mm_sub_ps(minY, oy), iy);
+            auto ty1 = _mm_mul_ps(_mm_sub_ps(maxY, oy), iy);
+            auto tz0 = _mm_mul_ps(_mm_sub_ps(minZ, oz), iz);
+            auto tz1 = _mm_mul_ps(_mm_sub_ps(maxZ, oz), iz);
+
+            auto t0 = _mm_max_ps(_mm_max_ps(_mm_load_ps(MinT + i), _mm_min_ps(tx0, tx1)), _mm_max_ps(_mm_min_ps(ty0, ty1), _mm_min_ps(tz0, tz1)));
+            auto t1 = _mm_min_ps(_mm_min_ps(_mm_load_ps(MaxT + i), _mm_max_ps(tx0, tx1)), _mm_min_ps(_mm_max_ps(ty0, ty1), _mm_max_ps(tz0, tz1)));
+
+            auto hit = _mm_cmple_ps(t0, t1);
+            mask |= uint32_t(_mm_movemask_ps(hit)) << i;
+            tnear = _mm_min_ps(tnear, _mm_or_ps(_mm_and_ps(hit, t0), _mm_andnot_ps(hit, _mm_set1_ps(FLT_MAX))));
+        }
+
+        tnear = _mm_min_ps(tnear, ASDX_SWIZZLE(tnear, 2, 3, 0, 1));
+        tnear = _mm_min_ps(tnear, ASDX_SWIZZLE(tnear, 1, 0, 3, 2));
+        nearT = _mm_cvtss_f32(tnear);
+    #else
+        for(auto i=0u; i<N; ++i)
+        {
+            auto tx0 = (node.Min[0] - OriginX[i]) * InvX[i];
+            auto tx1 = (node.Max[0] - OriginX[i]) * InvX[i];
+            auto ty0 = (node.Min[1] - OriginY[i]) * InvY[i];
+            auto ty1 = (node.Max[1] - OriginY[i]) * InvY[i];
+            auto tz0 = (node.Min[2] - OriginZ[i]) * InvZ[i];
+            auto tz1 = (node.Max[2] - OriginZ[i]) * InvZ[i];
+
+            auto t0 = asdx::Max(asdx::Max(MinT[i], asdx::Min(tx0, tx1)), asdx::Max(asdx::Min(ty0, ty1), asdx::Min(tz0, tz1)));
+            auto t1 = asdx::Min(asdx::Min(MaxT[i], asdx::Max(tx0, tx1)), asdx::Min(asdx::Max(ty0, ty1), asdx::Max(tz0, tz1)));
+            if (t0 <= t1)
+            {
+                mask |= 1u << i;
+                nearT = asdx::Min(nearT, t0);
+            }
+        }
+    #endif
+        return mask;
+    }
+
+    //-------------------------------------------------------------------------
+    //      三角形と交差判定を行い, 近い交差があれば更新します.
+    //-------------------------------------------------------------------------
+    void IntersectTriangle(const asdx::Vector3& v0, const asdx::Vector3& e1, const asdx::Vector3& e2, uint32_t triangle)
+    {
+    #if defined(ASDX_ENABLE_SIMD)
+        auto v0x = _mm_set1_ps(v0.x);
+        auto v0y = _mm_set1_ps(v0.y);
+        auto v0z = _mm_set1_ps(v0.z);
+        auto e1x = _mm_set1_ps(e1.x);
+        auto e1y = _mm_set1_ps(e1.y);
+        auto e1z = _mm_set1_ps(e1.z);
+        auto e2x = _mm_set1_ps(e2.x);
+        auto e2y = _mm_set1_ps(e2.y);
+        auto e2z = _mm_set1_ps(e2.z);
+        auto zero = _mm_setzero_ps();
+        auto one  = _mm_set1_ps(1.0f);
+        auto id   = _mm_castsi128_ps(_mm_set1_epi32(int(triangle)));
+
+        for(auto i=0u; i<N; i+=4)
+        {
+            auto dx = _mm_load_ps(DirectionX + i);
+            auto dy = _mm_load_ps(DirectionY + i);
+            auto dz = _mm_load_ps(DirectionZ + i);
+
+            // p = cross(d, e2), det = dot(e1, p).
+            auto px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            auto py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            auto pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            auto det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            auto invDet = _mm_div_ps(one, det);
+
+            auto sx = _mm_sub_ps(_mm_load_ps(OriginX + i), v0x);
+            auto sy = _mm_sub_ps(_mm_load_ps(OriginY + i), v0y);
+            auto sz = _mm_sub_ps(_mm_load_ps(OriginZ + i), v0z);
+            auto u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+
+            // q = cross(s, e1).
+            auto qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            auto qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            auto qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            auto v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+            auto t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+            auto maxT = _mm_load_ps(MaxT + i);
+            auto hit = _mm_cmpneq_ps(det, zero);
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(u, one));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(t, _mm_load_ps(MinT + i)));
+            hit = _mm_and_ps(hit, _mm_cmplt_ps(t, maxT));
+            if (_mm_movemask_ps(hit) == 0)
+            { continue; }
+
+            _mm_store_ps(MaxT + i, asdx::SimdSelect(hit, t, maxT));
+            _mm_store_ps(U + i, asdx::SimdSelect(hit, u, _mm_load_ps(U + i)));
+            _mm_store_ps(V + i, asdx::SimdSelect(hit, v, _mm_load_ps(V + i)));
+            auto pTriangle = reinterpret_cast<float*>(Triangle + i);
+            _mm_store_ps(pTriangle, asdx::SimdSelect(hit, id, _mm_load_ps(pTriangle)));
+        }
+    #else
+        for(auto i=0u; i<N; ++i)
+        {
+            RayContext ray;
+            ray.Origin    = asdx::Vector3(OriginX[i], OriginY[i], OriginZ[i]);
+            ray.Direction = asdx::Vector3(DirectionX[i], DirectionY[i], DirectionZ[i]);
+            ray.MinT      = MinT[i];
+
+            float t, u, v;
+            if (::IntersectTriangle(v0, e1, e2, ray, MaxT[i], t, u, v))
+            {
+                MaxT    [i] = t;
+                U       [i] = u;
+                V       [i] = v;
+                Triangle[i] = triangle;
+            }
+        }
+    #endif
+    }
+};
+
+} // namespace
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshBVH class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      階層を構築します.
+//-----------------------------------------------------------------------------
+bool MeshBVH::Build(const ResMesh& mesh, uint32_t maxThreadCount)
+{
+    m_Nodes          .clear();
+    m_Triangles      .clear();
+    m_TriangleIndices.clear();
+
+    if (mesh.Indices.size() % 3 != 0 || mesh.Indices.size() / 3 >= MESH_BVH_INVALID_INDEX)
+    {
+        ELOGA("Error : Invalid Index Count. count = %zu", mesh.Indices.size());
+        return false;
+    }
+
+    auto vertexCount = mesh.Positions.size();
+    for(auto& index : mesh.Indices)
+    {
+        if (index >= vertexCount)
+        {
+            ELOGA("Error : Index Out Of Range. index = %u", index);
+            return false;
+        }
+    }
+
+    auto triangleCount = mesh.Indices.size() / 3;
+    std::vector<BoundingBox> bounds (triangleCount);
+    std::vector<Vector3>     centers(triangleCount);
+
+    ParallelFor(triangleCount, SUBTREE_SIZE, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            auto& p0 = mesh.Positions[mesh.Indices[i * 3 + 0]];
+            auto& p1 = mesh.Positions[mesh.Indices[i * 3 + 1]];
+            auto& p2 = mesh.Positions[mesh.Indices[i * 3 + 2]];
+            bounds [i] = BoundingBox(Vector3::Min(p0, Vector3::Min(p1, p2)), Vector3::Max(p0, Vector3::Max(p1, p2)));
+            centers[i] = (bounds[i].Min + bounds[i].Max) * 0.5f;
+        }
+    }, maxThreadCount);
+
+    HierarchyBuilder builder;
+    builder.Build(bounds, centers, MESH_BVH_LEAF_SIZE, maxThreadCount, m_Nodes, m_TriangleIndices);
+
+    // 葉ノードの順に三角形を並べ替えてキャッシュ効率を上げる.
+    m_Triangles.resize(triangleCount);
+    ParallelFor(triangleCount, SUBTREE_SIZE, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            auto  index = m_TriangleIndices[i];
+            auto& p0    = mesh.Positions[mesh.Indices[index * 3 + 0]];
+            auto& p1    = mesh.Positions[mesh.Indices[index * 3 + 1]];
+            auto& p2    = mesh.Positions[mesh.Indices[index * 3 + 2]];
+            m_Triangles[i].V0 = p0;
+            m_Triangles[i].E1 = p1 - p0;
+            m_Triangles[i].E2 = p2 - p0;
+        }
+    }, maxThreadCount);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      レイと最も近い交差を求めます.
+//-----------------------------------------------------------------------------
+bool MeshBVH::Intersect(const Ray& ray, RayHit& hit) const
+{
+    hit = RayHit();
+    return IntersectImpl<false>(ray, hit);
+}
+
+//-----------------------------------------------------------------------------
+//      レイがいずれかの三角形と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+bool MeshBVH::Occluded(const Ray& ray) const
+{
+    RayHit hit;
+    return IntersectImpl<true>(ray, hit);
+}
+
+//-----------------------------------------------------------------------------
+//      レイとの交差判定を行います. hit.Distance より近い交差のみ更新します.
+//-----------------------------------------------------------------------------
+template<bool AnyHit>
+bool MeshBVH::IntersectImpl(const Ray& ray, RayHit& hit) const
+{
+    if (m_Nodes.empty())
+    { return false; }
+
+    auto context = CreateRayContext(ray);
+    auto maxT    = Min(ray.MaxT, hit.Distance);
+    auto found   = false;
+
+    float nearT;
+    if (!IntersectNode(m_Nodes[0], context, maxT, nearT))
+    { return false; }
+
+    uint32_t stack[MESH_BVH_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while(top > 0)
+    {
+        auto& node = m_Nodes[stack[--top]];
+        if (node.Count > 0)
+        {
+            for(auto i=node.Offset; i<node.Offset + node.Count; ++i)
+            {
+                auto& triangle = m_Triangles[i];
+                float t, u, v;
+                if (!IntersectTriangle(triangle.V0, triangle.E1, triangle.E2, context, maxT, t, u, v))
+                { continue; }
+
+                maxT              = t;
+                hit.Distance      = t;
+                hit.U             = u;
+                hit.V             = v;
+                hit.TriangleIndex = m_TriangleIndices[i];
+                found             = true;
+
+                if (AnyHit)
+                { return true; }
+            }
+            continue;
+        }
+
+        // 近い子ノードから辿る.
+        float nearL, nearR;
+        auto hitL = IntersectNode(m_Nodes[node.Offset + 0], context, maxT, nearL);
+        auto hitR = IntersectNode(m_Nodes[node.Offset + 1], context, maxT, nearR);
+        if (hitL && hitR)
+        {
+            auto nearFirst = (nearL <= nearR) ? node.Offset : node.Offset + 1;
+            stack[top++] = (nearFirst == node.Offset) ? node.Offset + 1 : node.Offset;
+            stack[top++] = nearFirst;
+        }
+        else if (hitL)
+        { stack[top++] = node.Offset; }
+        else if (hitR)
+        { stack[top++] = node.Offset + 1; }
+    }
+
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+//      4本のレイと最も近い交差を求めます.
+//-----------------------------------------------------------------------------
+uint32_t MeshBVH::Intersect(const RayPacket4& packet, RayHit* pHits) const
+{
+    for(auto i=0u; i<4; ++i)
+    { pHits[i] = RayHit(); }
+    return IntersectPacket(packet, pHits);
+}
+
+//-----------------------------------------------------------------------------
+//      8本のレイと最も近い交差を求めます.
+//-----------------------------------------------------------------------------
+uint32_t MeshBVH::Intersect(const RayPacket8& packet, RayHit* pHits) const
+{
+    for(auto i=0u; i<8; ++i)
+    { pHits[i] = RayHit(); }
+    return IntersectPacket(packet, pHits);
+}
+
+//-----------------------------------------------------------------------------
+//      レイパケットとの交差判定を行います. 更新したレーンのマスクを返却します.
+//-----------------------------------------------------------------------------
+template<uint32_t N>
+uint32_t MeshBVH::IntersectPacket(const RayPacket<N>& packet, RayHit* pHits) const
+{
+    if (m_Nodes.empty())
+    { return 0; }
+
+    PacketContext<N> context;
+    context.Init(packet, pHits);
+
+    float nearT;
+    if (context.IntersectNode(m_Nodes[0], nearT) == 0)
+    { return 0; }
+
+    // いずれかのレーンが交差するノードを全レーンで辿る.
+    uint32_t stack[MESH_BVH_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while(top > 0)
+    {
+        auto& node = m_Nodes[stack[--top]];
+        if (node.Count > 0)
+        {
+            for(auto i=node.Offset; i<node.Offset + node.Count; ++i)
+            {
+                auto& triangle = m_Triangles[i];
+                context.IntersectTriangle(triangle.V0, triangle.E1, triangle.E2, i);
+            }
+            continue;
+        }
+
+        float nearL, nearR;
+        auto maskL = context.IntersectNode(m_Nodes[node.Offset + 0], nearL);
+        auto maskR = context.IntersectNode(m_Nodes[node.Offset + 1], nearR);
+        if (maskL != 0 && maskR != 0)
+        {
+            auto nearFirst = (nearL <= nearR) ? node.Offset : node.Offset + 1;
+            stack[top++] = (nearFirst == node.Offset) ? node.Offset + 1 : node.Offset;
+            stack[top++] = nearFirst;
+        }
+        else if (maskL != 0)
+        { stack[top++] = node.Offset; }
+        else if (maskR != 0)
+        { stack[top++] = node.Offset + 1; }
+    }
+
+    uint32_t mask = 0;
+    for(auto i=0u; i<N; ++i)
+    {
+        if (context.Triangle[i] == MESH_BVH_INVALID_INDEX)
+        { continue; }
+
+        pHits[i].Distance      = context.MaxT[i];
+        pHits[i].U             = context.U[i];
+        pHits[i].V             = context.V[i];
+        pHits[i].TriangleIndex = m_TriangleIndices[context.Triangle[i]];
+        mask |= 1u << i;
+    }
+
+    return mask;
+}
+
+//-----------------------------------------------------------------------------
+//      点から最も近い三角形上の点を求めます.
+//-----------------------------------------------------------------------------
+bool MeshBVH::FindClosestPoint(const Vector3& point, float maxDistance, ClosestPoint& result) const
+{
+    result = ClosestPoint();
+
+    auto distanceSq = maxDistance * maxDistance;
+    if (!FindClosestPointImpl(point, nullptr, distanceSq, result))
+    { return false; }
+
+    result.Distance = sqrtf(distanceSq);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      最近点を探索します. distanceSq より近い点が見つかった場合のみ更新します.
+//-----------------------------------------------------------------------------
+bool MeshBVH::FindClosestPointImpl
+(
+    const Vector3&  point,
+    const Matrix*   pWorld,
+    float&          distanceSq,
+    ClosestPoint&   result
+) const
+{
+    if (m_Nodes.empty())
+    { return false; }
+
+    struct Entry
+    {
+        uint32_t    Node;
+        float       DistanceSq;
+    };
+
+    Entry stack[MESH_BVH_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = { 0, DistanceSq(point, GetNodeBounds(m_Nodes[0], pWorld)) };
+
+    auto found = false;
+    while(top > 0)
+    {
+        auto entry = stack[--top];
+        if (entry.DistanceSq > distanceSq)
+        { continue; }
+
+        auto& node = m_Nodes[entry.Node];
+        if (node.Count > 0)
+        {
+            for(auto i=node.Offset; i<node.Offset + node.Count; ++i)
+            {
+                auto& triangle = m_Triangles[i];
+                auto a = triangle.V0;
+                auto b = triangle.V0 + triangle.E1;
+                auto c = triangle.V0 + triangle.E2;
+                if (pWorld != nullptr)
+                {
+                    a = Vector3::Transform(a, *pWorld);
+                    b = Vector3::Transform(b, *pWorld);
+                    c = Vector3::Transform(c, *pWorld);
+                }
+
+                auto closest = ClosestPointOnTriangle(point, a, b, c);
+                auto d = closest - point;
+                auto dist = Vector3::Dot(d, d);
+                if (dist <= distanceSq)
+                {
+                    distanceSq           = dist;
+                    result.Point         = closest;
+                    result.TriangleIndex = m_TriangleIndices[i];
+                    found                = true;
+                }
+            }
+            continue;
+        }
+
+        // 遠い子ノードを先に積み, 近い子ノードから探索する.
+        auto distL = DistanceSq(point, GetNodeBounds(m_Nodes[node.Offset + 0], pWorld));
+        auto distR = DistanceSq(point, GetNodeBounds(m_Nodes[node.Offset + 1], pWorld));
+        if (distL <= distR)
+        {
+            stack[top++] = { node.Offset + 1, distR };
+            stack[top++] = { node.Offset + 0, distL };
+        }
+        else
+        {
+            stack[top++] = { node.Offset + 0, distL };
+            stack[top++] = { node.Offset + 1, distR };
+        }
+    }
+
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と重なる三角形を検索します.
+//-----------------------------------------------------------------------------
+void MeshBVH::Query(const BoundingSphere& sphere, std::vector<TriangleRef>& result) const
+{ QueryImpl(sphere, nullptr, MESH_BVH_INVALID_INDEX, result); }
+
+//-----------------------------------------------------------------------------
+//      境界球と重なる三角形を検索します.
+//-----------------------------------------------------------------------------
+void MeshBVH::QueryImpl
+(
+    const BoundingSphere&       sphere,
+    const Matrix*               pWorld,
+    uint32_t                    instance,
+    std::vector<TriangleRef>&   result
+) const
+{
+    if (m_Nodes.empty())
+    { return; }
+
+    auto radiusSq = sphere.Radius * sphere.Radius;
+
+    uint32_t stack[MESH_BVH_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while(top > 0)
+    {
+        auto& node = m_Nodes[stack[--top]];
+        if (DistanceSq(sphere.Center, GetNodeBounds(node, pWorld)) > radiusSq)
+        { continue; }
+
+        if (node.Count == 0)
+        {
+            stack[top++] = node.Offset + 1;
+            stack[top++] = node.Offset;
+            continue;
+        }
+
+        for(auto i=node.Offset; i<node.Offset + node.Count; ++i)
+        {
+            auto& triangle = m_Triangles[i];
+            auto a = triangle.V0;
+            auto b = triangle.V0 + triangle.E1;
+            auto c = triangle.V0 + triangle.E2;
+            if (pWorld != nullptr)
+            {
+                a = Vector3::Transform(a, *pWorld);
+                b = Vector3::Transform(b, *pWorld);
+                c = Vector3::Transform(c, *pWorld);
+            }
+
+            auto d = ClosestPointOnTriangle(sphere.Center, a, b, c) - sphere.Center;
+            if (Vector3::Dot(d, d) <= radiusSq)
+            { result.push_back({ instance, m_TriangleIndices[i] }); }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      全体の境界箱を取得します.
+//-----------------------------------------------------------------------------
+BoundingBox MeshBVH::GetBounds() const
+{
+    if (m_Nodes.empty())
+    { return BoundingBox(); }
+
+    return GetNodeBounds(m_Nodes[0], nullptr);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ModelBVH class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      メッシュごとの階層を構築します.
+//-----------------------------------------------------------------------------
+bool ModelBVH::Build(const ResModel& model, uint32_t maxThreadCount)
+{
+    m_Meshes       .clear();
+    m_Instances    .clear();
+    m_Nodes        .clear();
+    m_InstanceOrder.clear();
+
+    auto meshCount = model.Meshes.size();
+    m_Meshes.resize(meshCount);
+
+    // メッシュが十分に多い場合はメッシュ単位で並列化し, 少ない場合は各メッシュの構築を並列化する.
+    std::vector<uint8_t> succeeded(meshCount, 0);
+    if (meshCount >= GetWorkerThreadCount(maxThreadCount))
+    {
+        ParallelFor(meshCount, 1, [&](uint32_t, size_t begin, size_t end)
+        {
+            for(auto i=begin; i<end; ++i)
+            { succeeded[i] = m_Meshes[i].Build(model.Meshes[i], 1) ? 1 : 0; }
+        }, maxThreadCount);
+    }
+    else
+    {
+        for(size_t i=0; i<meshCount; ++i)
+        { succeeded[i] = m_Meshes[i].Build(model.Meshes[i], maxThreadCount) ? 1 : 0; }
+    }
+
+    for(size_t i=0; i<meshCount; ++i)
+    {
+        if (!succeeded[i])
+        {
+            ELOGA("Error : MeshBVH::Build() Failed. mesh = %s", model.Meshes[i].MeshName.c_str());
+            m_Meshes.clear();
+            return false;
+        }
+    }
+
+    std::vector<MeshInstance> instances(meshCount);
+    for(size_t i=0; i<meshCount; ++i)
+    {
+        instances[i].MeshIndex = uint32_t(i);
+        instances[i].World     = Matrix::CreateIdentity();
+    }
+
+    return SetInstances(instances.data(), instances.size());
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンスを設定し, 上位の階層のみ再構築します.
+//-----------------------------------------------------------------------------
+bool ModelBVH::SetInstances(const MeshInstance* pInstances, size_t count)
+{
+    assert(pInstances != nullptr || count == 0);
+
+    m_Instances    .clear();
+    m_Nodes        .clear();
+    m_InstanceOrder.clear();
+
+    for(size_t i=0; i<count; ++i)
+    {
+        auto& src = pInstances[i];
+        if (src.MeshIndex >= m_Meshes.size())
+        {
+            ELOGA("Error : Invalid Mesh Index. index = %u", src.MeshIndex);
+            m_Instances.clear();
+            return false;
+        }
+
+        if (!Matrix::IsAffine(src.World) || src.World.Determinant() == 0.0f)
+        {
+            ELOGA("Error : Invalid World Matrix. instance = %zu", i);
+            m_Instances.clear();
+            return false;
+        }
+
+        Instance instance;
+        instance.MeshIndex = src.MeshIndex;
+        instance.World     = src.World;
+        instance.InvWorld  = Matrix::InvertAffine(src.World);
+        m_Instances.push_back(instance);
+    }
+
+    // 空のメッシュを参照するインスタンスは上位の階層に含めない.
+    std::vector<BoundingBox> bounds;
+    std::vector<Vector3>     centers;
+    std::vector<uint32_t>    instanceIndices;
+    for(size_t i=0; i<m_Instances.size(); ++i)
+    {
+        auto& mesh = m_Meshes[m_Instances[i].MeshIndex];
+        if (mesh.m_Nodes.empty())
+        { continue; }
+
+        auto box = BoundingBox::Transform(mesh.GetBounds(), m_Instances[i].World);
+        bounds         .push_back(box);
+        centers        .push_back(box.GetCenter());
+        instanceIndices.push_back(uint32_t(i));
+    }
+
+    std::vector<uint32_t> order;
+    HierarchyBuilder builder;
+    builder.Build(bounds, centers, 1, 1, m_Nodes, order);
+
+    m_InstanceOrder.resize(order.size());
+    for(size_t i=0; i<order.size(); ++i)
+    { m_InstanceOrder[i] = instanceIndices[order[i]]; }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      レイと最も近い交差を求めます.
+//-----------------------------------------------------------------------------
+bool ModelBVH::Intersect(const Ray& ray, RayHit& hit) const
+{
+    hit = RayHit();
+    return IntersectImpl<false>(ray, hit);
+}
+
+//-----------------------------------------------------------------------------
+//      レイがいずれかの三角形と交差するかどうか判定します.
+//-----------------------------------------------------------------------------
+bool ModelBVH::Occluded(const Ray& ray) const
+{
+    RayHit hit;
+    return IntersectImpl<true>(ray, hit);
+}
+
+//-----------------------------------------------------------------------------
+//      レイとの交差判定を行います.
+//-----------------------------------------------------------------------------
+template<bool AnyHit>
+bool ModelBVH::IntersectImpl(const Ray& ray, RayHit& hit) const
+{
+    if (m_Nodes.empty())
+    { return false; }
+
+    auto context = CreateRayContext(ray);
+    auto found   = false;
+
+    uint32_t stack[MESH_BVH_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while(top > 0)
+    {
+        auto& node = m_Nodes[stack[--top]];
+
+        float nearT;
+        if (!IntersectNode(node, context, Min(ray.MaxT, hit.Distance), nearT))
+        { continue; }
+
+        if (node.Count == 0)
+        {
+            stack[top++] = node.Offset + 1;
+            stack[top++] = node.Offset;
+            continue;
+        }
+
+        // 変換はアフィンなので, ローカル空間のレイでも距離のパラメータは変わらない.
+        for(auto i=node.Offset; i<node.Offset + node.Count; ++i)
+        {
+            auto  index    = m_InstanceOrder[i];
+            auto& instance = m_Instances[index];
+
+            Ray local;
+            local.Origin    = Vector3::Transform      (ray.Origin,    instance.InvWorld);
+            local.Direction = Vector3::TransformNormal(ray.Direction, instance.InvWorld);
+            local.MinT      = ray.MinT;
+            local.MaxT      = ray.MaxT;
+
+            if (!m_Meshes[instance.MeshIndex].IntersectImpl<AnyHit>(local, hit))
+            { continue; }
+
+            hit.InstanceIndex = index;
+            found = true;
+
+            if (AnyHit)
+            { return true; }
+        }
+    }
+
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+//      4本のレイと最も近い交差を求めます.
+//-----------------------------------------------------------------------------
+uint32_t ModelBVH::Intersect(const RayPacket4& packet, RayHit* pHits) const
+{
+    for(auto i=0u; i<4; ++i)
+    { pHits[i] = RayHit(); }
+    return IntersectPacket(packet, pHits);
+}
+
+//-----------------------------------------------------------------------------
+//      8本のレイと最も近い交差を求めます.
+//-----------------------------------------------------------------------------
+uint32_t ModelBVH::Intersect(const RayPacket8& packet, RayHit* pHits) const
+{
+    for(auto i=0u; i<8; ++i)
+    { pHits[i] = RayHit(); }
+    return IntersectPacket(packet, pHits);
+}
+
+//-----------------------------------------------------------------------------
+//      レイパケットとの交差判定を行います.
+//-----------------------------------------------------------------------------
+template<uint32_t N>
+uint32_t ModelBVH::IntersectPacket(const RayPacket<N>& packet, RayHit* pHits) const
+{
+    if (m_Nodes.empty())
+    { return 0; }
+
+    PacketContext<N> context;
+    context.Init(packet, pHits);
+
+    uint32_t stack[MESH_BVH_MAX_DEPTH];
+    uint32_t top  = 0;
+    uint32_t mask = 0;
+    stack[top++] = 0;
+
+    while(top > 0)
+    {
+        auto& node = m_Nodes[stack[--top]];
+
+        float nearT;
+        if (context.IntersectNode(node, nearT) == 0)
+        { continue; }
+
+        if (node.Count == 0)
+        {
+            stack[top++] = node.Offset + 1;
+            stack[top++] = node.Offset;
+            continue;
+        }
+
+        for(auto i=node.Offset; i<node.Offset + node.Count; ++i)
+        {
+            auto  index    = m_InstanceOrder[i];
+            auto& instance = m_Instances[index];
+
+            RayPacket<N> local;
+            for(auto lane=0u; lane<N; ++lane)
+            {
+                auto ray = packet.Get(lane);
+                ray.Origin    = Vector3::Transform      (ray.Origin,    instance.InvWorld);
+                ray.Direction = Vector3::TransformNormal(ray.Direction, instance.InvWorld);
+                local.Set(lane, ray);
+            }
+
+            auto updated = m_Meshes[instance.MeshIndex].IntersectPacket(local, pHits);
+            for(auto lane=0u; lane<N; ++lane)
+            {
+                if (updated & (1u << lane))
+                {
+                    pHits[lane].InstanceIndex = index;
+                    context.MaxT[lane] = pHits[lane].Distance;
+                }
+            }
+            mask |= updated;
+        }
+    }
+
+    return mask;
+}
+
+//-----------------------------------------------------------------------------
+//      点から最も近い三角形上の点を求めます.
+//-----------------------------------------------------------------------------
+bool ModelBVH::FindClosestPoint(const Vector3& point, float maxDistance, ClosestPoint& result) const
+{
+    result = ClosestPoint();
+    if (m_Nodes.empty())
+    { return false; }
+
+    struct Entry
+    {
+        uint32_t    Node;
+        float       DistanceSq;
+    };
+
+    auto distanceSq = maxDistance * maxDistance;
+    auto found      = false;
+
+    Entry stack[MESH_BVH_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = { 0, DistanceSq(point, GetNodeBounds(m_Nodes[0], nullptr)) };
+
+    while(top > 0)
+    {
+        auto entry = stack[--top];
+        if (entry.DistanceSq > distanceSq)
+        { continue; }
+
+        auto& node = m_Nodes[entry.Node];
+        if (node.Count > 0)
+        {
+            for(auto i=node.Offset; i<node.Offset + node.Count; ++i)
+            {
+                auto  index    = m_InstanceOrder[i];
+                auto& instance = m_Instances[index];
+                if (m_Meshes[instance.MeshIndex].FindClosestPointImpl(point, &instance.World, distanceSq, result))
+                {
+                    result.InstanceIndex = index;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        auto distL = DistanceSq(point, GetNodeBounds(m_Nodes[node.Offset + 0], nullptr));
+        auto distR = DistanceSq(point, GetNodeBounds(m_Nodes[node.Offset + 1], nullptr));
+        if (distL <= distR)
+        {
+            stack[top++] = { node.Offset + 1, distR };
+            stack[top++] = { node.Offset + 0, distL };
+        }
+        else
+        {
+            stack[top++] = { node.Offset + 0, distL };
+            stack[top++] = { node.Offset + 1, distR };
+        }
+    }
+
+    if (found)
+    { result.Distance = sqrtf(distanceSq); }
+
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球と重なる三角形を検索します.
+//-----------------------------------------------------------------------------
+void ModelBVH::Query(const BoundingSphere& sphere, std::vector<TriangleRef>& result) const
+{
+    if (m_Nodes.empty())
+    { return; }
+
+    auto radiusSq = sphere.Radius * sphere.Radius;
+
+    uint32_t stack[MESH_BVH_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while(top > 0)
+    {
+        auto& node = m_Nodes[stack[--top]];
+        if (DistanceSq(sphere.Center, GetNodeBounds(node, nullptr)) > radiusSq)
+        { continue; }
+
+        if (node.Count == 0)
+        {
+            stack[top++] = node.Offset + 1;
+            stack[top++] = node.Offset;
+            continue;
+        }
+
+        for(auto i=node.Offset; i<node.Offset + node.Count; ++i)
+        {
+            auto  index    = m_InstanceOrder[i];
+            auto& instance = m_Instances[index];
+            m_Meshes[instance.MeshIndex].QueryImpl(sphere, &instance.World, index, result);
+        }
+    }
+}
+
+} // namespace asdx
@@ -0,0 +1,724 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMeshSimplify.cpp
+// Desc : Mesh Simplification.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstring>
+#include <algorithm>
+#include <tuple>
+#include <asdxMeshSimplify.h>
+#include <asdxParallel.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   INVALID_INDEX       = UINT32_MAX;
+static constexpr float      BORDER_WEIGHT       = 10.0f;    // 境界と継ぎ目の形状を保つための重み.
+static constexpr float      PASS_ERROR_SCALE    = 1.5f;     // 1パスで縮約する誤差の上限(目標に達する誤差に対する倍率).
+static constexpr float      FLIP_COS_LIMIT      = 0.25f;    // 縮約前後の面法線がなす角の余弦の下限.
+
+///////////////////////////////////////////////////////////////////////////////
+// VertexKind enum
+///////////////////////////////////////////////////////////////////////////////
+enum VertexKind : uint8_t
+{
+    VERTEX_KIND_MANIFOLD = 0,   // 閉じた多様体上の頂点.
+    VERTEX_KIND_BORDER,         // 開いた境界上の頂点.
+    VERTEX_KIND_SEAM,           // 属性の継ぎ目上の頂点(同じ位置の頂点が2つ).
+    VERTEX_KIND_LOCKED,         // 縮約しない頂点.
+};
+
+// 縮約元と縮約先の種類の組み合わせ.
+static const bool CAN_COLLAPSE[4][4] = {
+    { true,  true,  true,  true  },  // MANIFOLD
+    { false, true,  false, true  },  // BORDER : 境界に沿ってのみ.
+    { false, false, true,  true  },  // SEAM   : 継ぎ目に沿ってのみ.
+    { false, false, false, false },  // LOCKED
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Quadric structure
+///////////////////////////////////////////////////////////////////////////////
+struct Quadric
+{
+    float   a00, a11, a22;
+    float   a10, a20, a21;
+    float   b0,  b1,  b2;
+    float   c;
+    float   w;
+
+    //-------------------------------------------------------------------------
+    //      平面 n・p + d = 0 からの距離の2乗を重み付きで設定します.
+    //-------------------------------------------------------------------------
+    void SetPlane(const asdx::Vector3& n, float d, float weight)
+    {
+        a00 = n.x * n.x * weight;
+        a11 = n.y * n.y * weight;
+        a22 = n.z * n.z * weight;
+        a10 = n.y * n.x * weight;
+        a20 = n.z * n.x * weight;
+        a21 = n.z * n.y * weight;
+        b0  = n.x * d * weight;
+        b1  = n.y * d * weight;
+        b2  = n.z * d * weight;
+        c   = d * d * weight;
+        w   = weight;
+    }
+
+    //-------------------------------------------------------------------------
+    //      加算します.
+    //-------------------------------------------------------------------------
+    Quadric& operator += (const Quadric& value)
+    {
+        a00 += value.a00; a11 += value.a11; a22 += value.a22;
+        a10 += value.a10; a20 += value.a20; a21 += value.a21;
+        b0  += value.b0;  b1  += value.b1;  b2  += value.b2;
+        c   += value.c;
+        w   += value.w;
+        return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    //      位置に対する重み付き誤差を求めます.
+    //-------------------------------------------------------------------------
+    float Evaluate(const asdx::Vector3& p) const
+    {
+        auto rx = b0;
+        auto ry = b1;
+        auto rz = b2;
+
+        rx += a10 * p.y;
+        ry += a21 * p.z;
+        rz += a20 * p.x;
+
+        rx *= 2.0f;
+        ry *= 2.0f;
+        rz *= 2.0f;
+
+        rx += a00 * p.x;
+        ry += a11 * p.y;
+        rz += a22 * p.z;
+
+        auto r = c + rx * p.x + ry * p.y + rz * p.z;
+        return fabsf(r);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Adjacency structure
+///////////////////////////////////////////////////////////////////////////////
+struct Adjacency
+{
+    std::vector<uint32_t>   Counts;     // 頂点ごとの隣接三角形数.
+    std::vector<uint32_t>   Offsets;    // 頂点ごとの先頭位置.
+    std::vector<uint32_t>   Triangles;  // 隣接三角形番号.
+
+    //-------------------------------------------------------------------------
+    //      隣接情報を構築します.
+    //-------------------------------------------------------------------------
+    void Build(const std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        Counts .assign(vertexCount, 0);
+        Offsets.resize(vertexCount);
+        Triangles.resize(indices.size());
+
+        for(auto index : indices)
+        { Counts[index]++; }
+
+        uint32_t offset = 0;
+        for(size_t i=0; i<vertexCount; ++i)
+        {
+            Offsets[i] = offset;
+            offset += Counts[i];
+        }
+
+        for(size_t i=0; i<indices.size(); ++i)
+        { Triangles[Offsets[indices[i]]++] = uint32_t(i / 3); }
+
+        for(size_t i=0; i<vertexCount; ++i)
+        { Offsets[i] -= Counts[i]; }
+    }
+
+    //-------------------------------------------------------------------------
+    //      a から b への有向辺が存在するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool HasEdge(const std::vector<uint32_t>& indices, uint32_t a, uint32_t b) const
+    {
+        const auto* pList = Triangles.data() + Offsets[a];
+        for(uint32_t i=0; i<Counts[a]; ++i)
+        {
+            const auto* tri = indices.data() + pList[i] * 3;
+            if ((tri[0] == a && tri[1] == b)
+             || (tri[1] == a && tri[2] == b)
+             || (tri[2] == a && tri[0] == b))
+            { return true; }
+        }
+        return false;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Collapse structure
+///////////////////////////////////////////////////////////////////////////////
+struct Collapse
+{
+    uint32_t    From;       // 縮約元の頂点.
+    uint32_t    To;         // 縮約先の頂点.
+    float       Error;      // 誤差.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Simplifier class
+///////////////////////////////////////////////////////////////////////////////
+class Simplifier
+{
+public:
+    //-------------------------------------------------------------------------
+    //      コンストラクタです.
+    //-------------------------------------------------------------------------
+    Simplifier(const asdx::ResMesh& mesh, bool lockBorder)
+    : m_Positions(mesh.Positions)
+    {
+        m_Indices.assign(mesh.Indices.begin(), mesh.Indices.end() - mesh.Indices.size() % 3);
+        BuildWedges();
+        m_Adjacency.Build(m_Indices, m_Positions.size());
+        ClassifyVertices(lockBorder);
+        BuildQuadrics();
+    }
+
+    //-------------------------------------------------------------------------
+    //      簡略化します.
+    //-------------------------------------------------------------------------
+    float Run(uint32_t targetTriangleCount, float targetError, std::vector<uint32_t>& result)
+    {
+        auto errorLimit = (targetError < FLT_MAX) ? targetError * targetError : FLT_MAX;
+        auto maxError   = 0.0f;
+
+        std::vector<Collapse>   collapses;
+        std::vector<Collapse>   sorted;
+        std::vector<uint32_t>   collapseRemap(m_Positions.size());
+        std::vector<uint8_t>    locked(m_Positions.size());
+
+        while (m_Indices.size() / 3 > targetTriangleCount)
+        {
+            // 縮約候補を集めて誤差の小さい順に並べる.
+            PickCollapses(collapses);
+            if (collapses.empty())
+            { break; }
+
+            SortCollapses(collapses, sorted);
+            collapses.swap(sorted);
+
+            // 内部の辺は1回の縮約で2つの三角形が消えるので, 目標までの半分を1パスの目安とする.
+            auto triangleCount = m_Indices.size() / 3;
+            auto goal = asdx::Max<size_t>((triangleCount - targetTriangleCount) / 2, 1);
+            auto passLimit = collapses[asdx::Min(goal, collapses.size()) - 1].Error * PASS_ERROR_SCALE;
+            passLimit = asdx::Min(passLimit, errorLimit);
+
+            for(size_t i=0; i<collapseRemap.size(); ++i)
+            { collapseRemap[i] = uint32_t(i); }
+            memset(locked.data(), 0, locked.size());
+
+            size_t performed = 0;
+            for(const auto& collapse : collapses)
+            {
+                if (performed >= goal || collapse.Error > passLimit)
+                { break; }
+
+                auto i0 = collapse.From;
+                auto i1 = collapse.To;
+
+                // 同じパスで周辺が変わった頂点は縮約しない.
+                if (locked[m_Remap[i0]] || locked[m_Remap[i1]])
+                { continue; }
+
+                if (HasTriangleFlip(i0, i1))
+                { continue; }
+
+                if (m_Kinds[i0] == VERTEX_KIND_SEAM)
+                {
+                    // 継ぎ目の反対側も同じ位置へまとめて縮約する.
+                    auto s0 = m_Wedges[i0];
+                    auto s1 = FindSeamTarget(s0, i1);
+                    if (s1 == INVALID_INDEX || HasTriangleFlip(s0, s1))
+                    { continue; }
+
+                    collapseRemap[s0] = s1;
+                }
+
+                collapseRemap[i0] = i1;
+                m_Quadrics[m_Remap[i1]] += m_Quadrics[m_Remap[i0]];
+
+                // 裏返り判定が他の縮約と干渉しないよう, 縮約元の1リング全体を固定する.
+                LockRing(i0, locked);
+                locked[m_Remap[i1]] = 1;
+
+                maxError = asdx::Max(maxError, collapse.Error);
+                performed++;
+            }
+
+            if (performed == 0)
+            { break; }
+
+            ApplyCollapses(collapseRemap);
+            m_Adjacency.Build(m_Indices, m_Positions.size());
+        }
+
+        result = m_Indices;
+        return sqrtf(maxError);
+    }
+
+private:
+    const std::vector<asdx::Vector3>&   m_Positions;    // 位置座標.
+    std::vector<uint32_t>               m_Indices;      // 現在のインデックス.
+    std::vector<uint32_t>               m_Remap;        // 同じ位置の頂点の代表.
+    std::vector<uint32_t>               m_Wedges;       // 同じ位置の頂点の循環リスト.
+    std::vector<uint8_t>                m_Kinds;        // 頂点の種類.
+    std::vector<Quadric>                m_Quadrics;     // 代表頂点ごとの二次誤差.
+    Adjacency                           m_Adjacency;    // 隣接情報.
+
+    //-------------------------------------------------------------------------
+    //      同じ位置の頂点をまとめます.
+    //-------------------------------------------------------------------------
+    void BuildWedges()
+    {
+        auto vertexCount = m_Positions.size();
+        std::vector<uint32_t> order(vertexCount);
+        for(size_t i=0; i<vertexCount; ++i)
+        { order[i] = uint32_t(i); }
+
+        // ビット列で比較して完全に一致する位置をまとめる.
+        auto key = [&](uint32_t index)
+        {
+            uint32_t bits[3];
+            memcpy(bits, &m_Positions[index].x, sizeof(bits));
+            return std::make_tuple(bits[0], bits[1], bits[2], index);
+        };
+
+        std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs)
+        { return key(lhs) < key(rhs); });
+
+        m_Remap .resize(vertexCount);
+        m_Wedges.resize(vertexCount);
+
+        size_t begin = 0;
+        while (begin < vertexCount)
+        {
+            auto end = begin + 1;
+            while (end < vertexCount
+                && memcmp(&m_Positions[order[begin]].x, &m_Positions[order[end]].x, sizeof(float) * 3) == 0)
+            { end++; }
+
+            for(auto i=begin; i<end; ++i)
+            {
+                m_Remap [order[i]] = order[begin];
+                m_Wedges[order[i]] = order[(i + 1 < end) ? i + 1 : begin];
+            }
+
+            begin = end;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      位置として辺が存在するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool HasPositionEdge(uint32_t a, uint32_t b) const
+    {
+        auto wa = a;
+        do
+        {
+            auto wb = b;
+            do
+            {
+                if (m_Adjacency.HasEdge(m_Indices, wa, wb))
+                { return true; }
+                wb = m_Wedges[wb];
+            }
+            while (wb != b);
+
+            wa = m_Wedges[wa];
+        }
+        while (wa != a);
+
+        return false;
+    }
+
+    //-------------------------------------------------------------------------
+    //      頂点を分類します.
+    //-------------------------------------------------------------------------
+    void ClassifyVertices(bool lockBorder)
+    {
+        auto vertexCount = m_Positions.size();
+        std::vector<uint32_t> openOut(vertexCount, 0);
+        std::vector<uint32_t> openIn (vertexCount, 0);
+        std::vector<uint8_t>  border (vertexCount, 0);
+
+        // 逆向きの辺が無い辺を開いた辺とする.
+        for(size_t i=0; i<m_Indices.size(); i+=3)
+        {
+            for(auto k=0; k<3; ++k)
+            {
+                auto a = m_Indices[i + k];
+                auto b = m_Indices[i + (k + 1) % 3];
+                if (m_Adjacency.HasEdge(m_Indices, b, a))
+                { continue; }
+
+                openOut[a]++;
+                openIn [b]++;
+
+                // 位置としても開いていれば, 継ぎ目ではなく境界.
+                if (!HasPositionEdge(b, a))
+                {
+                    border[a] = 1;
+                    border[b] = 1;
+                }
+            }
+        }
+
+        m_Kinds.resize(vertexCount);
+        for(size_t i=0; i<vertexCount; ++i)
+        {
+            auto wedge = m_Wedges[i];
+            if (wedge == i)
+            {
+                if (openOut[i] == 0 && openIn[i] == 0)
+                { m_Kinds[i] = VERTEX_KIND_MANIFOLD; }
+                else if (openOut[i] == 1 && openIn[i] == 1)
+                { m_Kinds[i] = lockBorder ? VERTEX_KIND_LOCKED : VERTEX_KIND_BORDER; }
+                else
+                { m_Kinds[i] = VERTEX_KIND_LOCKED; }
+            }
+            else if (m_Wedges[wedge] == i
+                  && openOut[i] == 1 && openIn[i] == 1
+                  && openOut[wedge] == 1 && openIn[wedge] == 1
+                  && border[i] == 0 && border[wedge] == 0)
+            {
+                // 2つの頂点が継ぎ目の両側にあり, 位置としては閉じている.
+                m_Kinds[i] = VERTEX_KIND_SEAM;
+            }
+            else
+            {
+                m_Kinds[i] = VERTEX_KIND_LOCKED;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      二次誤差を構築します.
+    //-------------------------------------------------------------------------
+    void BuildQuadrics()
+    {
+        Quadric zero = {};
+        m_Quadrics.assign(m_Positions.size(), zero);
+
+        for(size_t i=0; i<m_Indices.size(); i+=3)
+        {
+            const uint32_t tri[3] = { m_Indices[i + 0], m_Indices[i + 1], m_Indices[i + 2] };
+            const auto& p0 = m_Positions[tri[0]];
+            const auto& p1 = m_Positions[tri[1]];
+            const auto& p2 = m_Positions[tri[2]];
+
+            auto n    = asdx::Vector3::Cross(p1 - p0, p2 - p0);
+            auto area = n.Length();
+            if (area <= FLT_MIN)
+            { continue; }
+
+            n *= 1.0f / area;
+
+            // 面積で重み付けした平面.
+            Quadric q;
+            q.SetPlane(n, -asdx::Vector3::Dot(n, p0), area);
+            for(auto k=0; k<3; ++k)
+            { m_Quadrics[m_Remap[tri[k]]] += q; }
+
+            // 開いた辺(境界と継ぎ目)は面に垂直な平面で形状を保つ.
+            for(auto k=0; k<3; ++k)
+            {
+                auto a = tri[k];
+                auto b = tri[(k + 1) % 3];
+                if (m_Adjacency.HasEdge(m_Indices, b, a))
+                { continue; }
+
+                auto edge   = m_Positions[b] - m_Positions[a];
+                auto length = edge.Length();
+                if (length <= FLT_MIN)
+                { continue; }
+
+                auto en = asdx::Vector3::Cross(edge, n) * (1.0f / length);
+
+                Quadric eq;
+                eq.SetPlane(en, -asdx::Vector3::Dot(en, m_Positions[a]), length * length * BORDER_WEIGHT);
+                m_Quadrics[m_Remap[a]] += eq;
+                m_Quadrics[m_Remap[b]] += eq;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      縮約できるかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool CanCollapse(uint32_t i0, uint32_t i1) const
+    {
+        auto k0 = m_Kinds[i0];
+        auto k1 = m_Kinds[i1];
+        if (!CAN_COLLAPSE[k0][k1])
+        { return false; }
+
+        // 境界と継ぎ目は開いた辺に沿ってのみ縮約する.
+        if (k0 == VERTEX_KIND_BORDER || k0 == VERTEX_KIND_SEAM)
+        {
+            if (m_Adjacency.HasEdge(m_Indices, i0, i1) && m_Adjacency.HasEdge(m_Indices, i1, i0))
+            { return false; }
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      縮約の誤差を求めます.
+    //-------------------------------------------------------------------------
+    float CalcError(uint32_t i0, uint32_t i1) const
+    {
+        auto q = m_Quadrics[m_Remap[i0]];
+        q += m_Quadrics[m_Remap[i1]];
+        return (q.w > 0.0f) ? q.Evaluate(m_Positions[i1]) / q.w : 0.0f;
+    }
+
+    //-------------------------------------------------------------------------
+    //      縮約候補を集めます.
+    //-------------------------------------------------------------------------
+    void PickCollapses(std::vector<Collapse>& result) const
+    {
+        result.clear();
+        for(size_t i=0; i<m_Indices.size(); i+=3)
+        {
+            for(auto k=0; k<3; ++k)
+            {
+                auto a = m_Indices[i + k];
+                auto b = m_Indices[i + (k + 1) % 3];
+
+                // 内部の辺は両側の三角形から現れるので片方だけ扱う.
+                if (a > b && m_Adjacency.HasEdge(m_Indices, b, a))
+                { continue; }
+
+                auto canAB = CanCollapse(a, b);
+                auto canBA = CanCollapse(b, a);
+                if (!canAB && !canBA)
+                { continue; }
+
+                auto errorAB = canAB ? CalcError(a, b) : FLT_MAX;
+                auto errorBA = canBA ? CalcError(b, a) : FLT_MAX;
+
+                if (errorAB <= errorBA)
+                { result.push_back({ a, b, errorAB }); }
+                else
+                { result.push_back({ b, a, errorBA }); }
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      縮約候補を誤差の小さい順に並べます.
+    //-------------------------------------------------------------------------
+    static void SortCollapses(const std::vector<Collapse>& input, std::vector<Collapse>& output)
+    {
+        // 誤差は非負なのでビット列の上位(指数部と仮数部の上位3ビット)で大まかに並べれば十分.
+        // 同じバケット内は候補の生成順を保つので, 結果は入力だけで決まる.
+        static const uint32_t BucketCount = 1 << 11;
+        std::vector<uint32_t> offsets(BucketCount, 0);
+
+        auto key = [](float value)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return (bits >> 20) & (BucketCount - 1);
+        };
+
+        for(const auto& itr : input)
+        { offsets[key(itr.Error)]++; }
+
+        uint32_t offset = 0;
+        for(auto& count : offsets)
+        {
+            auto next = offset + count;
+            count  = offset;
+            offset = next;
+        }
+
+        output.resize(input.size());
+        for(const auto& itr : input)
+        { output[offsets[key(itr.Error)]++] = itr; }
+    }
+
+    //-------------------------------------------------------------------------
+    //      継ぎ目の反対側の縮約先を探します.
+    //-------------------------------------------------------------------------
+    uint32_t FindSeamTarget(uint32_t s0, uint32_t i1) const
+    {
+        auto w = i1;
+        do
+        {
+            if (w != i1 || m_Wedges[i1] == i1)
+            {
+                if (m_Adjacency.HasEdge(m_Indices, s0, w) || m_Adjacency.HasEdge(m_Indices, w, s0))
+                { return w; }
+            }
+            w = m_Wedges[w];
+        }
+        while (w != i1);
+
+        return INVALID_INDEX;
+    }
+
+    //-------------------------------------------------------------------------
+    //      縮約で三角形が裏返るかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool HasTriangleFlip(uint32_t i0, uint32_t i1) const
+    {
+        const auto& p1 = m_Positions[i1];
+        const auto* pList = m_Adjacency.Triangles.data() + m_Adjacency.Offsets[i0];
+        for(uint32_t i=0; i<m_Adjacency.Counts[i0]; ++i)
+        {
+            const auto* tri = m_Indices.data() + pList[i] * 3;
+
+            // 縮約で消える三角形は判定しない.
+            auto r1 = m_Remap[i1];
+            if (m_Remap[tri[0]] == r1 || m_Remap[tri[1]] == r1 || m_Remap[tri[2]] == r1)
+            { continue; }
+
+            auto k = (tri[0] == i0) ? 0 : (tri[1] == i0) ? 1 : 2;
+            const auto& pb = m_Positions[tri[(k + 1) % 3]];
+            const auto& pc = m_Positions[tri[(k + 2) % 3]];
+            const auto& p0 = m_Positions[i0];
+
+            // 裏返りに加えて, 大きく傾いて細長い三角形が折れ曲がるものも除く.
+            auto before = asdx::Vector3::Cross(pb - p0, pc - p0);
+            auto after  = asdx::Vector3::Cross(pb - p1, pc - p1);
+            auto limit  = before.Length() * after.Length() * FLIP_COS_LIMIT;
+            if (asdx::Vector3::Dot(before, after) <= limit)
+            { return true; }
+        }
+
+        return false;
+    }
+
+    //-------------------------------------------------------------------------
+    //      同じ位置の全ての頂点の1リングを固定します.
+    //-------------------------------------------------------------------------
+    void LockRing(uint32_t index, std::vector<uint8_t>& locked) const
+    {
+        auto w = index;
+        do
+        {
+            const auto* pList = m_Adjacency.Triangles.data() + m_Adjacency.Offsets[w];
+            for(uint32_t i=0; i<m_Adjacency.Counts[w]; ++i)
+            {
+                const auto* tri = m_Indices.data() + pList[i] * 3;
+                locked[m_Remap[tri[0]]] = 1;
+                locked[m_Remap[tri[1]]] = 1;
+                locked[m_Remap[tri[2]]] = 1;
+            }
+            w = m_Wedges[w];
+        }
+        while (w != index);
+    }
+
+    //-------------------------------------------------------------------------
+    //      縮約を適用し, 縮退した三角形を取り除きます.
+    //-------------------------------------------------------------------------
+    void ApplyCollapses(const std::vector<uint32_t>& remap)
+    {
+        size_t count = 0;
+        for(size_t i=0; i<m_Indices.size(); i+=3)
+        {
+            auto a = remap[m_Indices[i + 0]];
+            auto b = remap[m_Indices[i + 1]];
+            auto c = remap[m_Indices[i + 2]];
+
+            auto ra = m_Remap[a];
+            auto rb = m_Remap[b];
+            auto rc = m_Remap[c];
+            if (ra == rb || rb == rc || rc == ra)
+            { continue; }
+
+            m_Indices[count + 0] = a;
+            m_Indices[count + 1] = b;
+            m_Indices[count + 2] = c;
+            count += 3;
+        }
+        m_Indices.resize(count);
+    }
+};
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      二次誤差計量による辺の縮約でメッシュを簡略化します.
+//-----------------------------------------------------------------------------
+float SimplifyMesh(const ResMesh& mesh, const SimplifyDesc& desc, std::vector<uint32_t>& result)
+{
+    Simplifier simplifier(mesh, desc.LockBorder);
+    return simplifier.Run(desc.TargetTriangleCount, desc.TargetError, result);
+}
+
+//-----------------------------------------------------------------------------
+//      LOD チェインを構築します.
+//-----------------------------------------------------------------------------
+void BuildLODChain(const ResMesh& mesh, const LODChainDesc& desc, std::vector<ResMeshLOD>& result)
+{
+    result.clear();
+
+    auto triangleCount = uint32_t(mesh.Indices.size() / 3);
+    if (desc.MaxLevelCount == 0)
+    { return; }
+
+    // LOD0 は元のメッシュ.
+    std::vector<ResMeshLOD> levels(desc.MaxLevelCount);
+    levels[0].Indices.assign(mesh.Indices.begin(), mesh.Indices.begin() + triangleCount * 3);
+    levels[0].Error = 0.0f;
+
+    // 各レベルは元のメッシュから独立に簡略化できるので並列に処理する.
+    ParallelFor(desc.MaxLevelCount - 1, 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            auto ratio = powf(desc.ReductionRatio, float(i + 1));
+
+            SimplifyDesc simplify;
+            simplify.TargetTriangleCount = uint32_t(float(triangleCount) * ratio);
+            simplify.TargetError         = desc.MaxError;
+            simplify.LockBorder          = desc.LockBorder;
+
+            auto& level = levels[i + 1];
+            level.Error = SimplifyMesh(mesh, simplify, level.Indices);
+        }
+    });
+
+    // 十分に減らなかったレベル以降は捨てる. 誤差は単調増加にそろえる.
+    result.push_back(std::move(levels[0]));
+    for(uint32_t i=1; i<desc.MaxLevelCount; ++i)
+    {
+        auto& prev  = result.back();
+        auto& level = levels[i];
+
+        auto prevCount  = prev .Indices.size() / 3;
+        auto levelCount = level.Indices.size() / 3;
+        if (levelCount < desc.MinTriangleCount || levelCount >= prevCount * 0.95f)
+        { break; }
+
+        level.Error = asdx::Max(level.Error, prev.Error);
+        result.push_back(std::move(level));
+    }
+}
+
+} // namespace asdx
@@ -0,0 +1,540 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMeshWeld.cpp
+// Desc : Vertex Welding.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <xxhash.h>
+#include <asdxMeshWeld.h>
+#include <asdxParallel.h>
+#include <asdxLogger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   INVALID_INDEX           = UINT32_MAX;
+static constexpr uint32_t   PARTITION_BITS          = 6;
+static constexpr uint32_t   PARTITION_COUNT         = 1u << PARTITION_BITS; // ハッシュ値の上位ビットで分ける区画数.
+static constexpr size_t     CHUNK_SIZE              = 65536;    // 区画分けの1単位あたりの頂点数.
+static constexpr size_t     MIN_BATCH_VERTEX_COUNT  = 16384;    // 1バッチあたりの最小頂点数.
+static constexpr uint32_t   MAX_STREAM_COUNT        = 7 + MAX_LAYER_COUNT;
+static constexpr size_t     MAX_KEY_SIZE            = 128;      // 1頂点の比較用データの最大サイズ.
+
+///////////////////////////////////////////////////////////////////////////////
+// Stream structure
+///////////////////////////////////////////////////////////////////////////////
+struct Stream
+{
+    const uint8_t*  pData;      // 先頭.
+    uint32_t        Size;       // 1頂点あたりのサイズ.
+    bool            IsFloat;    // 浮動小数点数の配列かどうか.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Slot structure
+///////////////////////////////////////////////////////////////////////////////
+struct Slot
+{
+    uint64_t    Hash;       // ハッシュ値.
+    uint32_t    Index;      // 頂点番号.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// VertexKey class
+///////////////////////////////////////////////////////////////////////////////
+class VertexKey
+{
+public:
+    //-------------------------------------------------------------------------
+    //      初期化します. 頂点ストリームの要素数が一致しない場合は false を返します.
+    //-------------------------------------------------------------------------
+    bool Init(const asdx::ResMesh& mesh, float epsilon)
+    {
+        m_pPositions  = mesh.Positions.data();
+        m_VertexCount = mesh.Positions.size();
+        m_Epsilon     = epsilon;
+        m_InvEpsilon  = (epsilon > 0.0f) ? 1.0f / epsilon : 0.0f;
+        m_StreamCount = 0;
+
+        auto valid = true;
+        auto add = [&](const void* pData, size_t count, uint32_t size, bool isFloat)
+        {
+            if (count == 0)
+            { return; }
+
+            if (count != m_VertexCount)
+            {
+                valid = false;
+                return;
+            }
+
+            m_Streams[m_StreamCount++] = { static_cast<const uint8_t*>(pData), size, isFloat };
+        };
+
+        add(mesh.Normals    .data(), mesh.Normals    .size(), sizeof(asdx::Vector3), true);
+        add(mesh.Tangents   .data(), mesh.Tangents   .size(), sizeof(asdx::Vector3), true);
+        add(mesh.Bitangents .data(), mesh.Bitangents .size(), sizeof(asdx::Vector3), true);
+        add(mesh.Colors     .data(), mesh.Colors     .size(), sizeof(asdx::Vector4), true);
+        for(auto i=0; i<MAX_LAYER_COUNT; ++i)
+        { add(mesh.TexCoords[i].data(), mesh.TexCoords[i].size(), sizeof(asdx::Vector2), true); }
+        add(mesh.BoneIndices.data(), mesh.BoneIndices.size(), sizeof(asdx::ResBoneIndex), false);
+        add(mesh.BoneWeights.data(), mesh.BoneWeights.size(), sizeof(asdx::Vector4), true);
+
+        return valid;
+    }
+
+    //-------------------------------------------------------------------------
+    //      許容誤差付きかどうか.
+    //-------------------------------------------------------------------------
+    bool HasEpsilon() const
+    { return m_Epsilon > 0.0f; }
+
+    //-------------------------------------------------------------------------
+    //      位置を取得します.
+    //-------------------------------------------------------------------------
+    const asdx::Vector3& GetPosition(size_t index) const
+    { return m_pPositions[index]; }
+
+    //-------------------------------------------------------------------------
+    //      格子のセルを求めます.
+    //-------------------------------------------------------------------------
+    void GetCell(size_t index, int32_t cell[3]) const
+    {
+        const auto& p = m_pPositions[index];
+        const float value[3] = { p.x, p.y, p.z };
+        for(auto i=0; i<3; ++i)
+        {
+            // 範囲外はクランプして, 整数への変換で未定義動作にならないようにする.
+            auto c = floorf(value[i] * m_InvEpsilon);
+            c = asdx::Clamp(c, -2147483520.0f, 2147483520.0f);
+            cell[i] = (c == c) ? int32_t(c) : 0;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      位置以外の属性を書き出します.
+    //-------------------------------------------------------------------------
+    size_t GatherAttributes(size_t index, uint8_t* pBuffer) const
+    {
+        size_t offset = 0;
+        for(uint32_t i=0; i<m_StreamCount; ++i)
+        {
+            const auto& stream = m_Streams[i];
+            const auto* pSrc   = stream.pData + index * stream.Size;
+            if (stream.IsFloat)
+            { offset += CopyFloats(pSrc, stream.Size, pBuffer + offset); }
+            else
+            {
+                memcpy(pBuffer + offset, pSrc, stream.Size);
+                offset += stream.Size;
+            }
+        }
+        return offset;
+    }
+
+    //-------------------------------------------------------------------------
+    //      比較用のデータを書き出します.
+    //-------------------------------------------------------------------------
+    size_t Gather(size_t index, uint8_t* pBuffer) const
+    {
+        // 許容誤差がある場合は位置の代わりにセルで比較する.
+        size_t offset = 0;
+        if (HasEpsilon())
+        {
+            int32_t cell[3];
+            GetCell(index, cell);
+            memcpy(pBuffer, cell, sizeof(cell));
+            offset = sizeof(cell);
+        }
+        else
+        { offset = CopyFloats(&m_pPositions[index], sizeof(asdx::Vector3), pBuffer); }
+
+        return offset + GatherAttributes(index, pBuffer + offset);
+    }
+
+    //-------------------------------------------------------------------------
+    //      ハッシュ値を求めます.
+    //-------------------------------------------------------------------------
+    uint64_t CalcHash(size_t index) const
+    {
+        uint8_t buffer[MAX_KEY_SIZE];
+        auto size = Gather(index, buffer);
+        return XXH3_64bits(buffer, size);
+    }
+
+    //-------------------------------------------------------------------------
+    //      比較用のデータが一致するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool IsEqual(size_t lhs, size_t rhs) const
+    {
+        uint8_t a[MAX_KEY_SIZE];
+        uint8_t b[MAX_KEY_SIZE];
+        auto size = Gather(lhs, a);
+        Gather(rhs, b);
+        return memcmp(a, b, size) == 0;
+    }
+
+    //-------------------------------------------------------------------------
+    //      位置以外の属性が一致するかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool IsEqualAttributes(size_t lhs, size_t rhs) const
+    {
+        uint8_t a[MAX_KEY_SIZE];
+        uint8_t b[MAX_KEY_SIZE];
+        auto size = GatherAttributes(lhs, a);
+        GatherAttributes(rhs, b);
+        return memcmp(a, b, size) == 0;
+    }
+
+    //-------------------------------------------------------------------------
+    //      位置が許容誤差内かどうか判定します.
+    //-------------------------------------------------------------------------
+    bool IsNear(size_t lhs, size_t rhs) const
+    {
+        const auto& a = m_pPositions[lhs];
+        const auto& b = m_pPositions[rhs];
+        return fabsf(a.x - b.x) <= m_Epsilon
+            && fabsf(a.y - b.y) <= m_Epsilon
+            && fabsf(a.z - b.z) <= m_Epsilon;
+    }
+
+private:
+    const asdx::Vector3*    m_pPositions    = nullptr;
+    size_t                  m_VertexCount   = 0;
+    float                   m_Epsilon       = 0.0f;
+    float                   m_InvEpsilon    = 0.0f;
+    Stream                  m_Streams[MAX_STREAM_COUNT] = {};
+    uint32_t                m_StreamCount   = 0;
+
+    //-------------------------------------------------------------------------
+    //      浮動小数点数をコピーします. -0 は +0 にそろえます.
+    //-------------------------------------------------------------------------
+    static size_t CopyFloats(const void* pSrc, size_t size, uint8_t* pDst)
+    {
+        uint32_t bits[4];
+        memcpy(bits, pSrc, size);
+        for(size_t i=0; i<size / sizeof(uint32_t); ++i)
+        {
+            if (bits[i] == 0x80000000u)
+            { bits[i] = 0; }
+        }
+        memcpy(pDst, bits, size);
+        return size;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      2の累乗に切り上げます.
+//-----------------------------------------------------------------------------
+inline size_t NextPow2(size_t value)
+{
+    size_t result = 1;
+    while (result < value)
+    { result <<= 1; }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      セルと属性のハッシュ値から近傍探索用のハッシュ値を求めます.
+//-----------------------------------------------------------------------------
+inline uint64_t CalcCellHash(const int32_t cell[3], uint64_t attributeHash)
+{
+    uint8_t buffer[sizeof(int32_t) * 3 + sizeof(uint64_t)];
+    memcpy(buffer, cell, sizeof(int32_t) * 3);
+    memcpy(buffer + sizeof(int32_t) * 3, &attributeHash, sizeof(uint64_t));
+    return XXH3_64bits(buffer, sizeof(buffer));
+}
+
+//-----------------------------------------------------------------------------
+//      隣接するセルの代表頂点同士を統合します.
+//-----------------------------------------------------------------------------
+void MergeNeighborCells(const VertexKey& key, std::vector<uint32_t>& remap, uint32_t maxThreadCount)
+{
+    // 同じセル内は区画ごとに統合済みなので, 代表頂点だけを頂点番号順に処理する.
+    std::vector<uint32_t> reps;
+    for(size_t i=0; i<remap.size(); ++i)
+    {
+        if (remap[i] == i)
+        { reps.push_back(uint32_t(i)); }
+    }
+
+    std::vector<uint64_t> attributeHashes(reps.size());
+    asdx::ParallelFor(reps.size(), MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        uint8_t buffer[MAX_KEY_SIZE];
+        for(auto i=begin; i<end; ++i)
+        {
+            auto size = key.GatherAttributes(reps[i], buffer);
+            attributeHashes[i] = XXH3_64bits(buffer, size);
+        }
+    }, maxThreadCount);
+
+    auto tableSize = NextPow2(reps.size() * 2);
+    auto mask      = tableSize - 1;
+    std::vector<uint32_t> table(tableSize, INVALID_INDEX);     // 代表頂点のリスト番号.
+    std::vector<uint32_t> merged(reps.size());
+
+    for(size_t i=0; i<reps.size(); ++i)
+    {
+        auto v = reps[i];
+        int32_t cell[3];
+        key.GetCell(v, cell);
+
+        // 27近傍から最も番号の小さい代表頂点を探す.
+        auto best = INVALID_INDEX;
+        for(auto dz=-1; dz<=1; ++dz)
+        for(auto dy=-1; dy<=1; ++dy)
+        for(auto dx=-1; dx<=1; ++dx)
+        {
+            const int32_t neighbor[3] = { cell[0] + dx, cell[1] + dy, cell[2] + dz };
+            auto slot = CalcCellHash(neighbor, attributeHashes[i]) & mask;
+            while (table[slot] != INVALID_INDEX)
+            {
+                auto j = table[slot];
+                auto c = reps[j];
+                if (attributeHashes[j] == attributeHashes[i] && c < best
+                 && key.IsNear(c, v) && key.IsEqualAttributes(c, v))
+                { best = c; }
+                slot = (slot + 1) & mask;
+            }
+        }
+
+        if (best != INVALID_INDEX)
+        {
+            merged[i] = best;
+            continue;
+        }
+
+        merged[i] = v;
+        auto slot = CalcCellHash(cell, attributeHashes[i]) & mask;
+        while (table[slot] != INVALID_INDEX)
+        { slot = (slot + 1) & mask; }
+        table[slot] = uint32_t(i);
+    }
+
+    // 統合先は常に自身より番号が小さいので, 番号を振り直す際に順にたどれる.
+    for(size_t i=0; i<reps.size(); ++i)
+    { remap[reps[i]] = merged[i]; }
+}
+
+//-----------------------------------------------------------------------------
+//      頂点ストリームを詰め直します.
+//-----------------------------------------------------------------------------
+template<typename T>
+void CompactStream(std::vector<T>& stream, const std::vector<uint32_t>& sources, uint32_t maxThreadCount)
+{
+    if (stream.empty())
+    { return; }
+
+    std::vector<T> result(sources.size());
+    asdx::ParallelFor(sources.size(), MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        { result[i] = stream[sources[i]]; }
+    }, maxThreadCount);
+
+    stream.swap(result);
+}
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      重複頂点を統合する頂点番号の対応表を生成します.
+//-----------------------------------------------------------------------------
+uint32_t GenerateVertexRemap
+(
+    const ResMesh&          mesh,
+    const WeldDesc&         desc,
+    std::vector<uint32_t>&  remap,
+    uint32_t                maxThreadCount
+)
+{
+    remap.clear();
+
+    VertexKey key;
+    if (!key.Init(mesh, asdx::Max(desc.Epsilon, 0.0f)))
+    {
+        ELOGA("Error : Vertex Stream Count Mismatch.");
+        return 0;
+    }
+
+    auto vertexCount = mesh.Positions.size();
+    if (vertexCount == 0)
+    { return 0; }
+
+    // 全ての属性のハッシュ値を求める.
+    std::vector<uint64_t> hashes(vertexCount);
+    ParallelFor(vertexCount, MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        { hashes[i] = key.CalcHash(i); }
+    }, maxThreadCount);
+
+    // ハッシュ値の上位ビットで区画に分ける. 分割単位は固定なので結果はスレッド数に依存しない.
+    auto partitionOf = [&](size_t index)
+    { return uint32_t(hashes[index] >> (64 - PARTITION_BITS)); };
+
+    auto chunkCount = (vertexCount + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<uint32_t> histogram(chunkCount * PARTITION_COUNT, 0);
+    ParallelFor(chunkCount, 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto c=begin; c<end; ++c)
+        {
+            auto last = asdx::Min((c + 1) * CHUNK_SIZE, vertexCount);
+            for(auto i=c * CHUNK_SIZE; i<last; ++i)
+            { histogram[c * PARTITION_COUNT + partitionOf(i)]++; }
+        }
+    }, maxThreadCount);
+
+    std::vector<uint32_t> partitionOffsets(PARTITION_COUNT + 1, 0);
+    {
+        uint32_t offset = 0;
+        for(uint32_t p=0; p<PARTITION_COUNT; ++p)
+        {
+            partitionOffsets[p] = offset;
+            for(size_t c=0; c<chunkCount; ++c)
+            {
+                auto count = histogram[c * PARTITION_COUNT + p];
+                histogram[c * PARTITION_COUNT + p] = offset;
+                offset += count;
+            }
+        }
+        partitionOffsets[PARTITION_COUNT] = offset;
+    }
+
+    std::vector<uint32_t> sorted(vertexCount);
+    ParallelFor(chunkCount, 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto c=begin; c<end; ++c)
+        {
+            auto last = asdx::Min((c + 1) * CHUNK_SIZE, vertexCount);
+            for(auto i=c * CHUNK_SIZE; i<last; ++i)
+            { sorted[histogram[c * PARTITION_COUNT + partitionOf(i)]++] = uint32_t(i); }
+        }
+    }, maxThreadCount);
+
+    // 区画ごとにハッシュテーブルで重複を探す. 区画内は頂点番号順なので, 最初に現れた頂点が代表になる.
+    remap.resize(vertexCount);
+    ParallelFor(PARTITION_COUNT, 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        // ハッシュ値も格納しておき, 衝突時に頂点データを参照しないようにする.
+        std::vector<Slot> table;
+        for(auto p=begin; p<end; ++p)
+        {
+            auto first = partitionOffsets[p];
+            auto last  = partitionOffsets[p + 1];
+            if (first == last)
+            { continue; }
+
+            auto tableSize = NextPow2((last - first) * 2);
+            auto mask      = tableSize - 1;
+            table.assign(tableSize, Slot{ 0, INVALID_INDEX });
+
+            for(auto i=first; i<last; ++i)
+            {
+                auto v    = sorted[i];
+                auto hash = hashes[v];
+                auto slot = hash & mask;
+                for(;;)
+                {
+                    const auto& entry = table[slot];
+                    if (entry.Index == INVALID_INDEX)
+                    {
+                        table[slot] = Slot{ hash, v };
+                        remap[v]    = v;
+                        break;
+                    }
+
+                    if (entry.Hash == hash && key.IsEqual(entry.Index, v))
+                    {
+                        remap[v] = entry.Index;
+                        break;
+                    }
+
+                    slot = (slot + 1) & mask;
+                }
+            }
+        }
+    }, maxThreadCount);
+
+    // 許容誤差がある場合は, セルの境界をまたぐ頂点を統合する.
+    if (key.HasEpsilon())
+    { MergeNeighborCells(key, remap, maxThreadCount); }
+
+    // 最初に現れた順に新しい番号を振る. 統合先は常に自身より前にあり, 振り直し済み.
+    uint32_t next = 0;
+    for(size_t i=0; i<vertexCount; ++i)
+    { remap[i] = (remap[i] == i) ? next++ : remap[remap[i]]; }
+
+    return next;
+}
+
+//-----------------------------------------------------------------------------
+//      重複頂点を統合し, インデックスを再構築します.
+//-----------------------------------------------------------------------------
+bool WeldVertices(ResMesh& mesh, const WeldDesc& desc, uint32_t maxThreadCount)
+{
+    auto vertexCount = mesh.Positions.size();
+    if (mesh.Indices.empty() && vertexCount % 3 != 0)
+    {
+        ELOGA("Error : Triangle Soup Vertex Count is not multiple of 3. count = %zu", vertexCount);
+        return false;
+    }
+
+    for(auto& index : mesh.Indices)
+    {
+        if (index >= vertexCount)
+        {
+            ELOGA("Error : Index Out Of Range. index = %u, vertexCount = %zu", index, vertexCount);
+            return false;
+        }
+    }
+
+    std::vector<uint32_t> remap;
+    auto uniqueCount = GenerateVertexRemap(mesh, desc, remap, maxThreadCount);
+    if (uniqueCount == 0 && vertexCount != 0)
+    { return false; }
+
+    // 新しい頂点ごとに, 元の代表頂点を求める.
+    std::vector<uint32_t> sources(uniqueCount);
+    for(size_t i=vertexCount; i-- > 0;)
+    { sources[remap[i]] = uint32_t(i); }
+
+    CompactStream(mesh.Positions,   sources, maxThreadCount);
+    CompactStream(mesh.Normals,     sources, maxThreadCount);
+    CompactStream(mesh.Tangents,    sources, maxThreadCount);
+    CompactStream(mesh.Bitangents,  sources, maxThreadCount);
+    CompactStream(mesh.Colors,      sources, maxThreadCount);
+    for(auto i=0; i<MAX_LAYER_COUNT; ++i)
+    { CompactStream(mesh.TexCoords[i], sources, maxThreadCount); }
+    CompactStream(mesh.BoneIndices, sources, maxThreadCount);
+    CompactStream(mesh.BoneWeights, sources, maxThreadCount);
+
+    // インデックスを再構築する.
+    if (mesh.Indices.empty())
+    { mesh.Indices.swap(remap); }
+    else
+    {
+        ParallelFor(mesh.Indices.size(), MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
+        {
+            for(auto i=begin; i<end; ++i)
+            { mesh.Indices[i] = remap[mesh.Indices[i]]; }
+        }, maxThreadCount);
+    }
+
+    return true;
+}
+
+} // namespace asdx
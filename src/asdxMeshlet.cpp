@@ -0,0 +1,524 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMeshlet.cpp
+// Desc : Meshlet Builder.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cfloat>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <asdxMeshlet.h>
+#include <asdxParallel.h>
+#include <asdxLogger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   INVALID_INDEX       = UINT32_MAX;
+static constexpr float      CONE_DISABLE_DOT    = 0.1f;     // 法線のばらつきがこれより大きい場合はコーンを無効にする.
+static constexpr float      BOUNDS_TOLERANCE    = 1e-4f;    // 検証時の許容誤差(相対値).
+
+///////////////////////////////////////////////////////////////////////////////
+// TriangleAdjacency structure
+///////////////////////////////////////////////////////////////////////////////
+struct TriangleAdjacency
+{
+    std::vector<uint32_t>   Counts;     // 頂点ごとの未使用の隣接三角形数.
+    std::vector<uint32_t>   Offsets;    // 頂点ごとの先頭位置.
+    std::vector<uint32_t>   Triangles;  // 隣接三角形番号.
+
+    //-------------------------------------------------------------------------
+    //      隣接情報を構築します.
+    //-------------------------------------------------------------------------
+    void Build(const uint32_t* pIndices, size_t indexCount, size_t vertexCount)
+    {
+        Counts .assign(vertexCount, 0);
+        Offsets.resize(vertexCount);
+        Triangles.resize(indexCount);
+
+        for(size_t i=0; i<indexCount; ++i)
+        { Counts[pIndices[i]]++; }
+
+        uint32_t offset = 0;
+        for(size_t i=0; i<vertexCount; ++i)
+        {
+            Offsets[i] = offset;
+            offset += Counts[i];
+        }
+
+        // 三角形番号の昇順に並ぶので, 候補の探索順も入力だけで決まる.
+        for(size_t i=0; i<indexCount; ++i)
+        {
+            auto v = pIndices[i];
+            Triangles[Offsets[v]++] = uint32_t(i / 3);
+        }
+
+        for(size_t i=0; i<vertexCount; ++i)
+        { Offsets[i] -= Counts[i]; }
+    }
+
+    //-------------------------------------------------------------------------
+    //      使用済みの三角形を取り除きます.
+    //-------------------------------------------------------------------------
+    void Remove(uint32_t vertex, uint32_t triangle)
+    {
+        auto* pList = Triangles.data() + Offsets[vertex];
+        auto  count = Counts[vertex];
+        for(uint32_t i=0; i<count; ++i)
+        {
+            if (pList[i] == triangle)
+            {
+                // 順序を保ったまま詰める.
+                memmove(pList + i, pList + i + 1, sizeof(uint32_t) * (count - i - 1));
+                break;
+            }
+        }
+        Counts[vertex]--;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      メッシュレットの境界を計算します.
+//-----------------------------------------------------------------------------
+asdx::ResMeshletBounds CalcBounds
+(
+    const asdx::ResMesh&        mesh,
+    const asdx::ResMeshlets&    meshlets,
+    const asdx::ResMeshlet&     meshlet
+)
+{
+    asdx::ResMeshletBounds result;
+
+    // 頂点を集めてバウンディングスフィアを求める.
+    asdx::Vector3 points[asdx::MESHLET_MAX_VERTEX_COUNT];
+    for(uint32_t i=0; i<meshlet.VertexCount; ++i)
+    { points[i] = mesh.Positions[meshlets.VertexIndices[meshlet.VertexOffset + i]]; }
+
+    result.Sphere = asdx::BoundingSphere::CreateFromPoints(points, meshlet.VertexCount);
+
+    // 面法線の平均をコーンの軸とする.
+    asdx::Vector3 normals[asdx::MESHLET_MAX_TRIANGLE_COUNT];
+    asdx::Vector3 axis(0.0f, 0.0f, 0.0f);
+    uint32_t normalCount = 0;
+
+    for(uint32_t i=0; i<meshlet.TriangleCount; ++i)
+    {
+        auto packed = meshlets.Triangles[meshlet.TriangleOffset + i];
+        const auto& p0 = points[asdx::UnpackMeshletTriangle(packed, 0)];
+        const auto& p1 = points[asdx::UnpackMeshletTriangle(packed, 1)];
+        const auto& p2 = points[asdx::UnpackMeshletTriangle(packed, 2)];
+
+        auto n   = asdx::Vector3::Cross(p1 - p0, p2 - p0);
+        auto len = n.Length();
+
+        // 縮退した三角形は向きを持たないので無視する.
+        if (len <= FLT_MIN)
+        { continue; }
+
+        normals[normalCount] = n * (1.0f / len);
+        axis += normals[normalCount];
+        normalCount++;
+    }
+
+    result.ConeApex   = result.Sphere.Center;
+    result.ConeAxis   = asdx::Vector3(0.0f, 0.0f, 0.0f);
+    result.ConeCutoff = 1.0f;
+
+    auto axisLen = axis.Length();
+    if (normalCount == 0 || axisLen <= FLT_MIN)
+    { return result; }
+
+    axis *= 1.0f / axisLen;
+
+    auto minDot = 1.0f;
+    for(uint32_t i=0; i<normalCount; ++i)
+    { minDot = asdx::Min(minDot, asdx::Vector3::Dot(normals[i], axis)); }
+
+    // 半球に近いほど広がっている場合は背面判定できない.
+    if (minDot <= CONE_DISABLE_DOT)
+    { return result; }
+
+    // 全ての三角形の平面の背面側に収まるよう, 中心から軸の逆方向に頂点を下げる.
+    auto maxT = 0.0f;
+    auto n    = 0u;
+    for(uint32_t i=0; i<meshlet.TriangleCount; ++i)
+    {
+        auto packed = meshlets.Triangles[meshlet.TriangleOffset + i];
+        const auto& p0 = points[asdx::UnpackMeshletTriangle(packed, 0)];
+        const auto& p1 = points[asdx::UnpackMeshletTriangle(packed, 1)];
+        const auto& p2 = points[asdx::UnpackMeshletTriangle(packed, 2)];
+
+        auto normal = asdx::Vector3::Cross(p1 - p0, p2 - p0);
+        if (normal.Length() <= FLT_MIN)
+        { continue; }
+
+        const auto& fn = normals[n++];
+        auto dc = asdx::Vector3::Dot(result.Sphere.Center - p0, fn);
+        auto dn = asdx::Vector3::Dot(axis, fn);
+
+        // minDot > CONE_DISABLE_DOT なので dn は正.
+        auto t = dc / dn;
+        maxT = asdx::Max(maxT, t);
+    }
+
+    result.ConeApex   = result.Sphere.Center - axis * maxT;
+    result.ConeAxis   = axis;
+    result.ConeCutoff = sqrtf(1.0f - minDot * minDot);
+    return result;
+}
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      メッシュをメッシュレットに分割します.
+//-----------------------------------------------------------------------------
+bool BuildMeshlets(const ResMesh& mesh, const MeshletDesc& desc, ResMeshlets& result)
+{
+    result.Meshlets     .clear();
+    result.Bounds       .clear();
+    result.VertexIndices.clear();
+    result.Triangles    .clear();
+
+    if (desc.MaxVertexCount < 3 || desc.MaxVertexCount > MESHLET_MAX_VERTEX_COUNT
+     || desc.MaxTriangleCount == 0 || desc.MaxTriangleCount > MESHLET_MAX_TRIANGLE_COUNT)
+    {
+        ELOGA("Error : Invalid Argument. MaxVertexCount = %u, MaxTriangleCount = %u",
+            desc.MaxVertexCount, desc.MaxTriangleCount);
+        return false;
+    }
+
+    if (mesh.Indices.size() % 3 != 0)
+    {
+        ELOGA("Error : Index Count is not multiple of 3. count = %zu", mesh.Indices.size());
+        return false;
+    }
+
+    auto vertexCount   = mesh.Positions.size();
+    auto triangleCount = mesh.Indices.size() / 3;
+    const auto* pIndices = mesh.Indices.data();
+
+    for(auto& index : mesh.Indices)
+    {
+        if (index >= vertexCount)
+        {
+            ELOGA("Error : Index Out Of Range. index = %u, vertexCount = %zu", index, vertexCount);
+            return false;
+        }
+    }
+
+    if (triangleCount == 0)
+    { return true; }
+
+    TriangleAdjacency adjacency;
+    adjacency.Build(pIndices, mesh.Indices.size(), vertexCount);
+
+    std::vector<uint8_t>  emitted(triangleCount, 0);
+    std::vector<uint32_t> localIndex(vertexCount, INVALID_INDEX);
+
+    // 見積もりで確保しておく.
+    auto estimate = (triangleCount + desc.MaxTriangleCount - 1) / desc.MaxTriangleCount;
+    result.Meshlets     .reserve(estimate);
+    result.VertexIndices.reserve(estimate * desc.MaxVertexCount);
+    result.Triangles    .reserve(triangleCount);
+
+    ResMeshlet current   = {};
+    Vector3    centerSum = Vector3(0.0f, 0.0f, 0.0f);
+    size_t     cursor    = 0;
+
+    // 現在のメッシュレットを確定する.
+    auto flush = [&]()
+    {
+        if (current.TriangleCount == 0)
+        { return; }
+
+        for(uint32_t i=0; i<current.VertexCount; ++i)
+        { localIndex[result.VertexIndices[current.VertexOffset + i]] = INVALID_INDEX; }
+
+        result.Meshlets.push_back(current);
+        centerSum = Vector3(0.0f, 0.0f, 0.0f);
+
+        current = {};
+        current.VertexOffset   = uint32_t(result.VertexIndices.size());
+        current.TriangleOffset = uint32_t(result.Triangles.size());
+    };
+
+    // 三角形が追加する頂点数を求める.
+    auto countNewVertices = [&](uint32_t triangle)
+    {
+        const auto* tri = pIndices + triangle * 3;
+        uint32_t count = 0;
+        count += (localIndex[tri[0]] == INVALID_INDEX) ? 1 : 0;
+        count += (localIndex[tri[1]] == INVALID_INDEX && tri[1] != tri[0]) ? 1 : 0;
+        count += (localIndex[tri[2]] == INVALID_INDEX && tri[2] != tri[0] && tri[2] != tri[1]) ? 1 : 0;
+        return count;
+    };
+
+    for(size_t emittedCount=0; emittedCount<triangleCount; ++emittedCount)
+    {
+        // メッシュレット内の頂点に隣接する三角形から, 追加頂点数が最小のものを選ぶ.
+        // 同数の場合は取り残されやすい, 未使用の隣接三角形が少ないものを優先し,
+        // 更に中心に近いものを選んでメッシュレットが細長くならないようにする.
+        auto best      = INVALID_INDEX;
+        auto bestExtra = UINT32_MAX;
+        auto bestLive  = UINT32_MAX;
+        auto bestDist  = FLT_MAX;
+        auto center    = centerSum * ((current.VertexCount > 0) ? 1.0f / float(current.VertexCount) : 0.0f);
+        for(uint32_t i=0; i<current.VertexCount; ++i)
+        {
+            auto v = result.VertexIndices[current.VertexOffset + i];
+            const auto* pList = adjacency.Triangles.data() + adjacency.Offsets[v];
+            for(uint32_t j=0; j<adjacency.Counts[v]; ++j)
+            {
+                auto t     = pList[j];
+                auto extra = countNewVertices(t);
+                if (extra > bestExtra)
+                { continue; }
+
+                const auto* tri = pIndices + t * 3;
+                auto live = adjacency.Counts[tri[0]] + adjacency.Counts[tri[1]] + adjacency.Counts[tri[2]];
+                if (extra == bestExtra && live > bestLive)
+                { continue; }
+
+                auto c    = (mesh.Positions[tri[0]] + mesh.Positions[tri[1]] + mesh.Positions[tri[2]]) * (1.0f / 3.0f);
+                auto dist = Vector3::DistanceSq(c, center);
+                if (extra < bestExtra || live < bestLive || dist < bestDist || (dist == bestDist && t < best))
+                {
+                    best      = t;
+                    bestExtra = extra;
+                    bestLive  = live;
+                    bestDist  = dist;
+                }
+            }
+        }
+
+        // 隣接する候補が無いか収まらない場合は新しいメッシュレットを始める.
+        if (best == INVALID_INDEX
+         || current.VertexCount + bestExtra > desc.MaxVertexCount
+         || current.TriangleCount + 1 > desc.MaxTriangleCount)
+        {
+            flush();
+
+            // 収まらなかった隣接三角形はそのまま次のメッシュレットの先頭にする.
+            if (best == INVALID_INDEX)
+            {
+                while (emitted[cursor] != 0)
+                { cursor++; }
+                best = uint32_t(cursor);
+            }
+        }
+
+        // 三角形を追加する.
+        const auto* tri = pIndices + best * 3;
+        uint32_t local[3];
+        for(auto k=0; k<3; ++k)
+        {
+            auto v = tri[k];
+            if (localIndex[v] == INVALID_INDEX)
+            {
+                localIndex[v] = current.VertexCount++;
+                result.VertexIndices.push_back(v);
+                centerSum += mesh.Positions[v];
+            }
+            local[k] = localIndex[v];
+        }
+
+        result.Triangles.push_back(PackMeshletTriangle(local[0], local[1], local[2]));
+        current.TriangleCount++;
+
+        // 隣接リストには頂点の出現ごとに登録されているので, 同じ回数だけ取り除く.
+        emitted[best] = 1;
+        adjacency.Remove(tri[0], best);
+        adjacency.Remove(tri[1], best);
+        adjacency.Remove(tri[2], best);
+    }
+
+    flush();
+
+    result.Bounds.resize(result.Meshlets.size());
+    for(size_t i=0; i<result.Meshlets.size(); ++i)
+    { result.Bounds[i] = CalcBounds(mesh, result, result.Meshlets[i]); }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      モデルの全メッシュをメッシュレットに分割します.
+//-----------------------------------------------------------------------------
+bool BuildMeshlets
+(
+    const ResModel&             model,
+    const MeshletDesc&          desc,
+    std::vector<ResMeshlets>&   result,
+    uint32_t                    maxThreadCount
+)
+{
+    result.resize(model.Meshes.size());
+
+    // メッシュごとに結果の格納先が決まっているので, 分割単位に依存しない.
+    std::atomic<bool> succeeded(true);
+    ParallelFor(model.Meshes.size(), 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            if (!BuildMeshlets(model.Meshes[i], desc, result[i]))
+            { succeeded = false; }
+        }
+    }, maxThreadCount);
+
+    return succeeded;
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュレットを検証します.
+//-----------------------------------------------------------------------------
+bool ValidateMeshlets(const ResMesh& mesh, const MeshletDesc& desc, const ResMeshlets& meshlets)
+{
+    if (meshlets.Bounds.size() != meshlets.Meshlets.size())
+    {
+        ELOGA("Error : Bounds Count Mismatch. bounds = %zu, meshlets = %zu",
+            meshlets.Bounds.size(), meshlets.Meshlets.size());
+        return false;
+    }
+
+    auto vertexCount = mesh.Positions.size();
+    std::vector<uint32_t> triangles;
+    triangles.reserve(mesh.Indices.size());
+
+    for(size_t i=0; i<meshlets.Meshlets.size(); ++i)
+    {
+        const auto& meshlet = meshlets.Meshlets[i];
+        const auto& bounds  = meshlets.Bounds[i];
+
+        if (meshlet.VertexCount > desc.MaxVertexCount || meshlet.TriangleCount > desc.MaxTriangleCount
+         || meshlet.TriangleCount == 0)
+        {
+            ELOGA("Error : Meshlet Limit Exceeded. meshlet = %zu, vertices = %u, triangles = %u",
+                i, meshlet.VertexCount, meshlet.TriangleCount);
+            return false;
+        }
+
+        if (size_t(meshlet.VertexOffset) + meshlet.VertexCount > meshlets.VertexIndices.size()
+         || size_t(meshlet.TriangleOffset) + meshlet.TriangleCount > meshlets.Triangles.size())
+        {
+            ELOGA("Error : Meshlet Range Out Of Bounds. meshlet = %zu", i);
+            return false;
+        }
+
+        // 境界の許容誤差は大きさに比例させる.
+        auto tolerance = BOUNDS_TOLERANCE * asdx::Max(bounds.Sphere.Radius, 1.0f);
+
+        for(uint32_t j=0; j<meshlet.VertexCount; ++j)
+        {
+            auto v = meshlets.VertexIndices[meshlet.VertexOffset + j];
+            if (v >= vertexCount)
+            {
+                ELOGA("Error : Vertex Index Out Of Range. meshlet = %zu, index = %u", i, v);
+                return false;
+            }
+
+            auto dist = Vector3::Distance(mesh.Positions[v], bounds.Sphere.Center);
+            if (dist > bounds.Sphere.Radius + tolerance)
+            {
+                ELOGA("Error : Vertex Outside Bounding Sphere. meshlet = %zu, index = %u", i, v);
+                return false;
+            }
+        }
+
+        for(uint32_t j=0; j<meshlet.TriangleCount; ++j)
+        {
+            auto packed = meshlets.Triangles[meshlet.TriangleOffset + j];
+            uint32_t tri[3];
+            for(auto k=0; k<3; ++k)
+            {
+                auto local = UnpackMeshletTriangle(packed, k);
+                if (local >= meshlet.VertexCount)
+                {
+                    ELOGA("Error : Local Index Out Of Range. meshlet = %zu, local = %u", i, local);
+                    return false;
+                }
+                tri[k] = meshlets.VertexIndices[meshlet.VertexOffset + local];
+            }
+
+            // 背面判定が保守的であることを確認する. コーンの頂点は全ての面の裏側にある.
+            const auto& p0 = mesh.Positions[tri[0]];
+            const auto& p1 = mesh.Positions[tri[1]];
+            const auto& p2 = mesh.Positions[tri[2]];
+            auto n   = Vector3::Cross(p1 - p0, p2 - p0);
+            auto len = n.Length();
+            if (len > FLT_MIN && Vector3::Dot(bounds.ConeAxis, bounds.ConeAxis) > 0.0f)
+            {
+                n *= 1.0f / len;
+                auto cosAngle = Vector3::Dot(n, bounds.ConeAxis);
+                auto sinAngle = sqrtf(asdx::Max(1.0f - cosAngle * cosAngle, 0.0f));
+                if (cosAngle <= 0.0f || sinAngle > bounds.ConeCutoff + BOUNDS_TOLERANCE
+                 || Vector3::Dot(bounds.ConeApex - p0, n) > tolerance)
+                {
+                    ELOGA("Error : Triangle Outside Normal Cone. meshlet = %zu, triangle = %u", i, j);
+                    return false;
+                }
+            }
+
+            // 回転を正規化して比較できるようにする.
+            auto first = uint32_t(std::min_element(tri, tri + 3) - tri);
+            triangles.push_back(tri[first]);
+            triangles.push_back(tri[(first + 1) % 3]);
+            triangles.push_back(tri[(first + 2) % 3]);
+        }
+    }
+
+    // 全ての三角形をちょうど1回ずつ含むことを確認する.
+    std::vector<uint32_t> reference;
+    reference.reserve(mesh.Indices.size());
+    for(size_t i=0; i + 2<mesh.Indices.size(); i+=3)
+    {
+        const auto* tri = mesh.Indices.data() + i;
+        auto first = uint32_t(std::min_element(tri, tri + 3) - tri);
+        reference.push_back(tri[first]);
+        reference.push_back(tri[(first + 1) % 3]);
+        reference.push_back(tri[(first + 2) % 3]);
+    }
+
+    auto sortTriangles = [](std::vector<uint32_t>& values)
+    {
+        auto count = values.size() / 3;
+        std::vector<uint32_t> order(count);
+        for(size_t i=0; i<count; ++i)
+        { order[i] = uint32_t(i); }
+
+        std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs)
+        { return std::lexicographical_compare(&values[lhs * 3], &values[lhs * 3] + 3, &values[rhs * 3], &values[rhs * 3] + 3); });
+
+        std::vector<uint32_t> sorted(values.size());
+        for(size_t i=0; i<count; ++i)
+        {
+            sorted[i * 3 + 0] = values[order[i] * 3 + 0];
+            sorted[i * 3 + 1] = values[order[i] * 3 + 1];
+            sorted[i * 3 + 2] = values[order[i] * 3 + 2];
+        }
+        values.swap(sorted);
+    };
+
+    sortTriangles(triangles);
+    sortTriangles(reference);
+
+    if (triangles != reference)
+    {
+        ELOGA("Error : Meshlet Triangles Mismatch. meshlet = %zu, mesh = %zu",
+            triangles.size() / 3, reference.size() / 3);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace asdx
@@ -0,0 +1,926 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxObj.cpp
+// Desc : Wavefront OBJ Loader.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxObj.h>
+#include <asdxMappedFile.h>
+#include <asdxParallel.h>
+#include <asdxLogger.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t     MIN_CHUNK_SIZE      = 1024 * 1024;  // 1チャンクの最小バイト数.
+static constexpr uint32_t   INVALID_INDEX       = UINT32_MAX;
+static constexpr uint32_t   MAX_SIGNIFICANT     = 19;           // uint64_t に収まる10進数の桁数.
+static constexpr uint64_t   MAX_EXACT_MANTISSA  = 1ull << 53;   // double で正確に表せる整数の最大値.
+static constexpr uint64_t   FLOAT_ROUND_MASK    = (1ull << 29) - 1; // float に丸めると捨てられる double の仮数ビット.
+static constexpr uint64_t   FLOAT_HALFWAY       = 1ull << 28;       // float の丁度中間を表す捨てられるビット.
+
+// double で正確に表せる10の累乗.
+static const double POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+static constexpr int MAX_EXACT_POW10 = int(sizeof(POW10) / sizeof(POW10[0])) - 1;
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjCorner structure
+///////////////////////////////////////////////////////////////////////////////
+struct ObjCorner
+{
+    uint32_t    Position;   // 位置座標の番号.
+    uint32_t    TexCoord;   // テクスチャ座標の番号(無い場合は INVALID_INDEX).
+    uint32_t    Normal;     // 法線の番号(無い場合は INVALID_INDEX).
+
+    bool operator == (const ObjCorner& value) const
+    { return Position == value.Position && TexCoord == value.TexCoord && Normal == value.Normal; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjRun structure
+///////////////////////////////////////////////////////////////////////////////
+struct ObjRun
+{
+    uint32_t    FirstCorner;    // この指定以降の先頭の角.
+    bool        IsMaterial;     // true なら usemtl, false なら g または o.
+    std::string Name;           // 名前.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjChunk structure
+///////////////////////////////////////////////////////////////////////////////
+struct ObjChunk
+{
+    const char*                 pBegin          = nullptr;  // 先頭.
+    const char*                 pEnd            = nullptr;  // 終端(改行の次).
+    uint32_t                    PositionCount   = 0;        // v の数.
+    uint32_t                    TexCoordCount   = 0;        // vt の数.
+    uint32_t                    NormalCount     = 0;        // vn の数.
+    uint32_t                    PositionBase    = 0;        // 先頭の v の番号.
+    uint32_t                    TexCoordBase    = 0;        // 先頭の vt の番号.
+    uint32_t                    NormalBase      = 0;        // 先頭の vn の番号.
+    std::vector<ObjCorner>      Corners;                    // 三角形化した面の角.
+    std::vector<ObjRun>         Runs;                       // グループとマテリアルの切り替え.
+    std::vector<std::string>    MaterialLibs;               // mtllib で指定されたファイル.
+    std::vector<asdx::Vector4>  Colors;                     // 頂点カラー(無い場合は空).
+    const char*                 pError          = nullptr;  // 解析に失敗した行.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjMeshSource structure
+///////////////////////////////////////////////////////////////////////////////
+struct ObjMeshSource
+{
+    std::string                                         Group;          // グループ名.
+    std::string                                         Material;       // マテリアル名.
+    std::vector<std::pair<const ObjCorner*, size_t>>    Ranges;         // 角の範囲.
+    size_t                                              CornerCount = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjAttributes structure
+///////////////////////////////////////////////////////////////////////////////
+struct ObjAttributes
+{
+    std::vector<asdx::Vector3>  Positions;
+    std::vector<asdx::Vector2>  TexCoords;
+    std::vector<asdx::Vector3>  Normals;
+    std::vector<asdx::Vector4>  Colors;
+};
+
+//-----------------------------------------------------------------------------
+//      改行以外の空白かどうか判定します.
+//-----------------------------------------------------------------------------
+inline bool IsSpace(char c)
+{ return c == ' ' || c == '\t' || c == '\r'; }
+
+//-----------------------------------------------------------------------------
+//      数字かどうか判定します.
+//-----------------------------------------------------------------------------
+inline bool IsDigit(char c)
+{ return uint8_t(c - '0') < 10; }
+
+//-----------------------------------------------------------------------------
+//      空白を読み飛ばします.
+//-----------------------------------------------------------------------------
+inline const char* SkipSpace(const char* p, const char* end)
+{
+    while(p < end && IsSpace(*p))
+    { p++; }
+    return p;
+}
+
+//-----------------------------------------------------------------------------
+//      キーワードと一致する場合は, 続く引数の位置を取得します.
+//-----------------------------------------------------------------------------
+inline bool MatchKeyword(const char* p, const char* end, const char* keyword, const char*& args)
+{
+    auto length = strlen(keyword);
+    if (size_t(end - p) < length || memcmp(p, keyword, length) != 0)
+    { return false; }
+
+    p += length;
+    if (p < end && !IsSpace(*p))
+    { return false; }
+
+    args = SkipSpace(p, end);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      行末までを前後の空白を除いた文字列として取得します.
+//-----------------------------------------------------------------------------
+inline std::string GetRestOfLine(const char* p, const char* end)
+{
+    p = SkipSpace(p, end);
+    while(end > p && IsSpace(end[-1]))
+    { end--; }
+    return std::string(p, end);
+}
+
+//-----------------------------------------------------------------------------
+//      strtod() で浮動小数を読み込みます.
+//-----------------------------------------------------------------------------
+const char* ParseFloatSlow(const char* p, const char* end, float& value)
+{
+    // テキストは終端されていないので, 一時バッファにコピーして変換する.
+    char buffer[64];
+    size_t count = 0;
+    while(p + count < end && count < sizeof(buffer) - 1 && !IsSpace(p[count]) && p[count] != '/' && p[count] != '\n')
+    {
+        buffer[count] = p[count];
+        count++;
+    }
+    buffer[count] = '\0';
+
+    char* pEnd = nullptr;
+    value = strtof(buffer, &pEnd);
+    return (pEnd == buffer) ? nullptr : p + (pEnd - buffer);
+}
+
+//-----------------------------------------------------------------------------
+//      浮動小数を読み込みます. 失敗した場合は nullptr を返却します.
+//-----------------------------------------------------------------------------
+inline const char* ParseFloat(const char* p, const char* end, float& value)
+{
+    auto begin    = p;
+    auto negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // 19桁までを仮数に集め, 残りは指数で扱う.
+    uint64_t mantissa = 0;
+    uint32_t digits   = 0;
+    int      exponent = 0;
+    auto     found    = false;
+    for(; p < end && IsDigit(*p); ++p)
+    {
+        found = true;
+        if (digits < MAX_SIGNIFICANT)
+        {
+            mantissa = mantissa * 10 + uint32_t(*p - '0');
+            digits += (mantissa != 0) ? 1 : 0;
+        }
+        else
+        { exponent++; }
+    }
+
+    if (p < end && *p == '.')
+    {
+        for(++p; p < end && IsDigit(*p); ++p)
+        {
+            found = true;
+            if (digits < MAX_SIGNIFICANT)
+            {
+                mantissa = mantissa * 10 + uint32_t(*p - '0');
+                digits += (mantissa != 0) ? 1 : 0;
+                exponent--;
+            }
+        }
+    }
+
+    // nan や inf など.
+    if (!found)
+    { return ParseFloatSlow(begin, end, value); }
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        auto q = p + 1;
+        auto negativeExponent = false;
+        if (q < end && (*q == '-' || *q == '+'))
+        {
+            negativeExponent = (*q == '-');
+            q++;
+        }
+
+        if (q < end && IsDigit(*q))
+        {
+            int e = 0;
+            for(; q < end && IsDigit(*q); ++q)
+            {
+                if (e < 100000)
+                { e = e * 10 + (*q - '0'); }
+            }
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+
+    // 仮数と10の累乗が double で正確に表せる場合は, 1回の乗除算で double に正しく丸められる.
+    if (mantissa > MAX_EXACT_MANTISSA || exponent < -MAX_EXACT_POW10 || exponent > MAX_EXACT_POW10)
+    { return ParseFloatSlow(begin, end, value); }
+
+    auto result = double(mantissa);
+    result = (exponent < 0) ? result / POW10[-exponent] : result * POW10[exponent];
+
+    // double の結果が float の丁度中間に丸められた場合だけは, float への丸めで
+    // 二重丸めになり得るので strtof() に任せる. それ以外は strtof() と一致する.
+    // (範囲は 1e-22 から 2^53 * 1e22 なので, float の非正規化数や無限大にはならない.)
+    uint64_t bits;
+    memcpy(&bits, &result, sizeof(bits));
+    if ((bits & FLOAT_ROUND_MASK) == FLOAT_HALFWAY)
+    { return ParseFloatSlow(begin, end, value); }
+
+    value = float(negative ? -result : result);
+    return p;
+}
+
+//-----------------------------------------------------------------------------
+//      符号付き整数を読み込みます. 失敗した場合は nullptr を返却します.
+//-----------------------------------------------------------------------------
+inline const char* ParseInt(const char* p, const char* end, int64_t& value)
+{
+    auto negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    if (p >= end || !IsDigit(*p))
+    { return nullptr; }
+
+    int64_t result = 0;
+    for(; p < end && IsDigit(*p); ++p)
+    {
+        if (result < INT32_MAX)
+        { result = result * 10 + (*p - '0'); }
+    }
+
+    value = negative ? -result : result;
+    return p;
+}
+
+//-----------------------------------------------------------------------------
+//      面の頂点番号を 0 から始まる番号に変換します.
+//-----------------------------------------------------------------------------
+inline bool ResolveIndex(int64_t index, uint32_t definedCount, uint32_t totalCount, uint32_t& result)
+{
+    // 負の値はその行までに定義された要素からの相対位置.
+    auto value = (index > 0) ? index - 1 : int64_t(definedCount) + index;
+    if (index == 0 || value < 0 || value >= int64_t(totalCount))
+    { return false; }
+
+    result = uint32_t(value);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      行の終端を取得します.
+//-----------------------------------------------------------------------------
+inline const char* FindLineEnd(const char* p, const char* end)
+{
+    auto result = static_cast<const char*>(memchr(p, '\n', size_t(end - p)));
+    return (result != nullptr) ? result : end;
+}
+
+//-----------------------------------------------------------------------------
+//      チャンク内の頂点属性の数を数えます.
+//-----------------------------------------------------------------------------
+void CountAttributes(ObjChunk& chunk)
+{
+    auto end = chunk.pEnd;
+    for(auto p = chunk.pBegin; p < end; )
+    {
+        auto lineEnd = FindLineEnd(p, end);
+        const char* args = nullptr;
+        p = SkipSpace(p, lineEnd);
+
+        // ParseChunk() と同じ条件で数える.
+        if (p < lineEnd && *p == 'v')
+        {
+            if (MatchKeyword(p, lineEnd, "v", args))
+            { chunk.PositionCount++; }
+            else if (MatchKeyword(p, lineEnd, "vt", args))
+            { chunk.TexCoordCount++; }
+            else if (MatchKeyword(p, lineEnd, "vn", args))
+            { chunk.NormalCount++; }
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      面を読み込みます.
+//-----------------------------------------------------------------------------
+bool ParseFace
+(
+    const char*             p,
+    const char*             end,
+    const ObjChunk&         chunk,
+    uint32_t                positionLocal,
+    uint32_t                texCoordLocal,
+    uint32_t                normalLocal,
+    const ObjAttributes&    attributes,
+    std::vector<ObjCorner>& corners
+)
+{
+    auto positionCount = uint32_t(attributes.Positions.size());
+    auto texCoordCount = uint32_t(attributes.TexCoords.size());
+    auto normalCount   = uint32_t(attributes.Normals  .size());
+
+    ObjCorner first = {};
+    ObjCorner prev  = {};
+    uint32_t  count = 0;
+
+    for(;;)
+    {
+        p = SkipSpace(p, end);
+        if (p >= end || *p == '#')
+        { break; }
+
+        ObjCorner corner = { INVALID_INDEX, INVALID_INDEX, INVALID_INDEX };
+        int64_t index;
+
+        p = ParseInt(p, end, index);
+        if (p == nullptr || !ResolveIndex(index, chunk.PositionBase + positionLocal, positionCount, corner.Position))
+        { return false; }
+
+        if (p < end && *p == '/')
+        {
+            p++;
+            if (p < end && *p != '/')
+            {
+                p = ParseInt(p, end, index);
+                if (p == nullptr || !ResolveIndex(index, chunk.TexCoordBase + texCoordLocal, texCoordCount, corner.TexCoord))
+                { return false; }
+            }
+
+            if (p < end && *p == '/')
+            {
+                p = ParseInt(p + 1, end, index);
+                if (p == nullptr || !ResolveIndex(index, chunk.NormalBase + normalLocal, normalCount, corner.Normal))
+                { return false; }
+            }
+        }
+
+        if (p < end && !IsSpace(*p))
+        { return false; }
+
+        // 多角形は扇状に三角形化する.
+        if (count == 0)
+        { first = corner; }
+        else if (count >= 2)
+        {
+            corners.push_back(first);
+            corners.push_back(prev);
+            corners.push_back(corner);
+        }
+
+        prev = corner;
+        count++;
+    }
+
+    return count >= 3;
+}
+
+//-----------------------------------------------------------------------------
+//      チャンクを解析します.
+//-----------------------------------------------------------------------------
+void ParseChunk(ObjChunk& chunk, ObjAttributes& attributes)
+{
+    uint32_t positionLocal = 0;
+    uint32_t texCoordLocal = 0;
+    uint32_t normalLocal   = 0;
+
+    auto end = chunk.pEnd;
+    for(auto p = chunk.pBegin; p < end; )
+    {
+        auto lineBegin = p;
+        auto lineEnd   = FindLineEnd(p, end);
+        auto succeeded = true;
+        const char* args = nullptr;
+
+        p = SkipSpace(p, lineEnd);
+        if (p >= lineEnd || *p == '#')
+        {
+            // 空行とコメント.
+        }
+        else if (MatchKeyword(p, lineEnd, "v", args))
+        {
+            auto& position = attributes.Positions[chunk.PositionBase + positionLocal];
+            args = ParseFloat(args, lineEnd, position.x);
+            if (args != nullptr) { args = ParseFloat(SkipSpace(args, lineEnd), lineEnd, position.y); }
+            if (args != nullptr) { args = ParseFloat(SkipSpace(args, lineEnd), lineEnd, position.z); }
+            succeeded = (args != nullptr);
+
+            // x y z r g b 形式の頂点カラー.
+            float color[3];
+            auto q = (args != nullptr) ? SkipSpace(args, lineEnd) : lineEnd;
+            if (q < lineEnd && *q != '#')
+            {
+                q = ParseFloat(q, lineEnd, color[0]);
+                if (q != nullptr) { q = ParseFloat(SkipSpace(q, lineEnd), lineEnd, color[1]); }
+                if (q != nullptr) { q = ParseFloat(SkipSpace(q, lineEnd), lineEnd, color[2]); }
+
+                if (q != nullptr)
+                {
+                    if (chunk.Colors.empty())
+                    { chunk.Colors.resize(chunk.PositionCount, asdx::Vector4(1.0f, 1.0f, 1.0f, 1.0f)); }
+                    chunk.Colors[positionLocal] = asdx::Vector4(color[0], color[1], color[2], 1.0f);
+                }
+            }
+
+            positionLocal++;
+        }
+        else if (MatchKeyword(p, lineEnd, "vt", args))
+        {
+            // v と w は省略可能.
+            auto& texcoord = attributes.TexCoords[chunk.TexCoordBase + texCoordLocal];
+            texcoord.y = 0.0f;
+            args = ParseFloat(args, lineEnd, texcoord.x);
+            succeeded = (args != nullptr);
+
+            args = (args != nullptr) ? SkipSpace(args, lineEnd) : lineEnd;
+            if (args < lineEnd && *args != '#')
+            { succeeded = (ParseFloat(args, lineEnd, texcoord.y) != nullptr); }
+
+            texCoordLocal++;
+        }
+        else if (MatchKeyword(p, lineEnd, "vn", args))
+        {
+            auto& normal = attributes.Normals[chunk.NormalBase + normalLocal];
+            args = ParseFloat(args, lineEnd, normal.x);
+            if (args != nullptr) { args = ParseFloat(SkipSpace(args, lineEnd), lineEnd, normal.y); }
+            if (args != nullptr) { args = ParseFloat(SkipSpace(args, lineEnd), lineEnd, normal.z); }
+            succeeded = (args != nullptr);
+
+            normalLocal++;
+        }
+        else if (MatchKeyword(p, lineEnd, "f", args))
+        {
+            succeeded = ParseFace(args, lineEnd, chunk,
+                positionLocal, texCoordLocal, normalLocal, attributes, chunk.Corners);
+        }
+        else if (MatchKeyword(p, lineEnd, "g", args) || MatchKeyword(p, lineEnd, "o", args))
+        {
+            chunk.Runs.push_back({ uint32_t(chunk.Corners.size()), false, GetRestOfLine(args, lineEnd) });
+        }
+        else if (MatchKeyword(p, lineEnd, "usemtl", args))
+        {
+            chunk.Runs.push_back({ uint32_t(chunk.Corners.size()), true, GetRestOfLine(args, lineEnd) });
+        }
+        else if (MatchKeyword(p, lineEnd, "mtllib", args))
+        {
+            chunk.MaterialLibs.push_back(GetRestOfLine(args, lineEnd));
+        }
+
+        // s, l, p などは無視する.
+        if (!succeeded)
+        {
+            chunk.pError = lineBegin;
+            return;
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュを構築します.
+//-----------------------------------------------------------------------------
+void BuildMesh(const ObjMeshSource& source, const ObjAttributes& attributes, asdx::ResMesh& mesh)
+{
+    mesh.MeshName     = source.Group.empty() ? std::string("default") : source.Group;
+    mesh.MaterialName = source.Material;
+
+    // 頂点番号の組をキーとするオープンアドレス法のハッシュテーブル.
+    struct Slot
+    {
+        ObjCorner   Key;
+        uint32_t    Index;
+    };
+
+    size_t capacity = 16;
+    while(capacity < source.CornerCount * 2)
+    { capacity <<= 1; }
+
+    std::vector<Slot> table(capacity, Slot{ {}, INVALID_INDEX });
+    std::vector<ObjCorner> uniques;
+    auto mask = capacity - 1;
+
+    mesh.Indices.resize(source.CornerCount);
+    size_t cursor = 0;
+    auto hasTexCoord = false;
+    auto hasNormal   = false;
+
+    for(auto& range : source.Ranges)
+    {
+        for(size_t i=0; i<range.second; ++i)
+        {
+            const auto& corner = range.first[i];
+            auto hash = corner.Position * 0x9e3779b1u ^ corner.TexCoord * 0x85ebca77u ^ corner.Normal * 0xc2b2ae3du;
+            hash ^= hash >> 15;
+
+            auto slot = size_t(hash) & mask;
+            while(table[slot].Index != INVALID_INDEX && !(table[slot].Key == corner))
+            { slot = (slot + 1) & mask; }
+
+            if (table[slot].Index == INVALID_INDEX)
+            {
+                table[slot].Key   = corner;
+                table[slot].Index = uint32_t(uniques.size());
+                uniques.push_back(corner);
+                hasTexCoord |= (corner.TexCoord != INVALID_INDEX);
+                hasNormal   |= (corner.Normal   != INVALID_INDEX);
+            }
+
+            mesh.Indices[cursor++] = table[slot].Index;
+        }
+    }
+
+    // 一部の角にしか無い属性は0で埋める.
+    auto count = uniques.size();
+    mesh.Positions.resize(count);
+    for(size_t i=0; i<count; ++i)
+    { mesh.Positions[i] = attributes.Positions[uniques[i].Position]; }
+
+    if (hasTexCoord)
+    {
+        mesh.TexCoords[0].resize(count);
+        for(size_t i=0; i<count; ++i)
+        {
+            auto index = uniques[i].TexCoord;
+            mesh.TexCoords[0][i] = (index != INVALID_INDEX) ? attributes.TexCoords[index] : asdx::Vector2(0.0f, 0.0f);
+        }
+    }
+
+    if (hasNormal)
+    {
+        mesh.Normals.resize(count);
+        for(size_t i=0; i<count; ++i)
+        {
+            auto index = uniques[i].Normal;
+            mesh.Normals[i] = (index != INVALID_INDEX) ? attributes.Normals[index] : asdx::Vector3(0.0f, 0.0f, 0.0f);
+        }
+    }
+
+    if (!attributes.Colors.empty())
+    {
+        mesh.Colors.resize(count);
+        for(size_t i=0; i<count; ++i)
+        { mesh.Colors[i] = attributes.Colors[uniques[i].Position]; }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルパスのディレクトリ部分を取得します.
+//-----------------------------------------------------------------------------
+std::string GetDirectory(const char* path)
+{
+    std::string result = path;
+    auto pos = result.find_last_of("/\\");
+    return (pos == std::string::npos) ? std::string(".") : result.substr(0, pos);
+}
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      Wavefront OBJ ファイルを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadObj(const char* filename, ResModel& result, uint32_t maxThreadCount)
+{
+    if (filename == nullptr)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.Open(filename))
+    { return false; }
+
+    auto directory = GetDirectory(filename);
+    return LoadObj(file.GetData(), file.GetSize(), directory.c_str(), result, maxThreadCount);
+}
+
+//-----------------------------------------------------------------------------
+//      メモリ上の Wavefront OBJ データを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadObj
+(
+    const void*     pBuffer,
+    size_t          size,
+    const char*     baseDirectory,
+    ResModel&       result,
+    uint32_t        maxThreadCount
+)
+{
+    result.Meshes   .clear();
+    result.Materials.clear();
+
+    if (pBuffer == nullptr || size == 0)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    // 行の途中で分割しないように, チャンクの終端を改行の次に合わせる.
+    auto pText = static_cast<const char*>(pBuffer);
+    auto pEnd  = pText + size;
+
+    auto threadCount = GetWorkerThreadCount(maxThreadCount);
+    auto chunkCount  = Max<size_t>(1, Min<size_t>(threadCount, size / MIN_CHUNK_SIZE));
+    auto chunkSize   = size / chunkCount;
+
+    std::vector<ObjChunk> chunks;
+    chunks.reserve(chunkCount);
+    for(auto p = pText; p < pEnd; )
+    {
+        auto end = (chunks.size() + 1 < chunkCount) ? p + chunkSize : pEnd;
+        end = (end < pEnd) ? FindLineEnd(end, pEnd) : pEnd;
+        end = (end < pEnd) ? end + 1 : pEnd;
+
+        ObjChunk chunk;
+        chunk.pBegin = p;
+        chunk.pEnd   = end;
+        chunks.push_back(std::move(chunk));
+        p = end;
+    }
+
+    // 属性の数を数えて, 各チャンクの書き込み先を決める.
+    ParallelFor(chunks.size(), 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        { CountAttributes(chunks[i]); }
+    }, maxThreadCount);
+
+    uint64_t positionCount = 0;
+    uint64_t texCoordCount = 0;
+    uint64_t normalCount   = 0;
+    for(auto& chunk : chunks)
+    {
+        chunk.PositionBase = uint32_t(positionCount);
+        chunk.TexCoordBase = uint32_t(texCoordCount);
+        chunk.NormalBase   = uint32_t(normalCount);
+        positionCount += chunk.PositionCount;
+        texCoordCount += chunk.TexCoordCount;
+        normalCount   += chunk.NormalCount;
+    }
+
+    if (positionCount >= INVALID_INDEX || texCoordCount >= INVALID_INDEX || normalCount >= INVALID_INDEX)
+    {
+        ELOGA("Error : Too Many Vertices.");
+        return false;
+    }
+
+    ObjAttributes attributes;
+    attributes.Positions.resize(size_t(positionCount));
+    attributes.TexCoords.resize(size_t(texCoordCount));
+    attributes.Normals  .resize(size_t(normalCount));
+
+    ParallelFor(chunks.size(), 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        { ParseChunk(chunks[i], attributes); }
+    }, maxThreadCount);
+
+    for(auto& chunk : chunks)
+    {
+        if (chunk.pError != nullptr)
+        {
+            auto line = size_t(std::count(pText, chunk.pError, '\n')) + 1;
+            ELOGA("Error : Invalid Line. line = %zu", line);
+            return false;
+        }
+
+        if (!chunk.Colors.empty() && attributes.Colors.empty())
+        { attributes.Colors.resize(attributes.Positions.size(), Vector4(1.0f, 1.0f, 1.0f, 1.0f)); }
+    }
+
+    if (!attributes.Colors.empty())
+    {
+        for(auto& chunk : chunks)
+        {
+            if (!chunk.Colors.empty())
+            { std::copy(chunk.Colors.begin(), chunk.Colors.end(), attributes.Colors.begin() + chunk.PositionBase); }
+        }
+    }
+
+    // グループとマテリアルの組ごとに, 出現順で角の範囲をまとめる.
+    std::vector<ObjMeshSource> sources;
+    std::unordered_map<std::string, size_t> sourceMap;
+    std::string group;
+    std::string material;
+
+    auto addRange = [&](const ObjChunk& chunk, size_t begin, size_t end)
+    {
+        if (begin >= end)
+        { return; }
+
+        auto key = group + '\n' + material;
+        auto itr = sourceMap.find(key);
+        if (itr == sourceMap.end())
+        {
+            itr = sourceMap.insert(std::make_pair(key, sources.size())).first;
+            sources.emplace_back();
+            sources.back().Group    = group;
+            sources.back().Material = material;
+        }
+
+        auto& source = sources[itr->second];
+        source.Ranges.push_back(std::make_pair(chunk.Corners.data() + begin, end - begin));
+        source.CornerCount += end - begin;
+    };
+
+    for(auto& chunk : chunks)
+    {
+        size_t cursor = 0;
+        for(auto& run : chunk.Runs)
+        {
+            addRange(chunk, cursor, run.FirstCorner);
+            cursor = run.FirstCorner;
+
+            if (run.IsMaterial)
+            { material = run.Name; }
+            else
+            { group = run.Name; }
+        }
+        addRange(chunk, cursor, chunk.Corners.size());
+    }
+
+    // メッシュごとに出力先が異なるので, 並列に構築できる.
+    result.Meshes.resize(sources.size());
+    ParallelFor(sources.size(), 1, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        { BuildMesh(sources[i], attributes, result.Meshes[i]); }
+    }, maxThreadCount);
+
+    // マテリアルライブラリを読み込む.
+    if (baseDirectory != nullptr)
+    {
+        std::vector<std::string> libs;
+        for(auto& chunk : chunks)
+        {
+            for(auto& lib : chunk.MaterialLibs)
+            {
+                if (std::find(libs.begin(), libs.end(), lib) == libs.end())
+                { libs.push_back(lib); }
+            }
+        }
+
+        for(auto& lib : libs)
+        {
+            auto path = std::string(baseDirectory) + "/" + lib;
+
+            MappedFile file;
+            if (!file.Open(path.c_str()))
+            {
+                WLOGA("Warning : Material Library Not Found. path = %s", path.c_str());
+                continue;
+            }
+
+            LoadMtl(file.GetData(), file.GetSize(), result.Materials);
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      メモリ上の MTL データを読み込みます.
+//-----------------------------------------------------------------------------
+void LoadMtl(const void* pBuffer, size_t size, std::vector<ResMaterial>& result)
+{
+    if (pBuffer == nullptr)
+    { return; }
+
+    auto pText = static_cast<const char*>(pBuffer);
+    auto pEnd  = pText + size;
+
+    ResMaterial* pMaterial = nullptr;
+    auto hasRoughness = false;
+
+    // オプション付きのテクスチャ指定は最後の項目をファイル名とする.
+    auto getMapName = [](const char* args, const char* end)
+    {
+        auto name = GetRestOfLine(args, end);
+        auto pos  = name.find_last_of(" \t");
+        return (pos == std::string::npos) ? name : name.substr(pos + 1);
+    };
+
+    auto readColor = [](const char* args, const char* end, float* pColor)
+    {
+        pColor[0] = pColor[1] = pColor[2] = 0.0f;
+        for(auto i=0; i<3 && args != nullptr; ++i)
+        {
+            args = SkipSpace(args, end);
+            args = ParseFloat(args, end, pColor[i]);
+
+            // 1成分のみの場合はグレースケール.
+            if (i == 0 && args != nullptr && SkipSpace(args, end) == end)
+            {
+                pColor[1] = pColor[2] = pColor[0];
+                break;
+            }
+        }
+    };
+
+    for(auto p = pText; p < pEnd; )
+    {
+        auto lineEnd = FindLineEnd(p, pEnd);
+        const char* args = nullptr;
+
+        p = SkipSpace(p, lineEnd);
+        if (MatchKeyword(p, lineEnd, "newmtl", args))
+        {
+            ResMaterial material;
+            material.MaterialName       = GetRestOfLine(args, lineEnd);
+            material.BaseColorIntensity = 1.0f;
+            material.OcclusionIntensity = 1.0f;
+            material.RoughnessIntensity = 1.0f;
+            material.EmissiveIntensity  = 0.0f;
+
+            result.push_back(material);
+            pMaterial    = &result.back();
+            hasRoughness = false;
+        }
+        else if (pMaterial == nullptr)
+        {
+            // newmtl より前の行は無視する.
+        }
+        else if (MatchKeyword(p, lineEnd, "Kd", args))
+        {
+            float color[3];
+            readColor(args, lineEnd, color);
+            pMaterial->BaseColorIntensity = (color[0] + color[1] + color[2]) / 3.0f;
+        }
+        else if (MatchKeyword(p, lineEnd, "Ke", args))
+        {
+            float color[3];
+            readColor(args, lineEnd, color);
+            pMaterial->EmissiveIntensity = Max(color[0], Max(color[1], color[2]));
+        }
+        else if (MatchKeyword(p, lineEnd, "Pr", args))
+        {
+            float roughness;
+            if (ParseFloat(args, lineEnd, roughness) != nullptr)
+            {
+                pMaterial->RoughnessIntensity = Saturate(roughness);
+                hasRoughness = true;
+            }
+        }
+        else if (MatchKeyword(p, lineEnd, "Ns", args))
+        {
+            // Blinn-Phong の指数から粗さに変換する.
+            float shininess;
+            if (!hasRoughness && ParseFloat(args, lineEnd, shininess) != nullptr)
+            { pMaterial->RoughnessIntensity = Saturate(sqrtf(2.0f / (Max(shininess, 0.0f) + 2.0f))); }
+        }
+        else if (MatchKeyword(p, lineEnd, "map_Kd", args))
+        {
+            pMaterial->BaseColorMap = getMapName(args, lineEnd);
+        }
+        else if (MatchKeyword(p, lineEnd, "map_Ke", args))
+        {
+            pMaterial->EmissiveMap = getMapName(args, lineEnd);
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+} // namespace asdx
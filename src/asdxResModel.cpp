@@ -9,6 +9,9 @@
 //-----------------------------------------------------------------------------
 #include <asdxResModel.h>
 #include <asdxLogger.h>
+#include <asdxParallel.h>
+#include <algorithm>
+#include <cstring>
 
 
 namespace {
@@ -64,6 +67,207 @@ union Unorm8888
 inline float Max3(const asdx::Vector3& value)
 { return asdx::Max(value.x, asdx::Max(value.y, value.z)); }
 
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   FORSYTH_CACHE_SIZE          = 32;   // Forsyth 法でシミュレートするキャッシュサイズ.
+static constexpr uint32_t   FORSYTH_MAX_VALENCE         = 32;   // スコアテーブルで扱う最大価数.
+static constexpr uint32_t   INVALID_INDEX               = UINT32_MAX;
+static constexpr size_t     MIN_BATCH_VERTEX_COUNT      = 16384;    // 1スレッドあたりの最小頂点数.
+static constexpr size_t     MIN_BATCH_TRIANGLE_COUNT    = 16384;    // 1スレッドあたりの最小三角形数.
+
+///////////////////////////////////////////////////////////////////////////////
+// VertexAdjacency structure
+///////////////////////////////////////////////////////////////////////////////
+struct VertexAdjacency
+{
+    std::vector<uint32_t>   Offsets;    // 頂点ごとの先頭位置 (頂点数 + 1 個).
+    std::vector<uint32_t>   Triangles;  // 頂点が参照される三角形番号(頂点ごとに昇順).
+
+    //-------------------------------------------------------------------------
+    //      頂点から三角形への逆引きを構築します.
+    //      範囲外の頂点番号を含む三角形は登録しません.
+    //-------------------------------------------------------------------------
+    void Build(const std::vector<uint32_t>& indices, size_t triangleCount, size_t vertexCount)
+    {
+        // 頂点ごとの参照数を数える.
+        Offsets.assign(vertexCount + 1, 0);
+        for(size_t i=0; i<triangleCount; ++i)
+        {
+            const auto* v = &indices[i * 3];
+            if (!IsValid(v, vertexCount))
+            { continue; }
+
+            Offsets[v[0] + 1]++;
+            Offsets[v[1] + 1]++;
+            Offsets[v[2] + 1]++;
+        }
+
+        // 累積和で先頭位置を求める.
+        for(size_t i=0; i<vertexCount; ++i)
+        { Offsets[i + 1] += Offsets[i]; }
+
+        // 三角形番号の昇順に詰める.
+        std::vector<uint32_t> cursor(Offsets.begin(), Offsets.end() - 1);
+        Triangles.resize(Offsets[vertexCount]);
+        for(size_t i=0; i<triangleCount; ++i)
+        {
+            const auto* v = &indices[i * 3];
+            if (!IsValid(v, vertexCount))
+            { continue; }
+
+            Triangles[cursor[v[0]]++] = uint32_t(i);
+            Triangles[cursor[v[1]]++] = uint32_t(i);
+            Triangles[cursor[v[2]]++] = uint32_t(i);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //      三角形の頂点番号が全て範囲内かどうか判定します.
+    //-------------------------------------------------------------------------
+    static bool IsValid(const uint32_t* v, size_t vertexCount)
+    { return v[0] < vertexCount && v[1] < vertexCount && v[2] < vertexCount; }
+};
+
+//-----------------------------------------------------------------------------
+//      面ごとの値を三角形番号順に頂点へ加算します.
+//-----------------------------------------------------------------------------
+void AccumulateFaces
+(
+    const std::vector<uint32_t>&        indices,
+    const std::vector<asdx::Vector3>&   faceValues,
+    std::vector<asdx::Vector3>&         sums,
+    std::vector<uint32_t>&              lastFaces,
+    uint32_t                            maxThreadCount
+)
+{
+    auto vertexCount   = sums.size();
+    auto triangleCount = faceValues.size();
+
+    // 1バッチで済む場合は三角形順に直接加算する.
+    if (vertexCount <= MIN_BATCH_VERTEX_COUNT || asdx::GetWorkerThreadCount(maxThreadCount) <= 1)
+    {
+        for(size_t i=0; i<triangleCount; ++i)
+        {
+            const auto* v = &indices[i * 3];
+            if (!VertexAdjacency::IsValid(v, vertexCount))
+            { continue; }
+
+            for(auto j=0; j<3; ++j)
+            {
+                sums     [v[j]] += faceValues[i];
+                lastFaces[v[j]] = uint32_t(i);
+            }
+        }
+        return;
+    }
+
+    // 各頂点は参照する三角形を番号順に加算する.
+    // 加算順序は上と同じなので, 結果はスレッド数に依存しない.
+    VertexAdjacency adjacency;
+    adjacency.Build(indices, triangleCount, vertexCount);
+
+    asdx::ParallelFor(vertexCount, MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            auto first = adjacency.Offsets[i];
+            auto last  = adjacency.Offsets[i + 1];
+            if (first == last)
+            { continue; }
+
+            for(auto j=first; j<last; ++j)
+            { sums[i] += faceValues[adjacency.Triangles[j]]; }
+
+            lastFaces[i] = adjacency.Triangles[last - 1];
+        }
+    }, maxThreadCount);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ForsythScoreTable structure
+///////////////////////////////////////////////////////////////////////////////
+struct ForsythScoreTable
+{
+    float   Cache  [FORSYTH_CACHE_SIZE + 1];    // キャッシュ位置によるスコア(末尾はキャッシュ外).
+    float   Valence[FORSYTH_MAX_VALENCE + 1];   // 残り三角形数によるスコア.
+
+    //-------------------------------------------------------------------------
+    //      コンストラクタです.
+    //-------------------------------------------------------------------------
+    ForsythScoreTable()
+    {
+        const auto CacheDecayPower   = 1.5f;
+        const auto LastTriangleScore = 0.75f;
+        const auto ValenceBoostScale = 2.0f;
+        const auto ValenceBoostPower = 0.5f;
+
+        for(uint32_t i=0; i<FORSYTH_CACHE_SIZE; ++i)
+        {
+            if (i < 3)
+            {
+                // 直前の三角形で使われた頂点は, 同じ三角形を連続させないよう固定値.
+                Cache[i] = LastTriangleScore;
+            }
+            else
+            {
+                auto scaler = 1.0f / float(FORSYTH_CACHE_SIZE - 3);
+                Cache[i] = powf(1.0f - float(i - 3) * scaler, CacheDecayPower);
+            }
+        }
+        Cache[FORSYTH_CACHE_SIZE] = 0.0f;
+
+        Valence[0] = 0.0f;
+        for(uint32_t i=1; i<=FORSYTH_MAX_VALENCE; ++i)
+        { Valence[i] = ValenceBoostScale * powf(float(i), -ValenceBoostPower); }
+    }
+
+    //-------------------------------------------------------------------------
+    //      頂点スコアを求めます.
+    //-------------------------------------------------------------------------
+    float GetScore(uint32_t cachePos, uint32_t valence) const
+    {
+        if (valence == 0)
+        { return -1.0f; }
+
+        return Cache[asdx::Min(cachePos, FORSYTH_CACHE_SIZE)]
+             + Valence[asdx::Min(valence, FORSYTH_MAX_VALENCE)];
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      頂点番号が全て範囲内かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool CheckIndices(const uint32_t* pIndices, size_t indexCount, size_t vertexCount)
+{
+    for(size_t i=0; i<indexCount; ++i)
+    {
+        if (pIndices[i] >= vertexCount)
+        {
+            ELOGA("Error : Index Out Of Range. index = %u, vertexCount = %zu", pIndices[i], vertexCount);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      頂点ストリームを並び替えます.
+//-----------------------------------------------------------------------------
+template<typename T>
+void RemapStream(std::vector<T>& stream, const std::vector<uint32_t>& remap)
+{
+    if (stream.size() != remap.size())
+    { return; }
+
+    std::vector<T> temp(stream.size());
+    for(size_t i=0; i<remap.size(); ++i)
+    { temp[remap[i]] = stream[i]; }
+
+    stream.swap(temp);
+}
+
 } // namespace
 
 
@@ -126,8 +330,8 @@ void Dispose(ResModel& resource)
 Vector2 OctWrap(const Vector2& value)
 {
     Vector2 result;
-    result.x = (1.0f - abs(value.y)) * (value.x >= 0.0f ? 1.0f : -1.0f);
-    result.y = (1.0f - abs(value.x)) * (value.y >= 0.0f ? 1.0f : -1.0f);
+    result.x = (1.0f - fabsf(value.y)) * (value.x >= 0.0f ? 1.0f : -1.0f);
+    result.y = (1.0f - fabsf(value.x)) * (value.y >= 0.0f ? 1.0f : -1.0f);
     return result;
 }
 
@@ -136,7 +340,7 @@ Vector2 OctWrap(const Vector2& value)
 //-----------------------------------------------------------------------------
 Vector2 PackNormal(const Vector3& value)
 {
-    auto n = value / (abs(value.x) + abs(value.y) + abs(value.z));
+    auto n = value / (fabsf(value.x) + fabsf(value.y) + fabsf(value.z));
     Vector2 result(n.x, n.y);
     result = (n.z >= 0.0f) ? result : OctWrap(result);
     result = result * 0.5f + Vector2(0.5f, 0.5f);
@@ -149,7 +353,7 @@ Vector2 PackNormal(const Vector3& value)
 Vector3 UnpackNormal(const Vector2& value)
 {
     auto encoded = value * 2.0f - Vector2(1.0f, 1.0f);
-    auto n = Vector3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    auto n = Vector3(encoded.x, encoded.y, 1.0f - fabsf(encoded.x) - fabsf(encoded.y));
     auto t = Saturate(-n.z);
     n.x += (n.x >= 0.0f) ? -t : t;
     n.y += (n.y >= 0.0f) ? -t : t;
@@ -235,183 +439,604 @@ void DecodeTBN(uint32_t encoded, Vector3& tangent, Vector3& bitangent, Vector3&
 //-----------------------------------------------------------------------------
 //      法線ベクトルを計算します.
 //-----------------------------------------------------------------------------
-void CalcNormals(ResMesh& resource)
+void CalcNormals(ResMesh& resource, uint32_t maxThreadCount)
 {
-    auto vertexCount = resource.Positions.size();
-    std::vector<asdx::Vector3> normals;
-    normals.resize(vertexCount);
+    auto vertexCount   = resource.Positions.size();
+    auto triangleCount = resource.Indices.size() / 3;
+    if (vertexCount == 0 || triangleCount == 0)
+    { return; }
 
-    // 法線データ初期化.
-    for(size_t i=0; i<vertexCount; ++i)
-    {
-        normals[i] = asdx::Vector3(0.0f, 0.0f, 0.0f);
-    }
-
-    auto indexCount = resource.Indices.size();
-    for(size_t i=0; i<indexCount - 3; i+=3)
-    {
-        auto i0 = resource.Indices[i + 0];
-        auto i1 = resource.Indices[i + 1];
-        auto i2 = resource.Indices[i + 2];
-
-        const auto& p0 = resource.Positions[i0];
-        const auto& p1 = resource.Positions[i1];
-        const auto& p2 = resource.Positions[i2];
-
-        // エッジ.
-        auto e0 = p1 - p0;
-        auto e1 = p2 - p0;
-
-        // 面法線を算出.
-        auto fn = asdx::Vector3::Cross(e0, e1);
-        fn = asdx::Vector3::SafeNormalize(fn, fn);
-
-        // 面法線を加算.
-        normals[i0] += fn;
-        normals[i1] += fn;
-        normals[i2] += fn;
-    }
+    const auto SMOOTHING_ANGLE = 59.7f;
+    auto cosSmooth = cosf(asdx::ToRadian(SMOOTHING_ANGLE));
 
-    // 加算した法線を正規化し，頂点法線を求める.
-    for(size_t i=0; i<vertexCount; ++i)
+    // 面法線を算出.
+    std::vector<asdx::Vector3> faceNormals(triangleCount);
+    ParallelFor(triangleCount, MIN_BATCH_TRIANGLE_COUNT, [&](uint32_t, size_t begin, size_t end)
     {
-        normals[i] = asdx::Vector3::SafeNormalize(normals[i], normals[i]);
-    }
-
-    const auto SMOOTHING_ANGLE = 59.7f;
-    auto cosSmooth = cosf(asdx::ToDegree(SMOOTHING_ANGLE));
+        for(auto i=begin; i<end; ++i)
+        {
+            const auto* v = &resource.Indices[i * 3];
+            if (!VertexAdjacency::IsValid(v, vertexCount))
+            { continue; }
+
+            const auto& p0 = resource.Positions[v[0]];
+            const auto& p1 = resource.Positions[v[1]];
+            const auto& p2 = resource.Positions[v[2]];
+
+            // エッジ.
+            auto e0 = p1 - p0;
+            auto e1 = p2 - p0;
+
+            auto fn = asdx::Vector3::Cross(e0, e1);
+            faceNormals[i] = asdx::Vector3::SafeNormalize(fn, fn);
+        }
+    }, maxThreadCount);
+
+    // 面法線を三角形番号順に加算する. スムージング用に最後に参照した面も覚えておく.
+    std::vector<asdx::Vector3> normals  (vertexCount, asdx::Vector3(0.0f, 0.0f, 0.0f));
+    std::vector<uint32_t>      lastFaces(vertexCount, INVALID_INDEX);
+    AccumulateFaces(resource.Indices, faceNormals, normals, lastFaces, maxThreadCount);
 
     // メモリ確保.
     resource.Normals.resize(vertexCount);
 
-    // スムージング処理.
-    for(size_t i=0; i<indexCount - 3; i+=3)
+    ParallelFor(vertexCount, MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
     {
-        auto i0 = resource.Indices[i + 0];
-        auto i1 = resource.Indices[i + 1];
-        auto i2 = resource.Indices[i + 2];
-
-        const auto& p0 = resource.Positions[i0];
-        const auto& p1 = resource.Positions[i1];
-        const auto& p2 = resource.Positions[i2];
-
-        // エッジ.
-        auto e0 = p1 - p0;
-        auto e1 = p2 - p0;
-
-        // 面法線を算出.
-        auto fn = asdx::Vector3::Cross(e0, e1);
-        fn = asdx::Vector3::SafeNormalize(fn, fn);
-
-        // 頂点法線と面法線のなす角度を算出.
-        auto c0 = asdx::Vector3::Dot(normals[i0], fn);
-        auto c1 = asdx::Vector3::Dot(normals[i1], fn);
-        auto c2 = asdx::Vector3::Dot(normals[i2], fn);
-
-        // スムージング処理.
-        resource.Normals[i0] = (c0 >= cosSmooth) ? normals[i0] : fn;
-        resource.Normals[i1] = (c1 >= cosSmooth) ? normals[i1] : fn;
-        resource.Normals[i2] = (c2 >= cosSmooth) ? normals[i2] : fn;
-    }
-
-    normals.clear();
+        for(auto i=begin; i<end; ++i)
+        {
+            if (lastFaces[i] == INVALID_INDEX)
+            { continue; }
+
+            // 加算した法線を正規化し，頂点法線を求める.
+            auto normal = asdx::Vector3::SafeNormalize(normals[i], normals[i]);
+
+            // 頂点法線と面法線のなす角度でスムージング処理.
+            const auto& lastNormal = faceNormals[lastFaces[i]];
+            auto c = asdx::Vector3::Dot(normal, lastNormal);
+            resource.Normals[i] = (c >= cosSmooth) ? normal : lastNormal;
+        }
+    }, maxThreadCount);
 }
 
 //-----------------------------------------------------------------------------
 //      法線ベクトルを計算します.
 //-----------------------------------------------------------------------------
-void CalcNormals(ResModel& resource)
+void CalcNormals(ResModel& resource, uint32_t maxThreadCount)
 {
     for(auto& mesh : resource.Meshes)
-    { CalcNormals(mesh); }
+    { CalcNormals(mesh, maxThreadCount); }
 }
 
 //-----------------------------------------------------------------------------
 //      接線ベクトルを計算します.
 //-----------------------------------------------------------------------------
-void CalcTangentsRoughly(ResMesh& mesh)
+void CalcTangentsRoughly(ResMesh& mesh, uint32_t maxThreadCount)
 {
     auto vertexCount = mesh.Positions.size();
     mesh.Tangents.resize(vertexCount);
-    for(size_t i=0; i<vertexCount; ++i)
+    ParallelFor(vertexCount, MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
     {
-        asdx::Vector3 T, B;
-        asdx::CalcONB(mesh.Normals[i], T, B);
-        mesh.Tangents[i] = T;
-    }
+        for(auto i=begin; i<end; ++i)
+        {
+            asdx::Vector3 T, B;
+            asdx::CalcONB(mesh.Normals[i], T, B);
+            mesh.Tangents[i] = T;
+        }
+    }, maxThreadCount);
 }
 //-----------------------------------------------------------------------------
 //      接線ベクトルを計算します.
 //-----------------------------------------------------------------------------
-void CalcTangents(ResMesh& resource)
+void CalcTangents(ResMesh& resource, uint32_t maxThreadCount)
 {
     // テクスチャ座標が無い場合は接線ベクトルをきちんと計算できないので，
     // 雑に計算する.
     if (resource.TexCoords[0].empty())
     {
-        CalcTangentsRoughly(resource);
+        CalcTangentsRoughly(resource, maxThreadCount);
         return;
     }
 
-    auto vertexCount = resource.Positions.size();
+    auto vertexCount   = resource.Positions.size();
+    auto triangleCount = resource.Indices.size() / 3;
     resource.Tangents.resize(vertexCount);
 
-    // 接線ベクトルを初期化.
+    // 面ごとの接線ベクトルを算出.
+    std::vector<asdx::Vector3> faceTangents(triangleCount);
+    ParallelFor(triangleCount, MIN_BATCH_TRIANGLE_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            const auto* v = &resource.Indices[i * 3];
+            if (!VertexAdjacency::IsValid(v, vertexCount))
+            { continue; }
+
+            auto p0 = resource.Positions[v[0]];
+            auto p1 = resource.Positions[v[1]];
+            auto p2 = resource.Positions[v[2]];
+
+            auto t0 = resource.TexCoords[0][v[0]];
+            auto t1 = resource.TexCoords[0][v[1]];
+            auto t2 = resource.TexCoords[0][v[2]];
+
+            auto e1 = p1 - p0;
+            auto e2 = p2 - p0;
+
+            float x1 = t1.x - t0.x;
+            float x2 = t2.x - t0.x;
+
+            float y1 = t1.y - t0.y;
+            float y2 = t2.y - t0.y;
+
+            float r = 1.0f / (x1 * y2 - x2 * y1);
+
+            faceTangents[i] = (e1 * y2 - e2 * y1) * r;
+        }
+    }, maxThreadCount);
+
+    // 法線と同様に, 接線ベクトルを三角形番号順に加算する.
+    std::vector<asdx::Vector3> tangents (vertexCount, asdx::Vector3(0.0f, 0.0f, 0.0f));
+    std::vector<uint32_t>      lastFaces(vertexCount, INVALID_INDEX);
+    AccumulateFaces(resource.Indices, faceTangents, tangents, lastFaces, maxThreadCount);
+
+    ParallelFor(vertexCount, MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            // Reject = a - b * Dot(a, b);
+            auto a = tangents[i];
+            auto b = resource.Normals[i];
+            auto T = a - b * asdx::Vector3::Dot(a, b);
+            resource.Tangents[i] = asdx::Vector3::SafeNormalize(T, T);
+        }
+    }, maxThreadCount);
+}
+
+//-----------------------------------------------------------------------------
+//      接線ベクトルを計算します.
+//-----------------------------------------------------------------------------
+void CalcTangents(ResModel& resource, uint32_t maxThreadCount)
+{
+    for(auto& mesh : resource.Meshes)
+    { CalcTangents(mesh, maxThreadCount); }
+}
+
+//-----------------------------------------------------------------------------
+//      頂点キャッシュの効率を解析します.
+//-----------------------------------------------------------------------------
+VertexCacheStats AnalyzeVertexCache
+(
+    const uint32_t* pIndices,
+    size_t          indexCount,
+    size_t          vertexCount,
+    uint32_t        cacheSize
+)
+{
+    VertexCacheStats result = {};
+    if (pIndices == nullptr || indexCount < 3 || vertexCount == 0 || cacheSize == 0)
+    { return result; }
+
+    if (!CheckIndices(pIndices, indexCount, vertexCount))
+    { return result; }
+
+    // FIFO キャッシュをタイムスタンプで表現する.
+    // 最後に読み込まれてから cacheSize 回以上の読み込みがあれば追い出されている.
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    std::vector<uint8_t>  referenced(vertexCount, 0);
+    uint32_t timestamp = cacheSize + 1;
+    uint32_t misses    = 0;
+    uint32_t unique    = 0;
+
+    for(size_t i=0; i<indexCount; ++i)
+    {
+        auto v = pIndices[i];
+        if (timestamp - timestamps[v] > cacheSize)
+        {
+            timestamps[v] = timestamp++;
+            misses++;
+        }
+
+        if (referenced[v] == 0)
+        {
+            referenced[v] = 1;
+            unique++;
+        }
+    }
+
+    result.ACMR = float(misses) / float(indexCount / 3);
+    result.ATVR = float(misses) / float(unique);
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      頂点キャッシュの効率を解析します.
+//-----------------------------------------------------------------------------
+VertexCacheStats AnalyzeVertexCache(const ResMesh& resource, uint32_t cacheSize)
+{
+    return AnalyzeVertexCache(
+        resource.Indices.data(),
+        resource.Indices.size(),
+        resource.Positions.size(),
+        cacheSize);
+}
+
+//-----------------------------------------------------------------------------
+//      頂点キャッシュの効率が良くなるように三角形を並び替えます.
+//-----------------------------------------------------------------------------
+void OptimizeVertexCache(ResMesh& resource)
+{
+    auto vertexCount   = resource.Positions.size();
+    auto indexCount    = resource.Indices.size() - resource.Indices.size() % 3;
+    auto triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+    { return; }
+
+    const auto* pIndices = resource.Indices.data();
+    if (!CheckIndices(pIndices, indexCount, vertexCount))
+    { return; }
+
+    static const ForsythScoreTable table;
+
+    VertexAdjacency adjacency;
+    adjacency.Build(resource.Indices, triangleCount, vertexCount);
+
+    // 残り三角形数は隣接リストの有効部分の長さとして管理する.
+    std::vector<uint32_t> liveCounts(vertexCount);
+    std::vector<uint32_t> cachePos(vertexCount, FORSYTH_CACHE_SIZE);
+    std::vector<float>    vertexScores(vertexCount);
     for(size_t i=0; i<vertexCount; ++i)
     {
-        resource.Tangents[i] = asdx::Vector3(0.0f, 0.0f, 0.0f);
+        liveCounts  [i] = adjacency.Offsets[i + 1] - adjacency.Offsets[i];
+        vertexScores[i] = table.GetScore(FORSYTH_CACHE_SIZE, liveCounts[i]);
     }
 
-    auto indexCount = resource.Indices.size();
-    for(size_t i=0; i<indexCount - 3; i+=3)
+    std::vector<float>   triangleScores(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    for(size_t i=0; i<triangleCount; ++i)
     {
-        auto i0 = resource.Indices[i + 0];
-        auto i1 = resource.Indices[i + 1];
-        auto i2 = resource.Indices[i + 2];
+        triangleScores[i] = vertexScores[pIndices[i * 3 + 0]]
+                          + vertexScores[pIndices[i * 3 + 1]]
+                          + vertexScores[pIndices[i * 3 + 2]];
+    }
 
-        auto p0 = resource.Positions[i0];
-        auto p1 = resource.Positions[i1];
-        auto p2 = resource.Positions[i2];
+    // LRU キャッシュ. 三角形を追加した直後は最大 3 つはみ出す.
+    uint32_t cache    [FORSYTH_CACHE_SIZE + 3];
+    uint32_t cacheNext[FORSYTH_CACHE_SIZE + 3];
+    uint32_t cacheCount = 0;
 
-        auto t0 = resource.TexCoords[0][i0];
-        auto t1 = resource.TexCoords[0][i1];
-        auto t2 = resource.TexCoords[0][i2];
+    std::vector<uint32_t> result(indexCount);
+    size_t   inputCursor = 0;
+    uint32_t current     = 0;
 
-        auto e1 = p1 - p0;
-        auto e2 = p2 - p0;
+    // 最もスコアの高い三角形から始める.
+    for(uint32_t i=1; i<triangleCount; ++i)
+    {
+        if (triangleScores[i] > triangleScores[current])
+        { current = i; }
+    }
 
-        float x1 = t1.x - t0.x;
-        float x2 = t2.x - t0.x;
+    for(size_t outputTriangle=0; outputTriangle<triangleCount; ++outputTriangle)
+    {
+        const auto* tri = pIndices + current * 3;
+        result[outputTriangle * 3 + 0] = tri[0];
+        result[outputTriangle * 3 + 1] = tri[1];
+        result[outputTriangle * 3 + 2] = tri[2];
+        emitted[current] = 1;
+
+        // 出力した頂点を先頭に置き, 残りを後ろに詰める.
+        uint32_t nextCount = 0;
+        cacheNext[nextCount++] = tri[0];
+        cacheNext[nextCount++] = tri[1];
+        cacheNext[nextCount++] = tri[2];
+        for(uint32_t i=0; i<cacheCount; ++i)
+        {
+            auto v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+            { cacheNext[nextCount++] = v; }
+        }
+
+        // 出力した三角形を隣接リストから取り除く.
+        for(auto k=0; k<3; ++k)
+        {
+            auto  v     = tri[k];
+            auto* pList = adjacency.Triangles.data() + adjacency.Offsets[v];
+            auto  count = liveCounts[v];
+            for(uint32_t i=0; i<count; ++i)
+            {
+                if (pList[i] == current)
+                {
+                    pList[i] = pList[count - 1];
+                    break;
+                }
+            }
+            liveCounts[v]--;
+        }
+
+        // キャッシュ内の頂点スコアを更新し, 次の候補を探す.
+        auto  best      = INVALID_INDEX;
+        float bestScore = -1.0f;
+        for(uint32_t i=0; i<nextCount; ++i)
+        {
+            auto v   = cacheNext[i];
+            auto pos = (i < FORSYTH_CACHE_SIZE) ? i : FORSYTH_CACHE_SIZE;
+            cachePos[v] = pos;
+
+            auto score = table.GetScore(pos, liveCounts[v]);
+            auto delta = score - vertexScores[v];
+            vertexScores[v] = score;
+
+            const auto* pList = adjacency.Triangles.data() + adjacency.Offsets[v];
+            for(uint32_t j=0; j<liveCounts[v]; ++j)
+            {
+                auto t = pList[j];
+                triangleScores[t] += delta;
+                if (triangleScores[t] > bestScore)
+                {
+                    best      = t;
+                    bestScore = triangleScores[t];
+                }
+            }
+        }
+
+        cacheCount = asdx::Min(nextCount, FORSYTH_CACHE_SIZE);
+        memcpy(cache, cacheNext, sizeof(uint32_t) * cacheCount);
+
+        // キャッシュ内に候補が無ければ入力順で未出力の三角形を選ぶ.
+        if (best == INVALID_INDEX)
+        {
+            while (inputCursor < triangleCount && emitted[inputCursor] != 0)
+            { inputCursor++; }
+
+            if (inputCursor == triangleCount)
+            { break; }
+
+            best = uint32_t(inputCursor);
+        }
+
+        current = best;
+    }
 
-        float y1 = t1.y - t0.y;
-        float y2 = t2.y - t0.y;
+    memcpy(resource.Indices.data(), result.data(), sizeof(uint32_t) * indexCount);
+}
 
-        float r = 1.0f / (x1 * y2 - x2 * y1);
+//-----------------------------------------------------------------------------
+//      頂点キャッシュの効率が良くなるように三角形を並び替えます.
+//-----------------------------------------------------------------------------
+void OptimizeVertexCache(ResModel& resource)
+{
+    for(auto& mesh : resource.Meshes)
+    { OptimizeVertexCache(mesh); }
+}
+
+//-----------------------------------------------------------------------------
+//      オーバードローが少なくなるように三角形を並び替えます.
+//-----------------------------------------------------------------------------
+void OptimizeOverdraw(ResMesh& resource, float threshold)
+{
+    auto vertexCount   = resource.Positions.size();
+    auto indexCount    = resource.Indices.size() - resource.Indices.size() % 3;
+    auto triangleCount = indexCount / 3;
+    if (triangleCount < 2)
+    { return; }
+
+    const auto* pIndices = resource.Indices.data();
+    if (!CheckIndices(pIndices, indexCount, vertexCount))
+    { return; }
+
+    // 頂点キャッシュをシミュレートして, 3頂点ともミスした三角形で区切る.
+    std::vector<uint32_t> clusters;
+    {
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t timestamp = FORSYTH_CACHE_SIZE + 1;
+
+        auto simulate = [&](uint32_t triangle)
+        {
+            uint32_t miss = 0;
+            for(auto k=0; k<3; ++k)
+            {
+                auto v = pIndices[triangle * 3 + k];
+                if (timestamp - timestamps[v] > FORSYTH_CACHE_SIZE)
+                {
+                    timestamps[v] = timestamp++;
+                    miss++;
+                }
+            }
+            return miss;
+        };
+
+        // タイムスタンプを進めてキャッシュを空にする.
+        auto flush = [&]()
+        { timestamp += FORSYTH_CACHE_SIZE + 1; };
+
+        std::vector<uint32_t> hard;
+        for(uint32_t i=0; i<triangleCount; ++i)
+        {
+            auto miss = simulate(i);
+            if (i == 0 || miss == 3)
+            { hard.push_back(i); }
+        }
+        hard.push_back(uint32_t(triangleCount));
+
+        // クラスタ単体で描画した時の ACMR * threshold に達した位置で更に区切る.
+        for(size_t c=0; c + 1<hard.size(); ++c)
+        {
+            auto start = hard[c];
+            auto end   = hard[c + 1];
+
+            flush();
+            uint32_t total = 0;
+            for(auto i=start; i<end; ++i)
+            { total += simulate(i); }
+
+            auto limit = float(total) / float(end - start) * threshold;
+
+            flush();
+            clusters.push_back(start);
+
+            uint32_t sum = 0;
+            for(auto i=start; i<end; ++i)
+            {
+                sum += simulate(i);
+                if (i + 1 < end && float(sum) <= limit * float(i - start + 1))
+                {
+                    flush();
+                    clusters.push_back(i + 1);
+                    start = i + 1;
+                    sum   = 0;
+                }
+            }
+        }
+        clusters.push_back(uint32_t(triangleCount));
+    }
+
+    auto clusterCount = clusters.size() - 1;
+    if (clusterCount < 2)
+    { return; }
 
-        asdx::Vector3 T = (e1 * y2 - e2 * y1) * r;
+    // メッシュ全体の重心.
+    asdx::Vector3 meshCenter(0.0f, 0.0f, 0.0f);
+    float meshArea = 0.0f;
 
-        resource.Tangents[i0] += T;
-        resource.Tangents[i1] += T;
-        resource.Tangents[i2] += T;
+    std::vector<asdx::Vector3> centers(clusterCount);
+    std::vector<asdx::Vector3> normals(clusterCount);
+
+    for(size_t c=0; c<clusterCount; ++c)
+    {
+        asdx::Vector3 center(0.0f, 0.0f, 0.0f);
+        asdx::Vector3 normal(0.0f, 0.0f, 0.0f);
+        float area = 0.0f;
+
+        for(auto i=clusters[c]; i<clusters[c + 1]; ++i)
+        {
+            const auto& p0 = resource.Positions[pIndices[i * 3 + 0]];
+            const auto& p1 = resource.Positions[pIndices[i * 3 + 1]];
+            const auto& p2 = resource.Positions[pIndices[i * 3 + 2]];
+
+            // 面積で重み付けした法線と重心.
+            auto n = asdx::Vector3::Cross(p1 - p0, p2 - p0);
+            auto a = n.Length();
+
+            center += (p0 + p1 + p2) * (a / 3.0f);
+            normal += n;
+            area   += a;
+        }
+
+        meshCenter += center;
+        meshArea   += area;
+
+        centers[c] = (area > 0.0f) ? center / area : resource.Positions[pIndices[clusters[c] * 3]];
+        normals[c] = asdx::Vector3::SafeNormalize(normal, normal);
     }
 
-    for(size_t i=0; i<vertexCount; ++i)
+    if (meshArea > 0.0f)
+    { meshCenter /= meshArea; }
+
+    // 外側を向いているクラスタほど手前に描かれやすいので先に描画する.
+    std::vector<float>    keys (clusterCount);
+    std::vector<uint32_t> order(clusterCount);
+    for(size_t c=0; c<clusterCount; ++c)
+    {
+        keys [c] = asdx::Vector3::Dot(centers[c] - meshCenter, normals[c]);
+        order[c] = uint32_t(c);
+    }
+
+    std::stable_sort(order.begin(), order.end(),
+        [&](uint32_t lhs, uint32_t rhs) { return keys[lhs] > keys[rhs]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indexCount);
+    for(auto c : order)
     {
-        // Reject = a - b * Dot(a, b);
-        auto a = resource.Tangents[i];
-        auto b = resource.Normals[i];
-        auto T = a - b * asdx::Vector3::Dot(a, b);
-        resource.Tangents[i] = asdx::Vector3::SafeNormalize(T, T);
+        result.insert(result.end(),
+            pIndices + clusters[c    ] * 3,
+            pIndices + clusters[c + 1] * 3);
     }
+
+    memcpy(resource.Indices.data(), result.data(), sizeof(uint32_t) * indexCount);
 }
 
 //-----------------------------------------------------------------------------
-//      接線ベクトルを計算します.
+//      オーバードローが少なくなるように三角形を並び替えます.
+//-----------------------------------------------------------------------------
+void OptimizeOverdraw(ResModel& resource, float threshold)
+{
+    for(auto& mesh : resource.Meshes)
+    { OptimizeOverdraw(mesh, threshold); }
+}
+
+//-----------------------------------------------------------------------------
+//      頂点フェッチの効率が良くなるように頂点を並び替えます.
+//-----------------------------------------------------------------------------
+void OptimizeVertexFetch(ResMesh& resource)
+{
+    auto vertexCount = resource.Positions.size();
+    if (vertexCount == 0)
+    { return; }
+
+    if (!CheckIndices(resource.Indices.data(), resource.Indices.size(), vertexCount))
+    { return; }
+
+    // インデックスの参照順に新しい頂点番号を振る.
+    std::vector<uint32_t> remap(vertexCount, INVALID_INDEX);
+    uint32_t next = 0;
+    for(auto& index : resource.Indices)
+    {
+        if (remap[index] == INVALID_INDEX)
+        { remap[index] = next++; }
+        index = remap[index];
+    }
+
+    // 参照されていない頂点は末尾に元の順で残す.
+    for(auto& value : remap)
+    {
+        if (value == INVALID_INDEX)
+        { value = next++; }
+    }
+
+    RemapStream(resource.Positions,   remap);
+    RemapStream(resource.Normals,     remap);
+    RemapStream(resource.Tangents,    remap);
+    RemapStream(resource.Bitangents,  remap);
+    RemapStream(resource.Colors,      remap);
+    for(auto i=0; i<MAX_LAYER_COUNT; ++i)
+    { RemapStream(resource.TexCoords[i], remap); }
+    RemapStream(resource.BoneIndices, remap);
+    RemapStream(resource.BoneWeights, remap);
+}
+
+//-----------------------------------------------------------------------------
+//      頂点フェッチの効率が良くなるように頂点を並び替えます.
+//-----------------------------------------------------------------------------
+void OptimizeVertexFetch(ResModel& resource)
+{
+    for(auto& mesh : resource.Meshes)
+    { OptimizeVertexFetch(mesh); }
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュを最適化します.
+//-----------------------------------------------------------------------------
+void OptimizeMesh(ResMesh& resource, bool overdraw)
+{
+    // 不正なメッシュは各処理でエラーになるので, 先に1度だけチェックする.
+    if (!CheckIndices(resource.Indices.data(), resource.Indices.size(), resource.Positions.size()))
+    { return; }
+
+    OptimizeVertexCache(resource);
+
+    if (overdraw)
+    { OptimizeOverdraw(resource); }
+
+    OptimizeVertexFetch(resource);
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュを最適化します.
 //-----------------------------------------------------------------------------
-void CalcTangents(ResModel& resource)
+void OptimizeMesh(ResModel& resource, bool overdraw)
 {
     for(auto& mesh : resource.Meshes)
-    { CalcTangents(mesh); }
+    { OptimizeMesh(mesh, overdraw); }
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,568 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxResModelFile.cpp
+// Desc : Binary Model File.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <asdxResModelFile.h>
+#include <asdxLogger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+enum STREAM_TYPE
+{
+    STREAM_POSITION = 0,
+    STREAM_NORMAL,
+    STREAM_TANGENT,
+    STREAM_BITANGENT,
+    STREAM_COLOR,
+    STREAM_TEXCOORD0,
+    STREAM_TEXCOORD1,
+    STREAM_TEXCOORD2,
+    STREAM_TEXCOORD3,
+    STREAM_BONE_INDEX,
+    STREAM_BONE_WEIGHT,
+    STREAM_INDEX,
+    STREAM_COUNT,
+};
+
+static const size_t STREAM_STRIDE[STREAM_COUNT] = {
+    sizeof(asdx::Vector3),      // STREAM_POSITION
+    sizeof(asdx::Vector3),      // STREAM_NORMAL
+    sizeof(asdx::Vector3),      // STREAM_TANGENT
+    sizeof(asdx::Vector3),      // STREAM_BITANGENT
+    sizeof(asdx::Vector4),      // STREAM_COLOR
+    sizeof(asdx::Vector2),      // STREAM_TEXCOORD0
+    sizeof(asdx::Vector2),      // STREAM_TEXCOORD1
+    sizeof(asdx::Vector2),      // STREAM_TEXCOORD2
+    sizeof(asdx::Vector2),      // STREAM_TEXCOORD3
+    sizeof(asdx::ResBoneIndex), // STREAM_BONE_INDEX
+    sizeof(asdx::Vector4),      // STREAM_BONE_WEIGHT
+    sizeof(uint32_t),           // STREAM_INDEX
+};
+
+static_assert(MAX_LAYER_COUNT == 4,                 "Invalid Layer Count");
+static_assert(sizeof(asdx::Vector2)      == 8,      "Vector2 Invalid Data Size");
+static_assert(sizeof(asdx::Vector3)      == 12,     "Vector3 Invalid Data Size");
+static_assert(sizeof(asdx::Vector4)      == 16,     "Vector4 Invalid Data Size");
+static_assert(sizeof(asdx::ResBoneIndex) == 8,      "ResBoneIndex Invalid Data Size");
+
+///////////////////////////////////////////////////////////////////////////////
+// FileHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct FileHeader
+{
+    uint32_t    Magic;                  // ファイル識別子.
+    uint32_t    Version;                // ファイルバージョン.
+    uint32_t    MeshCount;              // メッシュ数.
+    uint32_t    MaterialCount;          // マテリアル数.
+    uint64_t    FileSize;               // ファイルサイズ.
+    uint64_t    MeshTableOffset;        // メッシュテーブルの位置.
+    uint64_t    MaterialTableOffset;    // マテリアルテーブルの位置.
+    uint64_t    StringTableOffset;      // 文字列テーブルの位置.
+    uint64_t    StringTableSize;        // 文字列テーブルのサイズ.
+    uint64_t    Reserved;               // 予約領域.
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader Invalid Data Size");
+
+///////////////////////////////////////////////////////////////////////////////
+// FileString structure
+///////////////////////////////////////////////////////////////////////////////
+struct FileString
+{
+    uint32_t    Offset;     // 文字列テーブル内の位置.
+    uint32_t    Length;     // 終端文字を含まない文字数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FileStream structure
+///////////////////////////////////////////////////////////////////////////////
+struct FileStream
+{
+    uint64_t    Offset;     // ファイル先頭からの位置.
+    uint64_t    Count;      // 要素数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FileMesh structure
+///////////////////////////////////////////////////////////////////////////////
+struct FileMesh
+{
+    FileString  MeshName;               // メッシュ名.
+    FileString  MaterialName;           // マテリアル名.
+    FileStream  Streams[STREAM_COUNT];  // 頂点ストリームとインデックス.
+};
+static_assert(sizeof(FileMesh) == 16 + 16 * STREAM_COUNT, "FileMesh Invalid Data Size");
+
+///////////////////////////////////////////////////////////////////////////////
+// FileMaterial structure
+///////////////////////////////////////////////////////////////////////////////
+struct FileMaterial
+{
+    FileString  MaterialName;           // マテリアル名.
+    FileString  BaseColorMap;           // ベースカラーマップ.
+    FileString  OrmMap;                 // ORMマップ.
+    FileString  EmissiveMap;            // エミッシブマップ.
+    float       BaseColorIntensity;     // ベースカラー強度.
+    float       OcclusionIntensity;     // 遮蔽強度.
+    float       RoughnessIntensity;     // ラフネス強度.
+    float       EmissiveIntensity;      // エミッシブ強度.
+};
+static_assert(sizeof(FileMaterial) == 48, "FileMaterial Invalid Data Size");
+
+//-----------------------------------------------------------------------------
+//      アライメントに切り上げます.
+//-----------------------------------------------------------------------------
+inline uint64_t AlignUp(uint64_t value)
+{ return (value + asdx::RES_MODEL_FILE_ALIGNMENT - 1) & ~uint64_t(asdx::RES_MODEL_FILE_ALIGNMENT - 1); }
+
+///////////////////////////////////////////////////////////////////////////////
+// StreamData structure
+///////////////////////////////////////////////////////////////////////////////
+struct StreamData
+{
+    const void* pData;      // 先頭要素.
+    size_t      Count;      // 要素数.
+};
+
+//-----------------------------------------------------------------------------
+//      メッシュのストリームを取得します.
+//-----------------------------------------------------------------------------
+inline StreamData GetStream(const asdx::ResMesh& mesh, uint32_t type)
+{
+    const void* ptr   = nullptr;
+    size_t      count = 0;
+    switch(type)
+    {
+    case STREAM_POSITION:   ptr = mesh.Positions  .data(); count = mesh.Positions  .size(); break;
+    case STREAM_NORMAL:     ptr = mesh.Normals    .data(); count = mesh.Normals    .size(); break;
+    case STREAM_TANGENT:    ptr = mesh.Tangents   .data(); count = mesh.Tangents   .size(); break;
+    case STREAM_BITANGENT:  ptr = mesh.Bitangents .data(); count = mesh.Bitangents .size(); break;
+    case STREAM_COLOR:      ptr = mesh.Colors     .data(); count = mesh.Colors     .size(); break;
+    case STREAM_TEXCOORD0:
+    case STREAM_TEXCOORD1:
+    case STREAM_TEXCOORD2:
+    case STREAM_TEXCOORD3:
+        ptr   = mesh.TexCoords[type - STREAM_TEXCOORD0].data();
+        count = mesh.TexCoords[type - STREAM_TEXCOORD0].size();
+        break;
+    case STREAM_BONE_INDEX:  ptr = mesh.BoneIndices.data(); count = mesh.BoneIndices.size(); break;
+    case STREAM_BONE_WEIGHT: ptr = mesh.BoneWeights.data(); count = mesh.BoneWeights.size(); break;
+    case STREAM_INDEX:       ptr = mesh.Indices    .data(); count = mesh.Indices    .size(); break;
+    }
+    return StreamData{ ptr, count };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// StringTable class
+///////////////////////////////////////////////////////////////////////////////
+class StringTable
+{
+public:
+    //-------------------------------------------------------------------------
+    //      文字列を追加します.
+    //-------------------------------------------------------------------------
+    FileString Add(const std::string& value)
+    {
+        FileString result;
+        result.Offset = uint32_t(m_Buffer.size());
+        result.Length = uint32_t(value.size());
+        m_Buffer.insert(m_Buffer.end(), value.begin(), value.end());
+        m_Buffer.push_back('\0');
+        return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //      バッファを取得します.
+    //-------------------------------------------------------------------------
+    const std::vector<char>& GetBuffer() const
+    { return m_Buffer; }
+
+private:
+    std::vector<char>   m_Buffer;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FileReader class
+///////////////////////////////////////////////////////////////////////////////
+class FileReader
+{
+public:
+    FileReader(const uint8_t* pData, size_t size)
+    : m_pData(pData), m_Size(size)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //      範囲がファイル内に収まるかどうか判定します.
+    //-------------------------------------------------------------------------
+    bool IsValidRange(uint64_t offset, uint64_t count, size_t stride) const
+    {
+        if (offset > m_Size)
+        { return false; }
+        return count <= (m_Size - offset) / stride;
+    }
+
+    //-------------------------------------------------------------------------
+    //      構造体を読み取ります.
+    //-------------------------------------------------------------------------
+    template<typename T>
+    void Read(uint64_t offset, T& result) const
+    { memcpy(&result, m_pData + offset, sizeof(T)); }
+
+    //-------------------------------------------------------------------------
+    //      ストリームのビューを取得します.
+    //-------------------------------------------------------------------------
+    template<typename T>
+    bool GetSpan(const FileStream& stream, asdx::ResSpan<T>& result) const
+    {
+        if (stream.Count == 0)
+        {
+            result = asdx::ResSpan<T>();
+            return true;
+        }
+
+        if (!IsValidRange(stream.Offset, stream.Count, sizeof(T)))
+        { return false; }
+
+        // 要素型のアライメントを満たさない場合は直接参照できない.
+        auto ptr = m_pData + stream.Offset;
+        if (reinterpret_cast<uintptr_t>(ptr) % alignof(T) != 0)
+        { return false; }
+
+        result = asdx::ResSpan<T>(reinterpret_cast<const T*>(ptr), size_t(stream.Count));
+        return true;
+    }
+
+private:
+    const uint8_t*  m_pData;
+    size_t          m_Size;
+};
+
+} // namespace
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// ResModelFile class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      ファイルをメモリにマップして開きます.
+//-----------------------------------------------------------------------------
+bool ResModelFile::Open(const char* filename)
+{
+    Close();
+
+    if (!m_File.Open(filename))
+    { return false; }
+
+    if (!Parse(m_File.GetData(), m_File.GetSize()))
+    {
+        ELOGA("Error : Invalid Model File. path = %s", filename);
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      メモリ上のデータを開きます.
+//-----------------------------------------------------------------------------
+bool ResModelFile::Open(const void* pBuffer, size_t size)
+{
+    Close();
+
+    if (!Parse(pBuffer, size))
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルを閉じます.
+//-----------------------------------------------------------------------------
+void ResModelFile::Close()
+{
+    m_Meshes   .clear();
+    m_Materials.clear();
+    m_File     .Close();
+}
+
+//-----------------------------------------------------------------------------
+//      データを検証してビューを設定します.
+//-----------------------------------------------------------------------------
+bool ResModelFile::Parse(const void* pBuffer, size_t size)
+{
+    auto pData = static_cast<const uint8_t*>(pBuffer);
+    if (pData == nullptr || size < sizeof(FileHeader))
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    FileReader reader(pData, size);
+
+    FileHeader header;
+    reader.Read(0, header);
+    if (header.Magic != RES_MODEL_FILE_MAGIC)
+    {
+        ELOGA("Error : Invalid File Magic.");
+        return false;
+    }
+
+    if (header.Version != RES_MODEL_FILE_VERSION)
+    {
+        ELOGA("Error : Unsupported File Version. version = %u", header.Version);
+        return false;
+    }
+
+    if (header.FileSize > size
+     || !reader.IsValidRange(header.MeshTableOffset,     header.MeshCount,       sizeof(FileMesh))
+     || !reader.IsValidRange(header.MaterialTableOffset, header.MaterialCount,   sizeof(FileMaterial))
+     || !reader.IsValidRange(header.StringTableOffset,   header.StringTableSize, 1))
+    {
+        ELOGA("Error : Invalid File Size.");
+        return false;
+    }
+
+    auto pStrings = reinterpret_cast<const char*>(pData + header.StringTableOffset);
+    auto getString = [&](const FileString& value, const char*& result)
+    {
+        // 終端文字まで文字列テーブルに収まっていること.
+        if (uint64_t(value.Offset) + value.Length >= header.StringTableSize
+         || pStrings[value.Offset + value.Length] != '\0')
+        { return false; }
+
+        result = pStrings + value.Offset;
+        return true;
+    };
+
+    m_Materials.resize(header.MaterialCount);
+    for(auto i=0u; i<header.MaterialCount; ++i)
+    {
+        FileMaterial src;
+        reader.Read(header.MaterialTableOffset + i * sizeof(FileMaterial), src);
+
+        auto& dst = m_Materials[i];
+        if (!getString(src.MaterialName, dst.MaterialName)
+         || !getString(src.BaseColorMap, dst.BaseColorMap)
+         || !getString(src.OrmMap,       dst.OrmMap)
+         || !getString(src.EmissiveMap,  dst.EmissiveMap))
+        {
+            ELOGA("Error : Invalid Material String. index = %u", i);
+            return false;
+        }
+
+        dst.BaseColorIntensity = src.BaseColorIntensity;
+        dst.OcclusionIntensity = src.OcclusionIntensity;
+        dst.RoughnessIntensity = src.RoughnessIntensity;
+        dst.EmissiveIntensity  = src.EmissiveIntensity;
+    }
+
+    m_Meshes.resize(header.MeshCount);
+    for(auto i=0u; i<header.MeshCount; ++i)
+    {
+        FileMesh src;
+        reader.Read(header.MeshTableOffset + i * sizeof(FileMesh), src);
+
+        auto& dst = m_Meshes[i];
+        auto  ret = getString(src.MeshName,     dst.MeshName)
+                 && getString(src.MaterialName, dst.MaterialName)
+                 && reader.GetSpan(src.Streams[STREAM_POSITION],    dst.Positions)
+                 && reader.GetSpan(src.Streams[STREAM_NORMAL],      dst.Normals)
+                 && reader.GetSpan(src.Streams[STREAM_TANGENT],     dst.Tangents)
+                 && reader.GetSpan(src.Streams[STREAM_BITANGENT],   dst.Bitangents)
+                 && reader.GetSpan(src.Streams[STREAM_COLOR],       dst.Colors)
+                 && reader.GetSpan(src.Streams[STREAM_TEXCOORD0],   dst.TexCoords[0])
+                 && reader.GetSpan(src.Streams[STREAM_TEXCOORD1],   dst.TexCoords[1])
+                 && reader.GetSpan(src.Streams[STREAM_TEXCOORD2],   dst.TexCoords[2])
+                 && reader.GetSpan(src.Streams[STREAM_TEXCOORD3],   dst.TexCoords[3])
+                 && reader.GetSpan(src.Streams[STREAM_BONE_INDEX],  dst.BoneIndices)
+                 && reader.GetSpan(src.Streams[STREAM_BONE_WEIGHT], dst.BoneWeights)
+                 && reader.GetSpan(src.Streams[STREAM_INDEX],       dst.Indices);
+        if (!ret)
+        {
+            ELOGA("Error : Invalid Mesh Data. index = %u", i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      モデルリソースにコピーします.
+//-----------------------------------------------------------------------------
+void ResModelFile::CopyTo(ResModel& result) const
+{
+    result.Meshes   .resize(m_Meshes.size());
+    result.Materials.resize(m_Materials.size());
+
+    for(size_t i=0; i<m_Meshes.size(); ++i)
+    {
+        auto& src = m_Meshes[i];
+        auto& dst = result.Meshes[i];
+        dst.MeshName     = src.MeshName;
+        dst.MaterialName = src.MaterialName;
+        dst.Positions  .assign(src.Positions  .begin(), src.Positions  .end());
+        dst.Normals    .assign(src.Normals    .begin(), src.Normals    .end());
+        dst.Tangents   .assign(src.Tangents   .begin(), src.Tangents   .end());
+        dst.Bitangents .assign(src.Bitangents .begin(), src.Bitangents .end());
+        dst.Colors     .assign(src.Colors     .begin(), src.Colors     .end());
+        for(auto j=0; j<MAX_LAYER_COUNT; ++j)
+        { dst.TexCoords[j].assign(src.TexCoords[j].begin(), src.TexCoords[j].end()); }
+        dst.BoneIndices.assign(src.BoneIndices.begin(), src.BoneIndices.end());
+        dst.BoneWeights.assign(src.BoneWeights.begin(), src.BoneWeights.end());
+        dst.Indices    .assign(src.Indices    .begin(), src.Indices    .end());
+    }
+
+    for(size_t i=0; i<m_Materials.size(); ++i)
+    {
+        auto& src = m_Materials[i];
+        auto& dst = result.Materials[i];
+        dst.MaterialName       = src.MaterialName;
+        dst.BaseColorMap       = src.BaseColorMap;
+        dst.OrmMap             = src.OrmMap;
+        dst.EmissiveMap        = src.EmissiveMap;
+        dst.BaseColorIntensity = src.BaseColorIntensity;
+        dst.OcclusionIntensity = src.OcclusionIntensity;
+        dst.RoughnessIntensity = src.RoughnessIntensity;
+        dst.EmissiveIntensity  = src.EmissiveIntensity;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      モデルをバイナリ形式に変換します.
+//-----------------------------------------------------------------------------
+void SaveResModel(const ResModel& model, std::vector<uint8_t>& result)
+{
+    StringTable strings;
+
+    std::vector<FileMaterial> materials(model.Materials.size());
+    for(size_t i=0; i<model.Materials.size(); ++i)
+    {
+        auto& src = model.Materials[i];
+        auto& dst = materials[i];
+        dst.MaterialName       = strings.Add(src.MaterialName);
+        dst.BaseColorMap       = strings.Add(src.BaseColorMap);
+        dst.OrmMap             = strings.Add(src.OrmMap);
+        dst.EmissiveMap        = strings.Add(src.EmissiveMap);
+        dst.BaseColorIntensity = src.BaseColorIntensity;
+        dst.OcclusionIntensity = src.OcclusionIntensity;
+        dst.RoughnessIntensity = src.RoughnessIntensity;
+        dst.EmissiveIntensity  = src.EmissiveIntensity;
+    }
+
+    // 各セクションの配置を決める.
+    FileHeader header = {};
+    header.Magic         = RES_MODEL_FILE_MAGIC;
+    header.Version       = RES_MODEL_FILE_VERSION;
+    header.MeshCount     = uint32_t(model.Meshes.size());
+    header.MaterialCount = uint32_t(model.Materials.size());
+
+    header.MeshTableOffset     = AlignUp(sizeof(FileHeader));
+    header.MaterialTableOffset = AlignUp(header.MeshTableOffset + sizeof(FileMesh) * model.Meshes.size());
+
+    std::vector<FileMesh> meshes(model.Meshes.size());
+    for(size_t i=0; i<model.Meshes.size(); ++i)
+    {
+        meshes[i].MeshName     = strings.Add(model.Meshes[i].MeshName);
+        meshes[i].MaterialName = strings.Add(model.Meshes[i].MaterialName);
+    }
+
+    header.StringTableOffset = AlignUp(header.MaterialTableOffset + sizeof(FileMaterial) * materials.size());
+    header.StringTableSize   = strings.GetBuffer().size();
+
+    auto offset = AlignUp(header.StringTableOffset + header.StringTableSize);
+    for(size_t i=0; i<model.Meshes.size(); ++i)
+    {
+        for(auto j=0u; j<STREAM_COUNT; ++j)
+        {
+            auto  stream = GetStream(model.Meshes[i], j);
+            auto& dst    = meshes[i].Streams[j];
+            dst.Offset = (stream.Count > 0) ? offset : 0;
+            dst.Count  = stream.Count;
+            offset = AlignUp(offset + stream.Count * STREAM_STRIDE[j]);
+        }
+    }
+    header.FileSize = offset;
+
+    // 書き出す.
+    result.assign(size_t(header.FileSize), 0);
+    auto pDst = result.data();
+    memcpy(pDst, &header, sizeof(header));
+
+    if (!meshes.empty())
+    { memcpy(pDst + header.MeshTableOffset, meshes.data(), sizeof(FileMesh) * meshes.size()); }
+
+    if (!materials.empty())
+    { memcpy(pDst + header.MaterialTableOffset, materials.data(), sizeof(FileMaterial) * materials.size()); }
+
+    if (!strings.GetBuffer().empty())
+    { memcpy(pDst + header.StringTableOffset, strings.GetBuffer().data(), strings.GetBuffer().size()); }
+
+    for(size_t i=0; i<model.Meshes.size(); ++i)
+    {
+        for(auto j=0u; j<STREAM_COUNT; ++j)
+        {
+            auto stream = GetStream(model.Meshes[i], j);
+            if (stream.Count > 0)
+            { memcpy(pDst + meshes[i].Streams[j].Offset, stream.pData, stream.Count * STREAM_STRIDE[j]); }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      モデルをバイナリ形式でファイルに保存します.
+//-----------------------------------------------------------------------------
+bool SaveResModel(const char* filename, const ResModel& model)
+{
+    if (filename == nullptr)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    std::vector<uint8_t> buffer;
+    SaveResModel(model, buffer);
+
+    FILE* pFile = nullptr;
+#if defined(_WIN32)
+    fopen_s(&pFile, filename, "wb");
+#else
+    pFile = fopen(filename, "wb");
+#endif
+    if (pFile == nullptr)
+    {
+        ELOGA("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
+
+    auto written = fwrite(buffer.data(), 1, buffer.size(), pFile);
+    fclose(pFile);
+
+    if (written != buffer.size())
+    {
+        ELOGA("Error : File Write Failed. path = %s", filename);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace asdx
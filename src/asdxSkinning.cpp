@@ -0,0 +1,255 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxSkinning.cpp
+// Desc : CPU Skinning.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <asdxSkinning.h>
+#include <asdxParallel.h>
+#include <asdxLogger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      従接線の利き手を求めます.
+//-----------------------------------------------------------------------------
+inline uint8_t GetBinormalHandedness(const asdx::SkinningSource& source, size_t index)
+{
+    if (source.pBitangents == nullptr)
+    { return 0; }
+
+    // DecodeTBN() は Cross(N, T) を従接線とするので, 逆向きなら1とする.
+    auto c = asdx::Vector3::Cross(source.pNormals[index], source.pTangents[index]);
+    return (asdx::Vector3::Dot(c, source.pBitangents[index]) < 0.0f) ? 1 : 0;
+}
+
+#if defined(ASDX_ENABLE_SIMD)
+//-----------------------------------------------------------------------------
+//      3成分を格納します.
+//-----------------------------------------------------------------------------
+inline void SimdStoreFloat3(asdx::Vector3* pDst, __m128 value)
+{
+    _mm_storel_pi(reinterpret_cast<__m64*>(&pDst->x), value);
+    _mm_store_ss(&pDst->z, _mm_movehl_ps(value, value));
+}
+
+//-----------------------------------------------------------------------------
+//      3成分を変換して正規化します.
+//-----------------------------------------------------------------------------
+inline __m128 SimdTransformNormal(const asdx::Vector3& value, const __m128* rows)
+{
+    auto r = _mm_mul_ps(_mm_set1_ps(value.x), rows[0]);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(value.y), rows[1]));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(value.z), rows[2]));
+
+    auto sq = _mm_mul_ps(r, r);
+    auto lenSq = _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(sq, ASDX_SPLAT(sq, 1)), ASDX_SPLAT(sq, 2)));
+    auto inv = (lenSq > 0.0f) ? 1.0f / sqrtf(lenSq) : 0.0f;
+    return _mm_mul_ps(r, _mm_set1_ps(inv));
+}
+#else
+//-----------------------------------------------------------------------------
+//      3成分を変換して正規化します.
+//-----------------------------------------------------------------------------
+inline asdx::Vector3 TransformNormal(const asdx::Vector3& value, const asdx::Matrix& m)
+{
+    auto x = ((value.x * m._11) + (value.y * m._21)) + (value.z * m._31);
+    auto y = ((value.x * m._12) + (value.y * m._22)) + (value.z * m._32);
+    auto z = ((value.x * m._13) + (value.y * m._23)) + (value.z * m._33);
+
+    auto lenSq = (x * x + y * y) + z * z;
+    auto inv = (lenSq > 0.0f) ? 1.0f / sqrtf(lenSq) : 0.0f;
+    return asdx::Vector3(x * inv, y * inv, z * inv);
+}
+#endif//defined(ASDX_ENABLE_SIMD)
+
+//-----------------------------------------------------------------------------
+//      指定範囲の頂点をスキニングします.
+//-----------------------------------------------------------------------------
+void SkinVerticesRange
+(
+    const asdx::Matrix*             pPalette,
+    uint32_t                        boneCount,
+    const asdx::SkinningSource&     source,
+    const asdx::SkinningTarget&     target,
+    size_t                          begin,
+    size_t                          end
+)
+{
+    bool skinNormal  = (source.pNormals  != nullptr) && (target.pNormals  != nullptr || target.pEncodedTBN != nullptr);
+    bool skinTangent = (source.pTangents != nullptr) && (target.pTangents != nullptr || target.pEncodedTBN != nullptr);
+    bool encodeTBN   = (target.pEncodedTBN != nullptr);
+
+    for(auto i=begin; i<end; ++i)
+    {
+        auto& index  = source.pBoneIndices[i];
+        auto& weight = source.pBoneWeights[i];
+        assert(index.x < boneCount && index.y < boneCount && index.z < boneCount && index.w < boneCount);
+        (void)boneCount;
+
+        auto& m0 = pPalette[index.x];
+        auto& m1 = pPalette[index.y];
+        auto& m2 = pPalette[index.z];
+        auto& m3 = pPalette[index.w];
+
+        asdx::Vector3 normal;
+        asdx::Vector3 tangent;
+
+    #if defined(ASDX_ENABLE_SIMD)
+        // ボーン行列を重み付きで合成する.
+        auto w0 = _mm_set1_ps(weight.x);
+        auto w1 = _mm_set1_ps(weight.y);
+        auto w2 = _mm_set1_ps(weight.z);
+        auto w3 = _mm_set1_ps(weight.w);
+
+        __m128 rows[4];
+        for(auto r=0; r<4; ++r)
+        {
+            auto v = _mm_mul_ps(w0, _mm_loadu_ps(m0.m[r]));
+            v = _mm_add_ps(v, _mm_mul_ps(w1, _mm_loadu_ps(m1.m[r])));
+            v = _mm_add_ps(v, _mm_mul_ps(w2, _mm_loadu_ps(m2.m[r])));
+            v = _mm_add_ps(v, _mm_mul_ps(w3, _mm_loadu_ps(m3.m[r])));
+            rows[r] = v;
+        }
+
+        if (target.pPositions != nullptr)
+        {
+            auto& p = source.pPositions[i];
+            auto v = _mm_mul_ps(_mm_set1_ps(p.x), rows[0]);
+            v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(p.y), rows[1]));
+            v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(p.z), rows[2]));
+            v = _mm_add_ps(v, rows[3]);
+            SimdStoreFloat3(&target.pPositions[i], v);
+        }
+
+        if (skinNormal)
+        { SimdStoreFloat3(&normal, SimdTransformNormal(source.pNormals[i], rows)); }
+
+        if (skinTangent)
+        { SimdStoreFloat3(&tangent, SimdTransformNormal(source.pTangents[i], rows)); }
+    #else
+        // ボーン行列を重み付きで合成する.
+        asdx::Matrix blend;
+        for(auto r=0; r<4; ++r)
+        {
+            for(auto c=0; c<4; ++c)
+            {
+                blend.m[r][c] = ((weight.x * m0.m[r][c] + weight.y * m1.m[r][c])
+                                + weight.z * m2.m[r][c]) + weight.w * m3.m[r][c];
+            }
+        }
+
+        if (target.pPositions != nullptr)
+        { asdx::Vector3::Transform(source.pPositions[i], blend, target.pPositions[i]); }
+
+        if (skinNormal)
+        { normal = TransformNormal(source.pNormals[i], blend); }
+
+        if (skinTangent)
+        { tangent = TransformNormal(source.pTangents[i], blend); }
+    #endif//defined(ASDX_ENABLE_SIMD)
+
+        if (skinNormal && target.pNormals != nullptr)
+        { target.pNormals[i] = normal; }
+
+        if (skinTangent && target.pTangents != nullptr)
+        { target.pTangents[i] = tangent; }
+
+        if (encodeTBN)
+        { target.pEncodedTBN[i] = asdx::EncodeTBN(normal, tangent, GetBinormalHandedness(source, i)); }
+    }
+}
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      メッシュからスキニングの入力を設定します.
+//-----------------------------------------------------------------------------
+SkinningSource GetSkinningSource(const ResMesh& mesh)
+{
+    auto count = mesh.Positions.size();
+
+    SkinningSource result;
+    result.pPositions   = mesh.Positions.data();
+    result.pNormals     = (mesh.Normals   .size() == count) ? mesh.Normals   .data() : nullptr;
+    result.pTangents    = (mesh.Tangents  .size() == count) ? mesh.Tangents  .data() : nullptr;
+    result.pBitangents  = (mesh.Bitangents.size() == count) ? mesh.Bitangents.data() : nullptr;
+    result.VertexCount  = count;
+
+    // ボーン情報が頂点数と一致しない場合は設定しない(SkinVertices() が失敗する).
+    if (mesh.BoneIndices.size() != count || mesh.BoneWeights.size() != count)
+    {
+        ELOGA("Error : Bone Data Count Mismatch. vertex = %zu, indices = %zu, weights = %zu",
+            count, mesh.BoneIndices.size(), mesh.BoneWeights.size());
+        return result;
+    }
+
+    result.pBoneIndices = mesh.BoneIndices.data();
+    result.pBoneWeights = mesh.BoneWeights.data();
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      頂点をスキニングします.
+//-----------------------------------------------------------------------------
+bool SkinVertices
+(
+    const Matrix34*         pPalette,
+    uint32_t                boneCount,
+    const SkinningSource&   source,
+    const SkinningTarget&   target,
+    uint32_t                maxThreadCount
+)
+{
+    if (source.VertexCount == 0)
+    { return true; }
+
+    assert(target.pEncodedTBN == nullptr || (source.pNormals != nullptr && source.pTangents != nullptr));
+
+    if (pPalette == nullptr || boneCount == 0)
+    {
+        ELOGA("Error : Invalid Bone Palette.");
+        return false;
+    }
+
+    if (source.pPositions == nullptr || source.pBoneIndices == nullptr || source.pBoneWeights == nullptr)
+    {
+        ELOGA("Error : Invalid Skinning Source.");
+        return false;
+    }
+
+    // ボーン番号は読み込んだファイルの値なので, パレットを超えないか先に確認する.
+    for(size_t i=0; i<source.VertexCount; ++i)
+    {
+        const auto& index = source.pBoneIndices[i];
+        if (Max(Max(index.x, index.y), Max(index.z, index.w)) >= boneCount)
+        {
+            ELOGA("Error : Bone Index Out Of Range. vertex = %zu, boneCount = %u", i, boneCount);
+            return false;
+        }
+    }
+
+    // 行ベクトル形式に展開しておくと, 合成した行をそのまま変換に使える.
+    std::vector<Matrix> palette(boneCount);
+    for(auto i=0u; i<boneCount; ++i)
+    { palette[i] = Matrix(pPalette[i]); }
+
+    // 頂点ごとに出力先が異なるため, スレッド間で書き込みが競合することは無い.
+    ParallelFor(source.VertexCount, SKINNING_PARALLEL_THRESHOLD,
+        [&](uint32_t, size_t begin, size_t end)
+        { SkinVerticesRange(palette.data(), boneCount, source, target, begin, end); },
+        maxThreadCount);
+
+    return true;
+}
+
+} // namespace asdx
@@ -0,0 +1,567 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxVertexPacker.cpp
+// Desc : Quantized Vertex Stream Packer.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxVertexPacker.h>
+#include <asdxParallel.h>
+#include <asdxLogger.h>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(ASDX_ENABLE_SIMD)
+#include <asdxSimd.h>
+#endif//defined(ASDX_ENABLE_SIMD)
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t     MIN_BATCH_VERTEX_COUNT  = 8192;     // 1スレッドあたりの最小頂点数.
+static constexpr size_t     HALF_BLOCK_SIZE         = 1024;     // 半精度変換で一度に処理する頂点数.
+
+///////////////////////////////////////////////////////////////////////////////
+// ELEMENT_KIND enum
+///////////////////////////////////////////////////////////////////////////////
+enum ELEMENT_KIND
+{
+    ELEMENT_KIND_POSITION = 0,
+    ELEMENT_KIND_NORMAL,
+    ELEMENT_KIND_TANGENT,
+    ELEMENT_KIND_COLOR,
+    ELEMENT_KIND_TEXCOORD,
+    ELEMENT_KIND_BONE_INDEX,
+    ELEMENT_KIND_BONE_WEIGHT,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PackElement structure
+///////////////////////////////////////////////////////////////////////////////
+struct PackElement
+{
+    ELEMENT_KIND    Kind;       // 要素の種類.
+    uint32_t        Layer;      // テクスチャ座標のレイヤー番号.
+    uint8_t*        pDst;       // 先頭頂点の書き込み先.
+    size_t          Stride;     // 頂点間のバイト数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PackContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct PackContext
+{
+    const asdx::ResMesh*    pMesh;
+    asdx::VERTEX_FORMAT     Format;
+    asdx::Vector3           PositionMin;    // 量子化の基準位置.
+    asdx::Vector3           PositionScale;  // 量子化のスケール(65535 / 範囲).
+};
+
+//-----------------------------------------------------------------------------
+//      フォーマットが候補に含まれるか判定します.
+//-----------------------------------------------------------------------------
+bool IsSupported(asdx::VERTEX_FORMAT format, std::initializer_list<asdx::VERTEX_FORMAT> candidates)
+{
+    for(auto& itr : candidates)
+    {
+        if (itr == format)
+        { return true; }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+//      16bit符号無し正規化整数に変換します.
+//-----------------------------------------------------------------------------
+inline uint16_t ToUnorm16(float value)
+{ return uint16_t(asdx::Saturate(value) * 65535.0f + 0.5f); }
+
+//-----------------------------------------------------------------------------
+//      位置座標を量子化します.
+//-----------------------------------------------------------------------------
+inline uint16_t QuantizePosition(float value, float mini, float scale)
+{ return uint16_t(asdx::Clamp((value - mini) * scale + 0.5f, 0.0f, 65535.0f)); }
+
+//-----------------------------------------------------------------------------
+//      位置座標をパッキングします.
+//-----------------------------------------------------------------------------
+void PackPositions(const PackContext& context, const PackElement& element, size_t begin, size_t end)
+{
+    const auto& positions = context.pMesh->Positions;
+
+    if (context.Format == asdx::VERTEX_FORMAT_FLOAT3)
+    {
+        for(auto i=begin; i<end; ++i)
+        { memcpy(element.pDst + i * element.Stride, &positions[i], sizeof(asdx::Vector3)); }
+        return;
+    }
+
+    const auto& mini  = context.PositionMin;
+    const auto& scale = context.PositionScale;
+    auto i = begin;
+
+#if defined(ASDX_ENABLE_SIMD)
+    // 4頂点ずつSoA形式で量子化する.
+    // SSE2 には符号無し16bitへの飽和パックが無いので, 符号付きにずらしてパックする.
+    const auto minX   = _mm_set1_ps(mini.x);
+    const auto minY   = _mm_set1_ps(mini.y);
+    const auto minZ   = _mm_set1_ps(mini.z);
+    const auto scaleX = _mm_set1_ps(scale.x);
+    const auto scaleY = _mm_set1_ps(scale.y);
+    const auto scaleZ = _mm_set1_ps(scale.z);
+    const auto half   = _mm_set1_ps(0.5f);
+    const auto zero   = _mm_setzero_ps();
+    const auto limit  = _mm_set1_ps(65535.0f);
+    const auto bias   = _mm_set1_epi32(32768);
+    const auto flip   = _mm_set1_epi16(-32768);
+    const auto one    = _mm_set1_epi32(65535);
+
+    for(; i + 4 <= end; i += 4)
+    {
+        __m128 x, y, z;
+        asdx::SimdLoadFloat3x4(&positions[i], sizeof(asdx::Vector3), x, y, z);
+
+        x = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(x, minX), scaleX), half), zero), limit);
+        y = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(y, minY), scaleY), half), zero), limit);
+        z = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(z, minZ), scaleZ), half), zero), limit);
+
+        auto qx = _mm_cvttps_epi32(x);
+        auto qy = _mm_cvttps_epi32(y);
+        auto qz = _mm_cvttps_epi32(z);
+
+        auto xy01 = _mm_unpacklo_epi32(qx, qy);     // x0 y0 x1 y1
+        auto xy23 = _mm_unpackhi_epi32(qx, qy);     // x2 y2 x3 y3
+        auto zw01 = _mm_unpacklo_epi32(qz, one);    // z0 w0 z1 w1
+        auto zw23 = _mm_unpackhi_epi32(qz, one);    // z2 w2 z3 w3
+
+        auto v0 = _mm_sub_epi32(_mm_unpacklo_epi64(xy01, zw01), bias);
+        auto v1 = _mm_sub_epi32(_mm_unpackhi_epi64(xy01, zw01), bias);
+        auto v2 = _mm_sub_epi32(_mm_unpacklo_epi64(xy23, zw23), bias);
+        auto v3 = _mm_sub_epi32(_mm_unpackhi_epi64(xy23, zw23), bias);
+
+        auto v01 = _mm_xor_si128(_mm_packs_epi32(v0, v1), flip);
+        auto v23 = _mm_xor_si128(_mm_packs_epi32(v2, v3), flip);
+
+        auto pDst = element.pDst + i * element.Stride;
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDst + element.Stride * 0), v01);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDst + element.Stride * 1), _mm_srli_si128(v01, 8));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDst + element.Stride * 2), v23);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDst + element.Stride * 3), _mm_srli_si128(v23, 8));
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+
+    for(; i<end; ++i)
+    {
+        uint16_t packed[4] = {
+            QuantizePosition(positions[i].x, mini.x, scale.x),
+            QuantizePosition(positions[i].y, mini.y, scale.y),
+            QuantizePosition(positions[i].z, mini.z, scale.z),
+            65535
+        };
+        memcpy(element.pDst + i * element.Stride, packed, sizeof(packed));
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      接線空間をパッキングします.
+//-----------------------------------------------------------------------------
+void PackTangentSpace(const PackContext& context, const PackElement& element, size_t begin, size_t end)
+{
+    const auto& mesh = *context.pMesh;
+    const auto& source = (element.Kind == ELEMENT_KIND_NORMAL) ? mesh.Normals : mesh.Tangents;
+
+    if (context.Format == asdx::VERTEX_FORMAT_FLOAT3)
+    {
+        for(auto i=begin; i<end; ++i)
+        { memcpy(element.pDst + i * element.Stride, &source[i], sizeof(asdx::Vector3)); }
+        return;
+    }
+
+    auto hasTangent   = !mesh.Tangents.empty();
+    auto hasBitangent = !mesh.Bitangents.empty();
+
+    for(auto i=begin; i<end; ++i)
+    {
+        const auto& normal = mesh.Normals[i];
+
+        asdx::Vector3 tangent, bitangent;
+        if (hasTangent)
+        { tangent = mesh.Tangents[i]; }
+        else
+        { asdx::CalcONB(normal, tangent, bitangent); }
+
+        // DecodeTBN() は Cross(N, T) を従接線とするので, 逆向きなら1とする.
+        uint8_t handedness = 0;
+        if (hasTangent && hasBitangent)
+        {
+            auto c = asdx::Vector3::Cross(normal, tangent);
+            handedness = (asdx::Vector3::Dot(c, mesh.Bitangents[i]) < 0.0f) ? 1 : 0;
+        }
+
+        auto packed = asdx::EncodeTBN(normal, tangent, handedness);
+        memcpy(element.pDst + i * element.Stride, &packed, sizeof(packed));
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      4成分をパッキングします.
+//-----------------------------------------------------------------------------
+void PackFloat4(const PackContext& context, const PackElement& element, size_t begin, size_t end)
+{
+    const auto& source = (element.Kind == ELEMENT_KIND_COLOR)
+        ? context.pMesh->Colors
+        : context.pMesh->BoneWeights;
+
+    if (context.Format == asdx::VERTEX_FORMAT_FLOAT4)
+    {
+        for(auto i=begin; i<end; ++i)
+        { memcpy(element.pDst + i * element.Stride, &source[i], sizeof(asdx::Vector4)); }
+        return;
+    }
+
+    if (context.Format == asdx::VERTEX_FORMAT_UNORM16X4)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            uint16_t packed[4] = {
+                ToUnorm16(source[i].x),
+                ToUnorm16(source[i].y),
+                ToUnorm16(source[i].z),
+                ToUnorm16(source[i].w)
+            };
+            memcpy(element.pDst + i * element.Stride, packed, sizeof(packed));
+        }
+        return;
+    }
+
+    assert(context.Format == asdx::VERTEX_FORMAT_UNORM8X4);
+
+#if defined(ASDX_ENABLE_SIMD)
+    // 結果は EncodeUnorm4() と一致する.
+    const auto zero  = _mm_setzero_ps();
+    const auto one   = _mm_set1_ps(1.0f);
+    const auto scale = _mm_set1_ps(255.0f);
+
+    for(auto i=begin; i<end; ++i)
+    {
+        auto v = _mm_loadu_ps(&source[i].x);
+        v = _mm_mul_ps(_mm_min_ps(_mm_max_ps(v, zero), one), scale);
+
+        auto q = _mm_cvttps_epi32(v);
+        q = _mm_packs_epi32(q, q);
+        q = _mm_packus_epi16(q, q);
+
+        auto packed = uint32_t(_mm_cvtsi128_si32(q));
+        memcpy(element.pDst + i * element.Stride, &packed, sizeof(packed));
+    }
+#else
+    for(auto i=begin; i<end; ++i)
+    {
+        auto packed = asdx::EncodeUnorm4(source[i]);
+        memcpy(element.pDst + i * element.Stride, &packed, sizeof(packed));
+    }
+#endif//defined(ASDX_ENABLE_SIMD)
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャ座標をパッキングします.
+//-----------------------------------------------------------------------------
+void PackTexCoords(const PackContext& context, const PackElement& element, size_t begin, size_t end)
+{
+    const auto& source = context.pMesh->TexCoords[element.Layer];
+
+    if (context.Format == asdx::VERTEX_FORMAT_FLOAT2)
+    {
+        for(auto i=begin; i<end; ++i)
+        { memcpy(element.pDst + i * element.Stride, &source[i], sizeof(asdx::Vector2)); }
+        return;
+    }
+
+    // 連続した成分をまとめて ToHalfArray() で変換してから書き込む.
+    asdx::half temp[HALF_BLOCK_SIZE * 2];
+    for(auto i=begin; i<end; i+=HALF_BLOCK_SIZE)
+    {
+        auto count = asdx::Min(HALF_BLOCK_SIZE, end - i);
+        asdx::ToHalfArray(&source[i].x, count * 2, temp);
+
+        for(size_t j=0; j<count; ++j)
+        { memcpy(element.pDst + (i + j) * element.Stride, &temp[j * 2], sizeof(uint32_t)); }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ボーン番号をパッキングします.
+//-----------------------------------------------------------------------------
+void PackBoneIndices(const PackContext& context, const PackElement& element, size_t begin, size_t end)
+{
+    const auto& source = context.pMesh->BoneIndices;
+
+    if (context.Format == asdx::VERTEX_FORMAT_UINT16X4)
+    {
+        for(auto i=begin; i<end; ++i)
+        { memcpy(element.pDst + i * element.Stride, &source[i], sizeof(asdx::ResBoneIndex)); }
+        return;
+    }
+
+    for(auto i=begin; i<end; ++i)
+    {
+        uint8_t packed[4] = {
+            uint8_t(source[i].x),
+            uint8_t(source[i].y),
+            uint8_t(source[i].z),
+            uint8_t(source[i].w)
+        };
+        memcpy(element.pDst + i * element.Stride, packed, sizeof(packed));
+    }
+}
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      フォーマットのバイト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetVertexFormatSize(VERTEX_FORMAT format)
+{
+    switch(format)
+    {
+    case VERTEX_FORMAT_FLOAT2:      return 8;
+    case VERTEX_FORMAT_FLOAT3:      return 12;
+    case VERTEX_FORMAT_FLOAT4:      return 16;
+    case VERTEX_FORMAT_HALF2:       return 4;
+    case VERTEX_FORMAT_UNORM16X4:   return 8;
+    case VERTEX_FORMAT_UNORM8X4:    return 4;
+    case VERTEX_FORMAT_UINT16X4:    return 8;
+    case VERTEX_FORMAT_UINT8X4:     return 4;
+    case VERTEX_FORMAT_UINT32:      return 4;
+    default:                        return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュの頂点ストリームを量子化してパッキングします.
+//-----------------------------------------------------------------------------
+bool PackVertices
+(
+    const ResMesh&          mesh,
+    const VertexPackDesc&   desc,
+    PackedVertices&         result,
+    uint32_t                maxThreadCount
+)
+{
+    result = PackedVertices();
+
+    auto vertexCount = mesh.Positions.size();
+    if (vertexCount == 0 || vertexCount > UINT32_MAX)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    // 属性ごとに対応するフォーマットか確認する.
+    if (!IsSupported(desc.Position,   { VERTEX_FORMAT_FLOAT3, VERTEX_FORMAT_UNORM16X4 })
+     || !IsSupported(desc.Normal,     { VERTEX_FORMAT_NONE, VERTEX_FORMAT_FLOAT3, VERTEX_FORMAT_UINT32 })
+     || !IsSupported(desc.Color,      { VERTEX_FORMAT_NONE, VERTEX_FORMAT_FLOAT4, VERTEX_FORMAT_UNORM8X4 })
+     || !IsSupported(desc.TexCoord,   { VERTEX_FORMAT_NONE, VERTEX_FORMAT_FLOAT2, VERTEX_FORMAT_HALF2 })
+     || !IsSupported(desc.BoneIndex,  { VERTEX_FORMAT_NONE, VERTEX_FORMAT_UINT16X4, VERTEX_FORMAT_UINT8X4 })
+     || !IsSupported(desc.BoneWeight, { VERTEX_FORMAT_NONE, VERTEX_FORMAT_FLOAT4, VERTEX_FORMAT_UNORM16X4, VERTEX_FORMAT_UNORM8X4 }))
+    {
+        ELOGA("Error : Unsupported Vertex Format.");
+        return false;
+    }
+
+    auto isValid = [&](size_t count)
+    { return count == 0 || count == vertexCount; };
+
+    auto validStreams = isValid(mesh.Normals.size())
+                     && isValid(mesh.Tangents.size())
+                     && isValid(mesh.Bitangents.size())
+                     && isValid(mesh.Colors.size())
+                     && isValid(mesh.BoneIndices.size())
+                     && isValid(mesh.BoneWeights.size());
+    for(auto i=0; i<MAX_LAYER_COUNT; ++i)
+    { validStreams &= isValid(mesh.TexCoords[i].size()); }
+
+    if (!validStreams)
+    {
+        ELOGA("Error : Vertex Stream Count Mismatch.");
+        return false;
+    }
+
+    // 8bitに収まらないボーン番号は扱えない.
+    if (desc.BoneIndex == VERTEX_FORMAT_UINT8X4)
+    {
+        for(auto& itr : mesh.BoneIndices)
+        {
+            if (Max(Max(itr.x, itr.y), Max(itr.z, itr.w)) > UINT8_MAX)
+            {
+                ELOGA("Error : Bone Index Out Of Range For UINT8X4.");
+                return false;
+            }
+        }
+    }
+
+    // 出力する要素を列挙する.
+    std::vector<PackContext> contexts;
+    std::vector<PackElement> elements;
+
+    auto addElement = [&](const char* semanticName, uint32_t semanticIndex, VERTEX_FORMAT format, ELEMENT_KIND kind)
+    {
+        VertexElement element;
+        element.SemanticName  = semanticName;
+        element.SemanticIndex = semanticIndex;
+        element.Format        = format;
+        result.Elements.push_back(element);
+
+        PackContext context = {};
+        context.pMesh  = &mesh;
+        context.Format = format;
+        contexts.push_back(context);
+
+        PackElement pack = {};
+        pack.Kind  = kind;
+        pack.Layer = semanticIndex;
+        elements.push_back(pack);
+    };
+
+    addElement("POSITION", 0, desc.Position, ELEMENT_KIND_POSITION);
+
+    if (desc.Normal != VERTEX_FORMAT_NONE && !mesh.Normals.empty())
+    {
+        addElement("NORMAL", 0, desc.Normal, ELEMENT_KIND_NORMAL);
+
+        // 圧縮しない場合は接線を別の要素として出力する.
+        if (desc.Normal == VERTEX_FORMAT_FLOAT3 && !mesh.Tangents.empty())
+        { addElement("TANGENT", 0, VERTEX_FORMAT_FLOAT3, ELEMENT_KIND_TANGENT); }
+    }
+
+    if (desc.Color != VERTEX_FORMAT_NONE && !mesh.Colors.empty())
+    { addElement("COLOR", 0, desc.Color, ELEMENT_KIND_COLOR); }
+
+    if (desc.TexCoord != VERTEX_FORMAT_NONE)
+    {
+        for(auto i=0u; i<MAX_LAYER_COUNT; ++i)
+        {
+            if (!mesh.TexCoords[i].empty())
+            { addElement("TEXCOORD", i, desc.TexCoord, ELEMENT_KIND_TEXCOORD); }
+        }
+    }
+
+    if (desc.BoneIndex != VERTEX_FORMAT_NONE && !mesh.BoneIndices.empty())
+    { addElement("BLENDINDICES", 0, desc.BoneIndex, ELEMENT_KIND_BONE_INDEX); }
+
+    if (desc.BoneWeight != VERTEX_FORMAT_NONE && !mesh.BoneWeights.empty())
+    { addElement("BLENDWEIGHT", 0, desc.BoneWeight, ELEMENT_KIND_BONE_WEIGHT); }
+
+    assert(result.Elements.size() <= VERTEX_PACK_MAX_ELEMENTS);
+
+    // ストリームを割り当てる. 全フォーマットが4バイトの倍数なのでアライメントは揃う.
+    if (desc.Interleaved)
+    {
+        result.Streams.resize(1);
+
+        uint32_t offset = 0;
+        for(auto& itr : result.Elements)
+        {
+            itr.InputSlot = 0;
+            itr.Offset    = offset;
+            offset += GetVertexFormatSize(itr.Format);
+        }
+
+        result.Streams[0].Stride = offset;
+    }
+    else
+    {
+        result.Streams.resize(result.Elements.size());
+
+        for(size_t i=0; i<result.Elements.size(); ++i)
+        {
+            result.Elements[i].InputSlot = uint32_t(i);
+            result.Elements[i].Offset    = 0;
+            result.Streams[i].Stride     = GetVertexFormatSize(result.Elements[i].Format);
+        }
+    }
+
+    for(auto& itr : result.Streams)
+    { itr.Data.resize(size_t(itr.Stride) * vertexCount); }
+
+    for(size_t i=0; i<elements.size(); ++i)
+    {
+        auto& stream = result.Streams[result.Elements[i].InputSlot];
+        elements[i].pDst   = stream.Data.data() + result.Elements[i].Offset;
+        elements[i].Stride = stream.Stride;
+    }
+
+    // 位置座標の範囲を求める.
+    auto positionMin = mesh.Positions[0];
+    auto positionMax = mesh.Positions[0];
+    for(auto& itr : mesh.Positions)
+    {
+        positionMin = Vector3::Min(positionMin, itr);
+        positionMax = Vector3::Max(positionMax, itr);
+    }
+
+    auto extent = positionMax - positionMin;
+    result.VertexCount   = uint32_t(vertexCount);
+    result.PositionScale = extent;
+    result.PositionBias  = positionMin;
+
+    if (desc.Position == VERTEX_FORMAT_FLOAT3)
+    {
+        result.PositionScale = Vector3(1.0f, 1.0f, 1.0f);
+        result.PositionBias  = Vector3(0.0f, 0.0f, 0.0f);
+    }
+
+    // 範囲が0の軸は全て0に量子化され, バイアスだけで復元される.
+    contexts[0].PositionMin   = positionMin;
+    contexts[0].PositionScale = Vector3(
+        (extent.x > 0.0f) ? 65535.0f / extent.x : 0.0f,
+        (extent.y > 0.0f) ? 65535.0f / extent.y : 0.0f,
+        (extent.z > 0.0f) ? 65535.0f / extent.z : 0.0f);
+
+    // 頂点ごとに出力先が異なるため, スレッド間で書き込みが競合することは無い.
+    ParallelFor(vertexCount, MIN_BATCH_VERTEX_COUNT, [&](uint32_t, size_t begin, size_t end)
+    {
+        for(size_t i=0; i<elements.size(); ++i)
+        {
+            const auto& context = contexts[i];
+            const auto& element = elements[i];
+
+            switch(element.Kind)
+            {
+            case ELEMENT_KIND_POSITION:
+                PackPositions(context, element, begin, end);
+                break;
+
+            case ELEMENT_KIND_NORMAL:
+            case ELEMENT_KIND_TANGENT:
+                PackTangentSpace(context, element, begin, end);
+                break;
+
+            case ELEMENT_KIND_COLOR:
+            case ELEMENT_KIND_BONE_WEIGHT:
+                PackFloat4(context, element, begin, end);
+                break;
+
+            case ELEMENT_KIND_TEXCOORD:
+                PackTexCoords(context, element, begin, end);
+                break;
+
+            case ELEMENT_KIND_BONE_INDEX:
+                PackBoneIndices(context, element, begin, end);
+                break;
+            }
+        }
+    }, maxThreadCount);
+
+    return true;
+}
+
+} // namespace asdx
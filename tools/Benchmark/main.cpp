@@ -0,0 +1,1457 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Micro benchmarks for the portable core modules.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <asdxMath.h>
+#include <asdxFastMath.h>
+#include <asdxHash.h>
+#include <asdxFrameHeap.h>
+#include <asdxResModel.h>
+#include <asdxResModelFile.h>
+#include <asdxBounds.h>
+#include <asdxCulling.h>
+#include <asdxAnimation.h>
+#include <asdxSkinning.h>
+#include <asdxLightCluster.h>
+#include <asdxLightBVH.h>
+#include <asdxMeshlet.h>
+#include <asdxMeshSimplify.h>
+#include <asdxMeshWeld.h>
+#include <asdxVertexPacker.h>
+#include <asdxGltf.h>
+#include <asdxObj.h>
+#include <asdxMeshBVH.h>
+
+// 出力は1行1レコードのJSON形式です. 先頭行は計測条件です.
+//  {"context":{"simd":true,"samples":15,"min_time_ms":5.000}}
+//  {"name":"math/Matrix::Multiply","items":4096,"samples":15,"median_ns":1.234,"min_ns":1.200,"max_ns":1.400}
+// median_ns / min_ns / max_ns は1要素あたりの時間(ナノ秒)です.
+// 入力データは固定の種から生成するため, 実行ごとに同じ処理を計測します.
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t     ITEM_COUNT          = 4096;     // 1回の計測で処理する要素数.
+static constexpr uint32_t   DEFAULT_SAMPLES     = 15;       // 計測回数.
+static constexpr double     DEFAULT_MIN_TIME_MS = 5.0;      // 1回の計測の最小時間.
+static constexpr int        RANDOM_SEED         = 12345;
+
+///////////////////////////////////////////////////////////////////////////////
+// Benchmark structure
+///////////////////////////////////////////////////////////////////////////////
+struct Benchmark
+{
+    std::string                     Name;       // ベンチマーク名.
+    size_t                          Items;      // 1回の呼び出しで処理する要素数.
+    std::function<void()>           Func;       // 計測する処理.
+    std::function<std::string()>    Report;     // 計測結果に付け加えるJSONの項目(省略可).
+
+    Benchmark(
+        const std::string&                  name,
+        size_t                              items,
+        const std::function<void()>&        func,
+        const std::function<std::string()>& report = nullptr)
+    : Name  (name)
+    , Items (items)
+    , Func  (func)
+    , Report(report)
+    { /* DO_NOTHING */ }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Option structure
+///////////////////////////////////////////////////////////////////////////////
+struct Option
+{
+    std::string     Filter;                             // 名前に含まれる文字列.
+    uint32_t        Samples     = DEFAULT_SAMPLES;      // 計測回数.
+    double          MinTimeMs   = DEFAULT_MIN_TIME_MS;  // 1回の計測の最小時間.
+    bool            List        = false;                // 名前の一覧を出力するかどうか.
+};
+
+//-----------------------------------------------------------------------------
+// Global Variables
+//-----------------------------------------------------------------------------
+volatile float      g_SinkF = 0.0f;     // 最適化による処理の削除を防ぐための出力先.
+volatile uint64_t   g_SinkU = 0;        // 最適化による処理の削除を防ぐための出力先.
+
+//-----------------------------------------------------------------------------
+//      結果を使用済みにします.
+//-----------------------------------------------------------------------------
+inline void Consume(float value)
+{ g_SinkF = g_SinkF + value; }
+
+inline void Consume(uint64_t value)
+{ g_SinkU = g_SinkU ^ value; }
+
+//-----------------------------------------------------------------------------
+//      現在時刻をナノ秒で取得します.
+//-----------------------------------------------------------------------------
+inline double GetTimeNs()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+//-----------------------------------------------------------------------------
+//      ベンチマークを実行して結果を出力します.
+//-----------------------------------------------------------------------------
+void Run(const Benchmark& bench, const Option& option)
+{
+    // ウォームアップを兼ねて1回の計測で呼び出す回数を決める.
+    uint64_t calls = 1;
+    for(;;)
+    {
+        auto start = GetTimeNs();
+        for(uint64_t i=0; i<calls; ++i)
+        { bench.Func(); }
+        auto elapsed = GetTimeNs() - start;
+
+        if (elapsed >= option.MinTimeMs * 1e6 || calls >= (1ull << 30))
+        { break; }
+        calls *= 2;
+    }
+
+    std::vector<double> samples(option.Samples);
+    for(auto& sample : samples)
+    {
+        auto start = GetTimeNs();
+        for(uint64_t i=0; i<calls; ++i)
+        { bench.Func(); }
+        sample = (GetTimeNs() - start) / double(calls * bench.Items);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    printf("{\"name\":\"%s\",\"items\":%zu,\"calls\":%llu,\"samples\":%u,\"median_ns\":%.4f,\"min_ns\":%.4f,\"max_ns\":%.4f",
+        bench.Name.c_str(),
+        bench.Items,
+        (unsigned long long)calls,
+        option.Samples,
+        samples[samples.size() / 2],
+        samples.front(),
+        samples.back());
+
+    if (bench.Report)
+    { printf(",%s", bench.Report().c_str()); }
+
+    printf("}\n");
+    fflush(stdout);
+}
+
+//-----------------------------------------------------------------------------
+//      [a, b) の乱数配列を生成します.
+//-----------------------------------------------------------------------------
+std::vector<float> CreateRandomArray(size_t count, float a, float b, int seed = RANDOM_SEED)
+{
+    std::vector<float> result(count);
+    asdx::XorShiftX4 random(seed);
+    random.FillF32(result.data(), count, a, b);
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      乱数ベクトル配列を生成します.
+//-----------------------------------------------------------------------------
+std::vector<asdx::Vector3> CreateRandomVectors(size_t count, float range, int seed = RANDOM_SEED)
+{
+    auto values = CreateRandomArray(count * 3, -range, range, seed);
+    std::vector<asdx::Vector3> result(count);
+    for(size_t i=0; i<count; ++i)
+    { result[i] = asdx::Vector3(values[i * 3 + 0], values[i * 3 + 1], values[i * 3 + 2]); }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      乱数の剛体変換行列を生成します.
+//-----------------------------------------------------------------------------
+std::vector<asdx::Matrix> CreateRandomMatrices(size_t count, int seed = RANDOM_SEED)
+{
+    auto axis  = CreateRandomVectors(count, 1.0f, seed);
+    auto trans = CreateRandomVectors(count, 10.0f, seed + 1);
+    auto angle = CreateRandomArray(count, -asdx::F_PI, asdx::F_PI, seed + 2);
+
+    std::vector<asdx::Matrix> result(count);
+    for(size_t i=0; i<count; ++i)
+    {
+        auto a = asdx::Vector3::SafeNormalize(axis[i], asdx::Vector3(0.0f, 1.0f, 0.0f));
+        result[i] = asdx::Matrix::CreateFromAxisAngle(a, angle[i])
+                  * asdx::Matrix::CreateTranslation(trans[i].x, trans[i].y, trans[i].z);
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      格子状のメッシュを生成します.
+//-----------------------------------------------------------------------------
+asdx::ResMesh CreateGridMesh(uint32_t division)
+{
+    asdx::ResMesh mesh;
+    auto stride = division + 1;
+
+    for(auto y=0u; y<=division; ++y)
+    {
+        for(auto x=0u; x<=division; ++x)
+        {
+            auto u = float(x) / float(division);
+            auto v = float(y) / float(division);
+            auto h = 0.1f * sinf(u * 12.0f) * cosf(v * 9.0f);
+            mesh.Positions.push_back(asdx::Vector3(u, h, v));
+            mesh.TexCoords[0].push_back(asdx::Vector2(u, v));
+        }
+    }
+
+    for(auto y=0u; y<division; ++y)
+    {
+        for(auto x=0u; x<division; ++x)
+        {
+            auto i0 = y * stride + x;
+            auto i1 = i0 + 1;
+            auto i2 = i0 + stride;
+            auto i3 = i2 + 1;
+            mesh.Indices.insert(mesh.Indices.end(), { i0, i2, i1, i1, i2, i3 });
+        }
+    }
+
+    return mesh;
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュを複製した .glb をメモリ上に生成します.
+//-----------------------------------------------------------------------------
+std::vector<uint8_t> CreateGlbScene(const asdx::ResMesh& mesh, uint32_t meshCount)
+{
+    auto vertexCount = mesh.Positions.size();
+    auto indexCount  = mesh.Indices.size();
+
+    // 属性は POSITION, NORMAL, TANGENT, TEXCOORD_0, JOINTS_0, WEIGHTS_0 の順.
+    std::vector<uint8_t> tangents(vertexCount * 16);
+    std::vector<uint8_t> joints  (vertexCount * 8);
+    for(size_t i=0; i<vertexCount; ++i)
+    {
+        auto t = asdx::Vector4(mesh.Tangents[i], 1.0f);
+        uint16_t j[4] = { mesh.BoneIndices[i].x, mesh.BoneIndices[i].y, mesh.BoneIndices[i].z, mesh.BoneIndices[i].w };
+        memcpy(&tangents[i * 16], &t, 16);
+        memcpy(&joints  [i * 8],  j,  8);
+    }
+
+    struct Stream { const void* pData; size_t Size; uint32_t Type; const char* Name; };
+    const Stream streams[] = {
+        { mesh.Positions   .data(), vertexCount * 12, 5126, "VEC3" },
+        { mesh.Normals     .data(), vertexCount * 12, 5126, "VEC3" },
+        { tangents         .data(), vertexCount * 16, 5126, "VEC4" },
+        { mesh.TexCoords[0].data(), vertexCount * 8,  5126, "VEC2" },
+        { joints           .data(), vertexCount * 8,  5123, "VEC4" },
+        { mesh.BoneWeights .data(), vertexCount * 16, 5126, "VEC4" },
+        { mesh.Indices     .data(), indexCount  * 4,  5125, "SCALAR" },
+    };
+    static constexpr uint32_t STREAM_COUNT = uint32_t(sizeof(streams) / sizeof(streams[0]));
+
+    std::vector<uint8_t> bin;
+    std::string views, accessors, meshes;
+    char buf[256];
+    for(auto m=0u; m<meshCount; ++m)
+    {
+        for(auto s=0u; s<STREAM_COUNT; ++s)
+        {
+            auto id = m * STREAM_COUNT + s;
+            snprintf(buf, sizeof(buf), "%s{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu}",
+                (id == 0) ? "" : ",", bin.size(), streams[s].Size);
+            views += buf;
+            snprintf(buf, sizeof(buf), "%s{\"bufferView\":%u,\"componentType\":%u,\"count\":%zu,\"type\":\"%s\"}",
+                (id == 0) ? "" : ",", id, streams[s].Type, (s + 1 == STREAM_COUNT) ? indexCount : vertexCount, streams[s].Name);
+            accessors += buf;
+
+            auto offset = bin.size();
+            bin.resize(offset + streams[s].Size);
+            memcpy(&bin[offset], streams[s].pData, streams[s].Size);
+        }
+
+        auto a = m * STREAM_COUNT;
+        snprintf(buf, sizeof(buf), "%s{\"name\":\"grid%u\",\"primitives\":[{\"attributes\":{\"POSITION\":%u,\"NORMAL\":%u,"
+            "\"TANGENT\":%u,\"TEXCOORD_0\":%u,\"JOINTS_0\":%u,\"WEIGHTS_0\":%u},\"indices\":%u,\"material\":0}]}",
+            (m == 0) ? "" : ",", m, a, a + 1, a + 2, a + 3, a + 4, a + 5, a + 6);
+        meshes += buf;
+    }
+
+    snprintf(buf, sizeof(buf), "{\"asset\":{\"version\":\"2.0\"},\"buffers\":[{\"byteLength\":%zu}],", bin.size());
+    auto json = std::string(buf)
+        + "\"bufferViews\":[" + views + "],\"accessors\":[" + accessors + "],"
+        + "\"materials\":[{\"name\":\"grid\",\"pbrMetallicRoughness\":{\"roughnessFactor\":0.5}}],"
+        + "\"meshes\":[" + meshes + "]}";
+    while(json.size() % 4 != 0)
+    { json += ' '; }
+
+    // ヘッダー, JSON チャンク, BIN チャンクの順.
+    uint32_t header[5] = { 0x46546c67, 2, uint32_t(12 + 8 + json.size() + 8 + bin.size()), uint32_t(json.size()), 0x4e4f534a };
+    uint32_t binHeader[2] = { uint32_t(bin.size()), 0x004e4942 };
+
+    std::vector<uint8_t> result(header[2]);
+    auto ptr = result.data();
+    memcpy(ptr, header, sizeof(header));         ptr += sizeof(header);
+    memcpy(ptr, json.data(), json.size());       ptr += json.size();
+    memcpy(ptr, binHeader, sizeof(binHeader));   ptr += sizeof(binHeader);
+    memcpy(ptr, bin.data(), bin.size());
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュを複製した OBJ テキストを生成します.
+//-----------------------------------------------------------------------------
+std::string CreateObjText(const asdx::ResMesh& mesh, uint32_t meshCount)
+{
+    std::string result;
+    char buf[256];
+    auto vertexCount = uint32_t(mesh.Positions.size());
+
+    for(auto m=0u; m<meshCount; ++m)
+    {
+        snprintf(buf, sizeof(buf), "o grid%u\nusemtl material%u\n", m, m % 4);
+        result += buf;
+
+        for(size_t i=0; i<vertexCount; ++i)
+        {
+            auto& p = mesh.Positions[i];
+            auto& n = mesh.Normals[i];
+            auto& t = mesh.TexCoords[0][i];
+            snprintf(buf, sizeof(buf), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n",
+                p.x + float(m), p.y, p.z, t.x, t.y, n.x, n.y, n.z);
+            result += buf;
+        }
+
+        auto base = m * vertexCount + 1;
+        for(size_t i=0; i<mesh.Indices.size(); i+=3)
+        {
+            auto i0 = mesh.Indices[i + 0] + base;
+            auto i1 = mesh.Indices[i + 1] + base;
+            auto i2 = mesh.Indices[i + 2] + base;
+            snprintf(buf, sizeof(buf), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i0, i0, i0, i1, i1, i1, i2, i2, i2);
+            result += buf;
+        }
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      数学関数のベンチマークを登録します.
+//-----------------------------------------------------------------------------
+void RegisterMath(std::vector<Benchmark>& benches)
+{
+    using namespace asdx;
+
+    auto a   = std::make_shared<std::vector<Vector3>>(CreateRandomVectors(ITEM_COUNT, 1.0f, RANDOM_SEED));
+    auto b   = std::make_shared<std::vector<Vector3>>(CreateRandomVectors(ITEM_COUNT, 1.0f, RANDOM_SEED + 10));
+    auto out = std::make_shared<std::vector<Vector3>>(ITEM_COUNT);
+    auto m   = std::make_shared<std::vector<Matrix>>(CreateRandomMatrices(ITEM_COUNT));
+    auto mo  = std::make_shared<std::vector<Matrix>>(ITEM_COUNT);
+
+    benches.push_back({ "math/Vector3::Dot", ITEM_COUNT, [=]()
+    {
+        auto sum = 0.0f;
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { sum += Vector3::Dot((*a)[i], (*b)[i]); }
+        Consume(sum);
+    }});
+
+    benches.push_back({ "math/Vector3::Cross", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*out)[i] = Vector3::Cross((*a)[i], (*b)[i]); }
+        Consume((*out)[ITEM_COUNT - 1].x);
+    }});
+
+    benches.push_back({ "math/Vector3::Normalize", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*out)[i] = Vector3::Normalize((*a)[i]); }
+        Consume((*out)[ITEM_COUNT - 1].x);
+    }});
+
+    benches.push_back({ "math/Vector4::Dot", ITEM_COUNT, [=]()
+    {
+        auto sum = 0.0f;
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { sum += Vector4::Dot((*m)[i].row[0], (*m)[i].row[3]); }
+        Consume(sum);
+    }});
+
+    benches.push_back({ "math/Vector3::Transform", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*out)[i] = Vector3::Transform((*a)[i], (*m)[i]); }
+        Consume((*out)[ITEM_COUNT - 1].x);
+    }});
+
+    benches.push_back({ "math/Vector3::TransformArray", ITEM_COUNT, [=]()
+    {
+        Vector3::TransformArray(a->data(), sizeof(Vector3), a->size(), (*m)[0], out->data(), sizeof(Vector3));
+        Consume((*out)[ITEM_COUNT - 1].x);
+    }});
+
+    benches.push_back({ "math/Vector3::TransformCoordArray", ITEM_COUNT, [=]()
+    {
+        Vector3::TransformCoordArray(a->data(), sizeof(Vector3), a->size(), (*m)[0], out->data(), sizeof(Vector3));
+        Consume((*out)[ITEM_COUNT - 1].x);
+    }});
+
+    benches.push_back({ "math/Matrix::Multiply", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*mo)[i] = (*m)[i] * (*m)[(i + 1) % ITEM_COUNT]; }
+        Consume((*mo)[ITEM_COUNT - 1]._11);
+    }});
+
+    benches.push_back({ "math/Matrix::Invert", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*mo)[i] = Matrix::Invert((*m)[i]); }
+        Consume((*mo)[ITEM_COUNT - 1]._11);
+    }});
+
+    benches.push_back({ "math/Matrix::InvertAffine", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*mo)[i] = Matrix::InvertAffine((*m)[i]); }
+        Consume((*mo)[ITEM_COUNT - 1]._11);
+    }});
+
+    benches.push_back({ "math/Matrix::InvertRigid", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*mo)[i] = Matrix::InvertRigid((*m)[i]); }
+        Consume((*mo)[ITEM_COUNT - 1]._11);
+    }});
+
+    auto m34  = std::make_shared<std::vector<Matrix34>>();
+    auto m34o = std::make_shared<std::vector<Matrix34>>(ITEM_COUNT);
+    for(auto& itr : *m)
+    { m34->push_back(Matrix34(itr)); }
+
+    benches.push_back({ "math/Matrix34::Multiply", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { Matrix34::Multiply((*m34)[i], (*m34)[(i + 1) % ITEM_COUNT], (*m34o)[i]); }
+        Consume((*m34o)[ITEM_COUNT - 1]._11);
+    }});
+
+    auto q  = std::make_shared<std::vector<Quaternion>>(ITEM_COUNT);
+    auto qo = std::make_shared<std::vector<Quaternion>>(ITEM_COUNT);
+    {
+        auto angle = CreateRandomArray(ITEM_COUNT, -F_PI, F_PI);
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*q)[i] = Quaternion::CreateFromAxisAngle(Vector3::SafeNormalize((*a)[i], Vector3(0.0f, 0.0f, 1.0f)), angle[i]); }
+    }
+
+    benches.push_back({ "math/Quaternion::Multiply", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*qo)[i] = Quaternion::Multiply((*q)[i], (*q)[(i + 1) % ITEM_COUNT]); }
+        Consume((*qo)[ITEM_COUNT - 1].w);
+    }});
+
+    benches.push_back({ "math/Quaternion::Slerp", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*qo)[i] = Quaternion::Slerp((*q)[i], (*q)[(i + 1) % ITEM_COUNT], 0.3f); }
+        Consume((*qo)[ITEM_COUNT - 1].w);
+    }});
+
+    auto f  = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, -1000.0f, 1000.0f));
+    auto h  = std::make_shared<std::vector<half>>(ITEM_COUNT);
+    auto fo = std::make_shared<std::vector<float>>(ITEM_COUNT);
+
+    benches.push_back({ "math/ToHalfArray", ITEM_COUNT, [=]()
+    {
+        ToHalfArray(f->data(), f->size(), h->data());
+        Consume(uint64_t((*h)[ITEM_COUNT - 1]));
+    }});
+
+    benches.push_back({ "math/ToFloatArray", ITEM_COUNT, [=]()
+    {
+        ToFloatArray(h->data(), h->size(), fo->data());
+        Consume((*fo)[ITEM_COUNT - 1]);
+    }});
+
+    auto u = std::make_shared<std::vector<uint32_t>>(ITEM_COUNT);
+
+    benches.push_back({ "random/XorShift::GetAsU32", ITEM_COUNT, [=]()
+    {
+        static XorShift random(RANDOM_SEED);
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*u)[i] = random.GetAsU32(); }
+        Consume(uint64_t((*u)[ITEM_COUNT - 1]));
+    }});
+
+    benches.push_back({ "random/XorShiftX4::FillU32", ITEM_COUNT, [=]()
+    {
+        static XorShiftX4 random(RANDOM_SEED);
+        random.FillU32(u->data(), ITEM_COUNT);
+        Consume(uint64_t((*u)[ITEM_COUNT - 1]));
+    }});
+
+    benches.push_back({ "random/PCG::GetAsU32", ITEM_COUNT, [=]()
+    {
+        static PCG random(RANDOM_SEED);
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*u)[i] = random.GetAsU32(); }
+        Consume(uint64_t((*u)[ITEM_COUNT - 1]));
+    }});
+
+    benches.push_back({ "random/PCGX4::FillU32", ITEM_COUNT, [=]()
+    {
+        static PCGX4 random(RANDOM_SEED);
+        random.FillU32(u->data(), ITEM_COUNT);
+        Consume(uint64_t((*u)[ITEM_COUNT - 1]));
+    }});
+}
+
+//-----------------------------------------------------------------------------
+//      近似関数のベンチマークを登録します.
+//-----------------------------------------------------------------------------
+void RegisterFastMath(std::vector<Benchmark>& benches)
+{
+    auto angle = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, -100.0f, 100.0f));
+    auto unit  = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, -1.0f, 1.0f));
+    auto pos   = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, 1e-3f, 1e3f));
+    auto expo  = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, -20.0f, 20.0f));
+    auto s     = std::make_shared<std::vector<float>>(ITEM_COUNT);
+    auto c     = std::make_shared<std::vector<float>>(ITEM_COUNT);
+
+    benches.push_back({ "fast/std::sin+cos", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        {
+            (*s)[i] = sinf((*angle)[i]);
+            (*c)[i] = cosf((*angle)[i]);
+        }
+        Consume((*s)[ITEM_COUNT - 1] + (*c)[ITEM_COUNT - 1]);
+    }});
+
+    benches.push_back({ "fast/SinCos", ITEM_COUNT, [=]()
+    {
+        asdx::fast::SinCos(angle->data(), s->data(), c->data(), ITEM_COUNT);
+        Consume((*s)[ITEM_COUNT - 1] + (*c)[ITEM_COUNT - 1]);
+    }});
+
+    benches.push_back({ "fast/SinCosEst", ITEM_COUNT, [=]()
+    {
+        asdx::fast::SinCosEst(angle->data(), s->data(), c->data(), ITEM_COUNT);
+        Consume((*s)[ITEM_COUNT - 1] + (*c)[ITEM_COUNT - 1]);
+    }});
+
+    // 1入力の関数は同じ形で登録する.
+    struct UnaryEntry
+    {
+        const char*                                     Name;
+        std::shared_ptr<std::vector<float>>             Input;
+        std::function<void(const float*, float*, size_t)> Func;
+    };
+
+    UnaryEntry entries[] = {
+        { "fast/std::1/sqrt",   pos,  [](const float* p, float* r, size_t n) { for(size_t i=0; i<n; ++i) { r[i] = 1.0f / sqrtf(p[i]); } } },
+        { "fast/Rsqrt",         pos,  [](const float* p, float* r, size_t n) { asdx::fast::Rsqrt(p, r, n); } },
+        { "fast/RsqrtEst",      pos,  [](const float* p, float* r, size_t n) { asdx::fast::RsqrtEst(p, r, n); } },
+        { "fast/std::exp2",     expo, [](const float* p, float* r, size_t n) { for(size_t i=0; i<n; ++i) { r[i] = exp2f(p[i]); } } },
+        { "fast/Exp2",          expo, [](const float* p, float* r, size_t n) { asdx::fast::Exp2(p, r, n); } },
+        { "fast/Exp2Est",       expo, [](const float* p, float* r, size_t n) { asdx::fast::Exp2Est(p, r, n); } },
+        { "fast/std::log2",     pos,  [](const float* p, float* r, size_t n) { for(size_t i=0; i<n; ++i) { r[i] = log2f(p[i]); } } },
+        { "fast/Log2",          pos,  [](const float* p, float* r, size_t n) { asdx::fast::Log2(p, r, n); } },
+        { "fast/Log2Est",       pos,  [](const float* p, float* r, size_t n) { asdx::fast::Log2Est(p, r, n); } },
+        { "fast/std::acos",     unit, [](const float* p, float* r, size_t n) { for(size_t i=0; i<n; ++i) { r[i] = acosf(p[i]); } } },
+        { "fast/Acos",          unit, [](const float* p, float* r, size_t n) { asdx::fast::Acos(p, r, n); } },
+        { "fast/AcosEst",       unit, [](const float* p, float* r, size_t n) { asdx::fast::AcosEst(p, r, n); } },
+    };
+
+    for(auto& entry : entries)
+    {
+        auto input = entry.Input;
+        auto func  = entry.Func;
+        benches.push_back({ entry.Name, ITEM_COUNT, [=]()
+        {
+            func(input->data(), s->data(), ITEM_COUNT);
+            Consume((*s)[ITEM_COUNT - 1]);
+        }});
+    }
+
+    benches.push_back({ "fast/std::atan2", ITEM_COUNT, [=]()
+    {
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { (*s)[i] = atan2f((*unit)[i], (*angle)[i]); }
+        Consume((*s)[ITEM_COUNT - 1]);
+    }});
+
+    benches.push_back({ "fast/Atan2", ITEM_COUNT, [=]()
+    {
+        asdx::fast::Atan2(unit->data(), angle->data(), s->data(), ITEM_COUNT);
+        Consume((*s)[ITEM_COUNT - 1]);
+    }});
+
+    benches.push_back({ "fast/Atan2Est", ITEM_COUNT, [=]()
+    {
+        asdx::fast::Atan2Est(unit->data(), angle->data(), s->data(), ITEM_COUNT);
+        Consume((*s)[ITEM_COUNT - 1]);
+    }});
+}
+
+//-----------------------------------------------------------------------------
+//      ハッシュとメモリ確保のベンチマークを登録します.
+//-----------------------------------------------------------------------------
+void RegisterHash(std::vector<Benchmark>& benches)
+{
+    static constexpr size_t LARGE_SIZE = 64 * 1024;
+    static constexpr size_t KEY_SIZE   = 16;
+
+    auto data = std::make_shared<std::vector<uint8_t>>(LARGE_SIZE);
+    {
+        asdx::XorShift random(RANDOM_SEED);
+        for(auto& itr : *data)
+        { itr = uint8_t(random.GetAsU32()); }
+    }
+
+    // 大きなバッファは1バイトあたり, 短いキーは1キーあたりの時間を計測する.
+    benches.push_back({ "hash/CalcHash32/64KiB", LARGE_SIZE, [=]()
+    { Consume(uint64_t(asdx::CalcHash32(data->data(), uint32_t(LARGE_SIZE)))); }});
+
+    benches.push_back({ "hash/CalcHash64/64KiB", LARGE_SIZE, [=]()
+    { Consume(asdx::CalcHash64(data->data(), uint64_t(LARGE_SIZE))); }});
+
+    benches.push_back({ "hash/CalcFnv1_32/64KiB", LARGE_SIZE, [=]()
+    { Consume(uint64_t(asdx::CalcFnv1(data->data(), uint32_t(LARGE_SIZE)))); }});
+
+    benches.push_back({ "hash/CalcFnv1_64/64KiB", LARGE_SIZE, [=]()
+    { Consume(asdx::CalcFnv1(data->data(), uint64_t(LARGE_SIZE))); }});
+
+    auto keyCount = LARGE_SIZE / KEY_SIZE;
+
+    benches.push_back({ "hash/CalcHash32/16B", keyCount, [=]()
+    {
+        uint64_t result = 0;
+        for(size_t i=0; i<keyCount; ++i)
+        { result ^= asdx::CalcHash32(data->data() + i * KEY_SIZE, uint32_t(KEY_SIZE)); }
+        Consume(result);
+    }});
+
+    benches.push_back({ "hash/CalcHash64/16B", keyCount, [=]()
+    {
+        uint64_t result = 0;
+        for(size_t i=0; i<keyCount; ++i)
+        { result ^= asdx::CalcHash64(data->data() + i * KEY_SIZE, uint64_t(KEY_SIZE)); }
+        Consume(result);
+    }});
+
+    benches.push_back({ "hash/CalcFnv1_32/16B", keyCount, [=]()
+    {
+        uint64_t result = 0;
+        for(size_t i=0; i<keyCount; ++i)
+        { result ^= asdx::CalcFnv1(data->data() + i * KEY_SIZE, uint32_t(KEY_SIZE)); }
+        Consume(result);
+    }});
+
+    auto heap = std::make_shared<asdx::FrameHeap>();
+    heap->Init(ITEM_COUNT * 64);
+
+    benches.push_back({ "memory/FrameHeap::Alloc", ITEM_COUNT, [=]()
+    {
+        heap->Reset();
+        uint64_t result = 0;
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        { result ^= uint64_t(reinterpret_cast<uintptr_t>(heap->Alloc(64))); }
+        Consume(result);
+    }});
+}
+
+//-----------------------------------------------------------------------------
+//      モデルデータ処理のベンチマークを登録します.
+//-----------------------------------------------------------------------------
+void RegisterModel(std::vector<Benchmark>& benches)
+{
+    static constexpr uint32_t GRID_DIVISION       = 128;
+    static constexpr uint32_t LARGE_GRID_DIVISION = 724;    // 2 * 724 * 724 = 1048352 三角形.
+
+    auto source = std::make_shared<asdx::ResMesh>(CreateGridMesh(GRID_DIVISION));
+    auto mesh   = std::make_shared<asdx::ResMesh>();
+    auto vertexCount = source->Positions.size();
+
+    benches.push_back({ "model/CalcNormals", vertexCount, [=]()
+    {
+        mesh->Positions = source->Positions;
+        mesh->Indices   = source->Indices;
+        mesh->Normals.clear();
+        asdx::CalcNormals(*mesh);
+        Consume(mesh->Normals[vertexCount - 1].y);
+    }});
+
+    auto withNormal = std::make_shared<asdx::ResMesh>(*source);
+    asdx::CalcNormals(*withNormal);
+
+    benches.push_back({ "model/CalcTangents", vertexCount, [=]()
+    {
+        mesh->Positions    = withNormal->Positions;
+        mesh->Normals      = withNormal->Normals;
+        mesh->TexCoords[0] = withNormal->TexCoords[0];
+        mesh->Indices      = withNormal->Indices;
+        mesh->Tangents.clear();
+        mesh->Bitangents.clear();
+        asdx::CalcTangents(*mesh);
+        Consume(mesh->Tangents[vertexCount - 1].x);
+    }});
+
+    // 約100万三角形のメッシュで, シングルスレッドとマルチスレッドを比較する.
+    auto large       = std::make_shared<asdx::ResMesh>(CreateGridMesh(LARGE_GRID_DIVISION));
+    auto largeMesh   = std::make_shared<asdx::ResMesh>(*large);
+    auto largeCount  = large->Indices.size() / 3;
+    asdx::CalcNormals(*large);
+
+    for(auto threads : { 1u, 0u })
+    {
+        auto suffix = std::string((threads == 1) ? "/1t" : "/mt");
+
+        benches.push_back({ "model/CalcNormals/1M" + suffix, largeCount, [=]()
+        {
+            asdx::CalcNormals(*largeMesh, threads);
+            Consume(largeMesh->Normals.back().y);
+        }});
+
+        benches.push_back({ "model/CalcTangents/1M" + suffix, largeCount, [=]()
+        {
+            largeMesh->Normals = large->Normals;
+            asdx::CalcTangents(*largeMesh, threads);
+            Consume(largeMesh->Tangents.back().x);
+        }});
+    }
+
+    // スキニング用にボーンの重みを設定する.
+    static constexpr uint32_t BONE_COUNT = 64;
+    auto skinned = std::make_shared<asdx::ResMesh>(*withNormal);
+    asdx::CalcTangents(*skinned);
+    for(size_t i=0; i<vertexCount; ++i)
+    {
+        auto b = uint16_t(i % BONE_COUNT);
+        skinned->BoneIndices.push_back(asdx::ResBoneIndex(
+            b, uint16_t((b + 1) % BONE_COUNT), uint16_t((b + 2) % BONE_COUNT), uint16_t((b + 3) % BONE_COUNT)));
+        skinned->BoneWeights.push_back(asdx::Vector4(0.4f, 0.3f, 0.2f, 0.1f));
+    }
+
+    auto palette = std::make_shared<std::vector<asdx::Matrix34>>();
+    for(auto& itr : CreateRandomMatrices(BONE_COUNT))
+    { palette->push_back(asdx::Matrix34(itr)); }
+
+    auto positions = std::make_shared<std::vector<asdx::Vector3>>(vertexCount);
+    auto normals   = std::make_shared<std::vector<asdx::Vector3>>(vertexCount);
+    auto tbn       = std::make_shared<std::vector<uint32_t>>(vertexCount);
+
+    benches.push_back({ "model/SkinVertices", vertexCount, [=]()
+    {
+        asdx::SkinningTarget target;
+        target.pPositions  = positions->data();
+        target.pNormals    = normals->data();
+        target.pEncodedTBN = tbn->data();
+        asdx::SkinVertices(palette->data(), BONE_COUNT, asdx::GetSkinningSource(*skinned), target);
+        Consume((*positions)[vertexCount - 1].x);
+    }});
+
+    // バイナリモデルの読み込み. ファイルは最初の計測時に作成し, 終了時に削除する.
+    struct ModelFile
+    {
+        std::string Path;
+        bool        Created = false;
+        ~ModelFile()
+        {
+            if (Created)
+            { remove(Path.c_str()); }
+        }
+    };
+
+    static constexpr uint32_t MODEL_MESH_COUNT = 8;
+    auto model = std::make_shared<asdx::ResModel>();
+    model->Meshes.assign(MODEL_MESH_COUNT, *skinned);
+    auto modelFile = std::make_shared<ModelFile>();
+    modelFile->Path = "asdx_bench_model.amdl";
+
+    auto prepare = [=]()
+    {
+        if (!modelFile->Created)
+        { modelFile->Created = asdx::SaveResModel(modelFile->Path.c_str(), *model); }
+    };
+
+    benches.push_back({ "model/ResModelFile::Open/View", vertexCount * MODEL_MESH_COUNT, [=]()
+    {
+        prepare();
+        asdx::ResModelFile file;
+        file.Open(modelFile->Path.c_str());
+        uint64_t count = 0;
+        for(auto i=0u; i<file.GetMeshCount(); ++i)
+        { count += file.GetMesh(i).Positions.size(); }
+        Consume(count);
+    }});
+
+    benches.push_back({ "model/ResModelFile::Open/CopyTo", vertexCount * MODEL_MESH_COUNT, [=]()
+    {
+        prepare();
+        asdx::ResModelFile file;
+        file.Open(modelFile->Path.c_str());
+        asdx::ResModel result;
+        file.CopyTo(result);
+        Consume(uint64_t(result.Meshes.size()));
+    }});
+
+    // 頂点キャッシュ・フェッチの最適化. 入力は三角形の順序を乱数で崩した格子メッシュ.
+    auto shuffled = std::make_shared<asdx::ResMesh>(*withNormal);
+    {
+        auto triangleCount = shuffled->Indices.size() / 3;
+        auto keys  = CreateRandomArray(triangleCount, 0.0f, 1.0f, RANDOM_SEED + 30);
+        std::vector<uint32_t> order(triangleCount);
+        for(size_t i=0; i<triangleCount; ++i)
+        { order[i] = uint32_t(i); }
+        std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return keys[lhs] < keys[rhs]; });
+
+        std::vector<uint32_t> indices;
+        indices.reserve(shuffled->Indices.size());
+        for(auto t : order)
+        { indices.insert(indices.end(), &withNormal->Indices[t * 3], &withNormal->Indices[t * 3] + 3); }
+        shuffled->Indices.swap(indices);
+    }
+    auto triangleCount = shuffled->Indices.size() / 3;
+
+    // 最適化前後の ACMR / ATVR を計測結果に付け加える.
+    auto formatStats = [](const char* tag, const asdx::VertexCacheStats& stats)
+    {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "\"%s_acmr\":%.4f,\"%s_atvr\":%.4f", tag, stats.ACMR, tag, stats.ATVR);
+        return std::string(buf);
+    };
+
+    auto cacheOptimized = std::make_shared<asdx::ResMesh>(*shuffled);
+    asdx::OptimizeVertexCache(*cacheOptimized);
+
+    benches.push_back({ "model/OptimizeVertexCache", triangleCount, [=]()
+    {
+        mesh->Positions = shuffled->Positions;
+        mesh->Indices   = shuffled->Indices;
+        asdx::OptimizeVertexCache(*mesh);
+        Consume(uint64_t(mesh->Indices[0]));
+    }, [=]()
+    {
+        return formatStats("before", asdx::AnalyzeVertexCache(*shuffled)) + ","
+             + formatStats("after",  asdx::AnalyzeVertexCache(*cacheOptimized));
+    }});
+
+    benches.push_back({ "model/OptimizeOverdraw", triangleCount, [=]()
+    {
+        mesh->Positions = cacheOptimized->Positions;
+        mesh->Indices   = cacheOptimized->Indices;
+        asdx::OptimizeOverdraw(*mesh);
+        Consume(uint64_t(mesh->Indices[0]));
+    }, [=]()
+    {
+        asdx::ResMesh result;
+        result.Positions = cacheOptimized->Positions;
+        result.Indices   = cacheOptimized->Indices;
+        asdx::OptimizeOverdraw(result);
+        return formatStats("before", asdx::AnalyzeVertexCache(*cacheOptimized)) + ","
+             + formatStats("after",  asdx::AnalyzeVertexCache(result));
+    }});
+
+    benches.push_back({ "model/OptimizeVertexFetch", vertexCount, [=]()
+    {
+        *mesh = *cacheOptimized;
+        asdx::OptimizeVertexFetch(*mesh);
+        Consume(mesh->Positions[vertexCount - 1].x);
+    }});
+
+    // メッシュレット分割. 単体のメッシュと, 複数メッシュのモデルをメッシュ単位で並列に分割する.
+    benches.push_back({ "model/BuildMeshlets", triangleCount, [=]()
+    {
+        asdx::ResMeshlets meshlets;
+        asdx::BuildMeshlets(*cacheOptimized, asdx::MeshletDesc(), meshlets);
+        Consume(uint64_t(meshlets.Meshlets.size()));
+    }, [=]()
+    {
+        asdx::ResMeshlets meshlets;
+        asdx::BuildMeshlets(*cacheOptimized, asdx::MeshletDesc(), meshlets);
+
+        char buf[128];
+        snprintf(buf, sizeof(buf), "\"meshlets\":%zu,\"avg_vertices\":%.2f,\"avg_triangles\":%.2f",
+            meshlets.Meshlets.size(),
+            double(meshlets.VertexIndices.size()) / double(meshlets.Meshlets.size()),
+            double(meshlets.Triangles.size()) / double(meshlets.Meshlets.size()));
+        return std::string(buf);
+    }});
+
+    auto meshletModel = std::make_shared<asdx::ResModel>();
+    meshletModel->Meshes.assign(MODEL_MESH_COUNT, *cacheOptimized);
+
+    for(auto threads : { 1u, 0u })
+    {
+        auto name = std::string("model/BuildMeshlets(ResModel)") + ((threads == 1) ? "/1t" : "/mt");
+        benches.push_back({ name, triangleCount * MODEL_MESH_COUNT, [=]()
+        {
+            std::vector<asdx::ResMeshlets> meshlets;
+            asdx::BuildMeshlets(*meshletModel, asdx::MeshletDesc(), meshlets, threads);
+            Consume(uint64_t(meshlets.back().Meshlets.size()));
+        }});
+    }
+
+    // 簡略化. 三角形数を1/4にする場合と, LOD チェインの構築.
+    benches.push_back({ "model/SimplifyMesh/25%", triangleCount, [=]()
+    {
+        asdx::SimplifyDesc desc;
+        desc.TargetTriangleCount = uint32_t(triangleCount / 4);
+        std::vector<uint32_t> indices;
+        Consume(asdx::SimplifyMesh(*withNormal, desc, indices));
+    }, [=]()
+    {
+        asdx::SimplifyDesc desc;
+        desc.TargetTriangleCount = uint32_t(triangleCount / 4);
+        std::vector<uint32_t> indices;
+        auto error = asdx::SimplifyMesh(*withNormal, desc, indices);
+
+        char buf[128];
+        snprintf(buf, sizeof(buf), "\"triangles\":%zu,\"error\":%.6f", indices.size() / 3, error);
+        return std::string(buf);
+    }});
+
+    benches.push_back({ "model/BuildLODChain", triangleCount, [=]()
+    {
+        std::vector<asdx::ResMeshLOD> lods;
+        asdx::BuildLODChain(*withNormal, asdx::LODChainDesc(), lods);
+        Consume(lods.back().Error);
+    }, [=]()
+    {
+        std::vector<asdx::ResMeshLOD> lods;
+        asdx::BuildLODChain(*withNormal, asdx::LODChainDesc(), lods);
+
+        std::string result = "\"levels\":[";
+        for(size_t i=0; i<lods.size(); ++i)
+        {
+            char buf[128];
+            snprintf(buf, sizeof(buf), "%s{\"triangles\":%zu,\"error\":%.6f}",
+                (i == 0) ? "" : ",", lods[i].Indices.size() / 3, lods[i].Error);
+            result += buf;
+        }
+        result += "]";
+        return result;
+    }});
+
+    // 頂点統合. インデックスを展開したトライアングルスープを入力とします.
+    auto soup = std::make_shared<asdx::ResMesh>();
+    {
+        auto count = withNormal->Indices.size();
+        soup->Positions   .resize(count);
+        soup->Normals     .resize(count);
+        soup->TexCoords[0].resize(count);
+        for(size_t i=0; i<count; ++i)
+        {
+            auto v = withNormal->Indices[i];
+            soup->Positions   [i] = withNormal->Positions   [v];
+            soup->Normals     [i] = withNormal->Normals     [v];
+            soup->TexCoords[0][i] = withNormal->TexCoords[0][v];
+        }
+    }
+    auto soupVertexCount = soup->Positions.size();
+
+    for(auto epsilon : { 0.0f, 1e-4f })
+    {
+        for(auto threads : { 1u, 0u })
+        {
+            auto name = std::string("model/WeldVertices")
+                + ((epsilon > 0.0f) ? "/epsilon" : "")
+                + ((threads == 1) ? "/1t" : "/mt");
+            benches.push_back({ name, soupVertexCount, [=]()
+            {
+                asdx::WeldDesc desc;
+                desc.Epsilon = epsilon;
+                std::vector<uint32_t> remap;
+                Consume(uint64_t(asdx::GenerateVertexRemap(*soup, desc, remap, threads)));
+            }, [=]()
+            {
+                asdx::WeldDesc desc;
+                desc.Epsilon = epsilon;
+                std::vector<uint32_t> remap;
+                auto count = asdx::GenerateVertexRemap(*soup, desc, remap, threads);
+
+                char buf[128];
+                snprintf(buf, sizeof(buf), "\"input_vertices\":%zu,\"unique_vertices\":%u", soupVertexCount, count);
+                return std::string(buf);
+            }});
+        }
+    }
+
+    // 頂点ストリームの量子化. 非圧縮の頂点サイズとの比率も出力する.
+    auto floatBytes = vertexCount * (sizeof(asdx::Vector3) * 3 + sizeof(asdx::Vector2)
+        + sizeof(asdx::ResBoneIndex) + sizeof(asdx::Vector4));
+
+    for(auto interleaved : { true, false })
+    {
+        auto name = std::string("model/PackVertices") + (interleaved ? "/interleaved" : "/split");
+        benches.push_back({ name, vertexCount, [=]()
+        {
+            asdx::VertexPackDesc desc;
+            desc.Interleaved = interleaved;
+            asdx::PackedVertices packed;
+            asdx::PackVertices(*skinned, desc, packed);
+            Consume(uint64_t(packed.Streams[0].Data[0]));
+        }, [=]()
+        {
+            asdx::VertexPackDesc desc;
+            desc.Interleaved = interleaved;
+            asdx::PackedVertices packed;
+            asdx::PackVertices(*skinned, desc, packed);
+
+            char buf[128];
+            snprintf(buf, sizeof(buf), "\"float_bytes\":%zu,\"packed_bytes\":%zu,\"ratio\":%.2f",
+                floatBytes, packed.GetSize(), double(floatBytes) / double(packed.GetSize()));
+            return std::string(buf);
+        }});
+    }
+
+    // glTF の読み込み. 1.6万頂点のメッシュを複製したシーンを使用する.
+    static constexpr uint32_t GLTF_MESH_COUNT = 16;
+    auto glb = std::make_shared<std::vector<uint8_t>>(CreateGlbScene(*skinned, GLTF_MESH_COUNT));
+
+    for(auto threads : { 1u, 0u })
+    {
+        auto name = std::string("model/LoadGltf") + ((threads == 1) ? "/1t" : "/mt");
+        benches.push_back({ name, vertexCount * GLTF_MESH_COUNT, [=]()
+        {
+            asdx::ResModel model;
+            asdx::LoadGltf(glb->data(), glb->size(), nullptr, model, threads);
+            Consume(model.Meshes.back().Positions.back().x);
+        }, [=]()
+        {
+            char buf[128];
+            snprintf(buf, sizeof(buf), "\"meshes\":%u,\"file_bytes\":%zu", GLTF_MESH_COUNT, glb->size());
+            return std::string(buf);
+        }});
+    }
+
+    // OBJ の読み込み. 要素数はテキストのバイト数.
+    static constexpr uint32_t OBJ_MESH_COUNT = 8;
+    auto objText = std::make_shared<std::string>(CreateObjText(*withNormal, OBJ_MESH_COUNT));
+
+    for(auto threads : { 1u, 0u })
+    {
+        auto name = std::string("model/LoadObj") + ((threads == 1) ? "/1t" : "/mt");
+        benches.push_back({ name, objText->size(), [=]()
+        {
+            asdx::ResModel model;
+            asdx::LoadObj(objText->data(), objText->size(), nullptr, model, threads);
+            Consume(model.Meshes.back().Positions.back().x);
+        }, [=]()
+        {
+            asdx::ResModel model;
+            asdx::LoadObj(objText->data(), objText->size(), nullptr, model, threads);
+
+            size_t vertices = 0;
+            for(auto& mesh : model.Meshes)
+            { vertices += mesh.Positions.size(); }
+
+            char buf[128];
+            snprintf(buf, sizeof(buf), "\"bytes\":%zu,\"meshes\":%zu,\"vertices\":%zu",
+                objText->size(), model.Meshes.size(), vertices);
+            return std::string(buf);
+        }});
+    }
+
+    // メッシュの BVH 構築. 要素数は三角形数.
+    for(auto threads : { 1u, 0u })
+    {
+        auto name = std::string("model/MeshBVH/Build") + ((threads == 1) ? "/1t" : "/mt");
+        benches.push_back({ name, withNormal->Indices.size() / 3, [=]()
+        {
+            asdx::MeshBVH bvh;
+            bvh.Build(*withNormal, threads);
+            Consume(uint64_t(bvh.GetNodes().size()));
+        }});
+    }
+
+    // メッシュの BVH 探索. 境界箱の外側から内側の点に向けてレイを飛ばす.
+    auto meshBVH = std::make_shared<asdx::MeshBVH>();
+    meshBVH->Build(*withNormal);
+
+    auto rays = std::make_shared<std::vector<asdx::Ray>>(ITEM_COUNT);
+    {
+        auto box     = meshBVH->GetBounds();
+        auto center  = box.GetCenter();
+        auto extent  = asdx::Vector3::Distance(box.Min, box.Max);
+        auto origins = CreateRandomVectors(ITEM_COUNT, 1.0f, RANDOM_SEED);
+        auto targets = CreateRandomVectors(ITEM_COUNT, 1.0f, RANDOM_SEED + 10);
+        for(size_t i=0; i<ITEM_COUNT; ++i)
+        {
+            auto target = center + targets[i] * (extent * 0.25f);
+            (*rays)[i].Origin    = center + asdx::Vector3::Normalize(origins[i]) * extent;
+            (*rays)[i].Direction = target - (*rays)[i].Origin;
+        }
+    }
+
+    benches.push_back({ "model/MeshBVH/Intersect", ITEM_COUNT, [=]()
+    {
+        asdx::RayHit hit;
+        auto sum = 0.0f;
+        for(auto& ray : *rays)
+        {
+            if (meshBVH->Intersect(ray, hit))
+            { sum += hit.Distance; }
+        }
+        Consume(sum);
+    }, [=]()
+    {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "\"triangles\":%zu,\"nodes\":%zu",
+            meshBVH->GetTriangleCount(), meshBVH->GetNodes().size());
+        return std::string(buf);
+    }});
+
+    benches.push_back({ "model/MeshBVH/Occluded", ITEM_COUNT, [=]()
+    {
+        uint64_t count = 0;
+        for(auto& ray : *rays)
+        { count += meshBVH->Occluded(ray) ? 1 : 0; }
+        Consume(count);
+    }});
+
+    benches.push_back({ "model/MeshBVH/Packet4", ITEM_COUNT, [=]()
+    {
+        asdx::RayPacket4 packet;
+        asdx::RayHit     hits[4];
+        uint64_t mask = 0;
+        for(size_t i=0; i<ITEM_COUNT; i+=4)
+        {
+            for(auto j=0u; j<4; ++j)
+            { packet.Set(j, (*rays)[i + j]); }
+            mask += meshBVH->Intersect(packet, hits);
+        }
+        Consume(mask);
+    }});
+
+    benches.push_back({ "model/MeshBVH/Packet8", ITEM_COUNT, [=]()
+    {
+        asdx::RayPacket8 packet;
+        asdx::RayHit     hits[8];
+        uint64_t mask = 0;
+        for(size_t i=0; i<ITEM_COUNT; i+=8)
+        {
+            for(auto j=0u; j<8; ++j)
+            { packet.Set(j, (*rays)[i + j]); }
+            mask += meshBVH->Intersect(packet, hits);
+        }
+        Consume(mask);
+    }});
+
+    benches.push_back({ "model/MeshBVH/ClosestPoint", ITEM_COUNT, [=]()
+    {
+        asdx::ClosestPoint result;
+        auto sum = 0.0f;
+        for(auto& ray : *rays)
+        {
+            if (meshBVH->FindClosestPoint(ray.Origin, FLT_MAX, result))
+            { sum += result.Distance; }
+        }
+        Consume(sum);
+    }});
+
+    // 球と箱の視錐台カリング.
+    auto view  = asdx::Matrix::CreateLookAt(asdx::Vector3(0.0f, 0.0f, -50.0f), asdx::Vector3(0.0f, 0.0f, 0.0f), asdx::Vector3(0.0f, 1.0f, 0.0f));
+    auto proj  = asdx::Matrix::CreatePerspectiveFieldOfView(asdx::F_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+    auto planes = std::make_shared<std::vector<asdx::Vector4>>(asdx::CULLING_PLANE_COUNT);
+    asdx::CalcFrustumPlanes(view, proj, planes->data());
+
+    auto cx = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, -100.0f, 100.0f, RANDOM_SEED + 20));
+    auto cy = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, -100.0f, 100.0f, RANDOM_SEED + 21));
+    auto cz = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, -100.0f, 100.0f, RANDOM_SEED + 22));
+    auto r  = std::make_shared<std::vector<float>>(CreateRandomArray(ITEM_COUNT, 0.5f, 5.0f, RANDOM_SEED + 23));
+    auto mx = std::make_shared<std::vector<float>>(ITEM_COUNT);
+    auto my = std::make_shared<std::vector<float>>(ITEM_COUNT);
+    auto mz = std::make_shared<std::vector<float>>(ITEM_COUNT);
+    for(size_t i=0; i<ITEM_COUNT; ++i)
+    {
+        (*mx)[i] = (*cx)[i] + (*r)[i];
+        (*my)[i] = (*cy)[i] + (*r)[i];
+        (*mz)[i] = (*cz)[i] + (*r)[i];
+    }
+    auto mask = std::make_shared<std::vector<uint32_t>>(asdx::GetCullingMaskWordCount(ITEM_COUNT));
+
+    benches.push_back({ "culling/CullSpheres", ITEM_COUNT, [=]()
+    {
+        asdx::CullingSpheres spheres;
+        spheres.pCenterX = cx->data();
+        spheres.pCenterY = cy->data();
+        spheres.pCenterZ = cz->data();
+        spheres.pRadius  = r->data();
+        Consume(uint64_t(asdx::CullSpheres(planes->data(), spheres, ITEM_COUNT, mask->data())));
+    }});
+
+    benches.push_back({ "culling/CullBoxes", ITEM_COUNT, [=]()
+    {
+        asdx::CullingBoxes boxes;
+        boxes.pMinX = cx->data();
+        boxes.pMinY = cy->data();
+        boxes.pMinZ = cz->data();
+        boxes.pMaxX = mx->data();
+        boxes.pMaxY = my->data();
+        boxes.pMaxZ = mz->data();
+        Consume(uint64_t(asdx::CullBoxes(planes->data(), boxes, ITEM_COUNT, mask->data())));
+    }});
+
+    // 境界ボリュームと視錐台の判定.
+    auto frustum = std::make_shared<asdx::Frustum>(planes->data());
+    auto aabbs   = std::make_shared<std::vector<asdx::BoundingBox>>(ITEM_COUNT);
+    auto packets = std::make_shared<std::vector<asdx::BoundingBoxX4>>(ITEM_COUNT / asdx::BOUNDS_LANE_COUNT);
+    for(size_t i=0; i<ITEM_COUNT; ++i)
+    {
+        (*aabbs)[i] = asdx::BoundingBox(
+            asdx::Vector3((*cx)[i], (*cy)[i], (*cz)[i]),
+            asdx::Vector3((*mx)[i], (*my)[i], (*mz)[i]));
+        (*packets)[i / asdx::BOUNDS_LANE_COUNT].Set(uint32_t(i % asdx::BOUNDS_LANE_COUNT), (*aabbs)[i]);
+    }
+
+    benches.push_back({ "bounds/Frustum::Intersects(BoundingBox)", ITEM_COUNT, [=]()
+    {
+        uint64_t count = 0;
+        for(auto& box : *aabbs)
+        { count += frustum->Intersects(box) ? 1 : 0; }
+        Consume(count);
+    }});
+
+    benches.push_back({ "bounds/Frustum::Intersects(BoundingBoxX4)", ITEM_COUNT, [=]()
+    {
+        uint64_t bits = 0;
+        for(auto& packet : *packets)
+        { bits += frustum->Intersects(packet); }
+        Consume(bits);
+    }});
+}
+
+//-----------------------------------------------------------------------------
+//      アニメーションのベンチマークを登録します.
+//-----------------------------------------------------------------------------
+void RegisterAnimation(std::vector<Benchmark>& benches)
+{
+    static constexpr uint32_t BONE_COUNT  = 128;
+    static constexpr uint32_t FRAME_COUNT = 60;
+
+    asdx::ResAnimationClip source;
+    source.Name       = "bench";
+    source.FrameCount = FRAME_COUNT;
+    source.BoneCount  = BONE_COUNT;
+
+    auto count = size_t(BONE_COUNT) * FRAME_COUNT;
+    auto trans = CreateRandomVectors(count, 1.0f);
+    auto axis  = CreateRandomVectors(count, 1.0f, RANDOM_SEED + 1);
+    auto angle = CreateRandomArray(count, -asdx::F_PI, asdx::F_PI, RANDOM_SEED + 2);
+    for(size_t i=0; i<count; ++i)
+    {
+        source.Translations.push_back(trans[i]);
+        source.Rotations.push_back(asdx::Quaternion::CreateFromAxisAngle(
+            asdx::Vector3::SafeNormalize(axis[i], asdx::Vector3(0.0f, 1.0f, 0.0f)), angle[i]));
+        source.Scales.push_back(asdx::Vector3(1.0f, 1.0f, 1.0f));
+    }
+
+    auto clip = std::make_shared<asdx::AnimationClip>();
+    asdx::CompressAnimationClip(source, *clip);
+
+    auto pose = std::make_shared<asdx::AnimationPose>();
+    pose->Init(BONE_COUNT);
+    auto matrices = std::make_shared<std::vector<asdx::Matrix34>>(BONE_COUNT);
+
+    benches.push_back({ "animation/SampleAnimation/Nlerp", BONE_COUNT, [=]()
+    {
+        static float time = 0.0f;
+        time += 0.013f;
+        asdx::SampleAnimation(*clip, time, true, asdx::ANIMATION_INTERPOLATION_NLERP, *pose);
+        Consume(pose->Channels[0]);
+    }});
+
+    benches.push_back({ "animation/SampleAnimation/Slerp", BONE_COUNT, [=]()
+    {
+        static float time = 0.0f;
+        time += 0.013f;
+        asdx::SampleAnimation(*clip, time, true, asdx::ANIMATION_INTERPOLATION_SLERP, *pose);
+        Consume(pose->Channels[0]);
+    }});
+
+    benches.push_back({ "animation/CalcLocalMatrices", BONE_COUNT, [=]()
+    {
+        asdx::CalcLocalMatrices(*pose, matrices->data());
+        Consume((*matrices)[BONE_COUNT - 1]._11);
+    }});
+}
+
+//-----------------------------------------------------------------------------
+//      ライト割り当てのベンチマークを登録します.
+//-----------------------------------------------------------------------------
+void RegisterLight(std::vector<Benchmark>& benches)
+{
+    auto view = asdx::Matrix::CreateLookAt(asdx::Vector3(0.0f, 10.0f, 0.0f), asdx::Vector3(0.0f, 10.0f, -1.0f), asdx::Vector3(0.0f, 1.0f, 0.0f));
+    auto proj = asdx::Matrix::CreatePerspectiveFieldOfView(asdx::F_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+    asdx::LightClusterDesc desc;
+    desc.FarClip = 500.0f;
+
+    // ライト数の 3/4 をポイントライト, 残りをスポットライトとして視錐台の周辺に配置する.
+    const size_t counts[] = { 1000, 10000, 100000 };
+    const char*  names[]  = { "1k", "10k", "100k" };
+    for(auto i=0; i<3; ++i)
+    {
+        auto pointCount = counts[i] - counts[i] / 4;
+        auto spotCount  = counts[i] / 4;
+        auto seed       = RANDOM_SEED + 40 + i * 16;
+
+        auto points = std::make_shared<std::vector<asdx::PointLight>>();
+        auto spots  = std::make_shared<std::vector<asdx::SpotLight>>();
+        {
+            auto px = CreateRandomArray(pointCount, -300.0f, 300.0f, seed + 0);
+            auto py = CreateRandomArray(pointCount,    0.0f,  30.0f, seed + 1);
+            auto pz = CreateRandomArray(pointCount, -500.0f,  10.0f, seed + 2);
+            auto pr = CreateRandomArray(pointCount,    1.0f,  10.0f, seed + 3);
+            points->reserve(pointCount);
+            for(size_t j=0; j<pointCount; ++j)
+            { points->emplace_back(asdx::Vector3(px[j], py[j], pz[j]), pr[j], asdx::Vector3(1.0f, 1.0f, 1.0f)); }
+
+            auto sx = CreateRandomArray(spotCount, -300.0f, 300.0f, seed + 4);
+            auto sy = CreateRandomArray(spotCount,    0.0f,  30.0f, seed + 5);
+            auto sz = CreateRandomArray(spotCount, -500.0f,  10.0f, seed + 6);
+            auto sr = CreateRandomArray(spotCount,    2.0f,  20.0f, seed + 7);
+            auto sa = CreateRandomArray(spotCount,    0.2f,   1.2f, seed + 8);
+            auto dir = CreateRandomVectors(spotCount, 1.0f, seed + 9);
+            spots->reserve(spotCount);
+            for(size_t j=0; j<spotCount; ++j)
+            {
+                auto forward = asdx::Vector3::Normalize(dir[j] + asdx::Vector3(0.0f, -1.5f, 0.0f));
+                spots->emplace_back(asdx::Vector3(sx[j], sy[j], sz[j]), forward, sr[j], sa[j] * 0.5f, sa[j], asdx::Vector3(1.0f, 1.0f, 1.0f));
+            }
+        }
+
+        auto result = std::make_shared<asdx::LightClusterList>();
+        for(auto threads : { 1u, 0u })
+        {
+            auto name = std::string("light/AssignLightsToClusters/") + names[i] + ((threads == 1) ? "/1t" : "/mt");
+            benches.push_back({ name, counts[i], [=]()
+            {
+                asdx::AssignLightsToClusters(desc, view, proj,
+                    points->data(), points->size(),
+                    spots->data(), spots->size(),
+                    *result, threads);
+                Consume(uint64_t(result->Indices.size()));
+            }});
+        }
+
+        // ライトの階層構築と更新, 検索.
+        auto bvh = std::make_shared<asdx::LightBVH>();
+        bvh->Build(points->data(), points->size(), spots->data(), spots->size());
+
+        benches.push_back({ std::string("light/LightBVH::Build/") + names[i], counts[i], [=]()
+        {
+            bvh->Build(points->data(), points->size(), spots->data(), spots->size());
+            Consume(uint64_t(bvh->GetNodes().size()));
+        }});
+
+        benches.push_back({ std::string("light/LightBVH::Refit/") + names[i], counts[i], [=]()
+        {
+            bvh->Refit(points->data(), spots->data());
+            Consume(bvh->GetNodes()[0].Bounds.Max.x);
+        }});
+
+        auto queries = std::make_shared<std::vector<asdx::Vector3>>(CreateRandomVectors(ITEM_COUNT, 300.0f, seed + 10));
+        auto hits    = std::make_shared<asdx::LightBVHResult>();
+        benches.push_back({ std::string("light/LightBVH::Query(BoundingSphere)/") + names[i], ITEM_COUNT, [=]()
+        {
+            uint64_t count = 0;
+            for(auto& q : *queries)
+            {
+                hits->Clear();
+                bvh->Query(asdx::BoundingSphere(q, 2.0f), *hits);
+                count += hits->PointLights.size() + hits->SpotLights.size();
+            }
+            Consume(count);
+        }});
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      コマンドライン引数を解析します.
+//-----------------------------------------------------------------------------
+bool ParseOption(int argc, char** argv, Option& option)
+{
+    for(auto i=1; i<argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, 9, "--filter=") == 0)
+        { option.Filter = arg.substr(9); }
+        else if (arg.compare(0, 10, "--samples=") == 0)
+        { option.Samples = std::max(1u, uint32_t(strtoul(arg.c_str() + 10, nullptr, 10))); }
+        else if (arg.compare(0, 11, "--min-time=") == 0)
+        { option.MinTimeMs = strtod(arg.c_str() + 11, nullptr); }
+        else if (arg == "--list")
+        { option.List = true; }
+        else
+        {
+            fprintf(stderr,
+                "usage: %s [--filter=<substring>] [--samples=<count>] [--min-time=<ms>] [--list]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    Option option;
+    if (!ParseOption(argc, argv, option))
+    { return EXIT_FAILURE; }
+
+    std::vector<Benchmark> benches;
+    RegisterMath(benches);
+    RegisterFastMath(benches);
+    RegisterHash(benches);
+    RegisterModel(benches);
+    RegisterAnimation(benches);
+    RegisterLight(benches);
+
+    if (!option.List)
+    {
+    #if defined(ASDX_ENABLE_SIMD)
+        auto simd = "true";
+    #else
+        auto simd = "false";
+    #endif
+        printf("{\"context\":{\"simd\":%s,\"samples\":%u,\"min_time_ms\":%.3f}}\n",
+            simd, option.Samples, option.MinTimeMs);
+    }
+
+    for(auto& bench : benches)
+    {
+        if (!option.Filter.empty() && bench.Name.find(option.Filter) == std::string::npos)
+        { continue; }
+
+        if (option.List)
+        { printf("%s\n", bench.Name.c_str()); }
+        else
+        { Run(bench, option); }
+    }
+
+    return EXIT_SUCCESS;
+}
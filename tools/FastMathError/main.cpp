@@ -0,0 +1,352 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Accuracy harness for asdx::fast functions.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <asdxFastMath.h>
+
+
+//-----------------------------------------------------------------------------
+// 使い方.
+//  asdx_fastmath_error [stride]
+// stride 間隔で列挙した float のビット列(1 なら全 2^32 個, 既定は 61)について
+// asdx::fast 関数の誤差を計測し, 許容誤差を超えたら 0 以外を返却します.
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t     CHUNK_SIZE      = 4096;
+static constexpr uint32_t   DEFAULT_STRIDE  = 61;
+static constexpr uint32_t   ATAN2_SAMPLES   = 1u << 22;
+
+///////////////////////////////////////////////////////////////////////////////
+// ERROR_TYPE enum
+///////////////////////////////////////////////////////////////////////////////
+enum ERROR_TYPE
+{
+    ERROR_TYPE_ABSOLUTE,    // 絶対誤差.
+    ERROR_TYPE_RELATIVE,    // 相対誤差.
+    ERROR_TYPE_MIXED,       // |真値| <= 1 では絶対誤差, それ以外では相対誤差.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ErrorStat structure
+///////////////////////////////////////////////////////////////////////////////
+struct ErrorStat
+{
+    double      MaxError    = 0.0;      // 最大誤差.
+    float       WorstInput  = 0.0f;     // 最大誤差となった入力値.
+    uint64_t    Count       = 0;        // 評価した数.
+    uint64_t    Mismatch    = 0;        // スカラー版と配列版で結果が異なった数.
+
+    void Add(double error, float input)
+    {
+        if (error > MaxError)
+        {
+            MaxError   = error;
+            WorstInput = input;
+        }
+        Count++;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      ビット列から浮動小数を生成します.
+//-----------------------------------------------------------------------------
+inline float AsFloat(uint32_t bits)
+{
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      浮動小数をビット列に変換します.
+//-----------------------------------------------------------------------------
+inline uint32_t AsUint(float value)
+{
+    uint32_t result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      [minValue, maxValue] の浮動小数を列挙します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+void Sweep(float minValue, float maxValue, uint32_t stride, Func func)
+{
+    std::vector<float> values;
+    values.reserve(CHUNK_SIZE);
+
+    auto flush = [&]()
+    {
+        if (!values.empty())
+        { func(values.data(), values.size()); }
+        values.clear();
+    };
+
+    auto sweep = [&](uint32_t begin, uint32_t end, bool negative)
+    {
+        for(uint64_t bits=begin; bits<=end; bits+=stride)
+        {
+            auto v = AsFloat(uint32_t(bits));
+            values.push_back(negative ? -v : v);
+            if (values.size() == CHUNK_SIZE)
+            { flush(); }
+        }
+        values.push_back(negative ? -AsFloat(end) : AsFloat(end));
+        flush();
+    };
+
+    // 正の範囲と負の範囲を別々に列挙する.
+    if (maxValue > 0.0f)
+    { sweep((minValue > 0.0f) ? AsUint(minValue) : 0u, AsUint(maxValue), false); }
+    if (minValue < 0.0f)
+    { sweep((maxValue < 0.0f) ? AsUint(-maxValue) : 0u, AsUint(-minValue), true); }
+}
+
+//-----------------------------------------------------------------------------
+//      1入力1出力の関数を評価します.
+//-----------------------------------------------------------------------------
+template<typename ArrayFunc, typename ScalarFunc, typename RefFunc>
+ErrorStat Measure
+(
+    float       minValue,
+    float       maxValue,
+    uint32_t    stride,
+    ERROR_TYPE  type,
+    ArrayFunc   arrayFunc,
+    ScalarFunc  scalarFunc,
+    RefFunc     refFunc
+)
+{
+    ErrorStat stat;
+    std::vector<float> result(CHUNK_SIZE);
+
+    Sweep(minValue, maxValue, stride, [&](const float* pValues, size_t count)
+    {
+        arrayFunc(pValues, result.data(), count);
+        for(size_t i=0; i<count; ++i)
+        {
+            if (AsUint(result[i]) != AsUint(scalarFunc(pValues[i])))
+            { stat.Mismatch++; }
+
+            auto ref = refFunc(double(pValues[i]));
+            auto err = fabs(double(result[i]) - ref);
+            if (type == ERROR_TYPE_RELATIVE)
+            { err /= fabs(ref); }
+            else if (type == ERROR_TYPE_MIXED && fabs(ref) > 1.0)
+            { err /= fabs(ref); }
+            stat.Add(err, pValues[i]);
+        }
+    });
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      正弦と余弦を評価します.
+//-----------------------------------------------------------------------------
+template<typename ArrayFunc, typename ScalarFunc>
+ErrorStat MeasureSinCos(uint32_t stride, ArrayFunc arrayFunc, ScalarFunc scalarFunc)
+{
+    ErrorStat stat;
+    std::vector<float> s(CHUNK_SIZE);
+    std::vector<float> c(CHUNK_SIZE);
+    auto limit = asdx::fast::SINCOS_MAX_DOMAIN;
+
+    Sweep(-limit, limit, stride, [&](const float* pValues, size_t count)
+    {
+        arrayFunc(pValues, s.data(), c.data(), count);
+        for(size_t i=0; i<count; ++i)
+        {
+            float ss, sc;
+            scalarFunc(pValues[i], ss, sc);
+            if (AsUint(ss) != AsUint(s[i]) || AsUint(sc) != AsUint(c[i]))
+            { stat.Mismatch++; }
+
+            auto x = double(pValues[i]);
+            auto es = fabs(double(s[i]) - sin(x));
+            auto ec = fabs(double(c[i]) - cos(x));
+            stat.Add((es > ec) ? es : ec, pValues[i]);
+        }
+    });
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      逆正接を評価します.
+//-----------------------------------------------------------------------------
+template<typename ArrayFunc, typename ScalarFunc>
+ErrorStat MeasureAtan2(ArrayFunc arrayFunc, ScalarFunc scalarFunc)
+{
+    ErrorStat stat;
+    std::vector<float> y(CHUNK_SIZE);
+    std::vector<float> x(CHUNK_SIZE);
+    std::vector<float> result(CHUNK_SIZE);
+    asdx::XorShift random(12345);
+
+    for(uint32_t n=0; n<ATAN2_SAMPLES; n+=CHUNK_SIZE)
+    {
+        for(size_t i=0; i<CHUNK_SIZE; ++i)
+        {
+            // 半分は単位円上の角度, 残りは指数部も含めた任意の有限値.
+            if (i & 1)
+            {
+                auto angle = (double(n + i) / ATAN2_SAMPLES) * asdx::D_2PI - asdx::D_PI;
+                y[i] = float(sin(angle));
+                x[i] = float(cos(angle));
+            }
+            else
+            {
+                do { y[i] = AsFloat(random.GetAsU32()); } while(!std::isfinite(y[i]));
+                do { x[i] = AsFloat(random.GetAsU32()); } while(!std::isfinite(x[i]));
+            }
+        }
+
+        arrayFunc(y.data(), x.data(), result.data(), CHUNK_SIZE);
+        for(size_t i=0; i<CHUNK_SIZE; ++i)
+        {
+            if (AsUint(result[i]) != AsUint(scalarFunc(y[i], x[i])))
+            { stat.Mismatch++; }
+
+            auto err = fabs(double(result[i]) - atan2(double(y[i]), double(x[i])));
+            stat.Add(err, y[i]);
+        }
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      結果を出力します.
+//-----------------------------------------------------------------------------
+bool Report(const char* name, const ErrorStat& stat, float bound)
+{
+    auto pass = (stat.MaxError <= double(bound)) && (stat.Mismatch == 0);
+    printf("%-10s max_error=%.6e bound=%.6e worst_input=%.9g samples=%llu mismatch=%llu %s\n",
+        name,
+        stat.MaxError,
+        double(bound),
+        double(stat.WorstInput),
+        (unsigned long long)stat.Count,
+        (unsigned long long)stat.Mismatch,
+        pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+//-----------------------------------------------------------------------------
+//      列挙の間隔を解析します.
+//-----------------------------------------------------------------------------
+bool ParseStride(const char* arg, uint32_t& result)
+{
+    char* pEnd = nullptr;
+    auto value = strtoul(arg, &pEnd, 10);
+    if (arg[0] < '0' || arg[0] > '9' || *pEnd != '\0' || value == 0 || value > UINT32_MAX)
+    { return false; }
+
+    result = uint32_t(value);
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    using namespace asdx::fast;
+
+    // 引数で列挙の間隔を指定できる(1なら全ての浮動小数を評価する).
+    auto stride = DEFAULT_STRIDE;
+    if (argc > 2 || (argc == 2 && !ParseStride(argv[1], stride)))
+    {
+        fprintf(stderr, "usage: %s [stride]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto pass = true;
+
+    pass &= Report("SinCosEst", MeasureSinCos(stride,
+        [](const float* p, float* s, float* c, size_t n) { SinCosEst(p, s, c, n); },
+        [](float x, float& s, float& c) { SinCosEst(x, s, c); }),
+        SINCOS_EST_MAX_ERROR);
+
+    pass &= Report("SinCos", MeasureSinCos(stride,
+        [](const float* p, float* s, float* c, size_t n) { SinCos(p, s, c, n); },
+        [](float x, float& s, float& c) { SinCos(x, s, c); }),
+        SINCOS_MAX_ERROR);
+
+    pass &= Report("RsqrtEst", Measure(FLT_MIN, FLT_MAX, stride, ERROR_TYPE_RELATIVE,
+        [](const float* p, float* r, size_t n) { RsqrtEst(p, r, n); },
+        [](float x) { return RsqrtEst(x); },
+        [](double x) { return 1.0 / sqrt(x); }),
+        RSQRT_EST_MAX_ERROR);
+
+    pass &= Report("Rsqrt", Measure(FLT_MIN, FLT_MAX, stride, ERROR_TYPE_RELATIVE,
+        [](const float* p, float* r, size_t n) { Rsqrt(p, r, n); },
+        [](float x) { return Rsqrt(x); },
+        [](double x) { return 1.0 / sqrt(x); }),
+        RSQRT_MAX_ERROR);
+
+    pass &= Report("Exp2Est", Measure(-126.0f, 127.0f, stride, ERROR_TYPE_RELATIVE,
+        [](const float* p, float* r, size_t n) { Exp2Est(p, r, n); },
+        [](float x) { return Exp2Est(x); },
+        [](double x) { return exp2(x); }),
+        EXP2_EST_MAX_ERROR);
+
+    pass &= Report("Exp2", Measure(-126.0f, 127.0f, stride, ERROR_TYPE_RELATIVE,
+        [](const float* p, float* r, size_t n) { Exp2(p, r, n); },
+        [](float x) { return Exp2(x); },
+        [](double x) { return exp2(x); }),
+        EXP2_MAX_ERROR);
+
+    pass &= Report("Log2Est", Measure(FLT_MIN, FLT_MAX, stride, ERROR_TYPE_MIXED,
+        [](const float* p, float* r, size_t n) { Log2Est(p, r, n); },
+        [](float x) { return Log2Est(x); },
+        [](double x) { return log2(x); }),
+        LOG2_EST_MAX_ERROR);
+
+    pass &= Report("Log2", Measure(FLT_MIN, FLT_MAX, stride, ERROR_TYPE_MIXED,
+        [](const float* p, float* r, size_t n) { Log2(p, r, n); },
+        [](float x) { return Log2(x); },
+        [](double x) { return log2(x); }),
+        LOG2_MAX_ERROR);
+
+    pass &= Report("Atan2Est", MeasureAtan2(
+        [](const float* y, const float* x, float* r, size_t n) { Atan2Est(y, x, r, n); },
+        [](float y, float x) { return Atan2Est(y, x); }),
+        ATAN2_EST_MAX_ERROR);
+
+    pass &= Report("Atan2", MeasureAtan2(
+        [](const float* y, const float* x, float* r, size_t n) { Atan2(y, x, r, n); },
+        [](float y, float x) { return Atan2(y, x); }),
+        ATAN2_MAX_ERROR);
+
+    pass &= Report("AcosEst", Measure(-1.0f, 1.0f, stride, ERROR_TYPE_ABSOLUTE,
+        [](const float* p, float* r, size_t n) { AcosEst(p, r, n); },
+        [](float x) { return AcosEst(x); },
+        [](double x) { return acos(x); }),
+        ACOS_EST_MAX_ERROR);
+
+    pass &= Report("Acos", Measure(-1.0f, 1.0f, stride, ERROR_TYPE_ABSOLUTE,
+        [](const float* p, float* r, size_t n) { Acos(p, r, n); },
+        [](float x) { return Acos(x); },
+        [](double x) { return acos(x); }),
+        ACOS_MAX_ERROR);
+
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,250 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Exhaustive checker for half conversions.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <asdxMath.h>
+
+
+//-----------------------------------------------------------------------------
+// 使い方.
+//  asdx_half_error [stride]
+// 全ての half と, stride 間隔で列挙した float のビット列(既定では全 2^32 個)について
+//  - ToFloat / ToHalf と倍精度で丸めた参照値(IEEE 754 の最近接偶数丸め),
+//  - ToFloatArray / ToHalfArray と ToFloat / ToHalf
+// がビット単位で一致するか検査し, 不一致があれば 0 以外を返却します.
+// NaN は上位の仮数ビットを残した quiet NaN を参照値とします(F16C と同じ).
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr size_t     CHUNK_SIZE      = 4093;     // 配列版の端数処理も通るように8の倍数にしない.
+static constexpr uint32_t   DEFAULT_STRIDE  = 1;
+static constexpr uint32_t   MAX_PRINT       = 8;        // 出力する不一致の最大数.
+
+///////////////////////////////////////////////////////////////////////////////
+// MismatchStat structure
+///////////////////////////////////////////////////////////////////////////////
+struct MismatchStat
+{
+    uint64_t    Count       = 0;        // 評価した数.
+    uint64_t    Mismatch    = 0;        // 不一致の数.
+
+    void Add(const char* name, uint32_t input, uint32_t expected, uint32_t actual)
+    {
+        Count++;
+        if (expected == actual)
+        { return; }
+
+        if (Mismatch < MAX_PRINT)
+        {
+            printf("  %s mismatch: input=0x%08x expected=0x%08x actual=0x%08x\n",
+                name, input, expected, actual);
+        }
+        Mismatch++;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      ビット列から浮動小数を生成します.
+//-----------------------------------------------------------------------------
+inline float AsFloat(uint32_t bits)
+{
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      浮動小数をビット列に変換します.
+//-----------------------------------------------------------------------------
+inline uint32_t AsUint(float value)
+{
+    uint32_t result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      参照用の float から half への変換です.
+//-----------------------------------------------------------------------------
+asdx::half ReferenceToHalf(float value)
+{
+    auto bits = AsUint(value);
+    auto sign = asdx::half((bits >> 16) & 0x8000);
+    auto abs  = bits & 0x7FFFFFFF;
+
+    if (abs > 0x7F800000)
+    { return asdx::half(sign | 0x7E00 | ((abs >> 13) & 0x3FF)); }
+
+    if (abs == 0x7F800000)
+    { return asdx::half(sign | 0x7C00); }
+
+    auto x = fabs(double(value));
+    if (x == 0.0)
+    { return sign; }
+
+    // half の指数を求め, 非正規化数は最小の指数に揃える.
+    int exponent;
+    frexp(x, &exponent);
+    exponent = asdx::Max(exponent - 1, -14);
+
+    // 仮数を 10 ビットの整数に丸める(最近接偶数丸め). 桁上がりは指数に繰り上がる.
+    auto mantissa = uint32_t(nearbyint(ldexp(x, 10 - exponent)));
+    auto result   = (uint32_t(exponent + 15) << 10) + mantissa - 1024;
+    if (result >= 0x7C00)
+    { result = 0x7C00; }
+
+    return asdx::half(sign | result);
+}
+
+//-----------------------------------------------------------------------------
+//      参照用の half から float への変換です.
+//-----------------------------------------------------------------------------
+float ReferenceToFloat(asdx::half value)
+{
+    auto sign     = uint32_t(value & 0x8000) << 16;
+    auto exponent = (value >> 10) & 0x1F;
+    auto mantissa = uint32_t(value & 0x3FF);
+
+    if (exponent == 0x1F)
+    {
+        auto nan = (mantissa != 0) ? (0x400000 | (mantissa << 13)) : 0;
+        return AsFloat(sign | 0x7F800000 | nan);
+    }
+
+    auto x = (exponent == 0)
+        ? ldexp(double(mantissa), -24)
+        : ldexp(double(mantissa + 1024), exponent - 25);
+
+    return AsFloat(sign | AsUint(float(x)));
+}
+
+//-----------------------------------------------------------------------------
+//      全ての half を検査します.
+//-----------------------------------------------------------------------------
+bool CheckToFloat()
+{
+    std::vector<asdx::half> input (0x10000);
+    std::vector<float>      output(0x10000);
+    for(auto i=0u; i<0x10000; ++i)
+    { input[i] = asdx::half(i); }
+
+    for(size_t i=0; i<input.size(); i+=CHUNK_SIZE)
+    {
+        auto count = asdx::Min(CHUNK_SIZE, input.size() - i);
+        asdx::ToFloatArray(input.data() + i, count, output.data() + i);
+    }
+
+    MismatchStat scalar;
+    MismatchStat array;
+    for(auto i=0u; i<0x10000; ++i)
+    {
+        auto expected = AsUint(ReferenceToFloat(asdx::half(i)));
+        auto value    = AsUint(asdx::ToFloat(asdx::half(i)));
+        scalar.Add("ToFloat", i, expected, value);
+        array .Add("ToFloatArray", i, value, AsUint(output[i]));
+    }
+
+    auto pass = (scalar.Mismatch == 0) && (array.Mismatch == 0);
+    printf("%-12s samples=%llu mismatch_reference=%llu mismatch_array=%llu %s\n",
+        "ToFloat",
+        (unsigned long long)scalar.Count,
+        (unsigned long long)scalar.Mismatch,
+        (unsigned long long)array.Mismatch,
+        pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+//-----------------------------------------------------------------------------
+//      float のビット列を stride 間隔で検査します.
+//-----------------------------------------------------------------------------
+bool CheckToHalf(uint32_t stride)
+{
+    std::vector<float>      input (CHUNK_SIZE);
+    std::vector<asdx::half> output(CHUNK_SIZE);
+
+    MismatchStat scalar;
+    MismatchStat array;
+
+    uint64_t bits = 0;
+    while(bits <= UINT32_MAX)
+    {
+        size_t count = 0;
+        for(; count < CHUNK_SIZE && bits <= UINT32_MAX; ++count, bits += stride)
+        { input[count] = AsFloat(uint32_t(bits)); }
+
+        asdx::ToHalfArray(input.data(), count, output.data());
+
+        for(size_t i=0; i<count; ++i)
+        {
+            auto value = asdx::ToHalf(input[i]);
+            scalar.Add("ToHalf",      AsUint(input[i]), ReferenceToHalf(input[i]), value);
+            array .Add("ToHalfArray", AsUint(input[i]), value, output[i]);
+        }
+    }
+
+    auto pass = (scalar.Mismatch == 0) && (array.Mismatch == 0);
+    printf("%-12s samples=%llu mismatch_reference=%llu mismatch_array=%llu %s\n",
+        "ToHalf",
+        (unsigned long long)scalar.Count,
+        (unsigned long long)scalar.Mismatch,
+        (unsigned long long)array.Mismatch,
+        pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+//-----------------------------------------------------------------------------
+//      列挙の間隔を解析します.
+//-----------------------------------------------------------------------------
+bool ParseStride(const char* arg, uint32_t& result)
+{
+    char* pEnd = nullptr;
+    auto value = strtoul(arg, &pEnd, 10);
+    if (arg[0] < '0' || arg[0] > '9' || *pEnd != '\0' || value == 0 || value > UINT32_MAX)
+    { return false; }
+
+    result = uint32_t(value);
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    auto stride = DEFAULT_STRIDE;
+    if (argc > 2 || (argc == 2 && !ParseStride(argv[1], stride)))
+    {
+        fprintf(stderr, "usage: %s [stride]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+#if defined(ASDX_ENABLE_F16C)
+    printf("path: F16C\n");
+#elif defined(ASDX_ENABLE_SIMD)
+    printf("path: SSE2\n");
+#else
+    printf("path: scalar\n");
+#endif
+
+    auto pass = true;
+    pass &= CheckToFloat();
+    pass &= CheckToHalf(stride);
+
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,245 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Benchmark corpus generator for the OBJ loader.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <asdxObj.h>
+
+
+//-----------------------------------------------------------------------------
+// 使い方.
+//  asdx_obj_corpus [--out=<path>] [--size=<MB>] [--division=<count>] [--measure]
+// 格子状のメッシュを指定サイズに達するまで書き出し, 同名の .mtl も出力します.
+// オブジェクトごとにグループとマテリアルを切り替え, 四角形と三角形,
+// 正と負の頂点番号を交互に使用します.
+// --measure を指定した場合は, 出力したファイルの読み込み時間を1行1レコードのJSON形式で出力します.
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   DEFAULT_SIZE_MB     = 256;  // 出力サイズ(MB).
+static constexpr uint32_t   DEFAULT_DIVISION    = 256;  // 1オブジェクトの格子の分割数.
+static constexpr uint32_t   MATERIAL_COUNT      = 4;    // マテリアル数.
+static constexpr uint32_t   MEASURE_COUNT       = 3;    // 計測回数.
+
+///////////////////////////////////////////////////////////////////////////////
+// Option structure
+///////////////////////////////////////////////////////////////////////////////
+struct Option
+{
+    std::string     Path        = "corpus.obj";         // 出力ファイル.
+    uint32_t        SizeMB      = DEFAULT_SIZE_MB;      // 出力サイズ.
+    uint32_t        Division    = DEFAULT_DIVISION;     // 格子の分割数.
+    bool            Measure     = false;                // 読み込み時間を計測するかどうか.
+};
+
+//-----------------------------------------------------------------------------
+//      コマンドライン引数を解析します.
+//-----------------------------------------------------------------------------
+bool ParseOption(int argc, char** argv, Option& option)
+{
+    for(auto i=1; i<argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, 6, "--out=") == 0)
+        { option.Path = arg.substr(6); }
+        else if (arg.compare(0, 7, "--size=") == 0)
+        { option.SizeMB = uint32_t(strtoul(arg.c_str() + 7, nullptr, 10)); }
+        else if (arg.compare(0, 11, "--division=") == 0)
+        { option.Division = uint32_t(strtoul(arg.c_str() + 11, nullptr, 10)); }
+        else if (arg == "--measure")
+        { option.Measure = true; }
+        else
+        {
+            fprintf(stderr,
+                "usage: %s [--out=<path>] [--size=<MB>] [--division=<count>] [--measure]\n", argv[0]);
+            return false;
+        }
+    }
+
+    if (option.SizeMB == 0 || option.Division == 0)
+    {
+        fprintf(stderr, "size and division must be greater than 0.\n");
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      マテリアルライブラリを書き出します.
+//-----------------------------------------------------------------------------
+bool WriteMtl(const std::string& path)
+{
+    auto pFile = fopen(path.c_str(), "wb");
+    if (pFile == nullptr)
+    { return false; }
+
+    for(auto i=0u; i<MATERIAL_COUNT; ++i)
+    {
+        auto t = float(i) / float(MATERIAL_COUNT);
+        fprintf(pFile, "newmtl material%u\n", i);
+        fprintf(pFile, "Kd %.3f %.3f %.3f\n", 1.0f - t, 0.5f, t);
+        fprintf(pFile, "Ns %.1f\n", 10.0f + 100.0f * t);
+        fprintf(pFile, "map_Kd textures/albedo%u.png\n\n", i);
+    }
+
+    fclose(pFile);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      格子状のオブジェクトを1つ書き出します.
+//-----------------------------------------------------------------------------
+void WriteObject(FILE* pFile, uint32_t objectIndex, uint32_t division, uint32_t& vertexCount)
+{
+    auto stride = division + 1;
+    auto offset = float(objectIndex);
+
+    fprintf(pFile, "o grid%u\nusemtl material%u\n", objectIndex, objectIndex % MATERIAL_COUNT);
+
+    for(auto y=0u; y<=division; ++y)
+    {
+        for(auto x=0u; x<=division; ++x)
+        {
+            auto u = float(x) / float(division);
+            auto v = float(y) / float(division);
+            auto h = 0.1f * sinf(u * 12.0f + offset) * cosf(v * 9.0f);
+            fprintf(pFile, "v %.6f %.6f %.6f\n", u + offset, h, v);
+            fprintf(pFile, "vt %.6f %.6f\n", u, v);
+            fprintf(pFile, "vn %.6f %.6f %.6f\n", 0.0f, 1.0f, 0.0f);
+        }
+    }
+
+    // 偶数番目は正の番号で四角形, 奇数番目は負の番号で三角形.
+    auto relative = (objectIndex & 1) != 0;
+    auto count    = (long long)stride * stride;
+    auto base     = relative ? -count : (long long)vertexCount + 1;
+
+    for(auto y=0u; y<division; ++y)
+    {
+        for(auto x=0u; x<division; ++x)
+        {
+            auto i0 = base + (long long)(y * stride + x);
+            auto i1 = i0 + 1;
+            auto i2 = i0 + stride;
+            auto i3 = i2 + 1;
+
+            if (relative)
+            {
+                fprintf(pFile, "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+                    i0, i0, i0, i2, i2, i2, i1, i1, i1);
+                fprintf(pFile, "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+                    i1, i1, i1, i2, i2, i2, i3, i3, i3);
+            }
+            else
+            {
+                fprintf(pFile, "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+                    i0, i0, i0, i2, i2, i2, i3, i3, i3, i1, i1, i1);
+            }
+        }
+    }
+
+    vertexCount += uint32_t(count);
+}
+
+//-----------------------------------------------------------------------------
+//      読み込み時間を計測します.
+//-----------------------------------------------------------------------------
+void Measure(const std::string& path, uint64_t bytes)
+{
+    for(auto threads : { 1u, 0u })
+    {
+        double bestMs = 0.0;
+        size_t triangles = 0;
+        for(auto i=0u; i<MEASURE_COUNT; ++i)
+        {
+            asdx::ResModel model;
+            auto begin = std::chrono::steady_clock::now();
+            if (!asdx::LoadObj(path.c_str(), model, threads))
+            { return; }
+            auto end = std::chrono::steady_clock::now();
+
+            auto ms = std::chrono::duration<double, std::milli>(end - begin).count();
+            bestMs = (i == 0) ? ms : std::min(bestMs, ms);
+
+            triangles = 0;
+            for(auto& mesh : model.Meshes)
+            { triangles += mesh.Indices.size() / 3; }
+        }
+
+        printf("{\"name\":\"LoadObj/%s\",\"bytes\":%llu,\"triangles\":%zu,\"best_ms\":%.3f,\"mb_per_sec\":%.1f}\n",
+            (threads == 1) ? "1t" : "mt", (unsigned long long)bytes, triangles, bestMs,
+            double(bytes) / (1024.0 * 1024.0) / (bestMs * 1e-3));
+    }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    Option option;
+    if (!ParseOption(argc, argv, option))
+    { return EXIT_FAILURE; }
+
+    // マテリアルライブラリは拡張子を .mtl に置き換えたファイル.
+    auto mtlPath = option.Path;
+    auto dot = mtlPath.find_last_of('.');
+    auto sep = mtlPath.find_last_of("/\\");
+    if (dot != std::string::npos && (sep == std::string::npos || dot > sep))
+    { mtlPath.erase(dot); }
+    mtlPath += ".mtl";
+
+    auto mtlName = (sep == std::string::npos) ? mtlPath : mtlPath.substr(sep + 1);
+
+    if (!WriteMtl(mtlPath))
+    {
+        fprintf(stderr, "failed to write %s\n", mtlPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    auto pFile = fopen(option.Path.c_str(), "wb");
+    if (pFile == nullptr)
+    {
+        fprintf(stderr, "failed to write %s\n", option.Path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    fprintf(pFile, "# asdx OBJ benchmark corpus\nmtllib %s\n", mtlName.c_str());
+
+    auto target      = uint64_t(option.SizeMB) * 1024 * 1024;
+    auto vertexCount = 0u;
+    auto objectCount = 0u;
+    while(uint64_t(ftell(pFile)) < target)
+    {
+        WriteObject(pFile, objectCount, option.Division, vertexCount);
+        objectCount++;
+    }
+
+    auto bytes = uint64_t(ftell(pFile));
+    fclose(pFile);
+
+    fprintf(stderr, "wrote %s (%llu bytes, %u objects, %u vertices)\n",
+        option.Path.c_str(), (unsigned long long)bytes, objectCount, vertexCount);
+
+    if (option.Measure)
+    { Measure(option.Path, bytes); }
+
+    return EXIT_SUCCESS;
+}
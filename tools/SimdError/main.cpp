@@ -0,0 +1,581 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Scalar / SIMD agreement harness for asdxMath.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <random>
+#include <asdxMath.h>
+#include <asdxSimd.h>
+
+// スカラー版を基準にするため, このツールは ASDX_ENABLE_SIMD を定義せずにビルドする.
+// SIMD 版は asdxMath.inl と同じ読み込み方で asdxSimd.h の関数を直接呼び出す.
+#if defined(ASDX_ENABLE_SIMD)
+#error "asdx_simd_error must be built without ASDX_ENABLE_SIMD."
+#endif//defined(ASDX_ENABLE_SIMD)
+
+
+//-----------------------------------------------------------------------------
+// 使い方.
+//  asdx_simd_error [count]
+// 乱数で生成した count 個の入力についてスカラー版と SIMD 版の結果を比較し,
+// 関数ごとに最大誤差を1行ずつ出力します. 誤差が上限を超えた場合は 0 以外を返却します.
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+static constexpr uint32_t   DEFAULT_COUNT       = 1u << 20;     // 既定の入力数.
+static constexpr int        RANDOM_SEED         = 12345;
+static constexpr int        MAX_EXPONENT        = 8;            // 入力値の指数の範囲(±).
+static constexpr double     DOT_MAX_ULP         = 2.0;          // Vector4::Dot の上限(sum(|a_i * b_i|) の ULP 単位).
+static constexpr double     TRANSFORM_MAX_ULP   = 0.0;          // Vector4::Transform の上限(加算順序が同じなので一致する).
+static constexpr double     MULTIPLY_MAX_ULP    = 0.0;          // Matrix::Multiply の上限(加算順序が同じなので一致する).
+static constexpr double     QUATERNION_MAX_ULP  = 2.0;          // Quaternion::Multiply の上限(成分ごとの sum(|a_i * b_j|) の ULP 単位).
+static constexpr double     INVERT_MAX_ULP      = 4.0;          // Matrix::Invert の上限(ulp(|inv(A)|) * cond(A) 単位).
+static constexpr double     AFFINE_MAX_ULP      = 0.0;          // アフィン/剛体変換の逆行列の上限(符号を含めてビット単位で一致する).
+static constexpr float      INVERT_MIN_DET      = 1.0f / 16.0f; // 一般の行列として評価する行列式の下限.
+
+///////////////////////////////////////////////////////////////////////////////
+// ErrorStat structure
+///////////////////////////////////////////////////////////////////////////////
+struct ErrorStat
+{
+    double      MaxError    = 0.0;      // 最大誤差(ULP).
+    uint64_t    Count       = 0;        // 評価した数.
+
+    void Add(double error)
+    {
+        if (error > MaxError)
+        { MaxError = error; }
+        Count++;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      値の大きさに対応する ULP を求めます.
+//-----------------------------------------------------------------------------
+inline double Ulp(double value)
+{
+    auto x = float(fabs(value));
+    if (double(x) < fabs(value))
+    { x = nextafterf(x, INFINITY); }
+    return double(nextafterf(x, INFINITY)) - double(x);
+}
+
+//-----------------------------------------------------------------------------
+//      2つの浮動小数の間にある表現可能な値の数を求めます.
+//-----------------------------------------------------------------------------
+inline double UlpDistance(float a, float b)
+{
+    // +0 と -0 は同じ値として扱う.
+    auto order = [](float value)
+    {
+        int32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (bits < 0) ? int64_t(INT32_MIN) - int64_t(bits) : int64_t(bits);
+    };
+    return double(std::llabs(order(a) - order(b)));
+}
+
+//-----------------------------------------------------------------------------
+//      符号を含めてビット列が一致するか比較します.
+//-----------------------------------------------------------------------------
+inline double BitError(float a, float b)
+{
+    uint32_t x, y;
+    memcpy(&x, &a, sizeof(x));
+    memcpy(&y, &b, sizeof(y));
+    if (x == y)
+    { return 0.0; }
+
+    // +0 と -0 の違いも1として数える.
+    auto distance = UlpDistance(a, b);
+    return (distance > 1.0) ? distance : 1.0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Random class
+///////////////////////////////////////////////////////////////////////////////
+class Random
+{
+public:
+    explicit Random(int seed)
+    : m_Engine(uint32_t(seed))
+    { /* DO_NOTHING */ }
+
+    // [-1, 1] の一様乱数.
+    float GetUnit()
+    { return std::uniform_real_distribution<float>(-1.0f, 1.0f)(m_Engine); }
+
+    // 指数が ±MAX_EXPONENT の範囲に散らばった乱数.
+    float GetValue()
+    { return ldexpf(GetUnit(), std::uniform_int_distribution<int>(-MAX_EXPONENT, MAX_EXPONENT)(m_Engine)); }
+
+    asdx::Vector4 GetVector4()
+    { return asdx::Vector4(GetValue(), GetValue(), GetValue(), GetValue()); }
+
+    asdx::Quaternion GetQuaternion()
+    { return asdx::Quaternion(GetValue(), GetValue(), GetValue(), GetValue()); }
+
+    // 回転と平行移動からなる剛体変換行列.
+    asdx::Matrix GetRigid()
+    {
+        return asdx::Matrix::CreateRotationX(3.0f * GetUnit())
+             * asdx::Matrix::CreateRotationY(3.0f * GetUnit())
+             * asdx::Matrix::CreateRotationZ(3.0f * GetUnit())
+             * asdx::Matrix::CreateTranslation(100.0f * GetUnit(), 100.0f * GetUnit(), 100.0f * GetUnit());
+    }
+
+    // 符号が反転した拡大縮小を含むアフィン変換行列(行列式は正負どちらにもなる).
+    asdx::Matrix GetAffine()
+    {
+        auto sx = (0.5f + 0.75f * (GetUnit() + 1.0f)) * ((GetUnit() < 0.0f) ? -1.0f : 1.0f);
+        auto sy = (0.5f + 0.75f * (GetUnit() + 1.0f)) * ((GetUnit() < 0.0f) ? -1.0f : 1.0f);
+        auto sz = (0.5f + 0.75f * (GetUnit() + 1.0f)) * ((GetUnit() < 0.0f) ? -1.0f : 1.0f);
+        return asdx::Matrix::CreateScale(sx, sy, sz) * GetRigid();
+    }
+
+    asdx::Matrix GetMatrix()
+    {
+        asdx::Matrix result;
+        for(auto i=0; i<4; ++i)
+        {
+            for(auto j=0; j<4; ++j)
+            { result.m[i][j] = GetValue(); }
+        }
+        return result;
+    }
+
+private:
+    std::mt19937 m_Engine;
+};
+
+//-----------------------------------------------------------------------------
+//      Vector4::Dot を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureDot(uint32_t count)
+{
+    Random random(RANDOM_SEED);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto a = random.GetVector4();
+        auto b = random.GetVector4();
+
+        auto scalar = asdx::Vector4::Dot(a, b);
+        auto simd   = _mm_cvtss_f32(asdx::SimdDot4(_mm_loadu_ps(&a.x), _mm_loadu_ps(&b.x)));
+
+        auto sum = fabs(double(a.x * b.x)) + fabs(double(a.y * b.y))
+                 + fabs(double(a.z * b.z)) + fabs(double(a.w * b.w));
+        stat.Add(fabs(double(scalar) - double(simd)) / Ulp(sum));
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      Vector4::Transform を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureTransform(uint32_t count)
+{
+    Random random(RANDOM_SEED + 1);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto v = random.GetVector4();
+        auto m = random.GetMatrix();
+
+        auto scalar = asdx::Vector4::Transform(v, m);
+
+        asdx::Vector4 simd;
+        _mm_storeu_ps(&simd.x, asdx::SimdTransform(
+            _mm_loadu_ps(&v.x),
+            _mm_loadu_ps(m.m[0]),
+            _mm_loadu_ps(m.m[1]),
+            _mm_loadu_ps(m.m[2]),
+            _mm_loadu_ps(m.m[3])));
+
+        stat.Add(UlpDistance(scalar.x, simd.x));
+        stat.Add(UlpDistance(scalar.y, simd.y));
+        stat.Add(UlpDistance(scalar.z, simd.z));
+        stat.Add(UlpDistance(scalar.w, simd.w));
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      Matrix::Multiply を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureMultiply(uint32_t count)
+{
+    Random random(RANDOM_SEED + 2);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto a = random.GetMatrix();
+        auto b = random.GetMatrix();
+
+        auto scalar = asdx::Matrix::Multiply(a, b);
+
+        auto b0 = _mm_loadu_ps(b.m[0]);
+        auto b1 = _mm_loadu_ps(b.m[1]);
+        auto b2 = _mm_loadu_ps(b.m[2]);
+        auto b3 = _mm_loadu_ps(b.m[3]);
+
+        asdx::Matrix simd;
+        for(auto r=0; r<4; ++r)
+        { _mm_storeu_ps(simd.m[r], asdx::SimdTransform(_mm_loadu_ps(a.m[r]), b0, b1, b2, b3)); }
+
+        for(auto r=0; r<4; ++r)
+        {
+            for(auto c=0; c<4; ++c)
+            { stat.Add(UlpDistance(scalar.m[r][c], simd.m[r][c])); }
+        }
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      Quaternion::Multiply を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureQuaternion(uint32_t count)
+{
+    Random random(RANDOM_SEED + 3);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto a = random.GetQuaternion();
+        auto b = random.GetQuaternion();
+
+        auto scalar = asdx::Quaternion::Multiply(a, b);
+
+        asdx::Quaternion simd;
+        _mm_storeu_ps(&simd.x, asdx::SimdQuaternionMultiply(_mm_loadu_ps(&a.x), _mm_loadu_ps(&b.x)));
+
+        // 各成分は4つの積の和なので, 積の絶対値の和を基準にする.
+        double sum[4] = {
+            fabs(double(b.x * a.w)) + fabs(double(a.x * b.w)) + fabs(double(b.y * a.z)) + fabs(double(b.z * a.y)),
+            fabs(double(b.y * a.w)) + fabs(double(a.y * b.w)) + fabs(double(b.z * a.x)) + fabs(double(b.x * a.z)),
+            fabs(double(b.z * a.w)) + fabs(double(a.z * b.w)) + fabs(double(b.x * a.y)) + fabs(double(b.y * a.x)),
+            fabs(double(b.w * a.w)) + fabs(double(b.x * a.x)) + fabs(double(b.y * a.y)) + fabs(double(b.z * a.z)),
+        };
+
+        const float* pScalar = &scalar.x;
+        const float* pSimd   = &simd.x;
+        for(auto j=0; j<4; ++j)
+        { stat.Add(fabs(double(pScalar[j]) - double(pSimd[j])) / Ulp(sum[j])); }
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      行の絶対値の和の最大値を求めます.
+//-----------------------------------------------------------------------------
+inline double NormInf(const asdx::Matrix& value)
+{
+    double result = 0.0;
+    for(auto r=0; r<4; ++r)
+    {
+        double sum = 0.0;
+        for(auto c=0; c<4; ++c)
+        { sum += fabs(double(value.m[r][c])); }
+        result = (sum > result) ? sum : result;
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      Matrix::Invert を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureInvert(uint32_t count)
+{
+    Random random(RANDOM_SEED + 4);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        // 剛体変換 + 拡大縮小, 透視投影, 一般の行列を順番に評価する.
+        asdx::Matrix m;
+        switch(i % 3)
+        {
+        case 0:
+            {
+                m = asdx::Matrix::CreateScale(
+                        1.25f + 0.75f * random.GetUnit(),
+                        1.25f + 0.75f * random.GetUnit(),
+                        1.25f + 0.75f * random.GetUnit())
+                  * asdx::Matrix::CreateRotationX(3.0f * random.GetUnit())
+                  * asdx::Matrix::CreateRotationY(3.0f * random.GetUnit())
+                  * asdx::Matrix::CreateRotationZ(3.0f * random.GetUnit())
+                  * asdx::Matrix::CreateTranslation(
+                        100.0f * random.GetUnit(),
+                        100.0f * random.GetUnit(),
+                        100.0f * random.GetUnit());
+            }
+            break;
+
+        case 1:
+            {
+                auto eye    = asdx::Vector3(50.0f * random.GetUnit(), 50.0f * random.GetUnit(), 50.0f * random.GetUnit());
+                auto target = asdx::Vector3(random.GetUnit(), random.GetUnit(), random.GetUnit());
+                m = asdx::Matrix::CreateLookAt(eye, target, asdx::Vector3(0.0f, 1.0f, 0.0f))
+                  * asdx::Matrix::CreatePerspectiveFieldOfView(
+                        1.0f + 0.5f * random.GetUnit(),
+                        1.5f + 0.5f * random.GetUnit(),
+                        0.1f,
+                        1000.0f);
+            }
+            break;
+
+        default:
+            {
+                // 特異に近い行列は条件数が大きくなるので除外する.
+                do {
+                    for(auto r=0; r<4; ++r)
+                    {
+                        for(auto c=0; c<4; ++c)
+                        { m.m[r][c] = random.GetUnit(); }
+                    }
+                } while(fabsf(m.Determinant()) < INVERT_MIN_DET);
+            }
+            break;
+        }
+
+        auto scalar = asdx::Matrix::Invert(m);
+
+        __m128 rows[4];
+        asdx::SimdInvert(
+            _mm_loadu_ps(m.m[0]),
+            _mm_loadu_ps(m.m[1]),
+            _mm_loadu_ps(m.m[2]),
+            _mm_loadu_ps(m.m[3]),
+            rows);
+
+        asdx::Matrix simd;
+        for(auto r=0; r<4; ++r)
+        { _mm_storeu_ps(simd.m[r], rows[r]); }
+
+        // 逆行列の誤差は条件数に比例するので, ulp(|inv(A)|) * cond(A) を単位にする.
+        auto norm = NormInf(scalar);
+        auto unit = Ulp(norm) * NormInf(m) * norm;
+        for(auto r=0; r<4; ++r)
+        {
+            for(auto c=0; c<4; ++c)
+            { stat.Add(fabs(double(scalar.m[r][c]) - double(simd.m[r][c])) / unit); }
+        }
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      Matrix::InvertAffine を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureInvertAffine(uint32_t count)
+{
+    Random random(RANDOM_SEED + 5);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto m = random.GetAffine();
+        auto scalar = asdx::Matrix::InvertAffine(m);
+
+        __m128 rows[4];
+        asdx::SimdInvertAffine(
+            _mm_loadu_ps(m.m[0]),
+            _mm_loadu_ps(m.m[1]),
+            _mm_loadu_ps(m.m[2]),
+            _mm_loadu_ps(m.m[3]),
+            rows);
+
+        asdx::Matrix simd;
+        for(auto r=0; r<4; ++r)
+        { _mm_storeu_ps(simd.m[r], rows[r]); }
+
+        for(auto r=0; r<4; ++r)
+        {
+            for(auto c=0; c<4; ++c)
+            { stat.Add(BitError(scalar.m[r][c], simd.m[r][c])); }
+        }
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      Matrix::InvertRigid を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureInvertRigid(uint32_t count)
+{
+    Random random(RANDOM_SEED + 6);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto m = random.GetRigid();
+        auto scalar = asdx::Matrix::InvertRigid(m);
+
+        __m128 rows[4];
+        asdx::SimdInvertRigid(
+            _mm_loadu_ps(m.m[0]),
+            _mm_loadu_ps(m.m[1]),
+            _mm_loadu_ps(m.m[2]),
+            _mm_loadu_ps(m.m[3]),
+            rows);
+
+        asdx::Matrix simd;
+        for(auto r=0; r<4; ++r)
+        { _mm_storeu_ps(simd.m[r], rows[r]); }
+
+        for(auto r=0; r<4; ++r)
+        {
+            for(auto c=0; c<4; ++c)
+            { stat.Add(BitError(scalar.m[r][c], simd.m[r][c])); }
+        }
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      Matrix34::Invert を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureInvert34(uint32_t count)
+{
+    Random random(RANDOM_SEED + 7);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto m = asdx::Matrix34(random.GetAffine());
+        auto scalar = asdx::Matrix34::Invert(m);
+
+        __m128 rows[3];
+        asdx::SimdInvertAffine3x4(
+            _mm_loadu_ps(m.m[0]),
+            _mm_loadu_ps(m.m[1]),
+            _mm_loadu_ps(m.m[2]),
+            rows);
+
+        asdx::Matrix34 simd;
+        for(auto r=0; r<3; ++r)
+        { _mm_storeu_ps(simd.m[r], rows[r]); }
+
+        for(auto r=0; r<3; ++r)
+        {
+            for(auto c=0; c<4; ++c)
+            { stat.Add(BitError(scalar.m[r][c], simd.m[r][c])); }
+        }
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      Matrix34::InvertRigid を比較します.
+//-----------------------------------------------------------------------------
+ErrorStat MeasureInvertRigid34(uint32_t count)
+{
+    Random random(RANDOM_SEED + 8);
+    ErrorStat stat;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto m = asdx::Matrix34(random.GetRigid());
+        auto scalar = asdx::Matrix34::InvertRigid(m);
+
+        __m128 rows[3];
+        asdx::SimdInvertRigid3x4(
+            _mm_loadu_ps(m.m[0]),
+            _mm_loadu_ps(m.m[1]),
+            _mm_loadu_ps(m.m[2]),
+            rows);
+
+        asdx::Matrix34 simd;
+        for(auto r=0; r<3; ++r)
+        { _mm_storeu_ps(simd.m[r], rows[r]); }
+
+        for(auto r=0; r<3; ++r)
+        {
+            for(auto c=0; c<4; ++c)
+            { stat.Add(BitError(scalar.m[r][c], simd.m[r][c])); }
+        }
+    }
+
+    return stat;
+}
+
+//-----------------------------------------------------------------------------
+//      結果を出力します.
+//-----------------------------------------------------------------------------
+bool Report(const char* name, const ErrorStat& stat, double bound)
+{
+    auto pass = (stat.MaxError <= bound);
+    printf("%-22s max_ulp=%.3f bound=%.3f samples=%llu %s\n",
+        name,
+        stat.MaxError,
+        bound,
+        (unsigned long long)stat.Count,
+        pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+//-----------------------------------------------------------------------------
+//      入力数を解析します.
+//-----------------------------------------------------------------------------
+bool ParseCount(const char* arg, uint32_t& result)
+{
+    char* pEnd = nullptr;
+    auto value = strtoul(arg, &pEnd, 10);
+    if (arg[0] < '0' || arg[0] > '9' || *pEnd != '\0' || value == 0 || value > UINT32_MAX)
+    { return false; }
+
+    result = uint32_t(value);
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    auto count = DEFAULT_COUNT;
+    if (argc > 2 || (argc == 2 && !ParseCount(argv[1], count)))
+    {
+        fprintf(stderr, "usage: %s [count]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto pass = true;
+    pass &= Report("Vector4::Dot",          MeasureDot(count),           DOT_MAX_ULP);
+    pass &= Report("Vector4::Transform",    MeasureTransform(count),     TRANSFORM_MAX_ULP);
+    pass &= Report("Matrix::Multiply",      MeasureMultiply(count),      MULTIPLY_MAX_ULP);
+    pass &= Report("Quaternion::Multiply",  MeasureQuaternion(count),    QUATERNION_MAX_ULP);
+    pass &= Report("Matrix::Invert",        MeasureInvert(count),        INVERT_MAX_ULP);
+    pass &= Report("Matrix::InvertAffine",  MeasureInvertAffine(count),  AFFINE_MAX_ULP);
+    pass &= Report("Matrix::InvertRigid",   MeasureInvertRigid(count),   AFFINE_MAX_ULP);
+    pass &= Report("Matrix34::Invert",      MeasureInvert34(count),      AFFINE_MAX_ULP);
+    pass &= Report("Matrix34::InvertRigid", MeasureInvertRigid34(count), AFFINE_MAX_ULP);
+
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}